@@ -74,6 +74,7 @@ typedef struct
   int32_t (*GetYSize)(uint32_t, uint32_t *);
   int32_t (*SetLayer)(uint32_t, uint32_t);
   int32_t (*GetFormat)(uint32_t, uint32_t *);
+  int32_t (*DrawGlyph)(uint32_t, uint32_t, uint32_t, uint8_t *, uint32_t, uint32_t, uint32_t, uint32_t);
 } LCD_UTILS_Drv_t;
 
 typedef struct
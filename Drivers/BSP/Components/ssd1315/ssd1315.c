@@ -45,6 +45,8 @@
 /** @defgroup SSD1315_Private_Defines
 * @{
 */
+/* A single byte is sent as a command by the bus IO, a refreshed window is at least 2 columns wide */
+#define SSD1315_REFRESH_MIN_WIDTH   2U
 
 /**
 * @}
@@ -89,6 +91,7 @@ SSD1315_Drv_t   SSD1315_Driver =
   SSD1315_SetPixel,
   SSD1315_GetXSize,
   SSD1315_GetYSize,
+  SSD1315_DrawGlyph,
 };
 
 #if defined ( __ICCARM__ )  /* IAR Compiler */
@@ -99,6 +102,17 @@ uint8_t              PhysFrameBuffer[SSD1315_LCD_COLUMN_NUMBER*SSD1315_LCD_PAGE_
 #else                       /* ARM Compiler */
 __align(16) uint8_t  PhysFrameBuffer[SSD1315_LCD_COLUMN_NUMBER*SSD1315_LCD_PAGE_NUMBER];
 #endif /* __ICCARM__ */
+
+/* Columns range modified in each page since the last refresh, clean when start > end */
+static uint8_t DirtyColumnStart[SSD1315_LCD_PAGE_NUMBER];
+static uint8_t DirtyColumnEnd[SSD1315_LCD_PAGE_NUMBER];
+
+/* Window of the last prepared refresh, none when the first page is out of the display */
+static uint8_t RefreshPageStart = SSD1315_LCD_PAGE_NUMBER;
+static uint8_t RefreshPageEnd;
+static uint8_t RefreshColumnStart;
+static uint8_t RefreshColumnEnd;
+
 /* The below table handle the different values to be set to Memory Data Access Control
    depending on the orientation and pbm image writing where the data order is inverted
 */
@@ -114,6 +128,10 @@ static int32_t SSD1315_ReadRegWrap(void *handle, uint16_t Reg, uint8_t* pData, u
 static int32_t SSD1315_WriteRegWrap(void *handle, uint16_t Reg, uint8_t* pData, uint16_t Length);
 static int32_t SSD1315_IO_Delay(SSD1315_Object_t *pObj, uint32_t Delay);
 static void ssd1315_Clear(uint16_t ColorCode);
+static void ssd1315_SetDirty(uint32_t Page, uint32_t ColumnStart, uint32_t ColumnEnd);
+static void ssd1315_ResetDirty(void);
+static int32_t ssd1315_RefreshWindow(SSD1315_Object_t *pObj, uint32_t PageStart, uint32_t PageEnd, uint32_t ColumnStart, uint32_t ColumnEnd);
+static int32_t ssd1315_SetWindow(SSD1315_Object_t *pObj, uint32_t PageStart, uint32_t PageEnd, uint32_t *ColumnStart, uint32_t *ColumnEnd);
 /**
 * @}
 */
@@ -204,6 +222,7 @@ int32_t SSD1315_Init(SSD1315_Object_t *pObj, uint32_t ColorCoding, uint32_t Orie
       ret += ssd1315_write_reg(&pObj->Ctx, 1,&data, 1);
       ssd1315_Clear(SSD1315_COLOR_BLACK); 
       ret += ssd1315_write_reg(&pObj->Ctx, 1, PhysFrameBuffer,  SSD1315_LCD_COLUMN_NUMBER*SSD1315_LCD_PAGE_NUMBER);
+      ssd1315_ResetDirty();
     }
     else
     {
@@ -376,6 +395,8 @@ int32_t SSD1315_SetCursor(SSD1315_Object_t *pObj, uint32_t Xpos, uint32_t Ypos)
 
 /**
   * @brief  Refresh Display.
+  *         Only the pages and columns modified since the last refresh are sent,
+  *         consecutive dirty pages are grouped in a single window.
   * @param  pObj Component object.
   * @retval The component status.
   */
@@ -383,30 +404,124 @@ int32_t SSD1315_SetCursor(SSD1315_Object_t *pObj, uint32_t Xpos, uint32_t Ypos)
 int32_t SSD1315_Refresh(SSD1315_Object_t *pObj)
 {
   int32_t ret = SSD1315_OK; 
-  uint8_t data;
+  uint32_t page, first_page = 0;
+  uint32_t column_start = 0, column_end = 0;
+  uint8_t  is_window = 0;
 
-  data = SSD1315_DISPLAY_START_LINE_1;
-  ret += ssd1315_write_reg(&pObj->Ctx, 1,&data, 1);
-  data = SSD1315_SET_COLUMN_ADRESS;
-  ret += ssd1315_write_reg(&pObj->Ctx, 1,&data, 1);
-  data = SSD1315_LOWER_COLUMN_START_ADRESS;
-  ret += ssd1315_write_reg(&pObj->Ctx, 1,&data, 1);
-  data = SSD1315_DISPLAY_START_LINE_64;
-  ret += ssd1315_write_reg(&pObj->Ctx, 1,&data, 1);
-  data = SSD1315_SET_PAGE_ADRESS;
-  ret += ssd1315_write_reg(&pObj->Ctx, 1,&data, 1);
-  data = SSD1315_LOWER_COLUMN_START_ADRESS;
-  ret += ssd1315_write_reg(&pObj->Ctx, 1,&data, 1);
-  data = SSD1315_LOWER_COLUMN_START_ADRESS_15;
-  ret += ssd1315_write_reg(&pObj->Ctx, 1,&data, 1);
-  ret += ssd1315_write_reg(&pObj->Ctx, 1,PhysFrameBuffer, SSD1315_LCD_COLUMN_NUMBER*SSD1315_LCD_PAGE_NUMBER);
+  for (page = 0; page <= SSD1315_LCD_PAGE_NUMBER; page++)
+  {
+    if ((page < SSD1315_LCD_PAGE_NUMBER) && (DirtyColumnStart[page] <= DirtyColumnEnd[page]))
+    {
+      if (is_window == 0U)
+      {
+        is_window    = 1;
+        first_page   = page;
+        column_start = DirtyColumnStart[page];
+        column_end   = DirtyColumnEnd[page];
+      }
+      else
+      {
+        column_start = (DirtyColumnStart[page] < column_start) ? DirtyColumnStart[page] : column_start;
+        column_end   = (DirtyColumnEnd[page]   > column_end)   ? DirtyColumnEnd[page]   : column_end;
+      }
+    }
+    else if (is_window != 0U)
+    {
+      /* End of a run of dirty pages */
+      ret += ssd1315_RefreshWindow(pObj, first_page, page - 1U, column_start, column_end);
+      is_window = 0;
+    }
+  }
 
   if (ret != SSD1315_OK)
   {
     ret = SSD1315_ERROR;
   }
+  else
+  {
+    ssd1315_ResetDirty();
+  }
   return ret;
 }
+
+/**
+  * @brief  Prepare an asynchronous refresh of the display.
+  *         Set the address window covering all the modified pages and copy
+  *         its content in pData, page after page. The caller then sends the
+  *         Length bytes of pData as data, the frame buffer can be drawn again
+  *         during the transfer.
+  * @param  pObj Component object.
+  * @param  pData Buffer receiving the window, of the frame buffer size.
+  * @param  Length Number of bytes to send, 0 if the display is up to date.
+  * @retval The component status.
+  */
+int32_t SSD1315_PrepareRefresh(SSD1315_Object_t *pObj, uint8_t *pData, uint32_t *Length)
+{
+  int32_t ret = SSD1315_OK;
+  uint32_t page, first_page = SSD1315_LCD_PAGE_NUMBER, last_page = 0;
+  uint32_t column_start = SSD1315_LCD_COLUMN_NUMBER, column_end = 0;
+  uint32_t width;
+
+  *Length = 0;
+
+  /* Bounding window of the modified pages */
+  for (page = 0; page < SSD1315_LCD_PAGE_NUMBER; page++)
+  {
+    if (DirtyColumnStart[page] <= DirtyColumnEnd[page])
+    {
+      first_page   = (first_page == SSD1315_LCD_PAGE_NUMBER) ? page : first_page;
+      last_page    = page;
+      column_start = (DirtyColumnStart[page] < column_start) ? DirtyColumnStart[page] : column_start;
+      column_end   = (DirtyColumnEnd[page]   > column_end)   ? DirtyColumnEnd[page]   : column_end;
+    }
+  }
+  if (first_page == SSD1315_LCD_PAGE_NUMBER)
+  {
+    return ret;
+  }
+
+  ret += ssd1315_SetWindow(pObj, first_page, last_page, &column_start, &column_end);
+  if (ret != SSD1315_OK)
+  {
+    return SSD1315_ERROR;
+  }
+
+  width = column_end - column_start + 1U;
+  for (page = first_page; page <= last_page; page++)
+  {
+    memcpy(&pData[*Length], &PhysFrameBuffer[column_start + page * SSD1315_LCD_COLUMN_NUMBER], width);
+    *Length += width;
+  }
+  ssd1315_ResetDirty();
+
+  /* Kept until the transfer is known to be done, see SSD1315_CancelRefresh() */
+  RefreshPageStart   = (uint8_t)first_page;
+  RefreshPageEnd     = (uint8_t)last_page;
+  RefreshColumnStart = (uint8_t)column_start;
+  RefreshColumnEnd   = (uint8_t)column_end;
+
+  return ret;
+}
+
+/**
+  * @brief  Cancel the last prepared refresh, its transfer failed or was aborted.
+  *         The window is marked as modified again, to be sent by the next refresh.
+  * @param  pObj Component object.
+  * @retval The component status.
+  */
+int32_t SSD1315_CancelRefresh(SSD1315_Object_t *pObj)
+{
+  uint32_t page;
+
+  (void)pObj;
+  for (page = RefreshPageStart; (page <= RefreshPageEnd) && (page < SSD1315_LCD_PAGE_NUMBER); page++)
+  {
+    ssd1315_SetDirty(page, RefreshColumnStart, RefreshColumnEnd);
+  }
+  RefreshPageStart = SSD1315_LCD_PAGE_NUMBER;
+
+  return SSD1315_OK;
+}
 /**
   * @brief  Displays a bitmap picture.
   * @param  pObj Component object.
@@ -446,6 +561,10 @@ int32_t SSD1315_DrawBitmap(SSD1315_Object_t *pObj, uint32_t Xpos, uint32_t Ypos,
   if((Xpos == 0) && (Xpos == 0) & (size == (SSD1315_LCD_PIXEL_WIDTH * SSD1315_LCD_PIXEL_HEIGHT/8)))
   {
     memcpy(PhysFrameBuffer, pBmp, size);
+    for (y = 0; y < SSD1315_LCD_PAGE_NUMBER; y++)
+    {
+      ssd1315_SetDirty(y, 0, SSD1315_LCD_COLUMN_NUMBER - 1U);
+    }
   }
   else
   {
@@ -461,6 +580,7 @@ int32_t SSD1315_DrawBitmap(SSD1315_Object_t *pObj, uint32_t Xpos, uint32_t Ypos,
         if(((Ypos%8) == 0) && (y-Ypos >= 8) && ((YposBMP%8) == 0))
         {
           PhysFrameBuffer[Xpos+ (Ypos/8)*SSD1315_LCD_PIXEL_WIDTH] = pBmp[XposBMP+((YposBMP/8)*width)];
+          ssd1315_SetDirty(Ypos/8, Xpos, Xpos);
           Ypos+=7;
           YposBMP+=7;
         }
@@ -561,6 +681,10 @@ int32_t SSD1315_ShiftBitmap(SSD1315_Object_t *pObj,uint16_t Xpos, uint16_t Ypos,
   if((Xpos == 0) && (Xpos == 0) & (size == (SSD1315_LCD_PIXEL_WIDTH * SSD1315_LCD_PIXEL_HEIGHT/8)))
   {
     memcpy(PhysFrameBuffer, pbmp, size);
+    for (y = 0; y < SSD1315_LCD_PAGE_NUMBER; y++)
+    {
+      ssd1315_SetDirty(y, 0, SSD1315_LCD_COLUMN_NUMBER - 1U);
+    }
   }
   else
   {
@@ -576,6 +700,7 @@ int32_t SSD1315_ShiftBitmap(SSD1315_Object_t *pObj,uint16_t Xpos, uint16_t Ypos,
         if(((Ypos%8) == 0) && (y-Ypos >= 8) && ((YposBMP%8) == 0))
         {
           PhysFrameBuffer[Xpos+ (Ypos/8)*SSD1315_LCD_PIXEL_WIDTH] = pbmp[XposBMP+((YposBMP/8)*original_width)];
+          ssd1315_SetDirty(Ypos/8, Xpos, Xpos);
           Ypos+=7;
           YposBMP+=7;
         }
@@ -640,6 +765,83 @@ int32_t SSD1315_FillRGBRect(SSD1315_Object_t *pObj, uint32_t Xpos, uint32_t Ypos
   return ret;
 }
 
+/**
+  * @brief  Draw a glyph given column by column, in the page organization of the
+  *         frame buffer: each column is (Height + 7) / 8 bytes, the bit 0 of the
+  *         first byte being the top pixel. The glyph is opaque, the pixels of the
+  *         glyph are drawn with TextColor and the others with BackColor.
+  * @param  pObj Component object.
+  * @param  Xpos specifies the X position.
+  * @param  Ypos specifies the Y position, not necessarily aligned on a page.
+  * @param  pData Pointer to the glyph columns.
+  * @param  Width specifies the glyph width.
+  * @param  Height specifies the glyph height, up to SSD1315_GLYPH_MAX_HEIGHT.
+  * @param  TextColor Specifies the color of the glyph pixels.
+  * @param  BackColor Specifies the color of the background pixels.
+  * @retval The component status.
+  */
+int32_t SSD1315_DrawGlyph(SSD1315_Object_t *pObj, uint32_t Xpos, uint32_t Ypos, uint8_t *pData, uint32_t Width, uint32_t Height, uint32_t TextColor, uint32_t BackColor)
+{
+  uint32_t column_bytes = (Height + 7U) / 8U;
+  uint32_t shift = Ypos % 8U;
+  uint32_t first_page = Ypos / 8U, last_page;
+  uint32_t mask, bits, shifted_mask, i, k, page;
+  uint8_t  *pixels;
+  uint8_t  value;
+  /* Prevent unused argument(s) compilation warning */
+  (void)(pObj);
+
+  if ((Height == 0U) || (Height > SSD1315_GLYPH_MAX_HEIGHT))
+  {
+    return SSD1315_ERROR;
+  }
+
+  /* Clip the glyph outside of the screen */
+  if ((Xpos >= SSD1315_LCD_PIXEL_WIDTH) || (Ypos >= SSD1315_LCD_PIXEL_HEIGHT))
+  {
+    return SSD1315_OK;
+  }
+  if ((Xpos + Width) > SSD1315_LCD_PIXEL_WIDTH)
+  {
+    Width = SSD1315_LCD_PIXEL_WIDTH - Xpos;
+  }
+  last_page = (Ypos + Height - 1U) / 8U;
+  if (last_page >= SSD1315_LCD_PAGE_NUMBER)
+  {
+    last_page = SSD1315_LCD_PAGE_NUMBER - 1U;
+  }
+
+  shifted_mask = ((1UL << Height) - 1U) << shift;
+  for (i = 0; i < Width; i++)
+  {
+    bits = 0;
+    for (k = 0; k < column_bytes; k++)
+    {
+      bits |= (uint32_t)pData[(i * column_bytes) + k] << (8U * k);
+    }
+    mask = 0;
+    mask |= (TextColor == SSD1315_COLOR_WHITE) ? bits : 0U;
+    mask |= (BackColor == SSD1315_COLOR_WHITE) ? ~bits : 0U;
+    bits = (mask << shift) & shifted_mask;
+
+    /* Merge the column in the pages it covers */
+    for (page = first_page; page <= last_page; page++)
+    {
+      k = 8U * (page - first_page);
+      pixels = &PhysFrameBuffer[Xpos + i + (page * SSD1315_LCD_PIXEL_WIDTH)];
+      value = (*pixels & (uint8_t)~(shifted_mask >> k)) | (uint8_t)(bits >> k);
+      /* Only a real change needs to be sent on next refresh */
+      if (value != *pixels)
+      {
+        *pixels = value;
+        ssd1315_SetDirty(page, Xpos + i, Xpos + i);
+      }
+    }
+  }
+
+  return SSD1315_OK;
+}
+
 
 /**
   * @brief  Draw horizontal line.
@@ -730,16 +932,32 @@ int32_t SSD1315_FillRect(SSD1315_Object_t *pObj, uint32_t Xpos, uint32_t Ypos, u
 int32_t SSD1315_SetPixel(SSD1315_Object_t *pObj, uint32_t Xpos, uint32_t Ypos, uint32_t Color)
 {
   int32_t  ret = SSD1315_OK;
+  uint8_t  *pixels;
+  uint8_t  value;
   /* Prevent unused argument(s) compilation warning */  
   (void)(pObj);
+
+  /* Clip the pixels outside of the screen */
+  if ((Xpos >= SSD1315_LCD_PIXEL_WIDTH) || (Ypos >= SSD1315_LCD_PIXEL_HEIGHT))
+  {
+    return ret;
+  }
+
   /* Set color */
+  pixels = &PhysFrameBuffer[Xpos + (Ypos / 8) * SSD1315_LCD_PIXEL_WIDTH];
   if (Color == SSD1315_COLOR_WHITE)
   {
-    PhysFrameBuffer[Xpos + (Ypos / 8) * SSD1315_LCD_PIXEL_WIDTH] |= 1 << (Ypos % 8);
+    value = *pixels | (uint8_t)(1U << (Ypos % 8));
   }
   else
   {
-    PhysFrameBuffer[Xpos + (Ypos / 8) * SSD1315_LCD_PIXEL_WIDTH] &= ~(1 << (Ypos % 8));
+    value = *pixels & (uint8_t)~(1U << (Ypos % 8));
+  }
+  /* Only a real change needs to be sent on next refresh */
+  if (value != *pixels)
+  {
+    *pixels = value;
+    ssd1315_SetDirty(Ypos / 8, Xpos, Xpos);
   }
   if(ret != SSD1315_OK)
   {
@@ -1009,6 +1227,118 @@ static void ssd1315_Clear(uint16_t ColorCode)
   }
 }
 
+/**
+  * @brief  Extend the columns range to send on next refresh for a page.
+  * @param  Page the page modified (0-7).
+  * @param  ColumnStart first column modified.
+  * @param  ColumnEnd last column modified.
+  * @retval None
+  */
+static void ssd1315_SetDirty(uint32_t Page, uint32_t ColumnStart, uint32_t ColumnEnd)
+{
+  if (Page >= SSD1315_LCD_PAGE_NUMBER)
+  {
+    return;
+  }
+  if (ColumnStart < DirtyColumnStart[Page])
+  {
+    DirtyColumnStart[Page] = (uint8_t)ColumnStart;
+  }
+  if (ColumnEnd > DirtyColumnEnd[Page])
+  {
+    DirtyColumnEnd[Page] = (uint8_t)ColumnEnd;
+  }
+}
+
+/**
+  * @brief  Mark all the pages as clean, the display is up to date.
+  * @retval None
+  */
+static void ssd1315_ResetDirty(void)
+{
+  memset(DirtyColumnStart, 0xFF, sizeof(DirtyColumnStart));
+  memset(DirtyColumnEnd, 0x00, sizeof(DirtyColumnEnd));
+}
+
+/**
+  * @brief  Send a window of the frame buffer to the display.
+  *         The controller is in horizontal addressing mode, the window is
+  *         filled page after page.
+  * @param  pObj Component object.
+  * @param  PageStart first page of the window.
+  * @param  PageEnd last page of the window.
+  * @param  ColumnStart first column of the window.
+  * @param  ColumnEnd last column of the window.
+  * @retval Component error status.
+  */
+static int32_t ssd1315_RefreshWindow(SSD1315_Object_t *pObj, uint32_t PageStart, uint32_t PageEnd, uint32_t ColumnStart, uint32_t ColumnEnd)
+{
+  int32_t  ret = SSD1315_OK;
+  uint32_t page, width;
+
+  ret += ssd1315_SetWindow(pObj, PageStart, PageEnd, &ColumnStart, &ColumnEnd);
+  width = ColumnEnd - ColumnStart + 1U;
+
+  if (width == SSD1315_LCD_COLUMN_NUMBER)
+  {
+    /* Full width pages are contiguous in the frame buffer */
+    ret += ssd1315_write_reg(&pObj->Ctx, 1, &PhysFrameBuffer[PageStart * SSD1315_LCD_COLUMN_NUMBER],
+                             (uint16_t)((PageEnd - PageStart + 1U) * SSD1315_LCD_COLUMN_NUMBER));
+  }
+  else
+  {
+    for (page = PageStart; page <= PageEnd; page++)
+    {
+      ret += ssd1315_write_reg(&pObj->Ctx, 1, &PhysFrameBuffer[ColumnStart + page * SSD1315_LCD_COLUMN_NUMBER], (uint16_t)width);
+    }
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Set the column and page address window of the next data writes.
+  *         The window is widened to have data writes of at least 2 bytes.
+  * @param  pObj Component object.
+  * @param  PageStart first page of the window.
+  * @param  PageEnd last page of the window.
+  * @param  ColumnStart first column of the window, updated if widened.
+  * @param  ColumnEnd last column of the window, updated if widened.
+  * @retval Component error status.
+  */
+static int32_t ssd1315_SetWindow(SSD1315_Object_t *pObj, uint32_t PageStart, uint32_t PageEnd, uint32_t *ColumnStart, uint32_t *ColumnEnd)
+{
+  int32_t  ret = SSD1315_OK;
+  uint8_t  data;
+
+  if ((*ColumnEnd - *ColumnStart + 1U) < SSD1315_REFRESH_MIN_WIDTH)
+  {
+    if (*ColumnEnd < (SSD1315_LCD_COLUMN_NUMBER - 1U))
+    {
+      (*ColumnEnd)++;
+    }
+    else
+    {
+      (*ColumnStart)--;
+    }
+  }
+
+  data = SSD1315_SET_COLUMN_ADRESS;
+  ret += ssd1315_write_reg(&pObj->Ctx, 1, &data, 1);
+  data = (uint8_t)*ColumnStart;
+  ret += ssd1315_write_reg(&pObj->Ctx, 1, &data, 1);
+  data = (uint8_t)*ColumnEnd;
+  ret += ssd1315_write_reg(&pObj->Ctx, 1, &data, 1);
+  data = SSD1315_SET_PAGE_ADRESS;
+  ret += ssd1315_write_reg(&pObj->Ctx, 1, &data, 1);
+  data = (uint8_t)PageStart;
+  ret += ssd1315_write_reg(&pObj->Ctx, 1, &data, 1);
+  data = (uint8_t)PageEnd;
+  ret += ssd1315_write_reg(&pObj->Ctx, 1, &data, 1);
+
+  return ret;
+}
+
 /**
   * @brief  SSD1315 delay.
   * @param  Delay Delay in ms.
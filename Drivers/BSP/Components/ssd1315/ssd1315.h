@@ -100,6 +100,7 @@ typedef struct
   int32_t ( *SetPixel        ) (SSD1315_Object_t*, uint32_t, uint32_t, uint32_t);
   int32_t ( *GetXSize        ) (SSD1315_Object_t*, uint32_t *);
   int32_t ( *GetYSize        ) (SSD1315_Object_t*, uint32_t *);
+  int32_t ( *DrawGlyph       ) (SSD1315_Object_t*, uint32_t, uint32_t, uint8_t*, uint32_t, uint32_t, uint32_t, uint32_t);
 }SSD1315_Drv_t;
 
 /**
@@ -125,6 +126,9 @@ typedef struct
 #define  SSD1315_LCD_COLUMN_NUMBER  ((uint16_t)128)
 #define  SSD1315_LCD_PAGE_NUMBER    ((uint16_t)8)
 
+/* Highest glyph drawn by SSD1315_DrawGlyph, a shifted column must fit in 32 bits */
+#define  SSD1315_GLYPH_MAX_HEIGHT   24U
+
 /**
   *  @brief LCD_Orientation
   *  Possible values of Display Orientation
@@ -155,6 +159,8 @@ int32_t SSD1315_GetBrightness(SSD1315_Object_t *pObj, uint32_t *Brightness);
 int32_t SSD1315_SetOrientation(SSD1315_Object_t *pObj, uint32_t Orientation);
 int32_t SSD1315_GetOrientation(SSD1315_Object_t *pObj, uint32_t *Orientation);
 int32_t SSD1315_Refresh(SSD1315_Object_t *pObj);
+int32_t SSD1315_PrepareRefresh(SSD1315_Object_t *pObj, uint8_t *pData, uint32_t *Length);
+int32_t SSD1315_CancelRefresh(SSD1315_Object_t *pObj);
 
 int32_t SSD1315_SetPage(SSD1315_Object_t *pObj, uint16_t Page);
 int32_t SSD1315_SetColumn(SSD1315_Object_t *pObj, uint16_t Column);
@@ -166,6 +172,7 @@ int32_t SSD1315_SetCursor(SSD1315_Object_t *pObj, uint32_t Xpos, uint32_t Ypos);
 int32_t SSD1315_DrawBitmap(SSD1315_Object_t *pObj, uint32_t Xpos, uint32_t Ypos, uint8_t *pBmp);
 int32_t SSD1315_ShiftBitmap(SSD1315_Object_t *pObj,uint16_t Xpos, uint16_t Ypos, int16_t Xshift, int16_t Yshift, uint8_t *pbmp);
 int32_t SSD1315_FillRGBRect(SSD1315_Object_t *pObj, uint32_t Xpos, uint32_t Ypos, uint8_t *pData, uint32_t Width, uint32_t Height);
+int32_t SSD1315_DrawGlyph(SSD1315_Object_t *pObj, uint32_t Xpos, uint32_t Ypos, uint8_t *pData, uint32_t Width, uint32_t Height, uint32_t TextColor, uint32_t BackColor);
 int32_t SSD1315_DrawHLine(SSD1315_Object_t *pObj, uint32_t Xpos, uint32_t Ypos, uint32_t Length, uint32_t Color);
 int32_t SSD1315_DrawVLine(SSD1315_Object_t *pObj, uint32_t Xpos, uint32_t Ypos, uint32_t Length, uint32_t Color);
 int32_t SSD1315_DrawLine(SSD1315_Object_t *pObj, uint32_t X1pos, uint32_t Y1pos, uint32_t X2pos, uint32_t Y2pos, uint32_t Color);
@@ -157,6 +157,7 @@ static uint32_t IsSpi1MspCbValid = 0;
   */
 I2C_HandleTypeDef hbus_i2c3 = {0};
 SPI_HandleTypeDef hbus_spi1;
+DMA_HandleTypeDef hbus_spi1_dma_tx;
 
 /**
   * @}
@@ -175,6 +176,9 @@ static void     I2C_Compute_PRESC_SCLDEL_SDADEL(uint32_t clock_src_freq, uint32_
 
 static void SPI1_MspInit(SPI_HandleTypeDef* hspi);
 static void SPI1_MspDeInit(SPI_HandleTypeDef* hspi);
+#if (USE_HAL_SPI_REGISTER_CALLBACKS == 1)
+static void SPI1_TxCpltCallback(SPI_HandleTypeDef* hspi);
+#endif /* (USE_HAL_SPI_REGISTER_CALLBACKS == 1) */
 static uint32_t SPI_GetPrescaler( uint32_t clk_src_hz, uint32_t baudfreq_mbps );
 /**
   * @}
@@ -359,6 +363,12 @@ int32_t BSP_SPI1_Init(void)
     {
       ret = BSP_ERROR_BUS_FAILURE;
     }
+#if (USE_HAL_SPI_REGISTER_CALLBACKS == 1)
+    else if (HAL_SPI_RegisterCallback(&hbus_spi1, HAL_SPI_TX_COMPLETE_CB_ID, SPI1_TxCpltCallback) != HAL_OK)
+    {
+      ret = BSP_ERROR_PERIPH_FAILURE;
+    }
+#endif
   }
 
   return ret;
@@ -431,6 +441,48 @@ int32_t BSP_SPI1_Send(uint8_t *pData, uint16_t Length)
   return ret;
 }
 
+/**
+  * @brief  Write Data through SPI BUS using the DMA.
+  *         The buffer must stay valid until BSP_SPI1_TxCpltCallback() is called.
+  * @param  pData  Pointer to data buffer to send
+  * @param  Length Length of data in byte
+  * @retval BSP status
+  */
+int32_t BSP_SPI1_Send_DMA(uint8_t *pData, uint16_t Length)
+{
+  int32_t ret = BSP_ERROR_BUS_FAILURE;
+
+  if(HAL_SPI_Transmit_DMA(&hbus_spi1, pData, Length) == HAL_OK)
+  {
+    ret = BSP_ERROR_NONE;
+  }
+  return ret;
+}
+
+/**
+  * @brief  Handle the SPI1 DMA transmission interrupt.
+  *         To be called from the IRQ handler of BUS_SPI1_DMA_TX_CHANNEL.
+  * @retval None
+  */
+void BSP_SPI1_DMA_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hbus_spi1_dma_tx);
+}
+
+/**
+  * @brief  End of a DMA transmission on SPI1, called under interrupt.
+  *         With USE_HAL_SPI_REGISTER_CALLBACKS set to 1, it is registered by
+  *         BSP_SPI1_Init(). Otherwise, the BSP does not define the
+  *         HAL_SPI_TxCpltCallback() shared by all the SPI instances: the
+  *         application shall call this function from its own
+  *         HAL_SPI_TxCpltCallback() when the SPI1 instance is completed.
+  * @retval None
+  */
+__weak void BSP_SPI1_TxCpltCallback(void)
+{
+  /* This function should be implemented by the user of BSP_SPI1_Send_DMA() */
+}
+
 /**
   * @brief  Receive Data from SPI BUS
   * @param  pData  Pointer to data buffer to receive
@@ -666,6 +718,23 @@ static void SPI1_MspInit(SPI_HandleTypeDef* hspi)
   GPIO_InitStructure.Alternate = BUS_SPI1_AF;
   HAL_GPIO_Init(BUS_SPI1_GPIO_PORTA, &GPIO_InitStructure);
 
+  /* configure the DMA used by the asynchronous transmissions */
+  BUS_SPI1_DMA_CLOCK_ENABLE();
+  hbus_spi1_dma_tx.Instance                 = BUS_SPI1_DMA_TX_CHANNEL;
+  hbus_spi1_dma_tx.Init.Request             = BUS_SPI1_DMA_TX_REQUEST;
+  hbus_spi1_dma_tx.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+  hbus_spi1_dma_tx.Init.PeriphInc           = DMA_PINC_DISABLE;
+  hbus_spi1_dma_tx.Init.MemInc              = DMA_MINC_ENABLE;
+  hbus_spi1_dma_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+  hbus_spi1_dma_tx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+  hbus_spi1_dma_tx.Init.Mode                = DMA_NORMAL;
+  hbus_spi1_dma_tx.Init.Priority            = DMA_PRIORITY_LOW;
+  if (HAL_DMA_Init(&hbus_spi1_dma_tx) == HAL_OK)
+  {
+    __HAL_LINKDMA(hspi, hdmatx, hbus_spi1_dma_tx);
+    HAL_NVIC_SetPriority(BUS_SPI1_DMA_TX_IRQn, BUS_SPI1_DMA_IT_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(BUS_SPI1_DMA_TX_IRQn);
+  }
 }
 
 /**
@@ -691,8 +760,25 @@ static void SPI1_MspDeInit(SPI_HandleTypeDef* hspi)
   gpio_init_structure.Pin = BUS_SPI1_MOSI_PIN;
   HAL_GPIO_DeInit(BUS_SPI1_GPIO_PORTA, gpio_init_structure.Pin);
 
+  /* DMA */
+  HAL_NVIC_DisableIRQ(BUS_SPI1_DMA_TX_IRQn);
+  (void)HAL_DMA_DeInit(&hbus_spi1_dma_tx);
 }
 
+#if (USE_HAL_SPI_REGISTER_CALLBACKS == 1)
+/**
+  * @brief  SPI1 transmission complete callback.
+  * @param  hspi  SPI handler
+  * @retval None
+  */
+static void SPI1_TxCpltCallback(SPI_HandleTypeDef* hspi)
+{
+  UNUSED(hspi);
+
+  BSP_SPI1_TxCpltCallback();
+}
+#endif /* (USE_HAL_SPI_REGISTER_CALLBACKS == 1) */
+
 
 /**
   * @}
@@ -107,6 +107,17 @@ typedef struct
    #define BUS_SPI1_BAUDRATE  12500000    /* baud rate of SPIn = 12.5 Mbps*/
 #endif
 
+/* DMA used for the asynchronous transmissions, DMA1 Channel1 is kept for the ADC */
+#ifndef BUS_SPI1_DMA_TX_CHANNEL
+#define BUS_SPI1_DMA_TX_CHANNEL           DMA1_Channel2
+#define BUS_SPI1_DMA_TX_IRQn              DMA1_Channel2_IRQn
+#endif
+#define BUS_SPI1_DMA_TX_REQUEST           DMA_REQUEST_SPI1_TX
+#define BUS_SPI1_DMA_CLOCK_ENABLE()       do { __HAL_RCC_DMAMUX1_CLK_ENABLE(); __HAL_RCC_DMA1_CLK_ENABLE(); } while(0)
+#ifndef BUS_SPI1_DMA_IT_PRIORITY
+#define BUS_SPI1_DMA_IT_PRIORITY          0x0FUL
+#endif
+
 #endif /* HAL_SPI_MODULE_ENABLED */
 
 /**
@@ -118,6 +129,7 @@ typedef struct
   */
 extern I2C_HandleTypeDef hbus_i2c3;
 extern SPI_HandleTypeDef hbus_spi1;
+extern DMA_HandleTypeDef hbus_spi1_dma_tx;
 /**
   * @}
   */
@@ -143,6 +155,9 @@ int32_t BSP_SPI1_DeInit(void);
 int32_t BSP_SPI1_Send(uint8_t *pData, uint16_t Length);
 int32_t BSP_SPI1_Recv(uint8_t *pData, uint16_t Length);
 int32_t BSP_SPI1_SendRecv(uint8_t *pTxData, uint8_t *pRxData, uint16_t Length);
+int32_t BSP_SPI1_Send_DMA(uint8_t *pData, uint16_t Length);
+void    BSP_SPI1_DMA_IRQHandler(void);
+void    BSP_SPI1_TxCpltCallback(void);
 
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1)
 int32_t BSP_SPI1_RegisterDefaultMspCallbacks (void);
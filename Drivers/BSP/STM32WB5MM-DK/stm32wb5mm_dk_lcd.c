@@ -33,6 +33,11 @@
      o Enable the LCD display using the BSP_LCD_DisplayOn() function.
      o Disable the LCD display using the BSP_LCD_DisplayOff() function.
      o Refresh the LCD display using the BSP_LCD_Refresh() function.
+     o Refresh the LCD display without waiting the end of the transfer using the
+       BSP_LCD_RefreshAsync() function, BSP_LCD_RefreshCpltCallback() is called
+       under interrupt at its end. The DMA IRQ handler shall call BSP_SPI1_DMA_IRQHandler()
+       and, unless USE_HAL_SPI_REGISTER_CALLBACKS is set, the HAL_SPI_TxCpltCallback() of
+       the application shall call BSP_SPI1_TxCpltCallback() for the SPI1 instance.
      o Set Page of the LCD display using the BSP_LCD_SetPage() function.
      o Set Column of the LCD display using the BSP_LCD_SetColumn() function.
      o Setup Scrolling of the LCD display using the BSP_LCD_ScrollingSetup() function.
@@ -96,7 +101,8 @@ const LCD_UTILS_Drv_t LCD_Driver =
   BSP_LCD_GetXSize,
   BSP_LCD_GetYSize,
   NULL,
-  BSP_LCD_GetPixelFormat
+  BSP_LCD_GetPixelFormat,
+  BSP_LCD_DrawGlyph
 };
 /**
   * @}
@@ -126,6 +132,10 @@ BSP_LCD_Ctx_t        LcdCtx[LCD_INSTANCES_NBR];
   * @{
   */
 static SSD1315_Drv_t     *LcdDrv = NULL;
+
+/* Copy of the frame buffer window sent by DMA, drawing goes on in the frame buffer */
+static uint8_t           LcdTxBuffer[LCD_DEFAULT_WIDTH * LCD_DEFAULT_HEIGHT / 8U];
+static volatile uint8_t  LcdTxBusy = 0;
 /**
   * @}
   */
@@ -138,6 +148,7 @@ static void LCD_MspInit(void);
 static void LCD_MspDeInit(void);
 static int32_t LCD_IO_Init(void);
 static int32_t LCD_IO_DeInit(void);
+static int32_t LCD_IO_WaitTransfer(void);
 
 #if (USE_LCD_CTRL_SSD1315 == 1)
 static int32_t SSD1315_Probe(uint32_t Orientation);
@@ -374,6 +385,97 @@ int32_t BSP_LCD_Refresh(uint32_t Instance)
   return ret;
 }
 
+/**
+  * @brief  Refresh the display without waiting the end of the transfer.
+  *         Only the modified part of the display is sent. Drawing can go on
+  *         during the transfer, it will be sent by the next refresh.
+  * @param  Instance LCD Instance
+  * @retval BSP status, BSP_ERROR_BUSY if a transfer is on going
+  */
+int32_t BSP_LCD_RefreshAsync(uint32_t Instance)
+{
+  int32_t  ret = BSP_ERROR_NONE;
+  uint32_t length = 0;
+
+  if(Instance >= LCD_INSTANCES_NBR)
+  {
+    ret = BSP_ERROR_WRONG_PARAM;
+  }
+  else if(LcdTxBusy != 0U)
+  {
+    ret = BSP_ERROR_BUSY;
+  }
+  else if(SSD1315_PrepareRefresh(LcdCompObj, LcdTxBuffer, &length) < 0)
+  {
+    ret = BSP_ERROR_COMPONENT_FAILURE;
+  }
+  else if(length != 0U)
+  {
+    LcdTxBusy = 1;
+    LCD_CS_LOW();
+    LCD_DC_HIGH();
+    if(BSP_SPI1_Send_DMA(LcdTxBuffer, (uint16_t)length) != BSP_ERROR_NONE)
+    {
+      LCD_DC_LOW();
+      LCD_CS_HIGH();
+      LcdTxBusy = 0;
+      /* Not sent, left to the next refresh */
+      (void)SSD1315_CancelRefresh(LcdCompObj);
+      ret = BSP_ERROR_BUS_FAILURE;
+    }
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Get the state of the asynchronous refresh.
+  * @param  Instance LCD Instance
+  * @param  State 1 if a transfer is on going, 0 otherwise
+  * @retval BSP status
+  */
+int32_t BSP_LCD_GetRefreshState(uint32_t Instance, uint32_t *State)
+{
+  int32_t ret = BSP_ERROR_NONE;
+
+  if(Instance >= LCD_INSTANCES_NBR)
+  {
+    ret = BSP_ERROR_WRONG_PARAM;
+  }
+  else
+  {
+    *State = LcdTxBusy;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  End of an asynchronous refresh, called under interrupt.
+  * @param  Instance LCD Instance
+  * @retval None
+  */
+__weak void BSP_LCD_RefreshCpltCallback(uint32_t Instance)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(Instance);
+}
+
+/**
+  * @brief  End of the DMA transfer on SPI1.
+  * @retval None
+  */
+void BSP_SPI1_TxCpltCallback(void)
+{
+  if(LcdTxBusy != 0U)
+  {
+    LCD_DC_LOW();
+    LCD_CS_HIGH();
+    LcdTxBusy = 0;
+    BSP_LCD_RefreshCpltCallback(0);
+  }
+}
+
 /**
   * @brief  Set Page.
   * @param  Instance LCD Instance
@@ -767,6 +869,41 @@ int32_t BSP_LCD_FillRGBRect(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uin
   return ret;
 }
 
+/**
+  * @brief  Draw a glyph given column by column in the page organization of the LCD.
+  * @param  Instance LCD Instance.
+  * @param  Xpos X position.
+  * @param  Ypos Y position.
+  * @param  pData Pointer to the glyph columns, (Height + 7) / 8 bytes per column
+  * @param  Width width of the glyph.
+  * @param  Height height of the glyph.
+  * @param  TextColor color of the glyph pixels.
+  * @param  BackColor color of the background pixels.
+  * @retval BSP status.
+  */
+int32_t BSP_LCD_DrawGlyph(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint8_t *pData, uint32_t Width, uint32_t Height, uint32_t TextColor, uint32_t BackColor)
+{
+  int32_t ret = BSP_ERROR_NONE;
+
+  if(Instance >= LCD_INSTANCES_NBR)
+  {
+    ret = BSP_ERROR_WRONG_PARAM;
+  }
+  else if(LcdDrv->DrawGlyph != NULL)
+  {
+    if (LcdDrv->DrawGlyph(LcdCompObj, Xpos, Ypos, pData, Width, Height, TextColor, BackColor) < 0)
+    {
+      ret = BSP_ERROR_COMPONENT_FAILURE;
+    }
+  }
+  else
+  {
+    ret = BSP_ERROR_FEATURE_NOT_SUPPORTED;
+  }
+
+  return ret;
+}
+
 /**
   * @brief  Draws an horizontal line
   * @param  Instance LCD instance
@@ -976,7 +1113,20 @@ int32_t BSP_LCD_WriteReg(uint16_t Reg, uint8_t *pData, uint16_t Length)
 int32_t BSP_LCD_SendData(uint8_t *pData, uint16_t Length)
 {
   int32_t ret = BSP_ERROR_NONE;
-  if(Length==1)
+
+  /* The bus may still be used by an asynchronous refresh */
+  if(LCD_IO_WaitTransfer() != BSP_ERROR_NONE)
+  {
+    /* The refresh is stuck: stop it to release the bus, the part of the
+       display it was sending is sent again by the next refresh */
+    (void)HAL_SPI_Abort(&hbus_spi1);
+    LCD_DC_LOW();
+    LCD_CS_HIGH();
+    LcdTxBusy = 0;
+    (void)SSD1315_CancelRefresh(LcdCompObj);
+    ret = BSP_ERROR_BUS_FAILURE;
+  }
+  else if(Length==1)
   {
     /* Reset LCD control line CS */
     LCD_CS_LOW();
@@ -1181,6 +1331,28 @@ static int32_t LCD_IO_DeInit(void)
 
   return BSP_ERROR_NONE;
 }
+
+/**
+  * @brief  Wait the end of an asynchronous refresh before using the bus
+  * @retval BSP status, BSP_ERROR_BUS_FAILURE if the transfer is not over
+  *         after BUS_SPI1_TIMEOUT
+  */
+static int32_t LCD_IO_WaitTransfer(void)
+{
+  int32_t  ret = BSP_ERROR_NONE;
+  uint32_t tickstart = HAL_GetTick();
+
+  while(LcdTxBusy != 0U)
+  {
+    if((HAL_GetTick() - tickstart) >= BUS_SPI1_TIMEOUT)
+    {
+      ret = BSP_ERROR_BUS_FAILURE;
+      break;
+    }
+  }
+
+  return ret;
+}
 /**
   * @}
   */
@@ -150,6 +150,9 @@ int32_t  BSP_LCD_GetPixelFormat(uint32_t Instance, uint32_t *PixelFormat);
 int32_t  BSP_LCD_SetOrientation(uint32_t Instance, uint32_t Orientation);
 int32_t  BSP_LCD_GetOrientation(uint32_t Instance, uint32_t *Orientation);
 int32_t  BSP_LCD_Refresh(uint32_t Instance);
+int32_t  BSP_LCD_RefreshAsync(uint32_t Instance);
+int32_t  BSP_LCD_GetRefreshState(uint32_t Instance, uint32_t *State);
+void     BSP_LCD_RefreshCpltCallback(uint32_t Instance);
 int32_t  BSP_LCD_SetPage(uint32_t Instance, uint16_t Page);
 int32_t  BSP_LCD_SetColumn(uint32_t Instance, uint16_t Column);
 int32_t  BSP_LCD_ScrollingSetup(uint32_t Instance, uint16_t ScrollMode, uint16_t StartPage, uint16_t EndPage, uint16_t Frequency);
@@ -162,6 +165,7 @@ int32_t  BSP_LCD_DrawHLine(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint
 int32_t  BSP_LCD_DrawVLine(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Length, uint32_t Color);
 int32_t  BSP_LCD_FillRect(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Width, uint32_t Height, uint32_t Color);
 int32_t  BSP_LCD_FillRGBRect(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint8_t *pData, uint32_t Width, uint32_t Height);
+int32_t  BSP_LCD_DrawGlyph(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint8_t *pData, uint32_t Width, uint32_t Height, uint32_t TextColor, uint32_t BackColor);
 int32_t  BSP_LCD_ReadPixel(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t *Color);
 int32_t  BSP_LCD_WritePixel(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Color);
 int32_t  BSP_LCD_Clear(uint32_t Instance, uint32_t Color);
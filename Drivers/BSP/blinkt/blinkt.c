@@ -20,6 +20,11 @@
 #include "app_conf.h"
 #include <string.h>
 
+/* Apply a gamma correction to the Leds levels so that the brightness looks linear */
+#ifndef BLINKT_GAMMA_CORRECTION
+#define BLINKT_GAMMA_CORRECTION 0
+#endif
+
 #define FRAME_START_SIZE    32
 #define LEDX_START_SIZE     3
 #define LEDX_BRIGHT_SIZE    5
@@ -29,6 +34,18 @@
 #define FRAME_END_SIZE      32
 #define LED_LEVEL_MAX       256
 
+#define LEDX_START_BRIGHT   0xFF    /* 3 start bits and full brightness */
+#define FRAME_END_BYTE      0xFF
+
+#define HUE_MAX             360   /* Hue in degrees */
+#define HUE_SECTOR_NB       6
+
+#if (BLINKT_GAMMA_CORRECTION != 0)
+#define LED_OUTPUT(level)   (gamma_table[(level)])
+#else
+#define LED_OUTPUT(level)   (level)
+#endif
+
 #define BIT_1(inst)                                                            \
         do{                                                                    \
           LL_GPIO_SetOutputPin(data_port[inst], data_pin[inst]);               \
@@ -52,7 +69,32 @@ struct led_level_t
 
 
 static void BLINKT_refreshDisplay(uint8_t instance);
-static void BLINKT_HSVtoRGB(float h_f, float s_f, float v_f, uint8_t *r_p, uint8_t *g_p, uint8_t *b_p);
+static void BLINKT_sendFrameGPIO(uint8_t instance, const uint8_t *frame);
+static void BLINKT_sendFrameSPI(uint8_t instance);
+static void BLINKT_HSVtoRGB(uint32_t hue, uint8_t sat, uint8_t val, uint8_t *r_p, uint8_t *g_p, uint8_t *b_p);
+
+#if (BLINKT_GAMMA_CORRECTION != 0)
+/* Gamma 2.2, the non null levels stay visible */
+static const uint8_t gamma_table[LED_LEVEL_MAX] =
+{
+    0,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+    1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+    3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+    6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+   12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+   20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+   30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+   42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+   56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+   73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+   91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+  113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+  137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+  163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+  192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+  223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255
+};
+#endif
 
 /* Private variable */
 GPIO_TypeDef *clk_port[BAR_INSTANCE], *data_port[BAR_INSTANCE];
@@ -62,6 +104,11 @@ struct led_level_t leds_values_tmp[BAR_INSTANCE][LEDS_COUNT];
 BLINKT_BAR_GRAPH_MODE_t bar_graph_mode[BAR_INSTANCE];
 BLINKT_ANIMATION_MODE_t animation_mode;
 uint32_t animation_param_a;
+SPI_HandleTypeDef *spi_handle[BAR_INSTANCE];
+/* Frame under transfer by the DMA, must not change before the end of the transfer */
+uint8_t spi_frame[BAR_INSTANCE][BLINKT_FRAME_SIZE];
+/* Refresh requested during a transfer, sent at its end */
+volatile uint8_t spi_pending[BAR_INSTANCE];
 
 
 void BLINKT_Init(uint8_t instance, GPIO_TypeDef *clk_port_param, uint32_t clk_pin_param, GPIO_TypeDef *data_port_param, uint32_t data_pin_param)
@@ -79,6 +126,17 @@ void BLINKT_Init(uint8_t instance, GPIO_TypeDef *clk_port_param, uint32_t clk_pi
   return;
 }
 
+void BLINKT_InitSPI(uint8_t instance, SPI_HandleTypeDef *hspi)
+{
+  spi_handle[instance] = hspi;
+
+  bar_graph_mode[instance] = BLINKT_BAR_GRAPH_MODE_BLUE;
+
+  animation_mode = BLINKT_ANINATION_MODE_RAINBOW;
+  BLINKT_SetOff(instance);
+  return;
+}
+
 void BLINKT_SetOn(uint8_t instance)
 {
   BLINKT_SetLedColor(instance, BLINKT_LED_ALL, BLINKT_COLOR_DEFAULT);
@@ -280,7 +338,6 @@ void BLINKT_SetBarGraphLevel(uint8_t instance, uint8_t level) {
 void BLINKT_SetRainbow(uint8_t instance, uint16_t hue_val, uint16_t spacing) {
   uint8_t n;
   uint32_t hue, offset;
-  float h_f;
 
   //hue = HAL_GetTick() % 360;/* value between 0 and 359 */
   hue = hue_val % 360;/* value between 0 and 359 */
@@ -288,9 +345,8 @@ void BLINKT_SetRainbow(uint8_t instance, uint16_t hue_val, uint16_t spacing) {
   for( n = 0 ; n < LEDS_COUNT ; n++)
   {
     offset = n * spacing;
-    h_f = ((hue + offset) % 360) / 360.0;
 
-    BLINKT_HSVtoRGB(h_f, 1.0, 1.0, &leds_values[instance][n].red, 
+    BLINKT_HSVtoRGB((hue + offset) % HUE_MAX, 255, 255, &leds_values[instance][n].red, 
                                    &leds_values[instance][n].green, 
                                    &leds_values[instance][n].blue);
   }
@@ -391,7 +447,6 @@ void BLINKT_SetAnimationMode(BLINKT_ANIMATION_MODE_t mode, uint32_t param_a) {
 void BLINKT_AnimationStep(uint32_t val_a) {
   uint32_t i, n, hue, offset;
   uint32_t i_next, n_next;
-  float h_f;
   
   switch(animation_mode)
   {
@@ -403,9 +458,8 @@ void BLINKT_AnimationStep(uint32_t val_a) {
         for( n = 0 ; n < LEDS_COUNT ; n++)
         {
           offset = (i + 1) * n * animation_param_a;
-          h_f = ((hue + offset) % 360) / 360.0;
 
-          BLINKT_HSVtoRGB(h_f, 1.0, 1.0, &leds_values[i][n].red, 
+          BLINKT_HSVtoRGB((hue + offset) % HUE_MAX, 255, 255, &leds_values[i][n].red, 
                                          &leds_values[i][n].green, 
                                          &leds_values[i][n].blue);
         }
@@ -484,138 +538,152 @@ void BLINKT_AnimationStep(uint32_t val_a) {
   return;
 }
 
+void BLINKT_EncodeFrame(uint8_t instance, uint8_t *frame) {
+  uint8_t i, n;
+
+  for( i = 0 ; i < (FRAME_START_SIZE / 8) ; i++)
+  {
+    *frame++ = 0x00;
+  }
+  for( n = 0 ; n < LEDS_COUNT ; n++)
+  {
+    *frame++ = LEDX_START_BRIGHT;
+    *frame++ = LED_OUTPUT(leds_values[instance][n].blue);
+    *frame++ = LED_OUTPUT(leds_values[instance][n].green);
+    *frame++ = LED_OUTPUT(leds_values[instance][n].red);
+  }
+  for( i = 0 ; i < (FRAME_END_SIZE / 8) ; i++)
+  {
+    *frame++ = FRAME_END_BYTE;
+  }
+  return;
+}
+
 static void BLINKT_refreshDisplay(uint8_t instance) {
+  uint8_t frame[BLINKT_FRAME_SIZE];
+
+  if( spi_handle[instance] != NULL )
+  {
+    BLINKT_sendFrameSPI(instance);
+  }
+  else if( (clk_port[instance] != 0) && (data_port[instance] != 0))
+  {
+    BLINKT_EncodeFrame(instance, frame);
+    BLINKT_sendFrameGPIO(instance, frame);
+  }
+  return;
+}
+
+static void BLINKT_sendFrameGPIO(uint8_t instance, const uint8_t *frame) {
   uint8_t i, n;
-  
-  if( (clk_port[instance] != 0) && (data_port[instance] != 0))
+
+  for( n = 0 ; n < BLINKT_FRAME_SIZE ; n++)
   {
-    for( i = 0 ; i < FRAME_START_SIZE ; i++)
-    {
-      BIT_0(instance);
-    }
-    for( n = 0 ; n < LEDS_COUNT ; n++)
+    for( i = 0 ; i < 8 ; i++)
     {
-      for( i = 0 ; i < (LEDX_START_SIZE + LEDX_BRIGHT_SIZE) ; i++)
+      if( (frame[n] & (0x80 >> i)) != 0 )
       {
         BIT_1(instance);
       }
-      for( i = 0 ; i < LEDX_BLUE_SIZE ; i++)
+      else
       {
-        if( (leds_values[instance][n].blue & (0x01 << (LEDX_BLUE_SIZE - 1 - i))) != 0 )
-        {
-          BIT_1(instance);
-        }
-        else
-        {
-          BIT_0(instance);
-        }
-      }
-      for( i = 0 ; i < LEDX_GREEN_SIZE ; i++)
-      {
-        if( (leds_values[instance][n].green & (0x01 << (LEDX_GREEN_SIZE - 1 - i))) != 0 )
-        {
-          BIT_1(instance);
-        }
-        else
-        {
-          BIT_0(instance);
-        }
-      }
-      for( i = 0 ; i < LEDX_RED_SIZE ; i++)
-      {
-        if( (leds_values[instance][n].red & (0x01 << (LEDX_RED_SIZE - 1 - i))) != 0 )
-        {
-          BIT_1(instance);
-        }
-        else
-        {
-          BIT_0(instance);
-        }
+        BIT_0(instance);
       }
     }
-    for( i = 0 ; i < FRAME_END_SIZE ; i++)
+  }
+  return;
+}
+
+static void BLINKT_sendFrameSPI(uint8_t instance) {
+  /* Set first : when the previous frame is still sent, its end sends this refresh. The state
+   * can not change between the test and the clear, no transfer is ongoing when ready */
+  spi_pending[instance] = 1;
+  if( HAL_SPI_GetState(spi_handle[instance]) == HAL_SPI_STATE_READY )
+  {
+    spi_pending[instance] = 0;
+    BLINKT_EncodeFrame(instance, spi_frame[instance]);
+    (void)HAL_SPI_Transmit_DMA(spi_handle[instance], spi_frame[instance], BLINKT_FRAME_SIZE);
+  }
+  return;
+}
+
+void BLINKT_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi) {
+  uint8_t instance;
+
+  for( instance = 0 ; instance < BAR_INSTANCE ; instance++)
+  {
+    if( (spi_handle[instance] == hspi) && (spi_pending[instance] != 0) )
     {
-      BIT_1(instance);
+      spi_pending[instance] = 0;
+      BLINKT_EncodeFrame(instance, spi_frame[instance]);
+      (void)HAL_SPI_Transmit_DMA(hspi, spi_frame[instance], BLINKT_FRAME_SIZE);
     }
   }
   return;
 }
 
-static void BLINKT_HSVtoRGB(float h_f, float s_f, float v_f, uint8_t *r_p, uint8_t *g_p, uint8_t *b_p) {
-  float S, H, V, F, M, N, K;
-  float r_f, g_f, b_f;
-  uint32_t I;
-
-  S = s_f;  /* Saturation */
-  H = h_f;  /* Hue */
-  V = v_f;  /* value or brightness */
+/* Integer conversion : the levels are the exact fractions of 255 truncated.
+ * sat and val are in 1/255, hue in degrees from 0 to 359 */
+static void BLINKT_HSVtoRGB(uint32_t hue, uint8_t sat, uint8_t val, uint8_t *r_p, uint8_t *g_p, uint8_t *b_p) {
+  uint32_t sector, frac;
+  uint8_t m, n, k;
 
-  if ( S == 0.0 )
+  if ( sat == 0 )
   {
     /*
      * Achromatic case, set level of grey
      */
-    *r_p = (uint8_t)V;
-    *g_p = (uint8_t)V;
-    *b_p = (uint8_t)V;
-  } else {
-    /*
-     * Determine levels of primary colours.
-     */
-    if (H >= 1.0)
-    {
-       H = 0.0;
-    } else {
-       H = H * 6;
-    }
-    I = (int) H;   /* should be in the range 0..5 */
-    F = H - I;     /* fractional part */
+    *r_p = val;
+    *g_p = val;
+    *b_p = val;
+    return;
+  }
 
-    M = V * (1 - S);
-    N = V * (1 - S * F);
-    K = V * (1 - S * (1 - F));
+  /*
+   * Determine levels of primary colours.
+   * frac is the position in the sector, in 1/HUE_MAX
+   */
+  hue    = (hue % HUE_MAX) * HUE_SECTOR_NB;
+  sector = hue / HUE_MAX;
+  frac   = hue % HUE_MAX;
 
-    if (I == 0)
-    {
-      r_f = V;
-      g_f = K;
-      b_f = M;
-    }
-    if (I == 1)
-    {
-      r_f = N;
-      g_f = V;
-      b_f = M;
-    }
-    if (I == 2)
-    {
-      r_f = M;
-      g_f = V;
-      b_f = K;
-    }
-    if (I == 3)
-    {
-      r_f = M;
-      g_f = N;
-      b_f = V;
-    }
-    if (I == 4)
-    {
-      r_f = K;
-      g_f = M;
-      b_f = V;
-    }
-    if (I == 5)
-    {
-      r_f = V;
-      g_f = M;
-      b_f = N;
-    }
-  }
+  m = (uint8_t)((val * (255U - sat)) / 255U);
+  n = (uint8_t)((val * ((255U * HUE_MAX) - (sat * frac))) / (255U * HUE_MAX));
+  k = (uint8_t)((val * ((255U * HUE_MAX) - (sat * (HUE_MAX - frac)))) / (255U * HUE_MAX));
 
-  *r_p = (uint8_t)(r_f * 255.0f);
-  *g_p = (uint8_t)(g_f * 255.0f);
-  *b_p = (uint8_t)(b_f * 255.0f);
+  switch(sector)
+  {
+    case 0:
+      *r_p = val;
+      *g_p = k;
+      *b_p = m;
+      break;
+    case 1:
+      *r_p = n;
+      *g_p = val;
+      *b_p = m;
+      break;
+    case 2:
+      *r_p = m;
+      *g_p = val;
+      *b_p = k;
+      break;
+    case 3:
+      *r_p = m;
+      *g_p = n;
+      *b_p = val;
+      break;
+    case 4:
+      *r_p = k;
+      *g_p = m;
+      *b_p = val;
+      break;
+    default:
+      *r_p = val;
+      *g_p = m;
+      *b_p = n;
+      break;
+  }
 
   return;
 }
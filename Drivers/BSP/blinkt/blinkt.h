@@ -34,6 +34,9 @@ extern C {
 #define LEDS_COUNT          8
 #define BAR_GRAPH_LEVEL_MAX 256
 
+/* APA102 frame : 4 bytes start frame, 4 bytes per Led, 4 bytes end frame */
+#define BLINKT_FRAME_SIZE   (4 + (4 * LEDS_COUNT) + 4)
+
 /**
  * @brief  BLINKT color enumeration
  */
@@ -100,6 +103,37 @@ enum {
  */
 void BLINKT_Init(uint8_t instance, GPIO_TypeDef *clk_port_param, uint32_t clk_pin_param, GPIO_TypeDef *data_port_param, uint32_t data_pin_param);
 
+/**
+ * @brief  Initializes BLINKT Led driven by a SPI with DMA instead of GPIO bit-banging
+ * @note   The SPI must be initialized by the application in master transmit mode,
+ *         8 bits, MSB first, CPOL low and CPHA 1 edge, with a Tx DMA channel linked.
+ *         The Leds clock and data must be wired on the SPI SCK and MOSI pins: on the
+ *         STM32WB5MM-DK, the Arduino connector pins used by the Roller Shutter application
+ *         (PB2/PD13) are not, it keeps BLINKT_Init.
+ *         A refresh requested during a transfer is sent by BLINKT_SPI_TxCpltCallback.
+ * @param  instance: instance of he led bar, up to BAR_INSTANCE-1
+ * @param  hspi: SPI handle
+ * @retval None
+ */
+void BLINKT_InitSPI(uint8_t instance, SPI_HandleTypeDef *hspi);
+
+/**
+ * @brief  End of a SPI transfer, sends the refresh requested during the transfer if any
+ * @note   To call from HAL_SPI_TxCpltCallback when BLINKT_InitSPI is used
+ * @param  hspi: SPI handle of the completed transfer
+ * @retval None
+ */
+void BLINKT_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi);
+
+/**
+ * @brief  Build the APA102 frame of the current Leds levels
+ * @note   This is the exact bit sequence sent on the data line, MSB first
+ * @param  instance: instance of he led bar, up to BAR_INSTANCE-1
+ * @param  frame: buffer of BLINKT_FRAME_SIZE bytes
+ * @retval None
+ */
+void BLINKT_EncodeFrame(uint8_t instance, uint8_t *frame);
+
 /**
  * @brief  Set all Leds ON to the default color
  * @param  instance: instance of he led bar, up to BAR_INSTANCE-1
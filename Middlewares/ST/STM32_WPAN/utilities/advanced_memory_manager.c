@@ -36,6 +36,12 @@ typedef struct __attribute__((packed, aligned(4))) VirtualMemoryInfo
   uint32_t RequiredSize;
   /* Current occupation of the Virtual Memory buffer with a multiple of 32bits */
   uint32_t OccupiedSize;
+  /* Highest occupation of the Virtual Memory buffer with a multiple of 32bits */
+  uint32_t HighWaterMark;
+  /* Allocations refused for lack of reserved plus shared space */
+  uint32_t SizeFailureNb;
+  /* Allocations refused by the Basic Memory Manager */
+  uint32_t AllocationFailureNb;
 }VirtualMemoryInfo_t;
 
 /* Private defines -----------------------------------------------------------*/
@@ -67,6 +73,12 @@ typedef struct __attribute__((packed, aligned(4))) VirtualMemoryInfo
 /* Mask of the Buffer Size field in Virtual Memory Header */
 #define VIRTUAL_MEMORY_HEADER_BUFFER_SIZE_MASK 0x00FFFFFF
 
+/* Timestamp used to measure the retry latency, to be defined in utilities_conf.h,
+   all the retries fall in the first latency bucket otherwise */
+#ifndef AMM_GET_TIMESTAMP
+#define AMM_GET_TIMESTAMP()   (0u)
+#endif
+
 /* Private macros ------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 
@@ -100,6 +112,20 @@ static AMM_VirtualMemoryCallbackHeader_t AmmPendingCallback;
 /* Pointer on the first element of the active callbacks */
 static AMM_VirtualMemoryCallbackHeader_t AmmActiveCallback;
 
+/* Callback being invoked by the background process */
+static AMM_VirtualMemoryCallbackFunction_t * p_AmmRetryingCallback;
+
+/* Last failed retry put back in the pending callbacks by the background process */
+static AMM_VirtualMemoryCallbackFunction_t * p_AmmPendingRetryTail;
+
+/* Statistics of the shared pool, same meaning as in the Virtual Memory info */
+static uint32_t AmmSharedHighWaterMark;
+static uint32_t AmmSharedSizeFailureNb;
+static uint32_t AmmSharedAllocationFailureNb;
+
+/* Retry statistics */
+static AMM_Stats_t AmmStats;
+
 /* Global variables ----------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 
@@ -122,6 +148,20 @@ static inline void passPendingToActive (void);
  */
 static inline AMM_VirtualMemoryCallbackFunction_t * popActive (void);
 
+/**
+ * @brief  Check if a callback structure is already in the Pending or Active FIFO
+ * @param  p_CallbackElt: Pointer onto the callback to look for
+ * @return TRUE if the callback is waiting
+ */
+static inline uint8_t isWaiting (AMM_VirtualMemoryCallbackFunction_t * const p_CallbackElt);
+
+/**
+ * @brief  Update the shared pool and retry statistics after a successful allocation
+ * @param  p_CallbackElt: Pointer onto the callback given for the allocation
+ * @return None
+ */
+static inline void countAllocation (AMM_VirtualMemoryCallbackFunction_t * const p_CallbackElt);
+
 /* Functions Definition ------------------------------------------------------*/
 
 AMM_Function_Error_t AMM_Init (const AMM_InitParameters_t * const p_InitParams)
@@ -211,6 +251,14 @@ AMM_Function_Error_t AMM_Init (const AMM_InitParameters_t * const p_InitParams)
       AmmPendingCallback.prev = NULL;
       AmmActiveCallback.next = NULL;
       AmmActiveCallback.prev = NULL;
+      p_AmmRetryingCallback = NULL;
+      p_AmmPendingRetryTail = NULL;
+
+      /* Init all private variables: Statistics relative */
+      AmmSharedHighWaterMark = 0x00;
+      AmmSharedSizeFailureNb = 0x00;
+      AmmSharedAllocationFailureNb = 0x00;
+      memset (&AmmStats, 0x00, sizeof (AmmStats));
 
       /* First get the Basic Memory Manager functions back */
       AMM_RegisterBasicMemoryManager (&AmmBmmFunctionsHandler);
@@ -264,10 +312,15 @@ AMM_Function_Error_t AMM_Init (const AMM_InitParameters_t * const p_InitParams)
             p_AmmVirtualMemoryList[memIdx].Id = p_InitParams->p_VirtualMemoryConfigList[memIdx].Id;
             p_AmmVirtualMemoryList[memIdx].RequiredSize = p_InitParams->p_VirtualMemoryConfigList[memIdx].BufferSize;
             p_AmmVirtualMemoryList[memIdx].OccupiedSize = 0x00;
+            p_AmmVirtualMemoryList[memIdx].HighWaterMark = 0x00;
+            p_AmmVirtualMemoryList[memIdx].SizeFailureNb = 0x00;
+            p_AmmVirtualMemoryList[memIdx].AllocationFailureNb = 0x00;
 
             AmmRequiredVirtualMemorySize = AmmRequiredVirtualMemorySize + p_AmmVirtualMemoryList[memIdx].RequiredSize;
           }
 
+          AmmSharedHighWaterMark = AmmOccupiedSharedPoolSize;
+
           /* Set init flag */
           AmmInitialized = INITIALIZED;
 
@@ -362,10 +415,14 @@ AMM_Function_Error_t AMM_Alloc (const uint8_t VirtualMemoryId,
         /* Actualize the current memory occupation of the shared space */
         AmmOccupiedSharedPoolSize = AmmOccupiedSharedPoolSize + BufferSize + VIRTUAL_MEMORY_HEADER_SIZE;
 
+        countAllocation (p_CallBackFunction);
+
         error = AMM_ERROR_OK;
       }
       else
       {
+        AmmSharedAllocationFailureNb++;
+
         /* Register the callback for a future retry */
         pushPending (p_CallBackFunction);
 
@@ -374,6 +431,8 @@ AMM_Function_Error_t AMM_Alloc (const uint8_t VirtualMemoryId,
     }
     else
     {
+      AmmSharedSizeFailureNb++;
+
       /* Register the callback for a future retry */
       pushPending (p_CallBackFunction);
 
@@ -439,10 +498,20 @@ AMM_Function_Error_t AMM_Alloc (const uint8_t VirtualMemoryId,
                                           + VIRTUAL_MEMORY_HEADER_SIZE;
             }
 
+            /* Actualize our highest memory occupation */
+            if (p_AmmVirtualMemoryList[memIdx].HighWaterMark < p_AmmVirtualMemoryList[memIdx].OccupiedSize)
+            {
+              p_AmmVirtualMemoryList[memIdx].HighWaterMark = p_AmmVirtualMemoryList[memIdx].OccupiedSize;
+            }
+
+            countAllocation (p_CallBackFunction);
+
             error = AMM_ERROR_OK;
           }
           else
           {
+            p_AmmVirtualMemoryList[memIdx].AllocationFailureNb++;
+
             /* Register the callback for a future retry */
             pushPending (p_CallBackFunction);
 
@@ -451,6 +520,8 @@ AMM_Function_Error_t AMM_Alloc (const uint8_t VirtualMemoryId,
         }
         else
         {
+          p_AmmVirtualMemoryList[memIdx].SizeFailureNb++;
+
           /* Register the callback for a future retry */
           pushPending (p_CallBackFunction);
 
@@ -472,6 +543,7 @@ AMM_Function_Error_t AMM_Free (uint32_t * const p_BufferAddr)
 
   uint8_t virtualId = 0x00;
   uint32_t allocatedSize = 0x00;
+  uint32_t sharedSize = 0x00;
 
   uint32_t * p_TmpAllocAddr = NULL;
 
@@ -502,8 +574,8 @@ AMM_Function_Error_t AMM_Free (uint32_t * const p_BufferAddr)
     p_TmpAllocAddr = (uint32_t *)(p_BufferAddr - VIRTUAL_MEMORY_HEADER_SIZE);
 
     /* Get the virtual memory information */
-    virtualId = (*p_TmpAllocAddr >> VIRTUAL_MEMORY_HEADER_ID_POS) & VIRTUAL_MEMORY_HEADER_ID_MASK;
-    allocatedSize = (*p_TmpAllocAddr >> VIRTUAL_MEMORY_HEADER_BUFFER_SIZE_POS) & VIRTUAL_MEMORY_HEADER_BUFFER_SIZE_MASK;
+    virtualId = (*p_TmpAllocAddr & VIRTUAL_MEMORY_HEADER_ID_MASK) >> VIRTUAL_MEMORY_HEADER_ID_POS;
+    allocatedSize = (*p_TmpAllocAddr & VIRTUAL_MEMORY_HEADER_BUFFER_SIZE_MASK) >> VIRTUAL_MEMORY_HEADER_BUFFER_SIZE_POS;
 
     /* Free the allocated memory */
     AmmBmmFunctionsHandler.Free(p_TmpAllocAddr);
@@ -530,10 +602,16 @@ AMM_Function_Error_t AMM_Free (uint32_t * const p_BufferAddr)
           /* Check if reserved memory is overlapped */
           if (p_AmmVirtualMemoryList[memIdx].RequiredSize < p_AmmVirtualMemoryList[memIdx].OccupiedSize)
           {
+            /* Only give back to the shared pool what this buffer took from it */
+            sharedSize = p_AmmVirtualMemoryList[memIdx].OccupiedSize - p_AmmVirtualMemoryList[memIdx].RequiredSize;
+
+            if (sharedSize > (allocatedSize + VIRTUAL_MEMORY_HEADER_SIZE))
+            {
+              sharedSize = allocatedSize + VIRTUAL_MEMORY_HEADER_SIZE;
+            }
+
             /* Update the occupation size */
-            AmmOccupiedSharedPoolSize = AmmOccupiedSharedPoolSize
-                                        - (p_AmmVirtualMemoryList[memIdx].OccupiedSize
-                                        - p_AmmVirtualMemoryList[memIdx].RequiredSize);
+            AmmOccupiedSharedPoolSize = AmmOccupiedSharedPoolSize - sharedSize;
           }
 
           /* Update the occupation size */
@@ -565,25 +643,193 @@ void AMM_BackgroundProcess (void)
 
   do
   {
+    /* Enter critical section */
+    UTIL_SEQ_ENTER_CRITICAL_SECTION ();
+
     /* Pop an active callback request */
     p_tmpCallback = popActive();
 
+    /* An allocation failing again from this callback keeps its rank */
+    p_AmmRetryingCallback = p_tmpCallback;
+
+    /* Exit critical section */
+    UTIL_SEQ_EXIT_CRITICAL_SECTION ();
+
     if (p_tmpCallback != NULL)
     {
       /* Invoke the callback for an alloc retry */
       p_tmpCallback->Callback();
     }
+
+    p_AmmRetryingCallback = NULL;
   }while (p_tmpCallback != NULL);
+
+  /* Next failed retries are the oldest of the pending ones again */
+  p_AmmPendingRetryTail = NULL;
+}
+
+AMM_Function_Error_t AMM_GetVirtualMemoryStats (const uint8_t VirtualMemoryId,
+                                                AMM_VirtualMemoryStats_t * const p_Stats)
+{
+  AMM_Function_Error_t error = AMM_ERROR_NOK;
+
+  if (AmmInitialized == NOT_INITIALIZED)
+  {
+    error = AMM_ERROR_NOT_INIT;
+  }
+  else if (p_Stats == NULL)
+  {
+    error = AMM_ERROR_BAD_POINTER;
+  }
+  else if (VirtualMemoryId == AMM_NO_VIRTUAL_ID)
+  {
+    /* Enter critical section */
+    UTIL_SEQ_ENTER_CRITICAL_SECTION ();
+
+    p_Stats->Id = AMM_NO_VIRTUAL_ID;
+    p_Stats->RequiredSize = AmmPoolSize - AmmRequiredVirtualMemorySize;
+    p_Stats->OccupiedSize = AmmOccupiedSharedPoolSize;
+    p_Stats->HighWaterMark = AmmSharedHighWaterMark;
+    p_Stats->SizeFailureNb = AmmSharedSizeFailureNb;
+    p_Stats->AllocationFailureNb = AmmSharedAllocationFailureNb;
+
+    /* Exit critical section */
+    UTIL_SEQ_EXIT_CRITICAL_SECTION ();
+
+    error = AMM_ERROR_OK;
+  }
+  else
+  {
+    error = AMM_ERROR_UNKNOWN_ID;
+
+    /* Enter critical section */
+    UTIL_SEQ_ENTER_CRITICAL_SECTION ();
+
+    for (uint32_t memIdx = 0x00;
+         (memIdx < AmmVirtualMemoryNumber) && (error == AMM_ERROR_UNKNOWN_ID);
+         memIdx++)
+    {
+      if (VirtualMemoryId == p_AmmVirtualMemoryList[memIdx].Id)
+      {
+        p_Stats->Id = VirtualMemoryId;
+        p_Stats->RequiredSize = p_AmmVirtualMemoryList[memIdx].RequiredSize;
+        p_Stats->OccupiedSize = p_AmmVirtualMemoryList[memIdx].OccupiedSize;
+        p_Stats->HighWaterMark = p_AmmVirtualMemoryList[memIdx].HighWaterMark;
+        p_Stats->SizeFailureNb = p_AmmVirtualMemoryList[memIdx].SizeFailureNb;
+        p_Stats->AllocationFailureNb = p_AmmVirtualMemoryList[memIdx].AllocationFailureNb;
+
+        error = AMM_ERROR_OK;
+      }
+    }
+
+    /* Exit critical section */
+    UTIL_SEQ_EXIT_CRITICAL_SECTION ();
+  }
+
+  return error;
+}
+
+AMM_Function_Error_t AMM_GetStats (AMM_Stats_t * const p_Stats)
+{
+  AMM_Function_Error_t error = AMM_ERROR_NOK;
+
+  if (AmmInitialized == NOT_INITIALIZED)
+  {
+    error = AMM_ERROR_NOT_INIT;
+  }
+  else if (p_Stats == NULL)
+  {
+    error = AMM_ERROR_BAD_POINTER;
+  }
+  else
+  {
+    /* Enter critical section */
+    UTIL_SEQ_ENTER_CRITICAL_SECTION ();
+
+    *p_Stats = AmmStats;
+
+    /* Exit critical section */
+    UTIL_SEQ_EXIT_CRITICAL_SECTION ();
+
+    error = AMM_ERROR_OK;
+  }
+
+  return error;
+}
+
+void AMM_ResetStats (void)
+{
+  uint32_t waitingNb;
+
+  if (AmmInitialized == INITIALIZED)
+  {
+    /* Enter critical section */
+    UTIL_SEQ_ENTER_CRITICAL_SECTION ();
+
+    /* Keep the number of callbacks still waiting */
+    waitingNb = AmmStats.WaitingNb;
+    memset (&AmmStats, 0x00, sizeof (AmmStats));
+    AmmStats.WaitingNb = waitingNb;
+    AmmStats.WaitingMaxNb = waitingNb;
+
+    AmmSharedHighWaterMark = AmmOccupiedSharedPoolSize;
+    AmmSharedSizeFailureNb = 0x00;
+    AmmSharedAllocationFailureNb = 0x00;
+
+    for (uint32_t memIdx = 0x00;
+         memIdx < AmmVirtualMemoryNumber;
+         memIdx++)
+    {
+      p_AmmVirtualMemoryList[memIdx].HighWaterMark = p_AmmVirtualMemoryList[memIdx].OccupiedSize;
+      p_AmmVirtualMemoryList[memIdx].SizeFailureNb = 0x00;
+      p_AmmVirtualMemoryList[memIdx].AllocationFailureNb = 0x00;
+    }
+
+    /* Exit critical section */
+    UTIL_SEQ_EXIT_CRITICAL_SECTION ();
+  }
 }
 
 /* Private Functions Definition ------------------------------------------------------*/
 
 void pushPending (AMM_VirtualMemoryCallbackFunction_t * const p_CallbackElt)
 {
-  if (p_CallbackElt != NULL)
+  if (p_CallbackElt == NULL)
+  {
+    /* Nothing to register */
+  }
+  else if (p_CallbackElt == p_AmmRetryingCallback)
+  {
+    /* A failed retry goes back before the callbacks registered since its first failure,
+       behind the failed retries of the same background process */
+    if (p_AmmPendingRetryTail == NULL)
+    {
+      LST_insert_head (&AmmPendingCallback, (tListNode *)p_CallbackElt);
+    }
+    else
+    {
+      LST_insert_node_after ((tListNode *)p_CallbackElt, (tListNode *)p_AmmPendingRetryTail);
+    }
+
+    p_AmmPendingRetryTail = p_CallbackElt;
+    p_AmmRetryingCallback = NULL;
+    AmmStats.WaitingNb++;
+  }
+  else if (isWaiting (p_CallbackElt) == FALSE)
   {
     /* Add the new callback */
+    p_CallbackElt->WaitStartTime = AMM_GET_TIMESTAMP ();
     LST_insert_tail (&AmmPendingCallback, (tListNode *)p_CallbackElt);
+    AmmStats.WaitingNb++;
+  }
+  else
+  {
+    /* Already waiting, keep its rank */
+  }
+
+  if (AmmStats.WaitingNb > AmmStats.WaitingMaxNb)
+  {
+    AmmStats.WaitingMaxNb = AmmStats.WaitingNb;
   }
 }
 
@@ -591,6 +837,9 @@ void passPendingToActive (void)
 {
   AMM_VirtualMemoryCallbackFunction_t * p_TmpElt = NULL;
 
+  /* The failed retries are no more in the pending callbacks */
+  p_AmmPendingRetryTail = NULL;
+
   while (LST_is_empty (&AmmPendingCallback) == FALSE)
   {
     /* Remove the head element */
@@ -608,7 +857,67 @@ AMM_VirtualMemoryCallbackFunction_t * popActive (void)
   {
     /* Remove last element */
     LST_remove_head (&AmmActiveCallback, (tListNode**)&p_error);
+
+    AmmStats.WaitingNb--;
   }
 
   return p_error;
 }
+
+uint8_t isWaiting (AMM_VirtualMemoryCallbackFunction_t * const p_CallbackElt)
+{
+  tListNode * p_TmpNode = NULL;
+  uint8_t waiting = FALSE;
+
+  /* Look in the pending callbacks */
+  LST_get_next_node (&AmmPendingCallback, &p_TmpNode);
+  while ((p_TmpNode != &AmmPendingCallback) && (waiting == FALSE))
+  {
+    waiting = (p_TmpNode == (tListNode *)p_CallbackElt);
+    LST_get_next_node (p_TmpNode, &p_TmpNode);
+  }
+
+  /* Look in the active callbacks */
+  LST_get_next_node (&AmmActiveCallback, &p_TmpNode);
+  while ((p_TmpNode != &AmmActiveCallback) && (waiting == FALSE))
+  {
+    waiting = (p_TmpNode == (tListNode *)p_CallbackElt);
+    LST_get_next_node (p_TmpNode, &p_TmpNode);
+  }
+
+  return waiting;
+}
+
+void countAllocation (AMM_VirtualMemoryCallbackFunction_t * const p_CallbackElt)
+{
+  uint32_t latency = 0x00;
+  uint32_t bucket = 0x00;
+
+  /* Update the shared pool high water mark */
+  if (AmmOccupiedSharedPoolSize > AmmSharedHighWaterMark)
+  {
+    AmmSharedHighWaterMark = AmmOccupiedSharedPoolSize;
+  }
+
+  /* Check if this is a successful retry from the background process */
+  if ((p_CallbackElt != NULL) && (p_CallbackElt == p_AmmRetryingCallback))
+  {
+    latency = AMM_GET_TIMESTAMP () - p_CallbackElt->WaitStartTime;
+
+    /* Bucket n holds the latencies from 2^n to 2^(n+1) - 1 */
+    while (((latency >> bucket) > 0x01) && (bucket < (AMM_RETRY_LATENCY_NB - 1)))
+    {
+      bucket++;
+    }
+
+    AmmStats.RetryNb++;
+    AmmStats.RetryLatency[bucket]++;
+
+    if (latency > AmmStats.RetryLatencyMax)
+    {
+      AmmStats.RetryLatencyMax = latency;
+    }
+
+    p_AmmRetryingCallback = NULL;
+  }
+}
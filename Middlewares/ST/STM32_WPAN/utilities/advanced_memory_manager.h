@@ -41,8 +41,26 @@
  * - sizeOfDesiredPool = 8092
  * - numberOfVirtualMemory = 3
  * - actualSizeOfThePoolToGive = sizeOfDesiredPool + numberOfVirtualMemory * AMM_VIRTUAL_INFO_ELEMENT_SIZE
+ *
+ * The element holds the occupation and the statistics of the Virtual Memory.
+ *
+ * @note The element grew from 3 to 6 words when the statistics were added: a pool sized
+ * with the former value is 3 words short per Virtual Memory, and AMM_Init returns
+ * AMM_ERROR_BAD_VIRTUAL_CONFIG when the reserved sizes no longer fit in it.
  */
-#define AMM_VIRTUAL_INFO_ELEMENT_SIZE 0x3u
+#define AMM_VIRTUAL_INFO_ELEMENT_SIZE 0x6u
+
+/**
+ * @brief Number of buckets of the retry latency histogram
+ *
+ * @details Bucket n counts the retries served after 2^n to 2^(n+1) - 1 ticks of
+ * AMM_GET_TIMESTAMP, the first and last buckets also count the shorter and longer ones.
+ *
+ * @note AMM_GET_TIMESTAMP is to be mapped on a time base in utilities_conf.h, none of
+ * the applications defines it. Without it every retry is counted in the first bucket
+ * and the histogram gives no latency.
+ */
+#define AMM_RETRY_LATENCY_NB 12u
 
 /* Exported types ------------------------------------------------------------*/
 /* Redefine the header for chained list */
@@ -142,8 +160,48 @@ typedef struct AMM_VirtualMemoryCallbackFunction
   AMM_VirtualMemoryCallbackHeader_t Header;
   /* Callback function pointer to invoke once memory has been freed */
   void (* Callback) (void);
+  /* Time of the first failed allocation - Managed by the AMM - */
+  uint32_t WaitStartTime;
 }AMM_VirtualMemoryCallbackFunction_t;
 
+/**
+ * @brief   Virtual Memory statistics struct
+ *
+ * @details Sizes are multiples of 32bits and include the allocation headers.
+ */
+typedef struct AMM_VirtualMemoryStats
+{
+  /* ID of the Virtual Memory, AMM_NO_VIRTUAL_ID for the shared pool */
+  uint8_t Id;
+  /* Size reserved for this Virtual Memory, pool size not reserved by any Virtual Memory for the shared pool */
+  uint32_t RequiredSize;
+  /* Current occupation */
+  uint32_t OccupiedSize;
+  /* Highest occupation since the init or the last reset */
+  uint32_t HighWaterMark;
+  /* Allocations refused because the Virtual Memory plus the shared pool were too small */
+  uint32_t SizeFailureNb;
+  /* Allocations refused by the Basic Memory Manager, ie the pool is fragmented */
+  uint32_t AllocationFailureNb;
+}AMM_VirtualMemoryStats_t;
+
+/**
+ * @brief   Retry statistics struct
+ */
+typedef struct AMM_Stats
+{
+  /* Allocations that succeeded on a retry from AMM_BackgroundProcess */
+  uint32_t RetryNb;
+  /* Histogram of the time between the first failure and the successful retry */
+  uint32_t RetryLatency[AMM_RETRY_LATENCY_NB];
+  /* Longest time between the first failure and the successful retry */
+  uint32_t RetryLatencyMax;
+  /* Callbacks currently waiting for a retry */
+  uint32_t WaitingNb;
+  /* Highest number of callbacks waiting for a retry */
+  uint32_t WaitingMaxNb;
+}AMM_Stats_t;
+
 /* Exported constants --------------------------------------------------------*/
 /* External variables --------------------------------------------------------*/
 /* Exported macros -----------------------------------------------------------*/
@@ -182,6 +240,7 @@ AMM_Function_Error_t AMM_DeInit (void);
                                                      = 4 * 32bits
                                                      = 128 bits
  * @param  p_CallBackFunction: Pointer onto the Callback to call in case of failure - Can be NULL -
+ *                             A callback already waiting is not queued twice.
  * @param  pp_AllocBuffer: Pointer onto the allocated buffer
  * @return Status of the allocation
  * @retval AMM_Function_Error_t::AMM_ERROR_OK
@@ -213,11 +272,42 @@ AMM_Function_Error_t AMM_Free (uint32_t * const p_BufferAddr);
 
 /**
  * @brief  Background routine
- * @details Background routine that aims to call registered callbacks for an allocation retry
+ * @details Background routine that aims to call registered callbacks for an allocation retry.
+ *          Callbacks are called in the order of their first failed allocation. A callback
+ *          retrying its allocation and failing again keeps its rank for the next retry.
  * @return None
  */
 void AMM_BackgroundProcess (void);
 
+/**
+ * @brief  Get the statistics of a Virtual Memory
+ * @param  VirtualMemoryId: Virtual Memory Identifier - AMM_NO_VIRTUAL_ID for the shared pool -
+ * @param  p_Stats: Pointer onto the statistics to fill
+ * @return Status of the request
+ * @retval AMM_Function_Error_t::AMM_ERROR_OK
+ * @retval AMM_Function_Error_t::AMM_ERROR_NOT_INIT
+ * @retval AMM_Function_Error_t::AMM_ERROR_BAD_POINTER
+ * @retval AMM_Function_Error_t::AMM_ERROR_UNKNOWN_ID
+ */
+AMM_Function_Error_t AMM_GetVirtualMemoryStats (const uint8_t VirtualMemoryId,
+                                                AMM_VirtualMemoryStats_t * const p_Stats);
+
+/**
+ * @brief  Get the retry statistics
+ * @param  p_Stats: Pointer onto the statistics to fill
+ * @return Status of the request
+ * @retval AMM_Function_Error_t::AMM_ERROR_OK
+ * @retval AMM_Function_Error_t::AMM_ERROR_NOT_INIT
+ * @retval AMM_Function_Error_t::AMM_ERROR_BAD_POINTER
+ */
+AMM_Function_Error_t AMM_GetStats (AMM_Stats_t * const p_Stats);
+
+/**
+ * @brief  Reset the counters, the high water marks restart from the current occupation
+ * @return None
+ */
+void AMM_ResetStats (void);
+
 /* Exported functions to be implemented by the user if required ------------- */
 
 /**
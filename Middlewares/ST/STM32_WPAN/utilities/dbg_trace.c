@@ -19,7 +19,6 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "utilities_common.h"
-#include "stm_queue.h"
 #include "dbg_trace.h"
 
 /* Definition of the function */
@@ -50,7 +49,20 @@ size_t __write(int handle, const unsigned char * buf, size_t bufSize);
 /** @defgroup TRACE Log private defines 
  * @{
  */
+#ifndef DBG_TRACE_OVERFLOW_POLICY
+#define DBG_TRACE_OVERFLOW_POLICY   DBG_TRACE_DROP_NEWEST
+#endif
+
+/* Maximum wait for room in the queue with DBG_TRACE_BLOCK (ms) */
+#ifndef DBG_TRACE_BLOCK_TIMEOUT
+#define DBG_TRACE_BLOCK_TIMEOUT     10U
+#endif
 
+#if (DBG_TRACE_USE_CIRCULAR_QUEUE != 0)
+#if ((DBG_TRACE_MSG_QUEUE_SIZE & (DBG_TRACE_MSG_QUEUE_SIZE - 1)) != 0)
+#error "DBG_TRACE_MSG_QUEUE_SIZE shall be a power of 2"
+#endif
+#endif
 /**
  * @}
  */
@@ -59,6 +71,8 @@ size_t __write(int handle, const unsigned char * buf, size_t bufSize);
 /** @defgroup TRACE Log private macros 
  * @{
  */
+/* Position in the queue buffer of a free running index */
+#define DBG_TRACE_INDEX(X)          ((X) & (DBG_TRACE_MSG_QUEUE_SIZE - 1U))
 /**
  * @}
  */
@@ -69,9 +83,17 @@ size_t __write(int handle, const unsigned char * buf, size_t bufSize);
  */
 #if (( CFG_DEBUG_TRACE_FULL != 0 ) || ( CFG_DEBUG_TRACE_LIGHT != 0 ))
 #if (DBG_TRACE_USE_CIRCULAR_QUEUE != 0)
-static queue_t MsgDbgTraceQueue;
+/* Byte queue of the traces, the indexes are free running :
+ * Tail <= Tail + TxSize <= Commit <= Head <= Tail + DBG_TRACE_MSG_QUEUE_SIZE */
 static uint8_t MsgDbgTraceQueueBuff[DBG_TRACE_MSG_QUEUE_SIZE];
+static uint32_t DbgTraceTail;        /**< First byte not yet output */
+static uint32_t DbgTraceTxSize;      /**< Bytes under output */
+static uint32_t DbgTraceCommit;      /**< End of the bytes ready to output */
+static uint32_t DbgTraceHead;        /**< End of the reserved bytes */
+static uint32_t DbgTraceWriters;     /**< Writes copying their data in the queue */
+static uint8_t DbgTraceTxLast;       /**< Last byte given to the output */
 #endif
+static DbgTraceStats_t DbgTraceStats;
 __IO ITStatus DbgTracePeripheralReady = SET;
 #endif
 /**
@@ -92,6 +114,13 @@ __IO ITStatus DbgTracePeripheralReady = SET;
  */
 #if (( CFG_DEBUG_TRACE_FULL != 0 ) || ( CFG_DEBUG_TRACE_LIGHT != 0 ))
 static void DbgTrace_TxCpltCallback(void);
+#if (DBG_TRACE_USE_CIRCULAR_QUEUE != 0)
+static uint8_t DbgTrace_Reserve(uint32_t size, uint32_t *pPos);
+static uint8_t* DbgTrace_NextOutput(uint16_t *pSize);
+#if (DBG_TRACE_OVERFLOW_POLICY == DBG_TRACE_DROP_OLDEST)
+static void DbgTrace_DropOldest(uint32_t size);
+#endif
+#endif
 #endif
 
 
@@ -104,6 +133,130 @@ static void DbgTrace_TxCpltCallback(void);
 /** @defgroup TRACE Log Private function 
  * @{
  */
+#if (( CFG_DEBUG_TRACE_FULL != 0 ) || ( CFG_DEBUG_TRACE_LIGHT != 0 ))
+#if (DBG_TRACE_USE_CIRCULAR_QUEUE != 0)
+/**
+ * @brief  Reserve room in the trace queue, to be called with the IRQ disabled
+ * @param  size: Number of bytes to reserve
+ * @param  pPos: Returns the index of the reserved bytes
+ * @retval 1 if reserved, 0 if the queue is full
+ */
+static uint8_t DbgTrace_Reserve(uint32_t size, uint32_t *pPos)
+{
+  if (size > (DBG_TRACE_MSG_QUEUE_SIZE - (DbgTraceHead - DbgTraceTail)))
+  {
+#if (DBG_TRACE_OVERFLOW_POLICY == DBG_TRACE_DROP_OLDEST)
+    DbgTrace_DropOldest(size - (DBG_TRACE_MSG_QUEUE_SIZE - (DbgTraceHead - DbgTraceTail)));
+    if (size > (DBG_TRACE_MSG_QUEUE_SIZE - (DbgTraceHead - DbgTraceTail)))
+#endif
+    {
+      return 0;
+    }
+  }
+
+  *pPos = DbgTraceHead;
+  DbgTraceHead += size;
+  if ((DbgTraceHead - DbgTraceTail) > DbgTraceStats.MaxLevel)
+  {
+    DbgTraceStats.MaxLevel = DbgTraceHead - DbgTraceTail;
+  }
+
+  return 1;
+}
+
+/**
+ * @brief  Select the next bytes to output, to be called with the IRQ disabled
+ * @param  pSize: Returns the number of bytes to output
+ * @retval Pointer on the bytes to output, NULL if none (the output is then free)
+ */
+static uint8_t* DbgTrace_NextOutput(uint16_t *pSize)
+{
+  uint32_t size = DbgTraceCommit - DbgTraceTail;
+
+  if (size == 0U)
+  {
+    DbgTracePeripheralReady = SET;
+    return NULL;
+  }
+
+  /* Contiguous bytes up to the end of the buffer */
+  size = MIN(size, DBG_TRACE_MSG_QUEUE_SIZE - DBG_TRACE_INDEX(DbgTraceTail));
+  size = MIN(size, 0xFFFFU);
+
+  DbgTraceTxSize = size;
+  DbgTraceTxLast = MsgDbgTraceQueueBuff[DBG_TRACE_INDEX(DbgTraceTail + size - 1U)];
+  DbgTracePeripheralReady = RESET;
+  *pSize = (uint16_t)size;
+
+  return &MsgDbgTraceQueueBuff[DBG_TRACE_INDEX(DbgTraceTail)];
+}
+
+#if (DBG_TRACE_OVERFLOW_POLICY == DBG_TRACE_DROP_OLDEST)
+/**
+ * @brief  Drop the oldest lines waiting for output, to be called with the IRQ disabled
+ * @note   The bytes under output and the end of their line are kept, the following
+ *         lines are removed and the newer bytes are moved back. Nothing is dropped
+ *         while a write is copying its data, or if whole lines cannot free enough room.
+ * @param  size: Number of bytes to free
+ * @retval None
+ */
+static void DbgTrace_DropOldest(uint32_t size)
+{
+  uint32_t start = DbgTraceTail + DbgTraceTxSize;
+  uint32_t drop = 0;
+  uint32_t lines = 0;
+  uint32_t i;
+
+  if (DbgTraceWriters != 0U)
+  {
+    return;
+  }
+
+  /* Keep the end of the line partly output */
+  if (DbgTraceTxLast != '\n')
+  {
+    while ((start != DbgTraceCommit) && (MsgDbgTraceQueueBuff[DBG_TRACE_INDEX(start)] != '\n'))
+    {
+      start++;
+    }
+    if (start == DbgTraceCommit)
+    {
+      return;
+    }
+    start++;
+  }
+
+  /* Whole lines to drop */
+  for (i = start; i != DbgTraceCommit; i++)
+  {
+    if (MsgDbgTraceQueueBuff[DBG_TRACE_INDEX(i)] == '\n')
+    {
+      drop = i + 1U - start;
+      lines++;
+      if (drop >= size)
+      {
+        break;
+      }
+    }
+  }
+  if (drop < size)
+  {
+    return;
+  }
+
+  for (i = start; (i + drop) != DbgTraceCommit; i++)
+  {
+    MsgDbgTraceQueueBuff[DBG_TRACE_INDEX(i)] = MsgDbgTraceQueueBuff[DBG_TRACE_INDEX(i + drop)];
+  }
+  DbgTraceCommit -= drop;
+  DbgTraceHead = DbgTraceCommit;
+
+  DbgTraceStats.DroppedBytes += drop;
+  DbgTraceStats.DroppedMsg += lines;
+}
+#endif
+#endif
+#endif
 
 
 /* Functions Definition ------------------------------------------------------*/
@@ -172,23 +325,18 @@ static void DbgTrace_TxCpltCallback(void)
   BACKUP_PRIMASK();
 
   DISABLE_IRQ();			/**< Disable all interrupts by setting PRIMASK bit on Cortex*/
-  /* Remove element just sent to UART */
-  CircularQueue_Remove(&MsgDbgTraceQueue,&bufSize);
+  /* Release the bytes just sent to UART */
+  DbgTraceTail += DbgTraceTxSize;
+  DbgTraceTxSize = 0;
 
   /* Sense if new data to be sent */
-  buf=CircularQueue_Sense(&MsgDbgTraceQueue,&bufSize);
-
+  buf = DbgTrace_NextOutput(&bufSize);
+  RESTORE_PRIMASK();
 
   if ( buf != NULL) 
   {
-    RESTORE_PRIMASK();
-    DbgOutputTraces((uint8_t*)buf, bufSize, DbgTrace_TxCpltCallback);
+    DbgOutputTraces(buf, bufSize, DbgTrace_TxCpltCallback);
   } 
-  else
-  {
-    DbgTracePeripheralReady = SET;
-    RESTORE_PRIMASK();
-  }
 
 #else
   BACKUP_PRIMASK();
@@ -207,8 +355,14 @@ void DbgTraceInit( void )
 #if (( CFG_DEBUG_TRACE_FULL != 0 ) || ( CFG_DEBUG_TRACE_LIGHT != 0 ))
   DbgOutputInit();
 #if (DBG_TRACE_USE_CIRCULAR_QUEUE != 0)
-  CircularQueue_Init(&MsgDbgTraceQueue, MsgDbgTraceQueueBuff, DBG_TRACE_MSG_QUEUE_SIZE, 0, CIRCULAR_QUEUE_SPLIT_IF_WRAPPING_FLAG);
+  DbgTraceTail = 0;
+  DbgTraceTxSize = 0;
+  DbgTraceCommit = 0;
+  DbgTraceHead = 0;
+  DbgTraceWriters = 0;
+  DbgTraceTxLast = '\n';
 #endif 
+  memset(&DbgTraceStats, 0, sizeof(DbgTraceStats));
 #endif
   return;
 }
@@ -254,7 +408,16 @@ size_t __write(int handle, const unsigned char * buf, size_t bufSize)
 size_t DbgTraceWrite(int handle, const unsigned char * buf, size_t bufSize)
 {
   size_t chars_written = 0;
-  uint8_t* buffer;
+#if (DBG_TRACE_USE_CIRCULAR_QUEUE != 0)
+  uint8_t* buffer = NULL;
+  uint16_t size = 0;
+  uint32_t pos = 0;
+  uint32_t first;
+  uint8_t reserved;
+#if (DBG_TRACE_OVERFLOW_POLICY == DBG_TRACE_BLOCK)
+  uint32_t tickstart = HAL_GetTick();
+#endif
+#endif
 
   BACKUP_PRIMASK();
 
@@ -276,17 +439,54 @@ size_t DbgTraceWrite(int handle, const unsigned char * buf, size_t bufSize)
     /* CS Start */
 
 #if (DBG_TRACE_USE_CIRCULAR_QUEUE != 0)
+    /* Only the reservation is done with the IRQ disabled */
     DISABLE_IRQ();      /**< Disable all interrupts by setting PRIMASK bit on Cortex*/
-    buffer=CircularQueue_Add(&MsgDbgTraceQueue,(uint8_t*)buf, bufSize,1);
-    if (buffer && DbgTracePeripheralReady)
+    reserved = DbgTrace_Reserve(bufSize, &pos);
+#if (DBG_TRACE_OVERFLOW_POLICY == DBG_TRACE_BLOCK)
+    /* Wait for the output only from thread mode with the IRQ enabled */
+    if ((reserved == 0U) && (bufSize <= DBG_TRACE_MSG_QUEUE_SIZE) && (primask_bit == 0U) && (__get_IPSR() == 0U))
+    {
+      DbgTraceStats.BlockedNb++;
+      while ((reserved == 0U) && ((HAL_GetTick() - tickstart) < DBG_TRACE_BLOCK_TIMEOUT))
+      {
+        RESTORE_PRIMASK();
+        DISABLE_IRQ();
+        reserved = DbgTrace_Reserve(bufSize, &pos);
+      }
+    }
+#endif
+    if (reserved == 0U)
     {
-      DbgTracePeripheralReady = RESET;
+      DbgTraceStats.DroppedBytes += bufSize;
+      DbgTraceStats.DroppedMsg++;
       RESTORE_PRIMASK();
-      DbgOutputTraces((uint8_t*)buffer, bufSize, DbgTrace_TxCpltCallback);
     }
     else
     {
+      DbgTraceWriters++;
       RESTORE_PRIMASK();
+
+      first = MIN(bufSize, DBG_TRACE_MSG_QUEUE_SIZE - DBG_TRACE_INDEX(pos));
+      memcpy(&MsgDbgTraceQueueBuff[DBG_TRACE_INDEX(pos)], buf, first);
+      memcpy(&MsgDbgTraceQueueBuff[0], &buf[first], bufSize - first);
+
+      DISABLE_IRQ();
+      /* The bytes are output once all the writes started before are copied */
+      DbgTraceWriters--;
+      if (DbgTraceWriters == 0U)
+      {
+        DbgTraceCommit = DbgTraceHead;
+      }
+      if (DbgTracePeripheralReady)
+      {
+        buffer = DbgTrace_NextOutput(&size);
+      }
+      RESTORE_PRIMASK();
+
+      if (buffer != NULL)
+      {
+        DbgOutputTraces(buffer, size, DbgTrace_TxCpltCallback);
+      }
     }
 #else
     DISABLE_IRQ();      /**< Disable all interrupts by setting PRIMASK bit on Cortex*/
@@ -346,6 +546,40 @@ int fputc(int ch, FILE *f)
 
 #endif /* #if (( CFG_DEBUG_TRACE_FULL != 0 ) || ( CFG_DEBUG_TRACE_LIGHT != 0 )) */
 
+/**
+ * @brief Get the statistics of the trace queue
+ * @param pStats: Returns the statistics
+ * @retval None
+ */
+void DbgTraceGetStats(DbgTraceStats_t *pStats)
+{
+#if (( CFG_DEBUG_TRACE_FULL != 0 ) || ( CFG_DEBUG_TRACE_LIGHT != 0 ))
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ();
+  *pStats = DbgTraceStats;
+  RESTORE_PRIMASK();
+#else
+  memset(pStats, 0, sizeof(*pStats));
+#endif
+}
+
+/**
+ * @brief Reset the statistics of the trace queue
+ * @param None
+ * @retval None
+ */
+void DbgTraceResetStats(void)
+{
+#if (( CFG_DEBUG_TRACE_FULL != 0 ) || ( CFG_DEBUG_TRACE_LIGHT != 0 ))
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ();
+  memset(&DbgTraceStats, 0, sizeof(DbgTraceStats));
+  RESTORE_PRIMASK();
+#endif
+}
+
 /**
  * @}
  */
@@ -27,6 +27,20 @@ extern "C"
 #endif
 
 /* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t DroppedBytes;     /**< Bytes lost on a full queue */
+  uint32_t DroppedMsg;       /**< Writes lost, or lines with DBG_TRACE_DROP_OLDEST */
+  uint32_t BlockedNb;        /**< Writes that waited for room with DBG_TRACE_BLOCK */
+  uint32_t MaxLevel;         /**< Highest number of bytes in the queue */
+} DbgTraceStats_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* Policy when the trace queue is full (DBG_TRACE_OVERFLOW_POLICY) */
+#define DBG_TRACE_DROP_NEWEST   0   /**< The new write is lost */
+#define DBG_TRACE_DROP_OLDEST   1   /**< The oldest lines waiting for output are lost */
+#define DBG_TRACE_BLOCK         2   /**< Wait up to DBG_TRACE_BLOCK_TIMEOUT ms, then lose the new write */
+
 /* External variables --------------------------------------------------------*/
 /* Exported macros -----------------------------------------------------------*/
 #if ( ( CFG_DEBUG_TRACE_FULL != 0 ) || ( CFG_DEBUG_TRACE_LIGHT != 0 ) )
@@ -94,6 +108,20 @@ const char *DbgTraceGetFileName( const char *fullpath );
  */
 size_t DbgTraceWrite(int handle, const unsigned char * buf, size_t bufSize);
 
+/**
+ * @brief Get the statistics of the trace queue
+ * @param pStats: Returns the statistics
+ * @retval None
+ */
+void DbgTraceGetStats(DbgTraceStats_t *pStats);
+
+/**
+ * @brief Reset the statistics of the trace queue
+ * @param None
+ * @retval None
+ */
+void DbgTraceResetStats(void);
+
 #ifdef __cplusplus
 }
 #endif
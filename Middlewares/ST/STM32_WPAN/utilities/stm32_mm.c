@@ -49,6 +49,10 @@
  * (coalescences) adjacent memory blocks as they are freed, and in so doing
  * limits memory fragmentation.
  *
+ * Unlike heap_4.c the free blocks are not kept in a single list ordered by
+ * address but in segregated lists per size class, so that allocating and
+ * freeing take a bounded time whatever the number of free blocks.
+ *
  * See heap_1.c, heap_2.c and heap_3.c for alternative implementations, and the
  * memory management pages of https://www.FreeRTOS.org for more information.
  */
@@ -110,6 +114,12 @@
 #undef xTaskResumeAll
 #define xTaskResumeAll()  (0)
 
+#undef taskENTER_CRITICAL
+#define taskENTER_CRITICAL()
+
+#undef taskEXIT_CRITICAL
+#define taskEXIT_CRITICAL()
+
 #endif
 
 /* Block sizes must not get too small. */
@@ -130,24 +140,76 @@
 #endif /* configAPPLICATION_ALLOCATED_HEAP */
 #endif
 
-/* Define the linked list structure.  This is used to link free blocks in order
- * of their memory address. */
+/* Blocks are kept in segregated free lists, two levels of size classes in the
+ * spirit of TLSF: the first level is the power of two of the size, the second
+ * level splits it in heapSL_INDEX_COUNT linear ranges.  A bitmap per level
+ * tells which lists are not empty, so a suitable block is found without
+ * walking any list.  Blocks below heapSMALL_BLOCK_SIZE all go in the first
+ * level 0, split in ranges of portBYTE_ALIGNMENT bytes.
+ *
+ * The largest block size is ( 1 << UTIL_MM_FL_INDEX_MAX ) - portBYTE_ALIGNMENT,
+ * a larger pool is only used up to that size. */
+#ifndef UTIL_MM_FL_INDEX_MAX
+#define UTIL_MM_FL_INDEX_MAX      ( 17 )
+#endif
+
+#if ( UTIL_MM_FL_INDEX_MAX > 31 )
+    #error UTIL_MM_FL_INDEX_MAX must be lower than 32
+#endif
+
+#define heapSL_INDEX_COUNT_LOG2   ( 3 )
+#define heapSL_INDEX_COUNT        ( 1 << heapSL_INDEX_COUNT_LOG2 )
+#define heapALIGN_SIZE_LOG2       ( 3 )
+#define heapFL_INDEX_SHIFT        ( heapSL_INDEX_COUNT_LOG2 + heapALIGN_SIZE_LOG2 )
+#define heapFL_INDEX_COUNT        ( UTIL_MM_FL_INDEX_MAX - heapFL_INDEX_SHIFT + 1 )
+#define heapSMALL_BLOCK_SIZE      ( ( size_t ) 1 << heapFL_INDEX_SHIFT )
+#define heapMAXIMUM_BLOCK_SIZE    ( ( ( size_t ) 1 << UTIL_MM_FL_INDEX_MAX ) - portBYTE_ALIGNMENT )
+
+/* Define the block structure.  Every block, free or allocated, starts with a
+ * header giving its size and the block just below it in memory, so that a
+ * freed block is merged with its neighbours without any search.  Free blocks
+ * also link themselves in the list of their size class. */
 typedef struct A_BLOCK_LINK
 {
-    struct A_BLOCK_LINK * pxNextFreeBlock; /*<< The next free block in the list. */
-    size_t xBlockSize;                     /*<< The size of the free block. */
+    struct A_BLOCK_LINK * pxPrevPhysBlock; /*<< The block just below in memory, NULL for the first one. */
+    size_t xBlockSize;                     /*<< The size of the block, header included. */
+    /* The members below are only valid while the block is free, they are
+     * overwritten by the application data otherwise. */
+    struct A_BLOCK_LINK * pxNextFreeBlock; /*<< The next free block in the same list. */
+    struct A_BLOCK_LINK * pxPrevFreeBlock; /*<< The previous free block in the same list. */
 } BlockLink_t;
 
 /*-----------------------------------------------------------*/
 
 /*
- * Inserts a block of memory that is being freed into the correct position in
- * the list of free memory blocks.  The block being freed will be merged with
- * the block in front it and/or the block behind it if the memory blocks are
- * adjacent to each other.
+ * Inserts a block of memory that is being freed into the list of its size
+ * class.  The block being freed will be merged with the block in front it
+ * and/or the block behind it if they are free.
  */
 static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) PRIVILEGED_FUNCTION;
 
+/*
+ * Takes a free block out of the list of its size class.
+ */
+static void prvRemoveBlockFromFreeList( BlockLink_t * pxBlockToRemove ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns a free block of at least xWantedSize bytes, or NULL when there is
+ * none.  The block is left in its list.
+ */
+static BlockLink_t * prvSearchSuitableBlock( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * Computes the first and second level indexes of the list holding the blocks
+ * of xSize bytes.
+ */
+static void prvMappingInsert( size_t xSize, uint32_t * pulFl, uint32_t * pulSl ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the position of the most significant bit set, ulValue must not be 0.
+ */
+static uint32_t prvFls( uint32_t ulValue ) PRIVILEGED_FUNCTION;
+
 /*
  * Called automatically to setup the required heap structures the first time
  * pvPortMalloc() is called.
@@ -158,19 +220,33 @@ static void prvHeapInit( void ) PRIVILEGED_FUNCTION;
 
 /*-----------------------------------------------------------*/
 
-/* The size of the structure placed at the beginning of each allocated memory
+/* The size of the header placed at the beginning of each allocated memory
  * block must by correctly byte aligned. */
-static const size_t xHeapStructSize = ( sizeof( BlockLink_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+static const size_t xHeapStructSize = ( sizeof( BlockLink_t * ) + sizeof( size_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* Gives the block just above in memory. */
+#define heapNEXT_PHYS_BLOCK( pxBlock )    ( ( BlockLink_t * ) ( ( ( uint8_t * ) ( pxBlock ) ) + ( ( pxBlock )->xBlockSize & ~xBlockAllocatedBit ) ) )
 
-/* Create a couple of list links to mark the start and end of the list. */
-PRIVILEGED_DATA static BlockLink_t xStart, * pxEnd = NULL;
+/* Tells whether a block is part of the free heap space. */
+#define heapIS_FREE( pxBlock )            ( ( ( pxBlock )->xBlockSize & xBlockAllocatedBit ) == 0 )
+
+/* Marks the end of the heap, it is seen as an allocated block so it is never
+ * merged. */
+PRIVILEGED_DATA static BlockLink_t * pxEnd = NULL;
+
+/* The free lists of each size class, and the bitmaps of the lists not empty. */
+PRIVILEGED_DATA static BlockLink_t * pxFreeLists[ heapFL_INDEX_COUNT ][ heapSL_INDEX_COUNT ];
+PRIVILEGED_DATA static uint32_t ulFlBitmap = 0U;
+PRIVILEGED_DATA static uint8_t ucSlBitmap[ heapFL_INDEX_COUNT ];
 
 /* Keeps track of the number of calls to allocate and free memory as well as the
- * number of free bytes remaining, but says nothing about fragmentation. */
+ * number of free bytes remaining.  The fragmentation is given by
+ * UTIL_MM_GetStats(). */
 PRIVILEGED_DATA static size_t xFreeBytesRemaining = 0U;
 PRIVILEGED_DATA static size_t xMinimumEverFreeBytesRemaining = 0U;
 PRIVILEGED_DATA static size_t xNumberOfSuccessfulAllocations = 0;
 PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = 0;
+PRIVILEGED_DATA static size_t xNumberOfFailedAllocations = 0;
 
 /* Gets set to the top bit of an size_t type.  When this bit in the xBlockSize
  * member of an BlockLink_t structure is set then the block belongs to the
@@ -185,7 +261,7 @@ void * UTIL_MM_GetBuffer( size_t xWantedSize )
 void * pvPortMalloc( size_t xWantedSize )
 #endif
 {
-    BlockLink_t * pxBlock, * pxPreviousBlock, * pxNewBlockLink;
+    BlockLink_t * pxBlock, * pxNewBlockLink;
     void * pvReturn = NULL;
 
     vTaskSuspendAll();
@@ -203,60 +279,50 @@ void * pvPortMalloc( size_t xWantedSize )
             mtCOVERAGE_TEST_MARKER();
         }
 
-        /* Check the requested block size is not so large that the top bit is
-         * set.  The top bit of the block size member of the BlockLink_t structure
-         * is used to determine who owns the block - the application or the
-         * kernel, so it must be free. */
-        if( ( xWantedSize & xBlockAllocatedBit ) == 0 )
+        /* Check the requested block size is not larger than the largest block,
+         * this also keeps the top bit used to tell who owns the block free. */
+        if( ( xWantedSize > 0 ) && ( xWantedSize <= heapMAXIMUM_BLOCK_SIZE ) && ( pxEnd != NULL ) )
         {
-            /* The wanted size is increased so it can contain a BlockLink_t
-             * structure in addition to the requested amount of bytes. */
-            if( xWantedSize > 0 )
-            {
-                xWantedSize += xHeapStructSize;
+            /* The wanted size is increased so it can contain a block header
+             * in addition to the requested amount of bytes. */
+            xWantedSize += xHeapStructSize;
 
-                /* Ensure that blocks are always aligned to the required number
-                 * of bytes. */
-                if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
-                {
-                    /* Byte alignment required. */
-                    xWantedSize += ( portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK ) );
-                    configASSERT( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) == 0 );
-                }
-                else
-                {
-                    mtCOVERAGE_TEST_MARKER();
-                }
+            /* Ensure that blocks are always aligned to the required number
+             * of bytes. */
+            if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+            {
+                /* Byte alignment required. */
+                xWantedSize += ( portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK ) );
+                configASSERT( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) == 0 );
             }
             else
             {
                 mtCOVERAGE_TEST_MARKER();
             }
 
-            if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
+            /* The block must be able to hold the free list links once released. */
+            if( xWantedSize < heapMINIMUM_BLOCK_SIZE )
             {
-                /* Traverse the list from the start	(lowest address) block until
-                 * one	of adequate size is found. */
-                pxPreviousBlock = &xStart;
-                pxBlock = xStart.pxNextFreeBlock;
+                xWantedSize = heapMINIMUM_BLOCK_SIZE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
 
-                while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != NULL ) )
-                {
-                    pxPreviousBlock = pxBlock;
-                    pxBlock = pxBlock->pxNextFreeBlock;
-                }
+            if( xWantedSize <= xFreeBytesRemaining )
+            {
+                pxBlock = prvSearchSuitableBlock( xWantedSize );
 
-                /* If the end marker was reached then a block of adequate size
-                 * was	not found. */
-                if( pxBlock != pxEnd )
+                if( pxBlock != NULL )
                 {
-                    /* Return the memory space pointed to - jumping over the
-                     * BlockLink_t structure at its start. */
-                    pvReturn = ( void * ) ( ( ( uint8_t * ) pxPreviousBlock->pxNextFreeBlock ) + xHeapStructSize );
-
                     /* This block is being returned for use so must be taken out
                      * of the list of free blocks. */
-                    pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+                    prvRemoveBlockFromFreeList( pxBlock );
+
+                    /* Return the memory space pointed to - jumping over the
+                     * block header at its start. */
+                    pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
 
                     /* If the block is larger than required it can be split into
                      * two. */
@@ -272,17 +338,22 @@ void * pvPortMalloc( size_t xWantedSize )
                         /* Calculate the sizes of two blocks split from the
                          * single block. */
                         pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
-                        pxBlock->xBlockSize = xWantedSize;
+                        pxNewBlockLink->pxPrevPhysBlock = pxBlock;
+                        pxBlock->xBlockSize = xWantedSize | xBlockAllocatedBit;
 
-                        /* Insert the new block into the list of free blocks. */
+                        /* Insert the new block into the list of free blocks, the
+                         * returned block is already marked as allocated so the
+                         * two are not merged again. */
                         prvInsertBlockIntoFreeList( pxNewBlockLink );
                     }
                     else
                     {
-                        mtCOVERAGE_TEST_MARKER();
+                        /* The block is being returned - it is allocated and
+                         * owned by the application. */
+                        pxBlock->xBlockSize |= xBlockAllocatedBit;
                     }
 
-                    xFreeBytesRemaining -= pxBlock->xBlockSize;
+                    xFreeBytesRemaining -= pxBlock->xBlockSize & ~xBlockAllocatedBit;
 
                     if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
                     {
@@ -293,10 +364,6 @@ void * pvPortMalloc( size_t xWantedSize )
                         mtCOVERAGE_TEST_MARKER();
                     }
 
-                    /* The block is being returned - it is allocated and owned
-                     * by the application and has no "next" block. */
-                    pxBlock->xBlockSize |= xBlockAllocatedBit;
-                    pxBlock->pxNextFreeBlock = NULL;
                     xNumberOfSuccessfulAllocations++;
                 }
                 else
@@ -314,6 +381,15 @@ void * pvPortMalloc( size_t xWantedSize )
             mtCOVERAGE_TEST_MARKER();
         }
 
+        if( pvReturn == NULL )
+        {
+            xNumberOfFailedAllocations++;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
         traceMALLOC( pvReturn, xWantedSize );
     }
     ( void ) xTaskResumeAll();
@@ -347,39 +423,33 @@ void vPortFree( void * pv )
 
     if( pv != NULL )
     {
-        /* The memory being freed will have an BlockLink_t structure immediately
+        /* The memory being freed will have a block header immediately
          * before it. */
         puc -= xHeapStructSize;
 
         /* This casting is to keep the compiler from issuing warnings. */
         pxLink = ( void * ) puc;
 
-        /* Check the block is actually allocated. */
+        /* Check the block is actually allocated.  The free list links are
+         * part of the application data while the block is allocated, so only
+         * the size tells. */
         configASSERT( ( pxLink->xBlockSize & xBlockAllocatedBit ) != 0 );
-        configASSERT( pxLink->pxNextFreeBlock == NULL );
 
         if( ( pxLink->xBlockSize & xBlockAllocatedBit ) != 0 )
         {
-            if( pxLink->pxNextFreeBlock == NULL )
-            {
-                /* The block is being returned to the heap - it is no longer
-                 * allocated. */
-                pxLink->xBlockSize &= ~xBlockAllocatedBit;
+            /* The block is being returned to the heap - it is no longer
+             * allocated. */
+            pxLink->xBlockSize &= ~xBlockAllocatedBit;
 
-                vTaskSuspendAll();
-                {
-                    /* Add this block to the list of free blocks. */
-                    xFreeBytesRemaining += pxLink->xBlockSize;
-                    traceFREE( pv, pxLink->xBlockSize );
-                    prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
-                    xNumberOfSuccessfulFrees++;
-                }
-                ( void ) xTaskResumeAll();
-            }
-            else
+            vTaskSuspendAll();
             {
-                mtCOVERAGE_TEST_MARKER();
+                /* Add this block to the list of free blocks. */
+                xFreeBytesRemaining += pxLink->xBlockSize;
+                traceFREE( pv, pxLink->xBlockSize );
+                prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
+                xNumberOfSuccessfulFrees++;
             }
+            ( void ) xTaskResumeAll();
         }
         else
         {
@@ -414,6 +484,7 @@ void UTIL_MM_Init(uint8_t *p_pool, uint32_t pool_size)
     BlockLink_t * pxFirstFreeBlock;
     uint8_t * pucAlignedHeap;
     size_t uxAddress;
+    uint32_t ulFl, ulSl;
 #if (KEEP_ORIGINAL_CODE_FROM_FREERTOS != 0)
     size_t xTotalHeapSize = configTOTAL_HEAP_SIZE;
 #else
@@ -421,6 +492,9 @@ void UTIL_MM_Init(uint8_t *p_pool, uint32_t pool_size)
     xTotalHeapSize = pool_size;
 #endif
 
+    /* Work out the position of the top bit in a size_t variable. */
+    xBlockAllocatedBit = ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 );
+
     /* Ensure the heap starts on a correctly aligned boundary. */
     uxAddress = ( size_t ) p_pool;
 
@@ -433,131 +507,343 @@ void UTIL_MM_Init(uint8_t *p_pool, uint32_t pool_size)
 
     pucAlignedHeap = ( uint8_t * ) uxAddress;
 
-    /* xStart is used to hold a pointer to the first item in the list of free
-     * blocks.  The void cast is used to prevent compiler warnings. */
-    xStart.pxNextFreeBlock = ( void * ) pucAlignedHeap;
-    xStart.xBlockSize = ( size_t ) 0;
+    /* Start with all the lists empty. */
+    for( ulFl = 0; ulFl < heapFL_INDEX_COUNT; ulFl++ )
+    {
+        for( ulSl = 0; ulSl < heapSL_INDEX_COUNT; ulSl++ )
+        {
+            pxFreeLists[ ulFl ][ ulSl ] = NULL;
+        }
+
+        ucSlBitmap[ ulFl ] = 0U;
+    }
+
+    ulFlBitmap = 0U;
 
-    /* pxEnd is used to mark the end of the list of free blocks and is inserted
-     * at the end of the heap space. */
+    /* pxEnd is used to mark the end of the heap and is inserted at the end of
+     * the heap space.  The heap is cut to the largest block size. */
     uxAddress = ( ( size_t ) pucAlignedHeap ) + xTotalHeapSize;
     uxAddress -= xHeapStructSize;
     uxAddress &= ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
-    pxEnd = ( void * ) uxAddress;
-    pxEnd->xBlockSize = 0;
-    pxEnd->pxNextFreeBlock = NULL;
+
+    if( ( uxAddress - ( size_t ) pucAlignedHeap ) > heapMAXIMUM_BLOCK_SIZE )
+    {
+        uxAddress = ( size_t ) pucAlignedHeap + heapMAXIMUM_BLOCK_SIZE;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
 
     /* To start with there is a single free block that is sized to take up the
      * entire heap space, minus the space taken by pxEnd. */
     pxFirstFreeBlock = ( void * ) pucAlignedHeap;
     pxFirstFreeBlock->xBlockSize = uxAddress - ( size_t ) pxFirstFreeBlock;
-    pxFirstFreeBlock->pxNextFreeBlock = pxEnd;
+    pxFirstFreeBlock->pxPrevPhysBlock = NULL;
+
+    pxEnd = ( void * ) uxAddress;
+    pxEnd->xBlockSize = xBlockAllocatedBit;
+    pxEnd->pxPrevPhysBlock = pxFirstFreeBlock;
+
+    prvInsertBlockIntoFreeList( pxFirstFreeBlock );
 
     /* Only one block exists - and it covers the entire usable heap space. */
     xMinimumEverFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
     xFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
+    xNumberOfSuccessfulAllocations = 0;
+    xNumberOfSuccessfulFrees = 0;
+    xNumberOfFailedAllocations = 0;
+}
+/*-----------------------------------------------------------*/
 
-    /* Work out the position of the top bit in a size_t variable. */
-    xBlockAllocatedBit = ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 );
+static uint32_t prvFls( uint32_t ulValue ) /* PRIVILEGED_FUNCTION */
+{
+    uint32_t ulBit = 0;
+
+    /* Binary search, the time is the same whatever the value. */
+    if( ( ulValue & 0xFFFF0000U ) != 0 )
+    {
+        ulValue >>= 16;
+        ulBit += 16;
+    }
+
+    if( ( ulValue & 0xFF00U ) != 0 )
+    {
+        ulValue >>= 8;
+        ulBit += 8;
+    }
+
+    if( ( ulValue & 0xF0U ) != 0 )
+    {
+        ulValue >>= 4;
+        ulBit += 4;
+    }
+
+    if( ( ulValue & 0xCU ) != 0 )
+    {
+        ulValue >>= 2;
+        ulBit += 2;
+    }
+
+    if( ( ulValue & 0x2U ) != 0 )
+    {
+        ulBit += 1;
+    }
+
+    return ulBit;
 }
 /*-----------------------------------------------------------*/
 
-static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) /* PRIVILEGED_FUNCTION */
+static void prvMappingInsert( size_t xSize, uint32_t * pulFl, uint32_t * pulSl ) /* PRIVILEGED_FUNCTION */
 {
-    BlockLink_t * pxIterator;
-    uint8_t * puc;
+    uint32_t ulFls;
 
-    /* Iterate through the list until a block is found that has a higher address
-     * than the block being inserted. */
-    for( pxIterator = &xStart; pxIterator->pxNextFreeBlock < pxBlockToInsert; pxIterator = pxIterator->pxNextFreeBlock )
+    if( xSize < heapSMALL_BLOCK_SIZE )
+    {
+        /* Small blocks are split in linear ranges of the alignment size. */
+        *pulFl = 0;
+        *pulSl = ( uint32_t ) xSize >> heapALIGN_SIZE_LOG2;
+    }
+    else
     {
-        /* Nothing to do here, just iterate to the right position. */
+        ulFls = prvFls( ( uint32_t ) xSize );
+        *pulSl = ( ( uint32_t ) xSize >> ( ulFls - heapSL_INDEX_COUNT_LOG2 ) ) ^ heapSL_INDEX_COUNT;
+        *pulFl = ulFls - ( heapFL_INDEX_SHIFT - 1 );
     }
+}
+/*-----------------------------------------------------------*/
 
-    /* Do the block being inserted, and the block it is being inserted after
-     * make a contiguous block of memory? */
-    puc = ( uint8_t * ) pxIterator;
+static BlockLink_t * prvSearchSuitableBlock( size_t xWantedSize ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxBlock;
+    size_t xRoundedSize = xWantedSize;
+    uint32_t ulFl, ulSl, ulMap;
 
-    if( ( puc + pxIterator->xBlockSize ) == ( uint8_t * ) pxBlockToInsert )
+    /* Round the size up to the next list, so that any block of that list or of
+     * the larger ones fits without walking the list. */
+    if( xRoundedSize >= heapSMALL_BLOCK_SIZE )
     {
-        pxIterator->xBlockSize += pxBlockToInsert->xBlockSize;
-        pxBlockToInsert = pxIterator;
+        xRoundedSize += ( ( size_t ) 1 << ( prvFls( ( uint32_t ) xRoundedSize ) - heapSL_INDEX_COUNT_LOG2 ) ) - 1;
     }
     else
     {
         mtCOVERAGE_TEST_MARKER();
     }
 
-    /* Do the block being inserted, and the block it is being inserted before
-     * make a contiguous block of memory? */
-    puc = ( uint8_t * ) pxBlockToInsert;
+    if( xRoundedSize <= heapMAXIMUM_BLOCK_SIZE )
+    {
+        prvMappingInsert( xRoundedSize, &ulFl, &ulSl );
+
+        /* First look in the same first level, then in the first not empty list
+         * of the next first levels. */
+        ulMap = ucSlBitmap[ ulFl ] & ( ~0U << ulSl );
 
-    if( ( puc + pxBlockToInsert->xBlockSize ) == ( uint8_t * ) pxIterator->pxNextFreeBlock )
+        if( ulMap == 0 )
+        {
+            ulMap = ulFlBitmap & ( ~0U << ( ulFl + 1 ) );
+
+            if( ulMap != 0 )
+            {
+                ulFl = prvFls( ulMap & ( ~ulMap + 1U ) );
+                ulMap = ucSlBitmap[ ulFl ];
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( ulMap != 0 )
+        {
+            ulSl = prvFls( ulMap & ( ~ulMap + 1U ) );
+            return pxFreeLists[ ulFl ][ ulSl ];
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    /* Last chance before failing, the list of the wanted size itself may still
+     * hold a block large enough.  This is the only walk of a list, it is only
+     * done when the heap is nearly exhausted. */
+    prvMappingInsert( xWantedSize, &ulFl, &ulSl );
+
+    for( pxBlock = pxFreeLists[ ulFl ][ ulSl ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
     {
-        if( pxIterator->pxNextFreeBlock != pxEnd )
+        if( pxBlock->xBlockSize >= xWantedSize )
         {
-            /* Form one big block from the two blocks. */
-            pxBlockToInsert->xBlockSize += pxIterator->pxNextFreeBlock->xBlockSize;
-            pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock->pxNextFreeBlock;
+            return pxBlock;
+        }
+    }
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveBlockFromFreeList( BlockLink_t * pxBlockToRemove ) /* PRIVILEGED_FUNCTION */
+{
+    uint32_t ulFl, ulSl;
+
+    prvMappingInsert( pxBlockToRemove->xBlockSize, &ulFl, &ulSl );
+
+    if( pxBlockToRemove->pxNextFreeBlock != NULL )
+    {
+        pxBlockToRemove->pxNextFreeBlock->pxPrevFreeBlock = pxBlockToRemove->pxPrevFreeBlock;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( pxBlockToRemove->pxPrevFreeBlock != NULL )
+    {
+        pxBlockToRemove->pxPrevFreeBlock->pxNextFreeBlock = pxBlockToRemove->pxNextFreeBlock;
+    }
+    else
+    {
+        /* The block was the head of its list, clear the bitmaps if the list
+         * is now empty. */
+        pxFreeLists[ ulFl ][ ulSl ] = pxBlockToRemove->pxNextFreeBlock;
+
+        if( pxFreeLists[ ulFl ][ ulSl ] == NULL )
+        {
+            ucSlBitmap[ ulFl ] &= ( uint8_t ) ~( 1U << ulSl );
+
+            if( ucSlBitmap[ ulFl ] == 0U )
+            {
+                ulFlBitmap &= ~( 1U << ulFl );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
         }
         else
         {
-            pxBlockToInsert->pxNextFreeBlock = pxEnd;
+            mtCOVERAGE_TEST_MARKER();
         }
     }
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxPhysBlock;
+    uint32_t ulFl, ulSl;
+
+    /* Do the block being inserted, and the block just below it make a
+     * contiguous free block of memory? */
+    pxPhysBlock = pxBlockToInsert->pxPrevPhysBlock;
+
+    if( ( pxPhysBlock != NULL ) && heapIS_FREE( pxPhysBlock ) )
+    {
+        prvRemoveBlockFromFreeList( pxPhysBlock );
+        pxPhysBlock->xBlockSize += pxBlockToInsert->xBlockSize;
+        pxBlockToInsert = pxPhysBlock;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    /* Do the block being inserted, and the block just above it make a
+     * contiguous free block of memory?  pxEnd is never free. */
+    pxPhysBlock = heapNEXT_PHYS_BLOCK( pxBlockToInsert );
+
+    if( heapIS_FREE( pxPhysBlock ) )
+    {
+        prvRemoveBlockFromFreeList( pxPhysBlock );
+        pxBlockToInsert->xBlockSize += pxPhysBlock->xBlockSize;
+        pxPhysBlock = heapNEXT_PHYS_BLOCK( pxBlockToInsert );
+    }
     else
     {
-        pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock;
+        mtCOVERAGE_TEST_MARKER();
     }
 
-    /* If the block being inserted plugged a gab, so was merged with the block
-     * before and the block after, then it's pxNextFreeBlock pointer will have
-     * already been set, and should not be set here as that would make it point
-     * to itself. */
-    if( pxIterator != pxBlockToInsert )
+    pxPhysBlock->pxPrevPhysBlock = pxBlockToInsert;
+
+    /* Push the block at the head of the list of its size class. */
+    prvMappingInsert( pxBlockToInsert->xBlockSize, &ulFl, &ulSl );
+
+    pxBlockToInsert->pxPrevFreeBlock = NULL;
+    pxBlockToInsert->pxNextFreeBlock = pxFreeLists[ ulFl ][ ulSl ];
+
+    if( pxBlockToInsert->pxNextFreeBlock != NULL )
     {
-        pxIterator->pxNextFreeBlock = pxBlockToInsert;
+        pxBlockToInsert->pxNextFreeBlock->pxPrevFreeBlock = pxBlockToInsert;
     }
     else
     {
         mtCOVERAGE_TEST_MARKER();
     }
+
+    pxFreeLists[ ulFl ][ ulSl ] = pxBlockToInsert;
+    ucSlBitmap[ ulFl ] |= ( uint8_t ) ( 1U << ulSl );
+    ulFlBitmap |= ( 1U << ulFl );
 }
 /*-----------------------------------------------------------*/
-#if (KEEP_ORIGINAL_CODE_FROM_FREERTOS != 0)
+#if (KEEP_ORIGINAL_CODE_FROM_FREERTOS == 0)
+void UTIL_MM_GetStats( UTIL_MM_Stats_t * pxHeapStats )
+#else
 void vPortGetHeapStats( HeapStats_t * pxHeapStats )
+#endif
 {
     BlockLink_t * pxBlock;
-    size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+    size_t xBlocks = 0, xMaxSize = 0, xMinSize = 0, xTotalSize = 0;
+    uint32_t ulFl, ulSl, ulBucket;
 
-    vTaskSuspendAll();
+#if (KEEP_ORIGINAL_CODE_FROM_FREERTOS == 0)
+    for( ulBucket = 0; ulBucket < UTIL_MM_HISTOGRAM_NB; ulBucket++ )
     {
-        pxBlock = xStart.pxNextFreeBlock;
+        pxHeapStats->xFreeBlocksHistogram[ ulBucket ] = 0;
+    }
+#endif
 
-        /* pxBlock will be NULL if the heap has not been initialised.  The heap
-         * is initialised automatically when the first allocation is made. */
-        if( pxBlock != NULL )
+    vTaskSuspendAll();
+    {
+        /* The lists are all empty if the heap has not been initialised. */
+        for( ulFl = 0; ulFl < heapFL_INDEX_COUNT; ulFl++ )
         {
-            do
+            for( ulSl = 0; ulSl < heapSL_INDEX_COUNT; ulSl++ )
             {
-                /* Increment the number of blocks and record the largest block seen
-                 * so far. */
-                xBlocks++;
-
-                if( pxBlock->xBlockSize > xMaxSize )
+                for( pxBlock = pxFreeLists[ ulFl ][ ulSl ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
                 {
-                    xMaxSize = pxBlock->xBlockSize;
-                }
+                    /* Increment the number of blocks and record the largest
+                     * and smallest blocks seen so far. */
+                    xBlocks++;
+                    xTotalSize += pxBlock->xBlockSize;
 
-                if( pxBlock->xBlockSize < xMinSize )
-                {
-                    xMinSize = pxBlock->xBlockSize;
-                }
+                    if( pxBlock->xBlockSize > xMaxSize )
+                    {
+                        xMaxSize = pxBlock->xBlockSize;
+                    }
 
-                /* Move to the next block in the chain until the last block is
-                 * reached. */
-                pxBlock = pxBlock->pxNextFreeBlock;
-            } while( pxBlock != pxEnd );
+                    if( ( xMinSize == 0 ) || ( pxBlock->xBlockSize < xMinSize ) )
+                    {
+                        xMinSize = pxBlock->xBlockSize;
+                    }
+
+#if (KEEP_ORIGINAL_CODE_FROM_FREERTOS == 0)
+                    /* Bucket n holds the blocks from 2^(n+4) to 2^(n+5) - 1
+                     * bytes, the first and last ones hold all the smaller and
+                     * larger blocks. */
+                    ulBucket = prvFls( ( uint32_t ) pxBlock->xBlockSize );
+                    ulBucket = ( ulBucket > 4 ) ? ( ulBucket - 4 ) : 0;
+                    ulBucket = MIN( ulBucket, UTIL_MM_HISTOGRAM_NB - 1 );
+                    pxHeapStats->xFreeBlocksHistogram[ ulBucket ]++;
+#endif
+                }
+            }
         }
     }
     ( void ) xTaskResumeAll();
@@ -566,13 +852,28 @@ void vPortGetHeapStats( HeapStats_t * pxHeapStats )
     pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
     pxHeapStats->xNumberOfFreeBlocks = xBlocks;
 
+#if (KEEP_ORIGINAL_CODE_FROM_FREERTOS == 0)
+    /* 0 when all the free space is in a single block, close to 100 when it
+     * is scattered in small blocks. */
+    if( xTotalSize != 0 )
+    {
+        pxHeapStats->ucFragmentationIndex = ( uint8_t ) ( 100U - ( ( xMaxSize * 100U ) / xTotalSize ) );
+    }
+    else
+    {
+        pxHeapStats->ucFragmentationIndex = 0;
+    }
+#endif
+
     taskENTER_CRITICAL();
     {
         pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
         pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
         pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
         pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+#if (KEEP_ORIGINAL_CODE_FROM_FREERTOS == 0)
+        pxHeapStats->xNumberOfFailedAllocations = xNumberOfFailedAllocations;
+#endif
     }
     taskEXIT_CRITICAL();
 }
-#endif
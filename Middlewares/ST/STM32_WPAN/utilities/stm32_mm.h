@@ -24,7 +24,27 @@
 
 /* Includes ------------------------------------------------------------------*/
 /* Exported defines -----------------------------------------------------------*/
+/* Number of buckets of the free blocks histogram */
+#define UTIL_MM_HISTOGRAM_NB    (12U)
+
 /* Exported types ------------------------------------------------------------*/
+/**
+ * @brief  Heap statistics, the sizes include the block headers
+ */
+typedef struct
+{
+  size_t xAvailableHeapSpaceInBytes;      /* Free bytes in the heap */
+  size_t xSizeOfLargestFreeBlockInBytes;  /* Largest allocation that may succeed */
+  size_t xSizeOfSmallestFreeBlockInBytes; /* 0 when there is no free block */
+  size_t xNumberOfFreeBlocks;
+  size_t xMinimumEverFreeBytesRemaining;  /* Low water mark of the free bytes */
+  size_t xNumberOfSuccessfulAllocations;
+  size_t xNumberOfSuccessfulFrees;
+  size_t xNumberOfFailedAllocations;
+  size_t xFreeBlocksHistogram[UTIL_MM_HISTOGRAM_NB]; /* Free blocks per size, bucket n holds 2^(n+4) to 2^(n+5)-1 bytes */
+  uint8_t ucFragmentationIndex;           /* 100 * (1 - largest free block / free bytes) */
+} UTIL_MM_Stats_t;
+
 /* Exported constants --------------------------------------------------------*/
 /* External variables --------------------------------------------------------*/
 /* Exported macros -----------------------------------------------------------*/
@@ -53,6 +73,19 @@ void * UTIL_MM_GetBuffer(size_t xWantedSize);
 
 void UTIL_MM_ReleaseBuffer( void * pv );
 
+/**
+ * @brief  Get the heap statistics, the free lists are walked so it is not
+ *         meant to be called on a time critical path
+ * @note   When built with KEEP_ORIGINAL_CODE_FROM_FREERTOS, this function is
+ *         replaced by vPortGetHeapStats() which fills the FreeRTOS HeapStats_t:
+ *         that structure is defined by the kernel and is not extended, so the
+ *         failed allocations, the histogram and the fragmentation index are
+ *         only given here.
+ * @param  pxHeapStats: The statistics to fill
+ * @retval None
+ */
+void UTIL_MM_GetStats( UTIL_MM_Stats_t * pxHeapStats );
+
 /* Exported functions to be implemented by the user if required ------------- */
 
 #endif /* STM32_MM_H */
@@ -27,12 +27,34 @@
 /* Private typedef -------------------------------------------------------------*/
 /* Private macro -------------------------------------------------------------*/
 #define MOD(X,Y) (((X) >= (Y)) ? ((X)-(Y)) : (X))
+/* Zero-copy functions only work on a plain byte stream */
+#define IS_BYTE_QUEUE(Q) (((Q)->elementSize == 1) && ((Q)->optionFlags == CIRCULAR_QUEUE_NO_FLAG))
 
 /* Private variables ---------------------------------------------------------*/
 /* Global variables ----------------------------------------------------------*/
 /* Extern variables ----------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
+static void CircularQueue_View(queue_t *q, uint32_t pos, uint32_t size, queue_view_t *view);
+
 /* Private functions ---------------------------------------------------------*/
+/**
+  * @brief  Describe an area of the queue buffer as one or two segments
+  * @param  q: pointer on queue structure to be handled
+  * @param  pos: start of the area in the queue buffer
+  * @param  size: size of the area (in bytes), not above the queue size
+  * @param  view: filled with the segments
+  * @retval None
+  */
+static void CircularQueue_View(queue_t *q, uint32_t pos, uint32_t size, queue_view_t *view)
+{
+  uint32_t eob_size = q->queueMaxSize - pos;
+
+  view->ptr[0] = &q->qBuff[pos];
+  view->len[0] = MIN(size, eob_size);
+  view->ptr[1] = (size > eob_size) ? q->qBuff : NULL;
+  view->len[1] = size - view->len[0];
+}
+
 /* Public functions ----------------------------------------------------------*/
 
 /**
@@ -381,3 +403,104 @@ int CircularQueue_NbElement(queue_t *q)
 {
   return q->elementCount;
 }
+
+/**
+  * @brief  Free room of a byte queue
+  * @param  q: pointer on queue structure to be handled
+  * @retval number of bytes that can be reserved
+  */
+uint32_t CircularQueue_FreeSize(queue_t *q)
+{
+  return q->queueMaxSize - q->byteCount;
+}
+
+/**
+  * @brief  Reserve room at the end of a byte queue to be written in place
+  * @note   The data is only part of the queue once CircularQueue_Commit is called,
+  *         so the reserved area can be filled by a DMA or a formatting function.
+  *         Only one reservation can be pending; as for the other functions, the
+  *         caller protects the queue when the producer and consumer run in
+  *         different contexts.
+  * @param  q: pointer on queue structure to be handled
+  * @param  size: number of bytes to reserve
+  * @param  view: filled with the reserved area, two segments if it wraps
+  * @retval 0 if reserved, -1 if not enough room or not a byte queue
+  */
+int CircularQueue_Reserve(queue_t *q, uint32_t size, queue_view_t *view)
+{
+  if (!IS_BYTE_QUEUE(q) || (size == 0) || (size > CircularQueue_FreeSize(q)))
+  {
+    return -1;
+  }
+
+  CircularQueue_View(q, MOD((q->first + q->byteCount), q->queueMaxSize), size, view);
+  return 0;
+}
+
+/**
+  * @brief  Add to a byte queue the bytes written in the reserved area
+  * @param  q: pointer on queue structure to be handled
+  * @param  size: number of bytes written, not above the reserved size
+  * @retval 0 if committed, -1 if not enough room or not a byte queue
+  */
+int CircularQueue_Commit(queue_t *q, uint32_t size)
+{
+  if (!IS_BYTE_QUEUE(q) || (size > CircularQueue_FreeSize(q)))
+  {
+    return -1;
+  }
+
+  if (size > 0)
+  {
+    q->byteCount += size;
+    q->elementCount += size;
+    /* keep the position of the last element for CircularQueue_Add */
+    q->last = MOD((q->first + q->byteCount - 1), q->queueMaxSize);
+  }
+  return 0;
+}
+
+/**
+  * @brief  Get the bytes of a byte queue without copy nor removing them
+  * @note   The bytes stay valid until CircularQueue_Release, so they can be sent
+  *         by a DMA directly from the queue buffer.
+  * @param  q: pointer on queue structure to be handled
+  * @param  view: filled with the queued bytes, two segments if they wrap
+  * @retval number of bytes in the queue, 0 if empty or not a byte queue
+  */
+uint32_t CircularQueue_Peek(queue_t *q, queue_view_t *view)
+{
+  if (!IS_BYTE_QUEUE(q))
+  {
+    view->ptr[0] = view->ptr[1] = NULL;
+    view->len[0] = view->len[1] = 0;
+    return 0;
+  }
+
+  CircularQueue_View(q, q->first, q->byteCount, view);
+  if (q->byteCount == 0)
+  {
+    view->ptr[0] = NULL;
+  }
+  return q->byteCount;
+}
+
+/**
+  * @brief  Remove from a byte queue the bytes consumed after CircularQueue_Peek
+  * @param  q: pointer on queue structure to be handled
+  * @param  size: number of bytes consumed
+  * @retval 0 if released, -1 if more than the queued bytes or not a byte queue
+  */
+int CircularQueue_Release(queue_t *q, uint32_t size)
+{
+  if (!IS_BYTE_QUEUE(q) || (size > q->byteCount))
+  {
+    return -1;
+  }
+
+  q->byteCount -= size;
+  q->elementCount -= size;
+  /* as CircularQueue_Remove, an empty queue keeps first on the last element */
+  q->first = (q->byteCount > 0) ? MOD((q->first + size), q->queueMaxSize) : q->last;
+  return 0;
+}
@@ -42,6 +42,12 @@ typedef struct {
    uint8_t  optionFlags;     /* option to enable specific features */
 } queue_t;
 
+/* Direct view on the queue buffer, the second segment is used when the area wraps */
+typedef struct {
+   uint8_t* ptr[2];         /* start of each segment, NULL if unused */
+   uint32_t len[2];         /* size of each segment (in bytes) */
+} queue_view_t;
+
 /* Exported constants --------------------------------------------------------*/
 
 /* Exported macro ------------------------------------------------------------*/
@@ -55,5 +61,12 @@ int CircularQueue_NbElement(queue_t *q);
 uint8_t* CircularQueue_Remove_Copy(queue_t *q, uint16_t* elementSize, uint8_t* buffer);
 uint8_t* CircularQueue_Sense_Copy(queue_t *q, uint16_t* elementSize, uint8_t* buffer);
 
+/* Zero-copy access, byte queues only (elementSize 1, CIRCULAR_QUEUE_NO_FLAG) */
+uint32_t CircularQueue_FreeSize(queue_t *q);
+int CircularQueue_Reserve(queue_t *q, uint32_t size, queue_view_t *view);
+int CircularQueue_Commit(queue_t *q, uint32_t size);
+uint32_t CircularQueue_Peek(queue_t *q, queue_view_t *view);
+int CircularQueue_Release(queue_t *q, uint32_t size);
+
 
 #endif /* __STM_QUEUE_H */
@@ -95,6 +95,23 @@
 #define CFG_LPM_SUPPORTED   1
 #endif /* CFG_FULL_LOW_POWER */
 
+/******************************************************************************
+ * Flash driver
+ *
+ *  CFG_FD_SEM_TIMEOUT: Time (ms) waiting for the ownership of the Flash IP before
+ *  reporting the erase or write as not executed.
+ *
+ *  CFG_FD_LEASE_MAX_HOLD: Time (ms) after which a multiple sectors erase or multiple
+ *  data write gives the ownership of the Flash IP back to the CPU2 before going on.
+ *
+ *  CFG_FD_FAST_PROGRAM: When set, a complete row staged with FD_StageData() is fast
+ *  programmed at once instead of 64 double words. The row programming masks the
+ *  interrupts of the CPU1 for up to 7ms.
+ ******************************************************************************/
+#define CFG_FD_SEM_TIMEOUT         1000U
+#define CFG_FD_LEASE_MAX_HOLD      5U
+#define CFG_FD_FAST_PROGRAM        0U
+
 /******************************************************************************
  * Timer Server
  ******************************************************************************/
@@ -291,9 +308,11 @@ typedef enum
   CFG_TASK_SYSTEM_HCI_ASYNCH_EVT,
   CFG_TASK_ZIGBEE_NETWORK_FORM,
   CFG_TASK_ZIGBEE_RECOVER_PERSIST,
+  CFG_TASK_ZIGBEE_FREQ_AGILITY,
   CFG_TASK_BUTTON_SW1,
   CFG_TASK_BUTTON_SW2,
   CFG_TASK_BUTTON_SW3,
+  CFG_TASK_CONSOLE,
 #if (CFG_USB_INTERFACE_ENABLE != 0)
   CFG_TASK_VCP_SEND_DATA,
 #endif /* (CFG_USB_INTERFACE_ENABLE != 0) */
@@ -325,6 +344,7 @@ typedef enum
   CFG_EVT_ZIGBEE_NETWORK_FORM,
   CFG_EVT_ZIGBEE_STARTUP_ENDED,
   CFG_EVT_ZIGBEE_PERMIT_JOIN_REQ_RSP,
+  CFG_EVT_ZIGBEE_ED_SCAN_ENDED,
 } CFG_IdleEvt_Id_t;
 
 #define EVENT_ACK_FROM_M0_EVT             (1U << CFG_EVT_ACK_FROM_M0_EVT)
@@ -332,6 +352,7 @@ typedef enum
 #define EVENT_ZIGBEE_NETWORK_FORM           (1U << CFG_EVT_ZIGBEE_NETWORK_FORM)
 #define EVENT_ZIGBEE_STARTUP_ENDED        (1U << CFG_EVT_ZIGBEE_STARTUP_ENDED)
 #define EVENT_ZIGBEE_PERMIT_JOIN_REQ_RSP  (1U << CFG_EVT_ZIGBEE_PERMIT_JOIN_REQ_RSP)
+#define EVENT_ZIGBEE_ED_SCAN_ENDED        (1U << CFG_EVT_ZIGBEE_ED_SCAN_ENDED)
 
 
 /******************************************************************************
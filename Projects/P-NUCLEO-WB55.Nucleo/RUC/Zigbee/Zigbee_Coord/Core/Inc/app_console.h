@@ -0,0 +1,78 @@
+/**
+  ******************************************************************************
+  * @file    app_console.h
+  * @author  Zigbee Application Team
+  * @brief   Header for the line oriented console on the trace UART
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef APP_CONSOLE_H
+#define APP_CONSOLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include "app_common.h"
+
+/* Defines ------------------------------------------------------------------ */
+/* Circular DMA reception buffer, a burst longer than half of it is still read in time */
+#define CONSOLE_RX_SIZE              256U
+/* Longest command line, the rest of a longer line is dropped */
+#define CONSOLE_LINE_SIZE            80U
+/* Responses of one burst of commands sent to the UART in one write */
+#define CONSOLE_OUT_SIZE             512U
+
+/* Several commands can be given on one line */
+#define CONSOLE_CMD_SEPARATOR        ';'
+
+/* Exported Types ------------------------------------------------------------ */
+typedef struct
+{
+  const char * name;          /* Command typed on the console */
+  void (*fct)(void);          /* Action to do */
+} Console_Cmd_T;
+
+typedef struct
+{
+  const char * name;          /* Parameter name for set and get */
+  void *       value;         /* Application variable */
+  uint8_t      size;          /* Size of the variable: 1, 2 or 4 bytes */
+  uint32_t     min;
+  uint32_t     max;
+  void (*apply)(void);        /* Called after a change, NULL if nothing to do */
+} Console_Param_T;
+
+/* Exported Macros ----------------------------------------------------------- */
+#define CONSOLE_NB(table)                   (sizeof(table) / sizeof((table)[0]))
+#define CONSOLE_CMD(name, fct)              { (name), (fct) }
+#define CONSOLE_PARAM(name, var, min, max, apply)   \
+        { (name), &(var), (uint8_t)sizeof(var), (min), (max), (apply) }
+
+/* Exported Prototypes -------------------------------------------------------*/
+bool Console_Config(void);
+bool Console_Init  (const Console_Cmd_T * cmd, uint8_t cmd_nb, const Console_Param_T * param, uint8_t param_nb);
+
+/* Byte stream processing, called by the console task with the received bytes */
+void Console_Input (const uint8_t * data, uint16_t size);
+void Console_Flush (void);
+void Console_Printf(const char * format, ...);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* APP_CONSOLE_H */
@@ -47,6 +47,20 @@ typedef enum
   WAIT_FOR_SEM_BLOCK_FLASH_REQ_BY_CPU2,
 }WaitedSemId_t;
 
+typedef struct
+{
+  uint32_t LeaseNb;       /* Ownerships of the Flash IP taken */
+  uint32_t ContentionNb;  /* Ownerships requested while the CPU2 held the Flash IP */
+  uint32_t TimeoutNb;     /* Ownerships given up after CFG_FD_SEM_TIMEOUT */
+  uint32_t YieldNb;       /* Ownerships released in the middle of an operation after CFG_FD_LEASE_MAX_HOLD */
+  uint32_t SpinTime;      /* Total time waiting for the ownership (ms) */
+  uint32_t SpinTimeMax;   /* Longest wait for the ownership (ms) */
+  uint32_t HoldTimeMax;   /* Longest continuous ownership (ms) */
+}FD_LeaseStats_t;
+
+/* Exported constants --------------------------------------------------------*/
+#define FD_ROW_NB_DATA               64U   /* Number of 64bits data in a flash row */
+
 /* Exported functions ------------------------------------------------------- */
 
   /**
@@ -63,11 +77,14 @@ typedef enum
    *                        enabled by either CPU1 or CPU2. When the value returned is not 0, the application
    *                        should wait until both timing protection before retrying to erase the last missing sectors.
    *
-   *                        In addition, When the returned value is not 0:
-   *                        - The Sem2 is NOT released
-   *                        - The FLASH is NOT locked
-   *                        - SHCI_C2_FLASH_EraseActivity(ERASE_ACTIVITY_OFF) is NOT called
-   *                        It is expected that the user will call one more time this function to finish the process
+   *                        The ownership of the Flash IP (Sem2) is given up after CFG_FD_SEM_TIMEOUT, and released
+   *                        between two sectors to the CPU2 once held for CFG_FD_LEASE_MAX_HOLD.
+   *
+   *                        Whatever the returned value:
+   *                        - The Sem2 is released
+   *                        - The FLASH is locked
+   *                        - SHCI_C2_FLASH_EraseActivity(ERASE_ACTIVITY_OFF) is called
+   *                        The user may call one more time this function to erase the sectors left
    */
 uint32_t FD_EraseSectors(uint32_t FirstSector, uint32_t NbrOfSectors);
 
@@ -87,10 +104,13 @@ uint32_t FD_EraseSectors(uint32_t FirstSector, uint32_t NbrOfSectors);
    *                      enabled by either CPU1 or CPU2. When the value returned is not 0, the application
    *                      should wait until both timing protection before retrying to write the last missing 64bits data.
    *
-   *                      In addition, When the returned value is not 0:
-   *                        - The Sem2 is NOT released
-   *                        - The FLASH is NOT locked
-   *                        It is expected that the user will call one more time this function to finish the process
+   *                      The ownership of the Flash IP (Sem2) is given up after CFG_FD_SEM_TIMEOUT, and released
+   *                      between two data to the CPU2 once held for CFG_FD_LEASE_MAX_HOLD.
+   *
+   *                      Whatever the returned value:
+   *                        - The Sem2 is released
+   *                        - The FLASH is locked
+   *                        The user may call one more time this function to write the data left
    */
   uint32_t FD_WriteData(uint32_t DestAddress, uint64_t * pSrcBuffer, uint32_t NbrOfData);
 
@@ -163,6 +183,56 @@ uint32_t FD_EraseSectors(uint32_t FirstSector, uint32_t NbrOfSectors);
    */
   WaitedSemStatus_t FD_WaitForSemAvailable(WaitedSemId_t WaitedSemId);
 
+  /**
+   * @brief  Get the counters of the ownership of the Flash IP (Sem2) by FD_EraseSectors() and FD_WriteData()
+   *
+   * @param  pStats: Filled with the counters
+   * @retval None
+   */
+  void FD_GetLeaseStats(FD_LeaseStats_t * pStats);
+
+  /**
+   * @brief  Reset the counters of the ownership of the Flash IP
+   *
+   * @param  None
+   * @retval None
+   */
+  void FD_ResetLeaseStats(void);
+
+  /**
+   * @brief  Stage one 64bits data to be written in flash together with the following ones
+   *         The staged data are written in one single FD_WriteData() call when a data not following them is staged,
+   *         when the end of a flash row is reached or when FD_FlushData() is called.
+   *         When CFG_FD_FAST_PROGRAM is set, a complete row is fast programmed in one single operation.
+   *         The user shall first make sure the locations staged have been erased, including the one holding 0.
+   *         The staged data are not readable from the flash before they are written.
+   *
+   * @param  DestAddress: Address of the flash to write the data. It shall be 64bits aligned
+   * @param  Data:  64bits Data to be written
+   * @retval Number of 64bits data not written by the write this call triggered, 0 when nothing was written.
+   *         When not 0, the new data is not staged and the data not written are kept staged:
+   *         the user shall either call FD_FlushData() to try again or FD_DiscardData() to drop them.
+   */
+  uint32_t FD_StageData(uint32_t DestAddress, uint64_t Data);
+
+  /**
+   * @brief  Write the staged data in flash
+   *
+   * @param  None
+   * @retval Number of 64bits data not written, they are kept staged
+   */
+  uint32_t FD_FlushData(void);
+
+  /**
+   * @brief  Drop the staged data without writing them
+   *         To be called when a write failed and is not tried again, so that the data left staged
+   *         are not written later at locations the user has reused or erased.
+   *
+   * @param  None
+   * @retval None
+   */
+  void FD_DiscardData(void);
+
 
 #ifdef __cplusplus
 }
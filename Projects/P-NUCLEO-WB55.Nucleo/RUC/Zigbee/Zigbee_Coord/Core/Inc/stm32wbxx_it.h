@@ -45,6 +45,7 @@ void FLASH_IRQHandler(void);
 void RCC_IRQHandler(void);
 void DMA1_Channel1_IRQHandler(void);
 void DMA1_Channel2_IRQHandler(void);
+void DMA1_Channel3_IRQHandler(void);
 void C2SEV_PWR_C2H_IRQHandler(void);
 void USART1_IRQHandler(void);
 void LPUART1_IRQHandler(void);
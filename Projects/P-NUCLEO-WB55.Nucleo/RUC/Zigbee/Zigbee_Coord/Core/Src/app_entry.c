@@ -67,19 +67,6 @@ extern void MX_USART1_UART_Init(void);
 static void Led_Init(void);
 static void Button_Init(void);
 
-/* Section specific to button management using UART */
-static void RxUART_Init(void);
-static void RxCpltCallback(void);
-static void UartCmdExecute(void);
-
-#define C_SIZE_CMD_STRING       256U
-#define RX_BUFFER_SIZE          8U
-
-static uint8_t aRxBuffer[RX_BUFFER_SIZE];
-static uint8_t CommandString[C_SIZE_CMD_STRING];
-static uint16_t indexReceiveChar = 0;
-EXTI_HandleTypeDef exti_handle;
-
 /* Functions Definition ------------------------------------------------------*/
 void APPE_Init( void )
 {
@@ -95,7 +82,6 @@ void APPE_Init( void )
   UTIL_LPM_SetOffMode(1 << CFG_LPM_APP, UTIL_LPM_DISABLE);
   Led_Init();
   Button_Init();
-  RxUART_Init();
   appe_Tl_Init();	/* Initialize all transport layers */
 
   /**
@@ -449,60 +435,3 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_EXTI_Pin)
   }
 }
 
-static void RxUART_Init(void)
-{
-  HW_UART_Receive_IT(CFG_DEBUG_TRACE_UART, aRxBuffer, 1U, RxCpltCallback);
-}
-
-static void RxCpltCallback(void)
-{
-  /* Filling buffer and wait for '\r' char */
-  if (indexReceiveChar < C_SIZE_CMD_STRING)
-  {
-    if (aRxBuffer[0] == '\r')
-    {
-      APP_ZB_DBG("received %s", CommandString);
-
-      UartCmdExecute();
-
-      /* Clear receive buffer and character counter*/
-      indexReceiveChar = 0;
-      memset(CommandString, 0, C_SIZE_CMD_STRING);
-    }
-    else
-    {
-      CommandString[indexReceiveChar++] = aRxBuffer[0];
-    }
-  }
-
-  /* Once a character has been sent, put back the device in reception mode */
-  HW_UART_Receive_IT(CFG_DEBUG_TRACE_UART, aRxBuffer, 1U, RxCpltCallback);
-}
-
-static void UartCmdExecute(void)
-{
-  /* Parse received CommandString */
-  if(strcmp((char const*)CommandString, "SW1") == 0)
-  {
-    APP_ZB_DBG("SW1 OK");
-    exti_handle.Line = EXTI_LINE_4;
-    HAL_EXTI_GenerateSWI(&exti_handle);
-  }
-  else if (strcmp((char const*)CommandString, "SW2") == 0)
-  {
-    APP_ZB_DBG("SW2 OK");
-    exti_handle.Line = EXTI_LINE_0;
-    HAL_EXTI_GenerateSWI(&exti_handle);
-  }
-  else if (strcmp((char const*)CommandString, "SW3") == 0)
-  {
-    APP_ZB_DBG("SW3 OK");
-    exti_handle.Line = EXTI_LINE_1;
-    HAL_EXTI_GenerateSWI(&exti_handle);
-  }
-  else
-  {
-    APP_ZB_DBG("NOT RECOGNIZED COMMAND : %s", CommandString);
-  }
-}
-
@@ -36,8 +36,10 @@
 
 /* service dependencies */
 #include "app_zigbee.h"
+#include "app_zigbee_agility.h"
 #include "app_nvm.h"
 #include "app_menu.h"
+#include "app_console.h"
 
 /* Private typedef -----------------------------------------------------------*/
 
@@ -107,6 +109,9 @@ void App_Core_Init(void)
   /* Display informations after Join */
   App_Zigbee_Channel_Disp();
 
+  /* Watch the link counters to leave the channel on sustained interference */
+  App_Zigbee_Agility_Start();
+
   /* Since we're using group addressing (broadcast), shorten the broadcast timeout */
   uint32_t bcast_timeout = 3;
   ZbNwkSet(app_zb_info.zb, ZB_NWK_NIB_ID_NetworkBroadcastDeliveryTime, &bcast_timeout, sizeof(bcast_timeout));
@@ -116,6 +121,12 @@ void App_Core_Init(void)
   {
     APP_ZB_DBG("Error : Menu Config");
   }
+
+  /* Commands and parameters from the trace UART */
+  if (Console_Config() == 0)
+  {
+    APP_ZB_DBG("Error : Console Config");
+  }
 } /* App_Core_Init */
 
 /**
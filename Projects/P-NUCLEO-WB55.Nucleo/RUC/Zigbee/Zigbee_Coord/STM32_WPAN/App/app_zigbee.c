@@ -32,12 +32,11 @@
 #include "app_core.h"
 #include "app_nvm.h"
 #include "app_zigbee.h"
+#include "app_zigbee_channel.h"
+#include "app_zigbee_agility.h"
 
 /* Private defines -----------------------------------------------------------*/
 #define APP_ZIGBEE_STARTUP_FAIL_DELAY  500U
-#define CHANNEL                        25
-#define CHANNELMASK_USED               (1<< CHANNEL)
-// #define CHANNELMASK_USED               WPAN_CHANNELMASK_2400MHZ; /* Full Channel in use */
 
 /* Private function prototypes -----------------------------------------------*/
 static enum ZbStatusCodeT ZbStartupWait(struct ZigBeeT *zb, struct ZbStartupT *config);
@@ -108,6 +107,9 @@ void App_Zigbee_Init(void)
   /* Task associated with network creation process */
   UTIL_SEQ_RegTask(1U << CFG_TASK_ZIGBEE_NETWORK_FORM, UTIL_SEQ_RFU, App_Zigbee_NwkForm);
 
+  /* Task associated with the frequency agility */
+  App_Zigbee_Agility_Init();
+
   /* Start the Zigbee on the CPU2 side */
   ZigbeeInitStatus = SHCI_C2_ZIGBEE_Init();
   /* Prevent unused argument(s) compilation warning */
@@ -239,10 +241,19 @@ static void App_Zigbee_NwkForm(void)
     /* Using the default HA preconfigured Link Key */
     memcpy(config.security.preconfiguredLinkKey, sec_key_ha, ZB_SEC_KEYSIZE);   
   
-    /* Multi-channel prog */
+    /* Measure the energy of the channels to form on the quietest one */
+    if (App_Zigbee_Channel_Scan(app_zb_info.zb, CHANNEL_SCAN_MASK) == ZB_STATUS_SUCCESS)
+    {
+      App_Zigbee_Channel_Scan_Disp();
+    }
+    else
+    {
+      APP_ZB_DBG("Energy scan failed, use the default channel %d", CHANNEL_DEFAULT);
+    }
+
     config.channelList.count = 1;
     config.channelList.list[0].page = 0;
-    config.channelList.list[0].channelMask = CHANNELMASK_USED; /* Channel in use*/
+    config.channelList.list[0].channelMask = (1UL << App_Zigbee_Channel_Select()); /* Channel in use*/
 
     /* Using ZbStartupWait (blocking) here instead of ZbStartup, in order to demonstrate how to do
      * a blocking call on the M4. */
@@ -0,0 +1,404 @@
+/**
+  ******************************************************************************
+  * @file    app_zigbee_agility.c
+  * @author  Zigbee Application Team
+  * @brief   Frequency agility of the Coordinator.
+  *          Sample periodically the NWK transmission counters and move the
+  *          whole network to a quieter channel on sustained interference.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_common.h"
+#include "stm32_seq.h"
+#include "hw_if.h"
+
+/* Debug Part */
+#include "stm_logging.h"
+#include "dbg_trace.h"
+
+/* service dependencies */
+#include "app_zigbee.h"
+#include "app_zigbee_channel.h"
+#include "app_zigbee_agility.h"
+
+/* External variables --------------------------------------------------------*/
+extern App_Zb_Info_T app_zb_info;
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t TS_ID_AGILITY;
+
+static struct
+{
+  bool     is_baseline;       /* Counters of the previous sample are valid */
+  uint32_t tx_total;          /* Transmissions counter of the previous sample */
+  uint32_t tx_failure;        /* Failures counter of the previous sample */
+  uint8_t  bad_count;         /* Consecutive bad samples */
+  uint8_t  trigger_rate;      /* Success rate of the sample triggering the scan */
+  bool     is_changed;        /* A channel change has been requested */
+  bool     is_rate_pending;   /* Waiting the first sample after the change */
+  uint32_t change_tick;       /* Tick (ms) of the last channel change */
+  Agility_Stats_T stats;
+} agility;
+
+/* Private function prototypes -----------------------------------------------*/
+static void    App_Zigbee_Agility_Timer_cb  (void);
+static void    App_Zigbee_Agility_Change_cb (struct ZbZdoNwkUpdateNotifyT *notify, void *arg);
+static bool    App_Zigbee_Agility_Get_Counters(uint32_t *tx_total, uint32_t *tx_failure);
+static uint8_t App_Zigbee_Agility_Get_Channel (void);
+static void    App_Zigbee_Agility_Change    (uint8_t current, uint8_t channel, uint32_t now);
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+ * @brief  Register the frequency agility task and create its sampling timer
+ * @param  None
+ * @retval None
+ */
+void App_Zigbee_Agility_Init(void)
+{
+  memset(&agility, 0, sizeof(agility));
+
+  UTIL_SEQ_RegTask(1U << CFG_TASK_ZIGBEE_FREQ_AGILITY, UTIL_SEQ_RFU, App_Zigbee_Agility_Process);
+  HW_TS_Create(CFG_TIM_PROC_ID_ISR, &TS_ID_AGILITY, hw_ts_Repeated, App_Zigbee_Agility_Timer_cb);
+} /* App_Zigbee_Agility_Init */
+
+/**
+ * @brief  Start the sampling of the link counters, once the network is formed
+ * @param  None
+ * @retval None
+ */
+void App_Zigbee_Agility_Start(void)
+{
+  agility.is_baseline = false;
+  agility.bad_count   = 0U;
+
+  HW_TS_Stop(TS_ID_AGILITY);
+  HW_TS_Start(TS_ID_AGILITY, AGILITY_SAMPLE_PERIOD * HW_TS_SERVER_1S_NB_TICKS);
+} /* App_Zigbee_Agility_Start */
+
+/**
+ * @brief  Decide if the network suffers from interference
+ * Only depends on its parameters to be replayed with synthetic counters.
+ * @param  tx_total   NWK transmissions counter, 16 bits
+ * @param  tx_failure sum of the neighbors transmission failures counters
+ * @param  now        current tick (ms)
+ * @retval action to apply on the network
+ */
+Agility_Action_T App_Zigbee_Agility_Step(uint32_t tx_total, uint32_t tx_failure, uint32_t now)
+{
+  uint32_t tx_delta;
+  uint32_t failure_delta;
+  uint8_t  rate;
+  bool     is_reset;
+
+  if (agility.is_baseline == false)
+  {
+    agility.is_baseline = true;
+    agility.tx_total    = tx_total;
+    agility.tx_failure  = tx_failure;
+    return AGILITY_ACTION_NONE;
+  }
+
+  /* The Tx counter wraps on 16 bits, the baseline is taken again after a channel change.
+   * The failures are a sum of 8 bits neighbors counters: it drops when a neighbor ages out
+   * or its counter wraps or is reset. The failures of such a sample are unknown, it is only
+   * the new baseline and does not count as a good sample */
+  tx_delta      = (uint16_t)(tx_total - agility.tx_total);
+  is_reset      = (tx_failure < agility.tx_failure);
+  failure_delta = is_reset ? 0U : (tx_failure - agility.tx_failure);
+  agility.tx_total   = tx_total;
+  agility.tx_failure = tx_failure;
+  if (failure_delta > tx_delta)
+  {
+    failure_delta = tx_delta;
+  }
+
+  agility.stats.sample_nb++;
+  if ((is_reset) || (tx_delta < AGILITY_TX_MIN))
+  {
+    /* Not enough traffic or a counter reset to conclude, keep the current state */
+    return AGILITY_ACTION_NONE;
+  }
+
+  rate = (uint8_t)(100U - ((failure_delta * 100U) / tx_delta));
+  agility.stats.success_rate = rate;
+  if (agility.is_rate_pending)
+  {
+    agility.is_rate_pending  = false;
+    agility.stats.rate_after = rate;
+  }
+
+  /* Hysteresis : enter above the high threshold, leave below the low one */
+  if ((failure_delta * 100U) >= (tx_delta * AGILITY_FAILURE_HIGH))
+  {
+    agility.stats.bad_nb++;
+    if (agility.bad_count < AGILITY_BAD_SAMPLE_NB)
+    {
+      agility.bad_count++;
+    }
+  }
+  else if ((failure_delta * 100U) < (tx_delta * AGILITY_FAILURE_LOW))
+  {
+    agility.bad_count = 0U;
+  }
+
+  if (agility.bad_count < AGILITY_BAD_SAMPLE_NB)
+  {
+    return AGILITY_ACTION_NONE;
+  }
+
+  /* Do not flap between channels */
+  if ((agility.is_changed) && ((uint32_t)(now - agility.change_tick) < AGILITY_HOLDOFF))
+  {
+    agility.stats.holdoff_nb++;
+    return AGILITY_ACTION_NONE;
+  }
+
+  agility.bad_count    = 0U;
+  agility.trigger_rate = rate;
+  agility.stats.scan_nb++;
+
+  return AGILITY_ACTION_SCAN;
+} /* App_Zigbee_Agility_Step */
+
+/**
+ * @brief  Choose the channel to move to after an energy scan
+ * Only depends on its parameters to be checked against a simulated energy table.
+ * @param  energy   energy measured per channel
+ * @param  current  channel in use
+ * @param  quietest quietest channel of the scan
+ * @retval channel to use, current if no channel is quiet enough
+ */
+uint8_t App_Zigbee_Agility_Select(const uint8_t *energy, uint8_t current, uint8_t quietest)
+{
+  if ((current >= WPAN_PAGE_CHANNELS_MAX) || (quietest >= WPAN_PAGE_CHANNELS_MAX) || (quietest == current))
+  {
+    return current;
+  }
+
+  if (((uint16_t)energy[quietest] + AGILITY_ENERGY_MARGIN) > (uint16_t)energy[current])
+  {
+    return current;
+  }
+  return quietest;
+} /* App_Zigbee_Agility_Select */
+
+/**
+ * @brief  Sample the link counters and change the channel on sustained interference
+ * Called from the frequency agility task
+ * @param  None
+ * @retval None
+ */
+void App_Zigbee_Agility_Process(void)
+{
+  const App_Zb_Channel_Info_T *channel_info;
+  uint32_t tx_total;
+  uint32_t tx_failure;
+  uint8_t  current;
+  uint8_t  channel;
+
+  if ((app_zb_info.zb == NULL) || (app_zb_info.join_status != ZB_STATUS_SUCCESS))
+  {
+    return;
+  }
+
+  if (App_Zigbee_Agility_Get_Counters(&tx_total, &tx_failure) == false)
+  {
+    return;
+  }
+
+  if (App_Zigbee_Agility_Step(tx_total, tx_failure, HAL_GetTick()) != AGILITY_ACTION_SCAN)
+  {
+    return;
+  }
+
+  APP_ZB_DBG("Interference detected (Tx success %d%%), scan the channels", agility.trigger_rate);
+  if (App_Zigbee_Channel_Scan(app_zb_info.zb, CHANNEL_SCAN_MASK) != ZB_STATUS_SUCCESS)
+  {
+    return;
+  }
+
+  channel_info = App_Zigbee_Channel_Get_Info();
+  current      = App_Zigbee_Agility_Get_Channel();
+  channel      = App_Zigbee_Agility_Select(channel_info->energy, current, App_Zigbee_Channel_Select());
+  if (channel == current)
+  {
+    APP_ZB_DBG("No channel quieter than %d by %d, stay on it", current, AGILITY_ENERGY_MARGIN);
+    return;
+  }
+
+  App_Zigbee_Agility_Change(current, channel, HAL_GetTick());
+} /* App_Zigbee_Agility_Process */
+
+/**
+ * @brief  Get the frequency agility statistics
+ * @param  None
+ * @retval statistics
+ */
+const Agility_Stats_T * App_Zigbee_Agility_Get_Stats(void)
+{
+  return &agility.stats;
+} /* App_Zigbee_Agility_Get_Stats */
+
+/**
+ * @brief  For debug purpose, display the frequency agility statistics
+ * @param  None
+ * @retval None
+ */
+void App_Zigbee_Agility_Disp(void)
+{
+  APP_ZB_DBG("Freq agility : sample %ds | bad above %d%% failures | reset below %d%% | %d bad samples | hold-off %ds",
+             AGILITY_SAMPLE_PERIOD, AGILITY_FAILURE_HIGH, AGILITY_FAILURE_LOW,
+             AGILITY_BAD_SAMPLE_NB, AGILITY_HOLDOFF / 1000U);
+  APP_ZB_DBG("Samples : %d | bad : %d | scans : %d | delayed by hold-off : %d | changes : %d",
+             agility.stats.sample_nb, agility.stats.bad_nb, agility.stats.scan_nb,
+             agility.stats.holdoff_nb, agility.stats.change_nb);
+  APP_ZB_DBG("Tx success : %d%% (last sample)", agility.stats.success_rate);
+  if (agility.stats.change_nb != 0U)
+  {
+    APP_ZB_DBG("Last change from channel %d %ds ago : Tx success %d%% before | %d%% after%s",
+               agility.stats.last_channel, (HAL_GetTick() - agility.change_tick) / 1000U,
+               agility.stats.rate_before, agility.stats.rate_after,
+               (agility.is_rate_pending) ? " (not measured yet)" : "");
+  }
+} /* App_Zigbee_Agility_Disp */
+
+/* Private Functions Definition ----------------------------------------------*/
+/**
+ * @brief  Timer callback to sample the link counters
+ * Called under IRQ, the work is done in the frequency agility task
+ * @param  None
+ * @retval None
+ */
+static void App_Zigbee_Agility_Timer_cb(void)
+{
+  UTIL_SEQ_SetTask(1U << CFG_TASK_ZIGBEE_FREQ_AGILITY, CFG_SCH_PRIO_1);
+} /* App_Zigbee_Agility_Timer_cb */
+
+/**
+ * @brief  Read the NWK transmissions counter and the failures on all the neighbors
+ * The Diagnostics cluster attributes are not readable locally, use the NIB instead.
+ * @param  tx_total   filled with the NWK transmissions counter
+ * @param  tx_failure filled with the sum of the neighbors failures counters, on 16 bits
+ * @retval true if the counters are valid
+ */
+static bool App_Zigbee_Agility_Get_Counters(uint32_t *tx_total, uint32_t *tx_failure)
+{
+  struct ZbNwkNeighborT neighbor;
+  uint16_t total = 0;
+  uint16_t failure = 0;
+  unsigned int i;
+
+  if (ZbNwkGet(app_zb_info.zb, ZB_NWK_NIB_ID_TxTotal, &total, sizeof(total)) != ZB_STATUS_SUCCESS)
+  {
+    APP_ZB_DBG("Error, cannot read the NWK Tx counter");
+    return false;
+  }
+
+  for (i = 0; ZbNwkGetIndex(app_zb_info.zb, ZB_NWK_NIB_ID_NeighborTable, &neighbor, sizeof(neighbor), i) == ZB_STATUS_SUCCESS; i++)
+  {
+    if (neighbor.nwkAddr != ZB_NWK_ADDR_UNDEFINED)
+    {
+      failure += neighbor.txFailure;
+    }
+  }
+
+  /* The Tx counter wraps on 16 bits, the failures sum drops with a neighbor counter */
+  *tx_total   = total;
+  *tx_failure = failure;
+
+  return true;
+} /* App_Zigbee_Agility_Get_Counters */
+
+/**
+ * @brief  Get the channel in use by the network
+ * @param  None
+ * @retval channel, 0xff if not found
+ */
+static uint8_t App_Zigbee_Agility_Get_Channel(void)
+{
+  struct ZbChannelListT channelList;
+  uint8_t i;
+
+  memset(&channelList, 0, sizeof(channelList));
+  (void)ZbNwkGet(app_zb_info.zb, ZB_NWK_NIB_ID_ActiveChannelList, &channelList, sizeof(channelList));
+  if (channelList.count == 0U)
+  {
+    return 0xff;
+  }
+
+  for (i = 0; i < WPAN_PAGE_CHANNELS_MAX; i++)
+  {
+    if ((channelList.list[0].channelMask & (1UL << i)) != 0U)
+    {
+      return i;
+    }
+  }
+  return 0xff;
+} /* App_Zigbee_Agility_Get_Channel */
+
+/**
+ * @brief  Broadcast a Mgmt_Nwk_Update_req to move the whole network to a new channel
+ * @param  current channel in use
+ * @param  channel new channel
+ * @param  now     current tick (ms)
+ * @retval None
+ */
+static void App_Zigbee_Agility_Change(uint8_t current, uint8_t channel, uint32_t now)
+{
+  struct ZbZdoNwkUpdateReqT req;
+  enum ZbStatusCodeT status;
+  uint8_t update_id = 0;
+
+  (void)ZbNwkGet(app_zb_info.zb, ZB_NWK_NIB_ID_UpdateId, &update_id, sizeof(update_id));
+
+  memset(&req, 0, sizeof(req));
+  req.destAddr     = ZB_NWK_ADDR_BCAST_RXON;
+  req.channelMask  = (1UL << channel);
+  req.scanDuration = ZB_ZDP_NWK_UPDATE_CHANNEL_SWITCH;
+  req.updateId     = update_id + 1U;
+
+  APP_ZB_DBG("Move the network from channel %d to channel %d", current, channel);
+  status = ZbZdoNwkUpdateReq(app_zb_info.zb, &req, App_Zigbee_Agility_Change_cb, NULL);
+  if (status != ZB_STATUS_SUCCESS)
+  {
+    APP_ZB_DBG("Error, cannot send the channel change (0x%02x)", status);
+    return;
+  }
+
+  agility.is_changed         = true;
+  agility.is_rate_pending    = true;
+  agility.change_tick        = now;
+  agility.is_baseline        = false;
+  agility.stats.change_nb++;
+  agility.stats.rate_before  = agility.trigger_rate;
+  agility.stats.last_channel = current;
+} /* App_Zigbee_Agility_Change */
+
+/**
+ * @brief  Callback of the channel change request
+ * @param  notify request result
+ * @param  arg unused
+ * @retval None
+ */
+static void App_Zigbee_Agility_Change_cb(struct ZbZdoNwkUpdateNotifyT *notify, void *arg)
+{
+  UNUSED(arg);
+
+  if (notify->status != ZB_STATUS_SUCCESS)
+  {
+    APP_ZB_DBG("Channel change failed (0x%02x)", notify->status);
+    return;
+  }
+  APP_ZB_DBG("Channel change sent to the network");
+} /* App_Zigbee_Agility_Change_cb */
@@ -0,0 +1,81 @@
+/**
+  ******************************************************************************
+  * @file    app_zigbee_agility.h
+  * @author  Zigbee Application Team
+  * @brief   Header for the frequency agility of the Coordinator.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef APP_ZIGBEE_AGILITY_H
+#define APP_ZIGBEE_AGILITY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "zigbee_interface.h"
+
+/* Defines ------------------------------------------------------------------ */
+/* Period of the link counters sampling (in s) */
+#define AGILITY_SAMPLE_PERIOD          60U
+
+/* A sample is meaningful only with enough transmissions */
+#define AGILITY_TX_MIN                 20U
+/* A sample is bad above this failure rate (in %) */
+#define AGILITY_FAILURE_HIGH           25U
+/* Bad samples are forgotten below this failure rate (in %) */
+#define AGILITY_FAILURE_LOW            10U
+/* Consecutive bad samples before looking for another channel */
+#define AGILITY_BAD_SAMPLE_NB          3U
+
+/* Minimum time between two channel changes (in ms) */
+#define AGILITY_HOLDOFF                (30U * 60U * 1000U)
+/* The new channel must be quieter than the current one by this energy margin */
+#define AGILITY_ENERGY_MARGIN          20U
+
+/* Typedef ----------------------------------------------------------------- */
+typedef enum
+{
+  AGILITY_ACTION_NONE,
+  AGILITY_ACTION_SCAN,     /* Interference confirmed, look for another channel */
+} Agility_Action_T;
+
+typedef struct
+{
+  uint32_t sample_nb;      /* Link counters samples */
+  uint32_t bad_nb;         /* Samples above the failure threshold */
+  uint32_t holdoff_nb;     /* Scans delayed by the hold-off after a change */
+  uint32_t scan_nb;        /* Energy scans triggered by interference */
+  uint32_t change_nb;      /* Channel changes requested */
+  uint8_t  success_rate;   /* Tx success rate of the last sample (in %) */
+  uint8_t  rate_before;    /* Tx success rate of the sample triggering the last change (in %) */
+  uint8_t  rate_after;     /* Tx success rate of the first sample after the last change (in %) */
+  uint8_t  last_channel;   /* Channel left by the last change */
+} Agility_Stats_T;
+
+/* Exported functions ------------------------------------------------------- */
+void                    App_Zigbee_Agility_Init   (void);
+void                    App_Zigbee_Agility_Start  (void);
+Agility_Action_T        App_Zigbee_Agility_Step   (uint32_t tx_total, uint32_t tx_failure, uint32_t now);
+uint8_t                 App_Zigbee_Agility_Select (const uint8_t *energy, uint8_t current, uint8_t quietest);
+void                    App_Zigbee_Agility_Process(void);
+const Agility_Stats_T * App_Zigbee_Agility_Get_Stats(void);
+void                    App_Zigbee_Agility_Disp   (void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* APP_ZIGBEE_AGILITY_H */
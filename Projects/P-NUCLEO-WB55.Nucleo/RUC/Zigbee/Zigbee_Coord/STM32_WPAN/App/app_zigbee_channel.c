@@ -0,0 +1,229 @@
+/**
+  ******************************************************************************
+  * @file    app_zigbee_channel.c
+  * @author  Zigbee Application Team
+  * @brief   Channel selection of the Coordinator.
+  *          Measure the energy of the channels with an ED scan and rank them
+  *          to form the network on the quietest one.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_common.h"
+#include "stm32_seq.h"
+
+/* Debug Part */
+#include "stm_logging.h"
+#include "dbg_trace.h"
+
+/* service dependencies */
+#include "app_zigbee.h"
+#include "app_zigbee_channel.h"
+
+/* External variables --------------------------------------------------------*/
+extern App_Zb_Info_T app_zb_info;
+
+/* Private variables ---------------------------------------------------------*/
+static App_Zb_Channel_Info_T channel_info;
+static enum ZbStatusCodeT    channel_scan_status;
+static uint32_t              channel_scan_mask;
+
+/* Private function prototypes -----------------------------------------------*/
+static void App_Zigbee_Channel_Scan_cb(struct ZbNlmeEdScanConfT *scanConf, void *arg);
+static bool App_Zigbee_Channel_Is_Better(const uint8_t *energy, uint8_t channel, uint8_t other);
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+ * @brief  Measure the energy on each channel of the mask and rank them
+ * Blocking call, wait the end of the ED scan
+ * @param  zb Zigbee stack instance
+ * @param  mask channels to scan
+ * @retval zigbee status stack code
+ */
+enum ZbStatusCodeT App_Zigbee_Channel_Scan(struct ZigBeeT *zb, uint32_t mask)
+{
+  struct ZbNlmeEdScanReqT req;
+  enum ZbStatusCodeT status;
+
+  memset(&req, 0, sizeof(req));
+  req.channelMask  = mask;
+  req.scanDuration = CHANNEL_SCAN_DURATION;
+  channel_scan_mask = mask;
+
+  APP_ZB_DBG("Energy scan on channel mask 0x%08x", mask);
+  status = ZbNlmeEdScanReq(zb, &req, App_Zigbee_Channel_Scan_cb, NULL);
+  if (status != ZB_STATUS_SUCCESS)
+  {
+    APP_ZB_DBG("Error, cannot start the energy scan (0x%02x)", status);
+    return status;
+  }
+  UTIL_SEQ_WaitEvt(EVENT_ZIGBEE_ED_SCAN_ENDED);
+
+  return channel_scan_status;
+} /* App_Zigbee_Channel_Scan */
+
+/**
+ * @brief  Rank the channels of the mask from the quietest to the noisiest
+ * On equal energy, prefer the HA channels then the lowest channel number.
+ * Only depends on its parameters to be checked against a simulated energy table.
+ * @param  energy energy measured per channel
+ * @param  mask   channels to rank
+ * @param  rank   filled with the rank per channel, 1 for the quietest, 0 if not in the mask
+ * @retval quietest channel, 0xff if the mask is empty
+ */
+uint8_t App_Zigbee_Channel_Rank(const uint8_t *energy, uint32_t mask, uint8_t *rank)
+{
+  uint8_t i, j;
+  uint8_t best = 0xff;
+
+  for (i = 0; i < WPAN_PAGE_CHANNELS_MAX; i++)
+  {
+    rank[i] = 0U;
+    if ((mask & (1UL << i)) == 0U)
+    {
+      continue;
+    }
+
+    rank[i] = 1U;
+    for (j = 0; j < WPAN_PAGE_CHANNELS_MAX; j++)
+    {
+      if ((j != i) && ((mask & (1UL << j)) != 0U) && App_Zigbee_Channel_Is_Better(energy, j, i))
+      {
+        rank[i]++;
+      }
+    }
+
+    if (rank[i] == 1U)
+    {
+      best = i;
+    }
+  }
+
+  return best;
+} /* App_Zigbee_Channel_Rank */
+
+/**
+ * @brief  Get the channel to use to form the network
+ * @param  None
+ * @retval quietest channel of the last scan, CHANNEL_DEFAULT if none
+ */
+uint8_t App_Zigbee_Channel_Select(void)
+{
+  if ((channel_info.is_valid == false) || (channel_info.selected >= WPAN_PAGE_CHANNELS_MAX))
+  {
+    return CHANNEL_DEFAULT;
+  }
+  return channel_info.selected;
+} /* App_Zigbee_Channel_Select */
+
+/**
+ * @brief  Get the results of the last scan
+ * @param  None
+ * @retval channel information
+ */
+const App_Zb_Channel_Info_T * App_Zigbee_Channel_Get_Info(void)
+{
+  return &channel_info;
+} /* App_Zigbee_Channel_Get_Info */
+
+/**
+ * @brief  Display the results of the last scan
+ * @param  None
+ * @retval None
+ */
+void App_Zigbee_Channel_Scan_Disp(void)
+{
+  if (channel_info.is_valid == false)
+  {
+    APP_ZB_DBG("No energy scan done");
+    return;
+  }
+
+  APP_ZB_DBG("Energy scan done %ds ago", (HAL_GetTick() - channel_info.scan_tick) / 1000U);
+  APP_ZB_DBG(" Channel | Energy | Rank");
+  APP_ZB_DBG(" --------|--------|-----");
+  for (uint8_t i = 0; i < WPAN_PAGE_CHANNELS_MAX; i++)
+  {
+    if ((channel_info.scanned_mask & (1UL << i)) != 0U)
+    {
+      APP_ZB_DBG("   %2d    |  %3d   |  %2d %s", i, channel_info.energy[i], channel_info.rank[i],
+                 (i == channel_info.selected) ? "<" : "");
+    }
+  }
+  APP_ZB_DBG("Quietest channel : %2d", channel_info.selected);
+} /* App_Zigbee_Channel_Scan_Disp */
+
+/**
+ * @brief  Scan again all the channels and display the results
+ * @param  None
+ * @retval None
+ */
+void App_Zigbee_Channel_Rescan(void)
+{
+  if (App_Zigbee_Channel_Scan(app_zb_info.zb, CHANNEL_SCAN_MASK) == ZB_STATUS_SUCCESS)
+  {
+    App_Zigbee_Channel_Scan_Disp();
+  }
+} /* App_Zigbee_Channel_Rescan */
+
+/* Private Functions Definition ----------------------------------------------*/
+/**
+ * @brief  Callback of the ED scan, store and rank the measures
+ * @param  scanConf scan results
+ * @param  arg unused
+ * @retval None
+ */
+static void App_Zigbee_Channel_Scan_cb(struct ZbNlmeEdScanConfT *scanConf, void *arg)
+{
+  UNUSED(arg);
+
+  channel_scan_status = scanConf->status;
+  if (scanConf->status == ZB_STATUS_SUCCESS)
+  {
+    memcpy(channel_info.energy, scanConf->energyDetectList, sizeof(channel_info.energy));
+    channel_info.scanned_mask = channel_scan_mask & ~scanConf->unscannedChannels;
+    channel_info.selected     = App_Zigbee_Channel_Rank(channel_info.energy, channel_info.scanned_mask, channel_info.rank);
+    channel_info.scan_tick    = HAL_GetTick();
+    channel_info.is_valid     = (channel_info.selected < WPAN_PAGE_CHANNELS_MAX);
+  }
+  else
+  {
+    APP_ZB_DBG("Energy scan failed (0x%02x)", scanConf->status);
+  }
+
+  /* Unlock the waiting on this event */
+  UTIL_SEQ_SetEvt(EVENT_ZIGBEE_ED_SCAN_ENDED);
+} /* App_Zigbee_Channel_Scan_cb */
+
+/**
+ * @brief  Compare two channels
+ * @param  energy  energy measured per channel
+ * @param  channel channel to check
+ * @param  other   channel to compare with
+ * @retval true if channel is a better choice than other
+ */
+static bool App_Zigbee_Channel_Is_Better(const uint8_t *energy, uint8_t channel, uint8_t other)
+{
+  bool is_pref       = ((ZB_CHANNELMASK_2400MHZ_HA & (1UL << channel)) != 0U);
+  bool is_other_pref = ((ZB_CHANNELMASK_2400MHZ_HA & (1UL << other))   != 0U);
+
+  if (energy[channel] != energy[other])
+  {
+    return (energy[channel] < energy[other]);
+  }
+  if (is_pref != is_other_pref)
+  {
+    return is_pref;
+  }
+  return (channel < other);
+} /* App_Zigbee_Channel_Is_Better */
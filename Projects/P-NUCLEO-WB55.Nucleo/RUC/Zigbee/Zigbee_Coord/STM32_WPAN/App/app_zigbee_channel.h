@@ -0,0 +1,61 @@
+/**
+  ******************************************************************************
+  * @file    app_zigbee_channel.h
+  * @author  Zigbee Application Team
+  * @brief   Header for the channel selection of the Coordinator.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef APP_ZIGBEE_CHANNEL_H
+#define APP_ZIGBEE_CHANNEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "zigbee_interface.h"
+
+/* Defines ------------------------------------------------------------------ */
+/* Channels scanned before forming the network */
+#define CHANNEL_SCAN_MASK              WPAN_CHANNELMASK_2400MHZ
+/* ED scan duration per channel : (2^n + 1) * 15.36 ms */
+#define CHANNEL_SCAN_DURATION          3U
+/* Channel used if the ED scan fails */
+#define CHANNEL_DEFAULT                25U
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  bool     is_valid;                               /* A scan has been completed */
+  uint32_t scanned_mask;                           /* Channels measured by the last scan */
+  uint8_t  energy[WPAN_PAGE_CHANNELS_MAX];         /* Energy measured per channel */
+  uint8_t  rank[WPAN_PAGE_CHANNELS_MAX];           /* 1 for the quietest channel, 0 if not scanned */
+  uint8_t  selected;                               /* Quietest channel of the last scan */
+  uint32_t scan_tick;                              /* Tick (ms) of the last scan */
+} App_Zb_Channel_Info_T;
+
+/* Exported functions ------------------------------------------------------- */
+enum ZbStatusCodeT App_Zigbee_Channel_Scan  (struct ZigBeeT *zb, uint32_t mask);
+uint8_t            App_Zigbee_Channel_Rank  (const uint8_t *energy, uint32_t mask, uint8_t *rank);
+uint8_t            App_Zigbee_Channel_Select(void);
+const App_Zb_Channel_Info_T * App_Zigbee_Channel_Get_Info(void);
+void               App_Zigbee_Channel_Scan_Disp(void);
+void               App_Zigbee_Channel_Rescan   (void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* APP_ZIGBEE_CHANNEL_H */
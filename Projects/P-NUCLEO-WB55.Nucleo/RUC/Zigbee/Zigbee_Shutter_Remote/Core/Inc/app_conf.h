@@ -95,6 +95,23 @@
 #define CFG_LPM_SUPPORTED   1
 #endif /* CFG_FULL_LOW_POWER */
 
+/******************************************************************************
+ * Flash driver
+ *
+ *  CFG_FD_SEM_TIMEOUT: Time (ms) waiting for the ownership of the Flash IP before
+ *  reporting the erase or write as not executed.
+ *
+ *  CFG_FD_LEASE_MAX_HOLD: Time (ms) after which a multiple sectors erase or multiple
+ *  data write gives the ownership of the Flash IP back to the CPU2 before going on.
+ *
+ *  CFG_FD_FAST_PROGRAM: When set, a complete row staged with FD_StageData() is fast
+ *  programmed at once instead of 64 double words. The row programming masks the
+ *  interrupts of the CPU1 for up to 7ms.
+ ******************************************************************************/
+#define CFG_FD_SEM_TIMEOUT         1000U
+#define CFG_FD_LEASE_MAX_HOLD      5U
+#define CFG_FD_FAST_PROGRAM        0U
+
 /******************************************************************************
  * Timer Server
  ******************************************************************************/
@@ -297,6 +314,7 @@ typedef enum
   CFG_TASK_BUTTON_PIR,
   CFG_TASK_RETRY_PROC,
   CFG_TASK_LED_BLINK,
+  CFG_TASK_CONSOLE,
 #if (CFG_USB_INTERFACE_ENABLE != 0)
   CFG_TASK_VCP_SEND_DATA,
 #endif /* (CFG_USB_INTERFACE_ENABLE != 0) */
@@ -356,6 +374,11 @@ typedef enum
   CFG_LPM_APP,
 } CFG_LPM_Id_t;
 
+/**
+ * Frequency of the RTC timestamp of the low power statistics (in Hz)
+ */
+#define CFG_LPM_TIMESTAMP_FREQ    ( LSE_VALUE / ( CFG_RTC_ASYNCH_PRESCALER + 1U ) )
+
 /******************************************************************************
  * OTP manager
  ******************************************************************************/
@@ -134,9 +134,11 @@
 
 #define CFG_HW_LPUART1_ENABLED           1
 #define CFG_HW_LPUART1_DMA_TX_SUPPORTED  1
+#define CFG_HW_LPUART1_DMA_RX_SUPPORTED  0
 
 #define CFG_HW_USART1_ENABLED           1
 #define CFG_HW_USART1_DMA_TX_SUPPORTED  1
+#define CFG_HW_USART1_DMA_RX_SUPPORTED  1
 
 /**
  * LPUART1
@@ -241,5 +243,9 @@
 #define CFG_HW_USART1_TX_DMA_CHANNEL          DMA1_CHANNEL_2
 #define CFG_HW_USART1_TX_DMA_IRQn             DMA1_CHANNEL_2_IRQn
 #define CFG_HW_USART1_DMA_TX_IRQHandler       DMA1_CHANNEL_2_IRQHandler
+#define CFG_HW_USART1_RX_DMA_REQ              DMA_REQUEST_USART1_RX
+#define CFG_HW_USART1_RX_DMA_CHANNEL          DMA1_Channel3
+#define CFG_HW_USART1_RX_DMA_IRQn             DMA1_Channel3_IRQn
+#define CFG_HW_USART1_DMA_RX_IRQHandler       DMA1_Channel3_IRQHandler
 
 #endif /*HW_CONF_H */
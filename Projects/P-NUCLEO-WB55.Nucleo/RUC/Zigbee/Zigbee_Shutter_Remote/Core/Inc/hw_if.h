@@ -74,8 +74,19 @@ extern "C" {
     hw_uart_to,
   } hw_status_t;
 
+  /**
+   * Position given to the reception event callback when the circular DMA reception
+   * has been restarted from the start of the buffer after an error
+   */
+#define HW_UART_RX_RESTART    0xFFFFU
+
   void HW_UART_Init(hw_uart_id_t hw_uart_id);
   void HW_UART_Receive_IT(hw_uart_id_t hw_uart_id, uint8_t *pData, uint16_t Size, void (*Callback)(void));
+  /**
+   * The DMA channel shall be in circular mode. The callback is called from the interrupt
+   * on idle line, half and full buffer with the position of the next byte to be written.
+   */
+  hw_status_t HW_UART_Receive_ToIdle_DMA(hw_uart_id_t hw_uart_id, uint8_t *p_data, uint16_t size, void (*Callback)(uint16_t pos));
   void HW_UART_Transmit_IT(hw_uart_id_t hw_uart_id, uint8_t *pData, uint16_t Size,  void (*Callback)(void));
   hw_status_t HW_UART_Transmit(hw_uart_id_t hw_uart_id, uint8_t *p_data, uint16_t size,  uint32_t timeout);
   hw_status_t HW_UART_Transmit_DMA(hw_uart_id_t hw_uart_id, uint8_t *p_data, uint16_t size, void (*Callback)(void));
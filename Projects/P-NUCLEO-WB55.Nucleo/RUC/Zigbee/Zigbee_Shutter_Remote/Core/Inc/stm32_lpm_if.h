@@ -25,6 +25,7 @@ extern "C" {
 #endif
 
 /* Includes ------------------------------------------------------------------*/
+#include "stm32_lpm.h"
 
 /**
   * @brief Enters Low Power Off Mode
@@ -70,6 +71,30 @@ void PWR_EnterSleepMode( void );
   */
 void PWR_ExitSleepMode( void );
 
+/**
+  * @brief Returns a free running timestamp based on the RTC, counting in low power modes
+  * @note The unit is 1 / CFG_LPM_TIMESTAMP_FREQ s
+  * @param none
+  * @retval timestamp
+  */
+uint32_t PWR_GetTimestamp( void );
+
+/**
+  * @brief Returns the time left before the next timer server expiry
+  * @note The unit is the one of PWR_GetTimestamp
+  * @param none
+  * @retval time left, 0xFFFFFFFF if no timer is running
+  */
+uint32_t PWR_GetNextWakeup( void );
+
+/**
+  * @brief Returns the source of the wakeup from the pending interrupts
+  * @note Called in critical section when leaving the low power mode
+  * @param none
+  * @retval wakeup source
+  */
+UTIL_LPM_WakeupSource_t PWR_GetWakeupSource( void );
+
 #ifdef __cplusplus
 }
 #endif
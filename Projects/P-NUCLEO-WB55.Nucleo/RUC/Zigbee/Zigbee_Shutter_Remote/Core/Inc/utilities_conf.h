@@ -26,6 +26,7 @@ extern "C" {
 
 #include "cmsis_compiler.h"
 #include "string.h"
+#include "stm32_lpm_if.h"
 
 /******************************************************************************
  * common
@@ -44,6 +45,13 @@ extern "C" {
 #define UTIL_LPM_INIT_CRITICAL_SECTION( )
 #define UTIL_LPM_ENTER_CRITICAL_SECTION( )      UTILS_ENTER_CRITICAL_SECTION( )
 #define UTIL_LPM_EXIT_CRITICAL_SECTION( )       UTILS_EXIT_CRITICAL_SECTION( )
+#define UTIL_LPM_STATS_ENABLE                   (1)
+#define UTIL_LPM_GET_TIMESTAMP( )               PWR_GetTimestamp( )
+#define UTIL_LPM_GET_WAKEUP_SOURCE( )           PWR_GetWakeupSource( )
+#define UTIL_LPM_PREDICT_ENABLE                 (1)
+#define UTIL_LPM_GET_NEXT_WAKEUP( )             PWR_GetNextWakeup( )
+#define UTIL_LPM_STOP_BREAK_EVEN                (2U)    /* in RTC ticks, about 1ms */
+#define UTIL_LPM_OFF_BREAK_EVEN                 (64U)   /* in RTC ticks, about 30ms more than stop */
 
 /******************************************************************************
  * sequencer
@@ -0,0 +1,525 @@
+/**
+******************************************************************************
+* @file    app_console.c
+* @author  Zigbee Application Team
+* @brief   Line oriented console on the trace UART
+******************************************************************************
+* @attention
+*
+* Copyright (c) 2019-2024 STMicroelectronics.
+* All rights reserved.
+*
+* This software is licensed under terms that can be found in the LICENSE file
+* in the root directory of this software component.
+* If no LICENSE file comes with this software, it is provided AS-IS.
+*
+******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_common.h"
+#include "hw_if.h"
+#include "stm32_seq.h"
+#include "utilities_conf.h"
+
+/* Services dependencies */
+#include "app_console.h"
+
+/* Private defines ---------------------------------------------------------- */
+#define CONSOLE_LINE_END             "\r\n"
+/* Longest response line, truncated when longer */
+#define CONSOLE_RESP_SIZE            128U
+
+/* Private variables -------------------------------------------------------- */
+/* The DMA writes the received bytes in console_rx in circular mode, the console task reads
+ * them from console_rx_tail up to the position given by the last reception event. The number
+ * of wraps tells an empty buffer from a full one when the head is back at the tail. */
+static uint8_t                 console_rx[CONSOLE_RX_SIZE];
+static volatile uint16_t       console_rx_head;         /* Updated under interrupt */
+static volatile uint16_t       console_rx_wraps;        /* Updated under interrupt */
+static volatile bool           console_rx_restart;      /* Updated under interrupt */
+static uint16_t                console_rx_tail;
+static bool                    console_started;
+
+/* Line under construction, kept between two bursts */
+static char                    console_line[CONSOLE_LINE_SIZE];
+static uint8_t                 console_line_nb;
+static bool                    console_line_overflow;
+
+/* Responses waiting for the end of the burst */
+static char                    console_out[CONSOLE_OUT_SIZE];
+static uint16_t                console_out_nb;
+
+static const Console_Cmd_T *   console_cmd;
+static uint8_t                 console_cmd_nb;
+static const Console_Param_T * console_param;
+static uint8_t                 console_param_nb;
+
+/* Private functions prototypes-----------------------------------------------*/
+static void                    Console_RxEvent   (uint16_t pos);
+static void                    Console_Task      (void);
+static void                    Console_Exec_Line (char * line);
+static void                    Console_Exec      (char * cmd);
+static char *                  Console_Next_Word (char ** cursor);
+static void                    Console_Help      (void);
+static void                    Console_Set       (const char * name, const char * value);
+static void                    Console_Get       (const char * name);
+static const Console_Param_T * Console_Find_Param(const char * name);
+static uint32_t                Console_Param_Read (const Console_Param_T * param);
+static void                    Console_Param_Write(const Console_Param_T * param, uint32_t value);
+
+
+/* Exported Functions Definition -------------------------------------------- */
+
+/**
+ * @brief  Start the reception of the console on the trace UART
+ * @param  cmd: commands table
+ * @param  cmd_nb: number of commands
+ * @param  param: parameters table for set and get, NULL if none
+ * @param  param_nb: number of parameters
+ * @retval false if the reception can not be started
+ */
+bool Console_Init(const Console_Cmd_T * cmd, uint8_t cmd_nb, const Console_Param_T * param, uint8_t param_nb)
+{
+  console_cmd      = cmd;
+  console_cmd_nb   = cmd_nb;
+  console_param    = param;
+  console_param_nb = param_nb;
+
+  /* The reception runs for ever once started */
+  if (console_started)
+  {
+    return true;
+  }
+
+  UTIL_SEQ_RegTask(1U << CFG_TASK_CONSOLE, UTIL_SEQ_RFU, Console_Task);
+  console_rx_head = 0U;
+  console_rx_wraps = 0U;
+  console_rx_tail = 0U;
+  if (HW_UART_Receive_ToIdle_DMA(CFG_DEBUG_TRACE_UART, console_rx, CONSOLE_RX_SIZE, Console_RxEvent) != hw_uart_ok)
+  {
+    return false;
+  }
+
+  console_started = true;
+  return true;
+} /* Console_Init */
+
+/**
+ * @brief  Process received bytes, a command is executed at the end of its line
+ * @param  data: received bytes
+ * @param  size: number of bytes
+ * @retval None
+ */
+void Console_Input(const uint8_t * data, uint16_t size)
+{
+  uint16_t i;
+
+  for (i = 0U; i < size; i++)
+  {
+    char c = (char)data[i];
+
+    if ((c == '\r') || (c == '\n'))
+    {
+      /* CR LF gives an empty line, nothing to do */
+      if (console_line_overflow)
+      {
+        Console_Printf("ERR line longer than %u characters", (unsigned int)(CONSOLE_LINE_SIZE - 1U));
+      }
+      else if (console_line_nb > 0U)
+      {
+        console_line[console_line_nb] = '\0';
+        Console_Exec_Line(console_line);
+      }
+      console_line_nb = 0U;
+      console_line_overflow = false;
+    }
+    else if ((c == '\b') || (c == 0x7F))
+    {
+      if (console_line_nb > 0U)
+      {
+        console_line_nb--;
+      }
+    }
+    else if (console_line_nb < (CONSOLE_LINE_SIZE - 1U))
+    {
+      console_line[console_line_nb++] = c;
+    }
+    else
+    {
+      console_line_overflow = true;
+    }
+  }
+} /* Console_Input */
+
+/**
+ * @brief  Send the responses waiting in one write
+ * @param  None
+ * @retval None
+ */
+void Console_Flush(void)
+{
+  if (console_out_nb > 0U)
+  {
+    printf("%s", console_out);
+    console_out_nb = 0U;
+    console_out[0] = '\0';
+  }
+} /* Console_Flush */
+
+/**
+ * @brief  Add a response line, sent at the end of the burst of commands
+ * @param  format: printf format, without line end
+ * @retval None
+ */
+void Console_Printf(const char * format, ...)
+{
+  char     resp[CONSOLE_RESP_SIZE];
+  uint16_t len;
+  va_list  args;
+
+  va_start(args, format);
+  vsnprintf(resp, sizeof(resp) - (sizeof(CONSOLE_LINE_END) - 1U), format, args);
+  va_end(args);
+  strcat(resp, CONSOLE_LINE_END);
+  len = (uint16_t)strlen(resp);
+
+  if ((console_out_nb + len) >= CONSOLE_OUT_SIZE)
+  {
+    Console_Flush();
+  }
+  memcpy(&console_out[console_out_nb], resp, len + 1U);
+  console_out_nb += len;
+} /* Console_Printf */
+
+
+/* Private Functions Definition --------------------------------------------- */
+
+/**
+ * @brief  Reception event of the DMA, on idle line, half and full buffer
+ * @param  pos: position of the next byte written by the DMA
+ * @retval None
+ */
+static void Console_RxEvent(uint16_t pos)
+{
+  if (pos == HW_UART_RX_RESTART)
+  {
+    console_rx_restart = true;
+    console_rx_wraps = 0U;
+    pos = 0U;
+  }
+  else if (pos >= CONSOLE_RX_SIZE)
+  {
+    /* Transfer complete, the DMA goes on from the buffer start */
+    console_rx_wraps++;
+    pos = 0U;
+  }
+  console_rx_head = pos;
+
+  UTIL_SEQ_SetTask(1U << CFG_TASK_CONSOLE, CFG_SCH_PRIO_1);
+} /* Console_RxEvent */
+
+/**
+ * @brief  Process all the bytes received since the last run and answer in one write
+ * @param  None
+ * @retval None
+ */
+static void Console_Task(void)
+{
+  uint16_t head;
+  uint16_t wraps;
+  uint32_t pending;
+  bool     restart;
+
+  UTILS_ENTER_CRITICAL_SECTION();
+  head = console_rx_head;
+  wraps = console_rx_wraps;
+  console_rx_wraps = 0U;
+  restart = console_rx_restart;
+  console_rx_restart = false;
+  UTILS_EXIT_CRITICAL_SECTION();
+
+  /* The reception restarted from the buffer start, the line under construction is lost */
+  if (restart)
+  {
+    console_rx_tail = 0U;
+    console_line_nb = 0U;
+    console_line_overflow = false;
+  }
+
+  pending = ((uint32_t)wraps * CONSOLE_RX_SIZE) + head - console_rx_tail;
+  if (pending > CONSOLE_RX_SIZE)
+  {
+    /* The DMA has written over bytes not read yet, the line under construction is lost */
+    Console_Printf("ERR console overrun, %u bytes lost", (unsigned int)(pending - CONSOLE_RX_SIZE));
+    console_line_nb = 0U;
+    console_line_overflow = false;
+  }
+  else
+  {
+    if (wraps != 0U)
+    {
+      Console_Input(&console_rx[console_rx_tail], CONSOLE_RX_SIZE - console_rx_tail);
+      console_rx_tail = 0U;
+    }
+    Console_Input(&console_rx[console_rx_tail], head - console_rx_tail);
+  }
+  console_rx_tail = head;
+
+  Console_Flush();
+} /* Console_Task */
+
+/**
+ * @brief  Execute the commands of a line
+ * @param  line: commands separated by CONSOLE_CMD_SEPARATOR
+ * @retval None
+ */
+static void Console_Exec_Line(char * line)
+{
+  char * cmd = line;
+  char * end;
+
+  do
+  {
+    end = strchr(cmd, CONSOLE_CMD_SEPARATOR);
+    if (end != NULL)
+    {
+      *end = '\0';
+    }
+    Console_Exec(cmd);
+    cmd = end + 1;
+  } while (end != NULL);
+} /* Console_Exec_Line */
+
+/**
+ * @brief  Execute one command: set, get, help or one of the commands table
+ * @param  cmd: command and its arguments
+ * @retval None
+ */
+static void Console_Exec(char * cmd)
+{
+  char * word = Console_Next_Word(&cmd);
+  char * arg1;
+  char * arg2;
+  uint8_t i;
+
+  if (word == NULL)
+  {
+    return;
+  }
+  arg1 = Console_Next_Word(&cmd);
+  arg2 = Console_Next_Word(&cmd);
+
+  if (strcmp(word, "set") == 0)
+  {
+    if ((arg1 == NULL) || (arg2 == NULL))
+    {
+      Console_Printf("ERR usage: set <param> <value>");
+    }
+    else
+    {
+      Console_Set(arg1, arg2);
+    }
+  }
+  else if (strcmp(word, "get") == 0)
+  {
+    Console_Get(arg1);
+  }
+  else if (strcmp(word, "help") == 0)
+  {
+    Console_Help();
+  }
+  else
+  {
+    for (i = 0U; i < console_cmd_nb; i++)
+    {
+      if (strcmp(word, console_cmd[i].name) == 0)
+      {
+        console_cmd[i].fct();
+        Console_Printf("%s OK", word);
+        return;
+      }
+    }
+    Console_Printf("ERR unknown command: %s", word);
+  }
+} /* Console_Exec */
+
+/**
+ * @brief  Cut the next word of a command
+ * @param  cursor: position in the command, moved after the word
+ * @retval The word, NULL at the end of the command
+ */
+static char * Console_Next_Word(char ** cursor)
+{
+  char * word = *cursor;
+
+  while (*word == ' ')
+  {
+    word++;
+  }
+  if (*word == '\0')
+  {
+    *cursor = word;
+    return NULL;
+  }
+
+  *cursor = word;
+  while ((**cursor != ' ') && (**cursor != '\0'))
+  {
+    (*cursor)++;
+  }
+  if (**cursor == ' ')
+  {
+    **cursor = '\0';
+    (*cursor)++;
+  }
+  return word;
+} /* Console_Next_Word */
+
+/**
+ * @brief  List the commands and the parameters
+ * @param  None
+ * @retval None
+ */
+static void Console_Help(void)
+{
+  uint8_t i;
+
+  Console_Printf("set <param> <value>, get [param], help");
+  for (i = 0U; i < console_cmd_nb; i++)
+  {
+    Console_Printf("  %s", console_cmd[i].name);
+  }
+  for (i = 0U; i < console_param_nb; i++)
+  {
+    Console_Printf("  %s [%lu..%lu]", console_param[i].name,
+                   (unsigned long)console_param[i].min, (unsigned long)console_param[i].max);
+  }
+} /* Console_Help */
+
+/**
+ * @brief  Change a parameter, checked against its range
+ * @param  name: parameter name
+ * @param  value: new value, decimal or 0x hexadecimal
+ * @retval None
+ */
+static void Console_Set(const char * name, const char * value)
+{
+  const Console_Param_T * param = Console_Find_Param(name);
+  char *   end;
+  uint32_t val;
+
+  if (param == NULL)
+  {
+    Console_Printf("ERR unknown param: %s", name);
+    return;
+  }
+
+  val = strtoul(value, &end, 0);
+  if ((*end != '\0') || (*value == '-') || (val < param->min) || (val > param->max))
+  {
+    Console_Printf("ERR %s: %s not in [%lu..%lu]", name, value,
+                   (unsigned long)param->min, (unsigned long)param->max);
+    return;
+  }
+
+  Console_Param_Write(param, val);
+  if (param->apply != NULL)
+  {
+    param->apply();
+  }
+  Console_Printf("%s = %lu", param->name, (unsigned long)Console_Param_Read(param));
+} /* Console_Set */
+
+/**
+ * @brief  Display a parameter, or all of them
+ * @param  name: parameter name, NULL for all
+ * @retval None
+ */
+static void Console_Get(const char * name)
+{
+  const Console_Param_T * param;
+  uint8_t i;
+
+  if (name == NULL)
+  {
+    for (i = 0U; i < console_param_nb; i++)
+    {
+      Console_Printf("%s = %lu", console_param[i].name, (unsigned long)Console_Param_Read(&console_param[i]));
+    }
+    return;
+  }
+
+  param = Console_Find_Param(name);
+  if (param == NULL)
+  {
+    Console_Printf("ERR unknown param: %s", name);
+  }
+  else
+  {
+    Console_Printf("%s = %lu", param->name, (unsigned long)Console_Param_Read(param));
+  }
+} /* Console_Get */
+
+/**
+ * @brief  Look for a parameter by its name
+ * @param  name: parameter name
+ * @retval The parameter, NULL if not found
+ */
+static const Console_Param_T * Console_Find_Param(const char * name)
+{
+  uint8_t i;
+
+  for (i = 0U; i < console_param_nb; i++)
+  {
+    if (strcmp(name, console_param[i].name) == 0)
+    {
+      return &console_param[i];
+    }
+  }
+  return NULL;
+} /* Console_Find_Param */
+
+/**
+ * @brief  Read the application variable of a parameter
+ * @param  param: parameter
+ * @retval Value of the variable
+ */
+static uint32_t Console_Param_Read(const Console_Param_T * param)
+{
+  switch (param->size)
+  {
+    case 1U:
+      return *(const uint8_t *)param->value;
+
+    case 2U:
+      return *(const uint16_t *)param->value;
+
+    default:
+      return *(const uint32_t *)param->value;
+  }
+} /* Console_Param_Read */
+
+/**
+ * @brief  Write the application variable of a parameter
+ * @param  param: parameter
+ * @param  value: value in the parameter range
+ * @retval None
+ */
+static void Console_Param_Write(const Console_Param_T * param, uint32_t value)
+{
+  switch (param->size)
+  {
+    case 1U:
+      *(uint8_t *)param->value = (uint8_t)value;
+      break;
+
+    case 2U:
+      *(uint16_t *)param->value = (uint16_t)value;
+      break;
+
+    default:
+      *(uint32_t *)param->value = value;
+      break;
+  }
+} /* Console_Param_Write */
@@ -30,17 +30,35 @@ uint8_t display_type;
 #define MENU_REFRESH_DELAY           2
 #define HW_TS_MENU_REFRESH_DELAY     (MENU_REFRESH_DELAY * HW_TS_SERVER_1S_NB_TICKS)
 
+/* Menu line sent to the UART in one write, truncated when longer */
+#define MENU_LINE_SIZE               512U
+#define MENU_LINE_END                "\n\x1b[2K\x1b[u"  /* Add one blank line, delete the text on it and retrieve last cursor position saved */
+#define MENU_LINE_MAX                (MENU_LINE_SIZE - sizeof(MENU_LINE_END))
+
+/* Private typedef ---------------------------------------------------------- */
+typedef struct
+{
+  const Menu_Item_T * items;      /* Items of the level */
+  uint8_t             nb;         /* Number of items of the level */
+  uint8_t             index;      /* Selected item of the level */
+} Menu_Level_T;
+
 /* Private variables -------------------------------------------------------- */
-static Menu_Item_T * current_menu;
-static int           nb_of_menu_item;
+static Menu_Level_T  menu_level[MENU_DEPTH_MAX];  /* Levels from the main menu to the current one */
+static uint8_t       menu_depth;
+static bool          menu_refresh_created;
 static uint8_t       TS_ID_REFRESH_MENU_DISP;
+static char          menu_line[MENU_LINE_SIZE];
+static volatile bool menu_line_busy;              /* menu_line in use, the refresh timer runs under interrupt */
 
 /* Private functions prototypes-----------------------------------------------*/
 /* Menu Methode */
-static bool Check_Menu     (Menu_Item_T * menu_item);
-static void Calc_Item_Nb   (void);
-static void Print_Menu     (void);
-static void Clear_UART_Line(void);
+static bool                Check_Menu      (const Menu_Item_T * menu, uint8_t nb, uint8_t depth);
+static const Menu_Item_T * Get_Menu_Item   (void);
+static void                Print_Menu      (void);
+static void                Print_Menu_UART (void);
+static void                Print_Menu_LCD  (void);
+static void                Clear_UART_Line (void);
 
 
 /* Exported Functions Definition -------------------------------------------- */
@@ -53,9 +71,11 @@ static void Clear_UART_Line(void);
  */
 void Next_Menu_Item(void)
 {
-  current_menu = current_menu->next_item;
+  Menu_Level_T * level = &menu_level[menu_depth];
+
+  level->index = ((level->index + 1U) < level->nb) ? (level->index + 1U) : 0U;
   /* Display New Menu selection */
-  Print_Menu();      
+  Print_Menu();
 } /* Next_Menu_Item */
 
 /**
@@ -65,40 +85,40 @@ void Next_Menu_Item(void)
  */
 void Prev_Menu_Item(void)
 {
-  current_menu = current_menu->prev_item;
+  Menu_Level_T * level = &menu_level[menu_depth];
+
+  level->index = (level->index > 0U) ? (level->index - 1U) : (level->nb - 1U);
   /* Display New Menu selection */
-  Print_Menu();   
+  Print_Menu();
 } /* Prev_Menu_Item */
 
 /**
  * @brief  Do the action associated to the item
- * @param  arg pointer to launch the item
+ * @param  None
  * @retval None
  */
 void Select_Menu_Item(void)
 {
+  const Menu_Item_T * item = Get_Menu_Item();
+
   /* If this item get an sub menu, change current menu selection */
-  if (current_menu->sub_level != NULL)
+  if (item->sub_level != NULL)
   {
-    if (Check_Menu(current_menu->sub_level))
-    {
-      current_menu = current_menu->sub_level;
-      /* Calcule the new number of item in this menu */
-      Calc_Item_Nb();
-      Clear_UART_Line();        /* Clear Terminal line*/
-      Print_Menu();      
-    }
-    else
-    {
-      Clear_UART_Line();        /* Clear Terminal line*/
-      APP_ZB_DBG("Impossible to go in sub menu : Check Error");
-    }
+    /* The depth has been checked at the start of the menu. The level is filled
+     * before it is entered, the refresh timer prints it under interrupt */
+    menu_level[menu_depth + 1U].items = item->sub_level;
+    menu_level[menu_depth + 1U].nb    = item->sub_nb;
+    menu_level[menu_depth + 1U].index = 0U;
+    __COMPILER_BARRIER();
+    menu_depth++;
+    Clear_UART_Line();        /* Clear Terminal line*/
+    Print_Menu();
   }
   /* Launch the associated function */
-  else if (current_menu->fct != NULL)
+  else if (item->fct != NULL)
   {
     Clear_UART_Line();        /* Clear Terminal line*/
-    current_menu->fct();
+    item->fct();
   }
 } /* Select_Menu_Item */
 
@@ -109,10 +129,10 @@ void Select_Menu_Item(void)
  */
 void Exit_Menu_Item(void)
 {
-  if (current_menu->parent != NULL)
+  if (menu_depth > 0U)
   {
-    current_menu = current_menu->parent;
-    Calc_Item_Nb();
+    /* Back to the parent item, still selected in its level */
+    menu_depth--;
     Clear_UART_Line();        /* Clear Terminal line*/
     Print_Menu();
   }
@@ -123,331 +143,206 @@ void Exit_Menu_Item(void)
   }
 } /* Exit_Menu_Item */
 
-// Configuration fonctions for your menu tree
 /**
- * @brief  Create the instance of menu item
- * @retval pointer to the instance item
+ * @brief  Display again the menu on the UART and on the LCD
+ * @param  None
+ * @retval None
  */
-Menu_Item_T * Create_Menu_Item(void)
+void Refresh_Menu(void)
 {
-  Menu_Item_T * menu_item = (Menu_Item_T *) malloc(sizeof(Menu_Item_T));
-  
-  menu_item->first_item_to_display = false;
-  menu_item->name                  = NULL;
-  menu_item->prev_item             = NULL;
-  menu_item->next_item             = NULL;
-  menu_item->parent                = NULL;
-  menu_item->sub_level             = NULL;
-  menu_item->fct                   = NULL;
-  
-  return menu_item;
-} /* Create_Menu_Item */
-  
+  Print_Menu();
+} /* Refresh_Menu */
+
+// Configuration fonctions for your menu tree
 /**
- * @brief  Add an item to the current menu, repat it for each item to create the full menu
- * @param  name of current item of the menu
- * @param  current_item to add to menu
- * @param  next_item of menu
- * @param  sub_level of tree menu 
- * @param  fct to launch for action associated
- * @retval None
+ * @brief  Check the menu tables and start the menu on their first item
+ * May be called again to go back to the main menu
+ * @param  start_menu items of the main menu
+ * @param  nb number of items of the main menu
+ * @retval bool State
  */
-void  Add_Menu_Item(char* name, Menu_Item_T* current_item, Menu_Item_T * next_item,
-                    Menu_Item_T* sub_level, void (*fct)(void) )
+bool Def_Start_Menu_Item(const Menu_Item_T * start_menu, uint8_t nb)
 {
-  /* Global check to init correctly the item and avoid mismatch */
-  if ((sub_level != NULL) && (fct != NULL))
+  if (Check_Menu(start_menu, nb, 0U) == false)
   {
-    APP_ZB_DBG("Warning : [%s] menu item has both function and sub menu config. Only one is supported", name);
-  }
-  else if ((sub_level == NULL) && (fct == NULL))
-  {
-    APP_ZB_DBG("Warning : [%s] menu item hasn't neither function, nor sub menu config. One is needed", name);
+    APP_ZB_DBG("Error at the check of menu");
+    return false;
   }
-  else
-  {
-    /* Init instance menu item */
-    current_item->name      = name;
-    current_item->next_item = next_item;
-    next_item->prev_item    = current_item;   
-    current_item->fct       = fct;
-    
-    /* check if it is the top of the tree */
-    if (current_item->parent != NULL)
-    {
-      next_item->parent = current_item->parent;      
-    }
 
-    /* check if it is a sub-level ot the current_item */
-    if (sub_level != NULL)
-    {
-      current_item->sub_level          = sub_level;
-      /* auto init some parts of the sub-level */
-      sub_level->parent                = current_item;
-      sub_level->first_item_to_display = true;      
-    }    
-  }
-} /*  Add_Menu_Item */
+  menu_depth          = 0U;
+  menu_level[0].items = start_menu;
+  menu_level[0].nb    = nb;
+  menu_level[0].index = 0U;
 
-/**
- * @brief  Delete an item from menu
- * @param  item to delete
- * @retval state
- */
-bool Del_Menu_Item(Menu_Item_T * item)
-{
-  /* check if a sub menu exist */
-  if (item->sub_level == NULL)
+  /* Launch the autorefresh for the UART */
+  if ((display_type & UART_DISPLAY) && (menu_refresh_created == false))
   {
-    /* link correctly the items together */
-    item->prev_item->next_item = item->next_item;
-    item->next_item->prev_item = item->prev_item;
-
-    /* check and remove the parent dependance if exists */
-    if (item->parent != NULL)
-    {
-      item->parent->sub_level = NULL;
-    }
-    free(item->name);
-    //free(item->fct);
-    free(item);
-    
-    return true;
+    // Timer to autorefresh menu on UART
+    // Add to app_conf.h  (enum CFG_TimProcID_t)
+    HW_TS_Create(CFG_TIM_MENU_REFRESH, &TS_ID_REFRESH_MENU_DISP, hw_ts_Repeated, Print_Menu_UART);
+    HW_TS_Start(TS_ID_REFRESH_MENU_DISP, HW_TS_MENU_REFRESH_DELAY);    /* Start auto display when config is ok*/
+    menu_refresh_created = true;
   }
-  /* when a submenu exists, remove it recursivly */
-  else
-  {
-    Menu_Item_T *sub_level, *sub_next_item;
 
-    sub_level = item->sub_level;
-    sub_next_item = sub_level->next_item;
-    
-    /* loop on each item of the sub menu to delete it */
-    while (sub_next_item != sub_level )
-    {
-      if (Del_Menu_Item(sub_next_item) == false)
-      {
-        return false;
-      }
-      sub_next_item = sub_level->next_item;
-    }
-  }
+  Print_Menu();
+
   return true;
-} /* Del_Menu_Item */
+} /* Def_Start_Menu_Item */
+
 
+/* Private Functions Definition --------------------------------------------- */
+// Internal checkers
 /**
- * @brief  Check if the menu configuration is OK, if yes return the starting point of menu
- * @param  None
+ * @brief  Check that every item has either an action or a sub menu, down to the last level
+ * @param  menu  items of the level to check
+ * @param  nb    number of items of the level
+ * @param  depth depth of the level, 0 for the main menu
  * @retval bool State
  */
-bool Def_Start_Menu_Item(Menu_Item_T * start_item)
-{ 
-  Menu_Item_T * next_item = start_item->next_item;
-  int infinite_loop = 0;
-  
-  /* The starting stage of menu shouldn't have master above him */
-  if (start_item->parent != NULL)
+static bool Check_Menu(const Menu_Item_T * menu, uint8_t nb, uint8_t depth)
+{
+  if ((menu == NULL) || (nb == 0U))
   {
-    APP_ZB_DBG("The first stage of menu shouldn't have any master menu");
+    APP_ZB_DBG("Error : Empty menu");
     return false;
   }
 
-  /* The starting stage of menu shouldn't have master above him */
-  while ((next_item != start_item ) && (infinite_loop++ <= 100))
-  {
-    if ( next_item->parent != NULL )
-    {
-      APP_ZB_DBG("The first stage of menu shouldn't have any master menu");
-      return false;
-    }
-    next_item = next_item->next_item;
-  }
-  
-  /* Infinite loop error */
-  if (infinite_loop >= 100)
+  if (depth >= MENU_DEPTH_MAX)
   {
-    APP_ZB_DBG("Error : Last menu item isn't linked to first one");
+    APP_ZB_DBG("Error : Menu deeper than %d levels", MENU_DEPTH_MAX);
     return false;
   }
-  
-  /* Check that all items are linked together */
-  if (Check_Menu(start_item))
-  {
-    start_item->first_item_to_display = true;
-    current_menu = start_item;
-    Calc_Item_Nb();
 
-    /* Launch the autorefresh for the UART */
-    if (display_type & UART_DISPLAY)
+  /* loop on each item of the menu to check it */
+  for (uint8_t i = 0; i < nb; i++)
+  {
+    if ((menu[i].sub_level != NULL) == (menu[i].fct != NULL))
     {
-      // Timer to autorefresh menu on UART
-  	  // Add to app_conf.h  (enum CFG_TimProcID_t)
-      HW_TS_Create(CFG_TIM_MENU_REFRESH, &TS_ID_REFRESH_MENU_DISP, hw_ts_Repeated, Print_Menu);
-      HW_TS_Start(TS_ID_REFRESH_MENU_DISP, HW_TS_MENU_REFRESH_DELAY);    /* Start auto display when config is ok*/
+      APP_ZB_DBG("Error : [%s] menu item needs either a function or a sub menu", menu[i].name);
+      return false;
     }
-    else
+
+    /* Check for sub menu */
+    if ((menu[i].sub_level != NULL) && (Check_Menu(menu[i].sub_level, menu[i].sub_nb, depth + 1U) == false))
     {
-      Print_Menu();
+      return false;
     }
-
-    return true;
-  }
-  else
-  {
-    APP_ZB_DBG("Error at the check of menu");
-    return false;
   }
-} /* Def_Start_Menu_Item */
 
+  return true;
+} /* Check_Menu */
 
-/* Private Functions Definition --------------------------------------------- */
-// Internal checkers
 /**
- * @brief  Check that every item is linked to another one
- * @param  menu_item to check
- * @retval bool State
+ * @brief  Get the selected item of the current menu stage
+ * @param  None
+ * @retval selected item
  */
-static bool Check_Menu( Menu_Item_T * menu_item) 
+static const Menu_Item_T * Get_Menu_Item(void)
 {
-  const Menu_Item_T * first_item = menu_item;
-  Menu_Item_T * temp_item = menu_item->next_item;
-  int infinite_loop = 0;
-  bool status_ok = true;
-  bool first_item_already_exist = false;
-  
-  /* loop on each item of the menu to check it */
-  while ((temp_item != first_item ) && (infinite_loop++ <= 100))
-  {
-    /* Check that sub menu items are linked together */
-    if ( temp_item->sub_level != NULL ) 
-    {
-      /* Check for sub menu */
-       status_ok = Check_Menu( temp_item->sub_level );
-    }
-    
-    /* Check that there is no two items defined to be displayed first */
-    if ( temp_item->first_item_to_display == true)
-    {
-      if (first_item_already_exist == true)
-      {
-        Clear_UART_Line();        /* Clear Terminal line*/
-        APP_ZB_DBG("Error : Multiple item defined to be first to display");
-        return 0;
-      }
-      else
-      {
-        first_item_already_exist = true;
-      }
-    }
-    temp_item = temp_item->next_item;
-  }
-  
-  /* Infinite loop error */
-  if (infinite_loop >= 100)
-  {
-    APP_ZB_DBG("Error : Last menu item isn't linked to first one");
-    status_ok = false;
-  }
-  
-  return status_ok;
-} /* Check_Menu */
+  return &menu_level[menu_depth].items[menu_level[menu_depth].index];
+} /* Get_Menu_Item */
 
 /**
- * @brief  Compute the number of item in this menu stage
+ * @brief  Print the Menu on the UART and on the LCD
  * @param  None
  * @retval None
  */
-static void Calc_Item_Nb(void)
+static void Print_Menu(void)
 {
-  const Menu_Item_T * first_item = current_menu;
-  Menu_Item_T * temp_item = current_menu->next_item;
-  int infinite_loop = 0;
-
-  nb_of_menu_item = 0;
-  
-  while ((temp_item != first_item ) && (infinite_loop++ <= 100))
-  {
-    nb_of_menu_item++;
-    temp_item = temp_item->next_item;
-  }
-  nb_of_menu_item++;
-  if(infinite_loop >= 100)
-  {
-    /* Should not happend, already checked in Check_Menu function */
-    Clear_UART_Line();        /* Clear Terminal line*/ 
-    APP_ZB_DBG("Erreur : Linked list not linked");
-  }
-} /* Calc_Item_Nb */
+  Print_Menu_UART();
+  Print_Menu_LCD();
+} /* Print_Menu */
 
 /**
- * @brief  Print the Menu. The Tera Term New Line setting should be set to LF
+ * @brief  Print the Menu on the UART in a single write. The Tera Term New Line setting should be set to LF
+ * Also called periodically under interrupt as the logs scroll the menu out of the terminal,
+ * this refresh is skipped when it interrupts the print of a new selection.
  * @param  None
  * @retval None
  */
-static void Print_Menu(void)
+static void Print_Menu_UART(void)
 {
-  if (display_type & UART_DISPLAY)
+  const Menu_Level_T * level = &menu_level[menu_depth];
+  const Menu_Item_T *  item;
+  uint32_t             length;
+
+  if (((display_type & UART_DISPLAY) == 0U) || (menu_line_busy == true))
   {
-    Menu_Item_T * temp_item = current_menu;
-
-    printf("\x1b[s");                                           //Save current position of cursor
-    printf("\x1b[H\x1b[2K\x1b[m");                              //Set the terminal position on the top left of the terminal
-                                                                //Delete line
-                                                                //Reset all previous text config
-    printf("\x1b[38;5;178m MENU :\x1b[m ");                     //Set Background and forground color for " MENU :" print
-    
-    /* Loop to display the first menu item */
-    while (temp_item->first_item_to_display == false)
-    {
-      temp_item = temp_item->next_item;
-    }
-    
-    /* Loop on each menu item and display it following order */
-    for ( int i = 0; i < nb_of_menu_item; i++)
+    return;
+  }
+  menu_line_busy = true;
+
+  length = snprintf(menu_line, MENU_LINE_MAX, "\x1b[s"                    //Save current position of cursor
+                                              "\x1b[H\x1b[2K\x1b[m"       //Set the terminal position on the top left of the terminal
+                                                                          //Delete line
+                                                                          //Reset all previous text config
+                                              "\x1b[38;5;178m MENU :\x1b[m ");  //Set Background and forground color for " MENU :" print
+
+  /* Loop on each menu item and display it following order */
+  for (uint8_t i = 0; (i < level->nb) && (length < MENU_LINE_MAX); i++)
+  {
+    item = &level->items[i];
+    if (i == level->index)
     {
-      if (temp_item == current_menu)
+      /* Change the display following to if submenu or action to do */
+      if (item->fct == NULL)
       {
-        /* Change the display following to if submenu or action to do */
-        if (temp_item->fct == NULL)
-        {
-          printf(" \x1b[93m[%s]\x1b[m ",temp_item->name);
-        }
-        else
-        {
-          printf("  \x1b[93m%s\x1b[m  ",temp_item->name);          
-        }
+        length += snprintf(&menu_line[length], MENU_LINE_MAX - length, " \x1b[93m[%s]\x1b[m ", item->name);
       }
       else
       {
-        printf("  %s  ",temp_item->name);
-      }       
-      temp_item = temp_item->next_item;
+        length += snprintf(&menu_line[length], MENU_LINE_MAX - length, "  \x1b[93m%s\x1b[m  ", item->name);
+      }
+    }
+    else
+    {
+      length += snprintf(&menu_line[length], MENU_LINE_MAX - length, "  %s  ", item->name);
     }
-    /* return to the start of line */
-    printf("\n\x1b[2K\x1b[u");                                  //Add one blank line, delete the text on it and retrieve last cursor position saved
   }
- 
+
+  /* The end of line is always kept to retrieve the cursor position */
+  if (length >= MENU_LINE_MAX)
+  {
+    length = MENU_LINE_MAX - 1U;
+  }
+  memcpy(&menu_line[length], MENU_LINE_END, sizeof(MENU_LINE_END));
+
+  printf("%s", menu_line);
+
+  menu_line_busy = false;
+} /* Print_Menu_UART */
+
+/**
+ * @brief  Print the current menu item on the LCD
+ * Only the menu line is drawn.
+ * @param  None
+ * @retval None
+ */
+static void Print_Menu_LCD(void)
+{
   /* DK LCD, display only the current menu */
   if (display_type & DK_LCD_DISPLAY)
   {
 #ifdef LCD_H
+    const Menu_Item_T * item = Get_Menu_Item();
     char Display_text[32];
-	if (current_menu->fct == NULL)
-	{
-		sprintf(Display_text,"[%s]", current_menu->name);
-	}
-	else
-	{
-	    sprintf(Display_text,"{%s}", current_menu->name);         
-	}	
+
+    if (item->fct == NULL)
+    {
+      snprintf(Display_text, sizeof(Display_text), "[%s]", item->name);
+    }
+    else
+    {
+      snprintf(Display_text, sizeof(Display_text), "{%s}", item->name);
+    }
     UTIL_LCD_ClearStringLine(DK_LCD_MENU_LINE);
     UTIL_LCD_DisplayStringAt(0, LINE(DK_LCD_MENU_LINE), (uint8_t *) Display_text, CENTER_MODE);
     BSP_LCD_Refresh(0);
 #else
     APP_ZB_DBG("No LCD config");
-#endif    
+#endif
   }
-} /* Print_Menu */
+} /* Print_Menu_LCD */
 
 /**
  * @brief  Clear the menu in UART. The Tera Term New Line setting should be set to LF
@@ -461,4 +356,3 @@ void Clear_UART_Line(void)
   	printf("\x1b[2K");    /* Clear Terminal line*/
   }
 } /* Clear_UART_LINE */
-
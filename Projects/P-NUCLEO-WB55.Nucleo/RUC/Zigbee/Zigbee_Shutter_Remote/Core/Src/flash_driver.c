@@ -34,21 +34,37 @@ typedef enum
 {
   FLASH_ERASE,
   FLASH_WRITE,
+  FLASH_WRITE_ROW,
 }FlashOperationType_t;
 
 /* Private defines -----------------------------------------------------------*/
+#define FD_ROW_SIZE                  (FD_ROW_NB_DATA * 8U)
+
 /* Private macros ------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+static FD_LeaseStats_t lease_stats;
+static uint32_t lease_start;
+static uint8_t lease_held;
+static uint64_t stage_data[FD_ROW_NB_DATA];
+static uint32_t stage_address;
+static uint32_t stage_nb;
+
 /* Global variables ----------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 static SingleFlashOperationStatus_t ProcessSingleFlashOperation(FlashOperationType_t FlashOperationType,
                                                                 uint32_t SectorNumberOrDestAddress,
                                                                 uint64_t Data);
+static SemStatus_t LeaseAcquire(void);
+static SemStatus_t LeaseYield(void);
+static void LeaseRelease(void);
+static uint32_t WriteStaged(uint32_t NbrOfData);
+#if (CFG_FD_FAST_PROGRAM != 0)
+static uint32_t WriteRow(uint32_t DestAddress, uint64_t * pSrcBuffer);
+#endif
 /* Public functions ----------------------------------------------------------*/
 uint32_t FD_EraseSectors(uint32_t FirstSector, uint32_t NbrOfSectors)
 {
   uint32_t loop_flash;
-  uint32_t return_value;
   SingleFlashOperationStatus_t single_flash_operation_status;
 
   single_flash_operation_status = SINGLE_FLASH_OPERATION_DONE;
@@ -56,9 +72,10 @@ uint32_t FD_EraseSectors(uint32_t FirstSector, uint32_t NbrOfSectors)
   /**
    *  Take the semaphore to take ownership of the Flash IP
    */
-  while(LL_HSEM_1StepLock(HSEM, CFG_HW_FLASH_SEMID));
-
-  HAL_FLASH_Unlock();
+  if(LeaseAcquire() != SEM_LOCK_SUCCESSFUL)
+  {
+    return NbrOfSectors;
+  }
 
   /**
    *  Notify the CPU2 that some flash erase activity may be executed
@@ -70,39 +87,41 @@ uint32_t FD_EraseSectors(uint32_t FirstSector, uint32_t NbrOfSectors)
 
   for(loop_flash = 0; (loop_flash < NbrOfSectors) && (single_flash_operation_status ==  SINGLE_FLASH_OPERATION_DONE) ; loop_flash++)
   {
+    /**
+     *  Give the ownership of the Flash IP back to the CPU2 between two sectors when held for too long
+     */
+    if(LeaseYield() != SEM_LOCK_SUCCESSFUL)
+    {
+      break;
+    }
+
     single_flash_operation_status = FD_EraseSingleSector(FirstSector+loop_flash);
   }
 
   if(single_flash_operation_status != SINGLE_FLASH_OPERATION_DONE)
   {
-    return_value = NbrOfSectors - loop_flash + 1;
+    /* The last sector has not been erased */
+    loop_flash--;
   }
-  else
-  {
-    /**
-     *  Notify the CPU2 there will be no request anymore to erase the flash
-     *  On reception of this command, the CPU2 will disables the BLE timing protection versus flash erase processing
-     *  The protection is active until next end of radio event.
-     */
-    SHCI_C2_FLASH_EraseActivity(ERASE_ACTIVITY_OFF);
 
-    HAL_FLASH_Lock();
-
-    /**
-     *  Release the ownership of the Flash IP
-     */
-    LL_HSEM_ReleaseLock(HSEM, CFG_HW_FLASH_SEMID, 0);
+  /**
+   *  Notify the CPU2 there will be no request anymore to erase the flash
+   *  On reception of this command, the CPU2 will disables the BLE timing protection versus flash erase processing
+   *  The protection is active until next end of radio event.
+   */
+  SHCI_C2_FLASH_EraseActivity(ERASE_ACTIVITY_OFF);
 
-    return_value = 0;
-  }
+  /**
+   *  Release the ownership of the Flash IP, whatever the result
+   */
+  LeaseRelease();
 
-  return return_value;
+  return NbrOfSectors - loop_flash;
 }
 
 uint32_t FD_WriteData(uint32_t DestAddress, uint64_t * pSrcBuffer, uint32_t NbrOfData)
 {
   uint32_t loop_flash;
-  uint32_t return_value;
   SingleFlashOperationStatus_t single_flash_operation_status;
 
   single_flash_operation_status = SINGLE_FLASH_OPERATION_DONE;
@@ -110,32 +129,107 @@ uint32_t FD_WriteData(uint32_t DestAddress, uint64_t * pSrcBuffer, uint32_t NbrO
   /**
    *  Take the semaphore to take ownership of the Flash IP
    */
-  while(LL_HSEM_1StepLock(HSEM, CFG_HW_FLASH_SEMID));
-
-  HAL_FLASH_Unlock();
+  if(LeaseAcquire() != SEM_LOCK_SUCCESSFUL)
+  {
+    return NbrOfData;
+  }
 
   for(loop_flash = 0; (loop_flash < NbrOfData) && (single_flash_operation_status ==  SINGLE_FLASH_OPERATION_DONE) ; loop_flash++)
   {
+    /**
+     *  Give the ownership of the Flash IP back to the CPU2 between two data when held for too long
+     */
+    if(LeaseYield() != SEM_LOCK_SUCCESSFUL)
+    {
+      break;
+    }
+
     single_flash_operation_status = FD_WriteSingleData(DestAddress+(8*loop_flash), *(pSrcBuffer+loop_flash));
   }
 
   if(single_flash_operation_status != SINGLE_FLASH_OPERATION_DONE)
   {
-    return_value = NbrOfData - loop_flash + 1;
+    /* The last data has not been written */
+    loop_flash--;
   }
-  else
+
+  /**
+   *  Release the ownership of the Flash IP, whatever the result
+   */
+  LeaseRelease();
+
+  return NbrOfData - loop_flash;
+}
+
+uint32_t FD_StageData(uint32_t DestAddress, uint64_t Data)
+{
+  uint32_t left;
+
+  /**
+   *  Write first what is staged when the new data does not follow it
+   */
+  if((stage_nb != 0) && (DestAddress != (stage_address + (8 * stage_nb))))
   {
-    HAL_FLASH_Lock();
+    left = FD_FlushData();
+    if(left != 0)
+    {
+      return left;
+    }
+  }
 
-    /**
-     *  Release the ownership of the Flash IP
-     */
-    LL_HSEM_ReleaseLock(HSEM, CFG_HW_FLASH_SEMID, 0);
+  if(stage_nb == 0)
+  {
+    stage_address = DestAddress;
+  }
+  stage_data[stage_nb] = Data;
 
-    return_value = 0;
+  /**
+   *  A chunk never spans two rows, write it once the end of the row is reached
+   *  The new data is only kept staged once written: when the write fails, it is
+   *  the last data not written and it is dropped
+   */
+  if(((DestAddress + 8) & (FD_ROW_SIZE - 1)) == 0)
+  {
+    left = WriteStaged(stage_nb + 1);
+    if(left != 0)
+    {
+      stage_nb--;
+    }
+    return left;
   }
 
-  return return_value;
+  stage_nb++;
+
+  return 0;
+}
+
+uint32_t FD_FlushData(void)
+{
+  if(stage_nb == 0)
+  {
+    return 0;
+  }
+
+  return WriteStaged(stage_nb);
+}
+
+void FD_DiscardData(void)
+{
+  stage_nb = 0;
+}
+
+void FD_GetLeaseStats(FD_LeaseStats_t * pStats)
+{
+  UTILS_ENTER_CRITICAL_SECTION();
+  *pStats = lease_stats;
+  UTILS_EXIT_CRITICAL_SECTION();
+}
+
+void FD_ResetLeaseStats(void)
+{
+  UTILS_ENTER_CRITICAL_SECTION();
+  memset(&lease_stats, 0, sizeof(lease_stats));
+  UTILS_EXIT_CRITICAL_SECTION();
 }
 
 SingleFlashOperationStatus_t FD_EraseSingleSector(uint32_t SectorNumber)
@@ -162,12 +256,169 @@ SingleFlashOperationStatus_t FD_WriteSingleData(uint32_t DestAddress, uint64_t D
  * LOCAL FUNCTIONS
  *
  *************************************************************/
+/**
+ * Take the ownership of the Flash IP and unlock the flash.
+ * The CPU2 may hold the semaphore while it uses the flash, give up after CFG_FD_SEM_TIMEOUT.
+ * Note: The timeout is based on HAL_GetTick(), this shall not be called with the interrupts disabled.
+ */
+static SemStatus_t LeaseAcquire(void)
+{
+  SemStatus_t sem_status;
+  uint32_t spin_start;
+  uint32_t spin_time;
+
+  sem_status = (SemStatus_t)LL_HSEM_1StepLock(HSEM, CFG_HW_FLASH_SEMID);
+
+  if(sem_status != SEM_LOCK_SUCCESSFUL)
+  {
+    lease_stats.ContentionNb++;
+    spin_start = HAL_GetTick();
+
+    do
+    {
+      sem_status = (SemStatus_t)LL_HSEM_1StepLock(HSEM, CFG_HW_FLASH_SEMID);
+      spin_time = HAL_GetTick() - spin_start;
+    }
+    while((sem_status != SEM_LOCK_SUCCESSFUL) && (spin_time < CFG_FD_SEM_TIMEOUT));
+
+    lease_stats.SpinTime += spin_time;
+    if(spin_time > lease_stats.SpinTimeMax)
+    {
+      lease_stats.SpinTimeMax = spin_time;
+    }
+
+    if(sem_status != SEM_LOCK_SUCCESSFUL)
+    {
+      lease_stats.TimeoutNb++;
+      return sem_status;
+    }
+  }
+
+  HAL_FLASH_Unlock();
+
+  lease_stats.LeaseNb++;
+  lease_start = HAL_GetTick();
+  lease_held = TRUE;
+
+  return SEM_LOCK_SUCCESSFUL;
+}
+
+/**
+ * Release the ownership of the Flash IP when held for more than CFG_FD_LEASE_MAX_HOLD and take it back.
+ * On a failure, the ownership is not held anymore.
+ * Note: It waits for one full tick of HAL_GetTick(), this shall not be called with the interrupts disabled.
+ */
+static SemStatus_t LeaseYield(void)
+{
+  uint32_t tick;
+
+  if((HAL_GetTick() - lease_start) < CFG_FD_LEASE_MAX_HOLD)
+  {
+    return SEM_LOCK_SUCCESSFUL;
+  }
+
+  LeaseRelease();
+  lease_stats.YieldNb++;
+
+  /**
+   *  Leave the CPU2 at least one tick to take the semaphore, it would not get it if taken back at once.
+   *  Waiting only for the next tick may leave it no time when the release happens at the end of a tick.
+   */
+  tick = HAL_GetTick();
+  while((HAL_GetTick() - tick) < 2U);
+
+  return LeaseAcquire();
+}
+
+/**
+ * Lock the flash and release the ownership of the Flash IP, does nothing when not held.
+ */
+static void LeaseRelease(void)
+{
+  uint32_t hold_time;
+
+  if(lease_held == FALSE)
+  {
+    return;
+  }
+
+  HAL_FLASH_Lock();
+
+  LL_HSEM_ReleaseLock(HSEM, CFG_HW_FLASH_SEMID, 0);
+
+  lease_held = FALSE;
+  hold_time = HAL_GetTick() - lease_start;
+  if(hold_time > lease_stats.HoldTimeMax)
+  {
+    lease_stats.HoldTimeMax = hold_time;
+  }
+}
+
+/**
+ * Write the first staged data, in one row fast programming when they fill a row.
+ * The data not written are kept staged so that the write may be tried again.
+ * Returns the number of 64bits data not written.
+ */
+static uint32_t WriteStaged(uint32_t NbrOfData)
+{
+  uint32_t left;
+  uint32_t written;
+
+#if (CFG_FD_FAST_PROGRAM != 0)
+  if(NbrOfData == FD_ROW_NB_DATA)
+  {
+    left = WriteRow(stage_address, stage_data);
+  }
+  else
+#endif
+  {
+    left = FD_WriteData(stage_address, stage_data, NbrOfData);
+  }
+
+  written = NbrOfData - left;
+  if((left != 0) && (written != 0))
+  {
+    memmove(&stage_data[0], &stage_data[written], left * sizeof(stage_data[0]));
+  }
+  stage_address += 8 * written;
+  stage_nb = left;
+
+  return left;
+}
+
+#if (CFG_FD_FAST_PROGRAM != 0)
+/**
+ * Fast program a full row, which shall be erased.
+ * The row programming stalls the CPU2 on the flash for up to 7ms like an erase: it is notified the same way.
+ * Returns the number of 64bits data not written, the whole row or none.
+ */
+static uint32_t WriteRow(uint32_t DestAddress, uint64_t * pSrcBuffer)
+{
+  SingleFlashOperationStatus_t single_flash_operation_status;
+
+  if(LeaseAcquire() != SEM_LOCK_SUCCESSFUL)
+  {
+    return FD_ROW_NB_DATA;
+  }
+
+  SHCI_C2_FLASH_EraseActivity(ERASE_ACTIVITY_ON);
+
+  single_flash_operation_status = ProcessSingleFlashOperation(FLASH_WRITE_ROW, DestAddress, (uint32_t)pSrcBuffer);
+
+  SHCI_C2_FLASH_EraseActivity(ERASE_ACTIVITY_OFF);
+
+  LeaseRelease();
+
+  return (single_flash_operation_status == SINGLE_FLASH_OPERATION_DONE) ? 0 : FD_ROW_NB_DATA;
+}
+#endif
+
 static SingleFlashOperationStatus_t ProcessSingleFlashOperation(FlashOperationType_t FlashOperationType,
                                                                 uint32_t SectorNumberOrDestAddress,
                                                                 uint64_t Data)
 {
   SemStatus_t cpu1_sem_status;
-  SemStatus_t cpu2_sem_status;
+  SemStatus_t cpu2_sem_status = SEM_LOCK_BUSY;
   WaitedSemStatus_t waited_sem_status;
   SingleFlashOperationStatus_t return_status;
 
@@ -220,8 +471,8 @@ static SingleFlashOperationStatus_t ProcessSingleFlashOperation(FlashOperationTy
       if(cpu2_sem_status == SEM_LOCK_SUCCESSFUL)
       {
         /**
-         * When CFG_HW_BLOCK_FLASH_REQ_BY_CPU2_SEMID is taken, it is allowed to only erase one sector or
-         * write one single 64bits data
+         * When CFG_HW_BLOCK_FLASH_REQ_BY_CPU2_SEMID is taken, it is allowed to only erase one sector,
+         * write one single 64bits data or fast program one row
          * When either several sectors need to be erased or several 64bits data need to be written,
          * the application shall first exit from the critical section and try again.
          */
@@ -229,6 +480,10 @@ static SingleFlashOperationStatus_t ProcessSingleFlashOperation(FlashOperationTy
         {
           HAL_FLASHEx_Erase(&p_erase_init, &page_error);
         }
+        else if(FlashOperationType == FLASH_WRITE_ROW)
+        {
+          HAL_FLASH_Program(FLASH_TYPEPROGRAM_FAST, SectorNumberOrDestAddress, Data);
+        }
         else
         {
           HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, SectorNumberOrDestAddress, Data);
@@ -209,6 +209,90 @@ void PWR_ExitSleepMode( void )
   return;
 }
 
+/**
+  * @brief Returns a free running timestamp based on the RTC, counting in low power modes
+  * @note The RTC runs without shadow registers (set by the timer server) so the time
+  *       and sub-second registers are read until stable. With CFG_RTC_SYNCH_PRESCALER
+  *       at 0x7FFF the calendar second lasts 16s and the day wraps after 16 days, which
+  *       is extended here to a 32 bits counter
+  * @param none
+  * @retval timestamp
+  */
+uint32_t PWR_GetTimestamp( void )
+{
+  static uint32_t last_time;
+  static uint32_t day_offset;
+  uint32_t tr;
+  uint32_t ssr;
+  uint32_t seconds;
+  uint32_t time;
+
+  do
+  {
+    tr = READ_REG( RTC->TR );
+    ssr = READ_BIT( RTC->SSR, RTC_SSR_SS );
+  } while( ( tr != READ_REG( RTC->TR ) ) || ( ssr != READ_BIT( RTC->SSR, RTC_SSR_SS ) ) );
+
+  seconds = ( ( ( ( tr & RTC_TR_HT ) >> RTC_TR_HT_Pos ) * 10U ) + ( ( tr & RTC_TR_HU ) >> RTC_TR_HU_Pos ) ) * 3600U;
+  seconds += ( ( ( ( tr & RTC_TR_MNT ) >> RTC_TR_MNT_Pos ) * 10U ) + ( ( tr & RTC_TR_MNU ) >> RTC_TR_MNU_Pos ) ) * 60U;
+  seconds += ( ( ( tr & RTC_TR_ST ) >> RTC_TR_ST_Pos ) * 10U ) + ( ( tr & RTC_TR_SU ) >> RTC_TR_SU_Pos );
+
+  /* The sub-second register counts down */
+  time = ( seconds * ( CFG_RTC_SYNCH_PRESCALER + 1U ) ) + ( CFG_RTC_SYNCH_PRESCALER - ssr );
+  if( time < last_time )
+  {
+    day_offset += 86400U * ( CFG_RTC_SYNCH_PRESCALER + 1U );
+  }
+  last_time = time;
+
+  return time + day_offset;
+}
+
+/**
+  * @brief Returns the time left before the next timer server expiry
+  * @note The wakeup timer counts RTCCLK / 16 (CFG_RTC_WUCKSEL_DIVIDER 0), the same clock
+  *       as the sub-second register with CFG_RTC_ASYNCH_PRESCALER 15
+  * @param none
+  * @retval time left, 0xFFFFFFFF if no timer is running
+  */
+uint32_t PWR_GetNextWakeup( void )
+{
+  uint16_t left_ticks = HW_TS_RTC_ReadLeftTicksToCount( );
+
+  /* 0xFFFF when the timer list is empty */
+  return ( left_ticks == 0xFFFFU ) ? 0xFFFFFFFFUL : (uint32_t)left_ticks;
+}
+
+/**
+  * @brief Returns the source of the wakeup from the pending interrupts
+  * @note Called in critical section when leaving the low power mode
+  * @param none
+  * @retval wakeup source
+  */
+UTIL_LPM_WakeupSource_t PWR_GetWakeupSource( void )
+{
+  UTIL_LPM_WakeupSource_t source = UTIL_LPM_WAKEUP_UNKNOWN;
+
+  if( NVIC_GetPendingIRQ( IPCC_C1_RX_IRQn ) != 0U )
+  {
+    source = UTIL_LPM_WAKEUP_IPCC;
+  }
+  else if( NVIC_GetPendingIRQ( RTC_WKUP_IRQn ) != 0U )
+  {
+    source = UTIL_LPM_WAKEUP_RTC;
+  }
+  else if( ( EXTI->PR1 & 0x0000FFFFU ) != 0U ) /* GPIO lines */
+  {
+    source = UTIL_LPM_WAKEUP_EXTI;
+  }
+  else if( ( NVIC_GetPendingIRQ( USART1_IRQn ) != 0U ) || ( NVIC_GetPendingIRQ( LPUART1_IRQn ) != 0U ) )
+  {
+    source = UTIL_LPM_WAKEUP_UART;
+  }
+
+  return source;
+}
+
 /*************************************************************
  *
  * LOCAL FUNCTIONS
@@ -32,6 +32,7 @@
 /* External variables --------------------------------------------------------*/
 extern DMA_HandleTypeDef  hdma_lpuart1_tx;
 extern DMA_HandleTypeDef  hdma_usart1_tx;
+extern DMA_HandleTypeDef  hdma_usart1_rx;
 extern UART_HandleTypeDef hlpuart1;
 extern UART_HandleTypeDef huart1;
 
@@ -160,6 +161,14 @@ void DMA1_Channel2_IRQHandler(void)
   HAL_DMA_IRQHandler(&hdma_usart1_tx);
 }
 
+/**
+  * @brief This function handles DMA1 channel3 global interrupt (USART1 Rx).
+  */
+void DMA1_Channel3_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_usart1_rx);
+}
+
 /**
   * @brief This function handles CPU2 SEV interrupt through EXTI line 40 and PWR CPU2 HOLD wake-up interrupt.
   */
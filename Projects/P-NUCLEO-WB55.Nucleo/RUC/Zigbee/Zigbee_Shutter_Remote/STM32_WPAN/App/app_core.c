@@ -24,6 +24,7 @@
 #include "app_entry.h"
 #include "shci.h"
 #include "stm32_seq.h"
+#include "stm32_lpm.h"
 #include "stm32wbxx_core_interface_def.h"
 
 #include "zigbee_types.h"
@@ -38,11 +39,17 @@
 #include "app_zigbee.h"
 #include "app_nvm.h"
 #include "app_menu.h"
+#include "app_console.h"
 #include "app_roller_shutter_remote_cfg.h"
 
 /* External variables --------------------------------------------------------*/
 extern App_Zb_Info_T app_zb_info;
 
+/* Private defines -----------------------------------------------------------*/
+/* Low power statistics conversions */
+#define LPM_TICKS_TO_MS(TICKS)           ((uint32_t)(((uint64_t)(TICKS) * 1000U) / CFG_LPM_TIMESTAMP_FREQ))
+#define LPM_PERCENT(PART, TOTAL)         ((uint32_t)(((uint64_t)(PART) * 100U) / (TOTAL)))
+
 /* Private typedef -----------------------------------------------------------*/
 typedef enum
 {
@@ -106,6 +113,12 @@ void App_Core_Init(void)
   {
     APP_ZB_DBG("Error : Menu Config");
   }
+
+  /* Commands and parameters from the trace UART */
+  if (Console_Config() == 0)
+  {
+    APP_ZB_DBG("Error : Console Config");
+  }
 } /* App_Core_Init */
 
 /**
@@ -174,6 +187,63 @@ void App_Core_Infos_Disp(void)
   Menu_Config();
 } /* App_Core_Infos_Disp */
 
+/**
+ * @brief Display the time spent in each low power mode, the users keeping the
+ * device out of the deeper modes and the wakeup sources
+ * To call from the Menu to attribute the consumption
+ * 
+ */
+void App_Core_Lpm_Disp(void)
+{
+  static const char * const mode_name[UTIL_LPM_MODE_NB]     = { "Sleep", "Stop", "Off" };
+  static const char * const wakeup_name[UTIL_LPM_WAKEUP_NB] = { "Unknown", "IPCC", "RTC", "EXTI", "UART" };
+  UTIL_LPM_Stats_t stats;
+  uint32_t total;
+  uint32_t i;
+
+  UTIL_LPM_GetStats(&stats);
+  total = stats.RunTime;
+  for (i = 0; i < UTIL_LPM_MODE_NB; i++)
+  {
+    total += stats.Residency[i];
+  }
+  if (total == 0U)
+  {
+    APP_ZB_DBG("No low power statistics");
+    return;
+  }
+
+  APP_ZB_DBG("**********************************************************");
+  APP_ZB_DBG("Low power over %d ms", LPM_TICKS_TO_MS(total));
+  APP_ZB_DBG(" Run   : %8d ms (%3d%%)", LPM_TICKS_TO_MS(stats.RunTime), LPM_PERCENT(stats.RunTime, total));
+  for (i = 0; i < UTIL_LPM_MODE_NB; i++)
+  {
+    APP_ZB_DBG(" %-5s : %8d ms (%3d%%) %d entries", mode_name[i], LPM_TICKS_TO_MS(stats.Residency[i]),
+               LPM_PERCENT(stats.Residency[i], total), stats.EntryNb[i]);
+  }
+  for (i = 0; i < UTIL_LPM_ID_NB; i++)
+  {
+    if (stats.StopBlockTime[i] != 0U)
+    {
+      APP_ZB_DBG(" Stop disallowed by LPM id %2d : %8d ms", i, LPM_TICKS_TO_MS(stats.StopBlockTime[i]));
+    }
+    if (stats.OffBlockTime[i] != 0U)
+    {
+      APP_ZB_DBG(" Off disallowed by LPM id %2d  : %8d ms", i, LPM_TICKS_TO_MS(stats.OffBlockTime[i]));
+    }
+  }
+  for (i = 0; i < UTIL_LPM_WAKEUP_NB; i++)
+  {
+    APP_ZB_DBG(" Wakeup %-7s : %d", wakeup_name[i], stats.WakeupNb[i]);
+  }
+  APP_ZB_DBG(" Sleep as next timer too close : %d", stats.PredictSleepNb);
+  APP_ZB_DBG(" Stop as next timer too close  : %d", stats.PredictStopNb);
+  APP_ZB_DBG(" Sleep forced while Stop worth : %d", stats.LongSleepNb);
+  APP_ZB_DBG(" Stop exit average : %d us",
+             (uint32_t)(((uint64_t)stats.StopExitAvg * 1000000U) / (CFG_LPM_TIMESTAMP_FREQ << UTIL_LPM_AVG_SHIFT)));
+  APP_ZB_DBG("**********************************************************");
+} /* App_Core_Lpm_Disp */
+
 /**
  * @brief Toggle blue LED to visualize a task ongoing or other...
  * 
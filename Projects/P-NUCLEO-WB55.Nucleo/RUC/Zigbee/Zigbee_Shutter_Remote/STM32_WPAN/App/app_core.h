@@ -54,6 +54,7 @@ void App_Core_Restore_State  (void);
 
 /* Action from menu */
 void App_Core_Infos_Disp     (void);
+void App_Core_Lpm_Disp       (void);
 void App_Core_Ntw_Join       (void);
 void App_Core_Factory_Reset  (void);
 
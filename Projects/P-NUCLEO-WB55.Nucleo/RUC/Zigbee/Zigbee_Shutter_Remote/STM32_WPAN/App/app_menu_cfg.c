@@ -18,6 +18,8 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "app_menu.h"
+#include "app_console.h"
+#include "stm32_seq.h"
 
 #include "app_zigbee.h"
 #include "app_core.h"
@@ -26,11 +28,64 @@
 /* External variables ------------------------------------------------------- */
 extern uint8_t          display_type;
 
+/* Private functions prototypes-----------------------------------------------*/
+/* Console app Config */
+static void console_sw1(void);
+static void console_sw2(void);
+static void console_sw3(void);
+
+/* Menu tables, kept in flash --------------------------------------------- */
+// Network Menu
+static const Menu_Item_T menu_ntw[] =
+{
+  //         |  Menu name     | Action to launch                     |
+  MENU_ACTION("Join Network" , &App_Core_Ntw_Join                   ),
+  MENU_ACTION("Find & Bind"  , &App_Roller_Shutter_Remote_FindBind  ),
+  MENU_ACTION("Bind Table"   , &App_Roller_Shutter_Remote_Bind_Disp ),
+  MENU_ACTION("Tx Power Disp", &App_Zigbee_TxPwr_Disp               ),
+  MENU_ACTION("Tx Power +"   , &App_Zigbee_TxPwr_Up                 ),
+  MENU_ACTION("Tx Power -"   , &App_Zigbee_TxPwr_Down               ),
+};
+
+// Window Menu
+static const Menu_Item_T menu_shutter[] =
+{
+  MENU_ACTION("Shutter up"   , &App_Roller_Shutter_Remote_Move_Up   ),
+  MENU_ACTION("Shutter stop" , &App_Roller_Shutter_Remote_Move_Stop ),
+  MENU_ACTION("Shutter down" , &App_Roller_Shutter_Remote_Move_Down ),
+  MENU_ACTION("Attr Cache"   , &App_Roller_Shutter_Remote_Attr_Cache_Disp),
+};
+
+// Main menu
+static const Menu_Item_T menu_main[] =
+{
+  //         |  Menu name     | Sub-Menu or Action to launch |
+  MENU_SUB   ("Network"      , menu_ntw                    ),
+  MENU_SUB   ("Window"       , menu_shutter                ),
+  MENU_ACTION("Factory Reset", &App_Core_Factory_Reset     ),
+  MENU_ACTION("Global Infos" , &App_Core_Infos_Disp        ),
+  MENU_ACTION("Low Power"    , &App_Core_Lpm_Disp          ),
+};
+
+/* Console tables, kept in flash ------------------------------------------ */
+// Commands, the buttons and the menu keys
+static const Console_Cmd_T console_cmd[] =
+{
+  //         |  Command | Action to launch   |
+  CONSOLE_CMD("SW1"     , &console_sw1       ),
+  CONSOLE_CMD("SW2"     , &console_sw2       ),
+  CONSOLE_CMD("SW3"     , &console_sw3       ),
+  CONSOLE_CMD("next"    , &Next_Menu_Item    ),
+  CONSOLE_CMD("prev"    , &Prev_Menu_Item    ),
+  CONSOLE_CMD("select"  , &Select_Menu_Item  ),
+  CONSOLE_CMD("exit"    , &Exit_Menu_Item    ),
+};
+
 /* Functions Definition ----------------------------------------------------- */
 
 /**
  * @brief  Configure the Menu tree
- * @param  display_select to choose where the Menu appears
+ * @param  None
  * @retval state
  */
 bool Menu_Config(void)
@@ -38,46 +93,33 @@ bool Menu_Config(void)
   /* Choose where to display the menu */
   display_type = UART_DISPLAY;
 
-  /* Menu item instances -----------------------------------------------------*/
-  // 1st level of menu
-  Menu_Item_T * menu_reset= Create_Menu_Item();
-  Menu_Item_T * menu_info = Create_Menu_Item();
-
-  // Network Menu
-  Menu_Item_T * menu_ntw             = Create_Menu_Item();
-  Menu_Item_T * menu_ntw_join        = Create_Menu_Item();
-  Menu_Item_T * menu_ntw_findbind    = Create_Menu_Item();
-  Menu_Item_T * menu_ntw_bind_tab    = Create_Menu_Item();
-  Menu_Item_T * menu_ntw_txpwr_disp  = Create_Menu_Item();
-  Menu_Item_T * menu_ntw_txpwr_up    = Create_Menu_Item();
-  Menu_Item_T * menu_ntw_txpwr_down  = Create_Menu_Item();
-  
-  // Roller Shutter Menu
-  Menu_Item_T * menu_shutter         = Create_Menu_Item();  
-  Menu_Item_T * menu_shutter_up      = Create_Menu_Item();  
-  Menu_Item_T * menu_shutter_stop    = Create_Menu_Item();  
-  Menu_Item_T * menu_shutter_down    = Create_Menu_Item();  
-  
-  /* Menu link ---------------------------------------------------------------*/
-  // Main menu --------|  Menu name     | Current Item       | Next Item          | Sub-Menu         | Action to launch        |
-  Add_Menu_Item((char *) "Network"      , menu_ntw           , menu_shutter       , menu_ntw_join    , NULL                    );
-  Add_Menu_Item((char *) "Window"       , menu_shutter       , menu_reset         , menu_shutter_up  , NULL                    );
-  Add_Menu_Item((char *) "Factory Reset", menu_reset         , menu_info          , NULL             , &App_Core_Factory_Reset );
-  Add_Menu_Item((char *) "Global Infos" , menu_info          , menu_ntw           , NULL             , &App_Core_Infos_Disp    );
-
-  // Network Menu, 
-  Add_Menu_Item((char *) "Join Network" , menu_ntw_join      , menu_ntw_findbind  , NULL             , &App_Core_Ntw_Join      );
-  Add_Menu_Item((char *) "Find & Bind"  , menu_ntw_findbind  , menu_ntw_bind_tab  , NULL             , &App_Roller_Shutter_Remote_FindBind);
-  Add_Menu_Item((char *) "Bind Table"   , menu_ntw_bind_tab  , menu_ntw_txpwr_disp, NULL             , &App_Roller_Shutter_Remote_Bind_Disp);
-  Add_Menu_Item((char *) "Tx Power Disp", menu_ntw_txpwr_disp, menu_ntw_txpwr_up  , NULL             , &App_Zigbee_TxPwr_Disp  );
-  Add_Menu_Item((char *) "Tx Power +"   , menu_ntw_txpwr_up  , menu_ntw_txpwr_down, NULL             , &App_Zigbee_TxPwr_Up    );
-  Add_Menu_Item((char *) "Tx Power -"   , menu_ntw_txpwr_down, menu_ntw_join      , NULL             , &App_Zigbee_TxPwr_Down  );
-
-  // Window Menu, 
-  Add_Menu_Item((char *) "Shutter up"   , menu_shutter_up   , menu_shutter_stop   , NULL             , &App_Roller_Shutter_Remote_Move_Up  );
-  Add_Menu_Item((char *) "Shutter stop" , menu_shutter_stop , menu_shutter_down   , NULL             , &App_Roller_Shutter_Remote_Move_Stop);
-  Add_Menu_Item((char *) "Shutter down" , menu_shutter_down , menu_shutter_up     , NULL             , &App_Roller_Shutter_Remote_Move_Down);
-
-  return Def_Start_Menu_Item(menu_ntw);
+  return Def_Start_Menu_Item(menu_main, MENU_NB(menu_main));
 } /* Menu_config */
 
+/**
+ * @brief  Configure the commands of the console, no parameter to set
+ * @param  None
+ * @retval state
+ */
+bool Console_Config(void)
+{
+  return Console_Init(console_cmd, CONSOLE_NB(console_cmd), NULL, 0U);
+} /* Console_Config */
+
+/* User console config function ------------------------------------------------*/
+/* Same as a press on the button */
+static void console_sw1(void)
+{
+  UTIL_SEQ_SetTask(1U << CFG_TASK_BUTTON_SW1, CFG_SCH_PRIO_1);
+}
+
+static void console_sw2(void)
+{
+  UTIL_SEQ_SetTask(1U << CFG_TASK_BUTTON_SW2, CFG_SCH_PRIO_1);
+}
+
+static void console_sw3(void)
+{
+  UTIL_SEQ_SetTask(1U << CFG_TASK_BUTTON_SW3, CFG_SCH_PRIO_1);
+}
+
@@ -43,6 +43,9 @@ static void App_Roller_Shutter_Remote_Task_Retry_Cmd(void);
 /* App Window Covering functions ---------------------------------------------*/
 static void App_Roller_Shutter_Remote_Status_Led (void);
 
+/* Attribute cache functions -------------------------------------------------*/
+static void App_Roller_Shutter_Remote_Refresh_Stale(void);
+
 
 // Clusters CFG ----------------------------------------------------------------
 /**
@@ -83,6 +86,9 @@ void App_Roller_Shutter_Remote_ConfigEndpoint(struct ZigBeeT *zb)
   /* Command status on LEDs */
   UTIL_SEQ_RegTask(1U << CFG_TASK_LED_BLINK, UTIL_SEQ_RFU, App_Roller_Shutter_Remote_Status_Led);
   HW_TS_Create(CFG_TIM_LED_BLINK, &TS_ID_LED_BLINK, hw_ts_Repeated, App_Roller_Shutter_Remote_Status_Led);
+
+  /* Attribute cache, the stale entries are refreshed on user actions */
+  App_Roller_Shutter_Remote_Attr_Cache_Init();
 } /* App_Roller_Shutter_Remote_ConfigEndpoint */
 
 /**
@@ -410,6 +416,7 @@ void App_Roller_Shutter_Remote_Move_Up  (void)
     App_Roller_Shutter_Remote_Window_Covering_Set_Cmd(ZCL_WNCV_COMMAND_UP);
     App_Roller_Shutter_Remote_Window_Covering_Cmd(NULL);  
   }
+  App_Roller_Shutter_Remote_Refresh_Stale();
 } /* App_Roller_Shutter_Remote_Move_Up */
 
 void App_Roller_Shutter_Remote_Move_Down(void)
@@ -420,12 +427,14 @@ void App_Roller_Shutter_Remote_Move_Down(void)
     App_Roller_Shutter_Remote_Window_Covering_Set_Cmd(ZCL_WNCV_COMMAND_DOWN);
     App_Roller_Shutter_Remote_Window_Covering_Cmd(NULL);  
   }
+  App_Roller_Shutter_Remote_Refresh_Stale();
 } /* App_Roller_Shutter_Remote_move_Down */
 
 void App_Roller_Shutter_Remote_Move_Stop(void)
 {
   App_Roller_Shutter_Remote_Window_Covering_Set_Cmd(ZCL_WNCV_COMMAND_STOP);
   App_Roller_Shutter_Remote_Window_Covering_Cmd(NULL);  
+  App_Roller_Shutter_Remote_Refresh_Stale();
 } /* App_Roller_Shutter_Remote_Move_Stop */
 
 
@@ -465,6 +474,18 @@ static void App_Roller_Shutter_Remote_Status_Led(void)
   }
 }; /* App_Roller_Shutter_Remote_Status_Led */
 
+/**
+ * @brief Refresh the stale cached positions of the bound servers.
+ *        Called on user actions only, the remote is not woken up to poll.
+ * 
+ */
+static void App_Roller_Shutter_Remote_Refresh_Stale(void)
+{
+  Window_Cov_Control_T * window_ctrl = app_Shutter_Remote_Control.app_Window_Covering_Control;
+
+  App_Roller_Shutter_Remote_Attr_Cache_Refresh(window_ctrl->bind_table, window_ctrl->bind_nb);
+} /* App_Roller_Shutter_Remote_Refresh_Stale */
+
 /**
  * @brief Launch the status led in parallel task
  * 
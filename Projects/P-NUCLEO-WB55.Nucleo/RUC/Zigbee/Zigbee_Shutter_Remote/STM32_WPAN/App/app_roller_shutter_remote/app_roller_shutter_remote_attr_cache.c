@@ -0,0 +1,322 @@
+/**
+  ******************************************************************************
+  * @file    app_roller_shutter_remote_attr_cache.c
+  * @author  Zigbee Application Team
+  * @brief   Attribute cache of the servers bound to the Roller Shutter Remote.
+  *          Keep the last known Window Covering position of each server to
+  *          only trigger the UI work on real state transitions.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_roller_shutter_remote_cfg.h"
+
+/* Private Define-------------------------------------------------------------*/
+/* RTC calendar clocks, set by CFG_RTC_ASYNCH_PRESCALER and CFG_RTC_SYNCH_PRESCALER.
+ * Without the 1Hz calendar, a calendar second lasts ATTR_CACHE_SPRE_PERIOD (16 s)
+ * and the sub seconds count the ck_apre clock (2048 Hz). */
+#define ATTR_CACHE_APRE_FREQ                  (LSE_VALUE / (CFG_RTC_ASYNCH_PRESCALER + 1U))
+#define ATTR_CACHE_SPRE_PERIOD                ((CFG_RTC_SYNCH_PRESCALER + 1U) / ATTR_CACHE_APRE_FREQ)
+/* The week day cycles every 7 calendar days: wrap of the cache time (in s, 112 days) */
+#define ATTR_CACHE_TIME_WRAP                  (7U * 24U * 60U * 60U * ATTR_CACHE_SPRE_PERIOD)
+
+/* Private Variables----------------------------------------------------------*/
+extern RTC_HandleTypeDef hrtc;
+
+static Attr_Cache_Entry_T attr_cache_tab[ATTR_CACHE_NB_ENTRIES];
+static Attr_Cache_Stats_T attr_cache_stats;
+
+/* Private functions prototypes-----------------------------------------------*/
+static Attr_Cache_Entry_T * Attr_Cache_Find (uint64_t ext_addr, uint8_t endpoint);
+static Attr_Cache_Entry_T * Attr_Cache_Alloc(uint64_t ext_addr, uint8_t endpoint);
+static uint32_t             Attr_Cache_Age  (uint32_t now, uint32_t time);
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+ * @brief  Clear all the cache entries and statistics
+ * @param  None
+ * @retval None
+ */
+void App_Roller_Shutter_Remote_Attr_Cache_Init(void)
+{
+  memset(attr_cache_tab, 0, sizeof(attr_cache_tab));
+  memset(&attr_cache_stats, 0, sizeof(attr_cache_stats));
+} /* App_Roller_Shutter_Remote_Attr_Cache_Init */
+
+/**
+ * @brief  Time base of the cache, read from the RTC calendar.
+ *         Unlike HAL_GetTick(), the RTC keeps counting while the remote is in Stop mode.
+ * @param  None
+ * @retval current time (s), wraps at ATTR_CACHE_TIME_WRAP
+ */
+uint32_t App_Roller_Shutter_Remote_Attr_Cache_Get_Time(void)
+{
+  RTC_TimeTypeDef rtc_time;
+  RTC_DateTypeDef rtc_date;
+  uint32_t        spre_nb;
+
+  /* The date is read after the time to unlock the calendar shadow registers */
+  HAL_RTC_GetTime(&hrtc, &rtc_time, RTC_FORMAT_BIN);
+  HAL_RTC_GetDate(&hrtc, &rtc_date, RTC_FORMAT_BIN);
+
+  spre_nb = ((((rtc_date.WeekDay - 1U) * 24U + rtc_time.Hours) * 60U + rtc_time.Minutes) * 60U) + rtc_time.Seconds;
+
+  /* The sub seconds count down from SecondFraction */
+  return (spre_nb * ATTR_CACHE_SPRE_PERIOD) + ((rtc_time.SecondFraction - rtc_time.SubSeconds) / ATTR_CACHE_APRE_FREQ);
+} /* App_Roller_Shutter_Remote_Attr_Cache_Get_Time */
+
+/**
+ * @brief  Retrieve the cache entry of a server
+ * @param  ext_addr server extended address
+ * @param  endpoint server endpoint
+ * @retval entry, NULL if the server is not cached
+ */
+Attr_Cache_Entry_T * App_Roller_Shutter_Remote_Attr_Cache_Get(uint64_t ext_addr, uint8_t endpoint)
+{
+  return Attr_Cache_Find(ext_addr, endpoint);
+} /* App_Roller_Shutter_Remote_Attr_Cache_Get */
+
+/**
+ * @brief  Store a new position received from a server and detect the change
+ * @param  ext_addr  server extended address
+ * @param  endpoint  server endpoint
+ * @param  position  value of ZCL_WNCV_SVR_ATTR_CURR_POS_LIFT_PERCENT received
+ * @param  is_report true for an attribute report, false for a read response
+ * @param  now       current time (s), from App_Roller_Shutter_Remote_Attr_Cache_Get_Time
+ * @retval true if the cached value changed (or cannot be cached), false otherwise
+ */
+bool App_Roller_Shutter_Remote_Attr_Cache_Update(uint64_t ext_addr, uint8_t endpoint, uint8_t position,
+                                                 bool is_report, uint32_t now)
+{
+  Attr_Cache_Entry_T * entry = Attr_Cache_Alloc(ext_addr, endpoint);
+  bool is_changed = true;
+
+  if (is_report)
+  {
+    attr_cache_stats.report_rx++;
+  }
+  else
+  {
+    attr_cache_stats.read_rx++;
+  }
+
+  if (entry != NULL)
+  {
+    is_changed = ((entry->is_valid == false) || (entry->position != position));
+    entry->position  = position;
+    entry->is_valid  = true;
+    entry->is_polled = false;
+    entry->last_seen = now;
+  }
+
+  if (is_report && is_changed)
+  {
+    attr_cache_stats.report_work++;
+  }
+
+  return is_changed;
+} /* App_Roller_Shutter_Remote_Attr_Cache_Update */
+
+/**
+ * @brief  Update the report configuration status of a server
+ * @param  ext_addr   server extended address
+ * @param  endpoint   server endpoint
+ * @param  cfg_status new report configuration status
+ * @retval None
+ */
+void App_Roller_Shutter_Remote_Attr_Cache_Set_Cfg_Status(uint64_t ext_addr, uint8_t endpoint,
+                                                        Attr_Cache_Cfg_Status_T cfg_status)
+{
+  Attr_Cache_Entry_T * entry = Attr_Cache_Alloc(ext_addr, endpoint);
+
+  if (entry != NULL)
+  {
+    entry->cfg_status = cfg_status;
+  }
+} /* App_Roller_Shutter_Remote_Attr_Cache_Set_Cfg_Status */
+
+/**
+ * @brief  Check if the cached value of a server must be refreshed
+ * @param  ext_addr server extended address
+ * @param  endpoint server endpoint
+ * @param  now      current time (s), from App_Roller_Shutter_Remote_Attr_Cache_Get_Time
+ * @retval true if never received or older than ATTR_CACHE_STALE_DELAY
+ */
+bool App_Roller_Shutter_Remote_Attr_Cache_Is_Stale(uint64_t ext_addr, uint8_t endpoint, uint32_t now)
+{
+  Attr_Cache_Entry_T * entry = Attr_Cache_Find(ext_addr, endpoint);
+
+  if ((entry == NULL) || (entry->is_valid == false))
+  {
+    return true;
+  }
+
+  return (Attr_Cache_Age(now, entry->last_seen) > ATTR_CACHE_STALE_DELAY);
+} /* App_Roller_Shutter_Remote_Attr_Cache_Is_Stale */
+
+/**
+ * @brief  Refresh the servers whose cached position is stale, called when the
+ *         cache is needed (user action) instead of a periodic poll waking the remote.
+ *         Configure again the report if it never succeeded, otherwise read the attribute.
+ * @param  bind_table servers bound to the remote
+ * @param  bind_nb    number of servers in bind_table
+ * @retval None
+ */
+void App_Roller_Shutter_Remote_Attr_Cache_Refresh(struct ZbApsAddrT * bind_table, uint8_t bind_nb)
+{
+  Attr_Cache_Entry_T * entry;
+  uint32_t             now = App_Roller_Shutter_Remote_Attr_Cache_Get_Time();
+
+  for (uint8_t i = 0; i < bind_nb; i++)
+  {
+    if (App_Roller_Shutter_Remote_Attr_Cache_Is_Stale(bind_table[i].extAddr, bind_table[i].endpoint, now) == false)
+    {
+      continue;
+    }
+
+    entry = Attr_Cache_Alloc(bind_table[i].extAddr, bind_table[i].endpoint);
+    if (entry == NULL)
+    {
+      continue;
+    }
+
+    /* Do not flood a server which has not answered the previous request yet */
+    if ((entry->is_polled) && (Attr_Cache_Age(now, entry->last_poll) < ATTR_CACHE_POLL_HOLDOFF))
+    {
+      continue;
+    }
+    entry->is_polled = true;
+    entry->last_poll = now;
+    attr_cache_stats.poll_nb++;
+
+    if (entry->cfg_status == ATTR_CACHE_CFG_FAILED)
+    {
+      App_Roller_Shutter_Remote_Window_Covering_ReportConfig(&bind_table[i]);
+    }
+    else
+    {
+      App_Roller_Shutter_Remote_Window_Covering_Read_Attribute(&bind_table[i]);
+    }
+  }
+} /* App_Roller_Shutter_Remote_Attr_Cache_Refresh */
+
+/**
+ * @brief  Get the cache statistics
+ * @param  None
+ * @retval statistics
+ */
+const Attr_Cache_Stats_T * App_Roller_Shutter_Remote_Attr_Cache_Get_Stats(void)
+{
+  return &attr_cache_stats;
+} /* App_Roller_Shutter_Remote_Attr_Cache_Get_Stats */
+
+/**
+ * @brief  For debug purpose, display the cache content and statistics
+ * @param  None
+ * @retval None
+ */
+void App_Roller_Shutter_Remote_Attr_Cache_Disp(void)
+{
+  uint32_t now = App_Roller_Shutter_Remote_Attr_Cache_Get_Time();
+
+  APP_ZB_DBG(" --------------------------------------------------");
+  APP_ZB_DBG(" Item |   Long Address   | Ep | Pos | Cfg | Age (s)");
+  APP_ZB_DBG(" -----|------------------|----|-----|-----|--------");
+  for (uint8_t i = 0; i < ATTR_CACHE_NB_ENTRIES; i++)
+  {
+    if (attr_cache_tab[i].ext_addr == 0ULL)
+    {
+      continue;
+    }
+    if (attr_cache_tab[i].is_valid)
+    {
+      APP_ZB_DBG("  %2d  | %016llx | %2d | %3d |  %d  | %6d", i, attr_cache_tab[i].ext_addr,
+                 attr_cache_tab[i].endpoint, attr_cache_tab[i].position, attr_cache_tab[i].cfg_status,
+                 Attr_Cache_Age(now, attr_cache_tab[i].last_seen));
+    }
+    else
+    {
+      APP_ZB_DBG("  %2d  | %016llx | %2d |  -  |  %d  |    -", i, attr_cache_tab[i].ext_addr,
+                 attr_cache_tab[i].endpoint, attr_cache_tab[i].cfg_status);
+    }
+  }
+  APP_ZB_DBG(" --------------------------------------------------");
+  APP_ZB_DBG("Reports received : %d | with change : %d", attr_cache_stats.report_rx, attr_cache_stats.report_work);
+  APP_ZB_DBG("Reads received   : %d | stale refreshes : %d\n\r", attr_cache_stats.read_rx, attr_cache_stats.poll_nb);
+} /* App_Roller_Shutter_Remote_Attr_Cache_Disp */
+
+/* Private Functions Definition ----------------------------------------------*/
+/**
+ * @brief  Search the entry of a server in the cache
+ * @param  ext_addr server extended address
+ * @param  endpoint server endpoint
+ * @retval entry, NULL if not found
+ */
+static Attr_Cache_Entry_T * Attr_Cache_Find(uint64_t ext_addr, uint8_t endpoint)
+{
+  for (uint8_t i = 0; i < ATTR_CACHE_NB_ENTRIES; i++)
+  {
+    if ((attr_cache_tab[i].ext_addr == ext_addr) && (attr_cache_tab[i].endpoint == endpoint))
+    {
+      return &attr_cache_tab[i];
+    }
+  }
+  return NULL;
+} /* Attr_Cache_Find */
+
+/**
+ * @brief  Search the entry of a server in the cache, create it if needed
+ * @param  ext_addr server extended address
+ * @param  endpoint server endpoint
+ * @retval entry, NULL if the cache is full
+ */
+static Attr_Cache_Entry_T * Attr_Cache_Alloc(uint64_t ext_addr, uint8_t endpoint)
+{
+  Attr_Cache_Entry_T * entry;
+
+  if (ext_addr == 0ULL)
+  {
+    return NULL;
+  }
+
+  entry = Attr_Cache_Find(ext_addr, endpoint);
+  if (entry != NULL)
+  {
+    return entry;
+  }
+
+  for (uint8_t i = 0; i < ATTR_CACHE_NB_ENTRIES; i++)
+  {
+    if (attr_cache_tab[i].ext_addr == 0ULL)
+    {
+      memset(&attr_cache_tab[i], 0, sizeof(Attr_Cache_Entry_T));
+      attr_cache_tab[i].ext_addr = ext_addr;
+      attr_cache_tab[i].endpoint = endpoint;
+      return &attr_cache_tab[i];
+    }
+  }
+
+  APP_ZB_DBG("Attribute cache full, 0x%016llx not cached", ext_addr);
+  return NULL;
+} /* Attr_Cache_Alloc */
+
+/**
+ * @brief  Time elapsed since a cache time, over the RTC week day wrap around
+ * @param  now  current time (s)
+ * @param  time past time (s)
+ * @retval elapsed time (s)
+ */
+static uint32_t Attr_Cache_Age(uint32_t now, uint32_t time)
+{
+  return (now >= time) ? (now - time) : (now + ATTR_CACHE_TIME_WRAP - time);
+} /* Attr_Cache_Age */
@@ -0,0 +1,86 @@
+/**
+  ******************************************************************************
+  * @file    app_roller_shutter_remote_attr_cache.h
+  * @author  Zigbee Application Team
+  * @brief   Header for the attribute cache of the Roller Shutter Remote EndPoint.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef APP_ROLLER_SHUTTER_REMOTE_ATTR_CACHE_H
+#define APP_ROLLER_SHUTTER_REMOTE_ATTR_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines ----------------------------------------------------------------- */
+/* Number of servers followed by the cache, one per bindable server */
+#define ATTR_CACHE_NB_ENTRIES                 NB_OF_SERV_BINDABLE
+
+/* A cached value older than this is re-read from the server (in s) */
+#define ATTR_CACHE_STALE_DELAY                (5U * 60U)
+/* Minimum delay between two refresh requests of a server still not answered (in s) */
+#define ATTR_CACHE_POLL_HOLDOFF               30U
+
+/* Typedef ----------------------------------------------------------------- */
+typedef enum
+{
+  ATTR_CACHE_CFG_NONE,     /* Report configuration never requested */
+  ATTR_CACHE_CFG_PENDING,  /* Report configuration request sent */
+  ATTR_CACHE_CFG_DONE,     /* Report configuration acknowledged by the server */
+  ATTR_CACHE_CFG_FAILED,   /* Report configuration failed after all retries */
+} Attr_Cache_Cfg_Status_T;
+
+typedef struct
+{
+  uint64_t ext_addr;                   /* Server identification */
+  uint8_t  endpoint;
+  bool     is_valid;                   /* position received at least once */
+  uint8_t  position;                   /* Last ZCL_WNCV_SVR_ATTR_CURR_POS_LIFT_PERCENT value */
+  Attr_Cache_Cfg_Status_T cfg_status;  /* Report configuration status */
+  bool     is_polled;                  /* Refresh request sent, no answer yet */
+  uint32_t last_seen;                  /* Time (s) of the last report or read */
+  uint32_t last_poll;                  /* Time (s) of the last refresh request */
+} Attr_Cache_Entry_T;
+
+typedef struct
+{
+  uint32_t report_rx;    /* Reports received for the cached attribute */
+  uint32_t report_work;  /* Reports which changed the cached value */
+  uint32_t read_rx;      /* Read responses received for the cached attribute */
+  uint32_t poll_nb;      /* Refresh requests sent because of a stale entry */
+} Attr_Cache_Stats_T;
+
+/* Exported Prototypes -------------------------------------------------------*/
+void                 App_Roller_Shutter_Remote_Attr_Cache_Init  (void);
+uint32_t             App_Roller_Shutter_Remote_Attr_Cache_Get_Time(void);
+Attr_Cache_Entry_T * App_Roller_Shutter_Remote_Attr_Cache_Get   (uint64_t ext_addr, uint8_t endpoint);
+bool                 App_Roller_Shutter_Remote_Attr_Cache_Update(uint64_t ext_addr, uint8_t endpoint, uint8_t position,
+                                                                 bool is_report, uint32_t now);
+void                 App_Roller_Shutter_Remote_Attr_Cache_Set_Cfg_Status(uint64_t ext_addr, uint8_t endpoint,
+                                                                         Attr_Cache_Cfg_Status_T cfg_status);
+bool                 App_Roller_Shutter_Remote_Attr_Cache_Is_Stale(uint64_t ext_addr, uint8_t endpoint, uint32_t now);
+void                 App_Roller_Shutter_Remote_Attr_Cache_Refresh(struct ZbApsAddrT * bind_table, uint8_t bind_nb);
+const Attr_Cache_Stats_T * App_Roller_Shutter_Remote_Attr_Cache_Get_Stats(void);
+void                 App_Roller_Shutter_Remote_Attr_Cache_Disp  (void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* APP_ROLLER_SHUTTER_REMOTE_ATTR_CACHE_H */
@@ -42,6 +42,7 @@ extern "C" {
 /* EndPoint dependencies */
 #include "app_roller_shutter_remote.h"
 #include "app_roller_shutter_remote_window_covering.h"
+#include "app_roller_shutter_remote_attr_cache.h"
 
 /* Typedef ------------------------------------------------------------------*/
 typedef struct
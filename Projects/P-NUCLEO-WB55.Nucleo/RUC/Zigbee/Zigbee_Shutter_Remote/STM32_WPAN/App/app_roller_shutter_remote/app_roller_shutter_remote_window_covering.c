@@ -129,6 +129,8 @@ void App_Roller_Shutter_Remote_Window_Covering_ReportConfig(struct ZbApsAddrT *
   reportCfg.record_list[0].attr_id   = ZCL_WNCV_SVR_ATTR_CURR_POS_LIFT_PERCENT;
   reportCfg.record_list[0].attr_type = ZCL_DATATYPE_UNSIGNED_8BIT;
   
+  App_Roller_Shutter_Remote_Attr_Cache_Set_Cfg_Status(dst->extAddr, dst->endpoint, ATTR_CACHE_CFG_PENDING);
+
   APP_ZB_DBG("Send Window Covering Report Config");
   status = ZbZclAttrReportConfigReq(app_Window_Covering_Control.window_covering_client, &reportCfg, &App_Roller_Shutter_Remote_Window_Covering_ReportConfig_cb, NULL);
   if ( status != ZCL_STATUS_SUCCESS )
@@ -169,11 +171,13 @@ static void App_Roller_Shutter_Remote_Window_Covering_ReportConfig_cb(struct ZbZ
     {
       /* Max retry reached */
       APP_ZB_DBG("Exceed max retry for ReportConfig cmd to 0x%016llx", cmd_rsp->src.extAddr);
+      App_Roller_Shutter_Remote_Attr_Cache_Set_Cfg_Status(cmd_rsp->src.extAddr, cmd_rsp->src.endpoint, ATTR_CACHE_CFG_FAILED);
     }
   }
   else
   {
     APP_ZB_DBG("Report Window Covering Config set with success");
+    App_Roller_Shutter_Remote_Attr_Cache_Set_Cfg_Status(cmd_rsp->src.extAddr, cmd_rsp->src.endpoint, ATTR_CACHE_CFG_DONE);
     App_Roller_Shutter_Remote_Window_Covering_Read_Attribute( &(cmd_rsp->src) );
   }
   
@@ -182,7 +186,8 @@ static void App_Roller_Shutter_Remote_Window_Covering_ReportConfig_cb(struct ZbZ
 } /* App_Roller_Shutter_Remote_Window_Covering_ReportConfig_cb */
 
 /**
- * @brief  Report the modification of ZCL_WNCV_SVR_ATTR_CURR_POS_LIFT_PERCENT and update locally the state
+ * @brief  Report the modification of ZCL_WNCV_SVR_ATTR_CURR_POS_LIFT_PERCENT and update locally the state.
+ *         The LEDs are only updated when the cached value of the server changed.
  * @param  clusterPtr
  * @retval None
  */
@@ -216,6 +221,14 @@ static void App_Roller_Shutter_Remote_Window_Covering_Client_Report(struct ZbZcl
     }
 
     state = (uint8_t) in_payload[0];
+
+    /* Same value as the last one received from this server, nothing to do */
+    if (App_Roller_Shutter_Remote_Attr_Cache_Update(dataIndPtr->src.extAddr, dataIndPtr->src.endpoint,
+                                                    state, true, App_Roller_Shutter_Remote_Attr_Cache_Get_Time()) == false)
+    {
+      return;
+    }
+
     App_Roller_Shutter_Remote_Window_Covering_Set_state(state);
     switch (state)
     {
@@ -307,12 +320,23 @@ static void App_Roller_Shutter_Remote_Window_Covering_Read_cb(const ZbZclReadRsp
     }
     else
     {
-      /* Max retry reached */
+      /* Max retry reached: give up, the cache keeps its last good value */
       APP_ZB_DBG("Exceed max retry for Read cmd to 0x%016llx", cmd_rsp->src.extAddr);
+      (*retry) = 0;
+      return;
     }    
   }
+
+  /* Only a successfully read attribute updates the cache */
+  if (cmd_rsp->attr[0].status != ZCL_STATUS_SUCCESS)
+  {
+    APP_ZB_DBG("Error, Read attribute failed | status : 0x%x", cmd_rsp->attr[0].status);
+    (*retry) = 0;
+    return;
+  }
   
   state = *(cmd_rsp->attr[0].value);
+  App_Roller_Shutter_Remote_Attr_Cache_Update(cmd_rsp->src.extAddr, cmd_rsp->src.endpoint, state, false, App_Roller_Shutter_Remote_Attr_Cache_Get_Time());
   App_Roller_Shutter_Remote_Window_Covering_Set_state(state);
   APP_ZB_DBG("Read attribute From %016llx  -  %s", cmd_rsp->src.extAddr, Get_state_char());
 
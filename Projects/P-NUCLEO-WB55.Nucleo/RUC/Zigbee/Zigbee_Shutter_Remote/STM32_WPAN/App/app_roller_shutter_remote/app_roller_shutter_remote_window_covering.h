@@ -25,8 +25,8 @@ extern "C" {
 #endif
 
 /* Defines ----------------------------------------------------------------- */
-#define ROLLER_SHUTTER_REMOTE_WINDOW_COVERING_MIN_REPORT            0x0000
-#define ROLLER_SHUTTER_REMOTE_WINDOW_COVERING_MAX_REPORT            0x0000
+#define ROLLER_SHUTTER_REMOTE_WINDOW_COVERING_MIN_REPORT            0x0001
+#define ROLLER_SHUTTER_REMOTE_WINDOW_COVERING_MAX_REPORT            0x00F0 /* Below ATTR_CACHE_STALE_DELAY */
 #define ROLLER_SHUTTER_REMOTE_WINDOW_COVERING_REPORT_CHANGE         0x0001
 
 // TODO use alarm cluster instead of command not use in window cov cluster
@@ -0,0 +1,82 @@
+/**
+  ******************************************************************************
+  * @file    app_bench.h
+  * @author  Zigbee Application Team
+  * @brief   Header for the cycle measurement of the critical application paths
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef APP_BENCH_H
+#define APP_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "app_conf.h"
+
+/* Defines ------------------------------------------------------------------ */
+/* Two buckets per power of two, from 0 cycle up to 2^32 cycles */
+#define BENCH_HIST_NB                64U
+
+/* Exported Types ------------------------------------------------------------ */
+/* Measured paths, a path shall not be measured from the thread and an interrupt at
+ * the same time: the sample of the interrupted measure is then dropped. */
+typedef enum
+{
+  BENCH_MOTOR_CMD,            /* Up/Down command received up to the motor PWM started */
+  BENCH_NVM_INIT,             /* App_NVM_Init, EEPROM emulation recovery after a reset */
+  BENCH_NVM_READ,             /* App_NVM_Read, full restore of the persistent data */
+  BENCH_NVM_WRITE,            /* App_NVM_Write, full persist of the persistent data */
+  BENCH_ZB_CMD_TRANSFER,      /* ZIGBEE_CmdTransfer, request up to the M0 acknowledge */
+  BENCH_SEQ_DISPATCH,         /* UTIL_SEQ_Run, pending task selection up to the task call */
+  BENCH_TS_START,             /* HW_TS_Start */
+  BENCH_TS_STOP,              /* HW_TS_Stop */
+  BENCH_NB
+} Bench_Id_T;
+
+typedef struct
+{
+  uint32_t count;
+  uint32_t min;               /* In cycles, probe overhead removed */
+  uint32_t max;
+  uint64_t sum;
+  uint32_t hist[BENCH_HIST_NB];
+} Bench_Stats_T;
+
+/* Exported Macros ----------------------------------------------------------- */
+#if (CFG_BENCH_ENABLE != 0)
+#define APP_BENCH_START(id)          App_Bench_Start(id)
+#define APP_BENCH_STOP(id)           App_Bench_Stop(id)
+#else
+#define APP_BENCH_START(id)
+#define APP_BENCH_STOP(id)
+#endif /* CFG_BENCH_ENABLE */
+
+/* Exported Prototypes -------------------------------------------------------*/
+void                  App_Bench_Init     (void);
+void                  App_Bench_Start    (Bench_Id_T id);
+void                  App_Bench_Stop     (Bench_Id_T id);
+void                  App_Bench_Reset    (void);
+const Bench_Stats_T * App_Bench_Get_Stats(Bench_Id_T id);
+uint32_t              App_Bench_Percentile(Bench_Id_T id, uint8_t percent);
+void                  App_Bench_Report   (void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* APP_BENCH_H */
@@ -106,6 +106,23 @@
 #undef CFG_LPM_SUPPORTED
 #define CFG_LPM_SUPPORTED   1
 #endif /* CFG_FULL_LOW_POWER */
+/******************************************************************************
+ * Flash driver
+ *
+ *  CFG_FD_SEM_TIMEOUT: Time (ms) waiting for the ownership of the Flash IP before
+ *  reporting the erase or write as not executed.
+ *
+ *  CFG_FD_LEASE_MAX_HOLD: Time (ms) after which a multiple sectors erase or multiple
+ *  data write gives the ownership of the Flash IP back to the CPU2 before going on.
+ *
+ *  CFG_FD_FAST_PROGRAM: When set, a complete row staged with FD_StageData() is fast
+ *  programmed at once instead of 64 double words. The row programming masks the
+ *  interrupts of the CPU1 for up to 7ms.
+ ******************************************************************************/
+#define CFG_FD_SEM_TIMEOUT         1000U
+#define CFG_FD_LEASE_MAX_HOLD      5U
+#define CFG_FD_FAST_PROGRAM        0U
+
 /******************************************************************************
  * Timer Server
  ******************************************************************************/
@@ -258,6 +275,13 @@ typedef enum
 #define CFG_DEBUG_TRACE_LIGHT     0
 #endif
 
+/**
+ * When set to 1, the latency of the critical application paths is measured in cycles with
+ * DWT CYCCNT (see app_bench.h). The console command "bench" prints the distributions in JSON.
+ * The cycle counter stops in Stop mode, keep CFG_FULL_LOW_POWER to 0 while measuring.
+ */
+#define CFG_BENCH_ENABLE    0
+
 /**
  * When not set, the traces is looping on sending the trace over UART
  */
@@ -270,10 +294,26 @@ typedef enum
 #define DBG_TRACE_MSG_QUEUE_SIZE 4096
 #define MAX_DBG_TRACE_MSG_SIZE 1024
 
+/**
+ * Policy when the trace queue is full : DBG_TRACE_DROP_NEWEST, DBG_TRACE_DROP_OLDEST (whole lines)
+ * or DBG_TRACE_BLOCK (wait for the output up to DBG_TRACE_BLOCK_TIMEOUT ms, from thread mode only)
+ */
+#define DBG_TRACE_OVERFLOW_POLICY    DBG_TRACE_DROP_NEWEST
+#define DBG_TRACE_BLOCK_TIMEOUT      10U
+
+/**
+ * When set, the logs record only their format and arguments, the lines are
+ * formatted by the lowest priority task (see stm_logging.c).
+ * LOG_DEFERRED_BUFFER_SIZE is the size of the record ring in 32 bits words.
+ */
+#define LOG_DEFERRED_ENABLE        1U
+#define LOG_DEFERRED_BUFFER_SIZE   512U
+
 /******************************************************************************
  * Configure Log level for Application
  ******************************************************************************/
 #define APPLI_CONFIG_LOG_LEVEL    LOG_LEVEL_INFO
+#define APPLI_CONFIG_ZB_LOG_LEVEL LOG_LEVEL_DEBG
 #define APPLI_PRINT_FILE_FUNC_LINE    0
 
 /* USER CODE BEGIN Defines */
@@ -311,8 +351,12 @@ typedef enum
   CFG_TASK_LIMIT_SWITCH,
   CFG_TASK_MOTOR_CONTROL,
   CFG_TASK_LIGHT_UPDATE,
+  CFG_TASK_LIGHT_LEVEL_TRANSITION,
   CFG_TASK_ROLLER_SHUTTER_OCCUPANCY_EVT,
   CFG_TASK_LCD_CLEAN_STATUS,
+  CFG_TASK_LCD_REFRESH,
+  CFG_TASK_LOG_FLUSH,
+  CFG_TASK_CONSOLE,
 #if (CFG_USB_INTERFACE_ENABLE != 0)
   CFG_TASK_VCP_SEND_DATA,
 #endif /* (CFG_USB_INTERFACE_ENABLE != 0) */
@@ -373,8 +417,15 @@ typedef enum
 typedef enum
 {
   CFG_LPM_APP,
+  CFG_LPM_APP_LCD,
 } CFG_LPM_Id_t;
 
+/******************************************************************************
+ * Blinkt Led bar
+ ******************************************************************************/
+/* Gamma correction of the levels, the light level steps look even */
+#define BLINKT_GAMMA_CORRECTION 1
+
 /******************************************************************************
  * OTP manager
  ******************************************************************************/
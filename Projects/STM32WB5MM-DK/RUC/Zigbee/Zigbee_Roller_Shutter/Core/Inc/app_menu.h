@@ -34,40 +34,38 @@ extern "C" {
 #define UART_DISPLAY                 0x01
 #define DK_LCD_DISPLAY               0x02
 
+/* Maximum number of levels of the menu tree */
+#define MENU_DEPTH_MAX               4U
+
 /* Exported Types ------------------------------------------------------------ */
 typedef struct Menu_Item_T 
 {
-  bool first_item_to_display;     /* To know the first item of the current-item */
-  char * name;                    /* Item name to display */
-  
-  /* Link list foreach element in the current menu */
-  struct Menu_Item_T * prev_item;
-  struct Menu_Item_T * next_item;
-  
+  const char * name;                          /* Item name to display */
+
   /* Manage the Tree menu */
-  struct Menu_Item_T * parent;    /* Parent to callback in case of submenu */
-  struct Menu_Item_T * sub_level; /* Call a submenu with new items */
-  
-  void (*fct)(void);              /* Action to do */
+  const struct Menu_Item_T * sub_level;       /* Items of the submenu, NULL for an action */
+  uint8_t sub_nb;                             /* Number of items of the submenu */
+
+  void (*fct)(void);                          /* Action to do */
 } Menu_Item_T;
 
+/* Exported Macros ----------------------------------------------------------- */
+/* Each menu stage is a const table of items, a submenu table is defined before its parent item */
+#define MENU_NB(menu)                (sizeof(menu) / sizeof((menu)[0]))
+#define MENU_SUB(name, menu)         { (name), (menu), (uint8_t)MENU_NB(menu), NULL }
+#define MENU_ACTION(name, fct)       { (name), NULL, 0U, (fct) }
+
 /* Exported Prototypes -------------------------------------------------------*/
 /* Menu creation */
 bool Menu_Config(void);
-Menu_Item_T * Create_Menu_Item(void);
-void Add_Menu_Item(char * name,
-                    Menu_Item_T * current_item, 
-                    Menu_Item_T * next_item, 
-                    Menu_Item_T * sub_level, 
-                    void (*fct)(void) );
-bool Del_Menu_Item(Menu_Item_T * item);
-bool Def_Start_Menu_Item(Menu_Item_T * start_item);
+bool Def_Start_Menu_Item(const Menu_Item_T * start_menu, uint8_t nb);
 
 /* Menu actions */
 void Next_Menu_Item  (void);
 void Prev_Menu_Item  (void);
 void Select_Menu_Item(void);
 void Exit_Menu_Item  (void);
+void Refresh_Menu    (void);
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -51,6 +51,9 @@ extern "C" {
 
     ZIGBEE_DB_START_ADDR: beginning of zigbee NVM
 
+    APP_PARAM_START_ADDR: beginning of application parameters NVM, after the
+                          zigbee data and below the EE pool capacity
+
     CFG_EE_AUTO_CLEAN : Clean the flash automatically when needed
   */ 
 #define CFG_NB_OF_PAGE                          (16U)
@@ -60,8 +63,25 @@ extern "C" {
 #define ST_PERSIST_MAX_ALLOC_SZ                 (4U*CFG_EE_BANK0_MAX_NB) // Max data in bytes
 #define ST_PERSIST_FLASH_DATA_OFFSET            (4U)
 #define ZIGBEE_DB_START_ADDR                    (0U)
+#define APP_PARAM_START_ADDR                    (0x0400U)
 #define CFG_EE_AUTO_CLEAN                       (1U)
 
+#if (APP_PARAM_START_ADDR <= (ZIGBEE_DB_START_ADDR + CFG_EE_BANK0_MAX_NB))
+#error "APP_PARAM_START_ADDR overlaps the zigbee persistent data"
+#endif
+
+/* Types ---------------------------------------------------------------------*/
+/* Application parameters saved in NVM, one U32 word each */
+typedef enum
+{
+  APP_NVM_PARAM_REPORT_MIN,
+  APP_NVM_PARAM_REPORT_MAX,
+  APP_NVM_PARAM_REPORT_CHANGE,
+  APP_NVM_PARAM_OCC_HOLDOFF,
+  APP_NVM_PARAM_LOG_LEVELS,     /* 4 bits per log region */
+  APP_NVM_PARAM_NB,
+} App_NVM_Param_T;
+
 /* Exported Persistent Prototypes --------------------------------------------*/
 enum ZbStatusCodeT App_Startup_Persist(struct ZigBeeT *zb);
 bool App_Persist_Load        (void);
@@ -76,6 +96,10 @@ bool App_NVM_Read (void);
 bool App_NVM_Write(void);
 void App_NVM_Erase(void);
 
+/* Exported Application Parameters Prototypes --------------------------------*/
+bool App_NVM_Param_Read (App_NVM_Param_T param, uint32_t *value);
+bool App_NVM_Param_Write(App_NVM_Param_T param, uint32_t value);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
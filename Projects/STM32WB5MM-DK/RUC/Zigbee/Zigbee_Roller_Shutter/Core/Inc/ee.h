@@ -150,7 +150,9 @@ extern int EE_Read( int bank, uint16_t addr, uint32_t* data );
  * return: EE_OK in case of success
  *         EE_CLEAN_NEEDED if success but user must trigger flash cleanup
  *                         by calling EE_Clean()
- *         EE..._ERROR in case of error
+ *         EE..._ERROR in case of error, also when the flash is not given by
+ *                     the CPU2 within CFG_FD_SEM_TIMEOUT: the write may then
+ *                     be called again
  */
 
 extern int EE_Write( int bank, uint16_t addr, uint32_t data );
@@ -172,7 +174,10 @@ extern int EE_Write( int bank, uint16_t addr, uint32_t data );
  *            1 -> interrupt mode
  *
  * return: EE_OK in case of success
- *         EE..._ERROR in case of error
+ *         EE..._ERROR in case of error, also when the flash is not given by
+ *                     the CPU2 within CFG_FD_SEM_TIMEOUT: the clean may then
+ *                     be called again, or is finished by the EE_Write() that
+ *                     needs the other pool
  */
 
 extern int EE_Clean( int bank, int interrupt );
@@ -159,9 +159,11 @@
  *****************************************************************************/
 #define CFG_HW_LPUART1_ENABLED           0
 #define CFG_HW_LPUART1_DMA_TX_SUPPORTED  0
+#define CFG_HW_LPUART1_DMA_RX_SUPPORTED  0
 
 #define CFG_HW_USART1_ENABLED           1
 #define CFG_HW_USART1_DMA_TX_SUPPORTED  1
+#define CFG_HW_USART1_DMA_RX_SUPPORTED  1
 
 /**
  * UART1
@@ -206,5 +208,9 @@
 #define CFG_HW_USART1_TX_DMA_CHANNEL          DMA2_Channel4
 #define CFG_HW_USART1_TX_DMA_IRQn             DMA2_Channel4_IRQn
 #define CFG_HW_USART1_DMA_TX_IRQHandler       DMA2_Channel4_IRQHandler
+#define CFG_HW_USART1_RX_DMA_REQ              DMA_REQUEST_USART1_RX
+#define CFG_HW_USART1_RX_DMA_CHANNEL          DMA2_Channel5
+#define CFG_HW_USART1_RX_DMA_IRQn             DMA2_Channel5_IRQn
+#define CFG_HW_USART1_DMA_RX_IRQHandler       DMA2_Channel5_IRQHandler
 
 #endif /*HW_CONF_H */
@@ -45,6 +45,8 @@ void C2SEV_PWR_C2H_IRQHandler(void);
 void USART1_IRQHandler(void);
 void HSEM_IRQHandler(void);
 void DMA2_Channel4_IRQHandler(void);
+void DMA1_Channel2_IRQHandler(void);
+void DMA2_Channel5_IRQHandler(void);
 void FPU_IRQHandler(void);
 void PWR_SOTF_BLEACT_802ACT_RFPHASE_IRQHandler(void);
 void IPCC_C1_RX_IRQHandler(void);
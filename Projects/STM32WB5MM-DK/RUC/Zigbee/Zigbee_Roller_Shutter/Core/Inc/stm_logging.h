@@ -15,6 +15,7 @@
   ******************************************************************************
   */
 
+#include "app_conf.h"
 #include "dbg_trace.h"
 
 #ifndef STM_LOGGING_H_
@@ -26,13 +27,22 @@
 #define LOG_LEVEL_INFO  3U  /* Info     */
 #define LOG_LEVEL_DEBG  4U  /* Debug    */
 
+/* Size of the runtime level table, indexed by the region ID */
+#define APPLI_LOG_REGION_NB  3U
+
+/* Level check done before any formatting */
+#define LOG_IS_ENABLED(level, region)   ((level) <= logRegionLevel[(region)])
+
 #define APP_DBG_FULL(level, region, ...)                                                    \
   {                                                                                         \
-    if (APPLI_PRINT_FILE_FUNC_LINE == 1U)                                                   \
+    if (LOG_IS_ENABLED(level, region))                                                      \
     {                                                                                       \
-        printf("\r\n[%s][%s][%d] ", DbgTraceGetFileName(__FILE__),__FUNCTION__,__LINE__);   \
+      if (APPLI_PRINT_FILE_FUNC_LINE == 1U)                                                 \
+      {                                                                                     \
+          printf("\r\n[%s][%s][%d] ", DbgTraceGetFileName(__FILE__),__FUNCTION__,__LINE__); \
+      }                                                                                     \
+      logApplication(level, region, __VA_ARGS__);                                           \
     }                                                                                       \
-    logApplication(level, region, __VA_ARGS__);                                             \
   }
 
 #define APP_DBG(...)                                                                        \
@@ -44,7 +54,15 @@
     logApplication(LOG_LEVEL_NONE, APPLI_LOG_REGION_GENERAL, __VA_ARGS__);                  \
   }
 
+#if (LOG_DEFERRED_ENABLE == 1U)
+/* Only the format and the arguments are recorded, the line is formatted later */
 #define APP_ZB_DBG(...)                                                                 \
+  (LOG_IS_ENABLED(LOG_LEVEL_INFO, APPLI_LOG_REGION_GENERAL) ?                           \
+   logDeferred(LOG_LEVEL_INFO, APPLI_LOG_REGION_GENERAL, __FILE__, __VA_ARGS__) : (void)0)
+#else
+#define APP_ZB_DBG(...)                                                                 \
+  {                                                                                     \
+  if (LOG_IS_ENABLED(LOG_LEVEL_INFO, APPLI_LOG_REGION_GENERAL))                         \
   {                                                                                     \
     char const * name = DbgTraceGetFileName(__FILE__);                                  \
     printf("[M4 APPLICATION] \x1b[38;5;%dm[",( (name[4] + name[5] * 8) % 115) + 117);   \
@@ -62,7 +80,9 @@
    printf("]\x1B[m ");                                                                  \
    printf(__VA_ARGS__);                                                                 \
    printf("\n");                                                                        \
-}
+}                                                                                       \
+  }
+#endif /* LOG_DEFERRED_ENABLE */
 
 /**
  * This enumeration represents log regions.
@@ -76,6 +96,13 @@ typedef enum
 
 typedef uint8_t appliLogLevel_t;
 
+extern appliLogLevel_t logRegionLevel[APPLI_LOG_REGION_NB];
+
+appliLogLevel_t logGetLevel(appliLogRegion_t aLogRegion);
+void logSetLevel(appliLogRegion_t aLogRegion, appliLogLevel_t aLogLevel);
 void logApplication(appliLogLevel_t aLogLevel, appliLogRegion_t aLogRegion, const char *aFormat, ...);
+void logDeferred(appliLogLevel_t aLogLevel, appliLogRegion_t aLogRegion, const char *aFile, const char *aFormat, ...);
+void logDeferredInit(void);
+void logDeferredFlush(void);
 
 #endif /* STM_LOGGING_H_ */
@@ -26,6 +26,7 @@ extern "C" {
 
 #include "cmsis_compiler.h"
 #include "string.h"
+#include "app_bench.h"
 
 /******************************************************************************
  * common
@@ -55,6 +56,8 @@ extern "C" {
 #define UTIL_SEQ_CONF_TASK_NBR                  (32)
 #define UTIL_SEQ_CONF_PRIO_NBR                  (2)
 #define UTIL_SEQ_MEMSET8( dest, value, size )   UTILS_MEMSET8( dest, value, size )
+#define UTIL_SEQ_DISPATCH_START( )              APP_BENCH_START( BENCH_SEQ_DISPATCH )
+#define UTIL_SEQ_DISPATCH_END( )                APP_BENCH_STOP( BENCH_SEQ_DISPATCH )
 
 #ifdef __cplusplus
 }
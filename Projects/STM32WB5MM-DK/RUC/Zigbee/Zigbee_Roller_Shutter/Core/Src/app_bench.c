@@ -0,0 +1,329 @@
+/**
+  ******************************************************************************
+  * @file    app_bench.c
+  * @author  Zigbee Application Team
+  * @brief   Cycle measurement of the critical application paths with DWT CYCCNT
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include "app_common.h"
+#include "utilities_conf.h"
+
+/* Services dependencies */
+#include "app_bench.h"
+
+#if (CFG_BENCH_ENABLE != 0)
+
+/* Private defines ---------------------------------------------------------- */
+/* Back to back measures used to get the cost of the probes themselves */
+#define BENCH_CALIB_NB               8U
+/* One report line per path, the histogram only lists the used buckets.
+ * Shall not be larger than MAX_DBG_TRACE_MSG_SIZE */
+#define BENCH_LINE_SIZE              768U
+/* Room kept for the end of the line: "]}," CR LF and the null character */
+#define BENCH_LINE_END_SIZE          6U
+
+#define BENCH_GET_CYCLES()           (DWT->CYCCNT)
+
+/* Private variables -------------------------------------------------------- */
+static const char * const bench_name[BENCH_NB] =
+{
+  "motor_cmd",
+  "nvm_init",
+  "nvm_read",
+  "nvm_write",
+  "zb_cmd_transfer",
+  "seq_dispatch",
+  "ts_start",
+  "ts_stop",
+};
+
+static Bench_Stats_T     bench_stats[BENCH_NB];
+static uint32_t          bench_start[BENCH_NB];
+static volatile uint8_t  bench_running[BENCH_NB];   /* One byte per path, written from any context */
+static uint32_t          bench_overhead;
+static bool              bench_ready;
+static char              bench_line[BENCH_LINE_SIZE];
+
+/* Private functions prototypes-----------------------------------------------*/
+static uint8_t           Bench_Bucket      (uint32_t cycles);
+static uint32_t          Bench_Bucket_Max  (uint8_t bucket);
+static uint32_t          Bench_Percentile  (const Bench_Stats_T * stats, uint8_t percent);
+
+/* Functions Definition ------------------------------------------------------*/
+
+/**
+ * @brief  Start the cycle counter and measure the cost of the probes
+ * @param  None
+ * @retval None
+ */
+void App_Bench_Init(void)
+{
+  uint8_t index;
+
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  bench_overhead = 0U;
+  bench_ready    = true;
+  App_Bench_Reset();
+
+  for (index = 0U; index < BENCH_CALIB_NB; index++)
+  {
+    App_Bench_Start(BENCH_TS_STOP);
+    App_Bench_Stop(BENCH_TS_STOP);
+  }
+  bench_overhead = bench_stats[BENCH_TS_STOP].min;
+
+  App_Bench_Reset();
+} /* App_Bench_Init */
+
+/**
+ * @brief  Start the measure of a path
+ * @param  id path to measure
+ * @retval None
+ */
+void App_Bench_Start(Bench_Id_T id)
+{
+  if (bench_ready)
+  {
+    bench_start[id]   = BENCH_GET_CYCLES();
+    bench_running[id] = 1U;
+  }
+} /* App_Bench_Start */
+
+/**
+ * @brief  End the measure of a path and add the sample to its distribution,
+ *         nothing is recorded if the measure was not started
+ * @param  id path measured
+ * @retval None
+ */
+void App_Bench_Stop(Bench_Id_T id)
+{
+  uint32_t         cycles = BENCH_GET_CYCLES() - bench_start[id];
+  Bench_Stats_T *  stats  = &bench_stats[id];
+  uint8_t          bucket;
+
+  if (bench_running[id] == 0U)
+  {
+    return;
+  }
+  bench_running[id] = 0U;
+
+  cycles = (cycles > bench_overhead) ? (cycles - bench_overhead) : 0U;
+  bucket = Bench_Bucket(cycles);
+
+  UTILS_ENTER_CRITICAL_SECTION();
+  stats->count++;
+  stats->sum += cycles;
+  if (cycles < stats->min)
+  {
+    stats->min = cycles;
+  }
+  if (cycles > stats->max)
+  {
+    stats->max = cycles;
+  }
+  stats->hist[bucket]++;
+  UTILS_EXIT_CRITICAL_SECTION();
+} /* App_Bench_Stop */
+
+/**
+ * @brief  Clear the distributions of all the paths
+ * @param  None
+ * @retval None
+ */
+void App_Bench_Reset(void)
+{
+  uint8_t id;
+
+  UTILS_ENTER_CRITICAL_SECTION();
+  memset(bench_stats, 0, sizeof(bench_stats));
+  for (id = 0U; id < (uint8_t)BENCH_NB; id++)
+  {
+    bench_stats[id].min = UINT32_MAX;
+    bench_running[id]   = 0U;
+  }
+  UTILS_EXIT_CRITICAL_SECTION();
+} /* App_Bench_Reset */
+
+/**
+ * @brief  Give the distribution of a path
+ * @param  id path measured
+ * @retval pointer to the statistics, min is UINT32_MAX while count is 0
+ */
+const Bench_Stats_T * App_Bench_Get_Stats(Bench_Id_T id)
+{
+  return &bench_stats[id];
+} /* App_Bench_Get_Stats */
+
+/**
+ * @brief  Give a percentile of the distribution of a path
+ * @param  id path measured
+ * @param  percent 1 to 100
+ * @retval upper bound of the bucket holding the percentile in cycles, 0 if no sample
+ */
+uint32_t App_Bench_Percentile(Bench_Id_T id, uint8_t percent)
+{
+  return Bench_Percentile(&bench_stats[id], percent);
+} /* App_Bench_Percentile */
+
+/**
+ * @brief  Print the distributions of all the paths in JSON on the trace, one line per path
+ * @param  None
+ * @retval None
+ */
+void App_Bench_Report(void)
+{
+  Bench_Stats_T  stats;
+  uint16_t       len;
+  uint16_t       nb;
+  uint8_t        id;
+  uint8_t        bucket;
+  const char *   sep;
+
+  printf("{\"bench\":\"roller_shutter\",\"cpu_hz\":%lu,\"overhead\":%lu,\"results\":[\r\n",
+         (unsigned long)SystemCoreClock, (unsigned long)bench_overhead);
+
+  for (id = 0U; id < (uint8_t)BENCH_NB; id++)
+  {
+    /* Work on a copy, the samples keep coming under interrupt */
+    UTILS_ENTER_CRITICAL_SECTION();
+    stats = bench_stats[id];
+    UTILS_EXIT_CRITICAL_SECTION();
+
+    if (stats.count == 0U)
+    {
+      stats.min = 0U;
+    }
+
+    len = (uint16_t)snprintf(bench_line, BENCH_LINE_SIZE,
+                             "{\"name\":\"%s\",\"n\":%lu,\"min\":%lu,\"mean\":%lu,\"p50\":%lu,\"p90\":%lu,\"p99\":%lu,\"max\":%lu,\"hist\":[",
+                             bench_name[id], (unsigned long)stats.count, (unsigned long)stats.min,
+                             (unsigned long)((stats.count != 0U) ? (stats.sum / stats.count) : 0U),
+                             (unsigned long)Bench_Percentile(&stats, 50U),
+                             (unsigned long)Bench_Percentile(&stats, 90U),
+                             (unsigned long)Bench_Percentile(&stats, 99U),
+                             (unsigned long)stats.max);
+
+    /* [bucket upper bound in cycles, number of samples] for the used buckets, the last
+     * buckets are left out when the line is full so that it stays valid JSON */
+    sep = "";
+    for (bucket = 0U; bucket < BENCH_HIST_NB; bucket++)
+    {
+      if (stats.hist[bucket] != 0U)
+      {
+        nb = (uint16_t)snprintf(&bench_line[len], BENCH_LINE_SIZE - BENCH_LINE_END_SIZE - len, "%s[%lu,%lu]",
+                                sep, (unsigned long)Bench_Bucket_Max(bucket), (unsigned long)stats.hist[bucket]);
+        if (nb >= (BENCH_LINE_SIZE - BENCH_LINE_END_SIZE - len))
+        {
+          bench_line[len] = '\0';
+          break;
+        }
+        len += nb;
+        sep = ",";
+      }
+    }
+
+    (void)snprintf(&bench_line[len], BENCH_LINE_SIZE - len, "]}%s\r\n", (id < ((uint8_t)BENCH_NB - 1U)) ? "," : "");
+    printf("%s", bench_line);
+  }
+
+  printf("]}\r\n");
+} /* App_Bench_Report */
+
+/**
+ * @brief  Histogram bucket of a sample: 0, 1, then [2^n, 1.5*2^n[ and [1.5*2^n, 2^(n+1)[
+ * @param  cycles sample
+ * @retval bucket index
+ */
+static uint8_t Bench_Bucket(uint32_t cycles)
+{
+  uint8_t msb;
+
+  if (cycles < 2U)
+  {
+    return (uint8_t)cycles;
+  }
+
+  msb = (uint8_t)(31U - __CLZ(cycles));
+  return (uint8_t)((2U * msb) + ((cycles >> (msb - 1U)) & 1U));
+} /* Bench_Bucket */
+
+/**
+ * @brief  Largest sample of a histogram bucket
+ * @param  bucket bucket index
+ * @retval cycles
+ */
+static uint32_t Bench_Bucket_Max(uint8_t bucket)
+{
+  uint8_t msb = bucket / 2U;
+
+  if (bucket < 2U)
+  {
+    return bucket;
+  }
+
+  /* Wraps to UINT32_MAX for the last bucket */
+  return ((uint32_t)(3U + (bucket & 1U)) << (msb - 1U)) - 1U;
+} /* Bench_Bucket_Max */
+
+/**
+ * @brief  Percentile of a distribution from its histogram
+ * @param  stats distribution
+ * @param  percent 1 to 100
+ * @retval upper bound of the bucket holding the percentile, within min and max
+ */
+static uint32_t Bench_Percentile(const Bench_Stats_T * stats, uint8_t percent)
+{
+  uint32_t rank;
+  uint32_t nb = 0U;
+  uint32_t value;
+  uint8_t  bucket;
+
+  if (stats->count == 0U)
+  {
+    return 0U;
+  }
+
+  rank = (uint32_t)((((uint64_t)stats->count * percent) + 99U) / 100U);
+  if (rank == 0U)
+  {
+    rank = 1U;
+  }
+
+  for (bucket = 0U; bucket < BENCH_HIST_NB; bucket++)
+  {
+    nb += stats->hist[bucket];
+    if (nb >= rank)
+    {
+      value = Bench_Bucket_Max(bucket);
+      if (value > stats->max)
+      {
+        value = stats->max;
+      }
+      if (value < stats->min)
+      {
+        value = stats->min;
+      }
+      return value;
+    }
+  }
+
+  return stats->max;
+} /* Bench_Percentile */
+
+#endif /* CFG_BENCH_ENABLE */
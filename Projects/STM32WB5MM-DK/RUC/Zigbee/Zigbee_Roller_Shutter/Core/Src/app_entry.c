@@ -39,6 +39,7 @@
 #include "app_entry.h"
 #include "app_zigbee.h"
 #include "app_core.h"
+#include "app_bench.h"
 
 /* Private includes -----------------------------------------------------------*/
 
@@ -118,6 +119,9 @@ void MX_APPE_Init( void )
 
 /* USER CODE BEGIN MX_APPE_Init_1 */
   Init_Debug();
+#if (CFG_BENCH_ENABLE != 0)
+  App_Bench_Init();
+#endif /* CFG_BENCH_ENABLE */
   
   /**
    * The Standby mode should not be entered before the initialization is over
@@ -356,6 +360,7 @@ static void Init_Debug( void )
 
 #if(CFG_DEBUG_TRACE != 0)
   DbgTraceInit();
+  logDeferredInit();
 #endif
 
   return;
@@ -33,6 +33,7 @@
 
 /* service dependencies */
 #include "app_core.h"
+#include "app_bench.h"
 
 /* Private variables ---------------------------------------------------------*/
 uint32_t persistNumWrites = 0;
@@ -241,7 +242,9 @@ void App_NVM_Init(void)
   int eeprom_init_status;
 
   APP_ZB_DBG("Flash starting address = %x", HW_FLASH_ADDRESS + CFG_NVM_BASE_ADDRESS);
+  APP_BENCH_START(BENCH_NVM_INIT);
   eeprom_init_status = EE_Init(0, HW_FLASH_ADDRESS + CFG_NVM_BASE_ADDRESS);
+  APP_BENCH_STOP(BENCH_NVM_INIT);
 
   if (eeprom_init_status != EE_OK)
   {
@@ -263,6 +266,8 @@ bool App_NVM_Read(void)
   bool status        = true;
   int ee_status      = 0;
   
+  APP_BENCH_START(BENCH_NVM_READ);
+
   HAL_FLASH_Unlock();
   __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_PGSERR | FLASH_FLAG_WRPERR | FLASH_FLAG_OPTVERR);
 
@@ -305,6 +310,8 @@ bool App_NVM_Read(void)
   }
 
   HAL_FLASH_Lock();
+  APP_BENCH_STOP(BENCH_NVM_READ);
+
   if (status)
   {
     APP_ZB_DBG("Read persistent data length = %d", cache_persistent_data.U32_data[0]);
@@ -325,6 +332,8 @@ bool App_NVM_Write(void)
   uint16_t num_words;
   uint16_t local_current_size;
 
+  APP_BENCH_START(BENCH_NVM_WRITE);
+
   num_words = 1U; /* 1 words for the length */
   num_words += (uint16_t)(cache_persistent_data.U32_data[0] / 4);
 
@@ -354,6 +363,8 @@ bool App_NVM_Write(void)
     }
   }
 
+  APP_BENCH_STOP(BENCH_NVM_WRITE);
+
   if (ee_status != EE_OK)
   {
     APP_ZB_DBG("Write Stopped, need a FLASH ERASE");
@@ -381,6 +392,69 @@ void App_NVM_Erase(void)
   }
 } /* App_NVM_Erase */
 
+/* Exported Application Parameters Functions ---------------------------------*/
+/**
+ * @brief  Read an application parameter from NVM
+ * @param  param parameter identifier
+ * @param  value pointer to store the read value, untouched if not found
+ * @retval true if found, false otherwise (never written or NVM erased)
+ */
+bool App_NVM_Param_Read(App_NVM_Param_T param, uint32_t *value)
+{
+  uint32_t data;
+
+  if (param >= APP_NVM_PARAM_NB)
+  {
+    return false;
+  }
+
+  if (EE_Read(0, (uint16_t)(APP_PARAM_START_ADDR + param), &data) != EE_OK)
+  {
+    return false;
+  }
+
+  *value = data;
+  return true;
+} /* App_NVM_Param_Read */
+
+/**
+ * @brief  Write an application parameter in NVM
+ * Nothing is written if the stored value is already the same to save flash cycles
+ * @param  param parameter identifier
+ * @param  value new value
+ * @retval true if success, false if failed
+ */
+bool App_NVM_Param_Write(App_NVM_Param_T param, uint32_t value)
+{
+  uint32_t data;
+  int ee_status;
+
+  if (param >= APP_NVM_PARAM_NB)
+  {
+    return false;
+  }
+
+  if ((App_NVM_Param_Read(param, &data) == true) && (data == value))
+  {
+    return true;
+  }
+
+  ee_status = EE_Write(0, (uint16_t)(APP_PARAM_START_ADDR + param), value);
+  if (ee_status == EE_CLEAN_NEEDED) /* Shall not be there if CFG_EE_AUTO_CLEAN = 1*/
+  {
+    APP_ZB_DBG("CLEAN NEEDED, CLEANING");
+    ee_status = EE_Clean(0, 0);
+  }
+
+  if (ee_status != EE_OK)
+  {
+    APP_ZB_DBG("App_NVM_Param_Write failed for param %d status %d", param, ee_status);
+    return false;
+  }
+
+  return true;
+} /* App_NVM_Param_Write */
+
 /**
  * @brief  Simple function to see the content of NVM table
  * @param  None
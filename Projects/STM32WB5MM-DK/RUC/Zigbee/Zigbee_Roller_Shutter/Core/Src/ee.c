@@ -127,7 +127,10 @@ static int EE_Recovery( EE_var_t* pv );
 
 static int EE_Transfer( EE_var_t* pv, uint16_t addr, uint32_t page );
 
-static int EE_WriteEl( EE_var_t* pv, uint16_t addr, uint32_t data );
+static int EE_WriteEl( EE_var_t* pv, uint16_t addr, uint32_t data,
+                       int stage );
+
+static void EE_Discard( EE_var_t* pv );
 
 static int EE_ReadEl( const EE_var_t* pv,
                       uint16_t addr, uint32_t* data, uint32_t page );
@@ -177,6 +180,8 @@ int EE_Init( int format, uint32_t base_address )
 //      return EE_ERASE_ERROR;
 //    }
 
+    /* The flash driver gives up when it does not get the ownership of the
+       flash within CFG_FD_SEM_TIMEOUT */
     if ( FD_EraseSectors( EE_FLASH_PAGE( EE_var, 0 ), total_nb_pages) != 0 )
     {
       return EE_ERASE_ERROR;
@@ -221,12 +226,24 @@ int EE_Write( int bank, uint16_t addr, uint32_t data )
 {
   EE_var_t *pv = &EE_var[CFG_EE_BANK1_SIZE && bank];;
   uint32_t page;
+  int status;
+
+  /* If the last pool transfer has failed, resume it before writing */
+  if ( EE_GetState( pv, pv->current_write_page ) == EE_STATE_RECEIVE )
+  {
+    page = (pv->current_write_page < pv->nb_pages) ? 0 : pv->nb_pages;
+
+    if ( EE_Transfer( pv, EE_TAG, page ) != EE_OK )
+    {
+      return EE_WRITE_ERROR;
+    }
+  }
 
   /* Check if current pool is full */
   if ( pv->nb_written_elements < EE_NB_MAX_ELT * pv->nb_pages )
   {
     /* If not full, write the virtual address and value in the EEPROM */
-    return EE_WriteEl( pv, addr, data );
+    return EE_WriteEl( pv, addr, data, 0 );
   }
 
   EE_DBG( EE_2 );
@@ -234,6 +251,17 @@ int EE_Write( int bank, uint16_t addr, uint32_t data )
   /* If full, we need to write in other pool and perform pool transfer */
   page = EE_NEXT_POOL( pv );
 
+  /* If the clean following the last transfer has failed, finish it now:
+     only the pages not erased yet are erased */
+  if ( EE_GetState( pv, pv->current_write_page ) == EE_STATE_ACTIVE )
+  {
+    status = EE_Clean( bank, 0 );
+    if ( status != EE_OK )
+    {
+      return status;
+    }
+  }
+
   /* Check next page state: it must be ERASED */
   if ( EE_GetState( pv, page ) != EE_STATE_ERASED )
   {
@@ -254,7 +282,7 @@ int EE_Write( int bank, uint16_t addr, uint32_t data )
   pv->next_write_offset = EE_HEADER_SIZE;
 
   /* Write the variable passed as parameter in the new active page */
-  if ( EE_WriteEl( pv, addr, data ) != EE_OK )
+  if ( EE_WriteEl( pv, addr, data, 0 ) != EE_OK )
   {
     return EE_WRITE_ERROR;
   }
@@ -287,13 +315,15 @@ int EE_Write( int bank, uint16_t addr, uint32_t data )
 int EE_Clean( int bank, int interrupt )
 {
   EE_var_t *pv = &EE_var[CFG_EE_BANK1_SIZE && bank];
-  uint32_t page;
+  uint32_t first_page, page, state;
 
   /* Get first page of unused pool */
-  page = EE_NEXT_POOL( pv );
+  first_page = EE_NEXT_POOL( pv );
 
-  /* At least, the first page of the pool should be in ERASING state */
-  if ( EE_GetState( pv, page ) != EE_STATE_ERASING )
+  /* At least, the first page of the pool should be in ERASING state; it is
+     already erased when a previous clean has failed in the middle */
+  state = EE_GetState( pv, first_page );
+  if ( (state != EE_STATE_ERASING) && (state != EE_STATE_ERASED) )
   {
     return EE_STATE_ERROR;
   }
@@ -307,9 +337,17 @@ int EE_Clean( int bank, int interrupt )
 //    return EE_ERASE_ERROR;
 //  }
 
-  if( FD_EraseSectors(EE_FLASH_PAGE( pv, page ), pv->nb_pages) != 0 )
+  /* Erase the pages not erased yet: on a flash ownership timeout, the pages
+     left are erased by the next EE_Clean or EE_Init */
+  for ( page = first_page; page < first_page + pv->nb_pages; page++ )
   {
-    return EE_ERASE_ERROR;
+    if ( EE_GetState( pv, page ) != EE_STATE_ERASED )
+    {
+      if ( FD_EraseSectors( EE_FLASH_PAGE( pv, page ), 1) != 0 )
+      {
+        return EE_ERASE_ERROR;
+      }
+    }
   }
 
   return EE_OK;
@@ -402,6 +440,13 @@ static int EE_Recovery( EE_var_t* pv )
         }
       }
 
+      /* If next page of the pool has the same state, the page change has
+         been interrupted before this page was marked as VALID: the next page
+         is the write page, and this one is marked as VALID when it is found */
+      if ( (((page + 1) % pv->nb_pages) != 0) &&
+           (EE_GetState( pv, page + 1 ) == state) )
+        continue;
+
       /* Update write page */
       pv->current_write_page = page;
 
@@ -455,6 +500,7 @@ static int EE_Recovery( EE_var_t* pv )
 //          {
 //            return EE_ERASE_ERROR;
 //          }
+          /* On a flash ownership timeout, EE_Init can be called again */
           if ( FD_EraseSectors( EE_FLASH_PAGE( pv, page ), 1) != 0 )
           {
             return EE_ERASE_ERROR;
@@ -479,38 +525,36 @@ static int EE_Transfer( EE_var_t* pv, uint16_t addr, uint32_t page )
   /* Input "page" is the first page of the new pool;
      We compute "last_page" as the last page of the old pool to be set
      in ERASING state (all pages in old pool are assumed to be either VALID
-     or ACTIVE, except in case of recovery, where some pages may be already
-     in ERASING state.
-     However, in case of recovery, we do not not need to set ERASING,
-     as initialization phase erases the unactive pool. */
+     or ACTIVE, except when a transfer is resumed, where some pages may be
+     already in ERASING state). */
   last_page =
     (page < pv->nb_pages) ? (2 * pv->nb_pages - 1) : (pv->nb_pages - 1);
 
-  if ( addr != EE_TAG )
+  /* Loop on all old pool pages in descending order; the pages are also set
+     in ERASING state when the transfer is resumed, so that EE_Clean accepts
+     to erase them */
+  page = last_page;
+  while ( 1 )
   {
-    /* Loop on all old pool pages in descending order */
-    page = last_page;
-    while ( 1 )
-    {
-      state = EE_GetState( pv, page );
+    state = EE_GetState( pv, page );
 
-      if ( (state == EE_STATE_ACTIVE) || (state == EE_STATE_VALID) )
+    if ( (state == EE_STATE_ACTIVE) || (state == EE_STATE_VALID) )
+    {
+      /* Set page state to ERASING */
+      if ( EE_SetState( pv, page, EE_STATE_ERASING ) != EE_OK )
       {
-        /* Set page state to ERASING */
-        if ( EE_SetState( pv, page, EE_STATE_ERASING ) != EE_OK )
-        {
-          return EE_WRITE_ERROR;
-        }
+        EE_Discard( pv );
+        return EE_WRITE_ERROR;
       }
+    }
 
-      EE_DBG( EE_6 );
+    EE_DBG( EE_6 );
 
-      /* Check if start of pool is reached */
-      if ( (page == 0) || (page == pv->nb_pages) )
-        break;
+    /* Check if start of pool is reached */
+    if ( (page == 0) || (page == pv->nb_pages) )
+      break;
 
-      page--;
-    }
+    page--;
   }
 
   /* Now, we can copy variables from one pool to the other */
@@ -529,22 +573,32 @@ static int EE_Transfer( EE_var_t* pv, uint16_t addr, uint32_t page )
         EE_DBG( EE_7 );
 
         /* In case variable corresponding to the virtual address was found,
-           copy the variable to the new active page */
-        if ( EE_WriteEl( pv, var, data ) != EE_OK )
+           copy the variable to the new active page; consecutive elements
+           are staged to be written together */
+        if ( EE_WriteEl( pv, var, data, 1 ) != EE_OK )
         {
+          EE_Discard( pv );
           return EE_WRITE_ERROR;
         }
       }
     }
   }
 
+  /* Write the elements still staged before changing the page state */
+  if ( FD_FlushData() != 0 )
+  {
+    EE_Discard( pv );
+    return EE_WRITE_ERROR;
+  }
+
   /* Transfer is now done, mark the receive state page as active */
   return EE_SetState( pv, pv->current_write_page, EE_STATE_ACTIVE );
 }
 
 /*****************************************************************************/
 
-static int EE_WriteEl( EE_var_t* pv, uint16_t addr, uint32_t data )
+static int EE_WriteEl( EE_var_t* pv, uint16_t addr, uint32_t data,
+                       int stage )
 {
   uint32_t page, flash_addr;
   uint64_t el;
@@ -555,12 +609,20 @@ static int EE_WriteEl( EE_var_t* pv, uint16_t addr, uint32_t data )
   /* Check if active page is full */
   if ( pv->next_write_offset >= HW_FLASH_PAGE_SIZE )
   {
+    /* Write the elements still staged before changing the page state */
+    if ( FD_FlushData() != 0 )
+    {
+      EE_Discard( pv );
+      return EE_WRITE_ERROR;
+    }
+
     /* Get current active page */
     page = pv->current_write_page;
 
     /* Set new page as was previous one (active or receive) */
     if ( EE_SetState( pv, page + 1, EE_GetState( pv, page ) ) != EE_OK )
     {
+      EE_Discard( pv );
       return EE_WRITE_ERROR;
     }
 
@@ -569,6 +631,7 @@ static int EE_WriteEl( EE_var_t* pv, uint16_t addr, uint32_t data )
     /* Set current page in valid state */
     if ( EE_SetState( pv, page, EE_STATE_VALID ) != EE_OK )
     {
+      EE_Discard( pv );
       return EE_WRITE_ERROR;
     }
 
@@ -599,8 +662,20 @@ static int EE_WriteEl( EE_var_t* pv, uint16_t addr, uint32_t data )
 //    return EE_WRITE_ERROR;
 //  }
 
-  if ( FD_WriteData( flash_addr, &el, 1 ) != 0 )
+  if ( stage )
   {
+    /* Only stage the element, it is written with the following ones */
+    if ( FD_StageData( flash_addr, el ) != 0 )
+    {
+      EE_Discard( pv );
+      return EE_WRITE_ERROR;
+    }
+  }
+  /* On a flash ownership timeout, the element is not written and the write
+     offset is not moved: the element may be written again */
+  else if ( FD_WriteData( flash_addr, &el, 1 ) != 0 )
+  {
+    EE_Discard( pv );
     return EE_WRITE_ERROR;
   }
 
@@ -613,6 +688,27 @@ static int EE_WriteEl( EE_var_t* pv, uint16_t addr, uint32_t data )
 
 /*****************************************************************************/
 
+static void EE_Discard( EE_var_t* pv )
+{
+  uint32_t flash_addr;
+
+  /* Drop the elements still staged in the flash driver */
+  FD_DiscardData();
+
+  /* The write offset has been moved for the staged elements: move it back
+     after the last element actually written in the current page */
+  flash_addr = EE_FLASH_ADDR( pv, pv->current_write_page );
+  while ( (pv->next_write_offset > EE_HEADER_SIZE) &&
+          (*EE_PTR( flash_addr + pv->next_write_offset - HW_FLASH_WIDTH ) ==
+           EE_ERASED) )
+  {
+    pv->next_write_offset -= HW_FLASH_WIDTH;
+    pv->nb_written_elements--;
+  }
+}
+
+/*****************************************************************************/
+
 static int EE_ReadEl( const EE_var_t* pv,
                       uint16_t addr, uint32_t* data, uint32_t page )
 {
@@ -663,6 +759,11 @@ static int EE_SetState( const EE_var_t* pv, uint32_t page, uint32_t state )
 
   flash_addr = EE_FLASH_ADDR( pv, page ) + ((state - 1) * HW_FLASH_WIDTH);
 
+  /* The state is already set when a previous call failed after setting it:
+     a programmed header word shall not be programmed again */
+  if ( *EE_PTR( flash_addr ) != EE_ERASED )
+    return EE_OK;
+
   EE_DBG( EE_0 );
 
   /* Set new page state inside page header */
@@ -671,6 +772,8 @@ static int EE_SetState( const EE_var_t* pv, uint32_t page, uint32_t state )
 //    return EE_WRITE_ERROR;
 //  }
 
+  /* On a flash ownership timeout, the state is not set: the operation that
+     failed may be called again, the states already set are skipped */
   uint64_t data = EE_PROGRAMMED;
   if ( FD_WriteData( flash_addr, &data, 1 ) != 0 )
   {
@@ -21,6 +21,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "app_common.h"
 #include "hw_conf.h"
+#include "app_bench.h"
 
 /* Private typedef -----------------------------------------------------------*/
 typedef enum
@@ -729,6 +730,8 @@ void HW_TS_Stop(uint8_t timer_id)
   uint32_t primask_bit;
 #endif
 
+  APP_BENCH_START(BENCH_TS_STOP);
+
 #if (CFG_HW_TS_USE_PRIMASK_AS_CRITICAL_SECTION == 1)
   primask_bit = __get_PRIMASK();  /**< backup PRIMASK bit */
   __disable_irq();          /**< Disable all interrupts by setting PRIMASK bit on Cortex*/
@@ -790,6 +793,8 @@ void HW_TS_Stop(uint8_t timer_id)
   __set_PRIMASK(primask_bit); /**< Restore PRIMASK bit*/
 #endif
 
+  APP_BENCH_STOP(BENCH_TS_STOP);
+
   return;
 }
 
@@ -802,6 +807,8 @@ void HW_TS_Start(uint8_t timer_id, uint32_t timeout_ticks)
   uint32_t primask_bit;
 #endif
 
+  APP_BENCH_START(BENCH_TS_START);
+
   if(aTimerContext[timer_id].TimerIDStatus == TimerID_Running)
   {
     HW_TS_Stop( timer_id );
@@ -844,6 +851,8 @@ void HW_TS_Start(uint8_t timer_id, uint32_t timeout_ticks)
   __set_PRIMASK(primask_bit); /**< Restore PRIMASK bit*/
 #endif
 
+  APP_BENCH_STOP(BENCH_TS_START);
+
   return;
 }
 
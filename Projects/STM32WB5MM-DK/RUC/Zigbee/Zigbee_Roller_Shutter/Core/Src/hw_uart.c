@@ -34,6 +34,15 @@ extern UART_HandleTypeDef huart1;
             HAL_UART_Receive_IT(&(__HANDLE__), p_data, size);                                       \
         } while(0)
 
+#define HW_UART_RX_TOIDLE_DMA(__HANDLE__, __USART_BASE__)                                           \
+        do{                                                                                         \
+            HW_##__HANDLE__##RxEvtCb = cb;                                                          \
+            HW_##__HANDLE__##RxEvtData = p_data;                                                    \
+            HW_##__HANDLE__##RxEvtSize = size;                                                      \
+            (__HANDLE__).Instance = (__USART_BASE__);                                               \
+            hal_status = HAL_UARTEx_ReceiveToIdle_DMA(&(__HANDLE__), p_data, size);                 \
+        } while(0)
+
 #define HW_UART_TX_IT(__HANDLE__, __USART_BASE__)                                                   \
         do{                                                                                         \
             HW_##__HANDLE__##TxCb = cb;                                                             \
@@ -54,6 +63,11 @@ extern UART_HandleTypeDef huart1;
 #endif
     void (*HW_huart1RxCb)(void);
     void (*HW_huart1TxCb)(void);
+#if (CFG_HW_USART1_DMA_RX_SUPPORTED == 1)
+    void (*HW_huart1RxEvtCb)(uint16_t pos);
+    uint8_t *HW_huart1RxEvtData;
+    uint16_t HW_huart1RxEvtSize;
+#endif
 #endif
 
 #if (CFG_HW_LPUART1_ENABLED == 1)
@@ -62,6 +76,11 @@ extern UART_HandleTypeDef huart1;
 #endif
     void (*HW_hlpuart1RxCb)(void);
     void (*HW_hlpuart1TxCb)(void);
+#if (CFG_HW_LPUART1_DMA_RX_SUPPORTED == 1)
+    void (*HW_hlpuart1RxEvtCb)(uint16_t pos);
+    uint8_t *HW_hlpuart1RxEvtData;
+    uint16_t HW_hlpuart1RxEvtSize;
+#endif
 #endif
 
 void HW_UART_Receive_IT(hw_uart_id_t hw_uart_id, uint8_t *p_data, uint16_t size, void (*cb)(void))
@@ -87,6 +106,55 @@ void HW_UART_Receive_IT(hw_uart_id_t hw_uart_id, uint8_t *p_data, uint16_t size,
     return;
 }
 
+hw_status_t HW_UART_Receive_ToIdle_DMA(hw_uart_id_t hw_uart_id, uint8_t *p_data, uint16_t size, void (*cb)(uint16_t pos))
+{
+    HAL_StatusTypeDef hal_status = HAL_OK;
+    hw_status_t hw_status = hw_uart_ok;
+
+    switch (hw_uart_id)
+    {
+#if (CFG_HW_USART1_ENABLED == 1) && (CFG_HW_USART1_DMA_RX_SUPPORTED == 1)
+        case hw_uart1:
+            HW_UART_RX_TOIDLE_DMA(huart1, USART1);
+            break;
+#endif
+
+#if (CFG_HW_LPUART1_ENABLED == 1) && (CFG_HW_LPUART1_DMA_RX_SUPPORTED == 1)
+        case hw_lpuart1:
+            HW_UART_RX_TOIDLE_DMA(hlpuart1, LPUART1);
+            break;
+#endif
+
+        default:
+            hal_status = HAL_ERROR;
+            break;
+    }
+
+    switch (hal_status)
+    {
+        case HAL_OK:
+            hw_status = hw_uart_ok;
+            break;
+
+        case HAL_ERROR:
+            hw_status = hw_uart_error;
+            break;
+
+        case HAL_BUSY:
+            hw_status = hw_uart_busy;
+            break;
+
+        case HAL_TIMEOUT:
+            hw_status = hw_uart_to;
+            break;
+
+        default:
+            break;
+    }
+
+    return hw_status;
+}
+
 void HW_UART_Transmit_IT(hw_uart_id_t hw_uart_id, uint8_t *p_data, uint16_t size,  void (*cb)(void))
 {
     switch (hw_uart_id)
@@ -313,3 +381,72 @@ void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
 
     return;
 }
+
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    switch ((uint32_t)huart->Instance)
+    {
+#if (CFG_HW_USART1_ENABLED == 1) && (CFG_HW_USART1_DMA_RX_SUPPORTED == 1)
+        case (uint32_t)USART1:
+            if(HW_huart1RxEvtCb)
+            {
+                HW_huart1RxEvtCb(Size);
+            }
+            break;
+#endif
+
+#if (CFG_HW_LPUART1_ENABLED == 1) && (CFG_HW_LPUART1_DMA_RX_SUPPORTED == 1)
+        case (uint32_t)LPUART1:
+            if(HW_hlpuart1RxEvtCb)
+            {
+                HW_hlpuart1RxEvtCb(Size);
+            }
+            break;
+#endif
+
+        default:
+            break;
+    }
+
+    return;
+}
+
+/**
+ * An overrun aborts the DMA reception. The circular reception is restarted from the
+ * start of the buffer and the owner is told so, the other errors keep the reception running.
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    if (huart->RxState != HAL_UART_STATE_READY)
+    {
+        return;
+    }
+
+    switch ((uint32_t)huart->Instance)
+    {
+#if (CFG_HW_USART1_ENABLED == 1) && (CFG_HW_USART1_DMA_RX_SUPPORTED == 1)
+        case (uint32_t)USART1:
+            if(HW_huart1RxEvtCb)
+            {
+                HAL_UARTEx_ReceiveToIdle_DMA(&huart1, HW_huart1RxEvtData, HW_huart1RxEvtSize);
+                HW_huart1RxEvtCb(HW_UART_RX_RESTART);
+            }
+            break;
+#endif
+
+#if (CFG_HW_LPUART1_ENABLED == 1) && (CFG_HW_LPUART1_DMA_RX_SUPPORTED == 1)
+        case (uint32_t)LPUART1:
+            if(HW_hlpuart1RxEvtCb)
+            {
+                HAL_UARTEx_ReceiveToIdle_DMA(&hlpuart1, HW_hlpuart1RxEvtData, HW_hlpuart1RxEvtSize);
+                HW_hlpuart1RxEvtCb(HW_UART_RX_RESTART);
+            }
+            break;
+#endif
+
+        default:
+            break;
+    }
+
+    return;
+}
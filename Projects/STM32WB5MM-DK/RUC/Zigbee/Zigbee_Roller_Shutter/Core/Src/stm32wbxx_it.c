@@ -21,6 +21,7 @@
 
 /* Private includes ----------------------------------------------------------*/
 #include "stm32wb5mm_dk.h"
+#include "stm32wb5mm_dk_bus.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -33,6 +34,7 @@ extern void END_SENSOR_BOT_EXTI_Callback(void);
 /* External variables --------------------------------------------------------*/
 extern IPCC_HandleTypeDef hipcc;
 extern DMA_HandleTypeDef  hdma_usart1_tx;
+extern DMA_HandleTypeDef  hdma_usart1_rx;
 extern UART_HandleTypeDef huart1;
 
 /******************************************************************************/
@@ -178,6 +180,22 @@ void DMA2_Channel4_IRQHandler(void)
   HAL_DMA_IRQHandler(&hdma_usart1_tx);
 }
 
+/**
+ * @brief This function handles DMA2 channel5 global interrupt (USART1 Rx).
+ */
+void DMA2_Channel5_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_usart1_rx);
+}
+
+/**
+ * @brief This function handles DMA1 channel2 global interrupt (LCD SPI1 Tx).
+ */
+void DMA1_Channel2_IRQHandler(void)
+{
+  BSP_SPI1_DMA_IRQHandler();
+}
+
 /**
  * @brief This function handles PWR switching on the fly, end of BLE activity, end of 802.15.4 activity, end of critical radio phase interrupt.
  */
@@ -238,4 +256,15 @@ void RTC_WKUP_IRQHandler(void)
   HW_TS_RTC_Wakeup_Handler();
 }
 
+/**
+ * @brief End of a SPI DMA transmission: SPI1 is the LCD bus of the BSP.
+ */
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+  if (hspi->Instance == BUS_SPI1_INSTANCE)
+  {
+    BSP_SPI1_TxCpltCallback();
+  }
+}
+
 /* USER CODE END 1 */
\ No newline at end of file
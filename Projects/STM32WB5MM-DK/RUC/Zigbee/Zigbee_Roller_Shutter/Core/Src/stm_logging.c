@@ -31,10 +31,41 @@
 #include <string.h>
 
 #include "app_conf.h"
+#include "stm32_seq.h"
 #include "stm_logging.h"
 
 #define LOG_PARSE_BUFFER_SIZE  256U
 
+#ifndef LOG_DEFERRED_ENABLE
+#define LOG_DEFERRED_ENABLE    0U
+#endif
+
+/* Size of the deferred log ring in 32 bits words, shall be a power of 2 */
+#ifndef LOG_DEFERRED_BUFFER_SIZE
+#define LOG_DEFERRED_BUFFER_SIZE  512U
+#endif
+
+/* When set, the records are output raw to be decoded on the host with the
+ * addresses of the format strings in the image */
+#ifndef LOG_DEFERRED_RAW
+#define LOG_DEFERRED_RAW       0U
+#endif
+
+#define LOG_DEFERRED_ARG_MAX      8U
+#define LOG_DEFERRED_ARG_INVALID  0xFFU
+
+/* Record : header, tick, format, file name then the arguments */
+#define LOG_DEFERRED_HEADER_SIZE  4U
+#define LOG_DEFERRED_MAGIC        0xA5000000UL
+#define LOG_DEFERRED_MAGIC_MASK   0xFF000000UL
+#define LOG_DEFERRED_LEVEL_POS    16U
+#define LOG_DEFERRED_REGION_POS   8U
+#define LOG_DEFERRED_ARG_NB_MASK  0xFFUL
+
+#if ((LOG_DEFERRED_BUFFER_SIZE & (LOG_DEFERRED_BUFFER_SIZE - 1U)) != 0U)
+#error "LOG_DEFERRED_BUFFER_SIZE shall be a power of 2"
+#endif
+
 #define LOG_TIMESTAMP_ENABLE 0
 #define LOG_REGION_ENABLE 1U
 #define LOG_RTT_COLOR_ENABLE 1U
@@ -54,6 +85,50 @@
 #define RTT_COLOR_CODE_CYAN    ""
 #endif /* LOG_RTT_COLOR_ENABLE == 1 */
 
+/* Level of the Zigbee stack logs, LOG_LEVEL_DEBG matches ZB_LOG_MASK_LEVEL_5 */
+#ifndef APPLI_CONFIG_ZB_LOG_LEVEL
+#define APPLI_CONFIG_ZB_LOG_LEVEL  LOG_LEVEL_DEBG
+#endif
+
+/* Runtime level per region, checked by the macros before any formatting */
+appliLogLevel_t logRegionLevel[APPLI_LOG_REGION_NB] =
+{
+  APPLI_CONFIG_LOG_LEVEL,       /* No region */
+  APPLI_CONFIG_LOG_LEVEL,       /* APPLI_LOG_REGION_GENERAL */
+  APPLI_CONFIG_ZB_LOG_LEVEL,    /* APPLI_LOG_REGION_ZIGBEE_API */
+};
+
+/**
+ * Function for getting the runtime level of a region.
+ *
+ * @param[in]     aLogRegion  The region ID.
+ *
+ * @returns  Level of the region, LOG_LEVEL_NONE for an unknown region.
+ */
+appliLogLevel_t logGetLevel(appliLogRegion_t aLogRegion)
+{
+  if ((uint32_t)aLogRegion >= APPLI_LOG_REGION_NB)
+  {
+    return LOG_LEVEL_NONE;
+  }
+  return logRegionLevel[aLogRegion];
+}
+
+/**
+ * Function for changing the runtime level of a region.
+ *
+ * @param[in]     aLogRegion  The region ID.
+ * @param[in]     aLogLevel   New level, the logs above it are discarded before formatting.
+ */
+void logSetLevel(appliLogRegion_t aLogRegion, appliLogLevel_t aLogLevel)
+{
+  if (((uint32_t)aLogRegion >= APPLI_LOG_REGION_NB) || (aLogLevel > LOG_LEVEL_DEBG))
+  {
+    return;
+  }
+  logRegionLevel[aLogRegion] = aLogLevel;
+}
+
 #if (CFG_DEBUG_TRACE != 0)
 /**
  * Function for outputting code region string.
@@ -149,53 +224,424 @@ static inline uint16_t logTimestamp(char *aLogString, uint16_t aMaxSize)
 }
 #endif /* LOG_TIMESTAMP_ENABLE */
 
+#if (CFG_DEBUG_TRACE != 0)
 /**
- * Function for printing application log
+ * Function for printing the prefix of a log line.
  *
+ * @param[inout]  aLogString  Pointer to log buffer.
+ * @param[in]     aMaxSize    Maximum size of log buffer.
  * @param[in]     aLogLevel   Log level.
  * @param[in]     aLogRegion  The region ID.
- * @param[in]     aFormat     User string format.
+ * @param[in]     aFile       Source file of the log (APP_ZB_DBG), NULL for logApplication.
  *
- * @returns  Number of bytes successfully written to the log buffer.
+ * @returns  Number of bytes written to the log buffer.
  */
-void logApplication(appliLogLevel_t aLogLevel, appliLogRegion_t aLogRegion, const char *aFormat, ...)
+static uint16_t logPrefix(char *aLogString, uint16_t aMaxSize, appliLogLevel_t aLogLevel,
+                          appliLogRegion_t aLogRegion, const char *aFile)
 {
-#if (CFG_DEBUG_TRACE != 0) /* Since the traces are disabled, there is nothing to print */
   uint16_t length = 0;
-  char logString[LOG_PARSE_BUFFER_SIZE + 1U];
+
+  if (aFile != NULL)
+  {
+    /* Same prefix as the synchronous APP_ZB_DBG */
+    const char *name = DbgTraceGetFileName(aFile);
+    size_t i;
+
+    length += snprintf(aLogString, aMaxSize, "[M4 APPLICATION] \x1b[38;5;%dm[",
+                       ((name[4] + name[5] * 8) % 115) + 117);
+    for (i = 0; (i + 2U < strlen(name)) && (length < aMaxSize - 1U); i++)
+    {
+      aLogString[length++] = (char)toupper((int)name[i]);
+    }
+    length += snprintf(&aLogString[length], (aMaxSize - length), "]\x1B[m ");
+    return length;
+  }
 
 #if (LOG_TIMESTAMP_ENABLE == 1U)
-  length += logTimestamp(logString, LOG_PARSE_BUFFER_SIZE);
+  length += logTimestamp(aLogString, aMaxSize);
 #endif
 
 #if (LOG_RTT_COLOR_ENABLE == 1U)
   /* Add level information */
-  length += logLevel(&logString[length], (LOG_PARSE_BUFFER_SIZE - length),
-      aLogLevel);
+  length += logLevel(&aLogString[length], (aMaxSize - length), aLogLevel);
 #endif
 
 #if (LOG_REGION_ENABLE == 1U)
   /* Add Region information */
-  length += logRegion(&logString[length], (LOG_PARSE_BUFFER_SIZE - length),
-      aLogRegion);
+  length += logRegion(&aLogString[length], (aMaxSize - length), aLogRegion);
 #endif
 
+  return length;
+}
+
+/**
+ * Function for formatting and printing a log line at once.
+ *
+ * @param[in]     aLogLevel   Log level.
+ * @param[in]     aLogRegion  The region ID.
+ * @param[in]     aFile       Source file of the log, NULL for logApplication.
+ * @param[in]     aFormat     User string format.
+ * @param[in]     aParamList  User arguments.
+ */
+static void logOutput(appliLogLevel_t aLogLevel, appliLogRegion_t aLogRegion,
+                      const char *aFile, const char *aFormat, va_list aParamList)
+{
+  uint16_t length;
+  char logString[LOG_PARSE_BUFFER_SIZE + 3U];
+
+  length = logPrefix(logString, LOG_PARSE_BUFFER_SIZE, aLogLevel, aLogRegion, aFile);
+
   /* Parse user string */
-  va_list paramList;
-  va_start(paramList, aFormat);
-  length += vsnprintf(&logString[length], (LOG_PARSE_BUFFER_SIZE - length),
-      aFormat, paramList);
-  logString[length++] = '\r';
+  if (length < LOG_PARSE_BUFFER_SIZE)
+  {
+    length += vsnprintf(&logString[length], (LOG_PARSE_BUFFER_SIZE - length),
+        aFormat, aParamList);
+  }
+  if (length > (LOG_PARSE_BUFFER_SIZE - 1U))
+  {
+    length = LOG_PARSE_BUFFER_SIZE - 1U;
+  }
+  if (aFile == NULL)
+  {
+    logString[length++] = '\r';
+  }
   logString[length++] = '\n';
   logString[length++] = 0;
-  va_end(paramList);
 
-  if (aLogLevel <= APPLI_CONFIG_LOG_LEVEL)
+  printf("%s", logString);
+}
+#endif /* CFG_DEBUG_TRACE */
+
+#if (LOG_DEFERRED_ENABLE == 1U) && (CFG_DEBUG_TRACE != 0)
+static uint32_t          log_ring[LOG_DEFERRED_BUFFER_SIZE];
+static volatile uint32_t log_head;      /* Next word to reserve */
+static volatile uint32_t log_tail;      /* Next word to read */
+static volatile uint32_t log_lost;      /* Records dropped on a full ring */
+static volatile uint8_t  log_flushing;
+
+/**
+ * Function for counting the arguments of a format string.
+ *
+ * @param[in]     aFormat     User string format.
+ *
+ * @returns  Number of 32 bits arguments, LOG_DEFERRED_ARG_INVALID when an
+ *           argument cannot be deferred (string, 64 bits or floating point).
+ */
+static uint32_t logDeferredArgCount(const char *aFormat)
+{
+  uint32_t count = 0;
+  const char *p = aFormat;
+
+  while (*p != '\0')
   {
-    printf("%s", logString);
-  }else
+    if (*p++ != '%')
+    {
+      continue;
+    }
+    if (*p == '%')
+    {
+      p++;
+      continue;
+    }
+
+    /* Flags, width, precision and length */
+    while ((*p != '\0') && (strchr("-+ #0123456789.*hlzt", *p) != NULL))
+    {
+      if (*p == '*')
+      {
+        count++;
+      }
+      else if ((*p == 'l') && (p[1] == 'l'))
+      {
+        return LOG_DEFERRED_ARG_INVALID;
+      }
+      p++;
+    }
+
+    /* The pointed strings may not be valid anymore when formatted */
+    if ((*p == '\0') || (strchr("diouxXcp", *p) == NULL))
+    {
+      return LOG_DEFERRED_ARG_INVALID;
+    }
+    count++;
+    p++;
+  }
+
+  return (count <= LOG_DEFERRED_ARG_MAX) ? count : LOG_DEFERRED_ARG_INVALID;
+}
+
+/**
+ * Function for adding to a counter shared with interrupts.
+ *
+ * @param[in]     aCounter    Counter to update.
+ * @param[in]     aValue      Value to add, modulo 32 bits.
+ */
+static void logDeferredAdd(volatile uint32_t *aCounter, uint32_t aValue)
+{
+  uint32_t value;
+
+  do
   {
-    /* Print nothing */
+    value = __LDREXW((uint32_t *)aCounter);
+  } while (__STREXW(value + aValue, (uint32_t *)aCounter) != 0U);
+}
+
+/**
+ * Function for recording a log in the ring.
+ * Lock-free, can be called from interrupts : the space is reserved with an
+ * exclusive access then the record is committed by writing its header last.
+ *
+ * @param[in]     aHeader     Record header.
+ * @param[in]     aFile       Source file of the log.
+ * @param[in]     aFormat     User string format.
+ * @param[in]     aArgNb      Number of arguments.
+ * @param[in]     aParamList  User arguments.
+ */
+static void logDeferredWrite(uint32_t aHeader, const char *aFile, const char *aFormat,
+                             uint32_t aArgNb, va_list aParamList)
+{
+  uint32_t size = LOG_DEFERRED_HEADER_SIZE + aArgNb;
+  uint32_t head;
+  uint32_t i;
+
+  do
+  {
+    head = __LDREXW((uint32_t *)&log_head);
+    if ((head - log_tail + size) > LOG_DEFERRED_BUFFER_SIZE)
+    {
+      __CLREX();
+      logDeferredAdd(&log_lost, 1U);
+      return;
+    }
+  } while (__STREXW(head + size, (uint32_t *)&log_head) != 0U);
+
+  log_ring[(head + 1U) % LOG_DEFERRED_BUFFER_SIZE] = HAL_GetTick();
+  log_ring[(head + 2U) % LOG_DEFERRED_BUFFER_SIZE] = (uint32_t)aFormat;
+  log_ring[(head + 3U) % LOG_DEFERRED_BUFFER_SIZE] = (uint32_t)aFile;
+  for (i = 0; i < aArgNb; i++)
+  {
+    log_ring[(head + LOG_DEFERRED_HEADER_SIZE + i) % LOG_DEFERRED_BUFFER_SIZE] = va_arg(aParamList, uint32_t);
   }
+
+  /* Commit the record */
+  __DMB();
+  log_ring[head % LOG_DEFERRED_BUFFER_SIZE] = aHeader;
+
+  UTIL_SEQ_SetTask(1U << CFG_TASK_LOG_FLUSH, CFG_SCH_PRIO_1);
+}
+
+/**
+ * Function for formatting a recorded log.
+ *
+ * @param[in]     aHeader     Record header.
+ * @param[in]     aTick       Tick (ms) of the log.
+ * @param[in]     aFormat     User string format.
+ * @param[in]     aFile       Source file of the log.
+ * @param[in]     aArgs       Recorded arguments.
+ */
+static void logDeferredOutput(uint32_t aHeader, uint32_t aTick, const char *aFormat,
+                              const char *aFile, const uint32_t *aArgs)
+{
+#if (LOG_DEFERRED_RAW == 1U)
+  uint32_t i;
+
+  printf("$%08lx %08lx %08lx %08lx", aHeader, aTick, (uint32_t)aFormat, (uint32_t)aFile);
+  for (i = 0; i < (aHeader & LOG_DEFERRED_ARG_NB_MASK); i++)
+  {
+    printf(" %08lx", aArgs[i]);
+  }
+  printf("\r\n");
+#else
+  uint16_t length;
+  char logString[LOG_PARSE_BUFFER_SIZE + 3U];
+
+  UNUSED(aTick);
+
+  length = logPrefix(logString, LOG_PARSE_BUFFER_SIZE,
+                     (appliLogLevel_t)((aHeader >> LOG_DEFERRED_LEVEL_POS) & 0x0FU),
+                     (appliLogRegion_t)((aHeader >> LOG_DEFERRED_REGION_POS) & 0xFFU), aFile);
+
+  /* Unused arguments are ignored by the format */
+  if (length < LOG_PARSE_BUFFER_SIZE)
+  {
+    length += snprintf(&logString[length], (LOG_PARSE_BUFFER_SIZE - length), aFormat,
+                       aArgs[0], aArgs[1], aArgs[2], aArgs[3], aArgs[4], aArgs[5], aArgs[6], aArgs[7]);
+  }
+  if (length > (LOG_PARSE_BUFFER_SIZE - 1U))
+  {
+    length = LOG_PARSE_BUFFER_SIZE - 1U;
+  }
+  if (aFile == NULL)
+  {
+    logString[length++] = '\r';
+  }
+  logString[length++] = '\n';
+  logString[length++] = 0;
+
+  printf("%s", logString);
+#endif /* LOG_DEFERRED_RAW */
+}
+#endif /* LOG_DEFERRED_ENABLE && CFG_DEBUG_TRACE */
+
+/**
+ * Function for initializing the deferred logging.
+ */
+void logDeferredInit(void)
+{
+#if (LOG_DEFERRED_ENABLE == 1U) && (CFG_DEBUG_TRACE != 0)
+  UTIL_SEQ_RegTask(1U << CFG_TASK_LOG_FLUSH, UTIL_SEQ_RFU, logDeferredFlush);
+#endif
+}
+
+/**
+ * Function for formatting and printing the recorded logs.
+ * Called from the lowest priority task, or before a synchronous log to keep the order.
+ */
+void logDeferredFlush(void)
+{
+#if (LOG_DEFERRED_ENABLE == 1U) && (CFG_DEBUG_TRACE != 0)
+  uint32_t tail, header, size, lost, i;
+  uint32_t tick;
+  const char *format;
+  const char *file;
+  uint32_t args[LOG_DEFERRED_ARG_MAX];
+
+  /* Not reentrant, a log from an interrupt may flush */
+  if (log_flushing != 0U)
+  {
+    return;
+  }
+  log_flushing = 1U;
+
+  lost = log_lost;
+  if (lost != 0U)
+  {
+    logDeferredAdd(&log_lost, 0U - lost);
+    printf("%lu deferred logs lost\r\n", lost);
+  }
+
+  tail = log_tail;
+  while (tail != log_head)
+  {
+    header = log_ring[tail % LOG_DEFERRED_BUFFER_SIZE];
+    if ((header & LOG_DEFERRED_MAGIC_MASK) != LOG_DEFERRED_MAGIC)
+    {
+      /* Reserved but not yet committed, flushed on its commit */
+      break;
+    }
+    __DMB();
+
+    size   = LOG_DEFERRED_HEADER_SIZE + (header & LOG_DEFERRED_ARG_NB_MASK);
+    tick   = log_ring[(tail + 1U) % LOG_DEFERRED_BUFFER_SIZE];
+    format = (const char *)log_ring[(tail + 2U) % LOG_DEFERRED_BUFFER_SIZE];
+    file   = (const char *)log_ring[(tail + 3U) % LOG_DEFERRED_BUFFER_SIZE];
+    for (i = 0; i < LOG_DEFERRED_ARG_MAX; i++)
+    {
+      args[i] = (i < (header & LOG_DEFERRED_ARG_NB_MASK)) ?
+                log_ring[(tail + LOG_DEFERRED_HEADER_SIZE + i) % LOG_DEFERRED_BUFFER_SIZE] : 0U;
+    }
+
+    logDeferredOutput(header, tick, format, file, args);
+
+    /* Clear the record so that a reserved space is never seen as committed */
+    for (i = 0; i < size; i++)
+    {
+      log_ring[(tail + i) % LOG_DEFERRED_BUFFER_SIZE] = 0U;
+    }
+    tail += size;
+    __DMB();
+    log_tail = tail;
+  }
+
+  log_flushing = 0U;
+#endif /* LOG_DEFERRED_ENABLE && CFG_DEBUG_TRACE */
+}
+
+#if (CFG_DEBUG_TRACE != 0)
+/**
+ * Function for recording a log, or printing it at once when it cannot be deferred.
+ *
+ * @param[in]     aLogLevel   Log level.
+ * @param[in]     aLogRegion  The region ID.
+ * @param[in]     aFile       Source file of the log, NULL for logApplication.
+ * @param[in]     aFormat     User string format.
+ * @param[in]     aParamList  User arguments.
+ */
+static void logDispatch(appliLogLevel_t aLogLevel, appliLogRegion_t aLogRegion,
+                        const char *aFile, const char *aFormat, va_list aParamList)
+{
+#if (LOG_DEFERRED_ENABLE == 1U)
+  uint32_t argNb = logDeferredArgCount(aFormat);
+
+  if (argNb != LOG_DEFERRED_ARG_INVALID)
+  {
+    logDeferredWrite(LOG_DEFERRED_MAGIC | ((uint32_t)aLogLevel << LOG_DEFERRED_LEVEL_POS) |
+                     ((uint32_t)aLogRegion << LOG_DEFERRED_REGION_POS) | argNb,
+                     aFile, aFormat, argNb, aParamList);
+  }
+  else
+  {
+    /* Keep the order with the recorded logs */
+    logDeferredFlush();
+    logOutput(aLogLevel, aLogRegion, aFile, aFormat, aParamList);
+  }
+#else
+  logOutput(aLogLevel, aLogRegion, aFile, aFormat, aParamList);
+#endif /* LOG_DEFERRED_ENABLE */
+}
+#endif /* CFG_DEBUG_TRACE */
+
+/**
+ * Function for printing a log with a deferred formatting.
+ * The format string and the 32 bits arguments are recorded, the line is
+ * formatted later by logDeferredFlush(). Strings, 64 bits and floating point
+ * arguments are formatted at once, after the recorded logs.
+ *
+ * @param[in]     aLogLevel   Log level.
+ * @param[in]     aLogRegion  The region ID.
+ * @param[in]     aFile       Source file of the log (__FILE__), NULL for logApplication.
+ * @param[in]     aFormat     User string format, shall be a constant string.
+ */
+void logDeferred(appliLogLevel_t aLogLevel, appliLogRegion_t aLogRegion, const char *aFile,
+                 const char *aFormat, ...)
+{
+#if (CFG_DEBUG_TRACE != 0) /* Since the traces are disabled, there is nothing to print */
+  va_list paramList;
+
+  /* Filter before any formatting or recording */
+  if (!LOG_IS_ENABLED(aLogLevel, aLogRegion))
+  {
+    return;
+  }
+
+  va_start(paramList, aFormat);
+  logDispatch(aLogLevel, aLogRegion, aFile, aFormat, paramList);
+  va_end(paramList);
+#endif /* CFG_DEBUG_TRACE */
+}
+
+/**
+ * Function for printing application log
+ *
+ * @param[in]     aLogLevel   Log level.
+ * @param[in]     aLogRegion  The region ID.
+ * @param[in]     aFormat     User string format.
+ *
+ * @returns  Number of bytes successfully written to the log buffer.
+ */
+void logApplication(appliLogLevel_t aLogLevel, appliLogRegion_t aLogRegion, const char *aFormat, ...)
+{
+#if (CFG_DEBUG_TRACE != 0) /* Since the traces are disabled, there is nothing to print */
+  va_list paramList;
+
+  /* Filter before any formatting */
+  if (!LOG_IS_ENABLED(aLogLevel, aLogRegion))
+  {
+    return;
+  }
+
+  va_start(paramList, aFormat);
+  logDispatch(aLogLevel, aLogRegion, NULL, aFormat, paramList);
+  va_end(paramList);
 #endif /* CFG_DEBUG_TRACE */
 }
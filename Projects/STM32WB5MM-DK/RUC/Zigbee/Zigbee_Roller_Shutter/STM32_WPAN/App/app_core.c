@@ -25,6 +25,7 @@
 #include "app_zigbee.h"
 #include "shci.h"
 #include "stm32_seq.h"
+#include "stm32_lpm.h"
 #include "stm32wbxx_core_interface_def.h"
 
 #include "zigbee_types.h"
@@ -43,6 +44,7 @@
 #include "app_zigbee.h"
 #include "app_nvm.h"
 #include "app_menu.h"
+#include "app_console.h"
 #include "app_light_cfg.h"
 #include "app_roller_shutter_cfg.h"
 
@@ -74,10 +76,16 @@ static void App_Core_UpdateButtonState(Button_TypeDef button, int isPressed);
 static void App_Core_Name_Disp            (void);
 /* DK LCD Clean */
 static void App_Core_Display_Clean_Status (void);
+/* DK LCD Refresh */
+static void App_Core_Display_Refresh      (void);
 
 /* Others Action */
 static void App_Core_Leave_cb (struct ZbNlmeLeaveConfT *conf, void *arg);
 
+/* Log levels */
+static void App_Core_Log_Restore    (void);
+static void App_Core_Log_Next_Level (appliLogRegion_t region, const char *name);
+
 /* Functions Definition ------------------------------------------------------*/
 
 /**
@@ -88,10 +96,16 @@ void App_Core_Init(void)
 {
   APP_ZB_DBG("Initialisation");
 
+  /* Task to send the LCD frame buffer in background, first as all the displays use it */
+  UTIL_SEQ_RegTask(1U << CFG_TASK_LCD_REFRESH, UTIL_SEQ_RFU, App_Core_Display_Refresh);
+
   App_Core_Name_Disp();
 
   App_Zigbee_Init();
 
+  /* Runtime log levels saved in NVM, available once App_Zigbee_Init has loaded it */
+  App_Core_Log_Restore();
+
   /* Task associated with button Action */
   UTIL_SEQ_RegTask(1U << CFG_TASK_BUTTON_SW1, UTIL_SEQ_RFU, App_SW1_Action);
   UTIL_SEQ_RegTask(1U << CFG_TASK_BUTTON_SW2, UTIL_SEQ_RFU, App_SW2_Action);
@@ -116,6 +130,12 @@ void App_Core_Init(void)
     UTIL_LCD_DisplayStringAt(0, LINE(DK_LCD_STATUS_LINE), (uint8_t *)"Error : Menu Config", CENTER_MODE);
     BSP_LCD_Refresh(0);
   }
+
+  /* Commands and parameters from the trace UART */
+  if (Console_Config() == 0)
+  {
+    APP_ZB_DBG("Error : Console Config");
+  }
 } /* App_Core_Init */
 
 /**
@@ -160,7 +180,7 @@ static void App_Core_Name_Disp(void)
   /* Text Feature */
   BSP_LCD_Clear(0,SSD1315_COLOR_BLACK);
   UTIL_LCD_DisplayStringAt(0, LINE(DK_LCD_APP_NAME_LINE), (uint8_t *)"Zb Shutter Demo", CENTER_MODE);
-  BSP_LCD_Refresh(0);
+  App_Core_Display_Update();
 } /* App_Core_Name_Disp */
 
 /**
@@ -172,9 +192,59 @@ static void App_Core_Name_Disp(void)
 static void App_Core_Display_Clean_Status(void)
 {
   UTIL_LCD_ClearStringLine(DK_LCD_STATUS_LINE);
-  BSP_LCD_Refresh(0);
+  App_Core_Display_Update();
 } /* App_Core_Display_Clean_Status */
 
+/**
+ * @brief  Request to send the modified part of the frame buffer to the LCD
+ * Several requests before the refresh task runs are coalesced in one transfer.
+ * @param  None
+ * @retval None
+ */
+void App_Core_Display_Update(void)
+{
+  UTIL_SEQ_SetTask(1U << CFG_TASK_LCD_REFRESH, CFG_SCH_PRIO_1);
+} /* App_Core_Display_Update */
+
+/**
+ * @brief  LCD refresh task, start the DMA transfer of the modified part of the frame buffer
+ * Nothing is done while a transfer is ongoing, the end of transfer runs the task again
+ * to send what has been drawn in the meantime.
+ * @param  None
+ * @retval None
+ */
+static void App_Core_Display_Refresh(void)
+{
+  uint32_t state = 0;
+
+  /* The DMA is stopped in Stop mode, keep the MCU in Sleep until the end of transfer.
+   * Set before the start as the transfer can end before the return. */
+  UTIL_LPM_SetStopMode(1U << CFG_LPM_APP_LCD, UTIL_LPM_DISABLE);
+
+  /* When busy, the end of transfer runs this task again */
+  BSP_LCD_RefreshAsync(0);
+
+  BSP_LCD_GetRefreshState(0, &state);
+  if (state == 0U)
+  {
+    /* Nothing to send or already sent */
+    UTIL_LPM_SetStopMode(1U << CFG_LPM_APP_LCD, UTIL_LPM_ENABLE);
+  }
+} /* App_Core_Display_Refresh */
+
+/**
+ * @brief  End of the LCD DMA transfer, called under IRQ
+ * @param  Instance LCD Instance
+ * @retval None
+ */
+void BSP_LCD_RefreshCpltCallback(uint32_t Instance)
+{
+  UNUSED(Instance);
+
+  UTIL_LPM_SetStopMode(1U << CFG_LPM_APP_LCD, UTIL_LPM_ENABLE);
+  UTIL_SEQ_SetTask(1U << CFG_TASK_LCD_REFRESH, CFG_SCH_PRIO_1);
+} /* BSP_LCD_RefreshCpltCallback */
+
 /**
  * @brief Clean and refresh the global informations on the application ongoing
  * To call from the Menu when the user wants to retrevie the base informations
@@ -263,6 +333,102 @@ void App_Core_Factory_Reset(void)
   NVIC_SystemReset();
 } /* App_Core_Factory_Reset */
 
+/* Log Levels -------------------------------------------------------------- */
+static const char * const log_level_name[] = { "NONE", "CRIT", "WARN", "INFO", "DEBG" };
+
+/**
+ * @brief  Restore the runtime log levels saved in NVM
+ * A level out of range keeps the default of the region
+ * @param  None
+ * @retval None
+ */
+static void App_Core_Log_Restore(void)
+{
+  uint32_t levels;
+  uint32_t level;
+
+  if (App_NVM_Param_Read(APP_NVM_PARAM_LOG_LEVELS, &levels) == false)
+  {
+    return;
+  }
+
+  for (uint32_t region = 0; region < APPLI_LOG_REGION_NB; region++)
+  {
+    level = (levels >> (region * 4U)) & 0x0FU;
+    if (level <= LOG_LEVEL_DEBG)
+    {
+      logSetLevel((appliLogRegion_t)region, (appliLogLevel_t)level);
+    }
+  }
+} /* App_Core_Log_Restore */
+
+/**
+ * @brief  Move a log region to the next level (NONE -> ... -> DEBG -> NONE) and save it in NVM
+ * @param  region log region to update
+ * @param  name   name of the region for the display
+ * @retval None
+ */
+static void App_Core_Log_Next_Level(appliLogRegion_t region, const char *name)
+{
+  char LCD_Text[32];
+  uint32_t levels = 0;
+  appliLogLevel_t level = logGetLevel(region);
+
+  level = (level >= LOG_LEVEL_DEBG) ? LOG_LEVEL_NONE : (level + 1U);
+  logSetLevel(region, level);
+  /* The application level also applies to the logs without region */
+  if (region == APPLI_LOG_REGION_GENERAL)
+  {
+    logSetLevel((appliLogRegion_t)0U, level);
+  }
+
+  for (uint32_t i = 0; i < APPLI_LOG_REGION_NB; i++)
+  {
+    levels |= ((uint32_t)logGetLevel((appliLogRegion_t)i) & 0x0FU) << (i * 4U);
+  }
+  App_NVM_Param_Write(APP_NVM_PARAM_LOG_LEVELS, levels);
+
+  /* Always displayed, whatever the new level */
+  APP_DBG("%s log level : %s", name, log_level_name[level]);
+  sprintf(LCD_Text, "%s Log : %s", name, log_level_name[level]);
+  UTIL_LCD_ClearStringLine(DK_LCD_STATUS_LINE);
+  UTIL_LCD_DisplayStringAt(0, LINE(DK_LCD_STATUS_LINE), (uint8_t *)LCD_Text, CENTER_MODE);
+  App_Core_Display_Update();
+  UTIL_SEQ_SetTask(1U << CFG_TASK_LCD_CLEAN_STATUS, CFG_SCH_PRIO_1);
+} /* App_Core_Log_Next_Level */
+
+/**
+ * @brief  Display the runtime log levels
+ * @param  None
+ * @retval None
+ */
+void App_Core_Log_Disp(void)
+{
+  APP_DBG("App log level : %s", log_level_name[logGetLevel(APPLI_LOG_REGION_GENERAL)]);
+  APP_DBG("ZB log level  : %s", log_level_name[logGetLevel(APPLI_LOG_REGION_ZIGBEE_API)]);
+} /* App_Core_Log_Disp */
+
+/**
+ * @brief  Change the level of the application logs, called from the menu
+ * @param  None
+ * @retval None
+ */
+void App_Core_Log_App_Level(void)
+{
+  App_Core_Log_Next_Level(APPLI_LOG_REGION_GENERAL, "App");
+} /* App_Core_Log_App_Level */
+
+/**
+ * @brief  Change the level of the Zigbee stack logs, called from the menu
+ * @param  None
+ * @retval None
+ */
+void App_Core_Log_Zb_Level(void)
+{
+  App_Core_Log_Next_Level(APPLI_LOG_REGION_ZIGBEE_API, "ZB");
+  App_Zigbee_Set_Logging();
+} /* App_Core_Log_Zb_Level */
+
 /**
  * @brief Call back after perform an NLME-LEAVE.request
  * 
@@ -337,6 +503,8 @@ static void App_Core_UpdateButtonState(Button_TypeDef button, int isPressed)
       menu_mode = Normal_mode;
       display_type = (UART_DISPLAY | DK_LCD_DISPLAY);
       APP_ZB_DBG("Menu ON");
+      // The LCD menu line is only drawn on a change
+      Refresh_Menu();
       // App_Persist_Notify_cb(app_zb_info.zb, NULL);
     }
     while( (BSP_PB_GetState(BUTTON_USER1) == BUTTON_PRESSED) || (BSP_PB_GetState(BUTTON_USER2) == BUTTON_PRESSED) )
@@ -66,10 +66,16 @@ void App_Core_Init           (void);
 void App_Core_ConfigEndpoints(void);
 void App_Core_Restore_State  (void);
 
+/* Display */
+void App_Core_Display_Update (void);
+
 /* Action from menu */
 void App_Core_Infos_Disp     (void);
 void App_Core_Ntw_Join       (void);
 void App_Core_Factory_Reset  (void);
+void App_Core_Log_Disp       (void);
+void App_Core_Log_App_Level  (void);
+void App_Core_Log_Zb_Level   (void);
 
 #ifdef __cplusplus
 } /* extern "C" */
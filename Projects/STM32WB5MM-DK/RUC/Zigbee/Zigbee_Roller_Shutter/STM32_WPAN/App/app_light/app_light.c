@@ -175,7 +175,7 @@ static void App_Light_Identify_cb(struct ZbZclClusterT *cluster, enum ZbZclIdent
       UTIL_LCD_ClearStringLine(DK_LCD_STATUS_LINE);
       sprintf(disp_identify, "Identify Mode %2ds", IDENTIFY_MODE_DELAY);
       UTIL_LCD_DisplayStringAt(0, LINE(DK_LCD_STATUS_LINE), (uint8_t *)disp_identify, CENTER_MODE);
-      BSP_LCD_Refresh(0);
+      App_Core_Display_Update();
       break;
 
     case ZCL_IDENTIFY_STOP:
@@ -295,15 +295,16 @@ static void App_Light_Control_Task(void)
   if (app_Light_Control.app_OnOff->On)
   {
     HAL_Delay(10);
-    BLINKT_SetLedLevel(0, 0xE0, app_Light_Control.app_Level->level,                                  0,                                  0);   //0b11100000
-    BLINKT_SetLedLevel(0, 0x18, app_Light_Control.app_Level->level, app_Light_Control.app_Level->level, app_Light_Control.app_Level->level);   //0b00011000
+    /* Build the whole bar before sending one frame */
+    BLINKT_SetLedLevel(0, 0xE0 | BLINKT_NO_REFRESH, app_Light_Control.app_Level->level,                                  0,                                  0);   //0b11100000
+    BLINKT_SetLedLevel(0, 0x18 | BLINKT_NO_REFRESH, app_Light_Control.app_Level->level, app_Light_Control.app_Level->level, app_Light_Control.app_Level->level);   //0b00011000
     BLINKT_SetLedLevel(0, 0x07,                                  0,                                  0, app_Light_Control.app_Level->level);   //0b00000111
     APP_ZB_DBG("Light to ON");
 
     // Reuse LCD to display information
     UTIL_LCD_ClearStringLine(DK_LCD_LIGHT_DISP);
     UTIL_LCD_DisplayStringAt(0, LINE(DK_LCD_LIGHT_DISP), (uint8_t *) "LIGHT : ON", CENTER_MODE);
-    BSP_LCD_Refresh(0);
+    App_Core_Display_Update();
   }
   else
   {
@@ -314,7 +315,7 @@ static void App_Light_Control_Task(void)
     // Reuse LCD to display information
     UTIL_LCD_ClearStringLine(DK_LCD_LIGHT_DISP);
     UTIL_LCD_DisplayStringAt(0, LINE(DK_LCD_LIGHT_DISP), (uint8_t *) "LIGHT : OFF", CENTER_MODE);
-    BSP_LCD_Refresh(0);  
+    App_Core_Display_Update();
   }
 } /* App_Light_Control_Task */
 
@@ -27,6 +27,20 @@
 #include "stm32_seq.h"
 
 /* Private defines -----------------------------------------------------------*/
+/* Timer ticks of a delay in ms, rounded up: with HW_TS_SERVER_1ms_NB_TICKS the
+ * timer would expire before the tick of the planned update */
+#define LIGHT_LEVEL_MS_TO_TICKS(ms)   (uint32_t)((((uint64_t)(ms) * 1000000000U) + (uint64_t)CFG_TS_TICK_VAL_PS - 1U) \
+                                                 / (uint64_t)CFG_TS_TICK_VAL_PS)
+
+/* Private Variables----------------------------------------------------------*/
+static uint8_t TS_ID_LEVEL_TRANSITION;
+
+static Level_Transition_T level_transition =
+{
+  .start   = LIGHT_LEVEL_DEFAULT,
+  .target  = LIGHT_LEVEL_DEFAULT,
+  .current = LIGHT_LEVEL_DEFAULT,
+};
 
 /* Application Variable-------------------------------------------------------*/
 Level_Control_T app_Level =
@@ -44,6 +58,10 @@ enum ZclStatusCodeT light_level_server_step_cb(
 enum ZclStatusCodeT light_level_server_stop_cb(
   struct ZbZclClusterT *clusterPtr, struct ZbZclLevelClientStopReqT *req, struct ZbZclAddrInfoT *srcInfo, void *arg);
 
+/* Transition management */
+static void App_Light_Level_Transition_Task    (void);
+static void App_Light_Level_Transition_Timer_cb(void);
+
 /* Application Variable------------------------------------------------------ */
 /* Level Attributes persistent flag set */
 static const struct ZbZclAttrT zcl_levelcontrol_server_attr_list[] =
@@ -82,6 +100,10 @@ Level_Control_T * App_Light_Level_Cfg(struct ZigBeeT *zb)
     ZbZclClusterFree( app_Level.level_server);
   }
 
+  /* Task/Timer for the level transitions */
+  UTIL_SEQ_RegTask(1U << CFG_TASK_LIGHT_LEVEL_TRANSITION, UTIL_SEQ_RFU, App_Light_Level_Transition_Task);
+  HW_TS_Create(CFG_TIM_PROC_ID_ISR, &TS_ID_LEVEL_TRANSITION, hw_ts_SingleShot, App_Light_Level_Transition_Timer_cb);
+
   return &app_Level;
 
 } /*  App_Light_Level_Cfg */
@@ -117,6 +139,8 @@ enum ZclStatusCodeT App_Light_Level_Restore_State(void)
       break;
     
     default :
+      /* Start from the restored level without transition */
+      App_Light_Level_Transition_Start(app_Level.level, 0, HAL_GetTick());
       status = ZCL_STATUS_SUCCESS;
       break;
   }
@@ -124,6 +148,159 @@ enum ZclStatusCodeT App_Light_Level_Restore_State(void)
   return status;
 }/* App_Light_Level_Restore_State */
 
+/* Level transition --------------------------------------------------------- */
+/**
+ * @brief  Start a transition from the current level to a new target
+ * A transition already running is retargeted from the level reached,
+ * the Leds updates are never queued.
+ * @param  target   level to reach
+ * @param  duration transition time (in ms), 0 to apply the level at once
+ * @param  now      current tick (ms)
+ * @retval None
+ */
+void App_Light_Level_Transition_Start(uint8_t target, uint32_t duration, uint32_t now)
+{
+  uint32_t next_delay;
+
+  /* Level reached by the running transition */
+  (void)App_Light_Level_Transition_Step(now, &next_delay);
+
+  level_transition.start      = level_transition.current;
+  level_transition.target     = target;
+  level_transition.start_tick = now;
+  level_transition.duration   = duration;
+  level_transition.frame_nb   = 0;
+  level_transition.is_running = true;
+
+  if ((duration == 0U) || (target == level_transition.current))
+  {
+    level_transition.current    = target;
+    level_transition.is_running = false;
+  }
+} /* App_Light_Level_Transition_Start */
+
+/**
+ * @brief  Compute the level of the running transition
+ * The next update is planned at the next level change, not before
+ * LIGHT_LEVEL_FRAME_PERIOD, and at the end of the transition at the latest.
+ * Only depends on the given tick to be replayed with synthetic sequences.
+ * @param  now        current tick (ms)
+ * @param  next_delay delay (ms) before the next update, 0 at the end of the transition
+ * @retval level to apply
+ */
+uint8_t App_Light_Level_Transition_Step(uint32_t now, uint32_t *next_delay)
+{
+  uint32_t elapsed, delta, moved, change;
+
+  *next_delay = 0U;
+
+  if (level_transition.is_running == false)
+  {
+    return level_transition.current;
+  }
+
+  elapsed = now - level_transition.start_tick;
+  if (elapsed >= level_transition.duration)
+  {
+    level_transition.current    = level_transition.target;
+    level_transition.is_running = false;
+    level_transition.frame_nb++;
+    return level_transition.current;
+  }
+
+  /* Linear interpolation */
+  if (level_transition.target > level_transition.start)
+  {
+    delta = level_transition.target - level_transition.start;
+    moved = (delta * elapsed) / level_transition.duration;
+    level_transition.current = (uint8_t)(level_transition.start + moved);
+  }
+  else
+  {
+    delta = level_transition.start - level_transition.target;
+    moved = (delta * elapsed) / level_transition.duration;
+    level_transition.current = (uint8_t)(level_transition.start - moved);
+  }
+  level_transition.frame_nb++;
+
+  /* Time (from the start) of the next level change, rounded up */
+  change = (((moved + 1U) * level_transition.duration) + delta - 1U) / delta;
+  *next_delay = change - elapsed;
+  if (*next_delay < LIGHT_LEVEL_FRAME_PERIOD)
+  {
+    *next_delay = LIGHT_LEVEL_FRAME_PERIOD;
+  }
+  if (*next_delay > (level_transition.duration - elapsed))
+  {
+    *next_delay = level_transition.duration - elapsed;
+  }
+
+  return level_transition.current;
+} /* App_Light_Level_Transition_Step */
+
+/**
+ * @brief  Stop the running transition at the level reached
+ * @param  now      current tick (ms)
+ * @retval level reached
+ */
+uint8_t App_Light_Level_Transition_Stop(uint32_t now)
+{
+  uint32_t next_delay;
+
+  (void)App_Light_Level_Transition_Step(now, &next_delay);
+
+  level_transition.target     = level_transition.current;
+  level_transition.is_running = false;
+
+  return level_transition.current;
+} /* App_Light_Level_Transition_Stop */
+
+/**
+ * @brief  Get the state of the level transition
+ * @param  None
+ * @retval transition state
+ */
+const Level_Transition_T * App_Light_Level_Transition_Get(void)
+{
+  return &level_transition;
+} /* App_Light_Level_Transition_Get */
+
+/**
+ * @brief  Transition task, apply the level reached and plan the next update
+ * @param  None
+ * @retval None
+ */
+static void App_Light_Level_Transition_Task(void)
+{
+  uint32_t next_delay;
+  uint8_t  level;
+
+  level = App_Light_Level_Transition_Step(HAL_GetTick(), &next_delay);
+
+  HW_TS_Stop(TS_ID_LEVEL_TRANSITION);
+  if (next_delay != 0U)
+  {
+    HW_TS_Start(TS_ID_LEVEL_TRANSITION, LIGHT_LEVEL_MS_TO_TICKS(next_delay));
+  }
+
+  if (level != app_Level.level)
+  {
+    app_Level.level = level;
+    UTIL_SEQ_SetTask(1U << CFG_TASK_LIGHT_UPDATE, CFG_SCH_PRIO_1);
+  }
+} /* App_Light_Level_Transition_Task */
+
+/**
+ * @brief  Timer callback of the next transition update
+ * Called under IRQ, the work is done in the transition task
+ * @param  None
+ * @retval None
+ */
+static void App_Light_Level_Transition_Timer_cb(void)
+{
+  UTIL_SEQ_SetTask(1U << CFG_TASK_LIGHT_LEVEL_TRANSITION, CFG_SCH_PRIO_1);
+} /* App_Light_Level_Transition_Timer_cb */
+
 /* Level callbacks Definition ----------------------------------------------- */
 /**< Callback to application, invoked on receipt of Move To Level command. Set with_onoff to true in the req struct when utilizing the
      * onoff cluster on the same endpoint. The application is expected to update ZCL_LEVEL_ATTR_CURRLEVEL */
@@ -138,13 +315,20 @@ enum ZclStatusCodeT App_Light_Level_Restore_State(void)
 enum ZclStatusCodeT light_level_server_move_to_level_cb(struct ZbZclClusterT *clusterPtr, 
 struct ZbZclLevelClientMoveToLevelReqT *req, struct ZbZclAddrInfoT *srcInfo, void *arg)
 {
-  APP_ZB_DBG("Control Level: 0x%X", req->level);
+  uint32_t duration = 0;
+
+  APP_ZB_DBG("Control Level: 0x%X in %d ms", req->level, req->transition_time * LIGHT_LEVEL_TRANSITION_UNIT);
   (void)ZbZclAttrIntegerWrite(clusterPtr, ZCL_LEVEL_ATTR_CURRLEVEL, req->level);
-  app_Level.level = req->level;
 
   //TODO take the OnOff dependancy in the command ??? if (req->with_onoff) {}  
-  
-  UTIL_SEQ_SetTask(1U << CFG_TASK_LIGHT_UPDATE, CFG_SCH_PRIO_1);
+
+  /* 0xFFFF : as fast as possible */
+  if (req->transition_time != 0xFFFFU)
+  {
+    duration = req->transition_time * LIGHT_LEVEL_TRANSITION_UNIT;
+  }
+  App_Light_Level_Transition_Start(req->level, duration, HAL_GetTick());
+  UTIL_SEQ_SetTask(1U << CFG_TASK_LIGHT_LEVEL_TRANSITION, CFG_SCH_PRIO_1);
    
   return ZCL_STATUS_SUCCESS;
 } /* light_level_server_move_to_level_cb */
@@ -152,14 +336,18 @@ struct ZbZclLevelClientMoveToLevelReqT *req, struct ZbZclAddrInfoT *srcInfo, voi
 /* Level server move command callback */
 enum ZclStatusCodeT light_level_server_move_cb(struct ZbZclClusterT *clusterPtr, struct ZbZclLevelClientMoveReqT *req, struct ZbZclAddrInfoT *srcInfo, void *arg)
 {
+  /* Steps are added to the level targeted by the running transition */
+  uint8_t  level    = level_transition.target;
+  uint32_t duration = LIGHT_LEVEL_STEP_TRANSITION;
+
   /* Select mode to apply */
   switch (req->mode)
   {
     case LIGHT_LEVEL_MODE_DOWN :
-      if ( app_Level.level > LIGHT_LEVEL_MIN_VALUE)
+      if (level > LIGHT_LEVEL_MIN_VALUE)
       {
-        APP_ZB_DBG("Level Ctrl Down : 0x%x --> 0x%x", app_Level.level, app_Level.level - LIGHT_LEVEL_STEP);
-        app_Level.level -= LIGHT_LEVEL_STEP;
+        APP_ZB_DBG("Level Ctrl Down : 0x%x --> 0x%x", level, level - LIGHT_LEVEL_STEP);
+        level -= LIGHT_LEVEL_STEP;
       }
       else
       {
@@ -168,20 +356,20 @@ enum ZclStatusCodeT light_level_server_move_cb(struct ZbZclClusterT *clusterPtr,
       break;
       
     case LIGHT_LEVEL_MODE_UP :
-      if ( app_Level.level == LIGHT_LEVEL_MAX_VALUE)
+      if (level == LIGHT_LEVEL_MAX_VALUE)
       {
         APP_ZB_DBG("Max Level already reached");
       }
       /* Check if overflow happens */
-      else if ((uint16_t) ( app_Level.level + LIGHT_LEVEL_STEP) > LIGHT_LEVEL_MAX_VALUE)
+      else if ((uint16_t) (level + LIGHT_LEVEL_STEP) > LIGHT_LEVEL_MAX_VALUE)
       {
-        APP_ZB_DBG("Level Ctrl Up : 0x%x --> 0x%x", app_Level.level, LIGHT_LEVEL_MAX_VALUE);
-        app_Level.level = LIGHT_LEVEL_MAX_VALUE ;
+        APP_ZB_DBG("Level Ctrl Up : 0x%x --> 0x%x", level, LIGHT_LEVEL_MAX_VALUE);
+        level = LIGHT_LEVEL_MAX_VALUE ;
       }
       else
       {
-        APP_ZB_DBG("Level Ctrl Up : 0x%x --> 0x%x", app_Level.level, app_Level.level + LIGHT_LEVEL_STEP);
-         app_Level.level += LIGHT_LEVEL_STEP;
+        APP_ZB_DBG("Level Ctrl Up : 0x%x --> 0x%x", level, level + LIGHT_LEVEL_STEP);
+        level += LIGHT_LEVEL_STEP;
       }
       break;
       
@@ -190,9 +378,15 @@ enum ZclStatusCodeT light_level_server_move_cb(struct ZbZclClusterT *clusterPtr,
       break;
   }
   
-  (void)ZbZclAttrIntegerWrite(clusterPtr, ZCL_LEVEL_ATTR_CURRLEVEL,  app_Level.level);
-  
-  UTIL_SEQ_SetTask(1U << CFG_TASK_LIGHT_UPDATE, CFG_SCH_PRIO_1);
+  (void)ZbZclAttrIntegerWrite(clusterPtr, ZCL_LEVEL_ATTR_CURRLEVEL, level);
+
+  /* Rate in levels per second */
+  if ((req->rate != 0U) && (req->rate != 0xFFU))
+  {
+    duration = (LIGHT_LEVEL_STEP * 1000U) / req->rate;
+  }
+  App_Light_Level_Transition_Start(level, duration, HAL_GetTick());
+  UTIL_SEQ_SetTask(1U << CFG_TASK_LIGHT_LEVEL_TRANSITION, CFG_SCH_PRIO_1);
 
   return ZCL_STATUS_SUCCESS;
 } /* levelControl_server_move_cb */
@@ -206,6 +400,15 @@ enum ZclStatusCodeT light_level_server_step_cb(struct ZbZclClusterT *clusterPtr,
 /* Level server stop command callback */
 enum ZclStatusCodeT light_level_server_stop_cb(struct ZbZclClusterT *clusterPtr, struct ZbZclLevelClientStopReqT *req, struct ZbZclAddrInfoT *srcInfo, void *arg)
 {
+  uint8_t level;
+
+  /* Freeze at the level reached, applied by the transition task */
+  HW_TS_Stop(TS_ID_LEVEL_TRANSITION);
+  level = App_Light_Level_Transition_Stop(HAL_GetTick());
+  APP_ZB_DBG("Level Ctrl Stop at 0x%x", level);
+  (void)ZbZclAttrIntegerWrite(clusterPtr, ZCL_LEVEL_ATTR_CURRLEVEL, level);
+  UTIL_SEQ_SetTask(1U << CFG_TASK_LIGHT_LEVEL_TRANSITION, CFG_SCH_PRIO_1);
+
   return ZCL_STATUS_SUCCESS;
 }
 
@@ -34,6 +34,13 @@ extern "C" {
 #define LIGHT_LEVEL_MODE_UP                1U
 #define LIGHT_LEVEL_MODE_DOWN              0U
 
+/* Minimum time between two updates of the Leds during a transition (in ms) */
+#define LIGHT_LEVEL_FRAME_PERIOD          40U
+/* Transition of a level step from the Move command without rate (in ms) */
+#define LIGHT_LEVEL_STEP_TRANSITION      300U
+/* ZCL transition time unit (in ms) */
+#define LIGHT_LEVEL_TRANSITION_UNIT      100U
+
 /* Types ------------------------------------------------------------------- */
 typedef struct
 {
@@ -44,10 +51,26 @@ typedef struct
   struct ZbZclClusterT * level_server;
 } Level_Control_T;
 
+typedef struct
+{
+  bool     is_running;
+  uint8_t  start;          /* Level at the start of the transition */
+  uint8_t  target;         /* Level at the end of the transition */
+  uint8_t  current;        /* Level applied on the Leds */
+  uint32_t start_tick;     /* Tick (ms) of the start of the transition */
+  uint32_t duration;       /* Duration of the transition (in ms) */
+  uint32_t frame_nb;       /* Updates of the Leds since the start of the transition */
+} Level_Transition_T;
+
 /* Exported Prototypes -------------------------------------------------------*/
 Level_Control_T   * App_Light_Level_Cfg(struct ZigBeeT *zb);
 enum ZclStatusCodeT App_Light_Level_Restore_State(void);
 
+void                App_Light_Level_Transition_Start(uint8_t target, uint32_t duration, uint32_t now);
+uint8_t             App_Light_Level_Transition_Step (uint32_t now, uint32_t *next_delay);
+uint8_t             App_Light_Level_Transition_Stop (uint32_t now);
+const Level_Transition_T * App_Light_Level_Transition_Get(void);
+
 enum ZclStatusCodeT light_level_server_move_to_level_cb(struct ZbZclClusterT *clusterPtr, struct ZbZclLevelClientMoveToLevelReqT *req, struct ZbZclAddrInfoT *srcInfo, void *arg);
 enum ZclStatusCodeT light_level_server_move_cb(struct ZbZclClusterT *clusterPtr, struct ZbZclLevelClientMoveReqT *req, struct ZbZclAddrInfoT *srcInfo, void *arg);
 
@@ -18,6 +18,8 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "app_menu.h"
+#include "app_console.h"
+#include "app_bench.h"
 #include "app_nvm.h"
 #include "app_zigbee.h"
 #include "app_core.h"
@@ -27,17 +29,131 @@
 /* External variables ------------------------------------------------------- */
 extern uint8_t           display_type;
 extern App_Zb_Info_T     app_zb_info;
+extern Roller_Shutter_Control_T app_Roller_Shutter_Control;
 
 /* Private functions prototypes-----------------------------------------------*/
 /* Menu app Config */
 static void app_launch_nvm(void);
 
+/* Menu tables, kept in flash --------------------------------------------- */
+// Network Menu
+static const Menu_Item_T menu_ntw[] =
+{
+  //         |  Menu name     | Action to launch         |
+  MENU_ACTION("Join Network" , &App_Core_Ntw_Join       ),
+  MENU_ACTION("Permit_Join"  , &App_Zigbee_Permit_Join  ),
+  MENU_ACTION("Bind Table"   , &App_Zigbee_Bind_Disp    ),
+  MENU_ACTION("Tx Power Disp", &App_Zigbee_TxPwr_Disp   ),
+  MENU_ACTION("Tx Power +"   , &App_Zigbee_TxPwr_Up     ),
+  MENU_ACTION("Tx Power -"   , &App_Zigbee_TxPwr_Down   ),
+  MENU_ACTION("Launch NVM"   , &app_launch_nvm          ),
+};
+
+// Shutter conf Menu
+static const Menu_Item_T menu_shutter_cfg[] =
+{
+  MENU_ACTION("ID Mode"       , &App_Roller_Shutter_IdentifyMode                  ),
+  MENU_ACTION("Find & Bind"   , &App_Roller_Shutter_FindBind                      ),
+  MENU_ACTION("Timer Up +"    , &App_Roller_Shutter_timer_motorup_up              ),
+  MENU_ACTION("Timer Up -"    , &App_Roller_Shutter_timer_motorup_down            ),
+  MENU_ACTION("Timer Down +"  , &App_Roller_Shutter_timer_motordown_up            ),
+  MENU_ACTION("Timer Down -"  , &App_Roller_Shutter_timer_motordown_down          ),
+  MENU_ACTION("Motor speed +" , &App_Roller_Shutter_motor_speed_up                ),
+  MENU_ACTION("Motor speed -" , &App_Roller_Shutter_motor_speed_down              ),
+  MENU_ACTION("ADC Treshold +", &App_Roller_Shutter_adc_treshold_up               ),
+  MENU_ACTION("ADC Treshold -", &App_Roller_Shutter_adc_treshold_down             ),
+  MENU_ACTION("Report Disp"   , &App_Roller_Shutter_Report_Disp                   ),
+  MENU_ACTION("Report Min +"  , &App_Roller_Shutter_Report_Min_Up                 ),
+  MENU_ACTION("Report Min -"  , &App_Roller_Shutter_Report_Min_Down               ),
+  MENU_ACTION("Report Max +"  , &App_Roller_Shutter_Report_Max_Up                 ),
+  MENU_ACTION("Report Max -"  , &App_Roller_Shutter_Report_Max_Down               ),
+  MENU_ACTION("Report Chg +"  , &App_Roller_Shutter_Report_Change_Up              ),
+  MENU_ACTION("Report Chg -"  , &App_Roller_Shutter_Report_Change_Down            ),
+  MENU_ACTION("Occ Filter"    , &App_Roller_Shutter_Occupancy_Filter_Disp         ),
+  MENU_ACTION("Occ Holdoff +" , &App_Roller_Shutter_Occupancy_Filter_Holdoff_Up   ),
+  MENU_ACTION("Occ Holdoff -" , &App_Roller_Shutter_Occupancy_Filter_Holdoff_Down ),
+};
+
+// Shutter cmd Menu
+static const Menu_Item_T menu_shutter_cmd[] =
+{
+  MENU_ACTION("Shutter Up"    , &App_Roller_Shutter_Up   ),
+  MENU_ACTION("Shutter Stop"  , &App_Roller_Shutter_Stop ),
+  MENU_ACTION("Shutter Down"  , &App_Roller_Shutter_Down ),
+};
+
+// Light Menu
+static const Menu_Item_T menu_light_cfg[] =
+{
+  MENU_ACTION("ID Mode"       , &App_Light_IdentifyMode  ),
+  MENU_ACTION("Led Toggle"    , &App_Light_Toggle        ),
+  MENU_ACTION("Led lvl +"     , &App_Light_Level_Up      ),
+  MENU_ACTION("Led lvl -"     , &App_Light_Level_Down    ),
+};
+
+// Logs Menu
+static const Menu_Item_T menu_log[] =
+{
+  MENU_ACTION("Log Levels"    , &App_Core_Log_Disp       ),
+  MENU_ACTION("App Log Level" , &App_Core_Log_App_Level  ),
+  MENU_ACTION("ZB Log Level"  , &App_Core_Log_Zb_Level   ),
+};
+
+// Main menu
+static const Menu_Item_T menu_main[] =
+{
+  //         |  Menu name     | Sub-Menu or Action to launch |
+  MENU_SUB   ("Network"      , menu_ntw                    ),
+  MENU_SUB   ("Window Cfg"   , menu_shutter_cfg            ),
+  MENU_SUB   ("Window Cmd"   , menu_shutter_cmd            ),
+  MENU_SUB   ("Light"        , menu_light_cfg              ),
+  MENU_ACTION("Factory Reset", &App_Core_Factory_Reset     ),
+  MENU_ACTION("Global Infos" , &App_Core_Infos_Disp        ),
+  MENU_SUB   ("Logs"         , menu_log                    ),
+};
+
+/* Console tables, kept in flash ------------------------------------------ */
+// Commands, the menu keys and the actions used by scripts
+static const Console_Cmd_T console_cmd[] =
+{
+  //         |  Command          | Action to launch                          |
+  CONSOLE_CMD("next"             , &Next_Menu_Item                           ),
+  CONSOLE_CMD("prev"             , &Prev_Menu_Item                           ),
+  CONSOLE_CMD("select"           , &Select_Menu_Item                         ),
+  CONSOLE_CMD("exit"             , &Exit_Menu_Item                           ),
+  CONSOLE_CMD("join"             , &App_Core_Ntw_Join                        ),
+  CONSOLE_CMD("infos"            , &App_Core_Infos_Disp                      ),
+  CONSOLE_CMD("up"               , &App_Roller_Shutter_Up                    ),
+  CONSOLE_CMD("stop"             , &App_Roller_Shutter_Stop                  ),
+  CONSOLE_CMD("down"             , &App_Roller_Shutter_Down                  ),
+  CONSOLE_CMD("motor_speed_up"   , &App_Roller_Shutter_motor_speed_up        ),
+  CONSOLE_CMD("motor_speed_down" , &App_Roller_Shutter_motor_speed_down      ),
+  CONSOLE_CMD("report_disp"      , &App_Roller_Shutter_Report_Disp           ),
+  CONSOLE_CMD("occ_filter"       , &App_Roller_Shutter_Occupancy_Filter_Disp ),
+#if (CFG_BENCH_ENABLE != 0)
+  CONSOLE_CMD("bench"            , &App_Bench_Report                         ),
+  CONSOLE_CMD("bench_reset"      , &App_Bench_Reset                          ),
+#endif /* CFG_BENCH_ENABLE */
+};
+
+// Parameters for set and get
+static const Console_Param_T console_param[] =
+{
+  //           |  Name         | Variable                                          | Min | Max   | Apply after a change            |
+  CONSOLE_PARAM("timer_up"     , app_Roller_Shutter_Control.secure_timer_up        , 250U, 60000U, NULL                               ),
+  CONSOLE_PARAM("timer_down"   , app_Roller_Shutter_Control.secure_timer_down      , 250U, 60000U, NULL                               ),
+  CONSOLE_PARAM("motor_speed"  , app_Roller_Shutter_Control.PWM_Motor_Speed        , 0U  , 100U  , &App_Roller_Shutter_Motor_Cfg_Apply),
+  CONSOLE_PARAM("adc_high_up"  , app_Roller_Shutter_Control.ADC_TresholdHigh_Up    , 0U  , 4095U , &App_Roller_Shutter_Motor_Cfg_Apply),
+  CONSOLE_PARAM("adc_high_down", app_Roller_Shutter_Control.ADC_TresholdHigh_Down  , 0U  , 4095U , NULL                               ),
+  CONSOLE_PARAM("adc_low"      , app_Roller_Shutter_Control.ADC_TresholdLow        , 0U  , 4095U , &App_Roller_Shutter_Motor_Cfg_Apply),
+};
+
 
 /* Functions Definition -------------------------------------------- */
 
 /**
  * @brief  Configure the Menu tree
- * @param  display_select to choose where the Menu appears
+ * @param  None
  * @retval state
  */
 bool Menu_Config(void)
@@ -45,92 +161,19 @@ bool Menu_Config(void)
   /* Choose where to display the menu */
   display_type = (UART_DISPLAY | DK_LCD_DISPLAY);
 
-  /* Menu item instances -----------------------------------------------------*/
-  // 1st level of menu
-  Menu_Item_T * menu_reset                = Create_Menu_Item();
-  Menu_Item_T * menu_info                 = Create_Menu_Item();
-
-  // Network Menu
-  Menu_Item_T * menu_ntw                  = Create_Menu_Item();
-  Menu_Item_T * menu_id_mode              = Create_Menu_Item();
-  Menu_Item_T * menu_ntw_join             = Create_Menu_Item();
-  Menu_Item_T * menu_permit_join          = Create_Menu_Item();
-  Menu_Item_T * menu_ntw_bind_tab         = Create_Menu_Item();
-  Menu_Item_T * menu_ntw_unbind_all       = Create_Menu_Item();
-  Menu_Item_T * menu_ntw_txpwr_disp       = Create_Menu_Item();
-  Menu_Item_T * menu_ntw_txpwr_up         = Create_Menu_Item();
-  Menu_Item_T * menu_ntw_txpwr_down       = Create_Menu_Item();
-  Menu_Item_T * menu_ntw_NVM              = Create_Menu_Item();
-  
-  // Shutter conf Menu
-  Menu_Item_T * menu_shutter_cfg          = Create_Menu_Item();
-  Menu_Item_T * menu_shutter_id_mode      = Create_Menu_Item();  
-  Menu_Item_T * menu_shutter_findbind     = Create_Menu_Item();
-  Menu_Item_T * menu_timer_motorup_up     = Create_Menu_Item();
-  Menu_Item_T * menu_timer_motorup_down   = Create_Menu_Item();  
-  Menu_Item_T * menu_timer_motordown_up   = Create_Menu_Item();
-  Menu_Item_T * menu_timer_motordown_down = Create_Menu_Item(); 
-  Menu_Item_T * menu_motor_speed_up       = Create_Menu_Item();
-  Menu_Item_T * menu_motor_speed_down     = Create_Menu_Item();
-  Menu_Item_T * menu_adc_treshold_up      = Create_Menu_Item();
-  Menu_Item_T * menu_adc_treshold_down    = Create_Menu_Item(); 
-  // Shutter cmd Menu
-  Menu_Item_T * menu_shutter_cmd          = Create_Menu_Item();
-  Menu_Item_T * menu_shutter_up           = Create_Menu_Item();
-  Menu_Item_T * menu_shutter_down         = Create_Menu_Item();
-  Menu_Item_T * menu_shutter_stop         = Create_Menu_Item(); 
-  
-  // Light Menu
-  Menu_Item_T * menu_light_cfg            = Create_Menu_Item();
-  Menu_Item_T * menu_light_id_mode        = Create_Menu_Item();
-  Menu_Item_T * menu_light_led_toggle     = Create_Menu_Item();
-  Menu_Item_T * menu_light_led_lvl_up     = Create_Menu_Item();
-  Menu_Item_T * menu_light_led_lvl_down   = Create_Menu_Item();
- 
-  
-  /* Menu link --------------------------------------------------------------*/
-  // Main menu --------|  Menu name     | Current Item     | Next Item        | Sub-Menu             | Action to launch        |
-  Add_Menu_Item((char *) "Network"      , menu_ntw         , menu_shutter_cfg , menu_ntw_join        , NULL);
-  Add_Menu_Item((char *) "Window Cfg"   , menu_shutter_cfg , menu_shutter_cmd , menu_shutter_id_mode , NULL);
-  Add_Menu_Item((char *) "Window Cmd"   , menu_shutter_cmd , menu_light_cfg   , menu_shutter_up      , NULL);
-  Add_Menu_Item((char *) "Light"        , menu_light_cfg   , menu_reset       , menu_light_id_mode   , NULL);
-  Add_Menu_Item((char *) "Factory Reset", menu_reset       , menu_info        , NULL                 , &App_Core_Factory_Reset);
-  Add_Menu_Item((char *) "Global Infos" , menu_info        , menu_ntw         , NULL                 , &App_Core_Infos_Disp);
-
-  // Network Menu, 
-  Add_Menu_Item((char *) "Join Network" , menu_ntw_join      , menu_permit_join   , NULL             , &App_Core_Ntw_Join);
-  Add_Menu_Item((char *) "Permit_Join"  , menu_permit_join   , menu_ntw_bind_tab  , NULL             , &App_Zigbee_Permit_Join);
-  Add_Menu_Item((char *) "Bind Table"   , menu_ntw_bind_tab  , menu_ntw_txpwr_disp, NULL             , &App_Zigbee_Bind_Disp);
-  Add_Menu_Item((char *) "Tx Power Disp", menu_ntw_txpwr_disp, menu_ntw_txpwr_up  , NULL             , &App_Zigbee_TxPwr_Disp);
-  Add_Menu_Item((char *) "Tx Power +"   , menu_ntw_txpwr_up  , menu_ntw_txpwr_down, NULL             , &App_Zigbee_TxPwr_Up);
-  Add_Menu_Item((char *) "Tx Power -"   , menu_ntw_txpwr_down, menu_ntw_NVM       , NULL             , &App_Zigbee_TxPwr_Down);
-  Add_Menu_Item((char *) "Launch NVM"   , menu_ntw_NVM       , menu_ntw_join      , NULL             , &app_launch_nvm);
-
-  // Shutter conf Menu
-  Add_Menu_Item((char *) "ID Mode"       , menu_shutter_id_mode     , menu_shutter_findbind    , NULL, &App_Roller_Shutter_IdentifyMode);  
-  Add_Menu_Item((char *) "Find & Bind"   , menu_shutter_findbind    , menu_timer_motorup_up    , NULL, &App_Roller_Shutter_FindBind);   
-  Add_Menu_Item((char *) "Timer Up +"    , menu_timer_motorup_up    , menu_timer_motorup_down  , NULL, &App_Roller_Shutter_timer_motorup_up);
-  Add_Menu_Item((char *) "Timer Up -"    , menu_timer_motorup_down  , menu_timer_motordown_up  , NULL, &App_Roller_Shutter_timer_motorup_down);
-  Add_Menu_Item((char *) "Timer Down +"  , menu_timer_motordown_up  , menu_timer_motordown_down, NULL, &App_Roller_Shutter_timer_motordown_up);
-  Add_Menu_Item((char *) "Timer Down -"  , menu_timer_motordown_down, menu_motor_speed_up      , NULL, &App_Roller_Shutter_timer_motordown_down);
-  Add_Menu_Item((char *) "Motor speed +" , menu_motor_speed_up      , menu_motor_speed_down    , NULL, &App_Roller_Shutter_motor_speed_up);
-  Add_Menu_Item((char *) "Motor speed -" , menu_motor_speed_down    , menu_adc_treshold_up     , NULL, &App_Roller_Shutter_motor_speed_down);
-  Add_Menu_Item((char *) "ADC Treshold +", menu_adc_treshold_up     , menu_adc_treshold_down   , NULL, &App_Roller_Shutter_adc_treshold_up);
-  Add_Menu_Item((char *) "ADC Treshold -", menu_adc_treshold_down   , menu_shutter_id_mode     , NULL, &App_Roller_Shutter_adc_treshold_down);
-  // Shutter cmd Menu
-  Add_Menu_Item((char *) "Shutter Up"    , menu_shutter_up          , menu_shutter_stop        , NULL, &App_Roller_Shutter_Up);
-  Add_Menu_Item((char *) "Shutter Stop"  , menu_shutter_stop        , menu_shutter_down        , NULL, &App_Roller_Shutter_Stop);
-  Add_Menu_Item((char *) "Shutter Down"  , menu_shutter_down        , menu_shutter_up          , NULL, &App_Roller_Shutter_Down);
-  
-  // Light Menu
-  Add_Menu_Item((char *) "ID Mode"       , menu_light_id_mode       , menu_light_led_toggle    , NULL, &App_Light_IdentifyMode);
-  Add_Menu_Item((char *) "Led Toggle"    , menu_light_led_toggle    , menu_light_led_lvl_up    , NULL, &App_Light_Toggle);
-  Add_Menu_Item((char *) "Led lvl +"     , menu_light_led_lvl_up    , menu_light_led_lvl_down  , NULL, &App_Light_Level_Up);
-  Add_Menu_Item((char *) "Led lvl -"     , menu_light_led_lvl_down  , menu_light_id_mode       , NULL, &App_Light_Level_Down);
-  
-  return Def_Start_Menu_Item(menu_ntw);
+  return Def_Start_Menu_Item(menu_main, MENU_NB(menu_main));
 } /* Menu_config */
 
+/**
+ * @brief  Configure the commands and the parameters of the console
+ * @param  None
+ * @retval state
+ */
+bool Console_Config(void)
+{
+  return Console_Init(console_cmd, CONSOLE_NB(console_cmd), console_param, CONSOLE_NB(console_param));
+} /* Console_Config */
+
 /* User menu config function ---------------------------------------------------*/
 static void app_launch_nvm(void)
 {
@@ -30,6 +30,7 @@
 #include "app_roller_shutter_cfg.h"
 #include "app_core.h"
 #include "app_zigbee.h"
+#include "app_bench.h"
 
 /* Private defines -----------------------------------------------------------*/
 #define IDENTIFY_MODE_DELAY              30U
@@ -124,6 +125,7 @@ void App_Roller_Shutter_Cfg_Endpoint(struct ZigBeeT *zb)
 
   /* Window Covering Server */
   app_Roller_Shutter_Control.app_Window_Covering_Control = App_Roller_Shutter_Window_Covering_Config(zb);
+  App_Roller_Shutter_Report_Init(app_Roller_Shutter_Control.app_Window_Covering_Control->window_server);
 
   /*  Occupancy Client */
   app_Roller_Shutter_Control.app_Occupancy = App_Roller_Shutter_Occupancy_Cfg(zb);
@@ -145,10 +147,11 @@ void App_Roller_Shutter_Cfg_Endpoint(struct ZigBeeT *zb)
   HW_TS_Create(CFG_TIM_PROC_ID_ISR, &TS_ID_STOP_MOTOR_BOT_END_SENSOR, hw_ts_SingleShot, App_Roller_Shutter_Stop);
   //HW_TS_Create(CFG_TIM_PROC_ID_ISR, &TS_ID_ADC_STOP, hw_ts_Repeated, alert_too_high_current);
   UTIL_SEQ_RegTask(1U << CFG_TASK_ROLLER_SHUTTER_OCCUPANCY_EVT,  UTIL_SEQ_RFU, App_Roller_Shutter_Occupancy_Task);
+  App_Roller_Shutter_Occupancy_Filter_Init();
 
   UTIL_LCD_ClearStringLine(DK_LCD_SHUTTER_DISP);
   UTIL_LCD_DisplayStringAt(0, LINE(DK_LCD_SHUTTER_DISP), (uint8_t *) "SHUTTER : STOP", CENTER_MODE);
-  BSP_LCD_Refresh(0);
+  App_Core_Display_Update();
 } /* App_Roller_Shutter_Cfg_Endpoint */
 
 /**
@@ -224,7 +227,7 @@ static void App_Roller_Shutter_Identify_cb(struct ZbZclClusterT *cluster, enum Z
       UTIL_LCD_ClearStringLine(DK_LCD_STATUS_LINE);
       sprintf(disp_identify, "Identify Mode %2ds", IDENTIFY_MODE_DELAY);
       UTIL_LCD_DisplayStringAt(0, LINE(DK_LCD_STATUS_LINE), (uint8_t *)disp_identify, CENTER_MODE);
-      BSP_LCD_Refresh(0);
+      App_Core_Display_Update();
       break;
 
     case ZCL_IDENTIFY_STOP:
@@ -504,7 +507,11 @@ static void App_Roller_Shutter_Motor_Control_Task(void)
       /* Init anti-pitch detection */
       ams_adc_change_treshold_value(app_Roller_Shutter_Control.ADC_TresholdHigh_Up, app_Roller_Shutter_Control.ADC_TresholdLow);
 
-      if (ams_start_motor_up()) {APP_ZB_DBG("Moves Window Up"); }
+      if (ams_start_motor_up())
+      {
+        APP_BENCH_STOP(BENCH_MOTOR_CMD);
+        APP_ZB_DBG("Moves Window Up");
+      }
       else
         APP_ZB_DBG("Error in Cmd up");
       
@@ -514,7 +521,7 @@ static void App_Roller_Shutter_Motor_Control_Task(void)
       /* Display current action on LCD */
       UTIL_LCD_ClearStringLine(DK_LCD_SHUTTER_DISP);
       UTIL_LCD_DisplayStringAt(0, LINE(DK_LCD_SHUTTER_DISP), (uint8_t *) "SHUTTER : UP", CENTER_MODE);
-      BSP_LCD_Refresh(0);
+      App_Core_Display_Update();
       break;
       
     case ZCL_WNCV_COMMAND_DOWN :
@@ -531,7 +538,11 @@ static void App_Roller_Shutter_Motor_Control_Task(void)
       /* Init anti-pitch detection */
       ams_adc_change_treshold_value(app_Roller_Shutter_Control.ADC_TresholdHigh_Down, app_Roller_Shutter_Control.ADC_TresholdLow);
       
-      if (ams_start_motor_down()) {APP_ZB_DBG("Moves Window down"); }
+      if (ams_start_motor_down())
+      {
+        APP_BENCH_STOP(BENCH_MOTOR_CMD);
+        APP_ZB_DBG("Moves Window down");
+      }
       else
         APP_ZB_DBG("Error in Cmd down");
 
@@ -541,7 +552,7 @@ static void App_Roller_Shutter_Motor_Control_Task(void)
       /* Display current action on LCD */
       UTIL_LCD_ClearStringLine(DK_LCD_SHUTTER_DISP);
       UTIL_LCD_DisplayStringAt(0, LINE(DK_LCD_SHUTTER_DISP), (uint8_t *) "SHUTTER : DOWN", CENTER_MODE);
-      BSP_LCD_Refresh(0);    
+      App_Core_Display_Update();
       break;
       
     case ZCL_WNCV_COMMAND_STOP :
@@ -558,10 +569,13 @@ static void App_Roller_Shutter_Motor_Control_Task(void)
       else
         APP_ZB_DBG("Error in Cmd Stop");
 
+      /* Give the final state to the bound clients without waiting the min interval */
+      App_Roller_Shutter_Report_Final();
+
       /* Display current action on LCD */
       UTIL_LCD_ClearStringLine(DK_LCD_SHUTTER_DISP);
       UTIL_LCD_DisplayStringAt(0, LINE(DK_LCD_SHUTTER_DISP), (uint8_t *) "SHUTTER : STOP", CENTER_MODE);
-      BSP_LCD_Refresh(0);    
+      App_Core_Display_Update();
       break;
   }
 
@@ -571,18 +585,24 @@ static void App_Roller_Shutter_Motor_Control_Task(void)
 /**
  * @brief action done by event of the Occupancy sensor
  *  should be depend of the application target
+ *  Called on each report and on the filter timer, the filter decides when to move
  * 
  */
 static void App_Roller_Shutter_Occupancy_Task(void)
 {
-  /* Update the Window covering server according to the Sensor information */
-  if (app_Roller_Shutter_Control.app_Occupancy->Occupancy)
-  {
-    App_Roller_Shutter_Up();
-  }
-  else
+  /* Update the Window covering server according to the filtered Sensor information */
+  switch (App_Roller_Shutter_Occupancy_Filter_Process())
   {
-    App_Roller_Shutter_Down();
+    case OCC_FILTER_ACTION_UP :
+      App_Roller_Shutter_Up();
+      break;
+
+    case OCC_FILTER_ACTION_DOWN :
+      App_Roller_Shutter_Down();
+      break;
+
+    default :
+      break;
   }
 }
 
@@ -704,7 +724,7 @@ void App_Roller_Shutter_adc_treshold_up(void)
 {
   app_Roller_Shutter_Control.ADC_TresholdHigh_Up += ADC_TRESHOLD_STEP;
   if (ams_adc_change_treshold_value(app_Roller_Shutter_Control.ADC_TresholdHigh_Up, app_Roller_Shutter_Control.ADC_TresholdLow) == false)
-     APP_ZB_DBG("Erro while init ADC")
+     APP_ZB_DBG("Erro while init ADC");
   APP_ZB_DBG("New ADC High Treshold value : reel : %d vs %d", LL_ADC_GetAnalogWDThresholds(hadc1.Instance, ADC_ANALOGWATCHDOG_1, LL_ADC_AWD_THRESHOLD_HIGH) ,app_Roller_Shutter_Control.ADC_TresholdHigh_Up );
 } /* app_adc_treshold_up */
 
@@ -720,6 +740,17 @@ void App_Roller_Shutter_adc_treshold_down(void)
   APP_ZB_DBG("New ADC High Treshold value : reel : %d vs %d", LL_ADC_GetAnalogWDThresholds(hadc1.Instance, ADC_ANALOGWATCHDOG_1, LL_ADC_AWD_THRESHOLD_HIGH) ,app_Roller_Shutter_Control.ADC_TresholdHigh_Up );
 } /* app_adc_treshold_down */
 
+/**
+ * @brief Function to apply the motor speed and the threshold current after they have been set from the console
+ * 
+ */
+void App_Roller_Shutter_Motor_Cfg_Apply(void)
+{
+  ams_pwm_change_duty_cycle(app_Roller_Shutter_Control.PWM_Motor_Speed);
+  if (ams_adc_change_treshold_value(app_Roller_Shutter_Control.ADC_TresholdHigh_Up, app_Roller_Shutter_Control.ADC_TresholdLow) == false)
+     APP_ZB_DBG("Erro while init ADC");
+} /* App_Roller_Shutter_Motor_Cfg_Apply */
+
 // TODO May be to use in futur developpment
 // void     App_Roller_Shutter_Secure_TimerUp_Set  (uint16_t secure_timer_up)
 // {
@@ -101,6 +101,7 @@ void App_Roller_Shutter_motor_speed_up      (void);
 void App_Roller_Shutter_motor_speed_down    (void);
 void App_Roller_Shutter_adc_treshold_up     (void);
 void App_Roller_Shutter_adc_treshold_down   (void);
+void App_Roller_Shutter_Motor_Cfg_Apply     (void);
 
 #ifdef __cplusplus
 } /* extern "C" */
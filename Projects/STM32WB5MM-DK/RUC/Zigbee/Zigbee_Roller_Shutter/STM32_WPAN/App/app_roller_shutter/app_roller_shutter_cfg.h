@@ -43,6 +43,8 @@ extern "C" {
 /* EndPoint dependencies */
 #include "app_roller_shutter_window_covering.h"
 #include "app_roller_shutter_occupancy.h"
+#include "app_roller_shutter_occupancy_filter.h"
+#include "app_roller_shutter_report.h"
 #include "app_roller_shutter.h"
 
 /* Typedef ------------------------------------------------------------------*/
@@ -142,6 +142,7 @@ static void App_Roller_Shutter_Occupancy_client_report
     /* get the occupancy status form server */
     app_Occupancy.Occupancy = (uint8_t) in_payload[0];
     APP_ZB_DBG("Occupancy Report attribute From 0x%016llx -     %x",dataIndPtr->src.extAddr,app_Occupancy.Occupancy);
+    App_Roller_Shutter_Occupancy_Filter_Input(app_Occupancy.Occupancy, HAL_GetTick());
 
     UTIL_SEQ_SetTask(1U << CFG_TASK_ROLLER_SHUTTER_OCCUPANCY_EVT, CFG_SCH_PRIO_1);
   }
@@ -26,7 +26,7 @@ extern "C" {
 
 /* Includes ------------------------------------------------------------------*/
 /* Defines ------------------------------------------------------------------ */
-#define ROLLER_SHUTTER_OCCUPANCY_MIN_REPORT        0x0000
+#define ROLLER_SHUTTER_OCCUPANCY_MIN_REPORT        0x0001 /* Filter sensor bursts */
 #define ROLLER_SHUTTER_OCCUPANCY_MAX_REPORT        0x0000
 #define ROLLER_SHUTTER_OCCUPANCY_REPORT_CHANGE     0x0001 /* On/Off */
 
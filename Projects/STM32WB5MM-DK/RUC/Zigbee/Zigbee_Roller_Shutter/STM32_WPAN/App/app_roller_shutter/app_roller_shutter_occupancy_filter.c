@@ -0,0 +1,265 @@
+/**
+  ******************************************************************************
+  * @file    app_roller_shutter_occupancy_filter.c
+  * @author  Zigbee Application Team
+  * @brief   Occupancy filter of the Roller Shutter Endpoint.
+  *          Debounce the sensor reports and limit the motor reversals before
+  *          driving the shutter.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32_seq.h"
+#include "app_roller_shutter_cfg.h"
+#include "app_nvm.h"
+
+/* Private Variables----------------------------------------------------------*/
+static uint8_t TS_ID_OCCUPANCY_FILTER;
+
+static Occ_Filter_Cfg_T occ_filter_cfg =
+{
+  .holdoff    = OCC_FILTER_DEFAULT_HOLDOFF,
+  .dwell_up   = OCC_FILTER_DWELL_UP,
+  .dwell_down = OCC_FILTER_DWELL_DOWN,
+};
+
+static struct
+{
+  bool     is_raw_valid;      /* An occupancy has been received */
+  bool     raw;               /* Last occupancy received */
+  uint32_t raw_tick;          /* Tick (ms) of the last raw change */
+  bool     is_applied;        /* A command has already been issued */
+  bool     applied;           /* Occupancy of the last command issued */
+  uint32_t applied_tick;      /* Tick (ms) of the last command issued */
+  uint32_t reversal_tick[OCC_FILTER_REVERSAL_MAX]; /* Ring of the last reversals */
+  uint8_t  reversal_idx;      /* Oldest reversal of the ring */
+  uint8_t  reversal_count;
+  Occ_Filter_Stats_T stats;
+} occ_filter;
+
+/* Private functions prototypes-----------------------------------------------*/
+static void App_Roller_Shutter_Occupancy_Filter_Timer_cb(void);
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+ * @brief  Init the occupancy filter and its re-evaluation timer
+ * @param  None
+ * @retval None
+ */
+void App_Roller_Shutter_Occupancy_Filter_Init(void)
+{
+  uint32_t holdoff;
+
+  memset(&occ_filter, 0, sizeof(occ_filter));
+
+  if ((App_NVM_Param_Read(APP_NVM_PARAM_OCC_HOLDOFF, &holdoff) == true) &&
+      (holdoff <= OCC_FILTER_HOLDOFF_LIMIT))
+  {
+    occ_filter_cfg.holdoff = holdoff;
+  }
+
+  HW_TS_Create(CFG_TIM_PROC_ID_ISR, &TS_ID_OCCUPANCY_FILTER, hw_ts_SingleShot, App_Roller_Shutter_Occupancy_Filter_Timer_cb);
+} /* App_Roller_Shutter_Occupancy_Filter_Init */
+
+/**
+ * @brief  Give a new occupancy sample to the filter
+ * @param  occupied occupancy received from the sensor
+ * @param  now      current tick (ms)
+ * @retval None
+ */
+void App_Roller_Shutter_Occupancy_Filter_Input(bool occupied, uint32_t now)
+{
+  occ_filter.stats.input_nb++;
+
+  if ((occ_filter.is_raw_valid == false) || (occupied != occ_filter.raw))
+  {
+    /* A change back to the applied state before the end of the hold-off is a bounce */
+    if ((occ_filter.is_applied) && (occupied == occ_filter.applied) &&
+        ((uint32_t)(now - occ_filter.raw_tick) < occ_filter_cfg.holdoff))
+    {
+      occ_filter.stats.bounce_nb++;
+    }
+    occ_filter.is_raw_valid = true;
+    occ_filter.raw          = occupied;
+    occ_filter.raw_tick     = now;
+  }
+} /* App_Roller_Shutter_Occupancy_Filter_Input */
+
+/**
+ * @brief  Decide if the shutter must be moved according to the filtered occupancy
+ * Only depends on the given tick to be replayed with synthetic sequences.
+ * @param  now        current tick (ms)
+ * @param  next_delay delay (ms) before the next evaluation, 0 if not needed
+ * @retval action to apply on the shutter
+ */
+Occ_Filter_Action_T App_Roller_Shutter_Occupancy_Filter_Step(uint32_t now, uint32_t *next_delay)
+{
+  uint32_t elapsed;
+  uint32_t dwell;
+  bool     is_reversal;
+
+  *next_delay = 0U;
+
+  if ((occ_filter.is_raw_valid == false) ||
+      ((occ_filter.is_applied) && (occ_filter.raw == occ_filter.applied)))
+  {
+    return OCC_FILTER_ACTION_NONE;
+  }
+
+  /* Hold-off : the sensor state must be stable */
+  elapsed = now - occ_filter.raw_tick;
+  if (elapsed < occ_filter_cfg.holdoff)
+  {
+    *next_delay = occ_filter_cfg.holdoff - elapsed;
+    return OCC_FILTER_ACTION_NONE;
+  }
+
+  is_reversal = occ_filter.is_applied;
+  if (is_reversal)
+  {
+    /* Minimum dwell time in the current direction */
+    dwell   = (occ_filter.applied) ? occ_filter_cfg.dwell_up : occ_filter_cfg.dwell_down;
+    elapsed = now - occ_filter.applied_tick;
+    if (elapsed < dwell)
+    {
+      occ_filter.stats.dwell_nb++;
+      *next_delay = dwell - elapsed;
+      return OCC_FILTER_ACTION_NONE;
+    }
+
+    /* Reversal rate limit : wait the oldest reversal leaves the window */
+    if (occ_filter.reversal_count == OCC_FILTER_REVERSAL_MAX)
+    {
+      elapsed = now - occ_filter.reversal_tick[occ_filter.reversal_idx];
+      if (elapsed < OCC_FILTER_REVERSAL_WINDOW)
+      {
+        occ_filter.stats.rate_limit_nb++;
+        *next_delay = OCC_FILTER_REVERSAL_WINDOW - elapsed;
+        return OCC_FILTER_ACTION_NONE;
+      }
+    }
+
+    occ_filter.reversal_tick[(occ_filter.reversal_idx + occ_filter.reversal_count) % OCC_FILTER_REVERSAL_MAX] = now;
+    if (occ_filter.reversal_count < OCC_FILTER_REVERSAL_MAX)
+    {
+      occ_filter.reversal_count++;
+    }
+    else
+    {
+      occ_filter.reversal_idx = (occ_filter.reversal_idx + 1U) % OCC_FILTER_REVERSAL_MAX;
+    }
+    occ_filter.stats.reversal_nb++;
+  }
+
+  occ_filter.is_applied   = true;
+  occ_filter.applied      = occ_filter.raw;
+  occ_filter.applied_tick = now;
+  occ_filter.stats.action_nb++;
+
+  return (occ_filter.applied) ? OCC_FILTER_ACTION_UP : OCC_FILTER_ACTION_DOWN;
+} /* App_Roller_Shutter_Occupancy_Filter_Step */
+
+/**
+ * @brief  Run the filter and re-arm the evaluation timer if a decision is pending
+ * Called from the occupancy task
+ * @param  None
+ * @retval action to apply on the shutter
+ */
+Occ_Filter_Action_T App_Roller_Shutter_Occupancy_Filter_Process(void)
+{
+  Occ_Filter_Action_T action;
+  uint32_t next_delay;
+
+  action = App_Roller_Shutter_Occupancy_Filter_Step(HAL_GetTick(), &next_delay);
+
+  HW_TS_Stop(TS_ID_OCCUPANCY_FILTER);
+  if (next_delay != 0U)
+  {
+    HW_TS_Start(TS_ID_OCCUPANCY_FILTER, next_delay * HW_TS_SERVER_1ms_NB_TICKS);
+  }
+
+  return action;
+} /* App_Roller_Shutter_Occupancy_Filter_Process */
+
+/**
+ * @brief  Get the filter statistics
+ * @param  None
+ * @retval statistics
+ */
+const Occ_Filter_Stats_T * App_Roller_Shutter_Occupancy_Filter_Get_Stats(void)
+{
+  return &occ_filter.stats;
+} /* App_Roller_Shutter_Occupancy_Filter_Get_Stats */
+
+/**
+ * @brief  Increase the hold-off time and save it in NVM
+ * @param  None
+ * @retval None
+ */
+void App_Roller_Shutter_Occupancy_Filter_Holdoff_Up(void)
+{
+  if ((occ_filter_cfg.holdoff + OCC_FILTER_HOLDOFF_STEP) > OCC_FILTER_HOLDOFF_LIMIT)
+  {
+    APP_ZB_DBG("Occupancy hold-off already at the maximum");
+    return;
+  }
+  occ_filter_cfg.holdoff += OCC_FILTER_HOLDOFF_STEP;
+  App_NVM_Param_Write(APP_NVM_PARAM_OCC_HOLDOFF, occ_filter_cfg.holdoff);
+  APP_ZB_DBG("New occupancy hold-off : %d ms", occ_filter_cfg.holdoff);
+} /* App_Roller_Shutter_Occupancy_Filter_Holdoff_Up */
+
+/**
+ * @brief  Decrease the hold-off time and save it in NVM
+ * @param  None
+ * @retval None
+ */
+void App_Roller_Shutter_Occupancy_Filter_Holdoff_Down(void)
+{
+  if (occ_filter_cfg.holdoff < OCC_FILTER_HOLDOFF_STEP)
+  {
+    APP_ZB_DBG("Occupancy hold-off already at the minimum");
+    return;
+  }
+  occ_filter_cfg.holdoff -= OCC_FILTER_HOLDOFF_STEP;
+  App_NVM_Param_Write(APP_NVM_PARAM_OCC_HOLDOFF, occ_filter_cfg.holdoff);
+  APP_ZB_DBG("New occupancy hold-off : %d ms", occ_filter_cfg.holdoff);
+} /* App_Roller_Shutter_Occupancy_Filter_Holdoff_Down */
+
+/**
+ * @brief  For debug purpose, display the filter configuration and statistics
+ * @param  None
+ * @retval None
+ */
+void App_Roller_Shutter_Occupancy_Filter_Disp(void)
+{
+  APP_ZB_DBG("Occupancy filter : hold-off %d ms | dwell up %d ms | dwell down %d ms | %d reversals / %d s",
+             occ_filter_cfg.holdoff, occ_filter_cfg.dwell_up, occ_filter_cfg.dwell_down,
+             OCC_FILTER_REVERSAL_MAX, OCC_FILTER_REVERSAL_WINDOW / 1000U);
+  APP_ZB_DBG("Samples : %d | bounces : %d | commands : %d | reversals : %d",
+             occ_filter.stats.input_nb, occ_filter.stats.bounce_nb,
+             occ_filter.stats.action_nb, occ_filter.stats.reversal_nb);
+  APP_ZB_DBG("Delayed by dwell : %d | by rate limit : %d",
+             occ_filter.stats.dwell_nb, occ_filter.stats.rate_limit_nb);
+} /* App_Roller_Shutter_Occupancy_Filter_Disp */
+
+/* Private Functions Definition ----------------------------------------------*/
+/**
+ * @brief  Timer callback to evaluate again a pending decision
+ * Called under IRQ, the work is done in the occupancy task
+ * @param  None
+ * @retval None
+ */
+static void App_Roller_Shutter_Occupancy_Filter_Timer_cb(void)
+{
+  UTIL_SEQ_SetTask(1U << CFG_TASK_ROLLER_SHUTTER_OCCUPANCY_EVT, CFG_SCH_PRIO_1);
+} /* App_Roller_Shutter_Occupancy_Filter_Timer_cb */
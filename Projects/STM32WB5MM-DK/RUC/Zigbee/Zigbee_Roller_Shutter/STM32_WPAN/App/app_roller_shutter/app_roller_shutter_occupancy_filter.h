@@ -0,0 +1,84 @@
+/**
+  ******************************************************************************
+  * @file    app_roller_shutter_occupancy_filter.h
+  * @author  Zigbee Application Team
+  * @brief   Header for the occupancy filter of the Roller Shutter Endpoint.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef APP_ROLLER_SHUTTER_OCCUPANCY_FILTER_H
+#define APP_ROLLER_SHUTTER_OCCUPANCY_FILTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines ----------------------------------------------------------------- */
+/* Time the sensor state must stay stable before being considered (in ms) */
+#define OCC_FILTER_DEFAULT_HOLDOFF            2000U
+#define OCC_FILTER_HOLDOFF_STEP               500U
+#define OCC_FILTER_HOLDOFF_LIMIT              30000U
+
+/* Minimum time spent in a direction before reversing it (in ms) */
+#define OCC_FILTER_DWELL_UP                   10000U
+#define OCC_FILTER_DWELL_DOWN                 10000U
+
+/* At most OCC_FILTER_REVERSAL_MAX reversals in OCC_FILTER_REVERSAL_WINDOW (in ms) */
+#define OCC_FILTER_REVERSAL_MAX               6U
+#define OCC_FILTER_REVERSAL_WINDOW            (5U * 60U * 1000U)
+
+/* Typedef ----------------------------------------------------------------- */
+typedef enum
+{
+  OCC_FILTER_ACTION_NONE,
+  OCC_FILTER_ACTION_UP,    /* Occupancy confirmed */
+  OCC_FILTER_ACTION_DOWN,  /* No occupancy confirmed */
+} Occ_Filter_Action_T;
+
+typedef struct
+{
+  uint32_t holdoff;     /* in ms */
+  uint32_t dwell_up;    /* in ms */
+  uint32_t dwell_down;  /* in ms */
+} Occ_Filter_Cfg_T;
+
+typedef struct
+{
+  uint32_t input_nb;       /* Occupancy samples received */
+  uint32_t bounce_nb;      /* Changes cancelled during the hold-off */
+  uint32_t action_nb;      /* Motor commands issued */
+  uint32_t reversal_nb;    /* Motor commands reversing the previous one */
+  uint32_t dwell_nb;       /* Commands delayed by the minimum dwell time */
+  uint32_t rate_limit_nb;  /* Commands delayed by the reversal rate limit */
+} Occ_Filter_Stats_T;
+
+/* Exported Prototypes -------------------------------------------------------*/
+void                App_Roller_Shutter_Occupancy_Filter_Init   (void);
+void                App_Roller_Shutter_Occupancy_Filter_Input  (bool occupied, uint32_t now);
+Occ_Filter_Action_T App_Roller_Shutter_Occupancy_Filter_Step    (uint32_t now, uint32_t *next_delay);
+Occ_Filter_Action_T App_Roller_Shutter_Occupancy_Filter_Process (void);
+const Occ_Filter_Stats_T * App_Roller_Shutter_Occupancy_Filter_Get_Stats(void);
+void                App_Roller_Shutter_Occupancy_Filter_Holdoff_Up  (void);
+void                App_Roller_Shutter_Occupancy_Filter_Holdoff_Down(void);
+void                App_Roller_Shutter_Occupancy_Filter_Disp   (void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* APP_ROLLER_SHUTTER_OCCUPANCY_FILTER_H */
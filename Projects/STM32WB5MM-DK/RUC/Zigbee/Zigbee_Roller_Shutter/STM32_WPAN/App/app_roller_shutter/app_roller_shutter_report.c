@@ -0,0 +1,284 @@
+/**
+  ******************************************************************************
+  * @file    app_roller_shutter_report.c
+  * @author  Zigbee Application Team
+  * @brief   Attribute reporting policy of the Roller Shutter Endpoint.
+  *          Configure the min/max intervals and the reportable change of the
+  *          Window Covering state and force a final report when the motor stops.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_roller_shutter_cfg.h"
+#include "app_nvm.h"
+
+/* Private Variables----------------------------------------------------------*/
+static struct ZbZclClusterT * report_window_server;
+static uint32_t report_final_nb;
+
+static Report_Policy_T report_policy =
+{
+  .min_intvl = REPORT_DEFAULT_MIN_INTVL,
+  .max_intvl = REPORT_DEFAULT_MAX_INTVL,
+  .change    = REPORT_DEFAULT_CHANGE,
+};
+
+/* Private functions prototypes-----------------------------------------------*/
+static void App_Roller_Shutter_Report_Load(void);
+static void App_Roller_Shutter_Report_Save(void);
+static void App_Roller_Shutter_Report_Update(void);
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+ * @brief  Load the reporting policy from NVM and apply it to the Window Covering server
+ * @param  window_server Window Covering server cluster
+ * @retval None
+ */
+void App_Roller_Shutter_Report_Init(struct ZbZclClusterT *window_server)
+{
+  report_window_server = window_server;
+  report_final_nb      = 0;
+
+  App_Roller_Shutter_Report_Load();
+  App_Roller_Shutter_Report_Apply();
+} /* App_Roller_Shutter_Report_Init */
+
+/**
+ * @brief  Apply the reporting policy as default reporting configuration
+ * Also reset the active configuration, a bound client may configure it back.
+ * @param  None
+ * @retval None
+ */
+void App_Roller_Shutter_Report_Apply(void)
+{
+  double change = (double)report_policy.change;
+  enum ZclStatusCodeT status;
+
+  if (report_window_server == NULL)
+  {
+    return;
+  }
+
+  status = ZbZclAttrReportConfigDefault(report_window_server, ZCL_WNCV_SVR_ATTR_CURR_POS_LIFT_PERCENT,
+                                        report_policy.min_intvl, report_policy.max_intvl, &change);
+  if (status != ZCL_STATUS_SUCCESS)
+  {
+    APP_ZB_DBG("Error while configuring window report, status 0x%02x", status);
+  }
+} /* App_Roller_Shutter_Report_Apply */
+
+/**
+ * @brief  Force a report of the current state when the motor is stopped
+ * Bypass the min interval to give the final state to the bound clients at once
+ * @param  None
+ * @retval None
+ */
+void App_Roller_Shutter_Report_Final(void)
+{
+  if (report_window_server == NULL)
+  {
+    return;
+  }
+
+  if (ZbZclAttrReportKick(report_window_server, true, NULL, NULL) != ZCL_STATUS_SUCCESS)
+  {
+    APP_ZB_DBG("Error while sending the final window report");
+    return;
+  }
+  report_final_nb++;
+} /* App_Roller_Shutter_Report_Final */
+
+/* Menu tuning functions -----------------------------------------------------*/
+/**
+ * @brief  Increase the minimum reporting interval
+ * @param  None
+ * @retval None
+ */
+void App_Roller_Shutter_Report_Min_Up(void)
+{
+  if ((report_policy.min_intvl + REPORT_MIN_INTVL_STEP) > REPORT_MIN_INTVL_LIMIT)
+  {
+    APP_ZB_DBG("Report min interval already at the maximum");
+    return;
+  }
+  report_policy.min_intvl += REPORT_MIN_INTVL_STEP;
+  App_Roller_Shutter_Report_Update();
+} /* App_Roller_Shutter_Report_Min_Up */
+
+/**
+ * @brief  Decrease the minimum reporting interval
+ * @param  None
+ * @retval None
+ */
+void App_Roller_Shutter_Report_Min_Down(void)
+{
+  if (report_policy.min_intvl < REPORT_MIN_INTVL_STEP)
+  {
+    APP_ZB_DBG("Report min interval already at the minimum");
+    return;
+  }
+  report_policy.min_intvl -= REPORT_MIN_INTVL_STEP;
+  App_Roller_Shutter_Report_Update();
+} /* App_Roller_Shutter_Report_Min_Down */
+
+/**
+ * @brief  Increase the maximum reporting interval
+ * Leaving the 'on change only' mode starts at the smallest allowed periodic interval
+ * @param  None
+ * @retval None
+ */
+void App_Roller_Shutter_Report_Max_Up(void)
+{
+  if (report_policy.max_intvl == ZCL_ATTR_REPORT_MAX_INTVL_CHANGE)
+  {
+    report_policy.max_intvl = ZCL_ATTR_REPORT_MAX_INTVL_MINIMUM;
+  }
+  else if ((report_policy.max_intvl + REPORT_MAX_INTVL_STEP) <= REPORT_MAX_INTVL_LIMIT)
+  {
+    report_policy.max_intvl += REPORT_MAX_INTVL_STEP;
+  }
+  else
+  {
+    APP_ZB_DBG("Report max interval already at the maximum");
+    return;
+  }
+  App_Roller_Shutter_Report_Update();
+} /* App_Roller_Shutter_Report_Max_Up */
+
+/**
+ * @brief  Decrease the maximum reporting interval
+ * Below the smallest allowed periodic interval, only report on change
+ * @param  None
+ * @retval None
+ */
+void App_Roller_Shutter_Report_Max_Down(void)
+{
+  if (report_policy.max_intvl == ZCL_ATTR_REPORT_MAX_INTVL_CHANGE)
+  {
+    APP_ZB_DBG("Report max interval already disabled");
+    return;
+  }
+
+  if (report_policy.max_intvl < (ZCL_ATTR_REPORT_MAX_INTVL_MINIMUM + REPORT_MAX_INTVL_STEP))
+  {
+    report_policy.max_intvl = ZCL_ATTR_REPORT_MAX_INTVL_CHANGE;
+  }
+  else
+  {
+    report_policy.max_intvl -= REPORT_MAX_INTVL_STEP;
+  }
+  App_Roller_Shutter_Report_Update();
+} /* App_Roller_Shutter_Report_Max_Down */
+
+/**
+ * @brief  Increase the reportable change
+ * @param  None
+ * @retval None
+ */
+void App_Roller_Shutter_Report_Change_Up(void)
+{
+  if (report_policy.change >= REPORT_CHANGE_LIMIT)
+  {
+    APP_ZB_DBG("Reportable change already at the maximum");
+    return;
+  }
+  report_policy.change++;
+  App_Roller_Shutter_Report_Update();
+} /* App_Roller_Shutter_Report_Change_Up */
+
+/**
+ * @brief  Decrease the reportable change
+ * @param  None
+ * @retval None
+ */
+void App_Roller_Shutter_Report_Change_Down(void)
+{
+  if (report_policy.change <= 1U)
+  {
+    APP_ZB_DBG("Reportable change already at the minimum");
+    return;
+  }
+  report_policy.change--;
+  App_Roller_Shutter_Report_Update();
+} /* App_Roller_Shutter_Report_Change_Down */
+
+/**
+ * @brief  For debug purpose, display the reporting policy
+ * @param  None
+ * @retval None
+ */
+void App_Roller_Shutter_Report_Disp(void)
+{
+  APP_ZB_DBG("Window report : min %ds | max %ds%s | change %d",
+             report_policy.min_intvl, report_policy.max_intvl,
+             (report_policy.max_intvl == ZCL_ATTR_REPORT_MAX_INTVL_CHANGE) ? " (on change)" : "",
+             report_policy.change);
+  APP_ZB_DBG("Final reports forced at stop : %d", report_final_nb);
+} /* App_Roller_Shutter_Report_Disp */
+
+/* Private Functions Definition ----------------------------------------------*/
+/**
+ * @brief  Read back the reporting policy from NVM, keep the defaults if not saved
+ * @param  None
+ * @retval None
+ */
+static void App_Roller_Shutter_Report_Load(void)
+{
+  uint32_t min_intvl = report_policy.min_intvl;
+  uint32_t max_intvl = report_policy.max_intvl;
+  uint32_t change    = report_policy.change;
+
+  App_NVM_Param_Read(APP_NVM_PARAM_REPORT_MIN,    &min_intvl);
+  App_NVM_Param_Read(APP_NVM_PARAM_REPORT_MAX,    &max_intvl);
+  App_NVM_Param_Read(APP_NVM_PARAM_REPORT_CHANGE, &change);
+
+  /* Discard out of range values */
+  if ((min_intvl > REPORT_MIN_INTVL_LIMIT) || (max_intvl > REPORT_MAX_INTVL_LIMIT) ||
+      ((max_intvl != ZCL_ATTR_REPORT_MAX_INTVL_CHANGE) && (max_intvl < ZCL_ATTR_REPORT_MAX_INTVL_MINIMUM)) ||
+      (change == 0U) || (change > REPORT_CHANGE_LIMIT))
+  {
+    APP_ZB_DBG("Window report policy in NVM invalid, use defaults");
+    return;
+  }
+
+  report_policy.min_intvl = (uint16_t)min_intvl;
+  report_policy.max_intvl = (uint16_t)max_intvl;
+  report_policy.change    = (uint8_t)change;
+} /* App_Roller_Shutter_Report_Load */
+
+/**
+ * @brief  Save the reporting policy in NVM
+ * @param  None
+ * @retval None
+ */
+static void App_Roller_Shutter_Report_Save(void)
+{
+  if ((App_NVM_Param_Write(APP_NVM_PARAM_REPORT_MIN,    report_policy.min_intvl) == false) ||
+      (App_NVM_Param_Write(APP_NVM_PARAM_REPORT_MAX,    report_policy.max_intvl) == false) ||
+      (App_NVM_Param_Write(APP_NVM_PARAM_REPORT_CHANGE, report_policy.change)    == false))
+  {
+    APP_ZB_DBG("Error while saving the window report policy");
+  }
+} /* App_Roller_Shutter_Report_Save */
+
+/**
+ * @brief  Apply, save and display a new reporting policy
+ * @param  None
+ * @retval None
+ */
+static void App_Roller_Shutter_Report_Update(void)
+{
+  App_Roller_Shutter_Report_Apply();
+  App_Roller_Shutter_Report_Save();
+  App_Roller_Shutter_Report_Disp();
+} /* App_Roller_Shutter_Report_Update */
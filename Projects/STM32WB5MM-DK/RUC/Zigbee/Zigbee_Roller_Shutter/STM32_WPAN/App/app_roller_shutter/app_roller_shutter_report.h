@@ -0,0 +1,69 @@
+/**
+  ******************************************************************************
+  * @file    app_roller_shutter_report.h
+  * @author  Zigbee Application Team
+  * @brief   Header for the attribute reporting policy of the Roller Shutter Endpoint.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef APP_ROLLER_SHUTTER_REPORT_H
+#define APP_ROLLER_SHUTTER_REPORT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines ----------------------------------------------------------------- */
+/* Default policy of ZCL_WNCV_SVR_ATTR_CURR_POS_LIFT_PERCENT reports.
+   The max interval stays below the staleness delay of the remote cache. */
+#define REPORT_DEFAULT_MIN_INTVL              1U     /* in s */
+#define REPORT_DEFAULT_MAX_INTVL              240U   /* in s */
+#define REPORT_DEFAULT_CHANGE                 1U
+
+/* Menu tuning steps and limits */
+#define REPORT_MIN_INTVL_STEP                 1U     /* in s */
+#define REPORT_MIN_INTVL_LIMIT                60U    /* in s */
+#define REPORT_MAX_INTVL_STEP                 60U    /* in s */
+#define REPORT_MAX_INTVL_LIMIT                3600U  /* in s */
+#define REPORT_CHANGE_LIMIT                   9U     /* ZCL_COMMAND_ADC_STOP */
+
+/* Typedef ----------------------------------------------------------------- */
+typedef struct
+{
+  uint16_t min_intvl;  /* Minimum time between two reports (in s) */
+  uint16_t max_intvl;  /* Periodic report (in s), ZCL_ATTR_REPORT_MAX_INTVL_CHANGE to disable */
+  uint8_t  change;     /* Reportable change */
+} Report_Policy_T;
+
+/* Exported Prototypes -------------------------------------------------------*/
+void App_Roller_Shutter_Report_Init      (struct ZbZclClusterT *window_server);
+void App_Roller_Shutter_Report_Apply     (void);
+void App_Roller_Shutter_Report_Final     (void);
+void App_Roller_Shutter_Report_Min_Up    (void);
+void App_Roller_Shutter_Report_Min_Down  (void);
+void App_Roller_Shutter_Report_Max_Up    (void);
+void App_Roller_Shutter_Report_Max_Down  (void);
+void App_Roller_Shutter_Report_Change_Up (void);
+void App_Roller_Shutter_Report_Change_Down(void);
+void App_Roller_Shutter_Report_Disp      (void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* APP_ROLLER_SHUTTER_REPORT_H */
@@ -19,6 +19,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "app_roller_shutter_cfg.h"
 #include "stm32_seq.h"
+#include "app_bench.h"
 
 /* Application Variable-------------------------------------------------------*/
 Window_Cov_Control_T app_Window_Cov_Control =
@@ -131,6 +132,8 @@ enum ZclStatusCodeT Window_Server_Up_Cb
 (struct ZbZclClusterT *cluster, struct ZbZclHeaderT *zclHdrPtr,
  struct ZbApsdeDataIndT *dataIndPtr, void *arg)
 {
+  APP_BENCH_START(BENCH_MOTOR_CMD);
+
   APP_ZB_DBG("Up Command : Coming From : 0x%x ",dataIndPtr->src.nwkAddr);
   
   // Check if a different command run to take it the new one and launch the motor control
@@ -162,6 +165,8 @@ enum ZclStatusCodeT Window_Server_Down_Cb
 (struct ZbZclClusterT *cluster, struct ZbZclHeaderT *zclHdrPtr,
  struct ZbApsdeDataIndT *dataIndPtr, void *arg)
 {
+  APP_BENCH_START(BENCH_MOTOR_CMD);
+
   APP_ZB_DBG("Down Command : Coming From : 0x%016llx",dataIndPtr->src.extAddr);
 
   // Check if a different command run to take it the new one
@@ -37,6 +37,7 @@
 #include "app_core.h"
 #include "app_nvm.h"
 #include "app_zigbee.h"
+#include "app_bench.h"
 
 /* Private defines -----------------------------------------------------------*/
 #define APP_ZIGBEE_STARTUP_FAIL_DELAY  500U
@@ -239,7 +240,7 @@ static void App_Zigbee_NwkJoin(void)
     struct ZbStartupT config;
    
     /* Configure Zigbee Logging (only need to do this once, but this is a good place to put it) */
-    ZbSetLogging(app_zb_info.zb, ZB_LOG_MASK_LEVEL_5, NULL);
+    App_Zigbee_Set_Logging();
 
     /* Attempt to join a zigbee network */
     ZbStartupConfigGetProDefaults(&config);
@@ -339,7 +340,7 @@ void App_Zigbee_Channel_Disp(void)
       UTIL_LCD_ClearStringLine(DK_LCD_CHANNEL_LINE);
       sprintf(disp_chan, "Join Channel : %2d", active_channel);
       UTIL_LCD_DisplayStringAt(0, LINE(DK_LCD_CHANNEL_LINE), (uint8_t *)disp_chan, CENTER_MODE);
-      BSP_LCD_Refresh(0);
+      App_Core_Display_Update();
 
       APP_ZB_DBG(disp_chan);
     }
@@ -419,6 +420,36 @@ void App_Zigbee_TxPwr_Down(void)
   App_Zigbee_Set_TxPwr(app_zb_info.tx_power - TX_POWER_STEP);
 } /* App_Zigbee_TxPwr_Down */
 
+/**
+ * @brief  Apply the runtime level of the Zigbee API log region to the stack logs
+ * @param  None
+ * @retval None
+ */
+void App_Zigbee_Set_Logging(void)
+{
+  uint32_t mask;
+
+  switch (logGetLevel(APPLI_LOG_REGION_ZIGBEE_API))
+  {
+    case LOG_LEVEL_NONE:
+      mask = ZB_LOG_MASK_LEVEL_0;
+      break;
+    case LOG_LEVEL_CRIT:
+      mask = ZB_LOG_MASK_LEVEL_1;
+      break;
+    case LOG_LEVEL_WARN:
+      mask = ZB_LOG_MASK_LEVEL_3;
+      break;
+    case LOG_LEVEL_INFO:
+      mask = ZB_LOG_MASK_LEVEL_4;
+      break;
+    default:
+      mask = ZB_LOG_MASK_LEVEL_5;
+      break;
+  }
+  ZbSetLogging(app_zb_info.zb, mask, NULL);
+} /* App_Zigbee_Set_Logging */
+
 /**
  * @brief Display the new Value of Tx Power on LCD
  * @param  None
@@ -716,10 +747,14 @@ void ZIGBEE_CmdTransfer(void)
    * + ID (4 bytes) + Size (4 bytes) */
   p_ZIGBEE_otcmdbuffer->cmdserial.cmd.plen = 8U + (cmd_req->Size * 4U);
 
+  APP_BENCH_START(BENCH_ZB_CMD_TRANSFER);
+
   TL_ZIGBEE_SendM4RequestToM0();
 
   /* Wait completion of cmd */
   Wait_Getting_Ack_From_M0();
+
+  APP_BENCH_STOP(BENCH_ZB_CMD_TRANSFER);
 } /* ZIGBEE_CmdTransfer */
 
 /**
@@ -83,6 +83,7 @@ void App_Zigbee_All_Address_Disp    (void);
 void App_Zigbee_TxPwr_Up            (void);
 void App_Zigbee_TxPwr_Down          (void);
 void App_Zigbee_TxPwr_Disp          (void);
+void App_Zigbee_Set_Logging         (void);
 void App_Zigbee_Permit_Join         (void);
 void App_Zigbee_Unbind_All          (void);
 void App_Zigbee_Bind_Disp           (void);
@@ -0,0 +1,713 @@
+/**
+  ******************************************************************************
+  * @file    amm_test.c
+  * @author  Zigbee Application Team
+  * @brief   Test of the advanced memory manager utility.
+  *          The unmodified advanced_memory_manager.c runs over the stm32_mm.c
+  *          basic memory manager. The pool sizing at init and the decoding of
+  *          the buffer header are checked first, then random allocations and
+  *          releases from the shared pool and three Virtual Memories are
+  *          checked against a model of the occupation, of the statistics and
+  *          of the retry callbacks: the callbacks shall be called back in the
+  *          order of their first failure and never be queued twice.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Code under test, built as is with the list and the basic memory manager it uses */
+#include "stm_list.c"
+#include "stm32_mm.c"
+#include "advanced_memory_manager.c"
+
+/* Private defines -----------------------------------------------------------*/
+#define TEST_POOL_SIZE          2048U   /* In 32bits */
+#define TEST_VM_NB              3U
+#define TEST_BUFFERS_MAX        64U
+#define TEST_WAITERS_NB         8U
+#define TEST_MAX_SIZE           512U    /* Largest buffer asked, in 32bits */
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t  *p_data;
+  uint32_t  size;
+  uint8_t   id;
+  uint32_t  seed;
+} Test_Buffer_t;
+
+/* Owner of a retry callback: retries the same allocation until it succeeds */
+typedef struct
+{
+  AMM_VirtualMemoryCallbackFunction_t cb;
+  Test_Buffer_t buf;
+  bool      waiting;
+  bool      active;       /* Moved to the active callbacks by a release */
+  uint32_t  rank;         /* Order of the first failure */
+  uint32_t  start;        /* Tick of the first failure */
+} Test_Waiter_t;
+
+/* Model of the statistics of the shared pool or of a Virtual Memory */
+typedef struct
+{
+  uint8_t   id;
+  uint32_t  required;
+  uint32_t  occupied;
+  uint32_t  high;
+  uint32_t  size_failures;
+  uint32_t  alloc_failures;
+} Test_Model_t;
+
+/* Private variables ---------------------------------------------------------*/
+uint32_t Sim_Tick;
+
+static uint32_t       test_pool[TEST_POOL_SIZE];
+static Test_Buffer_t  test_buffers[TEST_BUFFERS_MAX];
+static Test_Waiter_t  test_waiters[TEST_WAITERS_NB];
+static AMM_VirtualMemoryConfig_t test_vm_config[TEST_VM_NB] =
+{
+  /* The IDs with the upper bit set check the header decoding */
+  { 0x01U, 64U },
+  { 0x80U, 256U },
+  { 0xFFU, 128U },
+};
+static Test_Model_t   test_shared;
+static Test_Model_t   test_vm[TEST_VM_NB];
+static AMM_Stats_t    test_stats;
+static uint32_t       test_rng = 0x2545F491U;
+static uint32_t       test_rank;
+static uint32_t       test_last_rank;
+static uint32_t       test_retries;
+static long           test_served;
+static long           test_waits;
+static bool           test_process_requested;
+static long           test_failures;
+static long           test_op;
+
+/* Private functions ---------------------------------------------------------*/
+#define TEST_CHECK(cond, ...) \
+  do \
+  { \
+    if (!(cond)) \
+    { \
+      if (test_failures < 20) \
+      { \
+        printf("FAIL op %ld: ", test_op); \
+        printf(__VA_ARGS__); \
+        printf("\n"); \
+      } \
+      test_failures++; \
+    } \
+  } while (0)
+
+static uint32_t Test_Random(void)
+{
+  test_rng ^= test_rng << 13;
+  test_rng ^= test_rng >> 17;
+  test_rng ^= test_rng << 5;
+  return test_rng;
+}
+
+/* Basic memory manager, the AMM gives the sizes in 32bits */
+static void Test_BmmInit(uint32_t * const p_PoolAddr, const uint32_t PoolSize)
+{
+  UTIL_MM_Init((uint8_t *)p_PoolAddr, PoolSize * sizeof(uint32_t));
+}
+
+static uint32_t * Test_BmmAllocate(const uint32_t BufferSize)
+{
+  return (uint32_t *)UTIL_MM_GetBuffer(BufferSize * sizeof(uint32_t));
+}
+
+static void Test_BmmFree(uint32_t * const p_BufferAddr)
+{
+  UTIL_MM_ReleaseBuffer(p_BufferAddr);
+}
+
+void AMM_RegisterBasicMemoryManager(AMM_BasicMemoryManagerFunctions_t * const p_BasicMemoryManagerFunctions)
+{
+  p_BasicMemoryManagerFunctions->Init = Test_BmmInit;
+  p_BasicMemoryManagerFunctions->Allocate = Test_BmmAllocate;
+  p_BasicMemoryManagerFunctions->Free = Test_BmmFree;
+}
+
+void AMM_ProcessRequest(void)
+{
+  test_process_requested = true;
+}
+
+static void Test_Fill(const Test_Buffer_t * p_buf)
+{
+  uint32_t i;
+
+  for (i = 0U; i < p_buf->size; i++)
+  {
+    p_buf->p_data[i] = p_buf->seed + (i * 0x9E3779B9U);
+  }
+}
+
+static bool Test_Intact(const Test_Buffer_t * p_buf)
+{
+  uint32_t i;
+
+  for (i = 0U; i < p_buf->size; i++)
+  {
+    if (p_buf->p_data[i] != (p_buf->seed + (i * 0x9E3779B9U)))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static Test_Model_t * Test_Model(uint8_t id)
+{
+  uint32_t i;
+
+  if (id == AMM_NO_VIRTUAL_ID)
+  {
+    return &test_shared;
+  }
+  for (i = 0U; i < TEST_VM_NB; i++)
+  {
+    if (test_vm[i].id == id)
+    {
+      return &test_vm[i];
+    }
+  }
+  return NULL;
+}
+
+/* Space usable by an allocation, as checked by AMM_Alloc */
+static uint32_t Test_Available(uint8_t id)
+{
+  Test_Model_t * p_model = Test_Model(id);
+  uint32_t available = TEST_POOL_SIZE - test_shared.occupied - (TEST_POOL_SIZE - test_shared.required);
+
+  if ((p_model != &test_shared) && (p_model->occupied < p_model->required))
+  {
+    available += p_model->required - p_model->occupied;
+  }
+  return available;
+}
+
+/* Occupation after an allocation or a release, the shared pool lends what a Virtual Memory uses beyond its
+ * reserved size */
+static void Test_Occupy(uint8_t id, uint32_t size, bool alloc)
+{
+  Test_Model_t * p_model = Test_Model(id);
+  uint32_t over_before;
+  uint32_t over_after;
+
+  if (p_model == &test_shared)
+  {
+    test_shared.occupied = alloc ? (test_shared.occupied + size + 1U) : (test_shared.occupied - size - 1U);
+  }
+  else
+  {
+    over_before = (p_model->occupied > p_model->required) ? (p_model->occupied - p_model->required) : 0U;
+    p_model->occupied = alloc ? (p_model->occupied + size + 1U) : (p_model->occupied - size - 1U);
+    over_after = (p_model->occupied > p_model->required) ? (p_model->occupied - p_model->required) : 0U;
+    test_shared.occupied = test_shared.occupied + over_after - over_before;
+    p_model->high = MAX(p_model->high, p_model->occupied);
+  }
+  test_shared.high = MAX(test_shared.high, test_shared.occupied);
+}
+
+static uint32_t Test_WaitingNb(void)
+{
+  uint32_t nb = 0U;
+  uint32_t i;
+
+  for (i = 0U; i < TEST_WAITERS_NB; i++)
+  {
+    nb += test_waiters[i].waiting ? 1U : 0U;
+  }
+  return nb;
+}
+
+static void Test_Waiting(Test_Waiter_t * p_waiter)
+{
+  p_waiter->waiting = true;
+  p_waiter->active = false;
+  p_waiter->rank = test_rank++;
+  p_waiter->start = Sim_Tick;
+  test_waits++;
+  test_stats.WaitingNb++;
+  test_stats.WaitingMaxNb = MAX(test_stats.WaitingMaxNb, test_stats.WaitingNb);
+}
+
+/* Allocation checked against the model, p_waiter is NULL for an allocation without callback */
+static AMM_Function_Error_t Test_Alloc(Test_Buffer_t * p_buf, Test_Waiter_t * p_waiter, bool retry)
+{
+  Test_Model_t * p_model = Test_Model(p_buf->id);
+  bool fits = (p_model != NULL) && (p_buf->size < Test_Available(p_buf->id));
+  AMM_Function_Error_t error;
+  uint32_t * p_data = NULL;
+  uint32_t latency;
+  uint32_t bucket = 0U;
+
+  error = AMM_Alloc(p_buf->id, p_buf->size, &p_data, (p_waiter != NULL) ? &p_waiter->cb : NULL);
+
+  if (p_model == NULL)
+  {
+    TEST_CHECK(error == AMM_ERROR_UNKNOWN_ID, "ID 0x%02X unknown, error %d", p_buf->id, error);
+    return error;
+  }
+
+  if (!fits)
+  {
+    TEST_CHECK(error == AMM_ERROR_BAD_ALLOCATION_SIZE, "ID 0x%02X size %u above %u, error %d",
+               p_buf->id, p_buf->size, Test_Available(p_buf->id), error);
+    p_model->size_failures++;
+  }
+  else if (error == AMM_ERROR_ALLOCATION_FAILED)
+  {
+    /* Pool fragmented, the basic memory manager is checked by its own soak test */
+    p_model->alloc_failures++;
+  }
+  else
+  {
+    TEST_CHECK(error == AMM_ERROR_OK, "ID 0x%02X size %u below %u, error %d",
+               p_buf->id, p_buf->size, Test_Available(p_buf->id), error);
+  }
+
+  if (error == AMM_ERROR_OK)
+  {
+    TEST_CHECK((p_data > test_pool) && ((p_data + p_buf->size) <= (test_pool + TEST_POOL_SIZE)),
+               "buffer out of the pool");
+    p_buf->p_data = p_data;
+    p_buf->seed = Test_Random();
+    Test_Fill(p_buf);
+    Test_Occupy(p_buf->id, p_buf->size, true);
+
+    if (retry)
+    {
+      latency = Sim_Tick - p_waiter->start;
+      while (((latency >> bucket) > 1U) && (bucket < (AMM_RETRY_LATENCY_NB - 1U)))
+      {
+        bucket++;
+      }
+      test_stats.RetryNb++;
+      test_stats.RetryLatency[bucket]++;
+      test_served++;
+      test_stats.RetryLatencyMax = MAX(test_stats.RetryLatencyMax, latency);
+      p_waiter->waiting = false;
+    }
+  }
+  else if ((p_waiter != NULL) && !p_waiter->waiting)
+  {
+    Test_Waiting(p_waiter);
+  }
+  else if (retry)
+  {
+    /* Failed again, keeps its rank and waits for the next release */
+    test_stats.WaitingNb++;
+    test_stats.WaitingMaxNb = MAX(test_stats.WaitingMaxNb, test_stats.WaitingNb);
+  }
+  else
+  {
+    /* Already waiting, shall not be queued twice */
+  }
+
+  return error;
+}
+
+/* Retry callback of a waiter, called by AMM_BackgroundProcess */
+static void Test_Retry(uint32_t index)
+{
+  Test_Waiter_t * p_waiter = &test_waiters[index];
+
+  TEST_CHECK(p_waiter->waiting && p_waiter->active, "waiter %u called back while %s", index,
+             p_waiter->waiting ? "pending" : "not waiting");
+  TEST_CHECK((test_retries == 0U) || (p_waiter->rank > test_last_rank),
+             "waiter %u of rank %u called back after rank %u", index, p_waiter->rank, test_last_rank);
+  test_last_rank = p_waiter->rank;
+  test_retries++;
+  if (test_retries > TEST_WAITERS_NB)
+  {
+    /* A callback queued twice loops in the lists */
+    printf("FAIL op %ld: %u callbacks called back in a background process\n", test_op, test_retries);
+    exit(1);
+  }
+  test_stats.WaitingNb--;
+  p_waiter->active = false;
+
+  (void)Test_Alloc(&p_waiter->buf, p_waiter, true);
+}
+
+#define TEST_RETRY(n)   static void Test_Retry##n(void) { Test_Retry(n); }
+TEST_RETRY(0) TEST_RETRY(1) TEST_RETRY(2) TEST_RETRY(3) TEST_RETRY(4) TEST_RETRY(5) TEST_RETRY(6) TEST_RETRY(7)
+
+static void (* const test_retry_cb[TEST_WAITERS_NB])(void) =
+{
+  Test_Retry0, Test_Retry1, Test_Retry2, Test_Retry3, Test_Retry4, Test_Retry5, Test_Retry6, Test_Retry7,
+};
+
+static void Test_Free(Test_Buffer_t * p_buf)
+{
+  AMM_Function_Error_t error;
+  uint32_t i;
+
+  TEST_CHECK(Test_Intact(p_buf), "ID 0x%02X buffer of %u overwritten", p_buf->id, p_buf->size);
+
+  test_process_requested = false;
+  error = AMM_Free(p_buf->p_data);
+  TEST_CHECK(error == AMM_ERROR_OK, "release of ID 0x%02X, error %d", p_buf->id, error);
+  TEST_CHECK(test_process_requested, "no background process requested");
+  Test_Occupy(p_buf->id, p_buf->size, false);
+  p_buf->p_data = NULL;
+
+  /* Every pending callback is now to be called back */
+  for (i = 0U; i < TEST_WAITERS_NB; i++)
+  {
+    test_waiters[i].active = test_waiters[i].waiting;
+  }
+}
+
+static void Test_Background(void)
+{
+  uint32_t i;
+
+  test_retries = 0U;
+  AMM_BackgroundProcess();
+
+  for (i = 0U; i < TEST_WAITERS_NB; i++)
+  {
+    TEST_CHECK(!test_waiters[i].active, "waiter %u not called back", i);
+    test_waiters[i].active = false;
+  }
+}
+
+static void Test_CheckModel(const Test_Model_t * p_model)
+{
+  AMM_VirtualMemoryStats_t stats;
+  AMM_Function_Error_t error;
+
+  error = AMM_GetVirtualMemoryStats(p_model->id, &stats);
+  TEST_CHECK(error == AMM_ERROR_OK, "stats of ID 0x%02X, error %d", p_model->id, error);
+  TEST_CHECK((stats.Id == p_model->id) && (stats.RequiredSize == p_model->required)
+             && (stats.OccupiedSize == p_model->occupied) && (stats.HighWaterMark == p_model->high)
+             && (stats.SizeFailureNb == p_model->size_failures)
+             && (stats.AllocationFailureNb == p_model->alloc_failures),
+             "ID 0x%02X: required %u/%u occupied %u/%u high %u/%u size failures %u/%u alloc failures %u/%u",
+             p_model->id, stats.RequiredSize, p_model->required, stats.OccupiedSize, p_model->occupied,
+             stats.HighWaterMark, p_model->high, stats.SizeFailureNb, p_model->size_failures,
+             stats.AllocationFailureNb, p_model->alloc_failures);
+}
+
+static void Test_CheckStats(void)
+{
+  AMM_Stats_t stats;
+  uint32_t i;
+
+  Test_CheckModel(&test_shared);
+  for (i = 0U; i < TEST_VM_NB; i++)
+  {
+    Test_CheckModel(&test_vm[i]);
+  }
+
+  TEST_CHECK(AMM_GetStats(&stats) == AMM_ERROR_OK, "retry stats");
+  TEST_CHECK(memcmp(&stats, &test_stats, sizeof(stats)) == 0,
+             "retries %u/%u latency max %u/%u waiting %u/%u max %u/%u", stats.RetryNb, test_stats.RetryNb,
+             stats.RetryLatencyMax, test_stats.RetryLatencyMax, stats.WaitingNb, test_stats.WaitingNb,
+             stats.WaitingMaxNb, test_stats.WaitingMaxNb);
+  TEST_CHECK(test_stats.WaitingNb == Test_WaitingNb(), "model waiting %u, waiters %u", test_stats.WaitingNb,
+             Test_WaitingNb());
+
+  if (stats.WaitingNb != test_stats.WaitingNb)
+  {
+    /* A callback queued twice or lost, the callback lists cannot be walked anymore */
+    printf("FAIL: %ld failures\n", test_failures);
+    exit(1);
+  }
+}
+
+static AMM_Function_Error_t Test_Init(uint32_t pool_size, uint32_t element_size)
+{
+  AMM_InitParameters_t params;
+  uint32_t i;
+
+  params.p_PoolAddr = test_pool;
+  params.PoolSize = pool_size;
+  params.VirtualMemoryNumber = TEST_VM_NB;
+  params.p_VirtualMemoryConfigList = test_vm_config;
+
+  memset(&test_shared, 0, sizeof(test_shared));
+  memset(test_vm, 0, sizeof(test_vm));
+  memset(&test_stats, 0, sizeof(test_stats));
+
+  test_shared.id = AMM_NO_VIRTUAL_ID;
+  test_shared.required = pool_size;
+  test_shared.occupied = TEST_VM_NB * element_size;
+  test_shared.high = test_shared.occupied;
+  for (i = 0U; i < TEST_VM_NB; i++)
+  {
+    test_vm[i].id = test_vm_config[i].Id;
+    test_vm[i].required = test_vm_config[i].BufferSize;
+    test_shared.required -= test_vm_config[i].BufferSize;
+  }
+
+  return AMM_Init(&params);
+}
+
+/* The pool shall hold the Virtual Memory info elements besides the reserved sizes */
+static void Test_Sizing(void)
+{
+  uint32_t reserved = 0U;
+  uint32_t i;
+
+  TEST_CHECK(sizeof(VirtualMemoryInfo_t) == (AMM_VIRTUAL_INFO_ELEMENT_SIZE * sizeof(uint32_t)),
+             "info element of %zu bytes", sizeof(VirtualMemoryInfo_t));
+
+  for (i = 0U; i < TEST_VM_NB; i++)
+  {
+    reserved += test_vm_config[i].BufferSize;
+  }
+
+  /* Sized with the element of 3 words used before the statistics */
+  TEST_CHECK(Test_Init(reserved + (TEST_VM_NB * 3U), AMM_VIRTUAL_INFO_ELEMENT_SIZE) == AMM_ERROR_BAD_VIRTUAL_CONFIG,
+             "pool sized with the former element accepted");
+
+  TEST_CHECK(Test_Init(reserved + (TEST_VM_NB * AMM_VIRTUAL_INFO_ELEMENT_SIZE),
+                       AMM_VIRTUAL_INFO_ELEMENT_SIZE) == AMM_ERROR_OK, "pool of the documented size refused");
+  Test_CheckStats();
+  TEST_CHECK(AMM_DeInit() == AMM_ERROR_OK, "deinit");
+}
+
+/* The ID and the size shall be read back from the header of each buffer */
+static void Test_Header(void)
+{
+  static const uint8_t ids[] = { AMM_NO_VIRTUAL_ID, 0x01U, 0x80U, 0xFFU };
+  static uint32_t outside[2];
+  Test_Buffer_t buf;
+  uint32_t i;
+
+  TEST_CHECK(Test_Init(TEST_POOL_SIZE, AMM_VIRTUAL_INFO_ELEMENT_SIZE) == AMM_ERROR_OK, "init");
+
+  for (i = 0U; i < (sizeof(ids) / sizeof(ids[0])); i++)
+  {
+    buf.id = ids[i];
+    buf.size = 100U + i;
+    TEST_CHECK(Test_Alloc(&buf, NULL, false) == AMM_ERROR_OK, "ID 0x%02X allocation", buf.id);
+    Test_CheckStats();
+    Test_Free(&buf);
+    Test_CheckStats();
+  }
+
+  TEST_CHECK(AMM_Free(NULL) == AMM_ERROR_BAD_POINTER, "NULL release");
+  TEST_CHECK(AMM_Free(&outside[1]) == AMM_ERROR_OUT_OF_RANGE, "release out of the pool");
+  TEST_CHECK(AMM_DeInit() == AMM_ERROR_OK, "deinit");
+}
+
+static void Test_RandomBuffer(Test_Buffer_t * p_buf)
+{
+  uint32_t kind = Test_Random() % 100U;
+
+  p_buf->id = (kind < 30U) ? AMM_NO_VIRTUAL_ID : test_vm_config[kind % TEST_VM_NB].Id;
+  if ((kind % 50U) == 0U)
+  {
+    /* Unknown ID */
+    p_buf->id = 0x42U;
+  }
+
+  kind = Test_Random() % 100U;
+  if (kind < 70U)
+  {
+    p_buf->size = 1U + (Test_Random() % 32U);
+  }
+  else if (kind < 97U)
+  {
+    p_buf->size = 32U + (Test_Random() % 160U);
+  }
+  else
+  {
+    p_buf->size = 192U + (Test_Random() % (TEST_MAX_SIZE - 191U));
+  }
+}
+
+static void Test_Soak(long nb_ops)
+{
+  Test_Waiter_t * p_waiter;
+  Test_Buffer_t * p_buf;
+  uint32_t idx;
+  uint32_t op;
+  uint32_t i;
+
+  TEST_CHECK(Test_Init(TEST_POOL_SIZE, AMM_VIRTUAL_INFO_ELEMENT_SIZE) == AMM_ERROR_OK, "init");
+  memset(test_buffers, 0, sizeof(test_buffers));
+  memset(test_waiters, 0, sizeof(test_waiters));
+  for (i = 0U; i < TEST_WAITERS_NB; i++)
+  {
+    test_waiters[i].cb.Callback = test_retry_cb[i];
+  }
+
+  for (test_op = 0; test_op < nb_ops; test_op++)
+  {
+    Sim_Tick += 1U + (Test_Random() % 4U);
+    op = Test_Random() % 100U;
+
+    if (op < 30U)
+    {
+      /* Allocation without callback */
+      p_buf = &test_buffers[Test_Random() % TEST_BUFFERS_MAX];
+      if (p_buf->p_data == NULL)
+      {
+        Test_RandomBuffer(p_buf);
+        (void)Test_Alloc(p_buf, NULL, false);
+      }
+    }
+    else if (op < 45U)
+    {
+      /* Allocation with a retry callback */
+      p_waiter = &test_waiters[Test_Random() % TEST_WAITERS_NB];
+      if ((p_waiter->buf.p_data == NULL) && !p_waiter->waiting)
+      {
+        do
+        {
+          Test_RandomBuffer(&p_waiter->buf);
+        } while (Test_Model(p_waiter->buf.id) == NULL);
+        /* Large enough to wait often */
+        p_waiter->buf.size += TEST_MAX_SIZE / 4U;
+        (void)Test_Alloc(&p_waiter->buf, p_waiter, false);
+      }
+    }
+    else if (op < 48U)
+    {
+      /* Allocation that cannot succeed with the callback of a waiter, the callback keeps its rank */
+      p_waiter = &test_waiters[Test_Random() % TEST_WAITERS_NB];
+      if (p_waiter->waiting)
+      {
+        Test_Buffer_t big = p_waiter->buf;
+        big.size = TEST_POOL_SIZE;
+        (void)Test_Alloc(&big, p_waiter, false);
+      }
+    }
+    else if (op < 85U)
+    {
+      /* Release, of a waiter buffer sometimes */
+      idx = Test_Random() % (TEST_BUFFERS_MAX + TEST_WAITERS_NB);
+      p_buf = (idx < TEST_BUFFERS_MAX) ? &test_buffers[idx] : &test_waiters[idx - TEST_BUFFERS_MAX].buf;
+      if (p_buf->p_data != NULL)
+      {
+        Test_Free(p_buf);
+        /* The background process may run after other failures */
+        if ((Test_Random() % 4U) != 0U)
+        {
+          Test_Background();
+        }
+      }
+    }
+    else if (op < 99U)
+    {
+      Test_Background();
+    }
+    else
+    {
+      AMM_ResetStats();
+      test_shared.high = test_shared.occupied;
+      test_shared.size_failures = 0U;
+      test_shared.alloc_failures = 0U;
+      for (i = 0U; i < TEST_VM_NB; i++)
+      {
+        test_vm[i].high = test_vm[i].occupied;
+        test_vm[i].size_failures = 0U;
+        test_vm[i].alloc_failures = 0U;
+      }
+      i = test_stats.WaitingNb;
+      memset(&test_stats, 0, sizeof(test_stats));
+      test_stats.WaitingNb = i;
+      test_stats.WaitingMaxNb = i;
+    }
+
+    Test_CheckStats();
+
+    if ((test_op % 256) == 0)
+    {
+      for (i = 0U; i < TEST_BUFFERS_MAX; i++)
+      {
+        TEST_CHECK((test_buffers[i].p_data == NULL) || Test_Intact(&test_buffers[i]), "buffer %u overwritten", i);
+      }
+    }
+  }
+
+  /* Release everything, the waiters get their buffers and release them too */
+  for (i = 0U; i < TEST_BUFFERS_MAX; i++)
+  {
+    if (test_buffers[i].p_data != NULL)
+    {
+      Test_Free(&test_buffers[i]);
+      Test_Background();
+    }
+  }
+  for (i = 0U; i < TEST_WAITERS_NB; i++)
+  {
+    if (test_waiters[i].buf.p_data != NULL)
+    {
+      Test_Free(&test_waiters[i].buf);
+      Test_Background();
+    }
+  }
+  for (i = 0U; i < TEST_WAITERS_NB; i++)
+  {
+    TEST_CHECK(!test_waiters[i].waiting, "waiter %u still waiting on an empty pool", i);
+    if (test_waiters[i].buf.p_data != NULL)
+    {
+      Test_Free(&test_waiters[i].buf);
+      Test_Background();
+    }
+  }
+  Test_CheckStats();
+  TEST_CHECK(test_shared.occupied == (TEST_VM_NB * AMM_VIRTUAL_INFO_ELEMENT_SIZE), "shared pool leaks %u",
+             test_shared.occupied - (TEST_VM_NB * AMM_VIRTUAL_INFO_ELEMENT_SIZE));
+
+  TEST_CHECK((test_waits > 0) && (test_served == test_waits), "%ld callbacks waited, %ld served", test_waits,
+             test_served);
+  printf("%ld operations, %ld callbacks waited and served\n", nb_ops, test_served);
+  TEST_CHECK(AMM_DeInit() == AMM_ERROR_OK, "deinit");
+}
+
+static void Usage(void)
+{
+  printf("usage: amm_test [-n operations]\n");
+  exit(2);
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char * argv[])
+{
+  long nb_ops = 200000;
+  int arg;
+
+  for (arg = 1; arg < argc; arg++)
+  {
+    if ((strcmp(argv[arg], "-n") == 0) && ((arg + 1) < argc))
+    {
+      nb_ops = atol(argv[++arg]);
+    }
+    else
+    {
+      Usage();
+    }
+  }
+
+  Test_Sizing();
+  Test_Header();
+  Test_Soak(nb_ops);
+
+  printf("%s: %ld failures\n", (test_failures == 0) ? "PASS" : "FAIL", test_failures);
+  return (test_failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,32 @@
+/**
+  ******************************************************************************
+  * @file    utilities_conf.h
+  * @author  Zigbee Application Team
+  * @brief   Host configuration of the advanced memory manager: the test has a
+  *          single context, the retry latency is counted in test operations
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef UTILITIES_CONF_H
+#define UTILITIES_CONF_H
+
+#include <stdint.h>
+
+#define UTIL_SEQ_INIT_CRITICAL_SECTION( )
+#define UTIL_SEQ_ENTER_CRITICAL_SECTION( )
+#define UTIL_SEQ_EXIT_CRITICAL_SECTION( )
+
+extern uint32_t Sim_Tick;
+#define AMM_GET_TIMESTAMP()                     (Sim_Tick)
+
+#endif /* UTILITIES_CONF_H */
@@ -0,0 +1,22 @@
+/**
+  ******************************************************************************
+  * @file    stm32_lcd.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the LCD utility, not used by the light level
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef STM32_LCD_H
+#define STM32_LCD_H
+
+#endif /* STM32_LCD_H */
@@ -0,0 +1,22 @@
+/**
+  ******************************************************************************
+  * @file    stm32wb5mm_dk_lcd.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the DK LCD BSP, not used by the light level
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef STM32WB5MM_DK_LCD_H
+#define STM32WB5MM_DK_LCD_H
+
+#endif /* STM32WB5MM_DK_LCD_H */
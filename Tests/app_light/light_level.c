@@ -0,0 +1,534 @@
+/**
+  ******************************************************************************
+  * @file    light_level.c
+  * @author  Zigbee Application Team
+  * @brief   Transition check of the light level.
+  *          The unmodified app_light_level.c receives Move To Level and Move
+  *          commands while its timer runs on a simulated RTC of 488 us ticks
+  *          and its tasks on a simulated sequencer. Each update of the Leds
+  *          is recorded: the transitions shall end on the target at their
+  *          end time, the levels shall move toward the target without jump,
+  *          two updates of a transition shall not be closer than the frame
+  *          period, and a new command shall retarget the transition without
+  *          queuing updates.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+/* The stub configuration comes first: the include guards it shares with the
+ * application headers keep them out */
+#include "app_conf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Code under test, built as is to reach the transition state */
+#include "app_light_level.c"
+
+/* Private defines -----------------------------------------------------------*/
+/* Simulated time in ps, the RTC tick is 16 / 32768 s */
+#define PS_PER_MS               1000000000ULL
+#define PS_PER_TICK             488281250ULL
+
+/* Frame period between two updates */
+#define FRAME_PERIOD_PS         (LIGHT_LEVEL_FRAME_PERIOD * PS_PER_MS)
+
+/* Allowed lateness of the last update, in ms of HAL_GetTick() */
+#define END_MAX_LATE            1U
+
+#define UPDATE_MAX              4096U
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  uint64_t time;                /* ps */
+  uint8_t  level;
+} Update_t;
+
+/* Private variables ---------------------------------------------------------*/
+Light_Control_T             app_Light_Control;
+appliLogLevel_t             logRegionLevel[APPLI_LOG_REGION_NB];
+
+static long                 failures;
+static uint32_t             sim_rng = 0x2545F491U;
+
+/* Simulated clock, timer and sequencer */
+static uint64_t             sim_time;
+static HW_TS_pTimerCb_t     sim_timer_cb;
+static bool                 sim_timer_armed;
+static uint64_t             sim_timer_expiry;
+static void                 (*sim_tasks[CFG_TASK_NBR])(void);
+static uint32_t             sim_pending;
+static uint32_t             sim_timer_starts;
+
+/* CurrentLevel attribute */
+static uint32_t             attr_writes;
+static long long            attr_value;
+
+/* Leds updates */
+static Update_t             updates[UPDATE_MAX];
+static uint32_t             update_nb;
+
+/* Private functions ---------------------------------------------------------*/
+#define CHECK(cond, ...) \
+  do \
+  { \
+    if (!(cond)) \
+    { \
+      if (failures < 20) \
+      { \
+        fprintf(stderr, "  "); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+      } \
+      failures++; \
+    } \
+  } while (0)
+
+static uint32_t Sim_Random(void)
+{
+  sim_rng ^= sim_rng << 13;
+  sim_rng ^= sim_rng >> 17;
+  sim_rng ^= sim_rng << 5;
+  return sim_rng;
+}
+
+/* Simulated platform --------------------------------------------------------*/
+uint32_t HAL_GetTick(void)
+{
+  return (uint32_t)(sim_time / PS_PER_MS);
+}
+
+HW_TS_ReturnStatus_t HW_TS_Create(uint32_t TimerProcessID, uint8_t *pTimerId, HW_TS_Mode_t TimerMode, HW_TS_pTimerCb_t pTimerCallBack)
+{
+  (void)TimerProcessID;
+  CHECK(TimerMode == hw_ts_SingleShot, "repeated transition timer");
+  *pTimerId    = 0U;
+  sim_timer_cb = pTimerCallBack;
+  return hw_ts_Successful;
+}
+
+void HW_TS_Stop(uint8_t TimerID)
+{
+  (void)TimerID;
+  sim_timer_armed = false;
+}
+
+void HW_TS_Start(uint8_t TimerID, uint32_t timeout_ticks)
+{
+  (void)TimerID;
+  CHECK(sim_timer_armed == false, "transition timer started twice");
+  sim_timer_armed  = true;
+  sim_timer_expiry = sim_time + (timeout_ticks * PS_PER_TICK);
+  sim_timer_starts++;
+}
+
+void UTIL_SEQ_RegTask(UTIL_SEQ_bm_t TaskId_bm, uint32_t Flags, void (*Task)(void))
+{
+  uint32_t task;
+
+  (void)Flags;
+  for (task = 0U; task < CFG_TASK_NBR; task++)
+  {
+    if ((TaskId_bm & (1U << task)) != 0U)
+    {
+      sim_tasks[task] = Task;
+    }
+  }
+}
+
+void UTIL_SEQ_SetTask(UTIL_SEQ_bm_t TaskId_bm, uint32_t Task_Prio)
+{
+  (void)Task_Prio;
+  sim_pending |= TaskId_bm;
+}
+
+void logDeferred(appliLogLevel_t aLogLevel, appliLogRegion_t aLogRegion, const char *aFile, const char *aFormat, ...)
+{
+  (void)aLogLevel;
+  (void)aLogRegion;
+  (void)aFile;
+  (void)aFormat;
+}
+
+/* Zigbee stack, only the CurrentLevel attribute is kept */
+struct ZbZclClusterT * ZbZclLevelServerAlloc(struct ZigBeeT *zb, uint8_t endpoint, struct ZbZclClusterT *onoff_server,
+                                             struct ZbZclLevelServerCallbacksT *callbacks, void *arg)
+{
+  static uint32_t cluster;
+
+  (void)zb;
+  (void)endpoint;
+  (void)onoff_server;
+  (void)callbacks;
+  (void)arg;
+  return (struct ZbZclClusterT *)&cluster;
+}
+
+bool ZbZclClusterEndpointRegister(struct ZbZclClusterT *cluster)
+{
+  (void)cluster;
+  return true;
+}
+
+enum ZclStatusCodeT ZbZclAttrAppendList(struct ZbZclClusterT *cluster, const struct ZbZclAttrT *attrList, unsigned int num_attrs)
+{
+  (void)cluster;
+  (void)attrList;
+  (void)num_attrs;
+  return ZCL_STATUS_SUCCESS;
+}
+
+void ZbZclClusterFree(struct ZbZclClusterT *cluster)
+{
+  (void)cluster;
+}
+
+enum ZclStatusCodeT ZbZclAttrRead(struct ZbZclClusterT *cluster, uint16_t attrId, enum ZclDataTypeT *attrType,
+                                  void *outputBuf, unsigned int max_len, bool isReporting)
+{
+  (void)cluster;
+  (void)attrId;
+  (void)attrType;
+  (void)outputBuf;
+  (void)max_len;
+  (void)isReporting;
+  return ZCL_STATUS_FAILURE;
+}
+
+enum ZclStatusCodeT ZbZclAttrIntegerWrite(struct ZbZclClusterT *cluster, uint16_t attributeId, long long value)
+{
+  (void)cluster;
+  CHECK(attributeId == ZCL_LEVEL_ATTR_CURRLEVEL, "attribute 0x%04X written", attributeId);
+  attr_writes++;
+  attr_value = value;
+  return ZCL_STATUS_SUCCESS;
+}
+
+/* Runs the posted tasks, the Leds update of app_light.c is recorded */
+static void Sim_Run_Tasks(void)
+{
+  while (sim_pending != 0U)
+  {
+    if ((sim_pending & (1U << CFG_TASK_LIGHT_LEVEL_TRANSITION)) != 0U)
+    {
+      sim_pending &= ~(1U << CFG_TASK_LIGHT_LEVEL_TRANSITION);
+      sim_tasks[CFG_TASK_LIGHT_LEVEL_TRANSITION]();
+    }
+    if ((sim_pending & (1U << CFG_TASK_LIGHT_UPDATE)) != 0U)
+    {
+      sim_pending &= ~(1U << CFG_TASK_LIGHT_UPDATE);
+      if (update_nb < UPDATE_MAX)
+      {
+        updates[update_nb].time  = sim_time;
+        updates[update_nb].level = app_Level.level;
+        update_nb++;
+      }
+    }
+  }
+}
+
+/* Advances the time to Time, firing the timer on the way */
+static void Sim_Run_Until(uint64_t Time)
+{
+  while (sim_timer_armed && (sim_timer_expiry <= Time))
+  {
+    sim_time        = sim_timer_expiry;
+    sim_timer_armed = false;
+    sim_timer_cb();
+    Sim_Run_Tasks();
+  }
+  sim_time = Time;
+}
+
+static void Move_To_Level(uint8_t Level, uint16_t TransitionTime)
+{
+  struct ZbZclLevelClientMoveToLevelReqT req =
+  {
+    .level           = Level,
+    .transition_time = TransitionTime,
+  };
+
+  (void)light_level_server_move_to_level_cb(app_Level.level_server, &req, NULL, NULL);
+  Sim_Run_Tasks();
+}
+
+static void Move(uint8_t Mode, uint8_t Rate)
+{
+  struct ZbZclLevelClientMoveReqT req =
+  {
+    .mode = Mode,
+    .rate = Rate,
+  };
+
+  (void)light_level_server_move_cb(app_Level.level_server, &req, NULL, NULL);
+  Sim_Run_Tasks();
+}
+
+static void Stop(void)
+{
+  struct ZbZclLevelClientStopReqT req;
+
+  memset(&req, 0, sizeof(req));
+  (void)light_level_server_stop_cb(app_Level.level_server, &req, NULL, NULL);
+  Sim_Run_Tasks();
+}
+
+/* Checks --------------------------------------------------------------------*/
+/* Updates of one transition from First, started at Start (ps) from From to
+ * Target in Duration (ms), and not interrupted */
+static void Check_Transition(const char * pName, uint32_t First, uint64_t Start, uint8_t From, uint8_t Target, uint32_t Duration)
+{
+  uint32_t i;
+  uint32_t end_ms, late;
+  uint32_t delta = (Target > From) ? (Target - From) : (From - Target);
+  uint32_t max_updates;
+
+  if (update_nb == First)
+  {
+    CHECK(From == Target, "%s: no update of the Leds", pName);
+    return;
+  }
+
+  /* Already on the target, the level reached is applied at once */
+  if (From == Target)
+  {
+    Duration = 0U;
+  }
+
+  for (i = First; i < update_nb; i++)
+  {
+    uint8_t prev = (i == First) ? From : updates[i - 1U].level;
+
+    /* The first update may apply the level reached by the previous transition */
+    CHECK(((i == First) && (updates[i].level == From))
+          || ((Target >= From) && (updates[i].level > prev) && (updates[i].level <= Target))
+          || ((Target < From) && (updates[i].level < prev) && (updates[i].level >= Target)),
+          "%s: update %u to 0x%02X after 0x%02X, target 0x%02X", pName, (unsigned)(i - First), updates[i].level, prev, Target);
+    /* The last update is planned at the end of the transition, whatever the frame period */
+    if ((i > First) && (i < (update_nb - 1U)))
+    {
+      CHECK((updates[i].time - updates[i - 1U].time) >= FRAME_PERIOD_PS, "%s: updates %u us apart", pName,
+            (unsigned)((updates[i].time - updates[i - 1U].time) / 1000000U));
+    }
+  }
+
+  CHECK(updates[update_nb - 1U].level == Target, "%s: ends on 0x%02X, target 0x%02X", pName, updates[update_nb - 1U].level, Target);
+  end_ms = (uint32_t)(updates[update_nb - 1U].time / PS_PER_MS) - (uint32_t)(Start / PS_PER_MS);
+  late   = end_ms - Duration;
+  CHECK((end_ms >= Duration) && (late <= END_MAX_LATE), "%s: ends after %u ms instead of %u ms", pName, (unsigned)end_ms,
+        (unsigned)Duration);
+
+  /* One update per frame period at most plus the end, one per level change at most, and the
+   * level reached by the previous transition */
+  max_updates = (uint32_t)(((uint64_t)Duration * PS_PER_MS) / FRAME_PERIOD_PS) + 1U;
+  max_updates = ((delta < max_updates) ? delta : max_updates) + 1U;
+  CHECK((update_nb - First) <= max_updates, "%s: %u updates, %u at most", pName, (unsigned)(update_nb - First),
+        (unsigned)max_updates);
+}
+
+/* Level reached when the last command came, the transition goes on from it */
+static uint8_t Level_From(void)
+{
+  return App_Light_Level_Transition_Get()->start;
+}
+
+static void Settle(void)
+{
+  Sim_Run_Until(sim_time + (100000U * PS_PER_MS));
+  CHECK(sim_timer_armed == false, "timer still running after the transition");
+}
+
+static void Check_Commands(void)
+{
+  uint32_t first, writes, starts;
+  uint64_t start;
+  uint8_t  from;
+
+  /* Jump to 0x10, then 0x10 -> 0xFF in 1 s */
+  first = update_nb;
+  Move_To_Level(0x10U, 0U);
+  CHECK((update_nb == (first + 1U)) && (updates[first].level == 0x10U), "0 transition time: %u updates",
+        (unsigned)(update_nb - first));
+  Settle();
+  first = update_nb;
+  start = sim_time;
+  writes = attr_writes;
+  starts = sim_timer_starts;
+  Move_To_Level(0xFFU, 10U);
+  Settle();
+  Check_Transition("0x10 -> 0xFF in 1 s", first, start, 0x10U, 0xFFU, 1000U);
+  CHECK(attr_writes == (writes + 1U), "CurrentLevel written %u times", (unsigned)(attr_writes - writes));
+  CHECK(attr_value == 0xFF, "CurrentLevel written to %lld", attr_value);
+  printf("  0x10 -> 0xFF in 1 s: %u updates, %u timer starts, last one after %u ms\n", (unsigned)(update_nb - first),
+         (unsigned)(sim_timer_starts - starts), (unsigned)((updates[update_nb - 1U].time - start) / PS_PER_MS));
+
+  /* Retarget at half time, no jump and a new end time */
+  Move_To_Level(0x10U, 10U);
+  Sim_Run_Until(sim_time + (500U * PS_PER_MS));
+  first = update_nb;
+  start = sim_time;
+  Move_To_Level(0x80U, 10U);
+  from = Level_From();
+  Settle();
+  Check_Transition("retarget at half time", first, start, from, 0x80U, 1000U);
+  printf("  retarget at 500 ms from 0x%02X to 0x80: %u updates, last one after %u ms\n", from,
+         (unsigned)(update_nb - first), (unsigned)((updates[update_nb - 1U].time - start) / PS_PER_MS));
+
+  /* At once */
+  first = update_nb;
+  Move_To_Level(0x40U, 0xFFFFU);
+  CHECK((update_nb == (first + 1U)) && (updates[first].level == 0x40U), "0xFFFF transition time: %u updates",
+        (unsigned)(update_nb - first));
+  CHECK(sim_timer_armed == false, "timer running after a transition at once");
+  first = update_nb;
+  Move_To_Level(0x40U, 10U);
+  Settle();
+  CHECK(update_nb == first, "transition to the same level: %u updates", (unsigned)(update_nb - first));
+
+  /* Consecutive Move commands coalesce in one transition to the last target */
+  Move(LIGHT_LEVEL_MODE_UP, 0U);
+  Sim_Run_Until(sim_time + (20U * PS_PER_MS));
+  Move(LIGHT_LEVEL_MODE_UP, 0U);
+  Sim_Run_Until(sim_time + (20U * PS_PER_MS));
+  start = sim_time;
+  first = update_nb;
+  Move(LIGHT_LEVEL_MODE_UP, 0U);
+  from = Level_From();
+  CHECK(App_Light_Level_Transition_Get()->target == (0x40U + (3U * LIGHT_LEVEL_STEP)), "3 Move Up target 0x%02X",
+        App_Light_Level_Transition_Get()->target);
+  Settle();
+  Check_Transition("3 Move Up", first, start, from, 0x40U + (3U * LIGHT_LEVEL_STEP), LIGHT_LEVEL_STEP_TRANSITION);
+
+  /* Move with a rate of 64 levels per second, a step in 250 ms */
+  first = update_nb;
+  start = sim_time;
+  Move(LIGHT_LEVEL_MODE_DOWN, 64U);
+  Settle();
+  Check_Transition("Move Down at 64/s", first, start, 0x70U, 0x70U - LIGHT_LEVEL_STEP, (LIGHT_LEVEL_STEP * 1000U) / 64U);
+
+  /* Stop at half time: frozen at the level reached, written to CurrentLevel */
+  Move_To_Level(0xF0U, 10U);
+  Sim_Run_Until(sim_time + (500U * PS_PER_MS));
+  writes = attr_writes;
+  Stop();
+  first = update_nb;
+  CHECK(sim_timer_armed == false, "timer running after a Stop");
+  CHECK(app_Level.level == (0x60U + ((0xF0U - 0x60U) / 2U)), "stopped at 0x%02X instead of 0x%02X",
+        app_Level.level, 0x60U + ((0xF0U - 0x60U) / 2U));
+  CHECK((attr_writes == (writes + 1U)) && (attr_value == app_Level.level), "CurrentLevel written to %lld at the Stop",
+        attr_value);
+  from = app_Level.level;
+  Settle();
+  CHECK((update_nb == first) && (app_Level.level == from), "level moved to 0x%02X after the Stop", app_Level.level);
+
+  /* Stop without transition */
+  Stop();
+  Settle();
+  CHECK((update_nb == first) && (attr_value == from), "Stop without transition: %u updates, CurrentLevel %lld",
+        (unsigned)(update_nb - first), attr_value);
+
+  /* A Move after a Stop starts from the level reached */
+  first = update_nb;
+  start = sim_time;
+  Move(LIGHT_LEVEL_MODE_UP, 0U);
+  Settle();
+  Check_Transition("Move Up after a Stop", first, start, from, from + LIGHT_LEVEL_STEP, LIGHT_LEVEL_STEP_TRANSITION);
+}
+
+/* Transitions of all lengths, interrupted or not by a new command */
+static void Check_Random(long NbCommands)
+{
+  long     cmd;
+  uint32_t first, duration, wait;
+  uint64_t start;
+  uint8_t  from, target;
+  uint64_t nb_updates = 0U, nb_transitions = 0U;
+  uint32_t max_late = 0U, late;
+  long     failures_start = failures;
+
+  for (cmd = 0; cmd < NbCommands; cmd++)
+  {
+    target   = (uint8_t)Sim_Random();
+    duration = (Sim_Random() % 100U) * LIGHT_LEVEL_TRANSITION_UNIT;
+    first    = update_nb;
+    start    = sim_time;
+    if (update_nb > (UPDATE_MAX - 512U))
+    {
+      update_nb = 0U;
+      first     = 0U;
+    }
+    Move_To_Level(target, (uint16_t)(duration / LIGHT_LEVEL_TRANSITION_UNIT));
+    from = Level_From();
+
+    /* Half of the transitions are interrupted */
+    wait = ((Sim_Random() & 1U) != 0U) ? (duration + 200U) : (Sim_Random() % (duration + 1U));
+    Sim_Run_Until(sim_time + ((uint64_t)wait * PS_PER_MS));
+    if (wait > duration)
+    {
+      Check_Transition("random", first, start, from, target, duration);
+      if (update_nb != first)
+      {
+        late = (uint32_t)((updates[update_nb - 1U].time - start) / PS_PER_MS) - ((from == target) ? 0U : duration);
+        max_late = (late > max_late) ? late : max_late;
+      }
+      nb_updates += update_nb - first;
+      nb_transitions++;
+    }
+    if (failures != failures_start)
+    {
+      fprintf(stderr, "  command %ld: 0x%02X -> 0x%02X in %u ms\n", cmd, from, target, (unsigned)duration);
+      break;
+    }
+  }
+  printf("  %ld random commands, %llu complete transitions: %.1f updates each, last update at most %u ms late\n",
+         NbCommands, (unsigned long long)nb_transitions, (nb_transitions != 0U) ? ((double)nb_updates / nb_transitions) : 0.0,
+         (unsigned)max_late);
+}
+
+static void Usage(void)
+{
+  fprintf(stderr, "usage: light_level [-n random commands]\n");
+  exit(2);
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char * argv[])
+{
+  long nb_commands = 20000;
+  int  arg;
+
+  for (arg = 1; arg < argc; arg++)
+  {
+    if ((strcmp(argv[arg], "-n") == 0) && ((arg + 1) < argc))
+    {
+      nb_commands = atol(argv[++arg]);
+    }
+    else
+    {
+      Usage();
+    }
+  }
+
+  (void)App_Light_Level_Cfg(NULL);
+  sim_tasks[CFG_TASK_LIGHT_UPDATE] = NULL;
+  CHECK(App_Light_Level_Restore_State() == ZCL_STATUS_FAILURE, "level restored without persistence");
+  Sim_Run_Tasks();
+  Settle();
+
+  Check_Commands();
+  Check_Random(nb_commands);
+
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,604 @@
+/**
+  ******************************************************************************
+  * @file    console_replay.c
+  * @author  Zigbee Application Team
+  * @brief   Check of the console of the trace UART.
+  *          The unmodified app_console.c receives byte streams through a
+  *          simulated 115200 baud UART and circular DMA, with the idle line,
+  *          half and full buffer events, and a sequencer running its task
+  *          after a latency. Recorded streams: typing, a pasted script longer
+  *          than the buffer, several commands on a line, errors, an overrun
+  *          restart, a slow task and help. Random streams are then checked
+  *          against a model of the parameters and of the responses. The
+  *          reception events, task runs and UART writes are printed.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+/* The stub configuration comes first: the include guards it shares with the
+ * application headers keep them out */
+#include "app_conf.h"
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The UART output goes to the capture of the test */
+int Sim_Printf(const char *format, ...);
+#define printf Sim_Printf
+
+/* Code under test, built as is to reach the reception state */
+#include "app_console.c"
+
+#undef printf
+
+/* Private defines -----------------------------------------------------------*/
+#define OUT_SIZE                (1U << 16)
+#define STREAM_SIZE             8192U
+
+/* 10 bits per byte at 115200 baud */
+#define BYTE_US                 87U
+#define IDLE_STEP_US            100U
+#define TASK_LATENCY_US         200U
+/* Longest task latency without overrun: the task is posted every half buffer */
+#define TASK_LATENCY_MAX_US     (((CONSOLE_RX_SIZE / 2U) - 2U) * BYTE_US)
+
+/* Random streams */
+#define RANDOM_LINES            40U
+#define RANDOM_CMDS_MAX         3U
+
+/* Private variables ---------------------------------------------------------*/
+static long                 failures;
+static uint32_t             sim_rng;
+
+/* Simulated UART and DMA */
+static uint8_t *            dma_buf;
+static uint16_t             dma_size;
+static uint16_t             dma_pos;
+static void                 (*dma_event)(uint16_t pos);
+static uint32_t             rx_events;
+static uint32_t             rx_bytes;
+
+/* Simulated sequencer */
+static void                 (*console_task)(void);
+static bool                 task_pending;
+static uint64_t             task_due;
+static uint64_t             task_latency;
+static uint32_t             task_runs;
+
+static uint64_t             sim_time;               /* us */
+
+/* UART output */
+static char                 out[OUT_SIZE];
+static uint32_t             out_len;
+static uint32_t             out_writes;
+
+/* Application of the console */
+static uint16_t             timer_up = 3000U;
+static uint32_t             motor_speed = 100U;
+static uint8_t              level = 7U;
+static uint32_t             applied;
+static uint32_t             next_nb;
+static uint32_t             sw1_nb;
+
+static void App_Apply(void)
+{
+  applied++;
+}
+
+static void App_Next(void)
+{
+  next_nb++;
+}
+
+static void App_Sw1(void)
+{
+  sw1_nb++;
+}
+
+static const Console_Cmd_T  cmd_table[] =
+{
+  CONSOLE_CMD("next"             , &App_Next       ),
+  CONSOLE_CMD("SW1"              , &App_Sw1        ),
+};
+
+static const Console_Param_T param_table[] =
+{
+  CONSOLE_PARAM("timer_up"       , timer_up        , 250U, 60000U, NULL      ),
+  CONSOLE_PARAM("motor_speed"    , motor_speed     , 0U  , 100U  , &App_Apply),
+  CONSOLE_PARAM("level"          , level           , 0U  , 254U  , NULL      ),
+};
+
+/* Private functions ---------------------------------------------------------*/
+#define CHECK(cond, ...) \
+  do \
+  { \
+    if (!(cond)) \
+    { \
+      if (failures < 20) \
+      { \
+        fprintf(stderr, "  "); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+      } \
+      failures++; \
+    } \
+  } while (0)
+
+static uint32_t Sim_Random(void)
+{
+  sim_rng ^= sim_rng << 13;
+  sim_rng ^= sim_rng >> 17;
+  sim_rng ^= sim_rng << 5;
+  return sim_rng;
+}
+
+/* Simulated platform --------------------------------------------------------*/
+int Sim_Printf(const char *format, ...)
+{
+  va_list args;
+  int     length;
+
+  va_start(args, format);
+  length = vsnprintf(&out[out_len], OUT_SIZE - out_len, format, args);
+  va_end(args);
+
+  CHECK((out_len + (uint32_t)length) < OUT_SIZE, "output capture full");
+  if ((out_len + (uint32_t)length) < OUT_SIZE)
+  {
+    out_len += (uint32_t)length;
+  }
+  out_writes++;
+  return length;
+}
+
+hw_status_t HW_UART_Receive_ToIdle_DMA(hw_uart_id_t hw_uart_id, uint8_t *p_data, uint16_t size,
+                                       void (*Callback)(uint16_t pos))
+{
+  CHECK(hw_uart_id == CFG_DEBUG_TRACE_UART, "console started on UART %d", (int)hw_uart_id);
+  dma_buf = p_data;
+  dma_size = size;
+  dma_pos = 0U;
+  dma_event = Callback;
+  return hw_uart_ok;
+}
+
+void UTIL_SEQ_RegTask(UTIL_SEQ_bm_t TaskId_bm, uint32_t Flags, void (*Task)(void))
+{
+  (void)Flags;
+  CHECK(TaskId_bm == (1U << CFG_TASK_CONSOLE), "task 0x%08X registered", (unsigned)TaskId_bm);
+  console_task = Task;
+}
+
+void UTIL_SEQ_SetTask(UTIL_SEQ_bm_t TaskId_bm, uint32_t Task_Prio)
+{
+  (void)Task_Prio;
+  CHECK(TaskId_bm == (1U << CFG_TASK_CONSOLE), "task 0x%08X set", (unsigned)TaskId_bm);
+  if (task_pending == false)
+  {
+    task_pending = true;
+    task_due = sim_time + task_latency;
+  }
+}
+
+static void Sim_Advance(uint64_t Us)
+{
+  sim_time += Us;
+  if (task_pending && (sim_time >= task_due))
+  {
+    task_pending = false;
+    task_runs++;
+    console_task();
+  }
+}
+
+static void Sim_Event(uint16_t Pos)
+{
+  rx_events++;
+  dma_event(Pos);
+}
+
+/* Bytes sent back to back, then the line stays idle for IdleUs */
+static void Sim_Uart_Rx(const char * pData, uint32_t Size, uint32_t IdleUs)
+{
+  uint32_t i;
+  uint64_t end;
+
+  rx_bytes += Size;
+  for (i = 0U; i < Size; i++)
+  {
+    Sim_Advance(BYTE_US);
+    dma_buf[dma_pos++] = (uint8_t)pData[i];
+    if (dma_pos == (dma_size / 2U))
+    {
+      Sim_Event(dma_pos);
+    }
+    if (dma_pos == dma_size)
+    {
+      Sim_Event(dma_size);
+      dma_pos = 0U;
+    }
+  }
+
+  /* Idle line detected after one byte time, the HAL reports it only when the
+   * DMA is not at the buffer start */
+  Sim_Advance(BYTE_US);
+  if (dma_pos != 0U)
+  {
+    Sim_Event(dma_pos);
+  }
+
+  end = sim_time + IdleUs;
+  while (sim_time < end)
+  {
+    Sim_Advance(IDLE_STEP_US);
+  }
+}
+
+static void Sim_Uart_Rx_Str(const char * pData, uint32_t IdleUs)
+{
+  Sim_Uart_Rx(pData, (uint32_t)strlen(pData), IdleUs);
+}
+
+/* Error of the UART, the DMA is restarted from the buffer start */
+static void Sim_Uart_Overrun(void)
+{
+  dma_pos = 0U;
+  Sim_Event(HW_UART_RX_RESTART);
+}
+
+/* Checks --------------------------------------------------------------------*/
+static void Stats_Reset(void)
+{
+  rx_events = 0U;
+  rx_bytes = 0U;
+  task_runs = 0U;
+  out_writes = 0U;
+  out_len = 0U;
+  out[0] = '\0';
+}
+
+static void Stats_Print(const char * pName, uint32_t Lines)
+{
+  printf("  %-28s: %4u bytes in %2u lines, %3u reception events, %3u task runs, %3u UART writes of %5u bytes\n",
+         pName, (unsigned)rx_bytes, (unsigned)Lines, (unsigned)rx_events, (unsigned)task_runs, (unsigned)out_writes,
+         (unsigned)out_len);
+}
+
+#define CHECK_OUT(text) \
+  CHECK(strstr(out, (text)) != NULL, "%s:%d: \"%s\" not in the output \"%s\"", __func__, __LINE__, (text), out)
+
+/* One key every 150 ms, then Enter */
+static void Replay_Typing(void)
+{
+  const char * typed = "get motor_speed\r";
+  const char * key;
+
+  Stats_Reset();
+  for (key = typed; *key != '\0'; key++)
+  {
+    Sim_Uart_Rx(key, 1U, 150000U);
+  }
+  CHECK(strcmp(out, "motor_speed = 100\r\n") == 0, "typing: \"%s\"", out);
+  CHECK(out_writes == 1U, "typing: %u UART writes", (unsigned)out_writes);
+  Stats_Print("typing, 150 ms per key", 1U);
+}
+
+/* Configuration script pasted at once, 3 times longer than the DMA buffer */
+static uint32_t Script(char * pScript, uint32_t Size)
+{
+  uint32_t length = 0U;
+  uint32_t i;
+
+  for (i = 0U; i < 40U; i++)
+  {
+    if ((i % 2U) != 0U)
+    {
+      length += (uint32_t)snprintf(&pScript[length], Size - length, "set motor_speed %u\r\n", (unsigned)(40U + i));
+    }
+    else
+    {
+      length += (uint32_t)snprintf(&pScript[length], Size - length, "set timer_up %u\r\n", (unsigned)(1000U + (10U * i)));
+    }
+  }
+  length += (uint32_t)snprintf(&pScript[length], Size - length, "get\r\n");
+  return length;
+}
+
+static void Replay_Script(const char * pName, uint64_t Latency)
+{
+  char     script[STREAM_SIZE];
+  uint32_t length = Script(script, sizeof(script));
+  uint32_t applied_start = applied;
+
+  Stats_Reset();
+  task_latency = Latency;
+  Sim_Uart_Rx(script, length, 50000U);
+  task_latency = TASK_LATENCY_US;
+
+  CHECK((motor_speed == 79U) && (timer_up == 1380U), "%s: motor_speed %u, timer_up %u", pName, (unsigned)motor_speed,
+        (unsigned)timer_up);
+  CHECK((applied - applied_start) == 20U, "%s: %u applied", pName, (unsigned)(applied - applied_start));
+  CHECK_OUT("timer_up = 1000\r\nmotor_speed = 41\r\ntimer_up = 1020\r\n");
+  CHECK_OUT("timer_up = 1380\r\nmotor_speed = 79\r\nlevel = ");
+  CHECK(strstr(out, "ERR") == NULL, "%s: error in \"%s\"", pName, out);
+  CHECK(rx_events <= ((length / (CONSOLE_RX_SIZE / 2U)) + 1U), "%s: %u reception events", pName, (unsigned)rx_events);
+  CHECK(out_writes <= task_runs, "%s: %u UART writes for %u task runs", pName, (unsigned)out_writes, (unsigned)task_runs);
+  Stats_Print(pName, 41U);
+}
+
+/* Several commands on one line */
+static void Replay_Batch(void)
+{
+  const char * line = "next;next; SW1 ;set level 200;get level\r";
+
+  Stats_Reset();
+  Sim_Uart_Rx_Str(line, 50000U);
+  CHECK((next_nb == 2U) && (sw1_nb == 1U) && (level == 200U), "batch: next %u, SW1 %u, level %u", (unsigned)next_nb,
+        (unsigned)sw1_nb, (unsigned)level);
+  CHECK(strcmp(out, "next OK\r\nnext OK\r\nSW1 OK\r\nlevel = 200\r\nlevel = 200\r\n") == 0, "batch: \"%s\"", out);
+  CHECK(out_writes == 1U, "batch: %u UART writes", (unsigned)out_writes);
+  Stats_Print("commands on one line", 1U);
+}
+
+/* Errors, backspace and a too long line */
+static void Replay_Errors(void)
+{
+  char long_line[200];
+
+  Stats_Reset();
+  Sim_Uart_Rx_Str("set motor_speed 101\r", 1000U);
+  Sim_Uart_Rx_Str("set motor_speed -1\r", 1000U);
+  Sim_Uart_Rx_Str("set motor_speed 5x\r", 1000U);
+  Sim_Uart_Rx_Str("set nothing 1\rfoo\rset level\r", 1000U);
+  Sim_Uart_Rx_Str("set level 12\b3\r", 1000U);
+  Sim_Uart_Rx_Str("set timer_up 0x400\r", 1000U);
+  memset(long_line, 'a', 150U);
+  strcpy(&long_line[150], "\rget level\r");
+  Sim_Uart_Rx_Str(long_line, 50000U);
+
+  CHECK((motor_speed == 79U) && (level == 13U) && (timer_up == 1024U), "errors: motor_speed %u, level %u, timer_up %u",
+        (unsigned)motor_speed, (unsigned)level, (unsigned)timer_up);
+  CHECK_OUT("ERR motor_speed: 101 not in [0..100]\r\n");
+  CHECK_OUT("ERR motor_speed: -1 not in [0..100]\r\n");
+  CHECK_OUT("ERR motor_speed: 5x not in [0..100]\r\n");
+  CHECK_OUT("ERR unknown param: nothing\r\nERR unknown command: foo\r\nERR usage: set <param> <value>\r\n");
+  CHECK_OUT("level = 13\r\ntimer_up = 1024\r\n");
+  CHECK_OUT("ERR line longer than 79 characters\r\nlevel = 13\r\n");
+  Stats_Print("errors", 10U);
+}
+
+/* Overrun in the middle of a line: the reception restarts at the buffer start
+ * and the partial line is dropped */
+static void Replay_Overrun(void)
+{
+  Stats_Reset();
+  Sim_Uart_Rx_Str("set lev", 1000U);
+  Sim_Uart_Overrun();
+  Sim_Uart_Rx_Str("el 99\rset level 42\r", 50000U);
+  CHECK(level == 42U, "overrun: level %u", (unsigned)level);
+  CHECK(strcmp(out, "ERR unknown command: el\r\nlevel = 42\r\n") == 0, "overrun: \"%s\"", out);
+  Stats_Print("overrun restart", 2U);
+}
+
+/* A task later than half of the buffer loses bytes, reported once */
+static void Replay_Late_Task(void)
+{
+  char     script[STREAM_SIZE];
+  uint32_t length = Script(script, sizeof(script));
+
+  Stats_Reset();
+  task_latency = CONSOLE_RX_SIZE * BYTE_US;
+  Sim_Uart_Rx(script, length, 50000U);
+  task_latency = TASK_LATENCY_US;
+  CHECK_OUT("ERR console overrun, ");
+
+  /* Back to normal on the next line */
+  Stats_Reset();
+  Sim_Uart_Rx_Str("\rget level\r", 50000U);
+  CHECK(strcmp(out, "level = 42\r\n") == 0, "after an overrun: \"%s\"", out);
+}
+
+/* help answered in one write */
+static void Replay_Help(void)
+{
+  Stats_Reset();
+  Sim_Uart_Rx_Str("help\r", 50000U);
+  CHECK(strcmp(out, "set <param> <value>, get [param], help\r\n  next\r\n  SW1\r\n  timer_up [250..60000]\r\n"
+               "  motor_speed [0..100]\r\n  level [0..254]\r\n") == 0, "help: \"%s\"", out);
+  CHECK(out_writes == 1U, "help: %u UART writes", (unsigned)out_writes);
+  Stats_Print("help", 1U);
+}
+
+/* Random streams --------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t timer_up;
+  uint32_t motor_speed;
+  uint32_t level;
+  uint32_t applied;
+  uint32_t next_nb;
+} Model_T;
+
+static uint32_t * Model_Param(Model_T * pModel, uint32_t Index)
+{
+  return (Index == 0U) ? &pModel->timer_up : ((Index == 1U) ? &pModel->motor_speed : &pModel->level);
+}
+
+/* One random command, its expected responses appended to pExpected */
+static uint32_t Random_Cmd(char * pCmd, uint32_t Size, Model_T * pModel, char * pExpected, uint32_t * pExpectedLen)
+{
+  uint32_t                p = Sim_Random() % CONSOLE_NB(param_table);
+  const Console_Param_T * param = &param_table[p];
+  uint32_t *              value = Model_Param(pModel, p);
+  uint32_t                length = 0U;
+  uint32_t                v;
+  uint32_t                i;
+
+  switch (Sim_Random() % 6U)
+  {
+    case 0U:
+    case 1U:
+      v = param->min + (Sim_Random() % (param->max - param->min + 1U));
+      length = (uint32_t)snprintf(pCmd, Size, ((Sim_Random() % 4U) == 0U) ? "set %s 0x%X" : "set %s %u", param->name,
+                                  (unsigned)v);
+      *value = v;
+      pModel->applied += (param->apply != NULL) ? 1U : 0U;
+      *pExpectedLen += (uint32_t)sprintf(&pExpected[*pExpectedLen], "%s = %u\r\n", param->name, (unsigned)v);
+      break;
+
+    case 2U:
+      length = (uint32_t)snprintf(pCmd, Size, "set %s %u", param->name, (unsigned)(param->max + 1U));
+      *pExpectedLen += (uint32_t)sprintf(&pExpected[*pExpectedLen], "ERR %s: %u not in [%u..%u]\r\n", param->name,
+                                         (unsigned)(param->max + 1U), (unsigned)param->min, (unsigned)param->max);
+      break;
+
+    case 3U:
+      length = (uint32_t)snprintf(pCmd, Size, "get %s", param->name);
+      *pExpectedLen += (uint32_t)sprintf(&pExpected[*pExpectedLen], "%s = %u\r\n", param->name, (unsigned)*value);
+      break;
+
+    case 4U:
+      length = (uint32_t)snprintf(pCmd, Size, "get");
+      for (i = 0U; i < CONSOLE_NB(param_table); i++)
+      {
+        *pExpectedLen += (uint32_t)sprintf(&pExpected[*pExpectedLen], "%s = %u\r\n", param_table[i].name,
+                                           (unsigned)*Model_Param(pModel, i));
+      }
+      break;
+
+    default:
+      length = (uint32_t)snprintf(pCmd, Size, "next");
+      pModel->next_nb++;
+      *pExpectedLen += (uint32_t)sprintf(&pExpected[*pExpectedLen], "next OK\r\n");
+      break;
+  }
+  return length;
+}
+
+static void Replay_Random(long NbStreams)
+{
+  static char stream[STREAM_SIZE];
+  static char expected[OUT_SIZE];
+  long        round;
+  uint32_t    events = 0U;
+  uint32_t    writes = 0U;
+  uint32_t    bytes = 0U;
+  long        failures_start = failures;
+
+  sim_rng = 0x2545F491U;
+  for (round = 0; round < NbStreams; round++)
+  {
+    Model_T  model = { timer_up, motor_speed, level, applied, next_nb };
+    uint32_t length = 0U;
+    uint32_t expected_len = 0U;
+    uint32_t line, cmd, nb, sent;
+
+    for (line = 0U; line < RANDOM_LINES; line++)
+    {
+      nb = 1U + (Sim_Random() % RANDOM_CMDS_MAX);
+      for (cmd = 0U; cmd < nb; cmd++)
+      {
+        if (cmd != 0U)
+        {
+          stream[length++] = CONSOLE_CMD_SEPARATOR;
+        }
+        length += Random_Cmd(&stream[length], sizeof(stream) - length, &model, expected, &expected_len);
+      }
+      length += (uint32_t)snprintf(&stream[length], sizeof(stream) - length, ((Sim_Random() % 2U) == 0U) ? "\r" : "\r\n");
+    }
+
+    /* Random bursts and task latency, the task still runs within half a buffer */
+    Stats_Reset();
+    task_latency = Sim_Random() % TASK_LATENCY_MAX_US;
+    for (sent = 0U; sent < length; sent += nb)
+    {
+      nb = 1U + (Sim_Random() % 300U);
+      nb = ((sent + nb) > length) ? (length - sent) : nb;
+      Sim_Uart_Rx(&stream[sent], nb, Sim_Random() % 20000U);
+    }
+    Sim_Uart_Rx(stream, 0U, 50000U);
+    task_latency = TASK_LATENCY_US;
+    events += rx_events;
+    writes += out_writes;
+    bytes += length;
+
+    CHECK((out_len == expected_len) && (memcmp(out, expected, expected_len) == 0),
+          "stream %ld: output of %u bytes instead of %u", round, (unsigned)out_len, (unsigned)expected_len);
+    CHECK((timer_up == model.timer_up) && (motor_speed == model.motor_speed) && (level == model.level),
+          "stream %ld: timer_up %u, motor_speed %u, level %u instead of %u, %u, %u", round, (unsigned)timer_up,
+          (unsigned)motor_speed, (unsigned)level, (unsigned)model.timer_up, (unsigned)model.motor_speed,
+          (unsigned)model.level);
+    CHECK((applied == model.applied) && (next_nb == model.next_nb), "stream %ld: %u applied, %u next instead of %u, %u",
+          round, (unsigned)applied, (unsigned)next_nb, (unsigned)model.applied, (unsigned)model.next_nb);
+
+    if (failures != failures_start)
+    {
+      fprintf(stderr, "  stream %ld, task latency %u us\n", round, (unsigned)task_latency);
+      break;
+    }
+  }
+
+  printf("  %ld random streams: %u bytes, %u reception events, %u UART writes\n", NbStreams, (unsigned)bytes,
+         (unsigned)events, (unsigned)writes);
+}
+
+static void Usage(void)
+{
+  fprintf(stderr, "usage: console_replay [-n random streams]\n");
+  exit(2);
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char * argv[])
+{
+  long nb_streams = 200;
+  int  arg;
+
+  for (arg = 1; arg < argc; arg++)
+  {
+    if ((strcmp(argv[arg], "-n") == 0) && ((arg + 1) < argc))
+    {
+      nb_streams = atol(argv[++arg]);
+    }
+    else
+    {
+      Usage();
+    }
+  }
+
+  task_latency = TASK_LATENCY_US;
+  CHECK(Console_Init(cmd_table, CONSOLE_NB(cmd_table), param_table, CONSOLE_NB(param_table)) == true,
+        "console init failed");
+  CHECK((dma_buf != NULL) && (dma_size == CONSOLE_RX_SIZE), "reception not started");
+  if (failures != 0)
+  {
+    printf("FAIL: %ld failures\n", failures);
+    return 1;
+  }
+
+  Replay_Typing();
+  Replay_Script("pasted script", TASK_LATENCY_US);
+  Replay_Batch();
+  Replay_Errors();
+  Replay_Overrun();
+  Replay_Script("pasted script, slow task", TASK_LATENCY_MAX_US);
+  Replay_Late_Task();
+  Replay_Help();
+  Replay_Random(nb_streams);
+
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,41 @@
+/**
+  ******************************************************************************
+  * @file    cmsis_compiler.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the CMSIS compiler header, the menu and
+  *          console tests have a single context
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef CMSIS_COMPILER_H
+#define CMSIS_COMPILER_H
+
+#include <stdint.h>
+
+#define __COMPILER_BARRIER()    __asm volatile("" ::: "memory")
+
+static inline uint32_t __get_PRIMASK(void)
+{
+  return 0U;
+}
+
+static inline void __set_PRIMASK(uint32_t priMask)
+{
+  (void)priMask;
+}
+
+static inline void __disable_irq(void)
+{
+}
+
+#endif /* CMSIS_COMPILER_H */
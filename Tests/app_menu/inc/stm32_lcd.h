@@ -0,0 +1,35 @@
+/**
+  ******************************************************************************
+  * @file    stm32_lcd.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the LCD utility, the menu line is recorded
+  *          by the menu test
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef STM32_LCD_H
+#define STM32_LCD_H
+
+/* Tested by app_menu.c to draw the menu on the LCD */
+#define LCD_H
+
+#include <stdint.h>
+
+#define CENTER_MODE                             1U
+#define LEFT_MODE                               3U
+#define LINE(x)                                 ((x) * 8U)
+
+void UTIL_LCD_ClearStringLine(uint32_t Line);
+void UTIL_LCD_DisplayStringAt(uint32_t Xpos, uint32_t Ypos, uint8_t *Text, uint32_t Mode);
+
+#endif /* STM32_LCD_H */
@@ -0,0 +1,35 @@
+/**
+  ******************************************************************************
+  * @file    stm32wbxx_hal.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the HAL used by the menu and console tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef STM32WBXX_HAL_H
+#define STM32WBXX_HAL_H
+
+#include <stdint.h>
+
+typedef enum
+{
+  HAL_OK       = 0x00U,
+  HAL_ERROR    = 0x01U,
+  HAL_BUSY     = 0x02U,
+  HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+uint32_t HAL_GetTick(void);
+void     HAL_Delay(uint32_t Delay);
+
+#endif /* STM32WBXX_HAL_H */
@@ -0,0 +1,582 @@
+/**
+  ******************************************************************************
+  * @file    menu_walk.c
+  * @author  Zigbee Application Team
+  * @brief   Check of the menu of the roller shutter.
+  *          The unmodified app_menu.c and app_menu_cfg.c are driven by a walk
+  *          of keys through all the menus. The visible text of the UART line
+  *          and the LCD menu line shall be the ones recorded from the linked
+  *          list menu they replace. The UART writes, bytes and LCD draws per
+  *          keypress and per refresh are printed and bounded, along with the
+  *          heap use, the restart, the refresh under interrupt, the checks of
+  *          the tables and the truncation of a long line.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+/* The stub configuration comes first: the include guards it shares with the
+ * application headers keep them out */
+#include "app_conf.h"
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The UART output and the heap go to the capture of the test */
+int   Sim_Printf(const char *format, ...);
+void *Sim_Malloc(size_t size);
+#define printf Sim_Printf
+#define malloc Sim_Malloc
+
+/* Code under test, built as is to reach the tables and the menu line */
+#include "app_menu.c"
+#include "app_menu_cfg.c"
+
+#undef printf
+#undef malloc
+
+/* Private defines -----------------------------------------------------------*/
+#define OUT_SIZE                4096U
+#define LCD_SIZE                64U
+
+/* Bounds of the single write menu */
+#define KEY_WRITES_MAX          2U        /* Line cleared, then the menu */
+#define REFRESH_WRITES          1U
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  char         key;     /* n: next, p: previous, s: select, e: exit */
+  const char * uart;    /* Visible text of the UART line, escape sequences removed */
+  const char * lcd;     /* LCD menu line */
+} Walk_Step_T;
+
+/* Private variables ---------------------------------------------------------*/
+static long                 failures;
+
+/* Simulated platform */
+static char                 out[OUT_SIZE];
+static uint32_t             out_len;
+static uint32_t             out_writes;
+static uint32_t             heap_nb;
+static char                 lcd_text[LCD_SIZE];
+static uint32_t             lcd_draws;
+static uint32_t             lcd_updates;
+static uint32_t             timer_nb;
+static HW_TS_pTimerCb_t     timer_cb;
+static uint32_t             timer_ticks;
+static uint32_t             actions;
+static void                 (*sim_printf_irq)(void);
+
+/* Walk through all the menus, recorded from the linked list menu before the
+ * const tables: same keys, same visible text, same LCD line */
+static const Walk_Step_T    walk[] =
+{
+  { 'n', " MENU :   Network   [Window Cfg]   Window Cmd    Light    Factory Reset    Global Infos    Logs  ", "[Window Cfg]" },
+  { 'n', " MENU :   Network    Window Cfg   [Window Cmd]   Light    Factory Reset    Global Infos    Logs  ", "[Window Cmd]" },
+  { 'n', " MENU :   Network    Window Cfg    Window Cmd   [Light]   Factory Reset    Global Infos    Logs  ", "[Light]" },
+  { 'n', " MENU :   Network    Window Cfg    Window Cmd    Light    Factory Reset    Global Infos    Logs  ", "{Factory Reset}" },
+  { 'n', " MENU :   Network    Window Cfg    Window Cmd    Light    Factory Reset    Global Infos    Logs  ", "{Global Infos}" },
+  { 'n', " MENU :   Network    Window Cfg    Window Cmd    Light    Factory Reset    Global Infos   [Logs] ", "[Logs]" },
+  { 'p', " MENU :   Network    Window Cfg    Window Cmd    Light    Factory Reset    Global Infos    Logs  ", "{Global Infos}" },
+  { 'p', " MENU :   Network    Window Cfg    Window Cmd    Light    Factory Reset    Global Infos    Logs  ", "{Factory Reset}" },
+  { 'p', " MENU :   Network    Window Cfg    Window Cmd   [Light]   Factory Reset    Global Infos    Logs  ", "[Light]" },
+  { 's', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{ID Mode}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{Led Toggle}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{Led lvl +}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{Led lvl -}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{ID Mode}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{Led Toggle}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{Led lvl +}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{Led lvl -}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{ID Mode}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{Led Toggle}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{Led lvl +}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{Led lvl -}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{ID Mode}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{Led Toggle}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{Led lvl +}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{Led lvl -}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{ID Mode}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{Led Toggle}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{Led lvl +}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{Led lvl -}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{ID Mode}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{Led Toggle}" },
+  { 'n', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{Led lvl +}" },
+  { 'p', " MENU :   ID Mode    Led Toggle    Led lvl +    Led lvl -  ", "{Led Toggle}" },
+  { 'e', " MENU :   Network    Window Cfg    Window Cmd   [Light]   Factory Reset    Global Infos    Logs  ", "[Light]" },
+  { 'e', "", "[Light]" },
+  { 'n', " MENU :   Network    Window Cfg    Window Cmd    Light    Factory Reset    Global Infos    Logs  ", "{Factory Reset}" },
+  { 'n', " MENU :   Network    Window Cfg    Window Cmd    Light    Factory Reset    Global Infos    Logs  ", "{Global Infos}" },
+  { 's', "", "{Global Infos}" },
+  { 'n', " MENU :   Network    Window Cfg    Window Cmd    Light    Factory Reset    Global Infos   [Logs] ", "[Logs]" },
+  { 'n', " MENU :  [Network]   Window Cfg    Window Cmd    Light    Factory Reset    Global Infos    Logs  ", "[Network]" },
+  { 'p', " MENU :   Network    Window Cfg    Window Cmd    Light    Factory Reset    Global Infos   [Logs] ", "[Logs]" },
+  { 'e', "", "[Logs]" },
+  { 's', " MENU :   Log Levels    App Log Level    ZB Log Level  ", "{Log Levels}" },
+  { 's', "", "{Log Levels}" },
+  { 's', "", "{Log Levels}" },
+  { 'e', " MENU :   Network    Window Cfg    Window Cmd    Light    Factory Reset    Global Infos   [Logs] ", "[Logs]" },
+  { 'n', " MENU :  [Network]   Window Cfg    Window Cmd    Light    Factory Reset    Global Infos    Logs  ", "[Network]" },
+  { 's', " MENU :   Join Network    Permit_Join    Bind Table    Tx Power Disp    Tx Power +    Tx Power -    Launch NVM  ", "{Join Network}" },
+  { 'p', " MENU :   Join Network    Permit_Join    Bind Table    Tx Power Disp    Tx Power +    Tx Power -    Launch NVM  ", "{Launch NVM}" },
+  { 'p', " MENU :   Join Network    Permit_Join    Bind Table    Tx Power Disp    Tx Power +    Tx Power -    Launch NVM  ", "{Tx Power -}" },
+  { 'p', " MENU :   Join Network    Permit_Join    Bind Table    Tx Power Disp    Tx Power +    Tx Power -    Launch NVM  ", "{Tx Power +}" },
+  { 's', "", "{Tx Power +}" },
+  { 'e', " MENU :  [Network]   Window Cfg    Window Cmd    Light    Factory Reset    Global Infos    Logs  ", "[Network]" },
+  { 'e', "", "[Network]" },
+  { 'n', " MENU :   Network   [Window Cfg]   Window Cmd    Light    Factory Reset    Global Infos    Logs  ", "[Window Cfg]" },
+  { 'n', " MENU :   Network    Window Cfg   [Window Cmd]   Light    Factory Reset    Global Infos    Logs  ", "[Window Cmd]" },
+  { 'n', " MENU :   Network    Window Cfg    Window Cmd   [Light]   Factory Reset    Global Infos    Logs  ", "[Light]" },
+  { 'n', " MENU :   Network    Window Cfg    Window Cmd    Light    Factory Reset    Global Infos    Logs  ", "{Factory Reset}" },
+  { 'n', " MENU :   Network    Window Cfg    Window Cmd    Light    Factory Reset    Global Infos    Logs  ", "{Global Infos}" },
+  { 'n', " MENU :   Network    Window Cfg    Window Cmd    Light    Factory Reset    Global Infos   [Logs] ", "[Logs]" },
+  { 's', " MENU :   Log Levels    App Log Level    ZB Log Level  ", "{Log Levels}" },
+  { 'e', " MENU :   Network    Window Cfg    Window Cmd    Light    Factory Reset    Global Infos   [Logs] ", "[Logs]" }
+};
+
+/* Private functions ---------------------------------------------------------*/
+#define CHECK(cond, ...) \
+  do \
+  { \
+    if (!(cond)) \
+    { \
+      if (failures < 20) \
+      { \
+        fprintf(stderr, "  "); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+      } \
+      failures++; \
+    } \
+  } while (0)
+
+/* Simulated platform --------------------------------------------------------*/
+int Sim_Printf(const char *format, ...)
+{
+  char    line[MENU_LINE_SIZE + 64U];
+  va_list args;
+  int     length;
+  void    (*irq)(void) = sim_printf_irq;
+
+  va_start(args, format);
+  length = vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+
+  out_writes++;
+  CHECK((out_len + (uint32_t)length) < OUT_SIZE, "output capture full");
+  if ((out_len + (uint32_t)length) < OUT_SIZE)
+  {
+    memcpy(&out[out_len], line, (size_t)length);
+    out_len += (uint32_t)length;
+    out[out_len] = '\0';
+  }
+
+  /* Interrupt taken during the UART write */
+  if (irq != NULL)
+  {
+    sim_printf_irq = NULL;
+    irq();
+  }
+  return length;
+}
+
+void *Sim_Malloc(size_t size)
+{
+  heap_nb++;
+  return malloc(size);
+}
+
+HW_TS_ReturnStatus_t HW_TS_Create(uint32_t TimerProcessID, uint8_t *pTimerId, HW_TS_Mode_t TimerMode,
+                                  HW_TS_pTimerCb_t pTimerCallBack)
+{
+  CHECK(TimerProcessID == CFG_TIM_MENU_REFRESH, "refresh timer created for process %u", (unsigned)TimerProcessID);
+  CHECK(TimerMode == hw_ts_Repeated, "refresh timer not repeated");
+  *pTimerId = (uint8_t)timer_nb;
+  timer_nb++;
+  timer_cb = pTimerCallBack;
+  return hw_ts_Successful;
+}
+
+void HW_TS_Start(uint8_t TimerID, uint32_t timeout_ticks)
+{
+  (void)TimerID;
+  timer_ticks = timeout_ticks;
+}
+
+void HW_TS_Stop(uint8_t TimerID)
+{
+  (void)TimerID;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+  (void)Delay;
+}
+
+void UTIL_LCD_ClearStringLine(uint32_t Line)
+{
+  CHECK(Line == DK_LCD_MENU_LINE, "LCD line %u cleared", (unsigned)Line);
+  lcd_text[0] = '\0';
+}
+
+void UTIL_LCD_DisplayStringAt(uint32_t Xpos, uint32_t Ypos, uint8_t *Text, uint32_t Mode)
+{
+  (void)Xpos;
+  (void)Mode;
+  CHECK(Ypos == LINE(DK_LCD_MENU_LINE), "LCD drawn at %u", (unsigned)Ypos);
+  snprintf(lcd_text, sizeof(lcd_text), "%s", (const char *)Text);
+  lcd_draws++;
+}
+
+void App_Core_Display_Update(void)
+{
+  lcd_updates++;
+}
+
+/* Logs of the menu, disabled by the log levels */
+appliLogLevel_t             logRegionLevel[APPLI_LOG_REGION_NB];
+
+void logDeferred(appliLogLevel_t aLogLevel, appliLogRegion_t aLogRegion, const char *aFile, const char *aFormat, ...)
+{
+  (void)aLogLevel;
+  (void)aLogRegion;
+  (void)aFile;
+  (void)aFormat;
+}
+
+/* Application of the menus and of the console tables */
+App_Zb_Info_T               app_zb_info;
+Roller_Shutter_Control_T    app_Roller_Shutter_Control;
+
+bool Console_Init(const Console_Cmd_T * cmd, uint8_t cmd_nb, const Console_Param_T * param, uint8_t param_nb)
+{
+  (void)cmd;
+  (void)cmd_nb;
+  (void)param;
+  (void)param_nb;
+  return true;
+}
+
+void App_Persist_Notify_cb(struct ZigBeeT *zb, void *cbarg)
+{
+  (void)zb;
+  (void)cbarg;
+  actions++;
+}
+
+#define SIM_ACTION(fct)   void fct(void) { actions++; }
+SIM_ACTION(App_Core_Ntw_Join)
+SIM_ACTION(App_Core_Factory_Reset)
+SIM_ACTION(App_Core_Infos_Disp)
+SIM_ACTION(App_Core_Log_Disp)
+SIM_ACTION(App_Core_Log_App_Level)
+SIM_ACTION(App_Core_Log_Zb_Level)
+SIM_ACTION(App_Zigbee_Permit_Join)
+SIM_ACTION(App_Zigbee_Bind_Disp)
+SIM_ACTION(App_Zigbee_TxPwr_Disp)
+SIM_ACTION(App_Zigbee_TxPwr_Up)
+SIM_ACTION(App_Zigbee_TxPwr_Down)
+SIM_ACTION(App_Roller_Shutter_IdentifyMode)
+SIM_ACTION(App_Roller_Shutter_FindBind)
+SIM_ACTION(App_Roller_Shutter_timer_motorup_up)
+SIM_ACTION(App_Roller_Shutter_timer_motorup_down)
+SIM_ACTION(App_Roller_Shutter_timer_motordown_up)
+SIM_ACTION(App_Roller_Shutter_timer_motordown_down)
+SIM_ACTION(App_Roller_Shutter_motor_speed_up)
+SIM_ACTION(App_Roller_Shutter_motor_speed_down)
+SIM_ACTION(App_Roller_Shutter_adc_treshold_up)
+SIM_ACTION(App_Roller_Shutter_adc_treshold_down)
+SIM_ACTION(App_Roller_Shutter_Motor_Cfg_Apply)
+SIM_ACTION(App_Roller_Shutter_Report_Disp)
+SIM_ACTION(App_Roller_Shutter_Report_Min_Up)
+SIM_ACTION(App_Roller_Shutter_Report_Min_Down)
+SIM_ACTION(App_Roller_Shutter_Report_Max_Up)
+SIM_ACTION(App_Roller_Shutter_Report_Max_Down)
+SIM_ACTION(App_Roller_Shutter_Report_Change_Up)
+SIM_ACTION(App_Roller_Shutter_Report_Change_Down)
+SIM_ACTION(App_Roller_Shutter_Occupancy_Filter_Disp)
+SIM_ACTION(App_Roller_Shutter_Occupancy_Filter_Holdoff_Up)
+SIM_ACTION(App_Roller_Shutter_Occupancy_Filter_Holdoff_Down)
+SIM_ACTION(App_Roller_Shutter_Up)
+SIM_ACTION(App_Roller_Shutter_Stop)
+SIM_ACTION(App_Roller_Shutter_Down)
+SIM_ACTION(App_Light_IdentifyMode)
+SIM_ACTION(App_Light_Toggle)
+SIM_ACTION(App_Light_Level_Up)
+SIM_ACTION(App_Light_Level_Down)
+
+/* Checks --------------------------------------------------------------------*/
+static void Out_Reset(void)
+{
+  out_len = 0U;
+  out[0] = '\0';
+  out_writes = 0U;
+  lcd_draws = 0U;
+  lcd_updates = 0U;
+}
+
+/* Text of the UART output as seen on the terminal line, without the escape
+ * sequences and the line feed of the end of line */
+static void Out_Visible(char * pText, uint32_t Size)
+{
+  uint32_t i;
+  uint32_t length = 0U;
+
+  for (i = 0U; (i < out_len) && ((length + 1U) < Size); i++)
+  {
+    if (out[i] == '\x1b')
+    {
+      i++;
+      if ((i < out_len) && (out[i] == '['))
+      {
+        while ((i < out_len) && !(((out[i] >= 'A') && (out[i] <= 'Z')) || ((out[i] >= 'a') && (out[i] <= 'z'))))
+        {
+          i++;
+        }
+      }
+    }
+    else if (out[i] != '\n')
+    {
+      pText[length++] = out[i];
+    }
+  }
+  pText[length] = '\0';
+}
+
+/* The menu line shall be one write that restores the cursor at its end */
+static void Check_Line(const char * pWhere)
+{
+  const char * line = strstr(out, "\x1b[s");
+
+  CHECK(line != NULL, "%s: no menu line", pWhere);
+  if (line != NULL)
+  {
+    CHECK(strlen(line) < MENU_LINE_SIZE, "%s: line of %u bytes", pWhere, (unsigned)strlen(line));
+    CHECK((strlen(line) >= (sizeof(MENU_LINE_END) - 1U)) &&
+          (strcmp(&line[strlen(line) - (sizeof(MENU_LINE_END) - 1U)], MENU_LINE_END) == 0),
+          "%s: cursor not restored at the end of the line", pWhere);
+  }
+}
+
+static void Check_Walk(void)
+{
+  char     visible[OUT_SIZE];
+  char     highlight[LCD_SIZE + 8U];
+  uint32_t step;
+  uint32_t writes = 0U;
+  uint32_t bytes = 0U;
+  uint32_t draws = 0U;
+  uint32_t actions_start = actions;
+  uint32_t nb = (uint32_t)(sizeof(walk) / sizeof(walk[0]));
+
+  for (step = 0U; step < nb; step++)
+  {
+    Out_Reset();
+    switch (walk[step].key)
+    {
+      case 'n': Next_Menu_Item();   break;
+      case 'p': Prev_Menu_Item();   break;
+      case 's': Select_Menu_Item(); break;
+      default:  Exit_Menu_Item();   break;
+    }
+    writes += out_writes;
+    bytes += out_len;
+    draws += lcd_draws;
+
+    Out_Visible(visible, sizeof(visible));
+    CHECK(strcmp(visible, walk[step].uart) == 0, "key %u '%c': UART \"%s\" instead of \"%s\"", (unsigned)step,
+          walk[step].key, visible, walk[step].uart);
+    CHECK(strcmp(lcd_text, walk[step].lcd) == 0, "key %u '%c': LCD \"%s\" instead of \"%s\"", (unsigned)step,
+          walk[step].key, lcd_text, walk[step].lcd);
+    CHECK(out_writes <= KEY_WRITES_MAX, "key %u '%c': %u UART writes", (unsigned)step, walk[step].key,
+          (unsigned)out_writes);
+    CHECK(lcd_updates == lcd_draws, "key %u '%c': %u LCD updates for %u draws", (unsigned)step, walk[step].key,
+          (unsigned)lcd_updates, (unsigned)lcd_draws);
+
+    /* The line is printed again on each move, an action prints nothing */
+    if (walk[step].uart[0] != '\0')
+    {
+      Check_Line("walk");
+      CHECK(lcd_draws == 1U, "key %u '%c': %u LCD draws", (unsigned)step, walk[step].key, (unsigned)lcd_draws);
+
+      /* The selected action is highlighted in the line */
+      if (walk[step].lcd[0] == '{')
+      {
+        snprintf(highlight, sizeof(highlight), "\x1b[93m%.*s\x1b[m", (int)(strlen(walk[step].lcd) - 2U),
+                 &walk[step].lcd[1]);
+        CHECK(strstr(out, highlight) != NULL, "key %u '%c': %s not highlighted", (unsigned)step, walk[step].key,
+              walk[step].lcd);
+      }
+    }
+    else
+    {
+      CHECK(lcd_draws == 0U, "key %u '%c': LCD drawn by an action", (unsigned)step, walk[step].key);
+    }
+  }
+
+  printf("  %u keys, %u actions: %.1f UART writes, %.1f bytes and %.2f LCD draws per keypress\n", (unsigned)nb,
+         (unsigned)(actions - actions_start), (double)writes / nb, (double)bytes / nb, (double)draws / nb);
+}
+
+/* Periodic refresh of the UART line, with and without a print in progress */
+static void Check_Refresh(void)
+{
+  char     visible[OUT_SIZE];
+  char     ref[OUT_SIZE];
+  uint32_t i;
+
+  CHECK(timer_cb != NULL, "no refresh timer");
+  if (timer_cb == NULL)
+  {
+    return;
+  }
+  CHECK(timer_ticks == HW_TS_MENU_REFRESH_DELAY, "refresh every %u ticks", (unsigned)timer_ticks);
+
+  Out_Reset();
+  Refresh_Menu();
+  Out_Visible(ref, sizeof(ref));
+
+  for (i = 0U; i < 10U; i++)
+  {
+    Out_Reset();
+    timer_cb();
+    Out_Visible(visible, sizeof(visible));
+    CHECK(out_writes == REFRESH_WRITES, "refresh: %u UART writes", (unsigned)out_writes);
+    CHECK(lcd_draws == 0U, "refresh: %u LCD draws", (unsigned)lcd_draws);
+    CHECK(strcmp(visible, ref) == 0, "refresh: \"%s\" instead of \"%s\"", visible, ref);
+    Check_Line("refresh");
+  }
+  printf("  refresh: %u UART write of %u bytes, %u LCD draw\n", (unsigned)out_writes, (unsigned)out_len,
+         (unsigned)lcd_draws);
+
+  /* The refresh interrupts a new selection: skipped, the line is not mixed */
+  Out_Reset();
+  sim_printf_irq = timer_cb;
+  Next_Menu_Item();
+  CHECK(sim_printf_irq == NULL, "no UART write on a new selection");
+  CHECK(out_writes == 1U, "refresh during a print: %u UART writes", (unsigned)out_writes);
+  Check_Line("refresh during a print");
+  Prev_Menu_Item();
+}
+
+/* The config is run again from "Global Infos": back to the main menu, no
+ * other timer */
+static void Check_Restart(void)
+{
+  char visible[OUT_SIZE];
+
+  Next_Menu_Item();
+  Select_Menu_Item();
+
+  Out_Reset();
+  CHECK(Menu_Config() == true, "menu config failed at the restart");
+  CHECK(timer_nb == 1U, "%u refresh timers after the restart", (unsigned)timer_nb);
+  Out_Visible(visible, sizeof(visible));
+  CHECK(strcmp(visible, " MENU :  [Network]   Window Cfg    Window Cmd    Light    Factory Reset    Global Infos    Logs  ")
+        == 0, "restart: \"%s\"", visible);
+  CHECK(strcmp(lcd_text, "[Network]") == 0, "restart: LCD \"%s\"", lcd_text);
+}
+
+/* Tables refused by Def_Start_Menu_Item(), and a line longer than the buffer */
+static void Check_Tables(void)
+{
+  static const Menu_Item_T action[] = { MENU_ACTION("Action", &App_Core_Ntw_Join) };
+  static const Menu_Item_T both[] = { { "Both", action, 1U, &App_Core_Ntw_Join } };
+  static const Menu_Item_T none[] = { { "None", NULL, 0U, NULL } };
+  static const Menu_Item_T empty[] = { { "Empty", action, 0U, NULL } };
+  static const Menu_Item_T depth_3[] = { MENU_SUB("Depth 4", action) };
+  static const Menu_Item_T depth_2[] = { MENU_SUB("Depth 3", depth_3) };
+  static const Menu_Item_T depth_1[] = { MENU_SUB("Depth 2", depth_2) };
+  static const Menu_Item_T depth_0[] = { MENU_SUB("Depth 1", depth_1) };
+  static const Menu_Item_T deepest[] = { MENU_SUB("Depth 1", depth_2) };
+  static const Menu_Item_T wide[] =
+  {
+    MENU_ACTION("Wide item number 01", &App_Core_Ntw_Join), MENU_ACTION("Wide item number 02", &App_Core_Ntw_Join),
+    MENU_ACTION("Wide item number 03", &App_Core_Ntw_Join), MENU_ACTION("Wide item number 04", &App_Core_Ntw_Join),
+    MENU_ACTION("Wide item number 05", &App_Core_Ntw_Join), MENU_ACTION("Wide item number 06", &App_Core_Ntw_Join),
+    MENU_ACTION("Wide item number 07", &App_Core_Ntw_Join), MENU_ACTION("Wide item number 08", &App_Core_Ntw_Join),
+    MENU_ACTION("Wide item number 09", &App_Core_Ntw_Join), MENU_ACTION("Wide item number 10", &App_Core_Ntw_Join),
+    MENU_ACTION("Wide item number 11", &App_Core_Ntw_Join), MENU_ACTION("Wide item number 12", &App_Core_Ntw_Join),
+    MENU_ACTION("Wide item number 13", &App_Core_Ntw_Join), MENU_ACTION("Wide item number 14", &App_Core_Ntw_Join),
+    MENU_ACTION("Wide item number 15", &App_Core_Ntw_Join), MENU_ACTION("Wide item number 16", &App_Core_Ntw_Join),
+    MENU_ACTION("Wide item number 17", &App_Core_Ntw_Join), MENU_ACTION("Wide item number 18", &App_Core_Ntw_Join),
+    MENU_ACTION("Wide item number 19", &App_Core_Ntw_Join), MENU_ACTION("Wide item number 20", &App_Core_Ntw_Join),
+    MENU_ACTION("Wide item number 21", &App_Core_Ntw_Join), MENU_ACTION("Wide item number 22", &App_Core_Ntw_Join),
+  };
+  uint8_t i;
+
+  CHECK(Def_Start_Menu_Item(both, MENU_NB(both)) == false, "item with an action and a submenu accepted");
+  CHECK(Def_Start_Menu_Item(none, MENU_NB(none)) == false, "item without action nor submenu accepted");
+  CHECK(Def_Start_Menu_Item(empty, MENU_NB(empty)) == false, "empty submenu accepted");
+  CHECK(Def_Start_Menu_Item(NULL, 1U) == false, "no main menu accepted");
+  CHECK(Def_Start_Menu_Item(depth_0, MENU_NB(depth_0)) == false, "menu deeper than %u levels accepted",
+        (unsigned)MENU_DEPTH_MAX);
+  CHECK(Def_Start_Menu_Item(deepest, MENU_NB(deepest)) == true, "menu of %u levels refused", (unsigned)MENU_DEPTH_MAX);
+
+  /* Down to the deepest level and back */
+  for (i = 0U; i < (MENU_DEPTH_MAX - 1U); i++)
+  {
+    Select_Menu_Item();
+  }
+  CHECK(strcmp(lcd_text, "{Action}") == 0, "deepest level: LCD \"%s\"", lcd_text);
+  for (i = 0U; i < MENU_DEPTH_MAX; i++)
+  {
+    Exit_Menu_Item();
+  }
+  CHECK(strcmp(lcd_text, "[Depth 1]") == 0, "back from the deepest level: LCD \"%s\"", lcd_text);
+
+  /* Truncated before the end of line */
+  CHECK(Def_Start_Menu_Item(wide, MENU_NB(wide)) == true, "wide menu refused");
+  for (i = 0U; i < MENU_NB(wide); i++)
+  {
+    Out_Reset();
+    Prev_Menu_Item();
+    CHECK(out_writes == 1U, "wide menu: %u UART writes", (unsigned)out_writes);
+    Check_Line("wide menu");
+  }
+  printf("  wide menu: %u items in a line of %u bytes\n", (unsigned)MENU_NB(wide), (unsigned)out_len);
+
+  CHECK(Menu_Config() == true, "menu config failed after the table checks");
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char * argv[])
+{
+  if (argc > 1)
+  {
+    fprintf(stderr, "usage: menu_walk\n");
+    return 2;
+  }
+
+  Out_Reset();
+  CHECK(Menu_Config() == true, "menu config failed");
+  CHECK(timer_nb == 1U, "%u refresh timers at the start", (unsigned)timer_nb);
+  CHECK(out_writes == 1U, "start: %u UART writes", (unsigned)out_writes);
+  Check_Line("start");
+  printf("  start: %u heap allocations, %u UART write of %u bytes\n", (unsigned)heap_nb, (unsigned)out_writes,
+         (unsigned)out_len);
+
+  Check_Walk();
+  Check_Refresh();
+  Check_Restart();
+  Check_Tables();
+  CHECK(heap_nb == 0U, "%u heap allocations", (unsigned)heap_nb);
+  CHECK(timer_nb == 1U, "%u refresh timers at the end", (unsigned)timer_nb);
+
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
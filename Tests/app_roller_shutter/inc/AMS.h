@@ -0,0 +1,23 @@
+/**
+  ******************************************************************************
+  * @file    AMS.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the motor board BSP, the occupancy filter
+  *          and reporting tests do not drive the motor
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef AMS_H
+#define AMS_H
+
+#endif /* AMS_H */
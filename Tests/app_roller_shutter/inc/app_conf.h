@@ -0,0 +1,58 @@
+/**
+  ******************************************************************************
+  * @file    app_conf.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the application configuration of the
+  *          roller shutter tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef APP_CONF_H
+#define APP_CONF_H
+
+#include "stm32wbxx_hal.h"
+#include "hw_if.h"
+
+/* Logs compiled in, the levels are left to LOG_LEVEL_NONE by the tests */
+#define LOG_DEFERRED_ENABLE                     1U
+#define APPLI_PRINT_FILE_FUNC_LINE              0
+
+/* Timer server tick : RTC clock of 32768 Hz divided by 16 */
+#define CFG_TS_TICK_VAL                         (488U)
+#define HW_TS_SERVER_1ms_NB_TICKS               (uint32_t) (1*1000/CFG_TS_TICK_VAL)
+#define HW_TS_SERVER_1S_NB_TICKS                (1000*HW_TS_SERVER_1ms_NB_TICKS)
+
+/* Probes of app_bench.h left out */
+#define CFG_BENCH_ENABLE                        0
+
+/* Timer server */
+typedef enum
+{
+  CFG_TIM_PROC_ID_ISR,
+} CFG_TimProcID_t;
+
+/* Scheduler */
+typedef enum
+{
+  CFG_TASK_ROLLER_SHUTTER_OCCUPANCY_EVT,
+  CFG_TASK_NBR
+} CFG_IdleTask_Id_t;
+
+typedef enum
+{
+  CFG_SCH_PRIO_0,
+  CFG_SCH_PRIO_1,
+  CFG_PRIO_NBR,
+} CFG_SCH_Prio_Id_t;
+
+#endif /* APP_CONF_H */
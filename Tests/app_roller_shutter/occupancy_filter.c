@@ -0,0 +1,518 @@
+/**
+  ******************************************************************************
+  * @file    occupancy_filter.c
+  * @author  Zigbee Application Team
+  * @brief   Synthetic occupancy sequences through the occupancy filter of the
+  *          roller shutter. The unmodified filter runs on a simulated RTC
+  *          timer server and sequencer, with the occupancy task of the
+  *          application. Every motor command is checked against the hold-off,
+  *          the dwell times and the reversal rate limit, and against its
+  *          earliest allowed time: a pending decision shall not be lost or
+  *          late. The reports of a bouncing and a flapping sensor, each
+  *          a motor command without the filter, are compared to the commands.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+/* The stub configuration comes first: the include guards it shares with the
+ * application headers keep them out */
+#include "app_conf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Code under test, built as is to reach its configuration */
+#include "app_roller_shutter_occupancy_filter.c"
+
+/* Private defines -----------------------------------------------------------*/
+#define RUN_DEFAULT             200U
+#define RUN_DURATION            (30U * 60U * 1000U)
+
+/* Simulated time in ps, the RTC tick is 16 / 32768 s */
+#define PS_PER_MS               1000000000ULL
+#define PS_PER_TICK             488281250ULL
+
+/* A command is given at most this late after its earliest time (in ms), the
+ * timer server runs on 488 us ticks and the filter on 1 ms ticks */
+#define LATE_MAX                2U
+
+/* Private variables ---------------------------------------------------------*/
+static long                 failures;
+static uint32_t             sim_rng = 0x2545F491U;
+
+/* Simulated clock, timer and sequencer */
+static uint64_t             sim_time;
+static HW_TS_pTimerCb_t     sim_timer_cb;
+static bool                 sim_timer_armed;
+static uint64_t             sim_timer_expiry;
+static bool                 sim_task_pending;
+static uint32_t             sim_expiries;
+
+/* Simulated NVM parameter */
+static bool                 sim_nvm_valid;
+static uint32_t             sim_nvm_holdoff;
+static uint32_t             sim_nvm_writes;
+
+/* Expected filter state, rebuilt from the inputs and the commands issued */
+static struct
+{
+  bool     is_raw;
+  bool     raw;
+  uint32_t raw_tick;
+  bool     is_applied;
+  bool     applied;
+  uint32_t applied_tick;
+  uint32_t reversal_tick[OCC_FILTER_REVERSAL_MAX];
+  uint32_t reversal_nb;
+  uint32_t command_nb;
+  uint32_t report_nb;
+  uint32_t change_nb;         /* Sensor state changes */
+  uint32_t late_max;
+} check;
+
+/* Private functions ---------------------------------------------------------*/
+#define CHECK(cond, ...) \
+  do \
+  { \
+    if (!(cond)) \
+    { \
+      if (failures < 20) \
+      { \
+        fprintf(stderr, "  "); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+      } \
+      failures++; \
+    } \
+  } while (0)
+
+static uint32_t Sim_Random(void)
+{
+  sim_rng ^= sim_rng << 13;
+  sim_rng ^= sim_rng >> 17;
+  sim_rng ^= sim_rng << 5;
+  return sim_rng;
+}
+
+/* Simulated platform --------------------------------------------------------*/
+/* Logs of the filter, disabled by the log levels */
+appliLogLevel_t             logRegionLevel[APPLI_LOG_REGION_NB];
+
+void logDeferred(appliLogLevel_t aLogLevel, appliLogRegion_t aLogRegion, const char *aFile, const char *aFormat, ...)
+{
+  (void)aLogLevel;
+  (void)aLogRegion;
+  (void)aFile;
+  (void)aFormat;
+}
+
+uint32_t HAL_GetTick(void)
+{
+  return (uint32_t)(sim_time / PS_PER_MS);
+}
+
+HW_TS_ReturnStatus_t HW_TS_Create(uint32_t TimerProcessID, uint8_t *pTimerId, HW_TS_Mode_t TimerMode, HW_TS_pTimerCb_t pTimerCallBack)
+{
+  (void)TimerProcessID;
+  CHECK(TimerMode == hw_ts_SingleShot, "filter timer not single shot");
+  *pTimerId       = 0U;
+  sim_timer_cb    = pTimerCallBack;
+  sim_timer_armed = false;
+  return hw_ts_Successful;
+}
+
+void HW_TS_Stop(uint8_t TimerID)
+{
+  (void)TimerID;
+  sim_timer_armed = false;
+}
+
+void HW_TS_Start(uint8_t TimerID, uint32_t timeout_ticks)
+{
+  (void)TimerID;
+  CHECK(timeout_ticks != 0U, "filter timer started for 0 tick");
+  sim_timer_armed  = true;
+  sim_timer_expiry = sim_time + ((uint64_t)timeout_ticks * PS_PER_TICK);
+}
+
+void UTIL_SEQ_SetTask(UTIL_SEQ_bm_t TaskId_bm, uint32_t Task_Prio)
+{
+  (void)Task_Prio;
+  CHECK(TaskId_bm == (1U << CFG_TASK_ROLLER_SHUTTER_OCCUPANCY_EVT), "task 0x%X set", (unsigned)TaskId_bm);
+  sim_task_pending = true;
+}
+
+bool App_NVM_Param_Read(App_NVM_Param_T param, uint32_t *value)
+{
+  CHECK(param == APP_NVM_PARAM_OCC_HOLDOFF, "NVM parameter %d read", (int)param);
+  *value = sim_nvm_holdoff;
+  return sim_nvm_valid;
+}
+
+bool App_NVM_Param_Write(App_NVM_Param_T param, uint32_t value)
+{
+  CHECK(param == APP_NVM_PARAM_OCC_HOLDOFF, "NVM parameter %d written", (int)param);
+  sim_nvm_valid   = true;
+  sim_nvm_holdoff = value;
+  sim_nvm_writes++;
+  return true;
+}
+
+/* Application ---------------------------------------------------------------*/
+/* Earliest time of the command pending on the expected state */
+static uint32_t Check_Earliest(void)
+{
+  uint32_t earliest = check.raw_tick + occ_filter_cfg.holdoff;
+  uint32_t dwell;
+
+  if (check.is_applied)
+  {
+    dwell = (check.applied) ? occ_filter_cfg.dwell_up : occ_filter_cfg.dwell_down;
+    if ((check.applied_tick + dwell) > earliest)
+    {
+      earliest = check.applied_tick + dwell;
+    }
+    if ((check.reversal_nb >= OCC_FILTER_REVERSAL_MAX) &&
+        ((check.reversal_tick[check.reversal_nb % OCC_FILTER_REVERSAL_MAX] + OCC_FILTER_REVERSAL_WINDOW) > earliest))
+    {
+      earliest = check.reversal_tick[check.reversal_nb % OCC_FILTER_REVERSAL_MAX] + OCC_FILTER_REVERSAL_WINDOW;
+    }
+  }
+  return earliest;
+}
+
+static bool Check_Is_Pending(void)
+{
+  return (check.is_raw) && ((check.is_applied == false) || (check.raw != check.applied));
+}
+
+/* A command shall be given once all the constraints allow it, and not before */
+static void Check_Command(bool occupied)
+{
+  uint32_t now = HAL_GetTick();
+  uint32_t earliest;
+
+  CHECK(Check_Is_Pending() && (occupied == check.raw), "%u ms: command %s without a pending change", now,
+        occupied ? "up" : "down");
+  earliest = Check_Earliest();
+  CHECK(now >= earliest, "%u ms: command %s %u ms early", now, occupied ? "up" : "down", earliest - now);
+  CHECK(now <= (earliest + LATE_MAX), "%u ms: command %s %u ms late", now, occupied ? "up" : "down", now - earliest);
+  if ((now > earliest) && ((now - earliest) > check.late_max))
+  {
+    check.late_max = now - earliest;
+  }
+
+  if (check.is_applied)
+  {
+    check.reversal_tick[check.reversal_nb % OCC_FILTER_REVERSAL_MAX] = now;
+    check.reversal_nb++;
+  }
+  check.is_applied   = true;
+  check.applied      = occupied;
+  check.applied_tick = now;
+  check.command_nb++;
+}
+
+/* The occupancy task of the application */
+static void Sim_Occupancy_Task(void)
+{
+  switch (App_Roller_Shutter_Occupancy_Filter_Process())
+  {
+    case OCC_FILTER_ACTION_UP :
+      Check_Command(true);
+      break;
+
+    case OCC_FILTER_ACTION_DOWN :
+      Check_Command(false);
+      break;
+
+    default :
+      break;
+  }
+}
+
+/* Runs the timer and the task up to Time (in ms) */
+static void Sim_Run_Until(uint32_t Time)
+{
+  uint64_t end = (uint64_t)Time * PS_PER_MS;
+
+  while (sim_timer_armed && (sim_timer_expiry <= end))
+  {
+    sim_time        = sim_timer_expiry;
+    sim_timer_armed = false;
+    sim_expiries++;
+    sim_timer_cb();
+    if (sim_task_pending)
+    {
+      sim_task_pending = false;
+      Sim_Occupancy_Task();
+    }
+  }
+  /* A decision still pending 2 ms after its time is lost */
+  if (Check_Is_Pending())
+  {
+    CHECK((Check_Earliest() + LATE_MAX) >= Time, "%u ms: command %s pending since %u ms", Time,
+          check.raw ? "up" : "down", Check_Earliest());
+  }
+  sim_time = end;
+}
+
+/* Occupancy report received at Time (in ms) */
+static void Sim_Report(uint32_t Time, bool Occupied)
+{
+  Sim_Run_Until(Time);
+
+  check.report_nb++;
+  if ((check.is_raw == false) || (Occupied != check.raw))
+  {
+    check.change_nb++;
+    check.is_raw   = true;
+    check.raw      = Occupied;
+    check.raw_tick = Time;
+  }
+
+  App_Roller_Shutter_Occupancy_Filter_Input(Occupied, HAL_GetTick());
+  UTIL_SEQ_SetTask(1U << CFG_TASK_ROLLER_SHUTTER_OCCUPANCY_EVT, CFG_SCH_PRIO_1);
+  if (sim_task_pending)
+  {
+    sim_task_pending = false;
+    Sim_Occupancy_Task();
+  }
+}
+
+static void Sim_Reset(void)
+{
+  memset(&check, 0, sizeof(check));
+  sim_time         = 0U;
+  sim_task_pending = false;
+  sim_expiries     = 0U;
+  App_Roller_Shutter_Occupancy_Filter_Init();
+}
+
+/* Checks --------------------------------------------------------------------*/
+/* A bouncing sensor, faster than the hold-off, never moves the shutter */
+static void Check_Bounce(void)
+{
+  const Occ_Filter_Stats_T *stats = App_Roller_Shutter_Occupancy_Filter_Get_Stats();
+  uint32_t t;
+
+  Sim_Reset();
+  Sim_Report(1000U, false);
+  Sim_Run_Until(10000U);
+  CHECK(check.command_nb == 1U, "%u commands on the first report", (unsigned)check.command_nb);
+
+  for (t = 10000U; t < 70000U; t += 500U)
+  {
+    Sim_Report(t, ((t / 500U) & 1U) == 0U);
+  }
+  Sim_Report(t, false);
+  Sim_Run_Until(t + 60000U);
+  CHECK(check.command_nb == 1U, "%u commands with a sensor bouncing every 500 ms", (unsigned)check.command_nb);
+  CHECK(stats->bounce_nb != 0U, "no bounce counted");
+  printf("  sensor bouncing every 500 ms for 60 s: %u reports, %u changes, %u commands, %u bounces\n",
+         (unsigned)check.report_nb, (unsigned)check.change_nb, (unsigned)check.command_nb,
+         (unsigned)stats->bounce_nb);
+
+  /* Then a real occupancy */
+  Sim_Report(t + 60000U, true);
+  Sim_Run_Until(t + 70000U);
+  CHECK((check.command_nb == 2U) && check.applied, "no command up after the bounces");
+}
+
+/* A flapping sensor, slower than the hold-off: the dwell times and the rate limit */
+static void Check_Flapping(void)
+{
+  const Occ_Filter_Stats_T *stats = App_Roller_Shutter_Occupancy_Filter_Get_Stats();
+  uint32_t t;
+
+  Sim_Reset();
+  for (t = 0U; t < (20U * 60U * 1000U); t += 3000U)
+  {
+    Sim_Report(t, ((t / 3000U) & 1U) != 0U);
+  }
+  Sim_Run_Until(t);
+
+  CHECK(check.reversal_nb <= (((20U * 60U * 1000U) / OCC_FILTER_REVERSAL_WINDOW) + 1U) * OCC_FILTER_REVERSAL_MAX,
+        "%u reversals in 20 min", (unsigned)check.reversal_nb);
+  CHECK((stats->dwell_nb != 0U) && (stats->rate_limit_nb != 0U), "%u delayed by dwell, %u by rate limit",
+        (unsigned)stats->dwell_nb, (unsigned)stats->rate_limit_nb);
+  printf("  sensor flapping every 3 s for 20 min: %u reports, %u commands, %u reversals,"
+         " %u timer expiries\n", (unsigned)check.report_nb, (unsigned)check.command_nb,
+         (unsigned)check.reversal_nb, (unsigned)sim_expiries);
+}
+
+/* Random sequences: stable periods, bursts of bounces, flapping */
+static void Check_Random(uint32_t Number)
+{
+  uint32_t changes = 0U, commands = 0U, reports = 0U, late = 0U;
+  uint32_t n, t, end, gap;
+  bool     occupied;
+
+  for (n = 0U; n < Number; n++)
+  {
+    Sim_Reset();
+    occupied = false;
+    t        = Sim_Random() % 1000U;
+    while (t < RUN_DURATION)
+    {
+      switch (Sim_Random() % 4U)
+      {
+        case 0:
+          /* Bounces */
+          end = t + (Sim_Random() % 5000U);
+          while (t < end)
+          {
+            Sim_Report(t, (Sim_Random() & 1U) != 0U);
+            t += 1U + (Sim_Random() % 700U);
+          }
+          break;
+
+        case 1:
+          /* Flapping around the hold-off */
+          gap = (occ_filter_cfg.holdoff / 2U) + (Sim_Random() % (occ_filter_cfg.holdoff + 1U));
+          end = t + (Sim_Random() % 60000U);
+          while (t < end)
+          {
+            occupied = !occupied;
+            Sim_Report(t, occupied);
+            t += gap + (Sim_Random() % 10U);
+          }
+          break;
+
+        case 2:
+          /* Periodic reports of the same state */
+          end = t + (Sim_Random() % 120000U);
+          while (t < end)
+          {
+            Sim_Report(t, occupied);
+            t += 1000U + (Sim_Random() % 10000U);
+          }
+          break;
+
+        default:
+          /* A change and a long stable state */
+          occupied = !occupied;
+          Sim_Report(t, occupied);
+          t += Sim_Random() % (OCC_FILTER_REVERSAL_WINDOW + 60000U);
+          break;
+      }
+    }
+
+    /* Stable long enough for any pending decision to be taken */
+    Sim_Run_Until(t + OCC_FILTER_REVERSAL_WINDOW + occ_filter_cfg.holdoff + OCC_FILTER_DWELL_UP);
+    CHECK(check.is_applied && (check.applied == check.raw), "run %u: %s not applied at the end", (unsigned)n,
+          check.raw ? "up" : "down");
+
+    changes  += check.change_nb;
+    commands += check.command_nb;
+    reports  += check.report_nb;
+    late        = (check.late_max > late) ? check.late_max : late;
+
+    /* Next run with another hold-off */
+    switch (Sim_Random() % 4U)
+    {
+      case 0:
+        App_Roller_Shutter_Occupancy_Filter_Holdoff_Up();
+        break;
+      case 1:
+        App_Roller_Shutter_Occupancy_Filter_Holdoff_Down();
+        break;
+      default:
+        break;
+    }
+  }
+
+  printf("  %u random runs of %u min: %u reports, %u changes, %u commands, at most %u ms late\n",
+         (unsigned)Number, (unsigned)(RUN_DURATION / 60000U), (unsigned)reports, (unsigned)changes,
+         (unsigned)commands, (unsigned)late);
+}
+
+/* Hold-off from the menu, saved and restored */
+static void Check_Holdoff_Cfg(void)
+{
+  uint32_t i, writes;
+
+  sim_nvm_valid = false;
+  occ_filter_cfg.holdoff = OCC_FILTER_DEFAULT_HOLDOFF;
+  Sim_Reset();
+  CHECK(occ_filter_cfg.holdoff == OCC_FILTER_DEFAULT_HOLDOFF, "hold-off %u ms without NVM",
+        (unsigned)occ_filter_cfg.holdoff);
+
+  writes = sim_nvm_writes;
+  for (i = 0U; i < ((OCC_FILTER_HOLDOFF_LIMIT / OCC_FILTER_HOLDOFF_STEP) + 4U); i++)
+  {
+    App_Roller_Shutter_Occupancy_Filter_Holdoff_Up();
+  }
+  CHECK((occ_filter_cfg.holdoff == OCC_FILTER_HOLDOFF_LIMIT) && (sim_nvm_holdoff == OCC_FILTER_HOLDOFF_LIMIT),
+        "hold-off %u ms, %u in NVM after the maximum", (unsigned)occ_filter_cfg.holdoff, (unsigned)sim_nvm_holdoff);
+  CHECK((sim_nvm_writes - writes) == ((OCC_FILTER_HOLDOFF_LIMIT - OCC_FILTER_DEFAULT_HOLDOFF) / OCC_FILTER_HOLDOFF_STEP),
+        "%u NVM writes", (unsigned)(sim_nvm_writes - writes));
+
+  for (i = 0U; i < ((OCC_FILTER_HOLDOFF_LIMIT / OCC_FILTER_HOLDOFF_STEP) + 4U); i++)
+  {
+    App_Roller_Shutter_Occupancy_Filter_Holdoff_Down();
+  }
+  CHECK((occ_filter_cfg.holdoff == 0U) && (sim_nvm_holdoff == 0U), "hold-off %u ms, %u in NVM after the minimum",
+        (unsigned)occ_filter_cfg.holdoff, (unsigned)sim_nvm_holdoff);
+
+  /* Without hold-off the first report moves the shutter at once */
+  Sim_Reset();
+  Sim_Report(100U, true);
+  CHECK((check.command_nb == 1U) && (check.applied_tick == 100U), "no immediate command without hold-off");
+
+  /* Restored on init, an out of range value is ignored */
+  sim_nvm_holdoff = 4500U;
+  Sim_Reset();
+  CHECK(occ_filter_cfg.holdoff == 4500U, "hold-off %u ms restored", (unsigned)occ_filter_cfg.holdoff);
+  sim_nvm_holdoff = OCC_FILTER_HOLDOFF_LIMIT + 1U;
+  Sim_Reset();
+  CHECK(occ_filter_cfg.holdoff == 4500U, "hold-off %u ms from an out of range NVM value",
+        (unsigned)occ_filter_cfg.holdoff);
+
+  sim_nvm_holdoff = OCC_FILTER_DEFAULT_HOLDOFF;
+  Sim_Reset();
+}
+
+static void Usage(void)
+{
+  fprintf(stderr, "usage: occupancy_filter [-n random_runs]\n");
+  exit(2);
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char * argv[])
+{
+  uint32_t number = RUN_DEFAULT;
+  int i;
+
+  for (i = 1; i < argc; i++)
+  {
+    if ((strcmp(argv[i], "-n") == 0) && ((i + 1) < argc))
+    {
+      number = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+    else
+    {
+      Usage();
+    }
+  }
+
+  Check_Holdoff_Cfg();
+  Check_Bounce();
+  Check_Flapping();
+  Check_Random(number);
+
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
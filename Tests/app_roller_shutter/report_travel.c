@@ -0,0 +1,446 @@
+/**
+  ******************************************************************************
+  * @file    report_travel.c
+  * @author  Zigbee Application Team
+  * @brief   Reports of the window covering state per shutter travel. The
+  *          unmodified reporting policy of the roller shutter configures a
+  *          simulated ZCL reporting engine (min and max intervals, reportable
+  *          change, forced report). Full travels, reversals and commands in
+  *          burst write the state attribute as the window covering server
+  *          does, the motor stop forces the final report. The reports per
+  *          travel and per idle hour are measured for the default policy and
+  *          the policies reachable from the menu, saved and restored.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+/* The stub configuration comes first: the include guards it shares with the
+ * application headers keep them out */
+#include "app_conf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Code under test, built as is to reach its policy */
+#include "app_roller_shutter_report.c"
+
+/* Private defines -----------------------------------------------------------*/
+#define TRAVEL_MS               20000U    /* Full travel of the shutter */
+#define IDLE_MS                 (60U * 60U * 1000U)
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t reports;
+  uint32_t forced;
+  uint32_t start_seen;      /* Motions whose start reached the remote */
+  uint32_t start_delay_max; /* in ms */
+} Sim_Count_t;
+
+/* Private variables ---------------------------------------------------------*/
+static long                 failures;
+static uint32_t             sim_cluster;
+
+/* Simulated clock */
+static uint32_t             sim_time;           /* in ms */
+
+/* Simulated NVM parameters */
+static bool                 sim_nvm_valid[APP_NVM_PARAM_NB];
+static uint32_t             sim_nvm[APP_NVM_PARAM_NB];
+static uint32_t             sim_nvm_writes;
+
+/* Simulated ZCL reporting engine of CURR_POS_LIFT_PERCENT */
+static struct
+{
+  bool     is_config;
+  uint16_t min_intvl;       /* in s */
+  uint16_t max_intvl;       /* in s */
+  uint8_t  change;
+  uint8_t  value;           /* Attribute value */
+  bool     is_reported;
+  uint8_t  reported;        /* Last value reported */
+  uint32_t report_time;     /* in ms */
+  bool     is_moving;       /* A motion waits its report */
+  uint32_t move_time;       /* in ms */
+  Sim_Count_t count;
+} zcl;
+
+/* Private functions ---------------------------------------------------------*/
+#define CHECK(cond, ...) \
+  do \
+  { \
+    if (!(cond)) \
+    { \
+      if (failures < 20) \
+      { \
+        fprintf(stderr, "  "); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+      } \
+      failures++; \
+    } \
+  } while (0)
+
+/* Simulated platform --------------------------------------------------------*/
+/* Logs of the policy, disabled by the log levels */
+appliLogLevel_t             logRegionLevel[APPLI_LOG_REGION_NB];
+
+void logDeferred(appliLogLevel_t aLogLevel, appliLogRegion_t aLogRegion, const char *aFile, const char *aFormat, ...)
+{
+  (void)aLogLevel;
+  (void)aLogRegion;
+  (void)aFile;
+  (void)aFormat;
+}
+
+bool App_NVM_Param_Read(App_NVM_Param_T param, uint32_t *value)
+{
+  if (sim_nvm_valid[param] == false)
+  {
+    return false;
+  }
+  *value = sim_nvm[param];
+  return true;
+}
+
+bool App_NVM_Param_Write(App_NVM_Param_T param, uint32_t value)
+{
+  sim_nvm_valid[param] = true;
+  sim_nvm[param]       = value;
+  sim_nvm_writes++;
+  return true;
+}
+
+/* ZCL reporting engine ------------------------------------------------------*/
+static void Zcl_Send(bool Forced)
+{
+  CHECK((Forced) || (zcl.is_reported == false) ||
+        ((sim_time - zcl.report_time) >= ((uint32_t)zcl.min_intvl * 1000U)),
+        "%u ms: report %u ms after the previous one, min %u s", sim_time, sim_time - zcl.report_time,
+        zcl.min_intvl);
+  zcl.is_reported = true;
+  zcl.reported    = zcl.value;
+  zcl.report_time = sim_time;
+  zcl.count.reports++;
+  if (Forced)
+  {
+    zcl.count.forced++;
+  }
+  if ((zcl.is_moving) && (zcl.value != ZCL_WNCV_COMMAND_STOP))
+  {
+    zcl.is_moving = false;
+    zcl.count.start_seen++;
+    if ((sim_time - zcl.move_time) > zcl.count.start_delay_max)
+    {
+      zcl.count.start_delay_max = sim_time - zcl.move_time;
+    }
+  }
+}
+
+enum ZclStatusCodeT ZbZclAttrReportConfigDefault(struct ZbZclClusterT *clusterPtr, uint16_t attrId,
+                                                 uint16_t default_min, uint16_t default_max, double *default_change)
+{
+  CHECK(clusterPtr == (struct ZbZclClusterT *)&sim_cluster, "report configured on another cluster");
+  CHECK(attrId == ZCL_WNCV_SVR_ATTR_CURR_POS_LIFT_PERCENT, "report configured on attribute 0x%04X", attrId);
+  CHECK((default_max == ZCL_ATTR_REPORT_MAX_INTVL_CHANGE) ||
+        ((default_max >= ZCL_ATTR_REPORT_MAX_INTVL_MINIMUM) && (default_max >= default_min)),
+        "report intervals min %u s, max %u s", default_min, default_max);
+  CHECK((*default_change >= 1.0) && (*default_change <= 255.0), "reportable change %f", *default_change);
+
+  zcl.is_config = true;
+  zcl.min_intvl = default_min;
+  zcl.max_intvl = default_max;
+  zcl.change    = (uint8_t)*default_change;
+  return ZCL_STATUS_SUCCESS;
+}
+
+enum ZclStatusCodeT ZbZclAttrReportKick(struct ZbZclClusterT *cluster, bool send_all,
+                                        void (*callback)(struct ZbZclClusterT *cluster, unsigned int next_timeout, void *arg),
+                                        void *arg)
+{
+  (void)callback;
+  (void)arg;
+  CHECK(cluster == (struct ZbZclClusterT *)&sim_cluster, "report kicked on another cluster");
+  CHECK(send_all, "final report not forced");
+  Zcl_Send(true);
+  return ZCL_STATUS_SUCCESS;
+}
+
+/* Report timer of the stack, run after the application task up to End */
+static void Zcl_Run_Until(uint32_t End)
+{
+  uint32_t next, diff;
+
+  while (zcl.is_config)
+  {
+    if (zcl.is_reported == false)
+    {
+      next = sim_time;
+    }
+    else
+    {
+      next = 0xFFFFFFFFU;
+      diff = (zcl.value > zcl.reported) ? (zcl.value - zcl.reported) : (zcl.reported - zcl.value);
+      if (diff >= zcl.change)
+      {
+        next = zcl.report_time + ((uint32_t)zcl.min_intvl * 1000U);
+      }
+      if ((zcl.max_intvl != ZCL_ATTR_REPORT_MAX_INTVL_CHANGE) &&
+          ((zcl.report_time + ((uint32_t)zcl.max_intvl * 1000U)) < next))
+      {
+        next = zcl.report_time + ((uint32_t)zcl.max_intvl * 1000U);
+      }
+      if (next < sim_time)
+      {
+        next = sim_time;
+      }
+    }
+    if (next > End)
+    {
+      break;
+    }
+    sim_time = next;
+    Zcl_Send(false);
+  }
+  sim_time = End;
+}
+
+/* Window covering server ----------------------------------------------------*/
+/* Attribute written by the window covering server callbacks on a command at
+ * Time (in ms), the motor control task forces the report on a stop */
+static void Sim_Command(uint32_t Time, uint8_t Cmd)
+{
+  Zcl_Run_Until(Time);
+  zcl.value = Cmd;
+  if (Cmd != ZCL_WNCV_COMMAND_STOP)
+  {
+    zcl.is_moving = true;
+    zcl.move_time = Time;
+    return;
+  }
+
+  zcl.is_moving = false;
+  App_Roller_Shutter_Report_Final();
+  CHECK((zcl.reported == ZCL_WNCV_COMMAND_STOP) && (zcl.report_time == Time), "%u ms: stop not reported at once",
+        Time);
+}
+
+static void Sim_Reset(uint16_t Min, uint16_t Max, uint8_t Change)
+{
+  memset(&zcl, 0, sizeof(zcl));
+  memset(sim_nvm_valid, 0, sizeof(sim_nvm_valid));
+  zcl.value = ZCL_WNCV_COMMAND_STOP;
+  sim_time  = 0U;
+
+  report_policy.min_intvl = Min;
+  report_policy.max_intvl = Max;
+  report_policy.change    = Change;
+  App_Roller_Shutter_Report_Init((struct ZbZclClusterT *)&sim_cluster);
+  CHECK(zcl.is_config && (zcl.min_intvl == Min) && (zcl.max_intvl == Max) && (zcl.change == Change),
+        "policy %u s / %u s / %u not configured on init", Min, Max, Change);
+
+  /* Report of the initial state, then the counts start */
+  Zcl_Run_Until(1000U);
+  memset(&zcl.count, 0, sizeof(zcl.count));
+}
+
+/* Full travels up and down with Idle (in ms) between them */
+static void Run_Travels(uint32_t Number, uint32_t Idle)
+{
+  uint32_t i, t = sim_time;
+
+  for (i = 0U; i < Number; i++)
+  {
+    Sim_Command(t, ((i & 1U) == 0U) ? ZCL_WNCV_COMMAND_UP : ZCL_WNCV_COMMAND_DOWN);
+    t += TRAVEL_MS;
+    Sim_Command(t, ZCL_WNCV_COMMAND_STOP);
+    t += Idle;
+  }
+  Zcl_Run_Until(t);
+}
+
+/* Checks --------------------------------------------------------------------*/
+/* Default policy: the start and the stop of each travel, the periodic report at rest */
+static void Check_Default(void)
+{
+  Sim_Reset(REPORT_DEFAULT_MIN_INTVL, REPORT_DEFAULT_MAX_INTVL, REPORT_DEFAULT_CHANGE);
+  Run_Travels(20U, 10U * 1000U);
+  CHECK((zcl.count.reports == 40U) && (zcl.count.forced == 20U) && (zcl.count.start_seen == 20U),
+        "20 travels: %u reports, %u forced, %u starts seen", (unsigned)zcl.count.reports, (unsigned)zcl.count.forced,
+        (unsigned)zcl.count.start_seen);
+  printf("  default policy %u s / %u s / %u: %.1f reports per %u s travel, start seen after %u ms at most",
+         REPORT_DEFAULT_MIN_INTVL, REPORT_DEFAULT_MAX_INTVL, REPORT_DEFAULT_CHANGE, zcl.count.reports / 20.0,
+         TRAVEL_MS / 1000U, (unsigned)zcl.count.start_delay_max);
+
+  memset(&zcl.count, 0, sizeof(zcl.count));
+  Zcl_Run_Until(sim_time + IDLE_MS);
+  CHECK(zcl.count.reports == (IDLE_MS / (REPORT_DEFAULT_MAX_INTVL * 1000U)), "%u reports in an idle hour",
+        (unsigned)zcl.count.reports);
+  printf(", %u reports per idle hour\n", (unsigned)zcl.count.reports);
+
+  /* A travel longer than the max interval */
+  memset(&zcl.count, 0, sizeof(zcl.count));
+  Sim_Command(sim_time, ZCL_WNCV_COMMAND_UP);
+  Sim_Command(sim_time + (2U * REPORT_DEFAULT_MAX_INTVL * 1000U) + 500U, ZCL_WNCV_COMMAND_STOP);
+  CHECK(zcl.count.reports == 4U, "%u reports on a %u s travel", (unsigned)zcl.count.reports,
+        (2U * REPORT_DEFAULT_MAX_INTVL) + 1U);
+}
+
+/* Commands in burst: the min interval spaces the reports, the stop is at once */
+static void Check_Burst(void)
+{
+  uint32_t i, t;
+
+  Sim_Reset(REPORT_DEFAULT_MIN_INTVL, REPORT_DEFAULT_MAX_INTVL, REPORT_DEFAULT_CHANGE);
+  t = sim_time;
+  for (i = 0U; i < 20U; i++)
+  {
+    Sim_Command(t, ((i & 1U) == 0U) ? ZCL_WNCV_COMMAND_UP : ZCL_WNCV_COMMAND_DOWN);
+    t += 100U;
+  }
+  Sim_Command(t, ZCL_WNCV_COMMAND_STOP);
+  CHECK(zcl.count.reports <= ((((20U * 100U) / 1000U) / REPORT_DEFAULT_MIN_INTVL) + 2U),
+        "%u reports for 20 commands in 2 s", (unsigned)zcl.count.reports);
+  printf("  20 reversals in 2 s then a stop: %u reports\n", (unsigned)zcl.count.reports);
+}
+
+/* The policies reachable from the menu */
+static void Check_Policies(void)
+{
+  static const uint16_t mins[]    = { 0U, 1U, 10U, REPORT_MIN_INTVL_LIMIT };
+  static const uint16_t maxs[]    = { ZCL_ATTR_REPORT_MAX_INTVL_CHANGE, ZCL_ATTR_REPORT_MAX_INTVL_MINIMUM, 240U,
+                                      REPORT_MAX_INTVL_LIMIT };
+  static const uint8_t  changes[] = { 1U, 2U, REPORT_CHANGE_LIMIT };
+  uint32_t a, b, c, travel, seen;
+  double   idle;
+
+  printf("  min s | max s | change | reports/travel | starts seen | idle reports/h\n");
+  for (a = 0U; a < (sizeof(mins) / sizeof(mins[0])); a++)
+  {
+    for (b = 0U; b < (sizeof(maxs) / sizeof(maxs[0])); b++)
+    {
+      for (c = 0U; c < sizeof(changes); c++)
+      {
+        Sim_Reset(mins[a], maxs[b], changes[c]);
+        Run_Travels(20U, 10U * 1000U);
+        travel = zcl.count.reports;
+        seen   = zcl.count.start_seen;
+        CHECK(zcl.count.forced == 20U, "%u s / %u s / %u: %u stops forced", mins[a], maxs[b], changes[c],
+              (unsigned)zcl.count.forced);
+        CHECK((changes[c] != 1U) || (TRAVEL_MS < (mins[a] * 1000U)) || (zcl.count.start_seen == 20U),
+              "%u s / %u s / %u: %u starts seen", mins[a], maxs[b], changes[c], (unsigned)zcl.count.start_seen);
+
+        memset(&zcl.count, 0, sizeof(zcl.count));
+        Zcl_Run_Until(sim_time + IDLE_MS);
+        idle = (double)zcl.count.reports;
+        CHECK(idle == ((maxs[b] == ZCL_ATTR_REPORT_MAX_INTVL_CHANGE) ? 0.0 : (double)(IDLE_MS / (maxs[b] * 1000U))),
+              "%u s / %u s / %u: %.0f idle reports", mins[a], maxs[b], changes[c], idle);
+        if ((a == 1U) || (b == 2U))
+        {
+          printf("  %5u | %5u | %6u | %14.1f | %8u/20 | %14.0f\n", mins[a], maxs[b], changes[c], travel / 20.0,
+                 (unsigned)seen, idle);
+        }
+      }
+    }
+  }
+}
+
+/* Menu tuning: limits, saved, restored, invalid values discarded */
+static void Check_Menu(void)
+{
+  uint32_t i, writes;
+
+  Sim_Reset(REPORT_DEFAULT_MIN_INTVL, REPORT_DEFAULT_MAX_INTVL, REPORT_DEFAULT_CHANGE);
+  writes = sim_nvm_writes;
+  for (i = 0U; i < 100U; i++)
+  {
+    App_Roller_Shutter_Report_Min_Up();
+    App_Roller_Shutter_Report_Max_Up();
+    App_Roller_Shutter_Report_Change_Up();
+  }
+  CHECK((report_policy.min_intvl == REPORT_MIN_INTVL_LIMIT) && (report_policy.change == REPORT_CHANGE_LIMIT) &&
+        (report_policy.max_intvl <= REPORT_MAX_INTVL_LIMIT) &&
+        ((report_policy.max_intvl + REPORT_MAX_INTVL_STEP) > REPORT_MAX_INTVL_LIMIT),
+        "policy %u s / %u s / %u at the maximum", report_policy.min_intvl, report_policy.max_intvl,
+        report_policy.change);
+  CHECK((zcl.min_intvl == report_policy.min_intvl) && (zcl.max_intvl == report_policy.max_intvl) &&
+        (zcl.change == report_policy.change), "maximum policy not applied");
+  CHECK((sim_nvm[APP_NVM_PARAM_REPORT_MIN] == report_policy.min_intvl) &&
+        (sim_nvm[APP_NVM_PARAM_REPORT_MAX] == report_policy.max_intvl) &&
+        (sim_nvm[APP_NVM_PARAM_REPORT_CHANGE] == report_policy.change), "maximum policy not saved");
+  CHECK(((sim_nvm_writes - writes) % 3U) == 0U, "%u NVM writes", (unsigned)(sim_nvm_writes - writes));
+
+  for (i = 0U; i < 100U; i++)
+  {
+    App_Roller_Shutter_Report_Min_Down();
+    App_Roller_Shutter_Report_Max_Down();
+    App_Roller_Shutter_Report_Change_Down();
+  }
+  CHECK((report_policy.min_intvl == 0U) && (report_policy.max_intvl == ZCL_ATTR_REPORT_MAX_INTVL_CHANGE) &&
+        (report_policy.change == 1U), "policy %u s / %u s / %u at the minimum", report_policy.min_intvl,
+        report_policy.max_intvl, report_policy.change);
+
+  /* Out of the on change mode at the smallest periodic interval */
+  App_Roller_Shutter_Report_Max_Up();
+  CHECK(report_policy.max_intvl == ZCL_ATTR_REPORT_MAX_INTVL_MINIMUM, "max %u s out of the on change mode",
+        report_policy.max_intvl);
+
+  /* Restored on init */
+  report_policy.min_intvl = REPORT_DEFAULT_MIN_INTVL;
+  report_policy.max_intvl = REPORT_DEFAULT_MAX_INTVL;
+  report_policy.change    = REPORT_DEFAULT_CHANGE;
+  App_Roller_Shutter_Report_Init((struct ZbZclClusterT *)&sim_cluster);
+  CHECK((report_policy.min_intvl == 0U) && (report_policy.max_intvl == ZCL_ATTR_REPORT_MAX_INTVL_MINIMUM) &&
+        (report_policy.change == 1U) && (zcl.max_intvl == ZCL_ATTR_REPORT_MAX_INTVL_MINIMUM),
+        "policy %u s / %u s / %u restored", report_policy.min_intvl, report_policy.max_intvl, report_policy.change);
+
+  /* A periodic interval below the BDB minimum in NVM is discarded */
+  sim_nvm[APP_NVM_PARAM_REPORT_MAX] = ZCL_ATTR_REPORT_MAX_INTVL_MINIMUM - 1U;
+  report_policy.min_intvl = REPORT_DEFAULT_MIN_INTVL;
+  report_policy.max_intvl = REPORT_DEFAULT_MAX_INTVL;
+  report_policy.change    = REPORT_DEFAULT_CHANGE;
+  App_Roller_Shutter_Report_Init((struct ZbZclClusterT *)&sim_cluster);
+  CHECK((report_policy.min_intvl == REPORT_DEFAULT_MIN_INTVL) && (report_policy.max_intvl == REPORT_DEFAULT_MAX_INTVL),
+        "invalid policy %u s / %u s / %u restored", report_policy.min_intvl, report_policy.max_intvl,
+        report_policy.change);
+
+  /* No final report before the cluster is known */
+  report_window_server = NULL;
+  App_Roller_Shutter_Report_Final();
+  App_Roller_Shutter_Report_Apply();
+}
+
+static void Usage(void)
+{
+  fprintf(stderr, "usage: report_travel\n");
+  exit(2);
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char * argv[])
+{
+  if (argc > 1)
+  {
+    Usage();
+  }
+  (void)argv;
+
+  Check_Default();
+  Check_Burst();
+  Check_Policies();
+  Check_Menu();
+
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,801 @@
+/**
+  ******************************************************************************
+  * @file    bench.c
+  * @author  Zigbee Application Team
+  * @brief   Host benchmark of the critical paths of the Zigbee_Roller_Shutter
+  *          application, with the probes of app_bench.c.
+  *          The unmodified sequencer, timer server, EEPROM emulation, NVM,
+  *          Zigbee command transfer and window covering motor control run on
+  *          a simulated RTC, flash, NVIC, CPU2 and motor board. The cycles are host nanoseconds (cpu_hz is 1e9), the flash
+  *          operations take no time. The distributions are printed in the
+  *          JSON of App_Bench_Report() on the standard output, the checks of
+  *          the results on the error output.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+/* The stub configuration comes first: the include guards it shares with the
+ * application headers keep the target configuration and HAL out */
+#include "app_conf.h"
+
+#include <stdbool.h>
+#include <time.h>
+
+/* Code under test, built as is */
+#include "stm32_seq.c"
+#include "hw_timerserver.c"
+#include "flash_driver.c"
+#include "ee.c"
+#include "app_nvm.c"
+#include "app_zigbee.c"
+#include "app_roller_shutter_window_covering.c"
+#include "app_roller_shutter.c"
+#include "app_bench.c"
+
+/* Private defines -----------------------------------------------------------*/
+#define EE_BASE                 (HW_FLASH_ADDRESS + CFG_NVM_BASE_ADDRESS)
+#define EE_FIRST_PAGE           (CFG_NVM_BASE_ADDRESS / HW_FLASH_PAGE_SIZE)
+#define SIM_NB_WORDS            (CFG_EE_BANK0_SIZE / 8U)
+#define SIM_PAGE_WORDS          (HW_FLASH_PAGE_SIZE / 8U)
+#define SIM_ERASED              UINT64_MAX
+
+/* RTC as set by MX_RTC_Init(): 32768 Hz, the sub-second counter and the wakeup
+ * timer both count at RTCCLK / 16 */
+#define SIM_RTC_PREDIV_S        CFG_RTC_SYNCH_PRESCALER
+#define SIM_RTC_PREDIV_A        CFG_RTC_ASYNCH_PRESCALER
+
+/* Workload of one round */
+#define WL_TIMER_NB             (CFG_HW_TS_MAX_NBR_CONCURRENT_TIMER - 1U)   /* The last one is the motor watchdog */
+#define WL_TIMER_REPEATED_NB    2U        /* The first timers are repeated, the others single shot */
+#define WL_TIMER_MAX_TICKS      200U      /* Longest timeout, about 100 ms */
+#define WL_TIMER_OPS            4U        /* Timer starts or stops per round */
+#define WL_IDLE_MAX_TICKS       40U       /* Simulated time between two rounds */
+#define WL_TASK_NB              8U        /* Sequencer tasks of the benchmark, after the application ones */
+#define WL_ZB_CMD_NB            2U        /* Zigbee commands per round */
+#define WL_NVM_PERIOD           16U       /* Rounds between two persistent data writes */
+#define WL_REBOOT_PERIOD        128U      /* Rounds between two NVM init as after a reset */
+#define WL_MOTOR_PERIOD         4U        /* Rounds between two Up, Down or Stop commands on average */
+
+#define TASK_ZB_CMD             CFG_TASK_NBR
+#define TASK_FIRST              (TASK_ZB_CMD + 1U)
+
+#if ((TASK_FIRST + WL_TASK_NB) > UTIL_SEQ_CONF_TASK_NBR)
+#error "Not enough sequencer tasks for the benchmark"
+#endif
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint8_t  id;
+  bool     running;
+  uint32_t start;         /* Simulated tick of the start or of the last expiry */
+  uint32_t timeout;
+  uint32_t nb_expired;
+} WlTimer_T;
+
+typedef struct
+{
+  long     rounds;
+  long     tasks;
+  long     zb_cmds;
+  long     nvm_init;
+  long     nvm_read;
+  long     nvm_write;
+  long     ts_start;
+  long     ts_stop;
+  long     ts_expired;
+  long     erase;
+  long     prog;
+  long     motor_cmds;    /* Up and Down commands that change the running command */
+  long     motor_starts;
+  long     motor_stops;
+} WlStats_T;
+
+/* Private variables ---------------------------------------------------------*/
+/* Simulated core and clocks */
+uint32_t                SystemCoreClock = 1000000000U;
+uint32_t                Sim_PRIMASK;
+CoreDebug_Type          Sim_CoreDebug;
+static DWT_Type         sim_dwt;
+static struct timespec  sim_epoch;
+
+/* Simulated NVIC */
+static bool             sim_irq_enabled[SIM_IRQ_NB];
+static bool             sim_irq_pending[SIM_IRQ_NB];
+
+/* Simulated RTC */
+RTC_HandleTypeDef       hrtc;
+static RTC_TypeDef      sim_rtc;
+static uint32_t         sim_rtc_ticks;
+static uint32_t         sim_wut_count;
+static bool             sim_wutf;
+
+/* Simulated flash */
+static uint64_t         sim_flash[SIM_NB_WORDS];
+
+/* Simulated CPU2 */
+static uint32_t         cpu2_expected_id;
+static uint32_t         cpu2_nb_cmd;
+
+/* Simulated motor board and window covering attributes */
+static long long        sim_wncv_lift;
+static long long        sim_wncv_tilt;
+
+/* Logs, all the regions left to LOG_LEVEL_NONE */
+appliLogLevel_t         logRegionLevel[APPLI_LOG_REGION_NB];
+
+static WlTimer_T        wl_timer[WL_TIMER_NB];
+static WlStats_T        wl;
+static uint32_t         wl_rng = 1U;
+static uint32_t         wl_task_prio[WL_TASK_NB];
+static long             failures;
+
+/* Private functions ---------------------------------------------------------*/
+#define CHECK(cond, ...) \
+  do \
+  { \
+    if (!(cond)) \
+    { \
+      if (failures < 20) \
+      { \
+        fprintf(stderr, "FAIL round %ld: ", wl.rounds); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+      } \
+      failures++; \
+    } \
+  } while (0)
+
+static uint32_t Wl_Random(void)
+{
+  wl_rng ^= wl_rng << 13;
+  wl_rng ^= wl_rng >> 17;
+  wl_rng ^= wl_rng << 5;
+  return wl_rng;
+}
+
+/* Simulated core ------------------------------------------------------------*/
+static uint64_t Sim_Host_Ns(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return ((uint64_t)(now.tv_sec - sim_epoch.tv_sec) * 1000000000ULL) + (uint64_t)now.tv_nsec -
+         (uint64_t)sim_epoch.tv_nsec;
+}
+
+/* One cycle is one nanosecond of the host */
+DWT_Type * Sim_DWT(void)
+{
+  if ((sim_dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0U)
+  {
+    sim_dwt.CYCCNT = (uint32_t)Sim_Host_Ns();
+  }
+  return &sim_dwt;
+}
+
+uint32_t HAL_GetTick(void)
+{
+  return (uint32_t)(Sim_Host_Ns() / 1000000U);
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+  UNUSED(Delay);
+}
+
+void logDeferred(appliLogLevel_t aLogLevel, appliLogRegion_t aLogRegion, const char *aFile, const char *aFormat, ...)
+{
+  UNUSED(aLogLevel);
+  UNUSED(aLogRegion);
+  UNUSED(aFile);
+  UNUSED(aFormat);
+}
+
+/* Simulated NVIC: the interrupts do not nest, a handler runs with PRIMASK set */
+static void Sim_IRQ_Handler(IRQn_Type IRQn)
+{
+  switch (IRQn)
+  {
+    case RTC_WKUP_IRQn:
+      HW_TS_RTC_Wakeup_Handler();
+      break;
+
+    case IPCC_C1_RX_IRQn:
+      /* Acknowledge of the CPU2 on the command channel */
+      TL_ZIGBEE_CmdEvtReceived((TL_EvtPacket_t *)p_ZIGBEE_otcmdbuffer);
+      break;
+
+    default:
+      CHECK(false, "unexpected interrupt %d", (int)IRQn);
+      break;
+  }
+}
+
+void Sim_NVIC_Run(void)
+{
+  uint32_t irq;
+
+  for (irq = 0U; (irq < SIM_IRQ_NB) && (Sim_PRIMASK == 0U); irq++)
+  {
+    if (sim_irq_pending[irq] && sim_irq_enabled[irq])
+    {
+      sim_irq_pending[irq] = false;
+      Sim_PRIMASK = 1U;
+      Sim_IRQ_Handler((IRQn_Type)irq);
+      Sim_PRIMASK = 0U;
+      irq = UINT32_MAX;   /* Start again from the first one */
+    }
+  }
+}
+
+void Sim_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+  sim_irq_enabled[IRQn] = true;
+  Sim_NVIC_Run();
+}
+
+void Sim_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+  sim_irq_enabled[IRQn] = false;
+}
+
+/* Only taken on the next PRIMASK clear or interrupt enable, the callers set it in a critical section */
+void Sim_NVIC_SetPendingIRQ(IRQn_Type IRQn)
+{
+  sim_irq_pending[IRQn] = true;
+}
+
+void Sim_NVIC_ClearPendingIRQ(IRQn_Type IRQn)
+{
+  sim_irq_pending[IRQn] = false;
+}
+
+/* Simulated RTC -------------------------------------------------------------*/
+RTC_TypeDef * Sim_RTC(void)
+{
+  sim_rtc.SSR = SIM_RTC_PREDIV_S - (sim_rtc_ticks % (SIM_RTC_PREDIV_S + 1U));
+  return &sim_rtc;
+}
+
+/* WUTWF: the wakeup timer can be written, that is while it is disabled */
+FlagStatus Sim_RTC_Flag(uint32_t flag)
+{
+  if (flag == RTC_FLAG_WUTWF)
+  {
+    return ((sim_rtc.CR & RTC_CR_WUTE) == 0U) ? SET : RESET;
+  }
+  return sim_wutf ? SET : RESET;
+}
+
+void Sim_RTC_ClearFlag(uint32_t flag)
+{
+  if (flag == RTC_FLAG_WUTF)
+  {
+    sim_wutf = false;
+  }
+}
+
+void Sim_RTC_Wakeup(uint32_t enable)
+{
+  if (enable != 0U)
+  {
+    sim_rtc.CR |= RTC_CR_WUTE;
+    sim_wut_count = 0U;
+  }
+  else
+  {
+    sim_rtc.CR &= ~RTC_CR_WUTE;
+  }
+}
+
+/* The simulated time goes on: the wakeup timer fires every WUTR + 1 ticks and its interrupt is taken at once */
+static void Sim_Advance(uint32_t ticks)
+{
+  while (ticks-- != 0U)
+  {
+    sim_rtc_ticks++;
+    if ((sim_rtc.CR & RTC_CR_WUTE) != 0U)
+    {
+      sim_wut_count++;
+      if (sim_wut_count > (sim_rtc.WUTR & RTC_WUTR_WUT))
+      {
+        sim_wut_count = 0U;
+        sim_wutf      = true;
+        Sim_NVIC_SetPendingIRQ(RTC_WKUP_IRQn);
+      }
+    }
+    Sim_NVIC_Run();
+  }
+}
+
+/* Weak and left undefined by the application: the ARM linker turns the call into a no-op, not the host one */
+void HW_TS_RTC_CountUpdated_AppNot(void)
+{
+}
+
+/* Simulated flash -----------------------------------------------------------*/
+uint64_t * Sim_Flash_Ptr(uint32_t address)
+{
+  if ((address < EE_BASE) || (address >= (EE_BASE + CFG_EE_BANK0_SIZE)) || ((address & 7U) != 0U))
+  {
+    fprintf(stderr, "read out of the NVM at 0x%08x\n", (unsigned)address);
+    exit(2);
+  }
+  return &sim_flash[(address - EE_BASE) / 8U];
+}
+
+void HAL_FLASH_Unlock(void)
+{
+}
+
+void HAL_FLASH_Lock(void)
+{
+}
+
+int HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef * pEraseInit, uint32_t * PageError)
+{
+  uint32_t page = pEraseInit->Page - EE_FIRST_PAGE;
+
+  *PageError = 0xFFFFFFFFU;
+  if ((page >= CFG_NB_OF_PAGE) || ((page + pEraseInit->NbPages) > CFG_NB_OF_PAGE))
+  {
+    fprintf(stderr, "erase out of the NVM, page %u\n", (unsigned)pEraseInit->Page);
+    exit(2);
+  }
+
+  memset(&sim_flash[page * SIM_PAGE_WORDS], 0xFF, pEraseInit->NbPages * HW_FLASH_PAGE_SIZE);
+  wl.erase += pEraseInit->NbPages;
+  return HAL_OK;
+}
+
+/* NOR flash: programming only clears bits */
+int HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+  uint32_t index = (Address - EE_BASE) / 8U;
+
+  if ((TypeProgram != FLASH_TYPEPROGRAM_DOUBLEWORD) || (Address < EE_BASE) || (index >= SIM_NB_WORDS))
+  {
+    fprintf(stderr, "program type %u at 0x%08x\n", (unsigned)TypeProgram, (unsigned)Address);
+    exit(2);
+  }
+
+  CHECK((sim_flash[index] == SIM_ERASED) || (Data == 0ULL), "program of 0x%08x not erased", (unsigned)Address);
+  sim_flash[index] &= Data;
+  wl.prog++;
+  return HAL_OK;
+}
+
+/* Simulated CPU2 ------------------------------------------------------------*/
+SHCI_CmdStatus_t SHCI_C2_FLASH_EraseActivity(SHCI_EraseActivity_t erase_activity)
+{
+  UNUSED(erase_activity);
+  return SHCI_Success;
+}
+
+/* Answers the command at once: the response overwrites the request in the shared buffer, as on target,
+ * and the acknowledge interrupt is taken on the next interrupt window of the CPU1 */
+void TL_ZIGBEE_SendM4RequestToM0(void)
+{
+  TL_CmdPacket_t *        cmd = p_ZIGBEE_otcmdbuffer;
+  Zigbee_Cmd_Request_t *  req = ZIGBEE_Get_OTCmdPayloadBuffer();
+  Zigbee_Cmd_Request_t *  rsp = ZIGBEE_Get_OTCmdRspPayloadBuffer();
+  uint32_t                sum;
+  uint32_t                index;
+
+  cmd->cmdserial.type = TL_OTCMD_PKT_TYPE;
+
+  CHECK(cmd->cmdserial.cmd.cmdcode == 0x280U, "command code 0x%x", (unsigned)cmd->cmdserial.cmd.cmdcode);
+  CHECK(req->Size <= OT_CMD_BUFFER_SIZE, "command of %u arguments", (unsigned)req->Size);
+  CHECK(cmd->cmdserial.cmd.plen == (8U + (req->Size * 4U)), "command length %u for %u arguments",
+        (unsigned)cmd->cmdserial.cmd.plen, (unsigned)req->Size);
+  CHECK(req->ID == cpu2_expected_id, "command 0x%x, 0x%x expected", (unsigned)req->ID, (unsigned)cpu2_expected_id);
+  CHECK(!sim_irq_pending[IPCC_C1_RX_IRQn], "command sent before the previous acknowledge");
+
+  sum = req->ID;
+  for (index = 0U; (index < req->Size) && (index < OT_CMD_BUFFER_SIZE); index++)
+  {
+    sum += req->Data[index];
+  }
+
+  rsp->ID      = req->ID;
+  rsp->Size    = 1U;
+  rsp->Data[0] = sum;
+
+  cpu2_nb_cmd++;
+  Sim_NVIC_SetPendingIRQ(IPCC_C1_RX_IRQn);
+}
+
+/* Simulated motor board -----------------------------------------------------*/
+bool ams_start_motor_up(void)
+{
+  CHECK((App_Roller_Shutter_Window_Covering_Get_Cmd() == ZCL_WNCV_COMMAND_UP) &&
+        (sim_wncv_lift == ZCL_WNCV_COMMAND_UP) && (sim_wncv_tilt == ZCL_WNCV_COMMAND_UP),
+        "motor started up on command %u", (unsigned)App_Roller_Shutter_Window_Covering_Get_Cmd());
+  wl.motor_starts++;
+  return true;
+}
+
+bool ams_start_motor_down(void)
+{
+  CHECK((App_Roller_Shutter_Window_Covering_Get_Cmd() == ZCL_WNCV_COMMAND_DOWN) &&
+        (sim_wncv_lift == ZCL_WNCV_COMMAND_DOWN) && (sim_wncv_tilt == ZCL_WNCV_COMMAND_DOWN),
+        "motor started down on command %u", (unsigned)App_Roller_Shutter_Window_Covering_Get_Cmd());
+  wl.motor_starts++;
+  return true;
+}
+
+bool ams_stop_motor(void)
+{
+  wl.motor_stops++;
+  return true;
+}
+
+bool ams_adc_change_treshold_value(uint32_t HighThreshold, uint32_t LowThreshold)
+{
+  UNUSED(HighThreshold);
+  UNUSED(LowThreshold);
+  return true;
+}
+
+/* Window covering server, only the attributes written by the command callbacks */
+enum ZclStatusCodeT ZbZclAttrIntegerWrite(struct ZbZclClusterT *cluster, uint16_t attributeId, long long value)
+{
+  UNUSED(cluster);
+  switch (attributeId)
+  {
+    case ZCL_WNCV_SVR_ATTR_CURR_POS_LIFT_PERCENT:
+      sim_wncv_lift = value;
+      break;
+
+    case ZCL_WNCV_SVR_ATTR_CURR_POS_TILT_PERCENT:
+      sim_wncv_tilt = value;
+      break;
+
+    default:
+      CHECK(false, "write of the attribute 0x%04x", (unsigned)attributeId);
+      return ZCL_STATUS_UNSUPP_ATTRIBUTE;
+  }
+  return ZCL_STATUS_SUCCESS;
+}
+
+void App_Roller_Shutter_Report_Final(void)
+{
+}
+
+void App_Core_Display_Update(void)
+{
+}
+
+/* Workload ------------------------------------------------------------------*/
+static void Wl_Timer_Expired(uint32_t index)
+{
+  WlTimer_T * timer = &wl_timer[index];
+  uint32_t    elapsed = sim_rtc_ticks - timer->start;
+
+  CHECK(timer->running, "timer %u expired while stopped", (unsigned)index);
+  CHECK(elapsed == timer->timeout,
+        "timer %u of %u ticks expired after %u ticks", (unsigned)index, (unsigned)timer->timeout, (unsigned)elapsed);
+
+  timer->nb_expired++;
+  wl.ts_expired++;
+  if (index < WL_TIMER_REPEATED_NB)
+  {
+    timer->start = sim_rtc_ticks;
+  }
+  else
+  {
+    timer->running = false;
+  }
+}
+
+#define WL_TIMER_CB(n) \
+  static void Wl_Timer_Cb##n(void) \
+  { \
+    Wl_Timer_Expired(n); \
+  }
+
+WL_TIMER_CB(0)
+WL_TIMER_CB(1)
+WL_TIMER_CB(2)
+WL_TIMER_CB(3)
+WL_TIMER_CB(4)
+
+static const HW_TS_pTimerCb_t wl_timer_cb[WL_TIMER_NB] =
+{
+  Wl_Timer_Cb0, Wl_Timer_Cb1, Wl_Timer_Cb2, Wl_Timer_Cb3, Wl_Timer_Cb4,
+};
+
+static void Wl_Timer_Init(void)
+{
+  uint32_t index;
+
+  HW_TS_Init(hw_ts_InitMode_Full, &hrtc);
+  for (index = 0U; index < WL_TIMER_NB; index++)
+  {
+    CHECK(HW_TS_Create(CFG_TIM_PROC_ID_ISR, &wl_timer[index].id,
+                       (index < WL_TIMER_REPEATED_NB) ? hw_ts_Repeated : hw_ts_SingleShot,
+                       wl_timer_cb[index]) == hw_ts_Successful, "timer %u not created", (unsigned)index);
+  }
+}
+
+/* Start or stop a random timer, a running one may be started again */
+static void Wl_Timer_Op(void)
+{
+  uint32_t    index = Wl_Random() % WL_TIMER_NB;
+  WlTimer_T * timer = &wl_timer[index];
+
+  if (timer->running && ((Wl_Random() & 1U) != 0U))
+  {
+    HW_TS_Stop(timer->id);
+    timer->running = false;
+    wl.ts_stop++;
+  }
+  else
+  {
+    timer->timeout = 1U + (Wl_Random() % WL_TIMER_MAX_TICKS);
+    timer->start   = sim_rtc_ticks;
+    timer->running = true;
+    HW_TS_Start(timer->id, timer->timeout);
+    wl.ts_start++;
+  }
+}
+
+/* Motor control of the roller shutter endpoint, as App_Roller_Shutter_Cfg_Endpoint() */
+static void Wl_Motor_Init(void)
+{
+  app_Roller_Shutter_Control.app_Window_Covering_Control = &app_Window_Cov_Control;
+  UTIL_SEQ_RegTask(1U << CFG_TASK_MOTOR_CONTROL, UTIL_SEQ_RFU, App_Roller_Shutter_Motor_Control_Task);
+  CHECK(HW_TS_Create(CFG_TIM_PROC_ID_ISR, &TS_ID_STOP_MOTOR, hw_ts_SingleShot, App_Roller_Shutter_Stop) ==
+        hw_ts_Successful, "motor watchdog not created");
+}
+
+/* Up, Down or Stop command of a remote, delivered to the window covering callbacks as by the stack.
+ * The motor task runs in the next UTIL_SEQ_Run(), the watchdog stops the motor after secure_timer_up/down */
+static void Wl_Motor_Cmd(void)
+{
+  struct ZbApsdeDataIndT  data_ind;
+  uint8_t                 cmd = (uint8_t)(Wl_Random() % 3U);
+
+  memset(&data_ind, 0, sizeof(data_ind));
+  data_ind.src.nwkAddr = 0x1234U;
+  data_ind.src.extAddr = 0x0080E10000001234ULL;
+
+  if ((cmd != ZCL_WNCV_COMMAND_STOP) && (cmd != App_Roller_Shutter_Window_Covering_Get_Cmd()))
+  {
+    wl.motor_cmds++;
+  }
+  switch (cmd)
+  {
+    case ZCL_WNCV_COMMAND_UP:
+      Window_Server_Up_Cb(app_Window_Cov_Control.window_server, NULL, &data_ind, NULL);
+      break;
+
+    case ZCL_WNCV_COMMAND_DOWN:
+      Window_Server_Down_Cb(app_Window_Cov_Control.window_server, NULL, &data_ind, NULL);
+      break;
+
+    default:
+      Window_Server_Stop_Cb(app_Window_Cov_Control.window_server, NULL, &data_ind, NULL);
+      break;
+  }
+}
+
+static void Wl_Task(void)
+{
+  wl.tasks++;
+}
+
+/* Caller of the Zigbee commands, as the stack API wrappers of zigbee_core_wb.c */
+static void Wl_Zb_Cmd_Task(void)
+{
+  Zigbee_Cmd_Request_t *  req;
+  Zigbee_Cmd_Request_t *  rsp;
+  uint32_t                sum;
+  uint32_t                index;
+  uint32_t                nb;
+
+  wl.tasks++;
+  for (nb = 0U; nb < WL_ZB_CMD_NB; nb++)
+  {
+    req       = ZIGBEE_Get_OTCmdPayloadBuffer();
+    req->ID   = MSG_M4TOM0_GET_ZB_HEAP_AVAILABLE + (Wl_Random() & 0xFFU);
+    req->Size = Wl_Random() % (OT_CMD_BUFFER_SIZE + 1U);
+    sum       = req->ID;
+    for (index = 0U; index < req->Size; index++)
+    {
+      req->Data[index] = Wl_Random();
+      sum += req->Data[index];
+    }
+    cpu2_expected_id = req->ID;
+
+    ZIGBEE_CmdTransfer();
+    wl.zb_cmds++;
+
+    rsp = ZIGBEE_Get_OTCmdRspPayloadBuffer();
+    CHECK((rsp->ID == cpu2_expected_id) && (rsp->Size == 1U) && (rsp->Data[0] == sum),
+          "response 0x%x of %u arguments", (unsigned)rsp->ID, (unsigned)rsp->Size);
+  }
+}
+
+/* Persistent data of a random length written, read back and checked, as App_Persist_Save() and App_Persist_Load() */
+static void Wl_Nvm(void)
+{
+  static uint32_t data[ST_PERSIST_MAX_ALLOC_SZ / 4U];
+  uint32_t        len = 4U + (Wl_Random() % (ST_PERSIST_MAX_ALLOC_SZ - ST_PERSIST_FLASH_DATA_OFFSET - 3U));
+  uint32_t        index;
+
+  memset(cache_persistent_data.U8_data, 0x00, ST_PERSIST_MAX_ALLOC_SZ);
+  for (index = 1U; index <= ((len + 3U) / 4U); index++)
+  {
+    cache_persistent_data.U32_data[index] = Wl_Random();
+  }
+  cache_persistent_data.U32_data[0] = len;
+  memcpy(data, cache_persistent_data.U32_data, sizeof(data));
+
+  CHECK(App_NVM_Write(), "persistent data of %u bytes not written", (unsigned)len);
+  wl.nvm_write++;
+
+  memset(cache_persistent_data.U8_data, 0x00, ST_PERSIST_MAX_ALLOC_SZ);
+  CHECK(App_NVM_Read(), "persistent data of %u bytes not read", (unsigned)len);
+  wl.nvm_read++;
+  CHECK(memcmp(data, cache_persistent_data.U32_data, 4U + (((len + 3U) / 4U) * 4U)) == 0,
+        "persistent data of %u bytes read back different", (unsigned)len);
+}
+
+static void Wl_Round(void)
+{
+  uint32_t index;
+  uint32_t nb;
+
+  for (nb = 0U; nb < WL_TIMER_OPS; nb++)
+  {
+    Wl_Timer_Op();
+  }
+
+  /* A random set of tasks with random priorities, and the Zigbee command caller */
+  for (index = 0U; index < WL_TASK_NB; index++)
+  {
+    if ((Wl_Random() & 1U) != 0U)
+    {
+      UTIL_SEQ_SetTask(1U << (TASK_FIRST + index), wl_task_prio[index]);
+    }
+  }
+  UTIL_SEQ_SetTask(1U << TASK_ZB_CMD, CFG_SCH_PRIO_0);
+  if ((Wl_Random() % WL_MOTOR_PERIOD) == 0U)
+  {
+    Wl_Motor_Cmd();
+  }
+  UTIL_SEQ_Run(UTIL_SEQ_DEFAULT);
+
+  if ((wl.rounds % WL_REBOOT_PERIOD) == (WL_REBOOT_PERIOD - 1U))
+  {
+    App_NVM_Init();
+    wl.nvm_init++;
+  }
+  if ((wl.rounds % WL_NVM_PERIOD) == 0U)
+  {
+    Wl_Nvm();
+  }
+
+  Sim_Advance(Wl_Random() % WL_IDLE_MAX_TICKS);
+}
+
+static void Wl_Check_Stats(Bench_Id_T id, long nb)
+{
+  const Bench_Stats_T * stats = App_Bench_Get_Stats(id);
+  uint32_t              p50   = App_Bench_Percentile(id, 50U);
+  uint32_t              p90   = App_Bench_Percentile(id, 90U);
+  uint32_t              p99   = App_Bench_Percentile(id, 99U);
+
+  CHECK(stats->count == (uint32_t)nb, "%s: %u samples for %ld calls", bench_name[id], (unsigned)stats->count, nb);
+  if (stats->count != 0U)
+  {
+    CHECK((stats->min <= p50) && (p50 <= p90) && (p90 <= p99) && (p99 <= stats->max),
+          "%s: min %u p50 %u p90 %u p99 %u max %u", bench_name[id], (unsigned)stats->min, (unsigned)p50,
+          (unsigned)p90, (unsigned)p99, (unsigned)stats->max);
+  }
+}
+
+static void Usage(void)
+{
+  fprintf(stderr, "usage: bench [-n rounds] [-s seed]\n");
+  exit(2);
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char * argv[])
+{
+  long      nb_rounds = 2000;
+  uint32_t  nb_timer_expired = 0U;
+  uint32_t  index;
+  int       arg;
+
+  for (arg = 1; arg < argc; arg++)
+  {
+    if ((strcmp(argv[arg], "-n") == 0) && ((arg + 1) < argc))
+    {
+      nb_rounds = atol(argv[++arg]);
+    }
+    else if ((strcmp(argv[arg], "-s") == 0) && ((arg + 1) < argc))
+    {
+      wl_rng = (uint32_t)strtoul(argv[++arg], NULL, 0);
+      if (wl_rng == 0U)
+      {
+        Usage();
+      }
+    }
+    else
+    {
+      Usage();
+    }
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &sim_epoch);
+  memset(sim_flash, 0xFF, sizeof(sim_flash));
+  sim_rtc.PRER = (SIM_RTC_PREDIV_A << 16) | SIM_RTC_PREDIV_S;
+  hrtc.Instance = &sim_rtc;
+  Sim_NVIC_EnableIRQ(IPCC_C1_RX_IRQn);
+
+  /* As the application: sequencer, timer server, NVM, then the probes */
+  UTIL_SEQ_Init();
+  for (index = 0U; index < WL_TASK_NB; index++)
+  {
+    UTIL_SEQ_RegTask(1U << (TASK_FIRST + index), UTIL_SEQ_RFU, Wl_Task);
+    wl_task_prio[index] = Wl_Random() % CFG_PRIO_NBR;
+  }
+  UTIL_SEQ_RegTask(1U << TASK_ZB_CMD, UTIL_SEQ_RFU, Wl_Zb_Cmd_Task);
+  App_Zigbee_RegisterCmdBuffer(&ZigbeeOtCmdBuffer);
+  Wl_Timer_Init();
+  Wl_Motor_Init();
+  App_NVM_Init();
+  App_Bench_Init();
+
+  for (wl.rounds = 0; wl.rounds < nb_rounds; wl.rounds++)
+  {
+    Wl_Round();
+  }
+
+  /* Let the running single shot timers expire, then stop the repeated ones */
+  Sim_Advance(WL_TIMER_MAX_TICKS + 2U);
+  for (index = 0U; index < WL_TIMER_NB; index++)
+  {
+    CHECK((index < WL_TIMER_REPEATED_NB) || !wl_timer[index].running, "timer %u never expired", (unsigned)index);
+    nb_timer_expired += wl_timer[index].nb_expired;
+  }
+
+  App_Bench_Report();
+
+  Wl_Check_Stats(BENCH_MOTOR_CMD, wl.motor_cmds);
+  Wl_Check_Stats(BENCH_NVM_INIT, wl.nvm_init);
+  Wl_Check_Stats(BENCH_NVM_READ, wl.nvm_read);
+  Wl_Check_Stats(BENCH_NVM_WRITE, wl.nvm_write);
+  Wl_Check_Stats(BENCH_ZB_CMD_TRANSFER, wl.zb_cmds);
+  /* Each run of the motor task starts or stops the motor, the limit switches are not simulated */
+  Wl_Check_Stats(BENCH_SEQ_DISPATCH, wl.tasks + wl.motor_starts + wl.motor_stops);
+  CHECK(App_Bench_Get_Stats(BENCH_TS_START)->count <= (uint32_t)(wl.ts_start + wl.ts_expired + wl.motor_starts),
+        "ts_start: %u samples", (unsigned)App_Bench_Get_Stats(BENCH_TS_START)->count);
+  CHECK(cpu2_nb_cmd == (uint32_t)wl.zb_cmds, "%u commands received by the CPU2 for %ld sent", (unsigned)cpu2_nb_cmd,
+        wl.zb_cmds);
+  CHECK(nb_timer_expired == (uint32_t)wl.ts_expired, "%u expiries counted", (unsigned)nb_timer_expired);
+  CHECK(wl.ts_expired != 0, "no timer expired");
+  CHECK(wl.motor_starts == wl.motor_cmds, "%ld motor starts for %ld commands", wl.motor_starts, wl.motor_cmds);
+  CHECK(wl.motor_cmds != 0, "no motor command");
+
+  fprintf(stderr, "%ld rounds: %ld tasks, %ld Zigbee commands, %ld NVM writes, %ld NVM init, %ld timer starts, "
+          "%ld stops, %ld expiries, %ld page erases, %ld programs, %ld motor starts, %ld stops\n", wl.rounds, wl.tasks,
+          wl.zb_cmds, wl.nvm_write, wl.nvm_init, wl.ts_start, wl.ts_stop, wl.ts_expired, wl.erase, wl.prog,
+          wl.motor_starts, wl.motor_stops);
+  fprintf(stderr, "%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,33 @@
+/**
+  ******************************************************************************
+  * @file    AMS.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the motor board BSP, the benchmark records
+  *          the motor starts and stops in place of the PWM
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef AMS_H
+#define AMS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+bool ams_init(uint32_t duty_cycle, uint32_t max_adc_treshold);
+bool ams_start_motor_up(void);
+bool ams_start_motor_down(void);
+bool ams_stop_motor(void);
+bool ams_adc_change_treshold_value(uint32_t HighThreshold, uint32_t LowThreshold);
+void ams_pwm_change_duty_cycle(uint32_t duty_cycle);
+
+#endif /* AMS_H */
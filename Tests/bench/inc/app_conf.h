@@ -0,0 +1,107 @@
+/**
+  ******************************************************************************
+  * @file    app_conf.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the application configuration for the
+  *          benchmark, same values as the Zigbee_Roller_Shutter application
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef APP_CONF_H
+#define APP_CONF_H
+
+#include "stm32wbxx_hal.h"
+#include "hw_conf.h"
+#include "hw_if.h"
+
+/* Probes of app_bench.h enabled */
+#define CFG_BENCH_ENABLE                        1
+
+/* Deferred logs, the levels are left to LOG_LEVEL_NONE by the benchmark */
+#define LOG_DEFERRED_ENABLE                     1U
+#define APPLI_PRINT_FILE_FUNC_LINE              0
+
+/* Flash driver */
+#define CFG_FD_SEM_TIMEOUT                      1000U
+#define CFG_FD_LEASE_MAX_HOLD                   5U
+#define CFG_FD_FAST_PROGRAM                     0U
+
+/* RTC, as set by MX_RTC_Init() */
+#define CFG_RTC_WUCKSEL_DIVIDER                 (0U)
+#define CFG_RTC_ASYNCH_PRESCALER                (0x0FU)
+#define CFG_RTC_SYNCH_PRESCALER                 (0x7FFFU)
+
+/* Timer server tick : RTC clock of 32768 Hz divided by 16 */
+#define CFG_TS_TICK_VAL                         (488U)
+#define HW_TS_SERVER_1ms_NB_TICKS               (uint32_t) (1*1000/CFG_TS_TICK_VAL)
+#define HW_TS_SERVER_1S_NB_TICKS                (1000*HW_TS_SERVER_1ms_NB_TICKS)
+
+/* Timer server */
+typedef enum
+{
+  CFG_TIM_PROC_ID_ISR,
+  CFG_TIM_WAIT_BEFORE_READ_ATTR,
+  CFG_TIM_SAMPLE_TOUCHKEY_STATUS,
+  CFG_TIM_TOUCHKEY_BRIGHTNESS_LEVEL,
+  CFG_TIM_MENU_REFRESH,
+} CFG_TimProcID_t;
+
+/* Scheduler */
+typedef enum
+{
+  CFG_TASK_NOTIFY_FROM_M0_TO_M4,
+  CFG_TASK_REQUEST_FROM_M0_TO_M4,
+  CFG_TASK_SYSTEM_HCI_ASYNCH_EVT,
+  CFG_TASK_ZIGBEE_NETWORK_JOIN,
+  CFG_TASK_BUTTON_SW1,
+  CFG_TASK_BUTTON_SW2,
+  CFG_TASK_LIMIT_SWITCH,
+  CFG_TASK_MOTOR_CONTROL,
+  CFG_TASK_LIGHT_UPDATE,
+  CFG_TASK_LIGHT_LEVEL_TRANSITION,
+  CFG_TASK_ROLLER_SHUTTER_OCCUPANCY_EVT,
+  CFG_TASK_LCD_CLEAN_STATUS,
+  CFG_TASK_LCD_REFRESH,
+  CFG_TASK_LOG_FLUSH,
+  CFG_TASK_CONSOLE,
+  CFG_TASK_NBR
+} CFG_IdleTask_Id_t;
+
+typedef enum
+{
+  CFG_SCH_PRIO_0,
+  CFG_SCH_PRIO_1,
+  CFG_PRIO_NBR,
+} CFG_SCH_Prio_Id_t;
+
+typedef enum
+{
+  CFG_EVT_SYSTEM_HCI_CMD_EVT_RESP,
+  CFG_EVT_ACK_FROM_M0_EVT,
+  CFG_EVT_SYNCHRO_BYPASS_IDLE,
+  CFG_EVT_ZIGBEE_NETWORK_JOIN,
+  CFG_EVT_ZIGBEE_STARTUP_ENDED,
+  CFG_EVT_ZIGBEE_PERMIT_JOIN_REQ_RSP,
+  CFG_EVT_ON_OFF_RSP,
+  CFG_EVT_LEVELCTRL_RSP,
+} CFG_IdleEvt_Id_t;
+
+#define EVENT_ACK_FROM_M0_EVT                   (1U << CFG_EVT_ACK_FROM_M0_EVT)
+#define EVENT_SYNCHRO_BYPASS_IDLE               (1U << CFG_EVT_SYNCHRO_BYPASS_IDLE)
+#define EVENT_ZIGBEE_NETWORK_JOIN               (1U << CFG_EVT_ZIGBEE_NETWORK_JOIN)
+#define EVENT_ZIGBEE_STARTUP_ENDED              (1U << CFG_EVT_ZIGBEE_STARTUP_ENDED)
+#define EVENT_ZIGBEE_PERMIT_JOIN_REQ_RSP        (1U << CFG_EVT_ZIGBEE_PERMIT_JOIN_REQ_RSP)
+#define EVENT_ON_OFF_RSP                        (1U << CFG_EVT_ON_OFF_RSP)
+#define EVENT_LEVELCTRL_RSP                     (1U << CFG_EVT_LEVELCTRL_RSP)
+
+#endif /* APP_CONF_H */
@@ -0,0 +1,84 @@
+/**
+  ******************************************************************************
+  * @file    cmsis_compiler.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the core services used by the benchmark,
+  *          the cycle counter reads the host clock and the interrupts are
+  *          simulated
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef CMSIS_COMPILER_H
+#define CMSIS_COMPILER_H
+
+#include <stdint.h>
+
+#define __IO                                    volatile
+#define __WEAK                                  __attribute__((weak))
+#define __weak                                  __attribute__((weak))
+
+/* PRIMASK, the pending interrupts are taken when it is cleared, see bench.c */
+extern uint32_t Sim_PRIMASK;
+void Sim_NVIC_Run(void);
+
+static inline uint32_t __get_PRIMASK(void)
+{
+  return Sim_PRIMASK;
+}
+
+static inline void __set_PRIMASK(uint32_t priMask)
+{
+  Sim_PRIMASK = priMask;
+  if (priMask == 0U)
+  {
+    Sim_NVIC_Run();
+  }
+}
+
+static inline void __disable_irq(void)
+{
+  Sim_PRIMASK = 1U;
+}
+
+static inline void __enable_irq(void)
+{
+  __set_PRIMASK(0U);
+}
+
+static inline uint8_t __CLZ(uint32_t value)
+{
+  return (value == 0U) ? 32U : (uint8_t)__builtin_clz(value);
+}
+
+/* Cycle counter, one cycle is one nanosecond of the host, see bench.c */
+typedef struct
+{
+  uint32_t CTRL;
+  uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+  uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk                  (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk              (1UL << 24)
+
+DWT_Type * Sim_DWT(void);
+extern CoreDebug_Type Sim_CoreDebug;
+
+#define DWT                                     (Sim_DWT())
+#define CoreDebug                               (&Sim_CoreDebug)
+
+#endif /* CMSIS_COMPILER_H */
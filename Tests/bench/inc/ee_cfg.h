@@ -0,0 +1,32 @@
+/**
+  ******************************************************************************
+  * @file    ee_cfg.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the EEPROM emulation configuration for the
+  *          benchmark, the NVM layout of app_nvm.h on a simulated flash
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef EE_CFG_H__
+#define EE_CFG_H__
+
+#include "app_common.h"
+#include "hw_flash.h"
+#include "flash_driver.h"
+#include "app_nvm.h"
+
+/* Every flash read of ee.c goes through the simulated flash */
+uint64_t * Sim_Flash_Ptr(uint32_t address);
+#define EE_PTR( x )                     Sim_Flash_Ptr( x )
+
+#endif /* EE_CFG_H__ */
@@ -0,0 +1,31 @@
+/**
+  ******************************************************************************
+  * @file    stm32_lcd.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the LCD utility, nothing is displayed
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef STM32_LCD_H
+#define STM32_LCD_H
+
+#include <stdint.h>
+
+#define CENTER_MODE                             1U
+#define LEFT_MODE                               3U
+#define LINE(x)                                 ((x) * 8U)
+
+#define UTIL_LCD_ClearStringLine(line)
+#define UTIL_LCD_DisplayStringAt(x, y, text, mode)
+
+#endif /* STM32_LCD_H */
@@ -0,0 +1,31 @@
+/**
+  ******************************************************************************
+  * @file    stm32wb5mm_dk.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the DK board header, only the RGB LED levels
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef STM32WB5MM_DK_H
+#define STM32WB5MM_DK_H
+
+#define STM32WB5MM_DK_H
+
+#include <stdint.h>
+
+typedef uint8_t PwmLedGsData_TypeDef;
+
+#define PWM_LED_GSDATA_OFF                      (PwmLedGsData_TypeDef) 0u
+#define PWM_LED_GSDATA_47_0                     (PwmLedGsData_TypeDef) 129u
+
+#endif /* STM32WB5MM_DK_H */
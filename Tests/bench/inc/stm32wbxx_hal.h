@@ -0,0 +1,207 @@
+/**
+  ******************************************************************************
+  * @file    stm32wbxx_hal.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the HAL used by the benchmark: simulated RTC
+  *          wakeup timer, flash controller and hardware semaphores
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef STM32WBXX_HAL_H
+#define STM32WBXX_HAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cmsis_compiler.h"
+
+typedef enum
+{
+  RESET = 0,
+  SET = !RESET
+} FlagStatus;
+
+typedef enum
+{
+  HAL_OK       = 0x00U,
+  HAL_ERROR    = 0x01U,
+  HAL_BUSY     = 0x02U,
+  HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+#define UNUSED(X)                               (void)X
+
+#define READ_BIT(REG, BIT)                      ((REG) & (BIT))
+#define SET_BIT(REG, BIT)                       ((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT)                     ((REG) &= ~(BIT))
+#define MODIFY_REG(REG, CLEARMASK, SETMASK)     ((REG) = (((REG) & (~(CLEARMASK))) | (SETMASK)))
+#define POSITION_VAL(VAL)                       ((uint32_t)__builtin_ctz(VAL))
+
+extern uint32_t SystemCoreClock;
+
+uint32_t HAL_GetTick(void);
+void     HAL_Delay(uint32_t Delay);
+
+/* NVIC, a pending and enabled interrupt is taken as soon as PRIMASK is cleared, see bench.c */
+typedef enum
+{
+  RTC_WKUP_IRQn   = 3,
+  EXTI4_IRQn      = 10,
+  EXTI9_5_IRQn    = 23,
+  IPCC_C1_RX_IRQn = 44,
+  SIM_IRQ_NB      = 64
+} IRQn_Type;
+
+void Sim_NVIC_EnableIRQ(IRQn_Type IRQn);
+void Sim_NVIC_DisableIRQ(IRQn_Type IRQn);
+void Sim_NVIC_SetPendingIRQ(IRQn_Type IRQn);
+void Sim_NVIC_ClearPendingIRQ(IRQn_Type IRQn);
+
+#define HAL_NVIC_SetPriority(irq, preempt, sub)
+#define HAL_NVIC_EnableIRQ(irq)                 Sim_NVIC_EnableIRQ(irq)
+#define HAL_NVIC_DisableIRQ(irq)                Sim_NVIC_DisableIRQ(irq)
+#define HAL_NVIC_SetPendingIRQ(irq)             Sim_NVIC_SetPendingIRQ(irq)
+#define HAL_NVIC_ClearPendingIRQ(irq)           Sim_NVIC_ClearPendingIRQ(irq)
+
+#define LL_EXTI_EnableRisingTrig_0_31(line)
+#define LL_EXTI_EnableIT_0_31(line)
+
+/* GPIO of the limit switches and ADC of the motor current, left to the parts of
+ * app_roller_shutter.c that the benchmark does not reach */
+typedef enum
+{
+  GPIO_PIN_RESET = 0,
+  GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct
+{
+  uint32_t IDR;
+} GPIO_TypeDef;
+
+typedef struct
+{
+  uint32_t Pin;
+  uint32_t Mode;
+  uint32_t Pull;
+} GPIO_InitTypeDef;
+
+#define GPIOC                                   ((GPIO_TypeDef *)0x48000800UL)
+#define GPIOE                                   ((GPIO_TypeDef *)0x48001000UL)
+#define GPIO_PIN_4                              (1U << 4)
+#define GPIO_PIN_5                              (1U << 5)
+#define GPIO_MODE_IT_FALLING                    0x10210000U
+#define GPIO_PULLUP                             0x00000001U
+
+#define __HAL_RCC_GPIOC_CLK_ENABLE()
+#define __HAL_RCC_GPIOE_CLK_ENABLE()
+#define __HAL_GPIO_EXTI_CLEAR_IT(pin)
+
+void          HAL_GPIO_Init(GPIO_TypeDef * GPIOx, GPIO_InitTypeDef * GPIO_Init);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef * GPIOx, uint16_t GPIO_Pin);
+
+typedef struct
+{
+  uint32_t TR1;
+} ADC_TypeDef;
+
+typedef struct
+{
+  ADC_TypeDef * Instance;
+} ADC_HandleTypeDef;
+
+#define ADC_ANALOGWATCHDOG_1                    0x00000001U
+#define LL_ADC_AWD_THRESHOLD_HIGH               0x0FFF0000U
+
+uint32_t LL_ADC_GetAnalogWDThresholds(ADC_TypeDef * ADCx, uint32_t AWDy, uint32_t AWDThresholdsHighLow);
+
+/* RTC, the sub-second counter and the wakeup timer run on the simulated time, see bench.c */
+#define LSI_VALUE                               32000U
+
+typedef struct
+{
+  uint32_t CR;
+  uint32_t PRER;
+  uint32_t SSR;
+  uint32_t WUTR;
+} RTC_TypeDef;
+
+typedef struct
+{
+  RTC_TypeDef * Instance;
+} RTC_HandleTypeDef;
+
+#define RTC_CR_WUCKSEL                          (7UL << 0)
+#define RTC_CR_BYPSHAD                          (1UL << 5)
+#define RTC_CR_WUTE                             (1UL << 10)
+#define RTC_PRER_PREDIV_S                       (0x7FFFUL << 0)
+#define RTC_PRER_PREDIV_A                       (0x7FUL << 16)
+#define RTC_SSR_SS                              (0xFFFFUL << 0)
+#define RTC_WUTR_WUT                            (0xFFFFUL << 0)
+
+#define RTC_FLAG_WUTWF                          0U
+#define RTC_FLAG_WUTF                           1U
+#define RTC_IT_WUT                              0U
+#define RTC_EXTI_LINE_WAKEUPTIMER_EVENT         0U
+
+RTC_TypeDef * Sim_RTC(void);
+FlagStatus    Sim_RTC_Flag(uint32_t flag);
+void          Sim_RTC_ClearFlag(uint32_t flag);
+void          Sim_RTC_Wakeup(uint32_t enable);
+
+#define RTC                                     (Sim_RTC())
+
+#define __HAL_RTC_WRITEPROTECTION_DISABLE(h)
+#define __HAL_RTC_WRITEPROTECTION_ENABLE(h)
+#define __HAL_RTC_WAKEUPTIMER_ENABLE(h)         Sim_RTC_Wakeup(1U)
+#define __HAL_RTC_WAKEUPTIMER_DISABLE(h)        Sim_RTC_Wakeup(0U)
+#define __HAL_RTC_WAKEUPTIMER_ENABLE_IT(h, it)
+#define __HAL_RTC_WAKEUPTIMER_GET_FLAG(h, flag) Sim_RTC_Flag(flag)
+#define __HAL_RTC_WAKEUPTIMER_CLEAR_FLAG(h, flag) Sim_RTC_ClearFlag(flag)
+#define __HAL_RTC_WAKEUPTIMER_EXTI_CLEAR_FLAG()
+
+/* Flash controller, the flash is a RAM array, see bench.c */
+#define FLASH_BASE                              0x08000000UL
+#define FLASH_PAGE_SIZE                         4096U
+
+#define FLASH_FLAG_EOP                          (1UL << 0)
+#define FLASH_FLAG_WRPERR                       (1UL << 4)
+#define FLASH_FLAG_PGSERR                       (1UL << 7)
+#define FLASH_FLAG_OPTVERR                      (1UL << 15)
+#define FLASH_FLAG_CFGBSY                       (1UL << 18)
+#define __HAL_FLASH_GET_FLAG(flag)              0U
+#define __HAL_FLASH_CLEAR_FLAG(flag)
+#define LL_FLASH_IsActiveFlag_OperationSuspended()   0U
+
+#define FLASH_TYPEERASE_PAGES                   0U
+#define FLASH_TYPEPROGRAM_DOUBLEWORD            1U
+#define FLASH_TYPEPROGRAM_FAST                  2U
+
+typedef struct
+{
+  uint32_t TypeErase;
+  uint32_t Page;
+  uint32_t NbPages;
+} FLASH_EraseInitTypeDef;
+
+void     HAL_FLASH_Unlock(void);
+void     HAL_FLASH_Lock(void);
+int      HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef * pEraseInit, uint32_t * PageError);
+int      HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+
+/* Hardware semaphores, the CPU2 never takes the flash */
+#define HSEM                                    0
+#define LL_HSEM_1StepLock(hsem, id)             0U
+#define LL_HSEM_GetStatus(hsem, id)             0U
+#define LL_HSEM_ReleaseLock(hsem, id, core)
+
+#endif /* STM32WBXX_HAL_H */
@@ -0,0 +1,24 @@
+/**
+  ******************************************************************************
+  * @file    stm32wbxx_hal_def.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the HAL definitions, see stm32wbxx_hal.h
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef STM32WBXX_HAL_DEF_H
+#define STM32WBXX_HAL_DEF_H
+
+#include "stm32wbxx_hal.h"
+
+#endif /* STM32WBXX_HAL_DEF_H */
@@ -0,0 +1,346 @@
+/**
+  ******************************************************************************
+  * @file    blinkt_frame.c
+  * @author  Zigbee Application Team
+  * @brief   Output check of the Blinkt driver.
+  *          The unmodified blinkt.c drives a bar on GPIO and another one on a
+  *          simulated SPI with DMA with the same random Led updates. The bits
+  *          clocked out on the GPIO, the bytes sent by the SPI and the APA102
+  *          frame built from the Led levels shall be the same. The refreshes
+  *          requested while the SPI is busy shall not be lost.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Code under test, built as is to read the Led levels */
+#include "blinkt.c"
+
+/* Private defines -----------------------------------------------------------*/
+#define INST_GPIO               0U
+#define INST_SPI                1U
+#define FRAME_BITS              (BLINKT_FRAME_SIZE * 8U)
+
+/* Private variables ---------------------------------------------------------*/
+static GPIO_TypeDef         sim_clk_port;
+static GPIO_TypeDef         sim_data_port;
+static SPI_HandleTypeDef    sim_hspi;
+static uint32_t             sim_rng = 0x2545F491U;
+static bool                 sim_no_refresh = true;
+
+/* Bits clocked out on the GPIO since the last check, and the last full frame */
+static uint8_t              gpio_bits[FRAME_BITS * 2U];
+static uint32_t             gpio_nb;
+static uint8_t              gpio_last[BLINKT_FRAME_SIZE];
+
+/* Frame under transfer by the simulated DMA, as read at its start */
+static uint8_t              spi_sent[BLINKT_FRAME_SIZE];
+static uint8_t              spi_last[BLINKT_FRAME_SIZE];
+static uint32_t             spi_frames;
+static uint32_t             spi_busy_calls;
+static uint32_t             spi_overwrites;
+
+/* Private function prototypes -----------------------------------------------*/
+static void Gpio_Frame(const uint8_t * bits, uint8_t * frame);
+
+/* Simulated hardware --------------------------------------------------------*/
+static uint32_t Sim_Random(void)
+{
+  sim_rng ^= sim_rng << 13;
+  sim_rng ^= sim_rng >> 17;
+  sim_rng ^= sim_rng << 5;
+  return sim_rng;
+}
+
+void LL_GPIO_SetOutputPin(GPIO_TypeDef * GPIOx, uint32_t PinMask)
+{
+  /* APA102 samples the data on the rising edge of the clock */
+  if ((GPIOx == &sim_clk_port) && ((GPIOx->ODR & PinMask) == 0U) && (gpio_nb < sizeof(gpio_bits)))
+  {
+    gpio_bits[gpio_nb++] = ((sim_data_port.ODR & GPIO_PIN_13) != 0U) ? 1U : 0U;
+    if ((gpio_nb % FRAME_BITS) == 0U)
+    {
+      Gpio_Frame(&gpio_bits[gpio_nb - FRAME_BITS], gpio_last);
+    }
+  }
+  GPIOx->ODR |= PinMask;
+}
+
+void LL_GPIO_ResetOutputPin(GPIO_TypeDef * GPIOx, uint32_t PinMask)
+{
+  GPIOx->ODR &= ~PinMask;
+}
+
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef * hspi)
+{
+  return hspi->State;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef * hspi, uint8_t * pData, uint16_t Size)
+{
+  if ((hspi->State != HAL_SPI_STATE_READY) || (Size != BLINKT_FRAME_SIZE))
+  {
+    spi_busy_calls++;
+    return HAL_BUSY;
+  }
+  hspi->State      = HAL_SPI_STATE_BUSY_TX;
+  hspi->pTxBuffPtr = pData;
+  hspi->TxXferSize = Size;
+  memcpy(spi_sent, pData, Size);
+  spi_frames++;
+  return HAL_OK;
+}
+
+uint32_t HAL_GetTick(void)
+{
+  return 0U;
+}
+
+/* End of the DMA transfer: the buffer shall not have changed since its start */
+static void Sim_SPI_Complete(void)
+{
+  if (sim_hspi.State != HAL_SPI_STATE_BUSY_TX)
+  {
+    return;
+  }
+  if (memcmp(sim_hspi.pTxBuffPtr, spi_sent, BLINKT_FRAME_SIZE) != 0)
+  {
+    spi_overwrites++;
+  }
+  memcpy(spi_last, spi_sent, BLINKT_FRAME_SIZE);
+  sim_hspi.State = HAL_SPI_STATE_READY;
+  BLINKT_SPI_TxCpltCallback(&sim_hspi);
+}
+
+/* Checks --------------------------------------------------------------------*/
+/* APA102 frame of an instance, from its Led levels: 32 bits at 0, then 3 start bits and
+ * 5 brightness bits at 1, blue, green and red for each Led, then 32 bits at 1 */
+static void Ref_Frame(uint8_t instance, uint8_t * frame)
+{
+  uint32_t n;
+
+  memset(frame, 0x00, 4U);
+  for (n = 0U; n < LEDS_COUNT; n++)
+  {
+    frame[4U + (4U * n)]      = 0xFFU;
+    frame[4U + (4U * n) + 1U] = LED_OUTPUT(leds_values[instance][n].blue);
+    frame[4U + (4U * n) + 2U] = LED_OUTPUT(leds_values[instance][n].green);
+    frame[4U + (4U * n) + 3U] = LED_OUTPUT(leds_values[instance][n].red);
+  }
+  memset(&frame[BLINKT_FRAME_SIZE - 4U], 0xFF, 4U);
+}
+
+/* Bytes of the GPIO bits, MSB first */
+static void Gpio_Frame(const uint8_t * bits, uint8_t * frame)
+{
+  uint32_t i;
+
+  memset(frame, 0, BLINKT_FRAME_SIZE);
+  for (i = 0U; i < FRAME_BITS; i++)
+  {
+    frame[i / 8U] |= (uint8_t)(bits[i] << (7U - (i % 8U)));
+  }
+}
+
+static long Compare(const char * what, long step, const uint8_t * frame, const uint8_t * ref)
+{
+  uint32_t i;
+
+  if (memcmp(frame, ref, BLINKT_FRAME_SIZE) == 0)
+  {
+    return 0;
+  }
+  for (i = 0U; (i < BLINKT_FRAME_SIZE) && (frame[i] == ref[i]); i++);
+  fprintf(stderr, "  step %ld: %s byte %u is 0x%02x, expected 0x%02x\n", step, what, (unsigned)i,
+          (unsigned)frame[i], (unsigned)ref[i]);
+  return 1;
+}
+
+/* Workload ------------------------------------------------------------------*/
+/* The same random update on both bars, the animations update all the bars.
+ * The updates without refresh are left out when sim_no_refresh is false */
+static void Random_Update(void)
+{
+  uint16_t mask  = (uint16_t)(Sim_Random() & 0xFFU);
+  uint8_t  op    = (uint8_t)(Sim_Random() % 7U);
+  uint8_t  red   = (uint8_t)Sim_Random();
+  uint8_t  green = (uint8_t)Sim_Random();
+  uint8_t  blue  = (uint8_t)Sim_Random();
+  uint8_t  level = (uint8_t)Sim_Random();
+  uint8_t  mode  = (uint8_t)(Sim_Random() % BLINKT_BAR_GRAPH_MODE_MAX);
+  uint16_t hue   = (uint16_t)(Sim_Random() % 720U);
+  uint16_t space = (uint16_t)(Sim_Random() % 64U);
+  uint8_t  inst;
+
+  if ((op == 1U) && (sim_no_refresh == false))
+  {
+    op = 0U;
+  }
+  if (op == 6U)
+  {
+    BLINKT_AnimationStep(Sim_Random() % 360U);
+    return;
+  }
+
+  for (inst = INST_GPIO; inst <= INST_SPI; inst++)
+  {
+    switch (op)
+    {
+      case 0:
+        BLINKT_SetLedLevel(inst, mask, red, green, blue);
+        break;
+      case 1:
+        BLINKT_SetLedLevel(inst, mask | BLINKT_NO_REFRESH, red, green, blue);
+        break;
+      case 2:
+        BLINKT_SetLedColor(inst, mask, (BLINKT_COLOR_t)(red % BLINKT_COLOR_MAX));
+        break;
+      case 3:
+        BLINKT_SetBarGraphMode(inst, (BLINKT_BAR_GRAPH_MODE_t)mode);
+        BLINKT_SetBarGraphLevel(inst, level);
+        break;
+      case 4:
+        BLINKT_SetRainbow(inst, hue, space);
+        break;
+      default:
+        BLINKT_SetLevel(inst, red, green, blue);
+        break;
+    }
+  }
+}
+
+static void Usage(void)
+{
+  fprintf(stderr, "usage: blinkt_frame [-n updates]\n");
+  exit(2);
+}
+
+int main(int argc, char * argv[])
+{
+  uint8_t  ref[BLINKT_FRAME_SIZE];
+  uint8_t  frame[BLINKT_FRAME_SIZE];
+  long     nb_updates = 100000;
+  long     step;
+  long     failures = 0;
+  uint32_t gpio_frames = 0U;
+  uint32_t busy_updates = 0U;
+  uint32_t i;
+  int      arg;
+
+  for (arg = 1; arg < argc; arg++)
+  {
+    if ((strcmp(argv[arg], "-n") == 0) && ((arg + 1) < argc))
+    {
+      nb_updates = atol(argv[++arg]);
+    }
+    else
+    {
+      Usage();
+    }
+  }
+
+  sim_hspi.State = HAL_SPI_STATE_READY;
+  BLINKT_Init(INST_GPIO, &sim_clk_port, GPIO_PIN_2, &sim_data_port, GPIO_PIN_13);
+  BLINKT_InitSPI(INST_SPI, &sim_hspi);
+  /* Without hue spacing, the rainbow animation sets the same levels on all the bars */
+  BLINKT_SetAnimationMode(BLINKT_ANINATION_MODE_RAINBOW, 0U);
+  gpio_nb = 0U;
+
+  /* First pass : the transfers end before the next update, both outputs send the same last frame */
+  for (step = 0; step < nb_updates; step++)
+  {
+    spi_frames = 0U;
+    Random_Update();
+    while (sim_hspi.State == HAL_SPI_STATE_BUSY_TX)
+    {
+      Sim_SPI_Complete();
+    }
+
+    Ref_Frame(INST_GPIO, ref);
+    if (gpio_nb != 0U)
+    {
+      if (gpio_nb != FRAME_BITS)
+      {
+        fprintf(stderr, "  step %ld: %u bits clocked out on the GPIO\n", step, (unsigned)gpio_nb);
+        failures++;
+      }
+      Gpio_Frame(gpio_bits, frame);
+      failures += Compare("GPIO", step, frame, ref);
+      gpio_frames++;
+    }
+    if ((spi_frames != 0U) != (gpio_nb != 0U))
+    {
+      fprintf(stderr, "  step %ld: %u SPI frames for %u GPIO bits\n", step, (unsigned)spi_frames, (unsigned)gpio_nb);
+      failures++;
+    }
+    if (spi_frames != 0U)
+    {
+      Ref_Frame(INST_SPI, ref);
+      failures += Compare("SPI", step, spi_last, ref);
+      failures += Compare("SPI vs GPIO", step, spi_last, gpio_last);
+    }
+    gpio_nb = 0U;
+  }
+  printf("  same output : %ld updates, %u frames of %u bits compared\n", nb_updates, (unsigned)gpio_frames,
+         (unsigned)FRAME_BITS);
+
+  /* Second pass : the transfers end at random, the refreshes requested during a transfer are sent
+   * at its end and the last frame sent is always the last frame refreshed on the GPIO bar. A pending
+   * frame is encoded when sent, it also shows the updates done without refresh since the request: these
+   * updates are left out here */
+  sim_no_refresh = false;
+  spi_frames = 0U;
+  for (step = 0; step < nb_updates; step++)
+  {
+    gpio_nb = 0U;
+    if (sim_hspi.State == HAL_SPI_STATE_BUSY_TX)
+    {
+      busy_updates++;
+    }
+    Random_Update();
+    if ((Sim_Random() % 3U) == 0U)
+    {
+      for (i = 0U; (i < 2U) && (sim_hspi.State == HAL_SPI_STATE_BUSY_TX); i++)
+      {
+        Sim_SPI_Complete();
+      }
+      if (sim_hspi.State == HAL_SPI_STATE_READY)
+      {
+        failures += Compare("SPI last frame", step, spi_last, gpio_last);
+      }
+    }
+  }
+  while (sim_hspi.State == HAL_SPI_STATE_BUSY_TX)
+  {
+    Sim_SPI_Complete();
+  }
+  failures += Compare("SPI final frame", step, spi_last, gpio_last);
+  if (spi_busy_calls != 0U)
+  {
+    fprintf(stderr, "  %u transfers started while the SPI was busy\n", (unsigned)spi_busy_calls);
+    failures++;
+  }
+  if (spi_overwrites != 0U)
+  {
+    fprintf(stderr, "  %u frames changed during their transfer\n", (unsigned)spi_overwrites);
+    failures++;
+  }
+  printf("  busy SPI    : %ld updates, %u during a transfer, %u frames sent\n", nb_updates, (unsigned)busy_updates,
+         (unsigned)spi_frames);
+
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,277 @@
+/**
+  ******************************************************************************
+  * @file    blinkt_hsv.c
+  * @author  Zigbee Application Team
+  * @brief   Check of the integer HSV conversion of the Blinkt driver.
+  *          BLINKT_HSVtoRGB() of the unmodified blinkt.c is compared with the
+  *          float conversion of the previous driver for every hue, saturation
+  *          and value: no level shall be more than 1 away, and the grey
+  *          levels shall be the value. The time of both conversions on the
+  *          host is printed, with the hue computed as their callers do.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Code under test, built as is to reach the static conversion */
+#include "blinkt.c"
+
+/* Private defines -----------------------------------------------------------*/
+#define MAX_ERROR               1U
+#define RUN_NB                  5U        /* Timed runs, the fastest one is kept */
+
+/* Private variables ---------------------------------------------------------*/
+static volatile uint32_t    sink;
+
+/* Simulated hardware, the bars are not driven here --------------------------*/
+void LL_GPIO_SetOutputPin(GPIO_TypeDef * GPIOx, uint32_t PinMask)
+{
+  (void)GPIOx;
+  (void)PinMask;
+}
+
+void LL_GPIO_ResetOutputPin(GPIO_TypeDef * GPIOx, uint32_t PinMask)
+{
+  (void)GPIOx;
+  (void)PinMask;
+}
+
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef * hspi)
+{
+  (void)hspi;
+  return HAL_SPI_STATE_READY;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef * hspi, uint8_t * pData, uint16_t Size)
+{
+  (void)hspi;
+  (void)pData;
+  (void)Size;
+  return HAL_OK;
+}
+
+uint32_t HAL_GetTick(void)
+{
+  return 0U;
+}
+
+/* Reference -----------------------------------------------------------------*/
+/* Float conversion of the previous driver, h_f, s_f and v_f from 0 to 1. Its grey case
+ * returned levels of 0 or 1: it is not used, the grey levels are checked apart */
+static void Float_HSVtoRGB(float h_f, float s_f, float v_f, uint8_t *r_p, uint8_t *g_p, uint8_t *b_p)
+{
+  float S, H, V, F, M, N, K;
+  float r_f = 0.0f, g_f = 0.0f, b_f = 0.0f;
+  uint32_t I;
+
+  S = s_f;  /* Saturation */
+  H = h_f;  /* Hue */
+  V = v_f;  /* value or brightness */
+
+  if (H >= 1.0)
+  {
+    H = 0.0;
+  }
+  else
+  {
+    H = H * 6;
+  }
+  I = (int) H;   /* should be in the range 0..5 */
+  F = H - I;     /* fractional part */
+
+  M = V * (1 - S);
+  N = V * (1 - S * F);
+  K = V * (1 - S * (1 - F));
+
+  if (I == 0)
+  {
+    r_f = V;
+    g_f = K;
+    b_f = M;
+  }
+  if (I == 1)
+  {
+    r_f = N;
+    g_f = V;
+    b_f = M;
+  }
+  if (I == 2)
+  {
+    r_f = M;
+    g_f = V;
+    b_f = K;
+  }
+  if (I == 3)
+  {
+    r_f = M;
+    g_f = N;
+    b_f = V;
+  }
+  if (I == 4)
+  {
+    r_f = K;
+    g_f = M;
+    b_f = V;
+  }
+  if (I == 5)
+  {
+    r_f = V;
+    g_f = M;
+    b_f = N;
+  }
+
+  *r_p = (uint8_t)(r_f * 255.0f);
+  *g_p = (uint8_t)(g_f * 255.0f);
+  *b_p = (uint8_t)(b_f * 255.0f);
+}
+
+/* Private functions ---------------------------------------------------------*/
+static uint64_t Host_Ns(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+static uint32_t Diff(uint8_t a, uint8_t b)
+{
+  return (a > b) ? (uint32_t)(a - b) : (uint32_t)(b - a);
+}
+
+/* Full hue circle at full saturation and value, as the rainbow animation, in ns per conversion */
+static double Time_Float(uint32_t loops)
+{
+  uint64_t start = Host_Ns();
+  uint32_t loop, hue;
+  uint8_t  r, g, b;
+
+  for (loop = 0U; loop < loops; loop++)
+  {
+    for (hue = 0U; hue < HUE_MAX; hue++)
+    {
+      Float_HSVtoRGB((float)(((hue + loop) % 360U) / 360.0), 1.0, 1.0, &r, &g, &b);
+      sink += r + g + b;
+    }
+  }
+  return (double)(Host_Ns() - start) / ((double)loops * HUE_MAX);
+}
+
+static double Time_Integer(uint32_t loops)
+{
+  uint64_t start = Host_Ns();
+  uint32_t loop, hue;
+  uint8_t  r, g, b;
+
+  for (loop = 0U; loop < loops; loop++)
+  {
+    for (hue = 0U; hue < HUE_MAX; hue++)
+    {
+      BLINKT_HSVtoRGB((hue + loop) % HUE_MAX, 255U, 255U, &r, &g, &b);
+      sink += r + g + b;
+    }
+  }
+  return (double)(Host_Ns() - start) / ((double)loops * HUE_MAX);
+}
+
+static void Usage(void)
+{
+  fprintf(stderr, "usage: blinkt_hsv [-n timed loops]\n");
+  exit(2);
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char * argv[])
+{
+  uint32_t loops = 20000U;
+  uint32_t hue, sat, val;
+  uint32_t err, max_err = 0U;
+  uint32_t run;
+  uint64_t nb = 0U, nb_diff = 0U;
+  double   t_float = 0.0, t_int = 0.0, t;
+  long     failures = 0;
+  uint8_t  r, g, b, r_ref, g_ref, b_ref;
+  int      arg;
+
+  for (arg = 1; arg < argc; arg++)
+  {
+    if ((strcmp(argv[arg], "-n") == 0) && ((arg + 1) < argc))
+    {
+      loops = (uint32_t)atol(argv[++arg]);
+    }
+    else
+    {
+      Usage();
+    }
+  }
+
+  for (hue = 0U; hue < HUE_MAX; hue++)
+  {
+    for (val = 0U; val <= 255U; val++)
+    {
+      BLINKT_HSVtoRGB(hue, 0U, (uint8_t)val, &r, &g, &b);
+      if ((r != val) || (g != val) || (b != val))
+      {
+        if (failures < 20)
+        {
+          fprintf(stderr, "  hue %u value %u grey: %u %u %u\n", (unsigned)hue, (unsigned)val, r, g, b);
+        }
+        failures++;
+      }
+
+      for (sat = 1U; sat <= 255U; sat++)
+      {
+        BLINKT_HSVtoRGB(hue, (uint8_t)sat, (uint8_t)val, &r, &g, &b);
+        Float_HSVtoRGB((float)(hue / 360.0), sat / 255.0f, val / 255.0f, &r_ref, &g_ref, &b_ref);
+
+        err = Diff(r, r_ref);
+        err = (Diff(g, g_ref) > err) ? Diff(g, g_ref) : err;
+        err = (Diff(b, b_ref) > err) ? Diff(b, b_ref) : err;
+        nb_diff += (r != r_ref) + (g != g_ref) + (b != b_ref);
+        nb += 3U;
+        if (err > max_err)
+        {
+          max_err = err;
+        }
+        if (err > MAX_ERROR)
+        {
+          if (failures < 20)
+          {
+            fprintf(stderr, "  hue %u sat %u value %u: %u %u %u, float %u %u %u\n", (unsigned)hue, (unsigned)sat,
+                    (unsigned)val, r, g, b, r_ref, g_ref, b_ref);
+          }
+          failures++;
+        }
+      }
+    }
+  }
+  printf("  %llu levels compared, %llu differ (%.2f%%), max error %u\n", (unsigned long long)nb,
+         (unsigned long long)nb_diff, (100.0 * nb_diff) / nb, (unsigned)max_err);
+
+  /* Host time only, the float conversion runs in hardware here: on the M4 its double
+   * operations are software calls */
+  for (run = 0U; run < RUN_NB; run++)
+  {
+    t = Time_Float(loops);
+    t_float = ((run == 0U) || (t < t_float)) ? t : t_float;
+    t = Time_Integer(loops);
+    t_int = ((run == 0U) || (t < t_int)) ? t : t_int;
+  }
+  printf("  host time per conversion: float %.1f ns, integer %.1f ns\n", t_float, t_int);
+
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
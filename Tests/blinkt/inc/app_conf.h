@@ -0,0 +1,27 @@
+/**
+  ******************************************************************************
+  * @file    app_conf.h
+  * @author  Zigbee Application Team
+  * @brief   Host configuration of the Blinkt driver, the gamma correction is
+  *          given on the command line
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef APP_CONF_H
+#define APP_CONF_H
+
+#ifndef BLINKT_GAMMA_CORRECTION
+#define BLINKT_GAMMA_CORRECTION       0
+#endif
+
+#endif /* APP_CONF_H */
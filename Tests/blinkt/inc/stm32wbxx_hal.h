@@ -0,0 +1,63 @@
+/**
+  ******************************************************************************
+  * @file    stm32wbxx_hal.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the GPIO and SPI services used by the Blinkt
+  *          driver: the data line is sampled on each clock rising edge and
+  *          the SPI DMA transfers are recorded
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef STM32WBxx_HAL_H
+#define STM32WBxx_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum
+{
+  HAL_OK = 0x00U,
+  HAL_ERROR,
+  HAL_BUSY,
+  HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+typedef struct
+{
+  uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef enum
+{
+  HAL_SPI_STATE_RESET = 0x00U,
+  HAL_SPI_STATE_READY,
+  HAL_SPI_STATE_BUSY_TX
+} HAL_SPI_StateTypeDef;
+
+typedef struct
+{
+  HAL_SPI_StateTypeDef State;
+  const uint8_t *      pTxBuffPtr;
+  uint16_t             TxXferSize;
+} SPI_HandleTypeDef;
+
+#define GPIO_PIN_2                    0x0004U
+#define GPIO_PIN_13                   0x2000U
+
+void                 LL_GPIO_SetOutputPin(GPIO_TypeDef * GPIOx, uint32_t PinMask);
+void                 LL_GPIO_ResetOutputPin(GPIO_TypeDef * GPIOx, uint32_t PinMask);
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef * hspi);
+HAL_StatusTypeDef    HAL_SPI_Transmit_DMA(SPI_HandleTypeDef * hspi, uint8_t * pData, uint16_t Size);
+uint32_t             HAL_GetTick(void);
+
+#endif /* STM32WBxx_HAL_H */
@@ -0,0 +1,406 @@
+/**
+  ******************************************************************************
+  * @file    dbg_trace_stress.c
+  * @author  Zigbee Application Team
+  * @brief   Multi-producer stress test of the trace queue.
+  *          The unmodified dbg_trace.c is written by several host threads,
+  *          some seen as thread mode and some as interrupts, while another
+  *          thread plays the UART: it outputs each chunk after a random delay
+  *          and calls the Tx complete callback. The writers are preempted at
+  *          random while copying in the queue. Each write is one line giving
+  *          its writer and sequence number, the output shall only hold whole
+  *          lines of each writer in order, and the output plus the dropped
+  *          bytes shall be what was written.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <time.h>
+
+/* Code under test, built as is to read the queue state */
+#include "dbg_trace.c"
+#undef memcpy
+
+/* Private defines -----------------------------------------------------------*/
+#define WRITERS_NB              4U      /* Writers 0 and 1 in thread mode, 2 and 3 in interrupts */
+#define LINE_SIZE_MAX           (DBG_TRACE_MSG_QUEUE_SIZE + 64U)
+#define OUTPUT_SIZE_MAX         (64U * 1024U * 1024U)
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t  id;
+  uint32_t  rng;
+  uint32_t  lines;
+  uint64_t  bytes;
+} Writer_t;
+
+/* Private variables ---------------------------------------------------------*/
+static pthread_mutex_t  sim_primask_lock = PTHREAD_MUTEX_INITIALIZER;
+static __thread uint32_t sim_primask;
+static __thread uint32_t sim_ipsr;
+static __thread uint32_t sim_rng = 0x1234567U;
+
+/* UART: chunk under output, set by DbgOutputTraces and cleared at its end */
+static uint8_t * volatile sim_tx_data;
+static volatile uint16_t sim_tx_size;
+static void (* volatile sim_tx_cb)(void);
+static volatile bool    sim_stop;
+static uint32_t         sim_tx_delay;
+static uint32_t         sim_tx_overlaps;
+static volatile uint32_t sim_shared_copies;
+static uint8_t          *sim_output;
+static size_t           sim_output_size;
+
+static uint32_t         sim_lines_per_writer = 3000U;
+
+/* Simulated core ------------------------------------------------------------*/
+static uint32_t Sim_Random(void)
+{
+  sim_rng ^= sim_rng << 13;
+  sim_rng ^= sim_rng >> 17;
+  sim_rng ^= sim_rng << 5;
+  return sim_rng;
+}
+
+/* Gives the CPU to another context from time to time */
+static void Sim_Preempt(void)
+{
+  if ((Sim_Random() % 4U) == 0U)
+  {
+    (void)sched_yield();
+  }
+}
+
+uint32_t __get_PRIMASK(void)
+{
+  return sim_primask;
+}
+
+void __disable_irq(void)
+{
+  if (sim_primask == 0U)
+  {
+    (void)pthread_mutex_lock(&sim_primask_lock);
+    sim_primask = 1U;
+  }
+}
+
+void __set_PRIMASK(uint32_t priMask)
+{
+  if ((priMask == 0U) && (sim_primask != 0U))
+  {
+    sim_primask = 0U;
+    (void)pthread_mutex_unlock(&sim_primask_lock);
+    Sim_Preempt();
+  }
+}
+
+uint32_t __get_IPSR(void)
+{
+  return sim_ipsr;
+}
+
+uint32_t HAL_GetTick(void)
+{
+  struct timespec now;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)((now.tv_sec * 1000U) + (now.tv_nsec / 1000000U));
+}
+
+void * Sim_Memcpy(void * dest, const void * src, size_t size)
+{
+  size_t half = size / 2U;
+
+  memcpy(dest, src, half);
+  Sim_Preempt();
+  if (DbgTraceWriters > 1U)
+  {
+    sim_shared_copies++;
+  }
+  memcpy((uint8_t *)dest + half, (const uint8_t *)src + half, size - half);
+  return dest;
+}
+
+/* Simulated UART ------------------------------------------------------------*/
+void DbgOutputInit(void)
+{
+}
+
+void DbgOutputTraces(uint8_t *p_data, uint16_t size, void (*cb)(void))
+{
+  if (sim_tx_data != NULL)
+  {
+    sim_tx_overlaps++;
+  }
+  sim_tx_size = size;
+  sim_tx_cb = cb;
+  __atomic_store_n(&sim_tx_data, p_data, __ATOMIC_RELEASE);
+}
+
+static void * Uart_Thread(void * arg)
+{
+  uint8_t *p_data;
+  void (*cb)(void);
+  uint32_t i, delay;
+
+  (void)arg;
+  sim_ipsr = 0x25U;   /* USART1 interrupt */
+  sim_rng = 0x9E3779B9U;
+  while (!sim_stop || (sim_tx_data != NULL))
+  {
+    p_data = __atomic_load_n(&sim_tx_data, __ATOMIC_ACQUIRE);
+    if (p_data == NULL)
+    {
+      (void)sched_yield();
+      continue;
+    }
+
+    /* Bytes sent one at a time from the queue, the writers keep running */
+    delay = Sim_Random() % (sim_tx_delay + 1U);
+    for (i = 0U; i < delay; i++)
+    {
+      (void)sched_yield();
+    }
+    if ((sim_output_size + sim_tx_size) <= OUTPUT_SIZE_MAX)
+    {
+      memcpy(&sim_output[sim_output_size], p_data, sim_tx_size);
+    }
+    sim_output_size += sim_tx_size;
+
+    cb = sim_tx_cb;
+    __atomic_store_n(&sim_tx_data, NULL, __ATOMIC_RELEASE);
+    cb();
+  }
+  return NULL;
+}
+
+/* Writers -------------------------------------------------------------------*/
+/* Line of a writer: "W<writer> <sequence> <payload>\n", the payload only depends on the writer and the sequence */
+static uint32_t Line_Build(uint32_t id, uint32_t seq, uint32_t payload, char * line)
+{
+  uint32_t len, i;
+
+  len = (uint32_t)sprintf(line, "W%u %u ", (unsigned)id, (unsigned)seq);
+  for (i = 0U; i < payload; i++)
+  {
+    line[len++] = (char)('a' + (((id * 7U) + seq + i) % 26U));
+  }
+  line[len++] = '\n';
+  return len;
+}
+
+static void * Writer_Thread(void * arg)
+{
+  Writer_t *p_writer = (Writer_t *)arg;
+  char line[LINE_SIZE_MAX + 32U];
+  uint32_t seq, payload, len;
+
+  sim_ipsr = (p_writer->id < 2U) ? 0U : (0x20U + p_writer->id);
+  sim_rng = p_writer->rng;
+  for (seq = 0U; seq < sim_lines_per_writer; seq++)
+  {
+    /* Mostly short lines, a few longer than the whole queue */
+    payload = ((Sim_Random() % 500U) == 0U) ? LINE_SIZE_MAX : (Sim_Random() % 120U);
+    len = Line_Build(p_writer->id, seq, payload, line);
+    if (DbgTraceWrite(1, (const unsigned char *)line, len) != len)
+    {
+      break;
+    }
+    p_writer->lines++;
+    p_writer->bytes += len;
+
+    /* Some time between the writes, so that the queue is not always full */
+    for (payload = Sim_Random() % 4U; payload != 0U; payload--)
+    {
+      (void)sched_yield();
+    }
+  }
+  return NULL;
+}
+
+/* Checks --------------------------------------------------------------------*/
+/* Splits the output in lines, each one shall be a whole line of a writer, after its previous line */
+static long Output_Check(uint64_t * p_lines)
+{
+  char expected[LINE_SIZE_MAX + 32U];
+  int32_t last_seq[WRITERS_NB];
+  size_t pos = 0U, end;
+  unsigned id, seq;
+  long failures = 0;
+  uint32_t i, len;
+
+  for (i = 0U; i < WRITERS_NB; i++)
+  {
+    last_seq[i] = -1;
+  }
+  *p_lines = 0U;
+
+  while ((pos < sim_output_size) && (failures < 10))
+  {
+    for (end = pos; (end < sim_output_size) && (sim_output[end] != '\n'); end++);
+    if ((end == sim_output_size) || (sscanf((const char *)&sim_output[pos], "W%u %u ", &id, &seq) != 2)
+        || (id >= WRITERS_NB) || ((int32_t)seq <= last_seq[id]))
+    {
+      fprintf(stderr, "  output byte %u: line out of order or cut\n", (unsigned)pos);
+      failures++;
+    }
+    else
+    {
+      len = (uint32_t)(end + 1U - pos);
+      if ((len <= (LINE_SIZE_MAX + 32U)) && (len > (uint32_t)sprintf(expected, "W%u %u ", id, seq)))
+      {
+        if ((Line_Build(id, seq, len - 1U - (uint32_t)strlen(expected), expected) != len)
+            || (memcmp(expected, &sim_output[pos], len) != 0))
+        {
+          fprintf(stderr, "  output byte %u: line W%u %u corrupted\n", (unsigned)pos, id, seq);
+          failures++;
+        }
+      }
+      last_seq[id] = (int32_t)seq;
+      (*p_lines)++;
+    }
+    pos = end + 1U;
+  }
+  return failures;
+}
+
+static void Usage(void)
+{
+  fprintf(stderr, "usage: dbg_trace_stress [-n lines per writer]\n");
+  exit(2);
+}
+
+static long Run(uint32_t tx_delay)
+{
+  pthread_t uart, writers[WRITERS_NB];
+  Writer_t writer[WRITERS_NB];
+  DbgTraceStats_t stats;
+  uint64_t written_bytes = 0U, written_lines = 0U, output_lines;
+  long failures;
+  uint32_t i;
+
+  DbgTraceInit();
+  sim_tx_delay = tx_delay;
+  sim_tx_overlaps = 0U;
+  sim_shared_copies = 0U;
+  sim_output_size = 0U;
+  sim_stop = false;
+  (void)pthread_create(&uart, NULL, Uart_Thread, NULL);
+  for (i = 0U; i < WRITERS_NB; i++)
+  {
+    memset(&writer[i], 0, sizeof(writer[i]));
+    writer[i].id = i;
+    writer[i].rng = 0x2545F491U * (i + 1U) + tx_delay;
+    (void)pthread_create(&writers[i], NULL, Writer_Thread, &writer[i]);
+  }
+  for (i = 0U; i < WRITERS_NB; i++)
+  {
+    (void)pthread_join(writers[i], NULL);
+    written_bytes += writer[i].bytes;
+    written_lines += writer[i].lines;
+  }
+  while (DbgTracePeripheralReady != SET)
+  {
+    (void)sched_yield();
+  }
+  sim_stop = true;
+  (void)pthread_join(uart, NULL);
+  DbgTraceGetStats(&stats);
+
+  if (sim_output_size > OUTPUT_SIZE_MAX)
+  {
+    fprintf(stderr, "  output larger than the check buffer\n");
+    return 1;
+  }
+  failures = Output_Check(&output_lines);
+  if ((DbgTraceHead != DbgTraceTail) || (DbgTraceCommit != DbgTraceTail) || (DbgTraceWriters != 0U))
+  {
+    fprintf(stderr, "  queue not empty at the end\n");
+    failures++;
+  }
+  if ((sim_output_size + stats.DroppedBytes) != written_bytes)
+  {
+    fprintf(stderr, "  %u bytes output and %u dropped for %u written\n", (unsigned)sim_output_size,
+            (unsigned)stats.DroppedBytes, (unsigned)written_bytes);
+    failures++;
+  }
+  if ((output_lines + stats.DroppedMsg) != written_lines)
+  {
+    fprintf(stderr, "  %u lines output and %u dropped for %u written\n", (unsigned)output_lines,
+            (unsigned)stats.DroppedMsg, (unsigned)written_lines);
+    failures++;
+  }
+  if (sim_shared_copies == 0U)
+  {
+    fprintf(stderr, "  no write preempted by another one during its copy\n");
+    failures++;
+  }
+  if ((stats.MaxLevel > DBG_TRACE_MSG_QUEUE_SIZE) || (sim_tx_overlaps != 0U))
+  {
+    fprintf(stderr, "  queue level %u, %u outputs started during another one\n", (unsigned)stats.MaxLevel,
+            (unsigned)sim_tx_overlaps);
+    failures++;
+  }
+#if (DBG_TRACE_OVERFLOW_POLICY != DBG_TRACE_BLOCK)
+  if (stats.BlockedNb != 0U)
+  {
+    fprintf(stderr, "  %u writes blocked\n", (unsigned)stats.BlockedNb);
+    failures++;
+  }
+#endif
+
+  printf("  output delay %2u: %u lines written, %u output, %u dropped (%u bytes), %u blocked, max level %u,"
+         " %u copies shared\n", (unsigned)tx_delay, (unsigned)written_lines, (unsigned)output_lines,
+         (unsigned)stats.DroppedMsg, (unsigned)stats.DroppedBytes, (unsigned)stats.BlockedNb,
+         (unsigned)stats.MaxLevel, (unsigned)sim_shared_copies);
+  return failures;
+}
+
+int main(int argc, char * argv[])
+{
+  static const uint32_t tx_delays[] = { 0U, 4U, 32U };
+  long failures = 0;
+  uint32_t i;
+  int arg;
+
+  for (arg = 1; arg < argc; arg++)
+  {
+    if ((strcmp(argv[arg], "-n") == 0) && ((arg + 1) < argc))
+    {
+      sim_lines_per_writer = (uint32_t)atol(argv[++arg]);
+    }
+    else
+    {
+      Usage();
+    }
+  }
+
+  sim_output = malloc(OUTPUT_SIZE_MAX);
+  if (sim_output == NULL)
+  {
+    return 2;
+  }
+  for (i = 0U; i < (sizeof(tx_delays) / sizeof(tx_delays[0])); i++)
+  {
+    failures += Run(tx_delays[i]);
+  }
+  free(sim_output);
+
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,42 @@
+/**
+  ******************************************************************************
+  * @file    app_conf.h
+  * @author  Zigbee Application Team
+  * @brief   Host configuration of the trace: light traces through the byte
+  *          queue, small enough to overflow often. The overflow policy is
+  *          given on the command line.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef APP_CONF_H
+#define APP_CONF_H
+
+#include "stm32wbxx_hal.h"
+
+#define CFG_DEBUG_TRACE_LIGHT         1
+#define CFG_DEBUG_TRACE_FULL          0
+
+#define DBG_TRACE_USE_CIRCULAR_QUEUE  1
+#define DBG_TRACE_MSG_QUEUE_SIZE      512
+#define MAX_DBG_TRACE_MSG_SIZE        256
+
+#ifndef DBG_TRACE_OVERFLOW_POLICY
+#define DBG_TRACE_OVERFLOW_POLICY     DBG_TRACE_DROP_NEWEST
+#endif
+#define DBG_TRACE_BLOCK_TIMEOUT       10U
+
+/* The copies in the queue are done with the IRQ enabled: each one is a place
+ * where the writer can be preempted */
+#define memcpy                        Sim_Memcpy
+
+#endif /* APP_CONF_H */
@@ -0,0 +1,42 @@
+/**
+  ******************************************************************************
+  * @file    stm32wbxx_hal.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the core services used by the trace. Each
+  *          host thread is a context of the target: PRIMASK is a lock shared
+  *          by all the threads, IPSR tells the interrupt contexts.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef STM32WBxx_HAL_H
+#define STM32WBxx_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define __IO    volatile
+
+typedef enum
+{
+  RESET = 0U,
+  SET = !RESET
+} FlagStatus, ITStatus;
+
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+void __disable_irq(void);
+uint32_t __get_IPSR(void);
+uint32_t HAL_GetTick(void);
+void * Sim_Memcpy(void * dest, const void * src, size_t size);
+
+#endif /* STM32WBxx_HAL_H */
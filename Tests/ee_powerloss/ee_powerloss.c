@@ -0,0 +1,748 @@
+/**
+  ******************************************************************************
+  * @file    ee_powerloss.c
+  * @author  Zigbee Application Team
+  * @brief   Power-loss fault injection for the EEPROM emulation.
+  *          The unmodified ee.c and flash_driver.c are built on a simulated
+  *          NOR flash. The power is cut at every erase and program of a
+  *          workload of EE_Write, EE_Transfer and EE_Clean, then EE_Init()
+  *          recovers and every variable is checked.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <setjmp.h>
+#include <stdbool.h>
+#include <time.h>
+
+/* Code under test, built as is so that its private state can be reset on a reboot */
+#include "flash_driver.c"
+#include "ee.c"
+
+/* Private defines -----------------------------------------------------------*/
+#define EE_BASE                 (HW_FLASH_ADDRESS + CFG_NVM_BASE_ADDRESS)
+#define EE_FIRST_PAGE           (CFG_NVM_BASE_ADDRESS / HW_FLASH_PAGE_SIZE)
+#define SIM_NB_WORDS            (CFG_EE_BANK0_SIZE / 8U)
+#define SIM_PAGE_WORDS          (HW_FLASH_PAGE_SIZE / 8U)
+
+/* Workload: the persistent data written as App_NVM_Write does (length word and
+ * CFG_EE_BANK0_MAX_NB words), with application parameters written in between */
+#define WL_NB_VARS              (CFG_EE_BANK0_MAX_NB + 1U)
+#define WL_PARAM_ADDR           0x400U
+#define WL_NB_PARAMS            5U
+#define WL_NB_ADDR              (WL_PARAM_ADDR + WL_NB_PARAMS)
+#define WL_PARAM_PERIOD         200U
+#define WL_ROUND_OPS            (WL_NB_VARS + (WL_NB_VARS / WL_PARAM_PERIOD) + 1U)
+/* The first rounds fill the pool, the next ones change page, transfer and clean */
+#define WL_NB_PREFILL           3U
+#define WL_NB_ROUNDS            9U
+
+/* Allowed values of a variable whose writes failed */
+#define WL_NB_ALT               8U
+
+/* Typical flash timings used for the recovery time estimate on target */
+#define TARGET_ERASE_MS         22.0
+#define TARGET_PROG_MS          0.0817
+#define TARGET_ROW_MS           3.8
+
+/* Private typedef -----------------------------------------------------------*/
+typedef enum
+{
+  FAULT_CUT,              /* Power lost before the erase or program starts */
+  FAULT_TORN,             /* Power lost during it: part of the bits are programmed or erased */
+  FAULT_TORN_ZERO,        /* As FAULT_TORN, the torn word reads 0 as after the ECC error handling */
+  FAULT_BUSY,             /* The flash semaphore is not obtained: the EE call fails, no power loss */
+  FAULT_NB
+} Fault_T;
+
+typedef struct
+{
+  uint16_t addr;
+  uint32_t value;
+  uint8_t  round;
+  bool     persist;       /* Part of a persistent data write, given up on the first failure */
+} WlOp_T;
+
+typedef struct
+{
+  uint32_t value;
+  uint8_t  set;
+  uint8_t  nb_alt;
+  uint32_t alt[WL_NB_ALT];
+} Model_T;
+
+typedef struct
+{
+  long     erase;
+  long     prog;
+  long     row;
+  long     prog_err;
+  long     lease;
+  uint64_t read;
+} SimStats_T;
+
+typedef struct
+{
+  long     nb;
+  long     erase_sum;
+  long     prog_sum;
+  long     erase_max;
+  long     prog_max;
+  long     row_max;
+  uint64_t read_max;
+  double   host_us_max;
+  double   target_ms_max;
+} Recovery_T;
+
+/* Private variables ---------------------------------------------------------*/
+static const char * const fault_name[FAULT_NB] = { "cut", "torn", "torn-zero", "busy" };
+
+static uint64_t     sim_flash[SIM_NB_WORDS];
+static SimStats_T   sim;
+static uint32_t     sim_tick;
+static uint32_t     sim_rng;
+static bool         sim_busy;
+static uint32_t     sim_busy_end;
+static long         fault_budget = -1;
+static Fault_T      fault;
+static jmp_buf      fault_env;
+static int          verbose;
+
+static WlOp_T       wl[WL_NB_ROUNDS * WL_ROUND_OPS];
+static uint32_t     wl_nb;
+static Model_T      model[WL_NB_ADDR];
+static volatile uint32_t wl_current;
+
+static Recovery_T   recovery;
+
+/* Simulated hardware --------------------------------------------------------*/
+static uint32_t Sim_Random(void)
+{
+  sim_rng ^= sim_rng << 13;
+  sim_rng ^= sim_rng >> 17;
+  sim_rng ^= sim_rng << 5;
+  return sim_rng;
+}
+
+/* True when the fault shall be injected on this step */
+static bool Sim_Fault(void)
+{
+  if (fault_budget < 0)
+  {
+    return false;
+  }
+  if (fault_budget == 0)
+  {
+    fault_budget = -1;
+    return true;
+  }
+  fault_budget--;
+  return false;
+}
+
+uint32_t HAL_GetTick(void)
+{
+  /* Time goes on with the flash activity, so that the lease hold time and timeout elapse */
+  return sim_tick++;
+}
+
+void HAL_FLASH_Unlock(void)
+{
+}
+
+void HAL_FLASH_Lock(void)
+{
+}
+
+uint32_t Sim_HSEM_Lock(uint32_t id)
+{
+  if (id != CFG_HW_FLASH_SEMID)
+  {
+    return 0U;
+  }
+
+  /* Each flash ownership taken is a step of the FAULT_BUSY injection: the CPU2 then keeps
+   * the semaphore until the flash driver has given up waiting for it */
+  if ((sim_busy == false) && (fault == FAULT_BUSY) && Sim_Fault())
+  {
+    sim_busy     = true;
+    sim_busy_end = sim_tick + CFG_FD_SEM_TIMEOUT + 1U;
+  }
+  if (sim_busy)
+  {
+    if ((int32_t)(sim_tick - sim_busy_end) < 0)
+    {
+      return 1U;
+    }
+    sim_busy = false;
+  }
+
+  sim.lease++;
+  return 0U;
+}
+
+void Sim_HSEM_Release(uint32_t id)
+{
+  (void)id;
+}
+
+uint64_t * Sim_Flash_Ptr(uint32_t address)
+{
+  if ((address < EE_BASE) || (address >= (EE_BASE + CFG_EE_BANK0_SIZE)) || ((address & 7U) != 0U))
+  {
+    fprintf(stderr, "read out of the NVM at 0x%08x\n", (unsigned)address);
+    exit(2);
+  }
+  sim.read++;
+  return &sim_flash[(address - EE_BASE) / 8U];
+}
+
+/* A programmed word can only be programmed again with 0, otherwise PROGERR is raised and nothing is written */
+static void Sim_Program_Word(uint32_t index, uint64_t data)
+{
+  if ((sim_flash[index] != EE_ERASED) && (data != 0ULL))
+  {
+    sim.prog_err++;
+    if (verbose)
+    {
+      fprintf(stderr, "  PROGERR page %u offset 0x%03x: 0x%016llx over 0x%016llx\n",
+              (unsigned)(index / SIM_PAGE_WORDS), (unsigned)((index % SIM_PAGE_WORDS) * 8U),
+              (unsigned long long)data, (unsigned long long)sim_flash[index]);
+    }
+    return;
+  }
+  sim_flash[index] &= data;
+}
+
+int HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef * pEraseInit, uint32_t * PageError)
+{
+  uint32_t page = pEraseInit->Page - EE_FIRST_PAGE;
+  uint32_t index;
+
+  *PageError = 0xFFFFFFFFU;
+  if (page >= CFG_NB_OF_PAGE)
+  {
+    fprintf(stderr, "erase out of the NVM, page %u\n", (unsigned)pEraseInit->Page);
+    exit(2);
+  }
+
+  if ((fault != FAULT_BUSY) && Sim_Fault())
+  {
+    if (fault != FAULT_CUT)
+    {
+      for (index = page * SIM_PAGE_WORDS; index < ((page + 1U) * SIM_PAGE_WORDS); index++)
+      {
+        if (Sim_Random() & 1U)
+        {
+          sim_flash[index] = EE_ERASED;
+        }
+        else if (fault == FAULT_TORN_ZERO)
+        {
+          sim_flash[index] = 0ULL;
+        }
+      }
+    }
+    longjmp(fault_env, 1);
+  }
+
+  for (index = page * SIM_PAGE_WORDS; index < ((page + 1U) * SIM_PAGE_WORDS); index++)
+  {
+    sim_flash[index] = EE_ERASED;
+  }
+  sim.erase++;
+
+  return 0;
+}
+
+int HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+  /* The fast programming source address does not fit 32 bits on the host: it is always the staging buffer */
+  const uint64_t * src   = (TypeProgram == FLASH_TYPEPROGRAM_FAST) ? stage_data : &Data;
+  uint32_t         nb    = (TypeProgram == FLASH_TYPEPROGRAM_FAST) ? FD_ROW_NB_DATA : 1U;
+  uint32_t         index = (Address - EE_BASE) / 8U;
+  uint32_t         torn;
+  uint32_t         i;
+
+  if ((Address < EE_BASE) || ((index + nb) > SIM_NB_WORDS))
+  {
+    fprintf(stderr, "program out of the NVM at 0x%08x\n", (unsigned)Address);
+    exit(2);
+  }
+
+  if ((fault != FAULT_BUSY) && Sim_Fault())
+  {
+    if (fault != FAULT_CUT)
+    {
+      torn = Sim_Random() % nb;
+      for (i = 0U; i < torn; i++)
+      {
+        Sim_Program_Word(index + i, src[i]);
+      }
+      if (fault == FAULT_TORN)
+      {
+        sim_flash[index + torn] &= ~(~src[torn] & (((uint64_t)Sim_Random() << 32) | Sim_Random()));
+      }
+      else
+      {
+        sim_flash[index + torn] = 0ULL;
+      }
+    }
+    longjmp(fault_env, 1);
+  }
+
+  for (i = 0U; i < nb; i++)
+  {
+    Sim_Program_Word(index + i, src[i]);
+  }
+  if (nb == 1U)
+  {
+    sim.prog++;
+  }
+  else
+  {
+    sim.row++;
+  }
+
+  return 0;
+}
+
+/* Workload ------------------------------------------------------------------*/
+static void Wl_Build(void)
+{
+  uint32_t round;
+  uint32_t var;
+
+  wl_nb = 0U;
+  for (round = 0U; round < WL_NB_ROUNDS; round++)
+  {
+    for (var = 0U; var < WL_NB_VARS; var++)
+    {
+      wl[wl_nb].addr    = (uint16_t)var;
+      wl[wl_nb].value   = (var == 0U) ? (4U * CFG_EE_BANK0_MAX_NB) : ((round * 2654435761U) ^ (var * 40503U) ^ 0x5A5A0000U);
+      wl[wl_nb].round   = (uint8_t)round;
+      wl[wl_nb].persist = true;
+      wl_nb++;
+
+      if ((var % WL_PARAM_PERIOD) == 0U)
+      {
+        wl[wl_nb].addr    = (uint16_t)(WL_PARAM_ADDR + ((round + (var / WL_PARAM_PERIOD)) % WL_NB_PARAMS));
+        wl[wl_nb].value   = (round * 1000U) + var;
+        wl[wl_nb].round   = (uint8_t)round;
+        wl[wl_nb].persist = false;
+        wl_nb++;
+      }
+    }
+  }
+}
+
+static void Model_Commit(const WlOp_T * op)
+{
+  model[op->addr].value  = op->value;
+  model[op->addr].set    = 1U;
+  model[op->addr].nb_alt = 0U;
+}
+
+/* The write failed or was interrupted: the variable may hold the new value as well */
+static void Model_Uncertain(const WlOp_T * op)
+{
+  Model_T * m = &model[op->addr];
+
+  if (m->nb_alt < WL_NB_ALT)
+  {
+    m->alt[m->nb_alt++] = op->value;
+  }
+}
+
+/* Run the operations [from, to[ as the application does, returns false on a write error */
+static bool Wl_Run(uint32_t from, uint32_t to)
+{
+  uint32_t index;
+  int      status;
+  bool     ok = true;
+
+  for (index = from; index < to; index++)
+  {
+    wl_current = index;
+    status = EE_Write(0, wl[index].addr, wl[index].value);
+
+    if (status == EE_CLEAN_NEEDED)
+    {
+      /* The value is written, the old pool is erased now */
+      Model_Commit(&wl[index]);
+      status = EE_Clean(0, 0);
+      if (status != EE_OK)
+      {
+        if (verbose)
+        {
+          fprintf(stderr, "  op %u: EE_Clean status %d\n", (unsigned)index, status);
+        }
+        ok = false;
+      }
+    }
+    else if (status == EE_OK)
+    {
+      Model_Commit(&wl[index]);
+    }
+    else
+    {
+      /* App_NVM_Write gives up the persistent data write on the first error */
+      if (verbose)
+      {
+        fprintf(stderr, "  op %u: EE_Write status %d\n", (unsigned)index, status);
+      }
+      ok = false;
+      Model_Uncertain(&wl[index]);
+      if (wl[index].persist)
+      {
+        while (((index + 1U) < to) && wl[index + 1U].persist && (wl[index + 1U].round == wl[index].round))
+        {
+          index++;
+        }
+      }
+    }
+  }
+
+  return ok;
+}
+
+static bool Model_Allows(uint16_t addr, int status, uint32_t value)
+{
+  const Model_T * m = &model[addr];
+  uint8_t         i;
+
+  if (status == EE_OK)
+  {
+    if (m->set && (value == m->value))
+    {
+      return true;
+    }
+    for (i = 0U; i < m->nb_alt; i++)
+    {
+      if (value == m->alt[i])
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  return (status == EE_NOT_FOUND) && (m->set == 0U);
+}
+
+static long Check(const char * what, long step)
+{
+  uint32_t addr;
+  uint32_t value = 0U;
+  int      status;
+  long     bad = 0;
+
+  for (addr = 0U; addr < WL_NB_ADDR; addr++)
+  {
+    if (addr == WL_NB_VARS)
+    {
+      addr = WL_PARAM_ADDR;
+    }
+    status = EE_Read(0, (uint16_t)addr, &value);
+    if (Model_Allows((uint16_t)addr, status, value) == false)
+    {
+      if (bad++ < 3)
+      {
+        fprintf(stderr, "  %s, step %ld: address 0x%03x status %d value 0x%08x, expected 0x%08x\n",
+                what, step, (unsigned)addr, status, (unsigned)value, (unsigned)model[addr].value);
+      }
+    }
+  }
+
+  return bad;
+}
+
+/* Reset of the flash driver state */
+static void Driver_Reset(void)
+{
+  stage_nb      = 0U;
+  stage_address = 0U;
+  lease_held    = FALSE;
+  sim_busy      = false;
+}
+
+/* Reset of the RAM as after a power on, the flash is kept */
+static void Reboot(void)
+{
+  Driver_Reset();
+  memset(EE_var, 0xA5, sizeof(EE_var));
+}
+
+static int Recover(bool measure)
+{
+  SimStats_T      before = sim;
+  struct timespec start;
+  struct timespec end;
+  double          host_us;
+  double          target_ms;
+  int             status;
+
+  Reboot();
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  status = EE_Init(0, EE_BASE);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  if (measure)
+  {
+    host_us   = ((end.tv_sec - start.tv_sec) * 1e6) + ((end.tv_nsec - start.tv_nsec) / 1e3);
+    target_ms = ((sim.erase - before.erase) * TARGET_ERASE_MS) + ((sim.prog - before.prog) * TARGET_PROG_MS)
+                + ((sim.row - before.row) * TARGET_ROW_MS);
+
+    recovery.nb++;
+    recovery.erase_sum += sim.erase - before.erase;
+    recovery.prog_sum  += sim.prog - before.prog;
+    if ((sim.erase - before.erase) > recovery.erase_max)  recovery.erase_max = sim.erase - before.erase;
+    if ((sim.prog - before.prog) > recovery.prog_max)     recovery.prog_max  = sim.prog - before.prog;
+    if ((sim.row - before.row) > recovery.row_max)        recovery.row_max   = sim.row - before.row;
+    if ((sim.read - before.read) > recovery.read_max)     recovery.read_max  = sim.read - before.read;
+    if (host_us > recovery.host_us_max)                   recovery.host_us_max = host_us;
+    if (target_ms > recovery.target_ms_max)               recovery.target_ms_max = target_ms;
+  }
+
+  return status;
+}
+
+/* Main ----------------------------------------------------------------------*/
+static void Usage(void)
+{
+  fprintf(stderr,
+          "usage: ee_powerloss [-s stride] [-d stride] [-m fault] [-k step] [-v]\n"
+          "  -s N  inject the fault at every Nth step only (default 1, every step)\n"
+          "  -d N  every Nth fault, also cut the power at every step of the recovery\n"
+          "  -m F  only this fault: cut, torn, torn-zero or busy (default all)\n"
+          "  -k K  only inject the fault at step K\n"
+          "  -v    report every program error\n");
+  exit(2);
+}
+
+int main(int argc, char * argv[])
+{
+  static uint64_t flash_init[SIM_NB_WORDS];
+  static uint64_t flash_fault[SIM_NB_WORDS];
+  static Model_T  model_init[WL_NB_ADDR];
+  static Model_T  model_fault[WL_NB_ADDR];
+  EE_var_t        var_init[sizeof(EE_var) / sizeof(EE_var[0])];
+  long            stride = 1;
+  long            double_stride = 0;
+  long            only_step = -1;
+  int             only_fault = -1;
+  long            steps[FAULT_NB];
+  uint32_t        prefill_end;
+  uint32_t        pending;
+  SimStats_T      before;
+  int             arg;
+  /* Kept across the longjmp() of a power loss */
+  volatile long   faults = 0;
+  volatile long   failures = 0;
+  volatile long   mode_failures;
+  volatile long   mode_faults;
+  volatile long   double_nb = 0;
+  volatile long   step;
+  volatile long   rec_step;
+  volatile long   rec_steps;
+  volatile int    f;
+
+  for (arg = 1; arg < argc; arg++)
+  {
+    if ((strcmp(argv[arg], "-v") == 0))
+    {
+      verbose = 1;
+    }
+    else if ((arg + 1) >= argc)
+    {
+      Usage();
+    }
+    else if (strcmp(argv[arg], "-s") == 0)
+    {
+      stride = atol(argv[++arg]);
+    }
+    else if (strcmp(argv[arg], "-d") == 0)
+    {
+      double_stride = atol(argv[++arg]);
+    }
+    else if (strcmp(argv[arg], "-k") == 0)
+    {
+      only_step = atol(argv[++arg]);
+    }
+    else if (strcmp(argv[arg], "-m") == 0)
+    {
+      arg++;
+      for (f = 0; (f < FAULT_NB) && (strcmp(argv[arg], fault_name[f]) != 0); f++);
+      if (f == FAULT_NB)
+      {
+        Usage();
+      }
+      only_fault = f;
+    }
+    else
+    {
+      Usage();
+    }
+  }
+  if (stride < 1)
+  {
+    Usage();
+  }
+
+  /* Factory state, then the prefill rounds */
+  Wl_Build();
+  prefill_end = WL_NB_PREFILL * (wl_nb / WL_NB_ROUNDS);
+  memset(sim_flash, 0xFF, sizeof(sim_flash));
+  if ((EE_Init(1, EE_BASE) != EE_OK) || (Wl_Run(0U, prefill_end) == false) || (Check("prefill", 0) != 0))
+  {
+    fprintf(stderr, "prefill failed\n");
+    return 1;
+  }
+  memcpy(flash_init, sim_flash, sizeof(sim_flash));
+  memcpy(var_init, EE_var, sizeof(EE_var));
+  memcpy(model_init, model, sizeof(model));
+
+  /* Reference run without fault: number of flash steps and of flash ownerships */
+  before = sim;
+  if ((Wl_Run(prefill_end, wl_nb) == false) || (Check("reference", 0) != 0) || (sim.prog_err != 0))
+  {
+    fprintf(stderr, "reference run failed\n");
+    return 1;
+  }
+  steps[FAULT_CUT] = (sim.erase - before.erase) + (sim.prog - before.prog) + (sim.row - before.row);
+  steps[FAULT_TORN] = steps[FAULT_CUT];
+  steps[FAULT_TORN_ZERO] = steps[FAULT_CUT];
+  steps[FAULT_BUSY] = sim.lease - before.lease;
+
+  printf("config: CFG_FD_FAST_PROGRAM %u, CFG_EE_AUTO_CLEAN %u, %u writes, %ld erases, %ld programs, %ld rows, %ld flash ownerships\n",
+         (unsigned)CFG_FD_FAST_PROGRAM, (unsigned)CFG_EE_AUTO_CLEAN, (unsigned)(wl_nb - prefill_end),
+         sim.erase - before.erase, sim.prog - before.prog, sim.row - before.row, steps[FAULT_BUSY]);
+
+  for (f = 0; f < FAULT_NB; f++)
+  {
+    if ((only_fault >= 0) && (f != only_fault))
+    {
+      continue;
+    }
+    fault = (Fault_T)f;
+    mode_failures = 0;
+    mode_faults   = 0;
+    memset(&recovery, 0, sizeof(recovery));
+
+    for (step = ((only_step >= 0) ? only_step : 0); step < ((only_step >= 0) ? (only_step + 1) : steps[f]); step += stride)
+    {
+      memcpy(sim_flash, flash_init, sizeof(sim_flash));
+      memcpy(EE_var, var_init, sizeof(EE_var));
+      memcpy(model, model_init, sizeof(model));
+      Driver_Reset();
+      sim.prog_err = 0;
+      sim_rng      = ((uint32_t)step * 7919U) + 1U + (uint32_t)f;
+      fault_budget = step;
+      faults++;
+      mode_faults++;
+
+      if (setjmp(fault_env) == 0)
+      {
+        /* FAULT_BUSY: the application keeps running after the failure, then the power is cut */
+        Wl_Run(prefill_end, wl_nb);
+        if (fault_budget >= 0)
+        {
+          fprintf(stderr, "  %s, step %ld: no fault injected\n", fault_name[f], step);
+          mode_failures++;
+          continue;
+        }
+        pending = wl_nb;
+      }
+      else
+      {
+        pending = wl_current;
+        Model_Uncertain(&wl[pending]);
+      }
+      fault_budget = -1;
+
+      if ((double_stride > 0) && ((faults % double_stride) == 0) && (fault != FAULT_BUSY))
+      {
+        /* Cut the power at every step of the recovery itself, then recover again */
+        memcpy(flash_fault, sim_flash, sizeof(sim_flash));
+        memcpy(model_fault, model, sizeof(model));
+        before = sim;
+        (void)Recover(false);
+        rec_steps = (sim.erase - before.erase) + (sim.prog - before.prog) + (sim.row - before.row);
+        for (rec_step = 0; rec_step < rec_steps; rec_step++)
+        {
+          memcpy(sim_flash, flash_fault, sizeof(sim_flash));
+          memcpy(model, model_fault, sizeof(model));
+          fault_budget = rec_step;
+          if (setjmp(fault_env) == 0)
+          {
+            (void)Recover(false);
+            fault_budget = -1;
+            continue;
+          }
+          fault_budget = -1;
+          double_nb++;
+          if ((Recover(false) != EE_OK) || (Check("double fault", step) != 0))
+          {
+            fprintf(stderr, "  %s, step %ld: recovery cut at its step %ld failed\n", fault_name[f], step, rec_step);
+            mode_failures++;
+          }
+        }
+        memcpy(sim_flash, flash_fault, sizeof(sim_flash));
+        memcpy(model, model_fault, sizeof(model));
+      }
+
+      if (Recover(true) != EE_OK)
+      {
+        fprintf(stderr, "  %s, step %ld: EE_Init failed\n", fault_name[f], step);
+        mode_failures++;
+        continue;
+      }
+      if (Check("recovered", step) != 0)
+      {
+        mode_failures++;
+        continue;
+      }
+
+      /* The application writes again what was interrupted, then goes on */
+      if (pending < wl_nb)
+      {
+        if ((Wl_Run(pending, wl_nb) == false) || (Check("continued", step) != 0))
+        {
+          mode_failures++;
+          continue;
+        }
+      }
+      if (sim.prog_err != 0)
+      {
+        fprintf(stderr, "  %s, step %ld: %ld program errors\n", fault_name[f], step, sim.prog_err);
+        mode_failures++;
+      }
+    }
+
+    failures += mode_failures;
+    printf("  %-9s: %ld steps, %ld faults injected, %ld failures | recovery max %ld erases %ld programs %ld rows "
+           "%llu reads, %.0f us host, %.1f ms target; mean %.2f erases %.1f programs\n",
+           fault_name[f], steps[f], mode_faults, mode_failures,
+           recovery.erase_max, recovery.prog_max, recovery.row_max, (unsigned long long)recovery.read_max,
+           recovery.host_us_max, recovery.target_ms_max,
+           (recovery.nb != 0) ? ((double)recovery.erase_sum / recovery.nb) : 0.0,
+           (recovery.nb != 0) ? ((double)recovery.prog_sum / recovery.nb) : 0.0);
+  }
+
+  if (double_nb != 0)
+  {
+    printf("  recovery cut at every step: %ld faults injected\n", double_nb);
+  }
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,42 @@
+/**
+  ******************************************************************************
+  * @file    ee_cfg.h
+  * @author  Zigbee Application Team
+  * @brief   Host configuration of the EEPROM emulation power-loss test,
+  *          same NVM layout as app_nvm.h
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef EE_CFG_H__
+#define EE_CFG_H__
+
+#include "app_common.h"
+#include "flash_driver.h"
+
+#define HW_FLASH_ADDRESS                0x08000000UL
+#define HW_FLASH_PAGE_SIZE              4096U
+#define HW_FLASH_WIDTH                  8
+
+#define CFG_NB_OF_PAGE                  16U
+#define CFG_EE_BANK0_SIZE               (CFG_NB_OF_PAGE * HW_FLASH_PAGE_SIZE)
+#define CFG_NVM_BASE_ADDRESS            0x70000U
+#define CFG_EE_BANK0_MAX_NB             1000U
+#ifndef CFG_EE_AUTO_CLEAN
+#define CFG_EE_AUTO_CLEAN               1U
+#endif
+
+/* Every flash read of ee.c goes through the simulated flash */
+uint64_t * Sim_Flash_Ptr(uint32_t address);
+#define EE_PTR( x )                     Sim_Flash_Ptr( x )
+
+#endif /* EE_CFG_H__ */
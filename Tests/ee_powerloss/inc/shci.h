@@ -0,0 +1,27 @@
+/**
+  ******************************************************************************
+  * @file    shci.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the system commands used by the flash driver
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef SHCI_H
+#define SHCI_H
+
+#define ERASE_ACTIVITY_OFF                      0U
+#define ERASE_ACTIVITY_ON                       1U
+
+#define SHCI_C2_FLASH_EraseActivity(activity)
+
+#endif /* SHCI_H */
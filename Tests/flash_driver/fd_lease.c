@@ -0,0 +1,462 @@
+/**
+  ******************************************************************************
+  * @file    fd_lease.c
+  * @author  Zigbee Application Team
+  * @brief   Test of the flash semaphore lease of the flash driver.
+  *          The unmodified flash_driver.c erases and writes a simulated flash
+  *          while a simulated CPU2 takes the hardware semaphores: the flash
+  *          one for 2 ms every 40 ms, then for longer than
+  *          CFG_FD_SEM_TIMEOUT, then the block one. No flash operation shall
+  *          run without the semaphores, the driver shall give the flash back
+  *          within its hold budget, and on every return the semaphore shall
+  *          be released, the flash locked and the erase activity closed, with
+  *          exactly the reported number of sectors or data left undone.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+
+/* Code under test, built as is */
+#include "flash_driver.c"
+
+/* Private defines -----------------------------------------------------------*/
+#define SIM_FLASH_BASE          0x08000000U
+#define SIM_PAGE_SIZE           4096U
+#define SIM_NB_PAGES            32U
+#define SIM_PAGE_WORDS          (SIM_PAGE_SIZE / 8U)
+#define SIM_NB_WORDS            (SIM_NB_PAGES * SIM_PAGE_WORDS)
+#define SIM_ERASED              UINT64_MAX
+
+#define MAX(a, b)               (((a) > (b)) ? (a) : (b))
+
+/* Durations in us */
+#define SIM_STEP_US             10U     /* Simulation step */
+#define SIM_GET_TICK_US         10U     /* One HAL_GetTick() poll */
+#define SIM_ERASE_US            22000U  /* Page erase */
+#define SIM_PROGRAM_US          90U     /* 64bits program */
+
+/* CPU2 radio activity: the flash semaphore every period */
+#define CPU2_PERIOD_US          40000U
+#define CPU2_HOLD_US            2000U
+#define CPU2_POLL_US            100U    /* The CPU2 misses a semaphore released for less */
+
+/* The driver gives the flash back between two operations once held for CFG_FD_LEASE_MAX_HOLD: the CPU2 shall
+ * get it after the budget plus the longest operation, plus one tick for the measure */
+#define LEASE_BOUNDED           (CFG_FD_LEASE_MAX_HOLD < 1000U)
+#define CPU2_WAIT_MAX_US        ((CFG_FD_LEASE_MAX_HOLD * 1000U) + SIM_ERASE_US + 1000U)
+
+/* Private typedef -----------------------------------------------------------*/
+typedef enum
+{
+  OWNER_NONE,
+  OWNER_CPU1,
+  OWNER_CPU2,
+} Owner_t;
+
+typedef enum
+{
+  SCENARIO_RADIO,         /* CPU2 takes the flash semaphore 2 ms every 40 ms */
+  SCENARIO_HOG,           /* Same, and sometimes longer than CFG_FD_SEM_TIMEOUT */
+  SCENARIO_BLOCK,         /* Same, and the CPU2 sometimes blocks the flash operations */
+  SCENARIO_NB,
+} Scenario_t;
+
+typedef struct
+{
+  bool      wants;
+  bool      held;
+  uint64_t  wait_start;
+  uint64_t  held_until;
+  uint64_t  next;
+  uint64_t  hold_us;
+  uint64_t  poll;
+} Cpu2_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const char * const scenario_name[SCENARIO_NB] = { "radio", "hog", "block" };
+
+static uint64_t   sim_flash[SIM_NB_WORDS];
+static uint64_t   model_flash[SIM_NB_WORDS];
+static uint32_t   model_next[SIM_NB_PAGES];   /* First erased data of each page */
+static uint64_t   sim_us;
+static uint32_t   sim_rng = 0x1B873593U;
+static Owner_t    sem_owner[8];
+static bool       flash_unlocked;
+static bool       erase_activity;
+static Scenario_t scenario;
+static Cpu2_t     cpu2_flash;
+static Cpu2_t     cpu2_block;
+static uint64_t   cpu2_wait_max;
+static uint64_t   cpu2_wait_total;
+static uint32_t   cpu2_wait_nb;
+static uint32_t   cpu1_leases;
+static uint32_t   cpu1_undone;
+static long       failures;
+static long       op;
+
+/* Private functions ---------------------------------------------------------*/
+#define CHECK(cond, ...) \
+  do \
+  { \
+    if (!(cond)) \
+    { \
+      if (failures < 20) \
+      { \
+        printf("FAIL %s op %ld: ", scenario_name[scenario], op); \
+        printf(__VA_ARGS__); \
+        printf("\n"); \
+      } \
+      failures++; \
+    } \
+  } while (0)
+
+static uint32_t Sim_Random(void)
+{
+  sim_rng ^= sim_rng << 13;
+  sim_rng ^= sim_rng >> 17;
+  sim_rng ^= sim_rng << 5;
+  return sim_rng;
+}
+
+/* One CPU2 client of a semaphore: asks for it, polls it until free, holds it */
+static void Cpu2_Step(Cpu2_t * p_cpu2, uint32_t id, uint64_t period, uint64_t hold_us, bool flash)
+{
+  if (!p_cpu2->wants && !p_cpu2->held && (sim_us >= p_cpu2->next))
+  {
+    p_cpu2->wants = true;
+    p_cpu2->wait_start = sim_us;
+    p_cpu2->hold_us = hold_us;
+  }
+
+  if (p_cpu2->wants && (sim_us >= p_cpu2->poll) && (sem_owner[id] == OWNER_NONE))
+  {
+    sem_owner[id] = OWNER_CPU2;
+    p_cpu2->wants = false;
+    p_cpu2->held = true;
+    p_cpu2->held_until = sim_us + p_cpu2->hold_us;
+
+    if (flash)
+    {
+      uint64_t wait = sim_us - p_cpu2->wait_start;
+
+      cpu2_wait_total += wait;
+      cpu2_wait_nb++;
+      if (wait > cpu2_wait_max)
+      {
+        cpu2_wait_max = wait;
+      }
+    }
+  }
+  else if (p_cpu2->held && (sim_us >= p_cpu2->held_until))
+  {
+    sem_owner[id] = OWNER_NONE;
+    p_cpu2->held = false;
+    /* Some jitter so that the CPU2 is not in step with the driver */
+    p_cpu2->next = sim_us + period - (period / 4U) + (Sim_Random() % (period / 2U));
+  }
+
+  if (sim_us >= p_cpu2->poll)
+  {
+    p_cpu2->poll = sim_us + CPU2_POLL_US;
+  }
+}
+
+static void Sim_Advance(uint32_t us)
+{
+  uint64_t hog;
+
+  while (us != 0U)
+  {
+    uint32_t step = (us < SIM_STEP_US) ? us : SIM_STEP_US;
+
+    sim_us += step;
+    us -= step;
+
+    /* A hog lasts longer than the driver acquisition timeout, one in twenty */
+    hog = CPU2_HOLD_US;
+    if ((scenario == SCENARIO_HOG) && ((Sim_Random() % 20U) == 0U))
+    {
+      hog = (CFG_FD_SEM_TIMEOUT * 1000U) + 500000U;
+    }
+    Cpu2_Step(&cpu2_flash, CFG_HW_FLASH_SEMID, CPU2_PERIOD_US, hog, true);
+
+    if (scenario == SCENARIO_BLOCK)
+    {
+      Cpu2_Step(&cpu2_block, CFG_HW_BLOCK_FLASH_REQ_BY_CPU2_SEMID, 3U * CPU2_PERIOD_US,
+                1000U + (Sim_Random() % 4000U), false);
+    }
+  }
+}
+
+uint32_t HAL_GetTick(void)
+{
+  Sim_Advance(SIM_GET_TICK_US);
+  return (uint32_t)(sim_us / 1000U);
+}
+
+void HAL_FLASH_Unlock(void)
+{
+  CHECK(sem_owner[CFG_HW_FLASH_SEMID] == OWNER_CPU1, "flash unlocked without the semaphore");
+  flash_unlocked = true;
+}
+
+void HAL_FLASH_Lock(void)
+{
+  flash_unlocked = false;
+}
+
+uint32_t Sim_HSEM_Lock(uint32_t id)
+{
+  CHECK(sem_owner[id] != OWNER_CPU1, "semaphore %u taken twice", id);
+
+  if (sem_owner[id] == OWNER_CPU2)
+  {
+    return 1U;
+  }
+
+  sem_owner[id] = OWNER_CPU1;
+  if (id == CFG_HW_FLASH_SEMID)
+  {
+    cpu1_leases++;
+  }
+  return 0U;
+}
+
+uint32_t Sim_HSEM_Status(uint32_t id)
+{
+  return (sem_owner[id] == OWNER_NONE) ? 0U : 1U;
+}
+
+void Sim_HSEM_Release(uint32_t id)
+{
+  CHECK(sem_owner[id] == OWNER_CPU1, "semaphore %u released while not held", id);
+  CHECK((id != CFG_HW_FLASH_SEMID) || !flash_unlocked, "semaphore released with the flash unlocked");
+  sem_owner[id] = OWNER_NONE;
+}
+
+void Sim_EraseActivity(unsigned int activity)
+{
+  CHECK(erase_activity != (activity == ERASE_ACTIVITY_ON), "erase activity %u twice", activity);
+  erase_activity = (activity == ERASE_ACTIVITY_ON);
+}
+
+/* A flash operation needs the flash semaphore, the flash unlocked and the CPU2 not blocking */
+static void Sim_CheckOperation(const char * what)
+{
+  CHECK(sem_owner[CFG_HW_FLASH_SEMID] == OWNER_CPU1, "%s without the flash semaphore", what);
+  CHECK(sem_owner[CFG_HW_BLOCK_FLASH_REQ_BY_CPU2_SEMID] == OWNER_CPU1, "%s without the block semaphore", what);
+  CHECK(flash_unlocked, "%s with the flash locked", what);
+}
+
+int HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef * pEraseInit, uint32_t * PageError)
+{
+  uint32_t i;
+
+  Sim_CheckOperation("erase");
+  CHECK(erase_activity, "erase without the erase activity");
+  CHECK(pEraseInit->Page < SIM_NB_PAGES, "erase of page %u", pEraseInit->Page);
+
+  for (i = 0U; i < SIM_PAGE_WORDS; i++)
+  {
+    sim_flash[(pEraseInit->Page * SIM_PAGE_WORDS) + i] = SIM_ERASED;
+  }
+  *PageError = UINT32_MAX;
+
+  /* The CPU2 may poll but not get the semaphore meanwhile */
+  Sim_Advance(SIM_ERASE_US);
+
+  return 0;
+}
+
+int HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+  uint32_t index = (Address - SIM_FLASH_BASE) / 8U;
+
+  Sim_CheckOperation("program");
+  CHECK(TypeProgram == FLASH_TYPEPROGRAM_DOUBLEWORD, "program type %u", TypeProgram);
+  CHECK((index < SIM_NB_WORDS) && (sim_flash[index] == SIM_ERASED), "program of 0x%08X not erased", Address);
+
+  if (index < SIM_NB_WORDS)
+  {
+    sim_flash[index] = Data;
+  }
+  Sim_Advance(SIM_PROGRAM_US);
+
+  return 0;
+}
+
+/* Whatever the result, the driver shall leave the flash as it found it */
+static void Check_Return(void)
+{
+  CHECK(sem_owner[CFG_HW_FLASH_SEMID] != OWNER_CPU1, "flash semaphore kept");
+  CHECK(sem_owner[CFG_HW_BLOCK_FLASH_REQ_BY_CPU2_SEMID] != OWNER_CPU1, "block semaphore kept");
+  CHECK(!flash_unlocked, "flash left unlocked");
+  CHECK(!erase_activity, "erase activity left on");
+  CHECK(memcmp(sim_flash, model_flash, sizeof(sim_flash)) == 0, "flash content differs from the result");
+}
+
+static void Op_Erase(void)
+{
+  uint32_t first = Sim_Random() % SIM_NB_PAGES;
+  uint32_t nb = 1U + (Sim_Random() % 4U);
+  uint32_t left;
+  uint32_t i;
+
+  if ((first + nb) > SIM_NB_PAGES)
+  {
+    nb = SIM_NB_PAGES - first;
+  }
+
+  left = FD_EraseSectors(first, nb);
+
+  CHECK(left <= nb, "%u sectors left of %u", left, nb);
+  for (i = 0U; i < (nb - left); i++)
+  {
+    memset(&model_flash[(first + i) * SIM_PAGE_WORDS], 0xFF, SIM_PAGE_SIZE);
+    model_next[first + i] = 0U;
+  }
+  cpu1_undone += left;
+
+  Check_Return();
+}
+
+static void Op_Write(void)
+{
+  static uint64_t data[SIM_PAGE_WORDS];
+  uint32_t page = Sim_Random() % SIM_NB_PAGES;
+  uint32_t free_nb = SIM_PAGE_WORDS - model_next[page];
+  uint32_t nb;
+  uint32_t left;
+  uint32_t i;
+
+  if (free_nb == 0U)
+  {
+    return;
+  }
+
+  nb = 1U + (Sim_Random() % free_nb);
+  for (i = 0U; i < nb; i++)
+  {
+    data[i] = ((uint64_t)Sim_Random() << 32) | Sim_Random();
+  }
+
+  left = FD_WriteData(SIM_FLASH_BASE + (page * SIM_PAGE_SIZE) + (model_next[page] * 8U), data, nb);
+
+  CHECK(left <= nb, "%u data left of %u", left, nb);
+  memcpy(&model_flash[(page * SIM_PAGE_WORDS) + model_next[page]], data, (nb - left) * 8U);
+  model_next[page] += nb - left;
+  cpu1_undone += left;
+
+  Check_Return();
+}
+
+static void Run(Scenario_t run, long nb_ops)
+{
+  FD_LeaseStats_t stats;
+  uint32_t leases;
+
+  scenario = run;
+  memset(&cpu2_flash, 0, sizeof(cpu2_flash));
+  memset(&cpu2_block, 0, sizeof(cpu2_block));
+  memset(sem_owner, 0, sizeof(sem_owner));
+  cpu2_wait_max = 0U;
+  cpu2_wait_total = 0U;
+  cpu2_wait_nb = 0U;
+  cpu1_undone = 0U;
+  FD_ResetLeaseStats();
+  leases = cpu1_leases;
+
+  for (op = 0; op < nb_ops; op++)
+  {
+    if ((Sim_Random() % 4U) == 0U)
+    {
+      Op_Erase();
+    }
+    else
+    {
+      Op_Write();
+    }
+    /* Application running between two flash requests */
+    Sim_Advance(Sim_Random() % 20000U);
+  }
+
+  FD_GetLeaseStats(&stats);
+
+  CHECK(stats.LeaseNb == (cpu1_leases - leases), "%u leases counted, %u taken", stats.LeaseNb,
+        cpu1_leases - leases);
+  CHECK(stats.SpinTimeMax <= (CFG_FD_SEM_TIMEOUT + 1U), "spin of %u ms", stats.SpinTimeMax);
+  CHECK(stats.TimeoutNb <= stats.ContentionNb, "%u timeouts, %u contentions", stats.TimeoutNb, stats.ContentionNb);
+#if (LEASE_BOUNDED != 0)
+  CHECK(cpu2_wait_max <= CPU2_WAIT_MAX_US, "CPU2 waited %llu us", (unsigned long long)cpu2_wait_max);
+  CHECK(stats.HoldTimeMax <= (CPU2_WAIT_MAX_US / 1000U), "lease held %u ms", stats.HoldTimeMax);
+  CHECK(stats.YieldNb != 0U, "no yield");
+#endif
+  if (scenario == SCENARIO_RADIO)
+  {
+    CHECK((stats.TimeoutNb == 0U) && (cpu1_undone == 0U), "%u timeouts, %u left undone", stats.TimeoutNb,
+          cpu1_undone);
+  }
+  else
+  {
+    CHECK(cpu1_undone != 0U, "the CPU2 never made an operation fail");
+  }
+  if (scenario == SCENARIO_HOG)
+  {
+    CHECK(stats.TimeoutNb != 0U, "no timeout");
+  }
+
+  printf("  %-5s: CPU2 wait max %5.1f ms avg %4.1f ms, %u leases, %u contentions, %u timeouts, %u yields, "
+         "hold max %u ms, spin max %u ms, %u left undone\n",
+         scenario_name[scenario], cpu2_wait_max / 1000.0, (cpu2_wait_total / 1000.0) / MAX(cpu2_wait_nb, 1U),
+         stats.LeaseNb, stats.ContentionNb, stats.TimeoutNb, stats.YieldNb, stats.HoldTimeMax,
+         stats.SpinTimeMax, cpu1_undone);
+}
+
+static void Usage(void)
+{
+  printf("usage: fd_lease [-n operations]\n");
+  exit(2);
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char * argv[])
+{
+  long nb_ops = 2000;
+  int arg;
+  int run;
+
+  for (arg = 1; arg < argc; arg++)
+  {
+    if ((strcmp(argv[arg], "-n") == 0) && ((arg + 1) < argc))
+    {
+      nb_ops = atol(argv[++arg]);
+    }
+    else
+    {
+      Usage();
+    }
+  }
+
+  memset(sim_flash, 0xFF, sizeof(sim_flash));
+  memset(model_flash, 0xFF, sizeof(model_flash));
+
+  printf("lease hold budget %u ms, acquisition timeout %u ms\n", CFG_FD_LEASE_MAX_HOLD, CFG_FD_SEM_TIMEOUT);
+  for (run = 0; run < SCENARIO_NB; run++)
+  {
+    Run((Scenario_t)run, nb_ops);
+  }
+
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
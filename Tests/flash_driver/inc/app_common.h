@@ -0,0 +1,78 @@
+/**
+  ******************************************************************************
+  * @file    app_common.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the application common header for the
+  *          flash driver lease test
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef APP_COMMON_H
+#define APP_COMMON_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRUE                                    1
+#define FALSE                                   0
+#define __WEAK                                  __attribute__((weak))
+
+/* Flash driver configuration, same defaults as app_conf.h */
+#ifndef CFG_FD_SEM_TIMEOUT
+#define CFG_FD_SEM_TIMEOUT                      1000U
+#endif
+#ifndef CFG_FD_LEASE_MAX_HOLD
+#define CFG_FD_LEASE_MAX_HOLD                   5U
+#endif
+#ifndef CFG_FD_FAST_PROGRAM
+#define CFG_FD_FAST_PROGRAM                     0U
+#endif
+
+#define CFG_HW_FLASH_SEMID                      2U
+#define CFG_HW_BLOCK_FLASH_REQ_BY_CPU2_SEMID    6U
+#define CFG_HW_BLOCK_FLASH_REQ_BY_CPU1_SEMID    7U
+
+/* Simulated hardware semaphores, see fd_lease.c */
+#define HSEM                                    0
+#define LL_HSEM_1StepLock(hsem, id)             Sim_HSEM_Lock(id)
+#define LL_HSEM_GetStatus(hsem, id)             Sim_HSEM_Status(id)
+#define LL_HSEM_ReleaseLock(hsem, id, core)     Sim_HSEM_Release(id)
+
+/* Simulated flash controller, see fd_lease.c */
+#define LL_FLASH_IsActiveFlag_OperationSuspended()   0U
+#define __HAL_FLASH_GET_FLAG(flag)              0U
+#define FLASH_FLAG_CFGBSY                       0U
+#define FLASH_TYPEERASE_PAGES                   0U
+#define FLASH_TYPEPROGRAM_DOUBLEWORD            1U
+#define FLASH_TYPEPROGRAM_FAST                  2U
+
+typedef struct
+{
+  uint32_t TypeErase;
+  uint32_t Page;
+  uint32_t NbPages;
+} FLASH_EraseInitTypeDef;
+
+uint32_t Sim_HSEM_Lock(uint32_t id);
+uint32_t Sim_HSEM_Status(uint32_t id);
+void     Sim_HSEM_Release(uint32_t id);
+
+uint32_t HAL_GetTick(void);
+void     HAL_FLASH_Unlock(void);
+void     HAL_FLASH_Lock(void);
+int      HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef * pEraseInit, uint32_t * PageError);
+int      HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+
+#endif /* APP_COMMON_H */
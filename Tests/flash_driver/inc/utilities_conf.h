@@ -0,0 +1,25 @@
+/**
+  ******************************************************************************
+  * @file    utilities_conf.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the utilities configuration, single thread
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef UTILITIES_CONF_H
+#define UTILITIES_CONF_H
+
+#define UTILS_ENTER_CRITICAL_SECTION()
+#define UTILS_EXIT_CRITICAL_SECTION()
+
+#endif /* UTILITIES_CONF_H */
@@ -0,0 +1,496 @@
+/**
+  ******************************************************************************
+  * @file    attr_cache.c
+  * @author  Zigbee Application Team
+  * @brief   Host test of the Shutter Remote attribute cache.
+  *          The unmodified app_roller_shutter_remote_attr_cache.c runs on a
+  *          simulated RTC calendar configured as on the remote (no 1Hz
+  *          calendar, 16 s per calendar second) while the HAL tick only runs
+  *          when the remote is awake, as in Stop mode. The cache time is
+  *          checked against the simulated time over the week day wrap around,
+  *          the staleness across long Stop periods, and the refresh requests
+  *          sent on user actions to servers reporting, silent, with a failed
+  *          report configuration or offline.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+/* The stub configuration comes first: the include guards it shares with the
+ * application headers keep them out */
+#include "app_conf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int Sim_Printf(const char *format, ...);
+#define printf Sim_Printf
+
+/* Code under test, built as is to reach the cache entries */
+#include "app_roller_shutter_remote_attr_cache.c"
+
+#undef printf
+
+/* Private defines -----------------------------------------------------------*/
+#define APRE_FREQ               2048ULL   /* RTC ck_apre, LSE / 16 */
+#define APRE_PER_SPRE           32768ULL  /* CFG_RTC_SYNCH_PRESCALER + 1 */
+#define MINUTE                  60U
+#define HOUR                    (60U * MINUTE)
+#define DAY                     (24U * HOUR)
+
+#define SERVER_NB               4U
+#define SERVER_REPORTING        0U        /* Reports at the max report interval */
+#define SERVER_SILENT           1U        /* Only answers the reads */
+#define SERVER_CFG_FAILED       2U        /* Report configuration keeps failing */
+#define SERVER_OFFLINE          3U        /* Never answers */
+#define REPORT_PERIOD           ROLLER_SHUTTER_REMOTE_WINDOW_COVERING_MAX_REPORT
+#define ANSWER_DELAY            1U        /* Read response delay (s) */
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t read_nb;
+  uint32_t config_nb;
+  uint32_t expected_nb;      /* Refresh requests expected by the reference model */
+  uint64_t last_request;     /* Simulated time (s) of the last refresh request */
+  uint64_t last_answer;      /* Simulated time (s) of the last report or read answer */
+  uint64_t min_gap;          /* Shortest time between two refresh requests (s) */
+  uint64_t answer_due;       /* Simulated time (s) of the pending answer, 0 if none */
+} Sim_Server_t;
+
+/* Private variables ---------------------------------------------------------*/
+RTC_HandleTypeDef           hrtc;
+
+static long                 failures;
+static uint32_t             sim_rng = 0x2545F491U;
+
+/* Simulated RTC and HAL tick */
+static uint64_t             sim_apre;          /* ck_apre periods since the calendar start */
+static uint32_t             sim_tick;          /* HAL tick (ms), stopped in Stop mode */
+static uint32_t             sim_tick_calls;
+static uint32_t             sim_logs;
+
+/* Simulated servers */
+static struct ZbApsAddrT    sim_bind[SERVER_NB];
+static Sim_Server_t         sim_servers[SERVER_NB];
+
+/* Private functions ---------------------------------------------------------*/
+#define CHECK(cond, ...) \
+  do \
+  { \
+    if (!(cond)) \
+    { \
+      if (failures < 20) \
+      { \
+        fprintf(stderr, "  "); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+      } \
+      failures++; \
+    } \
+  } while (0)
+
+static uint32_t Sim_Random(void)
+{
+  sim_rng ^= sim_rng << 13;
+  sim_rng ^= sim_rng >> 17;
+  sim_rng ^= sim_rng << 5;
+  return sim_rng;
+}
+
+/* Simulated platform --------------------------------------------------------*/
+int Sim_Printf(const char *format, ...)
+{
+  if (strchr(format, '\n') != NULL)
+  {
+    sim_logs++;
+  }
+  return 0;
+}
+
+const char *DbgTraceGetFileName(const char *fullpath)
+{
+  const char *ret = strrchr(fullpath, '/');
+
+  return (ret != NULL) ? (ret + 1) : fullpath;
+}
+
+uint32_t HAL_GetTick(void)
+{
+  sim_tick_calls++;
+  return sim_tick;
+}
+
+HAL_StatusTypeDef HAL_RTC_GetTime(RTC_HandleTypeDef *rtc, RTC_TimeTypeDef *sTime, uint32_t Format)
+{
+  uint64_t spre = sim_apre / APRE_PER_SPRE;
+
+  (void)rtc;
+  (void)Format;
+  memset(sTime, 0, sizeof(RTC_TimeTypeDef));
+  sTime->Hours          = (uint8_t)((spre / HOUR) % 24U);
+  sTime->Minutes        = (uint8_t)((spre / MINUTE) % 60U);
+  sTime->Seconds        = (uint8_t)(spre % 60U);
+  sTime->SecondFraction = CFG_RTC_SYNCH_PRESCALER;
+  sTime->SubSeconds     = (uint32_t)(CFG_RTC_SYNCH_PRESCALER - (sim_apre % APRE_PER_SPRE));
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTC_GetDate(RTC_HandleTypeDef *rtc, RTC_DateTypeDef *sDate, uint32_t Format)
+{
+  uint64_t days = sim_apre / APRE_PER_SPRE / DAY;
+
+  (void)rtc;
+  (void)Format;
+  sDate->WeekDay = (uint8_t)((days % 7U) + 1U);
+  sDate->Date    = (uint8_t)((days % 28U) + 1U);
+  sDate->Month   = (uint8_t)(((days / 28U) % 12U) + 1U);
+  sDate->Year    = (uint8_t)((days / (28U * 12U)) % 100U);
+  return HAL_OK;
+}
+
+static uint64_t Sim_Now(void)
+{
+  return sim_apre / APRE_FREQ;
+}
+
+/* Run the simulated clock, the HAL tick only counts while the remote is awake */
+static void Sim_Run(uint64_t apre_nb, bool is_awake)
+{
+  sim_apre += apre_nb;
+  if (is_awake)
+  {
+    sim_tick += (uint32_t)((apre_nb * 1000U) / APRE_FREQ);
+  }
+}
+
+static void Sim_Run_To(uint64_t time)
+{
+  if ((time * APRE_FREQ) > sim_apre)
+  {
+    Sim_Run((time * APRE_FREQ) - sim_apre, false);
+  }
+}
+
+static int Sim_Server_Index(const struct ZbApsAddrT * dst)
+{
+  for (uint8_t i = 0; i < SERVER_NB; i++)
+  {
+    if ((sim_bind[i].extAddr == dst->extAddr) && (sim_bind[i].endpoint == dst->endpoint))
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void Sim_Request(const struct ZbApsAddrT * dst)
+{
+  int           index = Sim_Server_Index(dst);
+  Sim_Server_t *server;
+  uint64_t      now = Sim_Now();
+
+  CHECK(index >= 0, "refresh request to an unknown server 0x%016llx", (unsigned long long)dst->extAddr);
+  if (index < 0)
+  {
+    return;
+  }
+
+  server = &sim_servers[index];
+  if (((server->read_nb + server->config_nb) > 0U) && ((now - server->last_request) < server->min_gap))
+  {
+    server->min_gap = now - server->last_request;
+  }
+  server->last_request = now;
+  if ((index != SERVER_OFFLINE) && (server->answer_due == 0U))
+  {
+    server->answer_due = now + ANSWER_DELAY;
+  }
+}
+
+void App_Roller_Shutter_Remote_Window_Covering_ReportConfig(struct ZbApsAddrT * dst)
+{
+  int index = Sim_Server_Index(dst);
+
+  Sim_Request(dst);
+  if (index >= 0)
+  {
+    sim_servers[index].config_nb++;
+  }
+}
+
+void App_Roller_Shutter_Remote_Window_Covering_Read_Attribute(struct ZbApsAddrT * dst)
+{
+  int index = Sim_Server_Index(dst);
+
+  Sim_Request(dst);
+  if (index >= 0)
+  {
+    sim_servers[index].read_nb++;
+  }
+}
+
+static void Sim_Reset(uint64_t start)
+{
+  sim_apre       = start;
+  sim_tick       = 0U;
+  sim_tick_calls = 0U;
+  memset(sim_servers, 0, sizeof(sim_servers));
+  for (uint8_t i = 0; i < SERVER_NB; i++)
+  {
+    sim_bind[i].mode     = ZB_APSDE_ADDRMODE_EXT;
+    sim_bind[i].extAddr  = 0x0080E1260000A000ULL + i;
+    sim_bind[i].endpoint = 17U;
+    sim_servers[i].min_gap = UINT64_MAX;
+  }
+  App_Roller_Shutter_Remote_Attr_Cache_Init();
+}
+
+/* Deliver the reports and read answers due before a simulated time */
+static void Sim_Servers_Run(uint64_t time)
+{
+  uint64_t next_report;
+
+  for (;;)
+  {
+    int      index = -1;
+    uint64_t due   = time + 1U;
+    bool     is_report = false;
+
+    for (uint8_t i = 0; i < SERVER_NB; i++)
+    {
+      if ((sim_servers[i].answer_due != 0U) && (sim_servers[i].answer_due < due))
+      {
+        due   = sim_servers[i].answer_due;
+        index = i;
+        is_report = false;
+      }
+    }
+    next_report = sim_servers[SERVER_REPORTING].last_answer + REPORT_PERIOD;
+    if (next_report < due)
+    {
+      due   = next_report;
+      index = SERVER_REPORTING;
+      is_report = true;
+    }
+    if (index < 0)
+    {
+      break;
+    }
+
+    Sim_Run_To(due);
+    if (is_report == false)
+    {
+      sim_servers[index].answer_due = 0U;
+      if (index == SERVER_CFG_FAILED)
+      {
+        /* The retried configuration fails again, no position received */
+        App_Roller_Shutter_Remote_Attr_Cache_Set_Cfg_Status(sim_bind[index].extAddr, sim_bind[index].endpoint,
+                                                            ATTR_CACHE_CFG_FAILED);
+        continue;
+      }
+    }
+    sim_servers[index].last_answer = due;
+    App_Roller_Shutter_Remote_Attr_Cache_Update(sim_bind[index].extAddr, sim_bind[index].endpoint,
+                                                (uint8_t)(Sim_Random() % 3U), is_report,
+                                                App_Roller_Shutter_Remote_Attr_Cache_Get_Time());
+  }
+  Sim_Run_To(time);
+}
+
+/* Checks --------------------------------------------------------------------*/
+/* The cache time follows the simulated time over the week day wrap around */
+static void Check_Time(uint32_t number)
+{
+  uint64_t wrap = 7ULL * DAY * (APRE_PER_SPRE / APRE_FREQ);
+  uint64_t prev_apre;
+  uint32_t prev;
+  uint32_t now;
+  uint64_t elapsed;
+  uint32_t age;
+  uint32_t wraps = 0U;
+
+  Sim_Reset(((uint64_t)Sim_Random() << 16) % (wrap * APRE_FREQ));
+  prev_apre = sim_apre;
+  prev      = App_Roller_Shutter_Remote_Attr_Cache_Get_Time();
+  for (uint32_t i = 0; i < number; i++)
+  {
+    /* From a few ms to 3 days, most of them in Stop mode */
+    uint64_t step = (Sim_Random() % 4U == 0U) ? (Sim_Random() % APRE_FREQ)
+                                              : (((uint64_t)Sim_Random() << 8) % (3ULL * DAY * APRE_FREQ));
+
+    Sim_Run(step, (Sim_Random() % 8U) == 0U);
+    now = App_Roller_Shutter_Remote_Attr_Cache_Get_Time();
+    CHECK(now < ATTR_CACHE_TIME_WRAP, "time %u beyond the wrap %u", now, ATTR_CACHE_TIME_WRAP);
+
+    /* The cache time is truncated to the second */
+    elapsed = (sim_apre / APRE_FREQ) - (prev_apre / APRE_FREQ);
+    age     = Attr_Cache_Age(now, prev);
+    CHECK(age == elapsed, "step %u: age %u s, elapsed %llu s", i, age, (unsigned long long)elapsed);
+    if (now < prev)
+    {
+      wraps++;
+    }
+    prev      = now;
+    prev_apre = sim_apre;
+  }
+
+  CHECK(ATTR_CACHE_TIME_WRAP == wrap, "wrap %u s, expected %llu s", ATTR_CACHE_TIME_WRAP, (unsigned long long)wrap);
+  CHECK(wraps > 0U, "the week day never wrapped");
+  CHECK(sim_tick_calls == 0U, "HAL tick read %u times", sim_tick_calls);
+  printf("time: %u steps, %u week day wraps, %.0f days\n", number, wraps,
+         (double)sim_apre / (double)(APRE_FREQ * DAY));
+}
+
+/* A position read before a Stop period is stale after it, even on the wrap */
+static void Check_Stop_Mode(void)
+{
+  struct ZbApsAddrT * dst = &sim_bind[SERVER_SILENT];
+  uint64_t            starts[] = { 0U, (ATTR_CACHE_TIME_WRAP - 10U) * APRE_FREQ, 123456789U };
+
+  for (uint8_t i = 0; i < (sizeof(starts) / sizeof(starts[0])); i++)
+  {
+    Sim_Reset(starts[i]);
+    CHECK(App_Roller_Shutter_Remote_Attr_Cache_Is_Stale(dst->extAddr, dst->endpoint,
+          App_Roller_Shutter_Remote_Attr_Cache_Get_Time()), "start %u: unknown server not stale", i);
+
+    App_Roller_Shutter_Remote_Attr_Cache_Update(dst->extAddr, dst->endpoint, 1U, false,
+                                                App_Roller_Shutter_Remote_Attr_Cache_Get_Time());
+    /* Awake 2 s, then in Stop until the stale delay */
+    Sim_Run(2U * APRE_FREQ, true);
+    Sim_Run((ATTR_CACHE_STALE_DELAY - 2U) * APRE_FREQ, false);
+    CHECK(App_Roller_Shutter_Remote_Attr_Cache_Is_Stale(dst->extAddr, dst->endpoint,
+          App_Roller_Shutter_Remote_Attr_Cache_Get_Time()) == false, "start %u: stale at the delay", i);
+
+    Sim_Run(APRE_FREQ + 1U, false);
+    CHECK(App_Roller_Shutter_Remote_Attr_Cache_Is_Stale(dst->extAddr, dst->endpoint,
+          App_Roller_Shutter_Remote_Attr_Cache_Get_Time()), "start %u: not stale after %u s in Stop",
+          i, ATTR_CACHE_STALE_DELAY);
+
+    /* A user action after a night in Stop refreshes it */
+    Sim_Run(8ULL * HOUR * APRE_FREQ, false);
+    App_Roller_Shutter_Remote_Attr_Cache_Refresh(dst, 1U);
+    CHECK(sim_servers[SERVER_SILENT].read_nb == 1U, "start %u: %u reads after a night in Stop",
+          i, sim_servers[SERVER_SILENT].read_nb);
+    CHECK(sim_tick < 3000U, "start %u: HAL tick %u ms", i, sim_tick);
+  }
+  printf("stop mode: stale after %u s, refreshed after a night in Stop\n", ATTR_CACHE_STALE_DELAY);
+}
+
+/* Refresh requests on user actions, against a reference model */
+static void Check_Refresh(uint32_t number)
+{
+  uint64_t start;
+  uint64_t time;
+  uint32_t actions = 0U;
+  uint32_t requests;
+
+  Sim_Reset(((uint64_t)Sim_Random() << 12) % (ATTR_CACHE_TIME_WRAP * APRE_FREQ));
+  start = Sim_Now();
+  time  = start;
+  App_Roller_Shutter_Remote_Attr_Cache_Set_Cfg_Status(sim_bind[SERVER_CFG_FAILED].extAddr,
+                                                      sim_bind[SERVER_CFG_FAILED].endpoint, ATTR_CACHE_CFG_FAILED);
+  sim_servers[SERVER_REPORTING].last_answer = time;
+  App_Roller_Shutter_Remote_Attr_Cache_Update(sim_bind[SERVER_REPORTING].extAddr, sim_bind[SERVER_REPORTING].endpoint,
+                                              0U, true, App_Roller_Shutter_Remote_Attr_Cache_Get_Time());
+
+  for (uint32_t i = 0; i < number; i++)
+  {
+    /* Bursts of key presses, or a pause up to an hour */
+    time += ((Sim_Random() % 3U) == 0U) ? (1U + (Sim_Random() % 5U)) : (Sim_Random() % HOUR);
+    Sim_Servers_Run(time);
+
+    for (uint8_t s = 0; s < SERVER_NB; s++)
+    {
+      Sim_Server_t * server = &sim_servers[s];
+      bool           is_answered = ((server->last_answer != 0U) && (server->last_answer >= server->last_request));
+      bool           is_stale = ((server->last_answer == 0U) || ((time - server->last_answer) > ATTR_CACHE_STALE_DELAY));
+      bool           is_holdoff = ((is_answered == false) && ((server->read_nb + server->config_nb) > 0U)
+                                   && ((time - server->last_request) < ATTR_CACHE_POLL_HOLDOFF));
+
+      if ((is_stale) && (is_holdoff == false))
+      {
+        server->expected_nb++;
+      }
+    }
+
+    App_Roller_Shutter_Remote_Attr_Cache_Refresh(sim_bind, SERVER_NB);
+    actions++;
+  }
+
+  requests = 0U;
+  for (uint8_t s = 0; s < SERVER_NB; s++)
+  {
+    Sim_Server_t * server = &sim_servers[s];
+
+    CHECK((server->read_nb + server->config_nb) == server->expected_nb, "server %u: %u requests, expected %u",
+          s, server->read_nb + server->config_nb, server->expected_nb);
+    requests += server->read_nb + server->config_nb;
+  }
+  CHECK(sim_servers[SERVER_REPORTING].read_nb == 0U, "reporting server read %u times",
+        sim_servers[SERVER_REPORTING].read_nb);
+  CHECK(sim_servers[SERVER_CFG_FAILED].read_nb == 0U, "failed configuration read %u times instead of configured",
+        sim_servers[SERVER_CFG_FAILED].read_nb);
+  CHECK(sim_servers[SERVER_CFG_FAILED].config_nb > 0U, "failed configuration never retried");
+  CHECK(sim_servers[SERVER_SILENT].min_gap > ATTR_CACHE_STALE_DELAY, "silent server read again after %llu s",
+        (unsigned long long)sim_servers[SERVER_SILENT].min_gap);
+  CHECK(sim_servers[SERVER_CFG_FAILED].min_gap >= ATTR_CACHE_POLL_HOLDOFF, "configuration retried after %llu s",
+        (unsigned long long)sim_servers[SERVER_CFG_FAILED].min_gap);
+  CHECK(sim_servers[SERVER_OFFLINE].min_gap >= ATTR_CACHE_POLL_HOLDOFF, "offline server polled again after %llu s",
+        (unsigned long long)sim_servers[SERVER_OFFLINE].min_gap);
+  CHECK(App_Roller_Shutter_Remote_Attr_Cache_Get_Stats()->poll_nb == requests, "%u refreshes counted, %u sent",
+        App_Roller_Shutter_Remote_Attr_Cache_Get_Stats()->poll_nb, requests);
+  CHECK(sim_tick_calls == 0U, "HAL tick read %u times", sim_tick_calls);
+
+  sim_logs = 0U;
+  App_Roller_Shutter_Remote_Attr_Cache_Disp();
+  /* Header, one line per server, footer and statistics, the last one ends with an empty line */
+  CHECK(sim_logs == (3U + SERVER_NB + 4U), "%u display lines", sim_logs);
+
+  printf("refresh: %u user actions over %.1f days, requests reporting %u silent %u cfg failed %u offline %u\n",
+         actions, (double)(Sim_Now() - start) / DAY,
+         sim_servers[SERVER_REPORTING].read_nb + sim_servers[SERVER_REPORTING].config_nb,
+         sim_servers[SERVER_SILENT].read_nb, sim_servers[SERVER_CFG_FAILED].config_nb,
+         sim_servers[SERVER_OFFLINE].read_nb);
+}
+
+static void Usage(void)
+{
+  fprintf(stderr, "usage: attr_cache [-n user_actions]\n");
+  exit(2);
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char * argv[])
+{
+  uint32_t number = 2000U;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if ((strcmp(argv[i], "-n") == 0) && ((i + 1) < argc))
+    {
+      number = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+    else
+    {
+      Usage();
+    }
+  }
+
+  Check_Time(50U * number);
+  Check_Stop_Mode();
+  Check_Refresh(number);
+
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,33 @@
+/**
+  ******************************************************************************
+  * @file    app_conf.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the Shutter Remote configuration, only the
+  *          RTC settings used by the attribute cache time base
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef APP_CONF_H
+#define APP_CONF_H
+
+#include "stm32wbxx_hal.h"
+
+#define APPLI_PRINT_FILE_FUNC_LINE              0
+
+/* RTC prescalers of the remote, custom configuration without 1Hz calendar */
+#define CFG_RTCCLK_DIV                          (16)
+#define CFG_RTC_WUCKSEL_DIVIDER                 (0)
+#define CFG_RTC_ASYNCH_PRESCALER                (CFG_RTCCLK_DIV - 1)
+#define CFG_RTC_SYNCH_PRESCALER                 (0x7FFF)
+
+#endif /* APP_CONF_H */
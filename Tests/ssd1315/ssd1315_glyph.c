@@ -0,0 +1,315 @@
+/**
+  ******************************************************************************
+  * @file    ssd1315_glyph.c
+  * @author  Zigbee Application Team
+  * @brief   Glyph drawing check and benchmark of the LCD utility on SSD1315.
+  *          The unmodified stm32_lcd.c draws the same strings on the SSD1315
+  *          frame buffer pixel by pixel and by glyph columns: the frame
+  *          buffers shall be the same for all the fonts, at Y positions on
+  *          and off the pages, with inverted colors and clipped at the screen
+  *          edge. The driver calls and the host time per string are printed
+  *          for both paths.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Code under test, built as is to read the frame buffer */
+#include "ssd1315_reg.c"
+#include "ssd1315.c"
+#include "stm32_lcd.c"
+
+/* Private defines -----------------------------------------------------------*/
+#define FRAME_SIZE              (SSD1315_LCD_COLUMN_NUMBER * SSD1315_LCD_PAGE_NUMBER)
+#define RUN_NB                  5U        /* Timed runs, the fastest one is kept */
+
+/* String of the applications status line, drawn with Font12 */
+#define BENCH_TEXT              "Zb Shutter 42%"
+
+/* Private variables ---------------------------------------------------------*/
+static SSD1315_Object_t     lcd_obj;
+static uint32_t             lcd_calls;
+static long                 failures;
+
+/* Private functions ---------------------------------------------------------*/
+static int32_t Sim_WriteReg(uint16_t Reg, uint8_t * pData, uint16_t Length)
+{
+  (void)Reg;
+  (void)pData;
+  (void)Length;
+  return 0;
+}
+
+static int32_t Sim_ReadReg(uint16_t Reg, uint8_t * pData, uint16_t Length)
+{
+  (void)Reg;
+  (void)pData;
+  (void)Length;
+  return 0;
+}
+
+static int32_t Sim_GetTick(void)
+{
+  static int32_t tick;
+
+  tick += 10;
+  return tick;
+}
+
+static int32_t Sim_Ok(void)
+{
+  return 0;
+}
+
+static uint64_t Host_Ns(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+/* LCD utility driver on the component, as the DK BSP ------------------------*/
+static int32_t Lcd_FillRGBRect(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint8_t * pData, uint32_t Width, uint32_t Height)
+{
+  (void)Instance;
+  lcd_calls++;
+  return SSD1315_FillRGBRect(&lcd_obj, Xpos, Ypos, pData, Width, Height);
+}
+
+static int32_t Lcd_DrawHLine(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Length, uint32_t Color)
+{
+  (void)Instance;
+  lcd_calls++;
+  return SSD1315_DrawHLine(&lcd_obj, Xpos, Ypos, Length, Color);
+}
+
+static int32_t Lcd_DrawVLine(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Length, uint32_t Color)
+{
+  (void)Instance;
+  lcd_calls++;
+  return SSD1315_DrawVLine(&lcd_obj, Xpos, Ypos, Length, Color);
+}
+
+static int32_t Lcd_FillRect(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Width, uint32_t Height, uint32_t Color)
+{
+  (void)Instance;
+  lcd_calls++;
+  return SSD1315_FillRect(&lcd_obj, Xpos, Ypos, Width, Height, Color);
+}
+
+static int32_t Lcd_GetPixel(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t * Color)
+{
+  (void)Instance;
+  lcd_calls++;
+  return SSD1315_GetPixel(&lcd_obj, Xpos, Ypos, Color);
+}
+
+static int32_t Lcd_SetPixel(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Color)
+{
+  (void)Instance;
+  lcd_calls++;
+  return SSD1315_SetPixel(&lcd_obj, Xpos, Ypos, Color);
+}
+
+static int32_t Lcd_GetXSize(uint32_t Instance, uint32_t * XSize)
+{
+  (void)Instance;
+  return SSD1315_GetXSize(&lcd_obj, XSize);
+}
+
+static int32_t Lcd_GetYSize(uint32_t Instance, uint32_t * YSize)
+{
+  (void)Instance;
+  return SSD1315_GetYSize(&lcd_obj, YSize);
+}
+
+static int32_t Lcd_GetFormat(uint32_t Instance, uint32_t * PixelFormat)
+{
+  (void)Instance;
+  (void)PixelFormat;
+  return -1;
+}
+
+static int32_t Lcd_DrawGlyph(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint8_t * pData, uint32_t Width, uint32_t Height,
+                             uint32_t TextColor, uint32_t BackColor)
+{
+  (void)Instance;
+  lcd_calls++;
+  return SSD1315_DrawGlyph(&lcd_obj, Xpos, Ypos, pData, Width, Height, TextColor, BackColor);
+}
+
+/* Without the glyph entry, as the drivers of the other displays */
+static const LCD_UTILS_Drv_t lcd_driver_pixel =
+{
+  .FillRGBRect = Lcd_FillRGBRect,
+  .DrawHLine   = Lcd_DrawHLine,
+  .DrawVLine   = Lcd_DrawVLine,
+  .FillRect    = Lcd_FillRect,
+  .GetPixel    = Lcd_GetPixel,
+  .SetPixel    = Lcd_SetPixel,
+  .GetXSize    = Lcd_GetXSize,
+  .GetYSize    = Lcd_GetYSize,
+  .GetFormat   = Lcd_GetFormat,
+};
+
+static const LCD_UTILS_Drv_t lcd_driver_glyph =
+{
+  .FillRGBRect = Lcd_FillRGBRect,
+  .DrawHLine   = Lcd_DrawHLine,
+  .DrawVLine   = Lcd_DrawVLine,
+  .FillRect    = Lcd_FillRect,
+  .GetPixel    = Lcd_GetPixel,
+  .SetPixel    = Lcd_SetPixel,
+  .GetXSize    = Lcd_GetXSize,
+  .GetYSize    = Lcd_GetYSize,
+  .GetFormat   = Lcd_GetFormat,
+  .DrawGlyph   = Lcd_DrawGlyph,
+};
+
+/* Checks --------------------------------------------------------------------*/
+/* Lines every YStep pixels, an inverted string and a string clipped at the bottom right corner */
+static void Draw_Screen(const LCD_UTILS_Drv_t * pDriver, sFONT * pFont, uint32_t YStep)
+{
+  uint32_t y;
+
+  UTIL_LCD_SetFuncDriver(pDriver);
+  UTIL_LCD_SetFont(pFont);
+  UTIL_LCD_SetTextColor(SSD1315_COLOR_WHITE);
+  UTIL_LCD_SetBackColor(SSD1315_COLOR_BLACK);
+  for (y = 0U; y < 64U; y += YStep)
+  {
+    UTIL_LCD_DisplayStringAt(0, y, (uint8_t *)BENCH_TEXT, CENTER_MODE);
+  }
+  UTIL_LCD_SetTextColor(SSD1315_COLOR_BLACK);
+  UTIL_LCD_SetBackColor(SSD1315_COLOR_WHITE);
+  UTIL_LCD_DisplayStringAt(3, 5, (uint8_t *)"{Inv}", LEFT_MODE);
+  UTIL_LCD_DisplayStringAt(100, 60, (uint8_t *)"clip", LEFT_MODE);
+}
+
+static void Check_Fonts(void)
+{
+  static sFONT * fonts[] = { &Font8, &Font12, &Font16, &Font20, &Font24 };
+  static uint8_t ref[FRAME_SIZE];
+  uint32_t font, y_step;
+
+  for (font = 0U; font < (sizeof(fonts) / sizeof(fonts[0])); font++)
+  {
+    for (y_step = 3U; y_step <= 13U; y_step += 5U)
+    {
+      memset(PhysFrameBuffer, 0x5A, FRAME_SIZE);
+      Draw_Screen(&lcd_driver_pixel, fonts[font], y_step);
+      memcpy(ref, PhysFrameBuffer, FRAME_SIZE);
+
+      /* Twice, the second time from the glyph cache */
+      memset(PhysFrameBuffer, 0x5A, FRAME_SIZE);
+      Draw_Screen(&lcd_driver_glyph, fonts[font], y_step);
+      Draw_Screen(&lcd_driver_glyph, fonts[font], y_step);
+      if (memcmp(ref, PhysFrameBuffer, FRAME_SIZE) != 0)
+      {
+        fprintf(stderr, "  font %u x %u, lines every %u pixels: frame buffers differ\n", fonts[font]->Width,
+                fonts[font]->Height, (unsigned)y_step);
+        failures++;
+      }
+    }
+  }
+}
+
+/* Benchmark -----------------------------------------------------------------*/
+static double Time_String(const LCD_UTILS_Drv_t * pDriver, uint32_t Loops, uint32_t * pCalls)
+{
+  uint64_t start;
+  uint32_t loop;
+
+  UTIL_LCD_SetFuncDriver(pDriver);
+  UTIL_LCD_SetFont(&Font12);
+  UTIL_LCD_SetTextColor(SSD1315_COLOR_WHITE);
+  UTIL_LCD_SetBackColor(SSD1315_COLOR_BLACK);
+
+  lcd_calls = 0U;
+  UTIL_LCD_DisplayStringAt(0, LINE(4), (uint8_t *)BENCH_TEXT, CENTER_MODE);
+  *pCalls = lcd_calls;
+
+  start = Host_Ns();
+  for (loop = 0U; loop < Loops; loop++)
+  {
+    UTIL_LCD_DisplayStringAt(0, LINE(loop & 3U), (uint8_t *)BENCH_TEXT, CENTER_MODE);
+  }
+  return (double)(Host_Ns() - start) / Loops;
+}
+
+static void Usage(void)
+{
+  fprintf(stderr, "usage: ssd1315_glyph [-n timed strings]\n");
+  exit(2);
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char * argv[])
+{
+  SSD1315_IO_t io = { Sim_Ok, Sim_Ok, Sim_WriteReg, Sim_ReadReg, Sim_GetTick };
+  uint32_t loops = 20000U;
+  uint32_t calls_pixel, calls_glyph;
+  uint32_t run;
+  double   t_pixel = 0.0, t_glyph = 0.0, t;
+  int      arg;
+
+  for (arg = 1; arg < argc; arg++)
+  {
+    if ((strcmp(argv[arg], "-n") == 0) && ((arg + 1) < argc))
+    {
+      loops = (uint32_t)atol(argv[++arg]);
+    }
+    else
+    {
+      Usage();
+    }
+  }
+
+  (void)SSD1315_RegisterBusIO(&lcd_obj, &io);
+  if (SSD1315_Init(&lcd_obj, SSD1315_FORMAT_DEFAULT, SSD1315_ORIENTATION_LANDSCAPE) != SSD1315_OK)
+  {
+    fprintf(stderr, "  init failed\n");
+    failures++;
+  }
+
+  Check_Fonts();
+
+  /* Host time only, the calls to the driver give the order of the gain on the M4 */
+  for (run = 0U; (run < RUN_NB) && (loops != 0U); run++)
+  {
+    t = Time_String(&lcd_driver_pixel, loops, &calls_pixel);
+    t_pixel = ((run == 0U) || (t < t_pixel)) ? t : t_pixel;
+    t = Time_String(&lcd_driver_glyph, loops, &calls_glyph);
+    t_glyph = ((run == 0U) || (t < t_glyph)) ? t : t_glyph;
+  }
+  if (loops != 0U)
+  {
+    printf("  \"%s\" Font12, pixel path: %u driver calls, %.2f us on the host\n", BENCH_TEXT, (unsigned)calls_pixel,
+           t_pixel / 1000.0);
+    printf("  \"%s\" Font12, glyph path: %u driver calls, %.2f us on the host\n", BENCH_TEXT, (unsigned)calls_glyph,
+           t_glyph / 1000.0);
+    if (calls_glyph >= calls_pixel)
+    {
+      fprintf(stderr, "  the glyph path makes %u driver calls, the pixel path %u\n", (unsigned)calls_glyph,
+              (unsigned)calls_pixel);
+      failures++;
+    }
+  }
+
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,506 @@
+/**
+  ******************************************************************************
+  * @file    ssd1315_refresh.c
+  * @author  Zigbee Application Team
+  * @brief   Partial refresh check of the SSD1315 driver.
+  *          The unmodified ssd1315.c and stm32_lcd.c draw on a simulated
+  *          controller which decodes the column and page address commands
+  *          and fills its display RAM as the SSD1315 does. The bytes sent
+  *          for the typical updates of the applications are counted and
+  *          compared with the full refresh, and after random drawings and
+  *          refreshes the display RAM shall always be the frame buffer, also
+  *          after asynchronous refreshes that fail or are aborted.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Code under test, built as is to read the frame buffer */
+#include "ssd1315_reg.c"
+#include "ssd1315.c"
+#include "stm32_lcd.c"
+
+/* Private defines -----------------------------------------------------------*/
+#define COLUMN_NB               SSD1315_LCD_COLUMN_NUMBER
+#define PAGE_NB                 SSD1315_LCD_PAGE_NUMBER
+#define FRAME_SIZE              (COLUMN_NB * PAGE_NB)
+
+/* Bytes of the full refresh done before : 7 commands and the frame buffer */
+#define FULL_REFRESH_BYTES      (7U + FRAME_SIZE)
+
+/* Lines of the DK applications, drawn with Font12 */
+#define STATUS_LINE             4U
+#define MENU_LINE               3U
+
+/* Private variables ---------------------------------------------------------*/
+static SSD1315_Object_t     lcd_obj;
+static long                 failures;
+
+/* Simulated controller : display RAM and address window, horizontal addressing */
+static uint8_t              sim_ram[PAGE_NB][COLUMN_NB];
+static uint8_t              sim_cmd[3];
+static uint32_t             sim_cmd_nb;
+static uint32_t             sim_column_start;
+static uint32_t             sim_column_end = COLUMN_NB - 1U;
+static uint32_t             sim_page_start;
+static uint32_t             sim_page_end = PAGE_NB - 1U;
+static uint32_t             sim_column;
+static uint32_t             sim_page;
+static uint32_t             sim_bytes;
+static uint32_t             sim_rng = 0x2545F491U;
+
+/* Private functions ---------------------------------------------------------*/
+#define CHECK(cond, ...) \
+  do \
+  { \
+    if (!(cond)) \
+    { \
+      if (failures < 20) \
+      { \
+        fprintf(stderr, "  "); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+      } \
+      failures++; \
+    } \
+  } while (0)
+
+static uint32_t Sim_Random(void)
+{
+  sim_rng ^= sim_rng << 13;
+  sim_rng ^= sim_rng >> 17;
+  sim_rng ^= sim_rng << 5;
+  return sim_rng;
+}
+
+/* Simulated controller ------------------------------------------------------*/
+/* The DK bus sends the 1 byte writes as commands and the longer ones as data */
+static void Sim_Command(uint8_t Cmd)
+{
+  if (sim_cmd_nb == 0U)
+  {
+    if ((Cmd == SSD1315_SET_COLUMN_ADRESS) || (Cmd == SSD1315_SET_PAGE_ADRESS))
+    {
+      sim_cmd[sim_cmd_nb++] = Cmd;
+    }
+    return;
+  }
+
+  sim_cmd[sim_cmd_nb++] = Cmd;
+  if (sim_cmd_nb == 3U)
+  {
+    if (sim_cmd[0] == SSD1315_SET_COLUMN_ADRESS)
+    {
+      sim_column_start = sim_cmd[1] % COLUMN_NB;
+      sim_column_end   = sim_cmd[2] % COLUMN_NB;
+      sim_column       = sim_column_start;
+    }
+    else
+    {
+      sim_page_start = sim_cmd[1] % PAGE_NB;
+      sim_page_end   = sim_cmd[2] % PAGE_NB;
+      sim_page       = sim_page_start;
+    }
+    sim_cmd_nb = 0U;
+  }
+}
+
+static void Sim_Data(const uint8_t * pData, uint32_t Length)
+{
+  uint32_t i;
+
+  for (i = 0U; i < Length; i++)
+  {
+    sim_ram[sim_page][sim_column] = pData[i];
+    if (sim_column == sim_column_end)
+    {
+      sim_column = sim_column_start;
+      sim_page   = (sim_page == sim_page_end) ? sim_page_start : (sim_page + 1U);
+    }
+    else
+    {
+      sim_column = (sim_column + 1U) % COLUMN_NB;
+    }
+  }
+}
+
+static int32_t Sim_WriteReg(uint16_t Reg, uint8_t * pData, uint16_t Length)
+{
+  (void)Reg;
+  sim_bytes += Length;
+  if (Length == 1U)
+  {
+    Sim_Command(pData[0]);
+  }
+  else
+  {
+    Sim_Data(pData, Length);
+  }
+  return 0;
+}
+
+static int32_t Sim_ReadReg(uint16_t Reg, uint8_t * pData, uint16_t Length)
+{
+  (void)Reg;
+  (void)pData;
+  (void)Length;
+  return 0;
+}
+
+static int32_t Sim_GetTick(void)
+{
+  static int32_t tick;
+
+  tick += 10;
+  return tick;
+}
+
+static int32_t Sim_Ok(void)
+{
+  return 0;
+}
+
+/* LCD utility driver on the component, as the DK BSP ------------------------*/
+static int32_t Lcd_FillRGBRect(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint8_t * pData, uint32_t Width, uint32_t Height)
+{
+  (void)Instance;
+  return SSD1315_FillRGBRect(&lcd_obj, Xpos, Ypos, pData, Width, Height);
+}
+
+static int32_t Lcd_DrawHLine(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Length, uint32_t Color)
+{
+  (void)Instance;
+  return SSD1315_DrawHLine(&lcd_obj, Xpos, Ypos, Length, Color);
+}
+
+static int32_t Lcd_DrawVLine(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Length, uint32_t Color)
+{
+  (void)Instance;
+  return SSD1315_DrawVLine(&lcd_obj, Xpos, Ypos, Length, Color);
+}
+
+static int32_t Lcd_FillRect(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Width, uint32_t Height, uint32_t Color)
+{
+  (void)Instance;
+  return SSD1315_FillRect(&lcd_obj, Xpos, Ypos, Width, Height, Color);
+}
+
+static int32_t Lcd_GetPixel(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t * Color)
+{
+  (void)Instance;
+  return SSD1315_GetPixel(&lcd_obj, Xpos, Ypos, Color);
+}
+
+static int32_t Lcd_SetPixel(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Color)
+{
+  (void)Instance;
+  return SSD1315_SetPixel(&lcd_obj, Xpos, Ypos, Color);
+}
+
+static int32_t Lcd_GetXSize(uint32_t Instance, uint32_t * XSize)
+{
+  (void)Instance;
+  return SSD1315_GetXSize(&lcd_obj, XSize);
+}
+
+static int32_t Lcd_GetYSize(uint32_t Instance, uint32_t * YSize)
+{
+  (void)Instance;
+  return SSD1315_GetYSize(&lcd_obj, YSize);
+}
+
+static int32_t Lcd_GetFormat(uint32_t Instance, uint32_t * PixelFormat)
+{
+  (void)Instance;
+  (void)PixelFormat;
+  return -1;
+}
+
+static int32_t Lcd_DrawGlyph(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint8_t * pData, uint32_t Width, uint32_t Height,
+                             uint32_t TextColor, uint32_t BackColor)
+{
+  (void)Instance;
+  return SSD1315_DrawGlyph(&lcd_obj, Xpos, Ypos, pData, Width, Height, TextColor, BackColor);
+}
+
+static const LCD_UTILS_Drv_t lcd_driver =
+{
+  .FillRGBRect = Lcd_FillRGBRect,
+  .DrawHLine   = Lcd_DrawHLine,
+  .DrawVLine   = Lcd_DrawVLine,
+  .FillRect    = Lcd_FillRect,
+  .GetPixel    = Lcd_GetPixel,
+  .SetPixel    = Lcd_SetPixel,
+  .GetXSize    = Lcd_GetXSize,
+  .GetYSize    = Lcd_GetYSize,
+  .GetFormat   = Lcd_GetFormat,
+  .DrawGlyph   = Lcd_DrawGlyph,
+};
+
+/* Checks --------------------------------------------------------------------*/
+static void Check_Ram(const char * pWhen)
+{
+  uint32_t page, column;
+
+  for (page = 0U; page < PAGE_NB; page++)
+  {
+    for (column = 0U; column < COLUMN_NB; column++)
+    {
+      if (sim_ram[page][column] != PhysFrameBuffer[column + (page * COLUMN_NB)])
+      {
+        CHECK(0, "%s: page %u column %u is 0x%02X on the display, 0x%02X in the frame buffer", pWhen,
+              (unsigned)page, (unsigned)column, sim_ram[page][column], PhysFrameBuffer[column + (page * COLUMN_NB)]);
+        return;
+      }
+    }
+  }
+}
+
+static uint32_t Refresh(void)
+{
+  sim_bytes = 0U;
+  CHECK(SSD1315_Refresh(&lcd_obj) == SSD1315_OK, "refresh failed");
+  Check_Ram("refresh");
+  return sim_bytes;
+}
+
+/* Asynchronous refresh of the DK BSP : window commands, then one data transfer */
+static uint32_t Refresh_Async(void)
+{
+  static uint8_t tx_buffer[FRAME_SIZE];
+  uint32_t length = 0U;
+
+  sim_bytes = 0U;
+  CHECK(SSD1315_PrepareRefresh(&lcd_obj, tx_buffer, &length) == SSD1315_OK, "refresh preparation failed");
+  if (length != 0U)
+  {
+    CHECK(length >= 2U, "asynchronous refresh of %u byte", (unsigned)length);
+    (void)Sim_WriteReg(1U, tx_buffer, (uint16_t)length);
+  }
+  Check_Ram("asynchronous refresh");
+  return sim_bytes;
+}
+
+/* Asynchronous refresh whose DMA does not start, or is aborted after a part
+ * of the window: the window shall be sent by the next refresh */
+static uint32_t Refresh_Async_Failed(void)
+{
+  static uint8_t tx_buffer[FRAME_SIZE];
+  uint32_t length = 0U;
+
+  sim_bytes = 0U;
+  CHECK(SSD1315_PrepareRefresh(&lcd_obj, tx_buffer, &length) == SSD1315_OK, "refresh preparation failed");
+  if (length != 0U)
+  {
+    length = Sim_Random() % length;
+    if (length != 0U)
+    {
+      (void)Sim_WriteReg(1U, tx_buffer, (uint16_t)length);
+    }
+    CHECK(SSD1315_CancelRefresh(&lcd_obj) == SSD1315_OK, "refresh cancel failed");
+  }
+  return sim_bytes;
+}
+
+static void Update(const char * pName, uint32_t Bytes)
+{
+  printf("  %-32s %4u bytes (full refresh %u)\n", pName, (unsigned)Bytes, (unsigned)FULL_REFRESH_BYTES);
+}
+
+/* Line rewritten as by the applications : cleared, then drawn with Font12 */
+static void Text_Line(uint32_t Line, const char * pText)
+{
+  UTIL_LCD_ClearStringLine(Line);
+  UTIL_LCD_DisplayStringAt(0, LINE(Line), (uint8_t *)pText, CENTER_MODE);
+}
+
+static void Typical_Updates(void)
+{
+  /* Window of a Font12 line, on 2 pages at most */
+  const uint32_t line_max = 6U + (2U * COLUMN_NB);
+  uint32_t bytes;
+
+  bytes = Refresh();
+  Update("idle", bytes);
+  CHECK(bytes == 0U, "idle: %u bytes", (unsigned)bytes);
+
+  /* Areas aligned on pages, the exact number of bytes is known */
+  SSD1315_FillRect(&lcd_obj, 0U, 48U, COLUMN_NB, 16U, SSD1315_COLOR_WHITE);
+  bytes = Refresh();
+  Update("128x16 band on pages 6-7", bytes);
+  CHECK(bytes == (6U + (2U * COLUMN_NB)), "band: %u bytes", (unsigned)bytes);
+
+  SSD1315_FillRect(&lcd_obj, 0U, 48U, COLUMN_NB, 16U, SSD1315_COLOR_WHITE);
+  bytes = Refresh();
+  Update("same band drawn again", bytes);
+  CHECK(bytes == 0U, "same band: %u bytes", (unsigned)bytes);
+
+  SSD1315_FillRect(&lcd_obj, 10U, 20U, 30U, 10U, SSD1315_COLOR_WHITE);
+  bytes = Refresh();
+  Update("30x10 area on pages 2-3", bytes);
+  CHECK(bytes == (6U + (2U * 30U)), "area: %u bytes", (unsigned)bytes);
+
+  SSD1315_FillRect(&lcd_obj, 0U, 48U, COLUMN_NB, 16U, SSD1315_COLOR_BLACK);
+  SSD1315_FillRect(&lcd_obj, 10U, 20U, 30U, 10U, SSD1315_COLOR_BLACK);
+  bytes = Refresh();
+  Update("both areas cleared", bytes);
+  CHECK(bytes == ((6U + (2U * COLUMN_NB)) + (6U + (2U * 30U))), "both areas: %u bytes", (unsigned)bytes);
+
+  SSD1315_SetPixel(&lcd_obj, COLUMN_NB - 1U, 63U, SSD1315_COLOR_WHITE);
+  bytes = Refresh();
+  Update("last pixel, window widened", bytes);
+  CHECK(bytes == (6U + 2U), "last pixel: %u bytes", (unsigned)bytes);
+
+  /* Text lines of the applications. Rewriting the same text still sends the
+   * line: the clear and the text change the pixels in between */
+  UTIL_LCD_SetFont(&Font12);
+  UTIL_LCD_SetTextColor(SSD1315_COLOR_WHITE);
+  UTIL_LCD_SetBackColor(SSD1315_COLOR_BLACK);
+  Text_Line(STATUS_LINE, "Network Join");
+  bytes = Refresh();
+  Update("status line text", bytes);
+  CHECK((bytes != 0U) && (bytes <= line_max), "status line: %u bytes", (unsigned)bytes);
+
+  Text_Line(STATUS_LINE, "Joined, 42%");
+  bytes = Refresh();
+  Update("other status line text", bytes);
+  CHECK((bytes != 0U) && (bytes <= line_max), "other status line: %u bytes", (unsigned)bytes);
+
+  Text_Line(MENU_LINE, "Up");
+  bytes = Refresh_Async();
+  Update("menu line, asynchronous", bytes);
+  CHECK((bytes != 0U) && (bytes <= line_max), "menu line: %u bytes", (unsigned)bytes);
+
+  /* Only the pages holding a text change */
+  UTIL_LCD_Clear(SSD1315_COLOR_BLACK);
+  bytes = Refresh();
+  Update("screen cleared", bytes);
+  CHECK(bytes < FULL_REFRESH_BYTES, "screen cleared: %u bytes", (unsigned)bytes);
+
+  UTIL_LCD_Clear(SSD1315_COLOR_WHITE);
+  bytes = Refresh();
+  Update("screen filled", bytes);
+  CHECK(bytes == (6U + FRAME_SIZE), "screen filled: %u bytes", (unsigned)bytes);
+  UTIL_LCD_Clear(SSD1315_COLOR_BLACK);
+  (void)Refresh();
+}
+
+/* Random drawings, the display shall follow whatever the refresh sequence */
+static void Random_Updates(long NbSteps)
+{
+  static const char * texts[] = { "Zb Shutter Demo", "Network Join", "Up", "Down", "Stop", "42%", "" };
+  static sFONT * fonts[] = { &Font8, &Font12, &Font16, &Font20, &Font24 };
+  uint64_t bytes = 0U;
+  long     failures_start = failures;
+  long     step;
+  uint32_t op, nb_ops, x, y;
+
+  for (step = 0; step < NbSteps; step++)
+  {
+    nb_ops = 1U + (Sim_Random() % 4U);
+    for (op = 0U; op < nb_ops; op++)
+    {
+      x = Sim_Random() % (COLUMN_NB + 8U);
+      y = Sim_Random() % (64U + 8U);
+      switch (Sim_Random() % 4U)
+      {
+        case 0:
+          SSD1315_SetPixel(&lcd_obj, x, y, ((Sim_Random() & 1U) != 0U) ? SSD1315_COLOR_WHITE : SSD1315_COLOR_BLACK);
+          break;
+
+        case 1:
+          if ((x < COLUMN_NB) && (y < 64U))
+          {
+            SSD1315_FillRect(&lcd_obj, x, y, 1U + (Sim_Random() % (COLUMN_NB - x)), 1U + (Sim_Random() % (64U - y)),
+                             ((Sim_Random() & 1U) != 0U) ? SSD1315_COLOR_WHITE : SSD1315_COLOR_BLACK);
+          }
+          break;
+
+        default:
+          UTIL_LCD_SetFont(fonts[Sim_Random() % (sizeof(fonts) / sizeof(fonts[0]))]);
+          UTIL_LCD_SetTextColor(((Sim_Random() & 1U) != 0U) ? SSD1315_COLOR_WHITE : SSD1315_COLOR_BLACK);
+          UTIL_LCD_SetBackColor(((Sim_Random() & 1U) != 0U) ? SSD1315_COLOR_WHITE : SSD1315_COLOR_BLACK);
+          UTIL_LCD_DisplayStringAt(x % COLUMN_NB, y % 64U, (uint8_t *)texts[Sim_Random() % (sizeof(texts) / sizeof(texts[0]))],
+                                   LEFT_MODE);
+          break;
+      }
+    }
+    switch (Sim_Random() % 5U)
+    {
+      case 0:
+        bytes += Refresh_Async_Failed();
+        break;
+
+      case 1:
+      case 2:
+        bytes += Refresh();
+        break;
+
+      default:
+        bytes += Refresh_Async();
+        break;
+    }
+    if (failures != failures_start)
+    {
+      fprintf(stderr, "  random step %ld\n", step);
+      break;
+    }
+  }
+  printf("  %ld random updates: %.1f bytes per refresh (full refresh %u)\n", NbSteps,
+         (NbSteps != 0) ? ((double)bytes / NbSteps) : 0.0, (unsigned)FULL_REFRESH_BYTES);
+  (void)Refresh_Async();
+}
+
+static void Usage(void)
+{
+  fprintf(stderr, "usage: ssd1315_refresh [-n random updates]\n");
+  exit(2);
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char * argv[])
+{
+  SSD1315_IO_t io = { Sim_Ok, Sim_Ok, Sim_WriteReg, Sim_ReadReg, Sim_GetTick };
+  long     nb_steps = 20000;
+  int      arg;
+
+  for (arg = 1; arg < argc; arg++)
+  {
+    if ((strcmp(argv[arg], "-n") == 0) && ((arg + 1) < argc))
+    {
+      nb_steps = atol(argv[++arg]);
+    }
+    else
+    {
+      Usage();
+    }
+  }
+
+  /* Random content in the display RAM, the init shall send the whole frame buffer */
+  for (arg = 0; arg < (int)FRAME_SIZE; arg++)
+  {
+    sim_ram[arg / COLUMN_NB][arg % COLUMN_NB] = (uint8_t)Sim_Random();
+  }
+  CHECK(SSD1315_RegisterBusIO(&lcd_obj, &io) == SSD1315_OK, "bus registration failed");
+  CHECK(SSD1315_Init(&lcd_obj, SSD1315_FORMAT_DEFAULT, SSD1315_ORIENTATION_LANDSCAPE) == SSD1315_OK, "init failed");
+  Check_Ram("init");
+  UTIL_LCD_SetFuncDriver(&lcd_driver);
+
+  Typical_Updates();
+  Random_Updates(nb_steps);
+
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
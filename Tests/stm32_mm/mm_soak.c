@@ -0,0 +1,457 @@
+/**
+  ******************************************************************************
+  * @file    mm_soak.c
+  * @author  Zigbee Application Team
+  * @brief   Soak test of the memory manager utility.
+  *          The unmodified stm32_mm.c serves random allocations and releases
+  *          of the buffer sizes seen in the Zigbee applications. After each
+  *          operation the whole heap is walked: block chaining, merging,
+  *          free lists, bitmaps and statistics shall be consistent, the
+  *          buffers shall keep their content, and an allocation shall only
+  *          fail when no free block is large enough. The free list nodes
+ *          read by each allocation and the neighbours merged by each
+ *          release are counted, their worst case is printed.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Code under test, built as is to walk the heap */
+#include "stm32_mm.c"
+
+/* Private defines -----------------------------------------------------------*/
+#define SOAK_BUFFERS_MAX        256U
+#define SOAK_POOL_MAX           ( 256U * 1024U )
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint8_t   *p_data;
+  size_t    size;
+  uint8_t   seed;
+} Soak_Buffer_t;
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t        soak_pool[SOAK_POOL_MAX + portBYTE_ALIGNMENT];
+static Soak_Buffer_t  soak_buffers[SOAK_BUFFERS_MAX];
+static uint32_t       soak_rng = 0x6C8E9CF5U;
+static BlockLink_t    *soak_first_block;
+static size_t         soak_live;
+static size_t         soak_failed;
+static size_t         soak_failed_in_range;
+static size_t         soak_max_failed_free;
+static uint32_t       soak_max_frag;
+static uint64_t       soak_allocs;
+static uint64_t       soak_walks;           /* Allocations that walked a list */
+static uint64_t       soak_nodes;
+static uint32_t       soak_max_nodes;
+static uint32_t       soak_max_merged;
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t Soak_Random(void)
+{
+  soak_rng ^= soak_rng << 13;
+  soak_rng ^= soak_rng >> 17;
+  soak_rng ^= soak_rng << 5;
+  return soak_rng;
+}
+
+/* Block size of an allocation, as computed by UTIL_MM_GetBuffer */
+static size_t Soak_BlockSize(size_t size)
+{
+  size += xHeapStructSize;
+  size = (size + portBYTE_ALIGNMENT_MASK) & ~((size_t)portBYTE_ALIGNMENT_MASK);
+  return MAX(size, heapMINIMUM_BLOCK_SIZE);
+}
+
+/* Buffer sizes: IPCC-like, ZCL-like and large buffers, sometimes out of range */
+static size_t Soak_RandomSize(void)
+{
+  uint32_t kind = Soak_Random() % 100U;
+
+  if (kind < 45U)
+  {
+    return 8U + (Soak_Random() % 57U);
+  }
+  if (kind < 85U)
+  {
+    return 32U + (Soak_Random() % 269U);
+  }
+  if (kind < 99U)
+  {
+    return 300U + (Soak_Random() % 1001U);
+  }
+  return ((Soak_Random() & 1U) != 0U) ? 0U : (heapMAXIMUM_BLOCK_SIZE + 1U + (Soak_Random() % 64U));
+}
+
+static void Soak_Fill(const Soak_Buffer_t * p_buf)
+{
+  size_t i;
+
+  for (i = 0U; i < p_buf->size; i++)
+  {
+    p_buf->p_data[i] = (uint8_t)(p_buf->seed + (i * 7U));
+  }
+}
+
+static bool Soak_Intact(const Soak_Buffer_t * p_buf)
+{
+  size_t i;
+
+  for (i = 0U; i < p_buf->size; i++)
+  {
+    if (p_buf->p_data[i] != (uint8_t)(p_buf->seed + (i * 7U)))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Free list nodes read by prvSearchSuitableBlock for a block of xWantedSize
+ * bytes, the block it finds is given and whether a list was walked. Only the fallback walks a list, the
+ * rounded-up search reads the head of a list found with the bitmaps */
+static uint32_t Soak_SearchNodes(size_t xWantedSize, BlockLink_t ** ppxFound, bool * p_walked)
+{
+  BlockLink_t *pxBlock;
+  size_t xRoundedSize = xWantedSize;
+  uint32_t ulFl, ulSl, ulNodes = 0U;
+
+  if (xRoundedSize >= heapSMALL_BLOCK_SIZE)
+  {
+    xRoundedSize += ((size_t)1 << (prvFls((uint32_t)xRoundedSize) - heapSL_INDEX_COUNT_LOG2)) - 1U;
+  }
+  if (xRoundedSize <= heapMAXIMUM_BLOCK_SIZE)
+  {
+    for (prvMappingInsert(xRoundedSize, &ulFl, &ulSl); ulFl < heapFL_INDEX_COUNT; ulFl++, ulSl = 0U)
+    {
+      for (; ulSl < heapSL_INDEX_COUNT; ulSl++)
+      {
+        if (pxFreeLists[ulFl][ulSl] != NULL)
+        {
+          *ppxFound = pxFreeLists[ulFl][ulSl];
+          *p_walked = false;
+          return 1U;
+        }
+      }
+    }
+  }
+
+  prvMappingInsert(xWantedSize, &ulFl, &ulSl);
+  for (pxBlock = pxFreeLists[ulFl][ulSl]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock)
+  {
+    ulNodes++;
+    if (pxBlock->xBlockSize >= xWantedSize)
+    {
+      break;
+    }
+  }
+  *ppxFound = pxBlock;
+  *p_walked = true;
+  return ulNodes;
+}
+
+/* True when the free block is the one of its size class list */
+static bool Soak_InList(const BlockLink_t * pxBlock)
+{
+  const BlockLink_t *pxItem;
+  uint32_t ulFl, ulSl;
+
+  prvMappingInsert(pxBlock->xBlockSize, &ulFl, &ulSl);
+  for (pxItem = pxFreeLists[ulFl][ulSl]; pxItem != NULL; pxItem = pxItem->pxNextFreeBlock)
+  {
+    if (pxItem == pxBlock)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Walks the heap, returns the first inconsistency found or NULL. The largest free block is given */
+static const char * Soak_CheckHeap(size_t * p_largest)
+{
+  BlockLink_t *pxBlock, *pxPrev = NULL, *pxItem;
+  size_t xSize, xFreeBytes = 0U, xFreeBlocks = 0U, xListed = 0U, xLargest = 0U;
+  uint32_t ulFl, ulSl;
+  bool bPrevFree = false;
+
+  for (pxBlock = soak_first_block; pxBlock != pxEnd; pxBlock = heapNEXT_PHYS_BLOCK(pxBlock))
+  {
+    xSize = pxBlock->xBlockSize & ~xBlockAllocatedBit;
+    if ((xSize < heapMINIMUM_BLOCK_SIZE) || ((xSize & portBYTE_ALIGNMENT_MASK) != 0U)
+        || (((uint8_t *)pxBlock + xSize) > (uint8_t *)pxEnd))
+    {
+      return "bad block size";
+    }
+    if (pxBlock->pxPrevPhysBlock != pxPrev)
+    {
+      return "bad previous block link";
+    }
+    if (heapIS_FREE(pxBlock))
+    {
+      if (bPrevFree)
+      {
+        return "two adjacent free blocks";
+      }
+      if (!Soak_InList(pxBlock))
+      {
+        return "free block out of its list";
+      }
+      xFreeBytes += xSize;
+      xFreeBlocks++;
+      xLargest = MAX(xLargest, xSize);
+    }
+    bPrevFree = heapIS_FREE(pxBlock);
+    pxPrev = pxBlock;
+  }
+  if (pxEnd->pxPrevPhysBlock != pxPrev)
+  {
+    return "bad end block link";
+  }
+  if (xFreeBytes != xFreeBytesRemaining)
+  {
+    return "free bytes count differs";
+  }
+
+  for (ulFl = 0U; ulFl < heapFL_INDEX_COUNT; ulFl++)
+  {
+    if (((ulFlBitmap >> ulFl) & 1U) != (ucSlBitmap[ulFl] != 0U))
+    {
+      return "first level bitmap differs";
+    }
+    for (ulSl = 0U; ulSl < heapSL_INDEX_COUNT; ulSl++)
+    {
+      if ((((uint32_t)ucSlBitmap[ulFl] >> ulSl) & 1U) != (pxFreeLists[ulFl][ulSl] != NULL))
+      {
+        return "second level bitmap differs";
+      }
+      for (pxItem = pxFreeLists[ulFl][ulSl]; pxItem != NULL; pxItem = pxItem->pxNextFreeBlock)
+      {
+        if (!heapIS_FREE(pxItem) || ((pxItem->pxNextFreeBlock != NULL) && (pxItem->pxNextFreeBlock->pxPrevFreeBlock != pxItem)))
+        {
+          return "bad free list links";
+        }
+        xListed++;
+      }
+    }
+  }
+  if (xListed != xFreeBlocks)
+  {
+    return "free lists and heap differ";
+  }
+
+  *p_largest = xLargest;
+  return NULL;
+}
+
+static const char * Soak_CheckStats(size_t largest)
+{
+  UTIL_MM_Stats_t stats;
+  size_t blocks = 0U;
+  uint32_t i;
+
+  UTIL_MM_GetStats(&stats);
+  for (i = 0U; i < UTIL_MM_HISTOGRAM_NB; i++)
+  {
+    blocks += stats.xFreeBlocksHistogram[i];
+  }
+  if ((blocks != stats.xNumberOfFreeBlocks) || (stats.xSizeOfLargestFreeBlockInBytes != largest)
+      || (stats.xAvailableHeapSpaceInBytes != xFreeBytesRemaining))
+  {
+    return "free block statistics differ";
+  }
+  if (((stats.xNumberOfSuccessfulAllocations - stats.xNumberOfSuccessfulFrees) != soak_live)
+      || (stats.xNumberOfFailedAllocations != soak_failed)
+      || (stats.xMinimumEverFreeBytesRemaining > stats.xAvailableHeapSpaceInBytes)
+      || (stats.ucFragmentationIndex > 100U))
+  {
+    return "allocation statistics differ";
+  }
+  soak_max_frag = MAX(soak_max_frag, stats.ucFragmentationIndex);
+  return NULL;
+}
+
+static long Soak_Run(size_t pool_size, uint32_t offset, long nb_ops)
+{
+  Soak_Buffer_t *p_buf;
+  const char *p_error;
+  size_t largest = 0U, size;
+  BlockLink_t *pxFound, *pxBlock;
+  uint32_t nodes, merged;
+  bool walked;
+  long op, failures = 0;
+  uint32_t i;
+
+  memset(soak_buffers, 0, sizeof(soak_buffers));
+  soak_live = 0U;
+  soak_failed = 0U;
+  soak_failed_in_range = 0U;
+  soak_max_failed_free = 0U;
+  soak_max_frag = 0U;
+  soak_allocs = 0U;
+  soak_walks = 0U;
+  soak_nodes = 0U;
+  soak_max_nodes = 0U;
+  soak_max_merged = 0U;
+
+  UTIL_MM_Init(&soak_pool[offset], (uint32_t)pool_size);
+  soak_first_block = pxEnd;
+  while (soak_first_block->pxPrevPhysBlock != NULL)
+  {
+    soak_first_block = soak_first_block->pxPrevPhysBlock;
+  }
+
+  for (op = 0; (op < nb_ops) && (failures < 10); op++)
+  {
+    p_buf = &soak_buffers[Soak_Random() % SOAK_BUFFERS_MAX];
+    if (p_buf->p_data != NULL)
+    {
+      if (!Soak_Intact(p_buf))
+      {
+        fprintf(stderr, "  op %ld: buffer of %u bytes overwritten\n", op, (unsigned)p_buf->size);
+        failures++;
+      }
+      pxBlock = (BlockLink_t *)(p_buf->p_data - xHeapStructSize);
+      merged  = ((pxBlock->pxPrevPhysBlock != NULL) && heapIS_FREE(pxBlock->pxPrevPhysBlock)) ? 1U : 0U;
+      merged += heapIS_FREE(heapNEXT_PHYS_BLOCK(pxBlock)) ? 1U : 0U;
+      soak_max_merged = MAX(soak_max_merged, merged);
+      UTIL_MM_ReleaseBuffer(p_buf->p_data);
+      p_buf->p_data = NULL;
+      soak_live--;
+    }
+    else
+    {
+      size = Soak_RandomSize();
+      pxFound = NULL;
+      if ((size != 0U) && (size <= heapMAXIMUM_BLOCK_SIZE) && (Soak_BlockSize(size) <= xFreeBytesRemaining))
+      {
+        nodes = Soak_SearchNodes(Soak_BlockSize(size), &pxFound, &walked);
+        soak_allocs++;
+        soak_walks += walked ? 1U : 0U;
+        soak_nodes += nodes;
+        soak_max_nodes = MAX(soak_max_nodes, nodes);
+      }
+      p_buf->p_data = UTIL_MM_GetBuffer(size);
+      if ((pxFound != NULL) && (p_buf->p_data != ((uint8_t *)pxFound + xHeapStructSize)))
+      {
+        fprintf(stderr, "  op %ld: %u bytes served from %p instead of %p\n", op, (unsigned)size,
+                (void *)p_buf->p_data, (void *)((uint8_t *)pxFound + xHeapStructSize));
+        failures++;
+      }
+      if (p_buf->p_data == NULL)
+      {
+        soak_failed++;
+        if ((size != 0U) && (size <= heapMAXIMUM_BLOCK_SIZE))
+        {
+          (void)Soak_CheckHeap(&largest);
+          if (largest >= Soak_BlockSize(size))
+          {
+            fprintf(stderr, "  op %ld: %u bytes refused with a free block of %u bytes\n", op, (unsigned)size,
+                    (unsigned)largest);
+            failures++;
+          }
+          soak_failed_in_range++;
+          soak_max_failed_free = MAX(soak_max_failed_free, xFreeBytesRemaining);
+        }
+      }
+      else
+      {
+        if ((size == 0U) || (size > heapMAXIMUM_BLOCK_SIZE) || ((((size_t)p_buf->p_data) & portBYTE_ALIGNMENT_MASK) != 0U))
+        {
+          fprintf(stderr, "  op %ld: bad buffer %p for %u bytes\n", op, (void *)p_buf->p_data, (unsigned)size);
+          failures++;
+        }
+        p_buf->size = size;
+        p_buf->seed = (uint8_t)Soak_Random();
+        Soak_Fill(p_buf);
+        soak_live++;
+      }
+    }
+
+    p_error = Soak_CheckHeap(&largest);
+    if (p_error == NULL)
+    {
+      p_error = Soak_CheckStats(largest);
+    }
+    if (p_error != NULL)
+    {
+      fprintf(stderr, "  op %ld: %s\n", op, p_error);
+      failures++;
+    }
+  }
+
+  /* Once all is released, the heap is back to a single free block */
+  for (i = 0U; i < SOAK_BUFFERS_MAX; i++)
+  {
+    if (soak_buffers[i].p_data != NULL)
+    {
+      UTIL_MM_ReleaseBuffer(soak_buffers[i].p_data);
+      soak_live--;
+    }
+  }
+  UTIL_MM_ReleaseBuffer(NULL);
+  if ((Soak_CheckHeap(&largest) != NULL) || (soak_first_block->xBlockSize != xFreeBytesRemaining)
+      || (heapNEXT_PHYS_BLOCK(soak_first_block) != pxEnd))
+  {
+    fprintf(stderr, "  heap not merged back in a single block\n");
+    failures++;
+  }
+
+  printf("  pool %6u offset %u: %ld ops, %u failed allocations, %u of a valid size with up to %u free bytes,"
+         " fragmentation index up to %u\n", (unsigned)pool_size, (unsigned)offset, nb_ops, (unsigned)soak_failed,
+         (unsigned)soak_failed_in_range, (unsigned)soak_max_failed_free, (unsigned)soak_max_frag);
+  printf("    free list nodes read per allocation: %.2f mean, %u worst, %llu of %llu allocations walked a list;"
+         " release merges up to %u neighbours\n", (soak_allocs != 0U) ? ((double)soak_nodes / soak_allocs) : 0.0,
+         (unsigned)soak_max_nodes, (unsigned long long)soak_walks, (unsigned long long)soak_allocs,
+         (unsigned)soak_max_merged);
+  return failures;
+}
+
+static void Usage(void)
+{
+  fprintf(stderr, "usage: mm_soak [-n operations]\n");
+  exit(2);
+}
+
+int main(int argc, char * argv[])
+{
+  long nb_ops = 300000;
+  long failures = 0;
+  int arg;
+
+  for (arg = 1; arg < argc; arg++)
+  {
+    if ((strcmp(argv[arg], "-n") == 0) && ((arg + 1) < argc))
+    {
+      nb_ops = atol(argv[++arg]);
+    }
+    else
+    {
+      Usage();
+    }
+  }
+
+  /* Small pool always close to full, pool of the applications, misaligned pool, pool larger than the largest
+   * block */
+  failures += Soak_Run(4096U, 0U, nb_ops);
+  failures += Soak_Run(24U * 1024U, 0U, nb_ops);
+  failures += Soak_Run(24U * 1024U, 3U, nb_ops);
+  failures += Soak_Run(SOAK_POOL_MAX, 0U, nb_ops);
+
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+/**
+  ******************************************************************************
+  * @file    app_conf.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the application configuration for the
+  *          deferred log test, same values as the Zigbee_Roller_Shutter application
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef APP_CONF_H
+#define APP_CONF_H
+
+#include "stm32wbxx_hal.h"
+
+#define CFG_DEBUG_TRACE                         1
+#define APPLI_PRINT_FILE_FUNC_LINE              0
+
+#define LOG_DEFERRED_ENABLE                     1U
+#define LOG_DEFERRED_BUFFER_SIZE                512U
+
+#define APPLI_CONFIG_LOG_LEVEL                  LOG_LEVEL_INFO
+#define APPLI_CONFIG_ZB_LOG_LEVEL               LOG_LEVEL_DEBG
+
+/* Scheduler */
+typedef enum
+{
+  CFG_TASK_LOG_FLUSH,
+  CFG_TASK_NBR
+} CFG_IdleTask_Id_t;
+
+typedef enum
+{
+  CFG_SCH_PRIO_0,
+  CFG_SCH_PRIO_1,
+  CFG_PRIO_NBR,
+} CFG_SCH_Prio_Id_t;
+
+#endif /* APP_CONF_H */
@@ -0,0 +1,79 @@
+/**
+  ******************************************************************************
+  * @file    cmsis_compiler.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the exclusive accesses of the log ring,
+  *          a store fails when the test simulates an interrupt since the load
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef CMSIS_COMPILER_H
+#define CMSIS_COMPILER_H
+
+#include <stdint.h>
+
+/* Number of exclusive stores to fail, interrupt taken after the next
+ * exclusive loads, see log_deferred.c */
+extern uint32_t Sim_Strex_Fail;
+extern uint32_t Sim_Ldrex_Skip;
+extern void     (*Sim_Ldrex_Irq)(void);
+extern uint8_t  Sim_Exclusive;
+
+static inline uint32_t __LDREXW(volatile uint32_t *addr)
+{
+  uint32_t value = *addr;
+  void     (*irq)(void) = Sim_Ldrex_Irq;
+
+  Sim_Exclusive = 1U;
+  if (irq != NULL)
+  {
+    if (Sim_Ldrex_Skip != 0U)
+    {
+      Sim_Ldrex_Skip--;
+    }
+    else
+    {
+      /* The exception return clears the exclusive monitor */
+      Sim_Ldrex_Irq = NULL;
+      irq();
+      Sim_Exclusive = 0U;
+    }
+  }
+  return value;
+}
+
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t *addr)
+{
+  if (Sim_Strex_Fail != 0U)
+  {
+    Sim_Strex_Fail--;
+    Sim_Exclusive = 0U;
+    return 1U;
+  }
+  if (Sim_Exclusive == 0U)
+  {
+    return 1U;
+  }
+  Sim_Exclusive = 0U;
+  *addr = value;
+  return 0U;
+}
+
+static inline void __CLREX(void)
+{
+  Sim_Exclusive = 0U;
+}
+
+#define __DMB()                                 __asm__ volatile("" ::: "memory")
+
+#endif /* CMSIS_COMPILER_H */
@@ -0,0 +1,27 @@
+/**
+  ******************************************************************************
+  * @file    dbg_trace.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the trace header, only the file name
+  *          extraction is used by the logs
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __DBG_TRACE_H
+#define __DBG_TRACE_H
+
+#include <string.h>
+
+const char *DbgTraceGetFileName(const char *fullpath);
+
+#endif /* __DBG_TRACE_H */
@@ -0,0 +1,29 @@
+/**
+  ******************************************************************************
+  * @file    stm32wbxx_hal.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the HAL services used by the logs
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef STM32WBxx_HAL_H
+#define STM32WBxx_HAL_H
+
+#include <stdint.h>
+#include "cmsis_compiler.h"
+
+#define UNUSED(X)                               (void)X
+
+uint32_t HAL_GetTick(void);
+
+#endif /* STM32WBxx_HAL_H */
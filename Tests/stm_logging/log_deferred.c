@@ -0,0 +1,662 @@
+/**
+  ******************************************************************************
+  * @file    log_deferred.c
+  * @author  Zigbee Application Team
+  * @brief   Check of the deferred application logs.
+  *          The unmodified stm_logging.c records the logs in its ring and
+  *          formats them at the flush. The output shall be the one of the
+  *          synchronous APP_ZB_DBG macro it replaces, in the order of the
+  *          calls, with the logs that cannot be deferred, a full ring, logs
+  *          from interrupts and a random sequence of logs and flushes. The
+  *          host time of a log at the call site and at the flush is printed.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* The logs are output to the capture of the test */
+int Sim_Printf(const char *format, ...);
+#define printf Sim_Printf
+
+/* Code under test, built as is to reach the ring and the synchronous output */
+#include "stm_logging.c"
+
+#undef printf
+
+/* Private defines -----------------------------------------------------------*/
+#define OUT_SIZE                (1U << 18)
+#define LINE_SIZE               512U
+#define RUN_NB                  5U        /* Timed runs, the fastest one is kept */
+#define BENCH_BATCH             20U       /* Logs recorded between two flushes */
+
+/* Synchronous APP_ZB_DBG before the deferred logs, the reference output */
+#define APP_ZB_DBG_SYNC(...)                                                            \
+  {                                                                                     \
+    char const * name = DbgTraceGetFileName(__FILE__);                                  \
+    Sim_Printf("[M4 APPLICATION] \x1b[38;5;%dm[",( (name[4] + name[5] * 8) % 115) + 117); \
+    for (int i=0; i < strlen(name) - 2; i++)                                            \
+    {                                                                                   \
+      if (name[i] >= 'a' && name[i] <= 'z')                                             \
+      {                                                                                 \
+        Sim_Printf("%c", name[i] - ' ' );                                               \
+      }                                                                                 \
+      else                                                                              \
+      {                                                                                 \
+        Sim_Printf("%c", name[i]);                                                      \
+      }                                                                                 \
+   }                                                                                    \
+   Sim_Printf("]\x1B[m ");                                                              \
+   Sim_Printf(__VA_ARGS__);                                                             \
+   Sim_Printf("\n");                                                                    \
+  }
+
+/* Private variables ---------------------------------------------------------*/
+uint32_t                    Sim_Strex_Fail;
+uint32_t                    Sim_Ldrex_Skip;
+void                        (*Sim_Ldrex_Irq)(void);
+uint8_t                     Sim_Exclusive;
+
+static long                 failures;
+static uint32_t             sim_rng = 0x2545F491U;
+
+/* Output capture */
+static char                 out[OUT_SIZE];
+static uint32_t             out_len;
+static bool                 out_on;
+
+/* Sequencer */
+static void                 (*sim_flush_task)(void);
+static bool                 sim_flush_pending;
+
+/* Interrupts simulated when a record is reserved, or during an output */
+static void                 (*sim_tick_irq)(void);
+static void                 (*sim_printf_irq)(void);
+
+/* Formats of the random logs, the extra arguments are ignored */
+static const char * const   random_formats[] =
+{
+  "r0",
+  "r1 %u",
+  "r2 %u %X",
+  "r3 %u %x %d",
+  "r4 %u %u %u %u",
+  "r5 %02x%02x%02x%02x%02x",
+  "r6 %u %u %u %u %u %u",
+  "r7 %u %u %u %u %u %u %u",
+  "r8 %u %u %u %u %u %u %u %u",
+  "rs %s",
+};
+
+/* Private functions ---------------------------------------------------------*/
+#define CHECK(cond, ...) \
+  do \
+  { \
+    if (!(cond)) \
+    { \
+      if (failures < 20) \
+      { \
+        fprintf(stderr, "  "); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+      } \
+      failures++; \
+    } \
+  } while (0)
+
+static uint32_t Sim_Random(void)
+{
+  sim_rng ^= sim_rng << 13;
+  sim_rng ^= sim_rng >> 17;
+  sim_rng ^= sim_rng << 5;
+  return sim_rng;
+}
+
+static uint64_t Host_Ns(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+/* Simulated platform --------------------------------------------------------*/
+int Sim_Printf(const char *format, ...)
+{
+  char    line[LINE_SIZE];
+  va_list args;
+  int     length;
+  void    (*irq)(void) = sim_printf_irq;
+
+  va_start(args, format);
+  length = vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+
+  if (out_on)
+  {
+    CHECK((out_len + (uint32_t)length) < OUT_SIZE, "output capture full");
+    if ((out_len + (uint32_t)length) < OUT_SIZE)
+    {
+      memcpy(&out[out_len], line, (size_t)length);
+      out_len += (uint32_t)length;
+      out[out_len] = '\0';
+    }
+  }
+
+  if (irq != NULL)
+  {
+    sim_printf_irq = NULL;
+    irq();
+  }
+  return length;
+}
+
+/* Called between the reservation and the commit of a record */
+uint32_t HAL_GetTick(void)
+{
+  void (*irq)(void) = sim_tick_irq;
+
+  if (irq != NULL)
+  {
+    sim_tick_irq = NULL;
+    irq();
+  }
+  return 1234U;
+}
+
+const char *DbgTraceGetFileName(const char *fullpath)
+{
+  const char *ret = fullpath;
+
+  if (strrchr(fullpath, '\\') != NULL)
+  {
+    ret = strrchr(fullpath, '\\') + 1;
+  }
+  else if (strrchr(fullpath, '/') != NULL)
+  {
+    ret = strrchr(fullpath, '/') + 1;
+  }
+
+  return ret;
+}
+
+void UTIL_SEQ_RegTask(UTIL_SEQ_bm_t TaskId_bm, uint32_t Flags, void (*Task)(void))
+{
+  (void)Flags;
+  CHECK(TaskId_bm == (1U << CFG_TASK_LOG_FLUSH), "task 0x%X registered", (unsigned)TaskId_bm);
+  sim_flush_task = Task;
+}
+
+void UTIL_SEQ_SetTask(UTIL_SEQ_bm_t TaskId_bm, uint32_t Task_Prio)
+{
+  (void)Task_Prio;
+  CHECK(TaskId_bm == (1U << CFG_TASK_LOG_FLUSH), "task 0x%X set", (unsigned)TaskId_bm);
+  sim_flush_pending = true;
+}
+
+/* Output capture ------------------------------------------------------------*/
+static void Out_Start(void)
+{
+  out_len = 0U;
+  out[0]  = '\0';
+  out_on  = true;
+}
+
+/* Returns a copy of the output since Out_Start(), to be freed */
+static char * Out_Take(void)
+{
+  char *copy = malloc(out_len + 1U);
+
+  memcpy(copy, out, out_len + 1U);
+  out_len = 0U;
+  out[0]  = '\0';
+  return copy;
+}
+
+static void Check_Same(const char * pName, const char * pRef, const char * pOut)
+{
+  if (strcmp(pRef, pOut) != 0)
+  {
+    CHECK(false, "%s: output differs", pName);
+    if (failures <= 20)
+    {
+      fprintf(stderr, "    expected: \"%s\"\n    output  : \"%s\"\n", pRef, pOut);
+    }
+  }
+}
+
+/* Synchronous logApplication, formatted at once as before the ring */
+static void Sync_Application(appliLogLevel_t aLogLevel, appliLogRegion_t aLogRegion, const char *aFormat, ...)
+{
+  va_list paramList;
+
+  va_start(paramList, aFormat);
+  logOutput(aLogLevel, aLogRegion, NULL, aFormat, paramList);
+  va_end(paramList);
+}
+
+/* Checks --------------------------------------------------------------------*/
+/* Same output for the synchronous macro and the deferred one */
+#define CHECK_OUTPUT(...) \
+  do \
+  { \
+    char *ref; \
+    char *got; \
+    Out_Start(); \
+    APP_ZB_DBG_SYNC(__VA_ARGS__); \
+    ref = Out_Take(); \
+    APP_ZB_DBG(__VA_ARGS__); \
+    logDeferredFlush(); \
+    got = Out_Take(); \
+    out_on = false; \
+    Check_Same(#__VA_ARGS__, ref, got); \
+    free(ref); \
+    free(got); \
+  } while (0)
+
+static void Check_Formats(void)
+{
+  char *ref, *got;
+
+  CHECK_OUTPUT("Control Level: 0x%X in %d ms", 0x80, 500);
+  CHECK_OUTPUT("Motor %s", "stop");
+  CHECK_OUTPUT("pos %3d%% %c", 42, 'x');
+  CHECK_OUTPUT("no argument");
+  CHECK_OUTPUT("%*d|%-4u|%04x", 6, -42, 7U, 0xBEEFU);
+  CHECK_OUTPUT("%d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8);
+  CHECK_OUTPUT("%d %d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8, 9);
+  CHECK_OUTPUT("%lld", 1LL << 40);
+  CHECK_OUTPUT("%.2f", 1.5);
+
+  /* logApplication */
+  Out_Start();
+  Sync_Application(LOG_LEVEL_INFO, APPLI_LOG_REGION_ZIGBEE_API, "Level %d of %u", -3, 10U);
+  Sync_Application(LOG_LEVEL_CRIT, APPLI_LOG_REGION_GENERAL, "Device %s", "lost");
+  ref = Out_Take();
+  logApplication(LOG_LEVEL_INFO, APPLI_LOG_REGION_ZIGBEE_API, "Level %d of %u", -3, 10U);
+  logApplication(LOG_LEVEL_CRIT, APPLI_LOG_REGION_GENERAL, "Device %s", "lost");
+  logDeferredFlush();
+  got = Out_Take();
+  out_on = false;
+  Check_Same("logApplication", ref, got);
+  free(ref);
+  free(got);
+
+  /* The logs that cannot be deferred come after the recorded ones */
+  Out_Start();
+  APP_ZB_DBG_SYNC("first %d", 1);
+  APP_ZB_DBG_SYNC("second %s", "at once");
+  APP_ZB_DBG_SYNC("third %d", 3);
+  ref = Out_Take();
+  sim_flush_pending = false;
+  APP_ZB_DBG("first %d", 1);
+  CHECK(sim_flush_pending, "flush task not set by a record");
+  CHECK(out_len == 0U, "recorded log output at once");
+  APP_ZB_DBG("second %s", "at once");
+  APP_ZB_DBG("third %d", 3);
+  sim_flush_task();
+  got = Out_Take();
+  out_on = false;
+  Check_Same("order", ref, got);
+  free(ref);
+  free(got);
+
+  /* Filtered out before any recording */
+  logSetLevel(APPLI_LOG_REGION_GENERAL, LOG_LEVEL_WARN);
+  Out_Start();
+  sim_flush_pending = false;
+  APP_ZB_DBG("filtered %d", 1);
+  APP_ZB_DBG("filtered %s", "too");
+  logDeferredFlush();
+  CHECK((out_len == 0U) && (sim_flush_pending == false), "filtered log: %u bytes output", (unsigned)out_len);
+  out_on = false;
+  logSetLevel(APPLI_LOG_REGION_GENERAL, APPLI_CONFIG_LOG_LEVEL);
+}
+
+/* Full ring : the logs that do not fit are counted and reported first */
+static void Check_Full(void)
+{
+  uint32_t record = LOG_DEFERRED_HEADER_SIZE + 2U;
+  uint32_t fit = LOG_DEFERRED_BUFFER_SIZE / record;
+  uint32_t total = fit + 50U;
+  uint32_t i;
+  char     expected[64];
+  char     *ref, *got;
+
+  Out_Start();
+  snprintf(expected, sizeof(expected), "%u deferred logs lost\r\n", (unsigned)(total - fit));
+  Sim_Printf("%s", expected);
+  for (i = 0U; i < fit; i++)
+  {
+    APP_ZB_DBG_SYNC("full %u %u", i, i * 3U);
+  }
+  ref = Out_Take();
+  for (i = 0U; i < total; i++)
+  {
+    APP_ZB_DBG("full %u %u", i, i * 3U);
+  }
+  CHECK(log_lost == (total - fit), "%u logs lost instead of %u", (unsigned)log_lost, (unsigned)(total - fit));
+  logDeferredFlush();
+  got = Out_Take();
+  out_on = false;
+  Check_Same("full ring", ref, got);
+  CHECK(log_lost == 0U, "lost count not cleared");
+  free(ref);
+  free(got);
+}
+
+static void Irq_Log_Lost(void)
+{
+  APP_ZB_DBG("lost %d", 4);
+}
+
+/* Lost count updated by an interrupt during its update by a flush, or by
+ * another lost log */
+static void Check_Lost_Interrupted(void)
+{
+  uint32_t record = LOG_DEFERRED_HEADER_SIZE + 1U;
+  uint32_t fit = LOG_DEFERRED_BUFFER_SIZE / record;
+  uint32_t i;
+  char     expected[64];
+
+  logDeferredFlush();
+  for (i = 0U; i < (fit + 3U); i++)
+  {
+    APP_ZB_DBG("fill %u", i);
+  }
+  CHECK(log_lost == 3U, "%u logs lost instead of 3", (unsigned)log_lost);
+
+  /* The ring is still full when the flush takes the lost count */
+  Out_Start();
+  Sim_Ldrex_Irq = Irq_Log_Lost;
+  logDeferredFlush();
+  CHECK(Sim_Ldrex_Irq == NULL, "flush without exclusive access to the lost count");
+  snprintf(expected, sizeof(expected), "3 deferred logs lost\r\n");
+  CHECK(strncmp(out, expected, strlen(expected)) == 0, "lost logs of the flush: \"%.30s\"", out);
+  CHECK(log_lost == 1U, "lost log of the interrupt counted %u times", (unsigned)log_lost);
+
+  /* A lost log preempted on the lost count by another lost log: the first
+   * exclusive load is on the ring head */
+  for (i = 0U; i < fit; i++)
+  {
+    APP_ZB_DBG("fill %u", i);
+  }
+  Sim_Ldrex_Skip = 1U;
+  Sim_Ldrex_Irq  = Irq_Log_Lost;
+  APP_ZB_DBG("fill %u", i);
+  CHECK(Sim_Ldrex_Irq == NULL, "lost log without exclusive access to the lost count");
+  CHECK(log_lost == 3U, "%u logs lost instead of 3", (unsigned)log_lost);
+
+  Out_Start();
+  logDeferredFlush();
+  snprintf(expected, sizeof(expected), "3 deferred logs lost\r\n");
+  CHECK(strncmp(out, expected, strlen(expected)) == 0, "lost logs of the interrupts: \"%.30s\"", out);
+  CHECK(log_lost == 0U, "lost count not cleared");
+  out_on = false;
+  out_len = 0U;
+}
+
+static void Irq_Log_And_Flush(void)
+{
+  APP_ZB_DBG("irq %d", 2);
+  logDeferredFlush();
+}
+
+static void Irq_Log_In_Flush(void)
+{
+  APP_ZB_DBG("irq %d", 3);
+  logDeferredFlush();
+}
+
+/* Logs from interrupts, during a record and during a flush */
+static void Check_Interrupts(void)
+{
+  char     *ref, *got;
+  uint32_t i;
+
+  /* One turn of records without argument: the record preempted below is
+   * reserved on the header of an old one */
+  logDeferredFlush();
+  for (i = 0U; i < (LOG_DEFERRED_BUFFER_SIZE / LOG_DEFERRED_HEADER_SIZE); i++)
+  {
+    APP_ZB_DBG("turn");
+    if ((i % 64U) == 63U)
+    {
+      logDeferredFlush();
+    }
+  }
+  logDeferredFlush();
+
+  Out_Start();
+  APP_ZB_DBG_SYNC("outer %d", 1);
+  APP_ZB_DBG_SYNC("irq %d", 2);
+  APP_ZB_DBG_SYNC("before %d", 1);
+  APP_ZB_DBG_SYNC("irq %d", 3);
+  ref = Out_Take();
+
+  /* The record of the interrupt is reserved after the one it preempts, its
+   * flush stops on the record not yet committed */
+  sim_tick_irq = Irq_Log_And_Flush;
+  APP_ZB_DBG("outer %d", 1);
+  CHECK(out_len == 0U, "record not committed output by the interrupt");
+  logDeferredFlush();
+
+  /* A flush preempted by a log and a flush goes on with the log */
+  APP_ZB_DBG("before %d", 1);
+  sim_printf_irq = Irq_Log_In_Flush;
+  logDeferredFlush();
+  CHECK(log_tail == log_head, "log of the interrupt left in the ring");
+
+  got = Out_Take();
+  out_on = false;
+  Check_Same("interrupts", ref, got);
+  free(ref);
+  free(got);
+}
+
+/* Random logs and flushes against a model of the ring */
+static void Check_Random(long NbRounds)
+{
+  long     round;
+  uint32_t nb, i, k, mark, used = 0U, lost = 0U, words = 0U, nb_logs = 0U;
+  uint32_t a[8];
+  char     *ref, *got;
+  static char pending[OUT_SIZE];
+  uint32_t pending_len = 0U;
+  static char expected[OUT_SIZE];
+  uint32_t expected_len;
+  long     failures_start = failures;
+
+  for (round = 0; round < NbRounds; round++)
+  {
+    Out_Start();
+    expected_len = 0U;
+    nb = Sim_Random() % 120U;
+    for (i = 0U; i < nb; i++)
+    {
+      k = Sim_Random() % (sizeof(random_formats) / sizeof(random_formats[0]));
+      for (uint32_t j = 0U; j < 8U; j++)
+      {
+        a[j] = Sim_Random() >> (Sim_Random() % 32U);
+      }
+      /* Text of the log, appended then removed from the output */
+      mark = out_len;
+      if (k == 9U)
+      {
+        APP_ZB_DBG_SYNC(random_formats[k], "string");
+      }
+      else
+      {
+        APP_ZB_DBG_SYNC(random_formats[k], a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+      }
+      ref = strdup(&out[mark]);
+      out_len = mark;
+      out[mark] = '\0';
+
+      if (k == 9U)
+      {
+        /* Flush then output at once */
+        if (lost != 0U)
+        {
+          expected_len += (uint32_t)snprintf(&expected[expected_len], OUT_SIZE - expected_len,
+                                             "%u deferred logs lost\r\n", (unsigned)lost);
+        }
+        memcpy(&expected[expected_len], pending, pending_len);
+        expected_len += pending_len;
+        expected_len += (uint32_t)snprintf(&expected[expected_len], OUT_SIZE - expected_len, "%s", ref);
+        pending_len = 0U;
+        used = 0U;
+        lost = 0U;
+        APP_ZB_DBG(random_formats[k], "string");
+      }
+      else
+      {
+        if ((used + LOG_DEFERRED_HEADER_SIZE + k) <= LOG_DEFERRED_BUFFER_SIZE)
+        {
+          used += LOG_DEFERRED_HEADER_SIZE + k;
+          words += LOG_DEFERRED_HEADER_SIZE + k;
+          pending_len += (uint32_t)snprintf(&pending[pending_len], OUT_SIZE - pending_len, "%s", ref);
+
+          /* Reservations preempted by an interrupt are retried */
+          Sim_Strex_Fail = ((Sim_Random() & 7U) == 0U) ? 1U + (Sim_Random() % 3U) : 0U;
+        }
+        else
+        {
+          lost++;
+        }
+        APP_ZB_DBG(random_formats[k], a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+      }
+      CHECK(Sim_Strex_Fail == 0U, "exclusive store not retried");
+      Sim_Strex_Fail = 0U;
+      nb_logs++;
+      free(ref);
+    }
+
+    /* The flush task does not run at each round */
+    if ((Sim_Random() % 3U) != 0U)
+    {
+      if (lost != 0U)
+      {
+        expected_len += (uint32_t)snprintf(&expected[expected_len], OUT_SIZE - expected_len,
+                                           "%u deferred logs lost\r\n", (unsigned)lost);
+      }
+      memcpy(&expected[expected_len], pending, pending_len);
+      expected_len += pending_len;
+      pending_len = 0U;
+      used = 0U;
+      lost = 0U;
+      logDeferredFlush();
+    }
+    expected[expected_len] = '\0';
+
+    got = Out_Take();
+    out_on = false;
+    Check_Same("random", expected, got);
+    free(got);
+    if (failures != failures_start)
+    {
+      fprintf(stderr, "  round %ld\n", round);
+      break;
+    }
+  }
+
+  logDeferredFlush();
+  printf("  %ld random rounds: %u logs, %u ring words, ring index at %u\n", NbRounds, (unsigned)nb_logs,
+         (unsigned)words, (unsigned)log_head);
+}
+
+/* Host time per log at the call site, then at the flush */
+static void Bench(uint32_t NbLogs)
+{
+  uint64_t start;
+  double   sync_ns = 0.0, record_ns = 0.0, flush_ns = 0.0, t;
+  uint64_t record, flush;
+  uint32_t run, i, j;
+
+  out_on = false;
+  for (run = 0U; run < RUN_NB; run++)
+  {
+    start = Host_Ns();
+    for (i = 0U; i < NbLogs; i++)
+    {
+      APP_ZB_DBG_SYNC("Control Level: 0x%X in %d ms", i & 0xFFU, 500);
+    }
+    t = (double)(Host_Ns() - start) / NbLogs;
+    sync_ns = ((run == 0U) || (t < sync_ns)) ? t : sync_ns;
+
+    record = 0U;
+    flush  = 0U;
+    for (i = 0U; i < NbLogs; i += BENCH_BATCH)
+    {
+      start = Host_Ns();
+      for (j = 0U; j < BENCH_BATCH; j++)
+      {
+        APP_ZB_DBG("Control Level: 0x%X in %d ms", j, 500);
+      }
+      record += Host_Ns() - start;
+      start = Host_Ns();
+      logDeferredFlush();
+      flush += Host_Ns() - start;
+    }
+    t = (double)record / NbLogs;
+    record_ns = ((run == 0U) || (t < record_ns)) ? t : record_ns;
+    t = (double)flush / NbLogs;
+    flush_ns = ((run == 0U) || (t < flush_ns)) ? t : flush_ns;
+  }
+  CHECK(log_lost == 0U, "%u logs lost by the benchmark", (unsigned)log_lost);
+  printf("  host time per log: synchronous %.0f ns, deferred %.0f ns at the call and %.0f ns at the flush\n",
+         sync_ns, record_ns, flush_ns);
+}
+
+static void Usage(void)
+{
+  fprintf(stderr, "usage: log_deferred [-n random rounds]\n");
+  exit(2);
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char * argv[])
+{
+  long nb_rounds = 2000;
+  int  arg;
+
+  for (arg = 1; arg < argc; arg++)
+  {
+    if ((strcmp(argv[arg], "-n") == 0) && ((arg + 1) < argc))
+    {
+      nb_rounds = atol(argv[++arg]);
+    }
+    else
+    {
+      Usage();
+    }
+  }
+
+  logDeferredInit();
+  CHECK(sim_flush_task == logDeferredFlush, "flush task not registered");
+
+  Check_Formats();
+  Check_Full();
+  Check_Lost_Interrupted();
+  Check_Interrupts();
+  Check_Random(nb_rounds);
+  Bench(200000U);
+
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
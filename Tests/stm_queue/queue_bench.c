@@ -0,0 +1,498 @@
+/**
+  ******************************************************************************
+  * @file    queue_bench.c
+  * @author  Zigbee Application Team
+  * @brief   Check and host benchmark of the queue utility.
+  *          The unmodified stm_queue.c runs random CircularQueue_Add,
+  *          CircularQueue_Remove, reserve/commit and peek/release operations
+  *          on byte queues against a reference FIFO: content, counters,
+  *          views and refused calls. Then the same message stream goes to a
+  *          simulated UART DMA three ways: variable size elements added and
+  *          removed with a copy to the transmit buffer, a byte queue added
+  *          and removed byte by byte, and the zero-copy calls. The transmitted
+  *          data shall be the same, the throughputs are printed.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Code under test, built as is to check the counters */
+#include "stm_queue.c"
+
+/* Private defines -----------------------------------------------------------*/
+#define QUEUE_SIZE_MAX          4096U
+#define MSG_SIZE                64U       /* Trace line */
+#define DMA_MAX                 255U      /* Largest UART DMA transfer */
+#define BENCH_BYTES             (32U * 1024U * 1024U)
+#define BENCH_MSG_NB            (BENCH_BYTES / MSG_SIZE)
+#define BENCH_SRC_NB            256U      /* Distinct messages */
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint64_t bytes;
+  uint32_t crc;
+  uint64_t ns;
+} Bench_Result_t;
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t        queue_buffer[QUEUE_SIZE_MAX];
+static uint8_t        model[QUEUE_SIZE_MAX];      /* Reference FIFO, model[0] is the oldest byte */
+static uint32_t       model_count;
+static uint8_t        tx_buffer[QUEUE_SIZE_MAX];
+static uint32_t       queue_rng = 0x2545F491U;
+static uint8_t        bench_src[BENCH_SRC_NB][MSG_SIZE];
+static bool           bench_checked;              /* Checksum of the sent bytes, left out of the timed runs */
+static long           failures;
+
+/* Private functions ---------------------------------------------------------*/
+#define CHECK(cond, ...) \
+  do \
+  { \
+    if (!(cond)) \
+    { \
+      if (failures < 20) \
+      { \
+        fprintf(stderr, "  "); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+      } \
+      failures++; \
+    } \
+  } while (0)
+
+static uint32_t Queue_Random(void)
+{
+  queue_rng ^= queue_rng << 13;
+  queue_rng ^= queue_rng >> 17;
+  queue_rng ^= queue_rng << 5;
+  return queue_rng;
+}
+
+static uint64_t Bench_Ns(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+/* Checks --------------------------------------------------------------------*/
+/* The view shall describe the queue buffer in order, contiguous and wrapping */
+static void Check_View(queue_t *q, queue_view_t *view, uint32_t pos, uint32_t size, const char *name, long op)
+{
+  uint32_t eob_size = q->queueMaxSize - pos;
+
+  CHECK((view->len[0] + view->len[1]) == size, "op %ld %s: %u + %u bytes, expected %u",
+        op, name, view->len[0], view->len[1], size);
+  CHECK((size == 0U) || (view->ptr[0] == &q->qBuff[pos]), "op %ld %s: first segment at %ld, expected %u",
+        op, name, (long)(view->ptr[0] - q->qBuff), pos);
+  CHECK(view->len[0] == ((size < eob_size) ? size : eob_size), "op %ld %s: first segment of %u bytes",
+        op, name, view->len[0]);
+  CHECK((view->len[1] == 0U) ? (view->ptr[1] == NULL) : (view->ptr[1] == q->qBuff),
+        "op %ld %s: second segment %p of %u bytes", op, name, (void *)view->ptr[1], view->len[1]);
+}
+
+/* Counters and content against the reference FIFO */
+static void Check_Model(queue_t *q, long op)
+{
+  queue_view_t view;
+  uint32_t     size = CircularQueue_Peek(q, &view);
+
+  CHECK(size == model_count, "op %ld: %u bytes peeked, %u queued", op, size, model_count);
+  CHECK(q->byteCount == model_count, "op %ld: byteCount %u, expected %u", op, q->byteCount, model_count);
+  CHECK(q->elementCount == model_count, "op %ld: elementCount %u, expected %u", op, q->elementCount, model_count);
+  CHECK(CircularQueue_NbElement(q) == (int)model_count, "op %ld: %d elements", op, CircularQueue_NbElement(q));
+  CHECK((CircularQueue_Empty(q) != 0) == (model_count == 0U), "op %ld: empty %d with %u bytes",
+        op, CircularQueue_Empty(q), model_count);
+  CHECK(CircularQueue_FreeSize(q) == (q->queueMaxSize - model_count), "op %ld: %u bytes free",
+        op, CircularQueue_FreeSize(q));
+  if (size != model_count)
+  {
+    return;
+  }
+
+  Check_View(q, &view, q->first, size, "peek", op);
+  CHECK((size > 0U) || (view.ptr[0] == NULL), "op %ld: empty peek with a segment", op);
+  if (size > 0U)
+  {
+    CHECK((memcmp(view.ptr[0], model, view.len[0]) == 0)
+          && ((view.len[1] == 0U) || (memcmp(view.ptr[1], &model[view.len[0]], view.len[1]) == 0)),
+          "op %ld: peeked bytes differ from the queued ones", op);
+    CHECK(*CircularQueue_Sense(q, NULL) == model[0], "op %ld: sensed byte 0x%02x, expected 0x%02x",
+          op, *CircularQueue_Sense(q, NULL), model[0]);
+  }
+}
+
+static void Model_Push(uint8_t data)
+{
+  model[model_count++] = data;
+}
+
+static void Model_Pop(uint32_t size)
+{
+  memmove(model, &model[size], model_count - size);
+  model_count -= size;
+}
+
+/* Random element and zero-copy calls mixed on a byte queue */
+static void Check_Random(uint32_t queue_size, long nb_ops)
+{
+  queue_t      q;
+  queue_view_t view;
+  uint8_t      data[QUEUE_SIZE_MAX + 8U];
+  uint32_t     free_size;
+  uint32_t     size;
+  uint32_t     written;
+  uint16_t     element_size;
+  uint8_t      *ptr;
+
+  CHECK(CircularQueue_Init(&q, queue_buffer, queue_size, 1U, CIRCULAR_QUEUE_NO_FLAG) == 0, "init failed");
+  model_count = 0U;
+  memset(queue_buffer, 0, sizeof(queue_buffer));
+
+  for (long op = 0; op < nb_ops; op++)
+  {
+    free_size = queue_size - model_count;
+    /* Up to a bit more than the room left to reach the refused cases */
+    size = Queue_Random() % ((free_size + 8U) / ((Queue_Random() % 4U) + 1U) + 1U);
+
+    switch (Queue_Random() % 6U)
+    {
+      case 0:
+        for (uint32_t i = 0; i < size; i++)
+        {
+          data[i] = (uint8_t)Queue_Random();
+        }
+        ptr = CircularQueue_Add(&q, data, 0U, size);
+        CHECK((size > free_size) == (ptr == NULL), "op %ld: add of %u bytes with %u free returned %p",
+              op, size, free_size, (void *)ptr);
+        if (ptr != NULL)
+        {
+          for (uint32_t i = 0; i < size; i++)
+          {
+            Model_Push(data[i]);
+          }
+        }
+        break;
+
+      case 1:
+      case 2:
+        if (CircularQueue_Reserve(&q, size, &view) != 0)
+        {
+          CHECK((size == 0U) || (size > free_size), "op %ld: reserve of %u bytes with %u free refused",
+                op, size, free_size);
+          break;
+        }
+        CHECK((size > 0U) && (size <= free_size), "op %ld: reserve of %u bytes with %u free accepted",
+              op, size, free_size);
+        Check_View(&q, &view, MOD((q.first + q.byteCount), q.queueMaxSize), size, "reserve", op);
+
+        /* Sometimes less than reserved, as a formatting shorter than expected */
+        written = ((Queue_Random() % 4U) == 0U) ? (Queue_Random() % (size + 1U)) : size;
+        for (uint32_t i = 0; i < written; i++)
+        {
+          uint8_t byte = (uint8_t)Queue_Random();
+
+          if (i < view.len[0])
+          {
+            view.ptr[0][i] = byte;
+          }
+          else
+          {
+            view.ptr[1][i - view.len[0]] = byte;
+          }
+          Model_Push(byte);
+        }
+        CHECK(CircularQueue_Commit(&q, written) == 0, "op %ld: commit of %u bytes refused", op, written);
+        break;
+
+      case 3:
+        size = (model_count > 0U) ? (Queue_Random() % (model_count + 2U)) : (Queue_Random() % 2U);
+        if (CircularQueue_Release(&q, size) != 0)
+        {
+          CHECK(size > model_count, "op %ld: release of %u bytes with %u queued refused", op, size, model_count);
+          break;
+        }
+        CHECK(size <= model_count, "op %ld: release of %u bytes with %u queued accepted", op, size, model_count);
+        Model_Pop(size);
+        break;
+
+      case 4:
+        ptr = CircularQueue_Remove(&q, &element_size);
+        CHECK((ptr == NULL) == (model_count == 0U), "op %ld: remove returned %p with %u queued",
+              op, (void *)ptr, model_count);
+        if (ptr != NULL)
+        {
+          CHECK((element_size == 1U) && (*ptr == model[0]), "op %ld: removed %u bytes 0x%02x, expected 0x%02x",
+                op, element_size, *ptr, model[0]);
+          Model_Pop(1U);
+        }
+        break;
+
+      default:
+        /* Refused calls leave the queue unchanged */
+        CHECK(CircularQueue_Commit(&q, free_size + 1U) != 0, "op %ld: commit beyond the room accepted", op);
+        CHECK(CircularQueue_Release(&q, model_count + 1U) != 0, "op %ld: release beyond the content accepted", op);
+        CHECK(CircularQueue_Reserve(&q, 0U, &view) != 0, "op %ld: empty reserve accepted", op);
+        break;
+    }
+    Check_Model(&q, op);
+  }
+  printf("random: %u bytes queue, %ld operations\n", queue_size, nb_ops);
+}
+
+/* The zero-copy calls only take byte queues */
+static void Check_Queue_Types(void)
+{
+  static const struct
+  {
+    uint16_t element_size;
+    uint8_t  flags;
+  } types[] = { { 0U, CIRCULAR_QUEUE_NO_FLAG }, { 4U, CIRCULAR_QUEUE_NO_FLAG }, { 1U, CIRCULAR_QUEUE_NO_WRAP_FLAG },
+                { 0U, CIRCULAR_QUEUE_SPLIT_IF_WRAPPING_FLAG } };
+  queue_t      q;
+  queue_view_t view;
+  uint8_t      data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+  for (uint32_t i = 0; i < (sizeof(types) / sizeof(types[0])); i++)
+  {
+    CircularQueue_Init(&q, queue_buffer, 256U, types[i].element_size, types[i].flags);
+    CircularQueue_Add(&q, data, 4U, 1U);
+    CHECK(CircularQueue_Reserve(&q, 4U, &view) != 0, "type %u: reserve accepted", i);
+    CHECK(CircularQueue_Commit(&q, 4U) != 0, "type %u: commit accepted", i);
+    CHECK(CircularQueue_Peek(&q, &view) == 0U, "type %u: peek returned bytes", i);
+    CHECK((view.ptr[0] == NULL) && (view.ptr[1] == NULL), "type %u: peek returned segments", i);
+    CHECK(CircularQueue_Release(&q, 1U) != 0, "type %u: release accepted", i);
+  }
+}
+
+/* Benchmark -----------------------------------------------------------------*/
+
+/* Simulated UART DMA, no CPU work on the target. The checked runs sum the bytes
+ * weighted by their stream position to compare the paths. */
+static inline void Bench_Dma(Bench_Result_t *result, const uint8_t *data, uint32_t size)
+{
+  uint32_t pos = (uint32_t)result->bytes;
+
+  if (bench_checked)
+  {
+    for (uint32_t i = 0; i < size; i++)
+    {
+      result->crc += data[i] * (pos + i + 1U);
+    }
+  }
+  result->bytes += size;
+}
+
+/* Messages ready in the producer buffers, as IPCC notifications */
+static void Bench_Init(void)
+{
+  for (uint32_t seq = 0; seq < BENCH_SRC_NB; seq++)
+  {
+    for (uint32_t i = 0; i < MSG_SIZE; i++)
+    {
+      bench_src[seq][i] = (uint8_t)((seq * 31U) + i);
+    }
+  }
+}
+
+/* Variable size elements: copy in by CircularQueue_Add, copy out to the DMA buffer */
+static void Bench_Add_Remove(Bench_Result_t *result)
+{
+  queue_t  q;
+  uint32_t seq = 0U;
+  uint64_t start = Bench_Ns();
+
+  CircularQueue_Init(&q, queue_buffer, QUEUE_SIZE_MAX, 0U, CIRCULAR_QUEUE_NO_FLAG);
+  memset(result, 0, sizeof(Bench_Result_t));
+  while (result->bytes < BENCH_BYTES)
+  {
+    /* Producer: fill the queue */
+    while (seq < BENCH_MSG_NB)
+    {
+      if (CircularQueue_Add(&q, bench_src[seq % BENCH_SRC_NB], MSG_SIZE, 1U) == NULL)
+      {
+        break;
+      }
+      seq++;
+    }
+
+    /* Consumer: gather the elements in the DMA buffer, they may wrap */
+    while (CircularQueue_Empty(&q) == 0)
+    {
+      uint32_t tx_size = 0U;
+
+      while ((CircularQueue_Empty(&q) == 0) && ((tx_size + MSG_SIZE) <= DMA_MAX))
+      {
+        uint16_t size;
+        uint8_t  *ptr = CircularQueue_Remove(&q, &size);
+        uint32_t eob_size = (uint32_t)(&q.qBuff[q.queueMaxSize] - ptr);
+
+        if (size <= eob_size)
+        {
+          memcpy(&tx_buffer[tx_size], ptr, size);
+        }
+        else
+        {
+          memcpy(&tx_buffer[tx_size], ptr, eob_size);
+          memcpy(&tx_buffer[tx_size + eob_size], q.qBuff, size - eob_size);
+        }
+        tx_size += size;
+      }
+      Bench_Dma(result, tx_buffer, tx_size);
+    }
+  }
+  result->ns = Bench_Ns() - start;
+}
+
+/* Byte queue: CircularQueue_Add of the message bytes, CircularQueue_Remove byte by byte */
+static void Bench_Byte_Add_Remove(Bench_Result_t *result)
+{
+  queue_t  q;
+  uint32_t seq = 0U;
+  uint64_t start = Bench_Ns();
+
+  CircularQueue_Init(&q, queue_buffer, QUEUE_SIZE_MAX, 1U, CIRCULAR_QUEUE_NO_FLAG);
+  memset(result, 0, sizeof(Bench_Result_t));
+  while (result->bytes < BENCH_BYTES)
+  {
+    while (seq < BENCH_MSG_NB)
+    {
+      if (CircularQueue_Add(&q, bench_src[seq % BENCH_SRC_NB], 0U, MSG_SIZE) == NULL)
+      {
+        break;
+      }
+      seq++;
+    }
+
+    while (CircularQueue_Empty(&q) == 0)
+    {
+      uint32_t tx_size = 0U;
+
+      while ((CircularQueue_Empty(&q) == 0) && (tx_size < ((DMA_MAX / MSG_SIZE) * MSG_SIZE)))
+      {
+        tx_buffer[tx_size++] = *CircularQueue_Remove(&q, NULL);
+      }
+      Bench_Dma(result, tx_buffer, tx_size);
+    }
+  }
+  result->ns = Bench_Ns() - start;
+}
+
+/* Zero-copy: the message is copied in the reserved area, the DMA reads the peeked segments */
+static void Bench_Zero_Copy(Bench_Result_t *result)
+{
+  queue_t      q;
+  queue_view_t view;
+  uint32_t     seq = 0U;
+  uint64_t     start = Bench_Ns();
+
+  CircularQueue_Init(&q, queue_buffer, QUEUE_SIZE_MAX, 1U, CIRCULAR_QUEUE_NO_FLAG);
+  memset(result, 0, sizeof(Bench_Result_t));
+  while (result->bytes < BENCH_BYTES)
+  {
+    while ((seq < BENCH_MSG_NB) && (CircularQueue_Reserve(&q, MSG_SIZE, &view) == 0))
+    {
+      memcpy(view.ptr[0], bench_src[seq % BENCH_SRC_NB], view.len[0]);
+      memcpy(view.ptr[1], &bench_src[seq % BENCH_SRC_NB][view.len[0]], view.len[1]);
+      CircularQueue_Commit(&q, MSG_SIZE);
+      seq++;
+    }
+
+    /* Same DMA transfers as the copy paths: whole messages, up to DMA_MAX bytes */
+    while (CircularQueue_Peek(&q, &view) > 0U)
+    {
+      uint32_t tx_size = MIN(q.byteCount, (DMA_MAX / MSG_SIZE) * MSG_SIZE);
+      uint32_t size = MIN(tx_size, view.len[0]);
+
+      Bench_Dma(result, view.ptr[0], size);
+      if (size < tx_size)
+      {
+        Bench_Dma(result, view.ptr[1], tx_size - size);
+      }
+      CircularQueue_Release(&q, tx_size);
+    }
+  }
+  result->ns = Bench_Ns() - start;
+}
+
+static void Check_Bench(void)
+{
+  Bench_Result_t copy;
+  Bench_Result_t bytes;
+  Bench_Result_t zero_copy;
+
+  /* Same stream on the three paths */
+  Bench_Init();
+  bench_checked = true;
+  Bench_Add_Remove(&copy);
+  Bench_Byte_Add_Remove(&bytes);
+  Bench_Zero_Copy(&zero_copy);
+  CHECK((bytes.bytes == copy.bytes) && (bytes.crc == copy.crc), "byte queue sent %llu bytes crc 0x%08x, "
+        "expected %llu bytes crc 0x%08x", (unsigned long long)bytes.bytes, bytes.crc,
+        (unsigned long long)copy.bytes, copy.crc);
+  CHECK((zero_copy.bytes == copy.bytes) && (zero_copy.crc == copy.crc), "zero-copy sent %llu bytes crc 0x%08x, "
+        "expected %llu bytes crc 0x%08x", (unsigned long long)zero_copy.bytes, zero_copy.crc,
+        (unsigned long long)copy.bytes, copy.crc);
+
+  /* Timed runs: queue handling only */
+  bench_checked = false;
+  Bench_Add_Remove(&copy);
+  Bench_Byte_Add_Remove(&bytes);
+  Bench_Zero_Copy(&zero_copy);
+
+  printf("bench: %u bytes queue, %u bytes messages, %u MB per path\n", QUEUE_SIZE_MAX, MSG_SIZE,
+         (uint32_t)(copy.bytes >> 20));
+  printf("  add/remove + copy to the DMA buffer : %6.0f MB/s\n", (double)copy.bytes * 1000.0 / (double)copy.ns);
+  printf("  byte queue add/remove               : %6.0f MB/s\n", (double)bytes.bytes * 1000.0 / (double)bytes.ns);
+  printf("  reserve/commit + peek/release       : %6.0f MB/s\n",
+         (double)zero_copy.bytes * 1000.0 / (double)zero_copy.ns);
+}
+
+static void Usage(void)
+{
+  fprintf(stderr, "usage: queue_bench [-n operations]\n");
+  exit(2);
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char * argv[])
+{
+  long nb_ops = 200000;
+
+  for (int arg = 1; arg < argc; arg++)
+  {
+    if ((strcmp(argv[arg], "-n") == 0) && ((arg + 1) < argc))
+    {
+      nb_ops = atol(argv[++arg]);
+    }
+    else
+    {
+      Usage();
+    }
+  }
+
+  /* Power of two size and odd size */
+  Check_Random(QUEUE_SIZE_MAX, nb_ops);
+  Check_Random(1021U, nb_ops);
+  Check_Queue_Types();
+  Check_Bench();
+
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+/**
+  ******************************************************************************
+  * @file    utilities_conf.h
+  * @author  Zigbee Application Team
+  * @brief   Host replacement of the utilities configuration for the low power
+  *          manager tests, same settings as the Zigbee_Shutter_Remote
+  *          application on a simulated PRIMASK and power interface
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef UTILITIES_CONF_H
+#define UTILITIES_CONF_H
+
+#include <stdint.h>
+#include <string.h>
+#include "stm32_lpm.h"
+
+/* Simulated platform, see the tests */
+extern uint32_t Sim_PRIMASK;
+
+uint32_t PWR_GetTimestamp( void );
+uint32_t PWR_GetNextWakeup( void );
+UTIL_LPM_WakeupSource_t PWR_GetWakeupSource( void );
+
+/******************************************************************************
+ * common
+ ******************************************************************************/
+#define UTILS_ENTER_CRITICAL_SECTION( )   uint32_t primask_bit = Sim_PRIMASK;\
+                                          Sim_PRIMASK = 1U
+
+#define UTILS_EXIT_CRITICAL_SECTION( )          Sim_PRIMASK = primask_bit
+
+/******************************************************************************
+ * tiny low power manager, the prediction and its break-even times can be
+ * changed by the build
+ ******************************************************************************/
+#define UTIL_LPM_INIT_CRITICAL_SECTION( )
+#define UTIL_LPM_ENTER_CRITICAL_SECTION( )      UTILS_ENTER_CRITICAL_SECTION( )
+#define UTIL_LPM_EXIT_CRITICAL_SECTION( )       UTILS_EXIT_CRITICAL_SECTION( )
+#define UTIL_LPM_STATS_ENABLE                   (1)
+#define UTIL_LPM_GET_TIMESTAMP( )               PWR_GetTimestamp( )
+#define UTIL_LPM_GET_WAKEUP_SOURCE( )           PWR_GetWakeupSource( )
+#ifndef UTIL_LPM_PREDICT_ENABLE
+#define UTIL_LPM_PREDICT_ENABLE                 (1)
+#endif
+#if ( UTIL_LPM_PREDICT_ENABLE == 1 )
+#define UTIL_LPM_GET_NEXT_WAKEUP( )             PWR_GetNextWakeup( )
+#endif
+#ifndef UTIL_LPM_STOP_BREAK_EVEN
+#define UTIL_LPM_STOP_BREAK_EVEN                (2U)
+#endif
+#ifndef UTIL_LPM_OFF_BREAK_EVEN
+#define UTIL_LPM_OFF_BREAK_EVEN                 (64U)
+#endif
+
+#endif /*UTILITIES_CONF_H */
@@ -0,0 +1,354 @@
+/**
+  ******************************************************************************
+  * @file    lpm_predict.c
+  * @author  Zigbee Application Team
+  * @brief   Check and energy model of the low power mode prediction.
+  *          UTIL_LPM_SelectMode() of the unmodified stm32_lpm.c is checked
+  *          for each user mask around the break-even times. The low power
+  *          manager then runs on a simulated power driver with the timer
+  *          server wakeups of an idle device: the entered modes and the
+  *          prediction counters shall match a model, and the energy of the
+  *          sequence is printed for several Stop break-even times and
+  *          without prediction.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Stop break-even time changed by the energy model */
+uint32_t Sim_Stop_Break_Even = 2U;
+#define UTIL_LPM_STOP_BREAK_EVEN    Sim_Stop_Break_Even
+
+/* Code under test, built as is with the configuration of utilities_conf.h */
+#include "stm32_lpm.c"
+
+/* Private defines -----------------------------------------------------------*/
+/* Energy model, the times are in RTC ticks of 488 us and the currents in uA */
+#define I_RUN                   4000.0
+#define I_SLEEP                 1200.0
+#define I_STOP                  3.0
+#define I_OFF                   0.3
+#define STOP_EXIT_TIME          3U        /* HSE restore after Stop */
+#define OFF_EXIT_TIME           40U       /* Restart of the application after Off */
+#define WAKEUP_RUN_TIME         1U        /* Run time of a timer wakeup */
+
+/* Private variables ---------------------------------------------------------*/
+uint32_t                    Sim_PRIMASK;
+
+static long                 failures;
+static uint32_t             sim_rng;
+
+/* Simulated platform */
+static uint32_t             sim_time;
+static uint32_t             sim_next;                     /* Ticks left before the next timer */
+static bool                 sim_predict = true;           /* False : no timer seen by the prediction */
+static int                  sim_mode;
+static double               sim_energy;
+
+/* Private functions ---------------------------------------------------------*/
+#define CHECK(cond, ...) \
+  do \
+  { \
+    if (!(cond)) \
+    { \
+      if (failures < 20) \
+      { \
+        fprintf(stderr, "  "); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+      } \
+      failures++; \
+    } \
+  } while (0)
+
+static uint32_t Sim_Random(void)
+{
+  sim_rng ^= sim_rng << 13;
+  sim_rng ^= sim_rng >> 17;
+  sim_rng ^= sim_rng << 5;
+  return sim_rng;
+}
+
+/* Simulated platform --------------------------------------------------------*/
+uint32_t PWR_GetTimestamp(void)
+{
+  return sim_time;
+}
+
+uint32_t PWR_GetNextWakeup(void)
+{
+  CHECK(Sim_PRIMASK != 0U, "next wakeup read out of the critical section");
+  return sim_predict ? sim_next : UTIL_LPM_NO_WAKEUP;
+}
+
+UTIL_LPM_WakeupSource_t PWR_GetWakeupSource(void)
+{
+  return UTIL_LPM_WAKEUP_RTC;
+}
+
+/* The device sleeps until the next timer */
+static void Sim_Enter(int Mode, double Current)
+{
+  sim_mode    = Mode;
+  sim_time   += sim_next;
+  sim_energy += sim_next * Current;
+}
+
+static void Sim_Exit_Cost(uint32_t Time)
+{
+  sim_time   += Time;
+  sim_energy += Time * I_RUN;
+}
+
+static void Sim_EnterSleep(void)
+{
+  Sim_Enter(UTIL_LPM_SLEEPMODE, I_SLEEP);
+}
+
+static void Sim_EnterStop(void)
+{
+  Sim_Enter(UTIL_LPM_STOPMODE, I_STOP);
+}
+
+static void Sim_ExitStop(void)
+{
+  Sim_Exit_Cost(STOP_EXIT_TIME);
+}
+
+static void Sim_EnterOff(void)
+{
+  Sim_Enter(UTIL_LPM_OFFMODE, I_OFF);
+}
+
+static void Sim_ExitOff(void)
+{
+  Sim_Exit_Cost(OFF_EXIT_TIME);
+}
+
+static void Sim_None(void)
+{
+}
+
+const struct UTIL_LPM_Driver_s UTIL_PowerDriver =
+{
+  Sim_EnterSleep, Sim_None, Sim_EnterStop, Sim_ExitStop, Sim_EnterOff, Sim_ExitOff
+};
+
+/* Checks --------------------------------------------------------------------*/
+/* Deepest mode allowed, then lighter ones while the next wakeup is too close */
+static UTIL_LPM_Mode_t Model_Mode(UTIL_LPM_bm_t StopBm, UTIL_LPM_bm_t OffBm, uint32_t Next, uint32_t BreakEven,
+                                  uint32_t OffBreakEven)
+{
+  if ((StopBm == 0U) && (OffBm == 0U) && (Next >= OffBreakEven))
+  {
+    return UTIL_LPM_OFFMODE;
+  }
+  if ((StopBm == 0U) && (Next >= BreakEven))
+  {
+    return UTIL_LPM_STOPMODE;
+  }
+  return UTIL_LPM_SLEEPMODE;
+}
+
+static void Check_Select(void)
+{
+  static const uint32_t masks[] = { 0U, 1U, 0x80000000U, 0xFFFFFFFFU };
+  static const uint32_t breaks[] = { 0U, 1U, 5U, 100U, 0xFFFFFFFFU };
+  uint32_t s, o, b, d, n;
+  uint32_t nb = 0U;
+
+  for (s = 0U; s < 4U; s++)
+  {
+    for (o = 0U; o < 4U; o++)
+    {
+      for (b = 0U; b < 5U; b++)
+      {
+        for (d = 0U; d < 5U; d++)
+        {
+          uint32_t off_break = (breaks[b] > (0xFFFFFFFFU - breaks[d])) ? 0xFFFFFFFFU : (breaks[b] + breaks[d]);
+          uint32_t nexts[] = { 0U, 1U, breaks[b] - 1U, breaks[b], breaks[b] + 1U, off_break - 1U, off_break,
+                               off_break + 1U, 0xFFFFFFFEU, 0xFFFFFFFFU };
+
+          for (n = 0U; n < (sizeof(nexts) / sizeof(nexts[0])); n++)
+          {
+            UTIL_LPM_Mode_t mode = UTIL_LPM_SelectMode(masks[s], masks[o], nexts[n], breaks[b], off_break);
+            UTIL_LPM_Mode_t ref  = Model_Mode(masks[s], masks[o], nexts[n], breaks[b], off_break);
+
+            CHECK(mode == ref, "stop 0x%08X off 0x%08X next %u break-even %u/%u: mode %d instead of %d",
+                  (unsigned)masks[s], (unsigned)masks[o], (unsigned)nexts[n], (unsigned)breaks[b], (unsigned)off_break,
+                  (int)mode, (int)ref);
+            nb++;
+          }
+        }
+      }
+    }
+  }
+  printf("  UTIL_LPM_SelectMode: %u cases\n", (unsigned)nb);
+}
+
+/* Idle device with the timer server: mostly close timers, some long ones. The
+ * entered modes and the counters are checked, the energy is returned */
+static double Run(long NbIdles, bool WithOff, UTIL_LPM_Stats_t * pStats)
+{
+  long             idle;
+  UTIL_LPM_Stats_t stats;
+  UTIL_LPM_Mode_t  mode;
+  UTIL_LPM_bm_t    stop_bm = 0U;
+  UTIL_LPM_bm_t    off_bm = WithOff ? 0U : 1U;
+  uint32_t         be, off_be, next;
+  uint32_t         predict_sleep = 0U, predict_stop = 0U, long_sleep = 0U;
+  long             failures_start = failures;
+
+  sim_rng    = 0x2545F491U;
+  sim_time   = 1000U;
+  sim_energy = 0.0;
+  UTIL_LPM_Init();
+  UTIL_LPM_SetOffMode(1U, WithOff ? UTIL_LPM_ENABLE : UTIL_LPM_DISABLE);
+
+  for (idle = 0; idle < NbIdles; idle++)
+  {
+    /* A user disallows Stop for a few idles from time to time */
+    if ((idle % 1000) == 0)
+    {
+      UTIL_LPM_SetStopMode(2U, UTIL_LPM_DISABLE);
+      stop_bm = 2U;
+    }
+    if ((idle % 1000) == 5)
+    {
+      UTIL_LPM_SetStopMode(2U, UTIL_LPM_ENABLE);
+      stop_bm = 0U;
+    }
+
+    next = ((Sim_Random() % 10U) < 7U) ? (Sim_Random() % 9U) : (Sim_Random() % 2000U);
+    sim_next = next;
+    UTIL_LPM_GetStats(&stats);
+    be     = Sim_Stop_Break_Even + (stats.StopExitAvg >> UTIL_LPM_AVG_SHIFT);
+    off_be = be + UTIL_LPM_OFF_BREAK_EVEN;
+    next   = sim_predict ? next : UTIL_LPM_NO_WAKEUP;
+    mode   = Model_Mode(stop_bm, off_bm, next, be, off_be);
+    if ((mode == UTIL_LPM_SLEEPMODE) && (stop_bm == 0U))
+    {
+      predict_sleep++;
+    }
+    else if ((mode == UTIL_LPM_SLEEPMODE) && (next >= be))
+    {
+      long_sleep++;
+    }
+    else if ((mode == UTIL_LPM_STOPMODE) && (off_bm == 0U))
+    {
+      predict_stop++;
+    }
+
+    sim_mode = -1;
+    UTIL_LPM_EnterLowPower();
+    CHECK(sim_mode == (int)mode, "idle %ld of %u ticks: mode %d instead of %d", idle, (unsigned)sim_next, sim_mode,
+          (int)mode);
+    CHECK(Sim_PRIMASK == 0U, "critical section left open by the low power mode");
+    if (mode == UTIL_LPM_STOPMODE)
+    {
+      /* Constant exit time, the average is exact from the first Stop */
+      UTIL_LPM_GetStats(&stats);
+      CHECK(stats.StopExitAvg == (STOP_EXIT_TIME << UTIL_LPM_AVG_SHIFT), "idle %ld: Stop exit average %u instead of %u",
+            idle, (unsigned)stats.StopExitAvg, (unsigned)(STOP_EXIT_TIME << UTIL_LPM_AVG_SHIFT));
+    }
+
+    sim_time   += WAKEUP_RUN_TIME;
+    sim_energy += WAKEUP_RUN_TIME * I_RUN;
+
+    if (failures != failures_start)
+    {
+      break;
+    }
+  }
+
+  UTIL_LPM_GetStats(pStats);
+  CHECK(pStats->PredictSleepNb == predict_sleep, "%u predicted Sleep instead of %u", (unsigned)pStats->PredictSleepNb,
+        (unsigned)predict_sleep);
+  CHECK(pStats->PredictStopNb == predict_stop, "%u predicted Stop instead of %u", (unsigned)pStats->PredictStopNb,
+        (unsigned)predict_stop);
+  CHECK(pStats->LongSleepNb == long_sleep, "%u long Sleep instead of %u", (unsigned)pStats->LongSleepNb,
+        (unsigned)long_sleep);
+  return sim_energy;
+}
+
+static void Check_Energy(long NbIdles, bool WithOff)
+{
+  static const uint32_t breaks[] = { 0U, 1U, 2U, 4U, 8U, 16U, 64U };
+  UTIL_LPM_Stats_t stats;
+  double           base, energy;
+  uint32_t         b;
+
+  printf("  %ld idles, Off %s: analytic Stop break-even %.1f ticks\n", NbIdles, WithOff ? "allowed" : "disallowed",
+         (STOP_EXIT_TIME * I_RUN) / (I_SLEEP - I_STOP));
+
+  sim_predict = false;
+  base = Run(NbIdles, WithOff, &stats);
+  sim_predict = true;
+  printf("    no prediction          : energy %.3e, Sleep %6u Stop %6u Off %6u\n", base,
+         (unsigned)stats.EntryNb[0], (unsigned)stats.EntryNb[1], (unsigned)stats.EntryNb[2]);
+
+  for (b = 0U; b < (sizeof(breaks) / sizeof(breaks[0])); b++)
+  {
+    Sim_Stop_Break_Even = breaks[b];
+    energy = Run(NbIdles, WithOff, &stats);
+    printf("    Stop break-even %2u + %u : energy %.3e (%+.0f%%), Sleep %6u Stop %6u Off %6u, predicted Sleep %6u "
+           "Stop %6u, long Sleep %4u\n", (unsigned)breaks[b], (unsigned)(stats.StopExitAvg >> UTIL_LPM_AVG_SHIFT),
+           energy, (100.0 * (energy - base)) / base, (unsigned)stats.EntryNb[0], (unsigned)stats.EntryNb[1],
+           (unsigned)stats.EntryNb[2], (unsigned)stats.PredictSleepNb, (unsigned)stats.PredictStopNb,
+           (unsigned)stats.LongSleepNb);
+
+    /* The configured break-even of the remote shall save energy */
+    if (breaks[b] == 2U)
+    {
+      CHECK(energy < base, "no energy saved by the prediction, Off %s", WithOff ? "allowed" : "disallowed");
+    }
+  }
+  Sim_Stop_Break_Even = 2U;
+}
+
+static void Usage(void)
+{
+  fprintf(stderr, "usage: lpm_predict [-n idles]\n");
+  exit(2);
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char * argv[])
+{
+  long nb_idles = 200000;
+  int  arg;
+
+  for (arg = 1; arg < argc; arg++)
+  {
+    if ((strcmp(argv[arg], "-n") == 0) && ((arg + 1) < argc))
+    {
+      nb_idles = atol(argv[++arg]);
+    }
+    else
+    {
+      Usage();
+    }
+  }
+
+  Check_Select();
+  Check_Energy(nb_idles, false);
+  Check_Energy(nb_idles, true);
+
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,383 @@
+/**
+  ******************************************************************************
+  * @file    lpm_stats.c
+  * @author  Zigbee Application Team
+  * @brief   Check of the residency and wakeup statistics of the low power
+  *          manager.
+  *          The unmodified stm32_lpm.c enters the low power modes of a
+  *          simulated power driver while users allow and disallow the Stop
+  *          and Off modes. Each period, wakeup source and user block is
+  *          accounted by a model: the statistics shall match it across the
+  *          32 bits wrap of the timestamp and the resets.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Code under test, built as is with the configuration of utilities_conf.h */
+#include "stm32_lpm.c"
+
+/* Private defines -----------------------------------------------------------*/
+#define STOP_EXIT_TIME          3U        /* Ticks to restore the clocks after Stop */
+#define CHECK_PERIOD            97U       /* Steps between two reads of the statistics */
+#define USER_NB                 5U        /* Users of the random steps, the last one is bit 31 */
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  uint64_t RunTime;
+  uint64_t Residency[UTIL_LPM_MODE_NB];
+  uint32_t EntryNb[UTIL_LPM_MODE_NB];
+  uint64_t StopBlockTime[UTIL_LPM_ID_NB];
+  uint64_t OffBlockTime[UTIL_LPM_ID_NB];
+  uint32_t WakeupNb[UTIL_LPM_WAKEUP_NB];
+} Model_t;
+
+/* Private variables ---------------------------------------------------------*/
+uint32_t                    Sim_PRIMASK;
+
+static long                 failures;
+static uint32_t             sim_rng = 0x2545F491U;
+
+/* Simulated platform, the timestamp starts before its wrap */
+static uint32_t             sim_time = 0xFFFF0000U;
+static uint32_t             sim_lp_time;                  /* Next period in low power mode */
+static uint32_t             sim_source;                   /* Next wakeup source, may be invalid */
+static int                  sim_mode = -1;                /* Mode entered by the driver */
+static bool                 sim_exited;
+
+static UTIL_LPM_bm_t        model_stop_bm;
+static UTIL_LPM_bm_t        model_off_bm;
+static Model_t              model;
+
+/* Private functions ---------------------------------------------------------*/
+#define CHECK(cond, ...) \
+  do \
+  { \
+    if (!(cond)) \
+    { \
+      if (failures < 20) \
+      { \
+        fprintf(stderr, "  "); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+      } \
+      failures++; \
+    } \
+  } while (0)
+
+static uint32_t Sim_Random(void)
+{
+  sim_rng ^= sim_rng << 13;
+  sim_rng ^= sim_rng >> 17;
+  sim_rng ^= sim_rng << 5;
+  return sim_rng;
+}
+
+/* Simulated platform --------------------------------------------------------*/
+uint32_t PWR_GetTimestamp(void)
+{
+  return sim_time;
+}
+
+uint32_t PWR_GetNextWakeup(void)
+{
+  return UTIL_LPM_NO_WAKEUP;
+}
+
+UTIL_LPM_WakeupSource_t PWR_GetWakeupSource(void)
+{
+  CHECK(Sim_PRIMASK != 0U, "wakeup source read out of the critical section");
+  return (UTIL_LPM_WakeupSource_t)sim_source;
+}
+
+static void Sim_Enter(int Mode)
+{
+  CHECK(Sim_PRIMASK != 0U, "low power mode entered out of the critical section");
+  CHECK(sim_mode == -1, "low power mode entered twice");
+  sim_mode  = Mode;
+  sim_time += sim_lp_time;
+}
+
+static void Sim_Exit(int Mode)
+{
+  CHECK(sim_mode == Mode, "exit of mode %d after the entry of mode %d", Mode, sim_mode);
+  sim_exited = true;
+}
+
+static void Sim_EnterSleep(void)
+{
+  Sim_Enter(UTIL_LPM_SLEEPMODE);
+}
+
+static void Sim_ExitSleep(void)
+{
+  Sim_Exit(UTIL_LPM_SLEEPMODE);
+}
+
+static void Sim_EnterStop(void)
+{
+  Sim_Enter(UTIL_LPM_STOPMODE);
+}
+
+/* The clocks are restored after the wakeup, out of the accounted period */
+static void Sim_ExitStop(void)
+{
+  Sim_Exit(UTIL_LPM_STOPMODE);
+  sim_time += STOP_EXIT_TIME;
+}
+
+static void Sim_EnterOff(void)
+{
+  Sim_Enter(UTIL_LPM_OFFMODE);
+}
+
+static void Sim_ExitOff(void)
+{
+  Sim_Exit(UTIL_LPM_OFFMODE);
+}
+
+const struct UTIL_LPM_Driver_s UTIL_PowerDriver =
+{
+  Sim_EnterSleep, Sim_ExitSleep, Sim_EnterStop, Sim_ExitStop, Sim_EnterOff, Sim_ExitOff
+};
+
+/* Model ---------------------------------------------------------------------*/
+/* Deepest mode allowed by the users */
+static UTIL_LPM_Mode_t Model_Mode(void)
+{
+  if (model_stop_bm != 0U)
+  {
+    return UTIL_LPM_SLEEPMODE;
+  }
+  return (model_off_bm != 0U) ? UTIL_LPM_STOPMODE : UTIL_LPM_OFFMODE;
+}
+
+static void Model_Account(UTIL_LPM_Mode_t Mode, uint32_t Duration, uint32_t Source)
+{
+  uint32_t id;
+
+  model.Residency[Mode] += Duration;
+  model.EntryNb[Mode]++;
+  for (id = 0U; id < UTIL_LPM_ID_NB; id++)
+  {
+    if ((Mode == UTIL_LPM_SLEEPMODE) && ((model_stop_bm & (1UL << id)) != 0U))
+    {
+      model.StopBlockTime[id] += Duration;
+    }
+    if ((Mode == UTIL_LPM_STOPMODE) && ((model_off_bm & (1UL << id)) != 0U))
+    {
+      model.OffBlockTime[id] += Duration;
+    }
+  }
+  model.WakeupNb[(Source < UTIL_LPM_WAKEUP_NB) ? Source : UTIL_LPM_WAKEUP_UNKNOWN]++;
+}
+
+/* The statistics are 32 bits counters */
+static void Check_Stats(const char * pName)
+{
+  UTIL_LPM_Stats_t stats;
+  uint32_t         i;
+
+  UTIL_LPM_GetStats(&stats);
+  CHECK(Sim_PRIMASK == 0U, "%s: critical section left open", pName);
+  CHECK(stats.RunTime == (uint32_t)model.RunTime, "%s: run time %u instead of %u", pName, (unsigned)stats.RunTime,
+        (unsigned)model.RunTime);
+  for (i = 0U; i < UTIL_LPM_MODE_NB; i++)
+  {
+    CHECK(stats.Residency[i] == (uint32_t)model.Residency[i], "%s: residency of mode %u: %u instead of %u", pName,
+          (unsigned)i, (unsigned)stats.Residency[i], (unsigned)model.Residency[i]);
+    CHECK(stats.EntryNb[i] == model.EntryNb[i], "%s: %u entries in mode %u instead of %u", pName,
+          (unsigned)stats.EntryNb[i], (unsigned)i, (unsigned)model.EntryNb[i]);
+  }
+  for (i = 0U; i < UTIL_LPM_ID_NB; i++)
+  {
+    CHECK(stats.StopBlockTime[i] == (uint32_t)model.StopBlockTime[i], "%s: Stop blocked by user %u for %u instead of %u",
+          pName, (unsigned)i, (unsigned)stats.StopBlockTime[i], (unsigned)model.StopBlockTime[i]);
+    CHECK(stats.OffBlockTime[i] == (uint32_t)model.OffBlockTime[i], "%s: Off blocked by user %u for %u instead of %u",
+          pName, (unsigned)i, (unsigned)stats.OffBlockTime[i], (unsigned)model.OffBlockTime[i]);
+  }
+  for (i = 0U; i < UTIL_LPM_WAKEUP_NB; i++)
+  {
+    CHECK(stats.WakeupNb[i] == model.WakeupNb[i], "%s: %u wakeups by source %u instead of %u", pName,
+          (unsigned)stats.WakeupNb[i], (unsigned)i, (unsigned)model.WakeupNb[i]);
+  }
+  if (model.EntryNb[UTIL_LPM_STOPMODE] != 0U)
+  {
+    CHECK(stats.StopExitAvg == (STOP_EXIT_TIME << UTIL_LPM_AVG_SHIFT), "%s: Stop exit average %u instead of %u", pName,
+          (unsigned)stats.StopExitAvg, (unsigned)(STOP_EXIT_TIME << UTIL_LPM_AVG_SHIFT));
+  }
+}
+
+/* One run period then one low power period */
+static void Step(uint32_t RunTime, uint32_t LpTime, uint32_t Source)
+{
+  UTIL_LPM_Mode_t mode = Model_Mode();
+
+  sim_time += RunTime;
+  model.RunTime += RunTime;
+
+  sim_lp_time = LpTime;
+  sim_source  = Source;
+  sim_mode    = -1;
+  sim_exited  = false;
+  UTIL_LPM_EnterLowPower();
+  CHECK(sim_exited && (sim_mode == (int)mode), "mode %d entered instead of %d", sim_mode, (int)mode);
+  CHECK(Sim_PRIMASK == 0U, "critical section left open by the low power mode");
+  sim_mode = -1;
+
+  Model_Account(mode, LpTime, Source);
+
+  /* The clock restore is run time */
+  if (mode == UTIL_LPM_STOPMODE)
+  {
+    model.RunTime += STOP_EXIT_TIME;
+  }
+}
+
+static void Reset(void)
+{
+  UTIL_LPM_ResetStats();
+  memset(&model, 0, sizeof(model));
+}
+
+/* Checks --------------------------------------------------------------------*/
+/* Run, Sleep, Stop and Off periods across the wrap of the timestamp */
+static void Check_Sequence(void)
+{
+  UTIL_LPM_Init();
+  model_stop_bm = 0U;
+  model_off_bm  = 0U;
+  memset(&model, 0, sizeof(model));
+
+  /* 100 run, 50 Sleep with Stop disallowed by users 0 and 3, RTC wakeup */
+  UTIL_LPM_SetStopMode((1U << 0) | (1U << 3), UTIL_LPM_DISABLE);
+  UTIL_LPM_SetOffMode(1U << 1, UTIL_LPM_DISABLE);
+  model_stop_bm = (1U << 0) | (1U << 3);
+  model_off_bm  = 1U << 1;
+  Step(100U, 50U, UTIL_LPM_WAKEUP_RTC);
+
+  /* 10 run, 0x10000 Stop across the wrap with Off disallowed by user 1, IPCC wakeup */
+  UTIL_LPM_SetStopMode((1U << 0) | (1U << 3), UTIL_LPM_ENABLE);
+  model_stop_bm = 0U;
+  Step(10U, 0x10000U, UTIL_LPM_WAKEUP_IPCC);
+
+  /* 5 run, 7 Off, invalid wakeup source */
+  UTIL_LPM_SetOffMode(1U << 1, UTIL_LPM_ENABLE);
+  model_off_bm = 0U;
+  Step(5U, 7U, 42U);
+  sim_time += 3U;
+  model.RunTime += 3U;
+  Check_Stats("sequence");
+
+  /* Only the ongoing run period after a reset */
+  Reset();
+  sim_time += 9U;
+  model.RunTime += 9U;
+  Check_Stats("reset");
+}
+
+/* Random users, periods and wakeup sources */
+static void Check_Random(long NbSteps)
+{
+  long     step;
+  uint32_t id;
+  uint64_t total;
+  long     failures_start = failures;
+
+  UTIL_LPM_Init();
+  model_stop_bm = 0U;
+  model_off_bm  = 0U;
+  memset(&model, 0, sizeof(model));
+
+  for (step = 0; step < NbSteps; step++)
+  {
+    /* A few users change their requests, a request is released twice as often as it is made */
+    while ((Sim_Random() & 3U) == 0U)
+    {
+      id = Sim_Random() % USER_NB;
+      id = (id == (USER_NB - 1U)) ? (UTIL_LPM_ID_NB - 1U) : id;
+      if ((Sim_Random() & 1U) != 0U)
+      {
+        UTIL_LPM_State_t state = ((Sim_Random() % 3U) == 0U) ? UTIL_LPM_DISABLE : UTIL_LPM_ENABLE;
+
+        UTIL_LPM_SetStopMode(1UL << id, state);
+        model_stop_bm = (state == UTIL_LPM_DISABLE) ? (model_stop_bm | (1UL << id)) : (model_stop_bm & ~(1UL << id));
+      }
+      else
+      {
+        UTIL_LPM_State_t state = ((Sim_Random() % 3U) == 0U) ? UTIL_LPM_DISABLE : UTIL_LPM_ENABLE;
+
+        UTIL_LPM_SetOffMode(1UL << id, state);
+        model_off_bm = (state == UTIL_LPM_DISABLE) ? (model_off_bm | (1UL << id)) : (model_off_bm & ~(1UL << id));
+      }
+    }
+
+    Step(Sim_Random() % 2000U, Sim_Random() >> (8U + (Sim_Random() % 24U)), Sim_Random() % (UTIL_LPM_WAKEUP_NB + 2U));
+
+    if ((step % CHECK_PERIOD) == 0)
+    {
+      Check_Stats("random");
+    }
+    if ((Sim_Random() % 10000U) == 0U)
+    {
+      Reset();
+    }
+    if (failures != failures_start)
+    {
+      fprintf(stderr, "  step %ld\n", step);
+      break;
+    }
+  }
+  Check_Stats("random end");
+
+  total = model.RunTime + model.Residency[0] + model.Residency[1] + model.Residency[2];
+  printf("  %ld random steps since the last reset: run %.1f%%, Sleep %.1f%%, Stop %.1f%%, Off %.1f%%, "
+         "%u/%u/%u entries\n", NbSteps, (100.0 * model.RunTime) / total, (100.0 * model.Residency[0]) / total,
+         (100.0 * model.Residency[1]) / total, (100.0 * model.Residency[2]) / total, (unsigned)model.EntryNb[0],
+         (unsigned)model.EntryNb[1], (unsigned)model.EntryNb[2]);
+}
+
+static void Usage(void)
+{
+  fprintf(stderr, "usage: lpm_stats [-n random steps]\n");
+  exit(2);
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char * argv[])
+{
+  long nb_steps = 200000;
+  int  arg;
+
+  for (arg = 1; arg < argc; arg++)
+  {
+    if ((strcmp(argv[arg], "-n") == 0) && ((arg + 1) < argc))
+    {
+      nb_steps = atol(argv[++arg]);
+    }
+    else
+    {
+      Usage();
+    }
+  }
+
+  Check_Sequence();
+  Check_Random(nb_steps);
+
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,633 @@
+/**
+  ******************************************************************************
+  * @file    agility_sim.c
+  * @author  Zigbee Application Team
+  * @brief   Interference simulation of the coordinator frequency agility.
+  *          The unmodified app_zigbee_agility.c and app_zigbee_channel.c run
+  *          against a simulated network: a NWK Tx counter, a neighbor table
+  *          with 8 bits failure counters, per channel failure rates and
+  *          energies, the ED scan and the Mgmt_Nwk_Update_req channel switch.
+  *          The command success rate is measured before the interference,
+  *          under it and after the channel change. A clean network, neighbors
+  *          aging out, interference on every channel, interference following
+  *          the network, intermittent interference and a low traffic shall not
+  *          move the network.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+/* The stub configuration comes first: the include guards it shares with the
+ * application headers keep them out */
+#include "app_conf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The logs of the application are counted, not printed */
+int Sim_Printf(const char *format, ...);
+#define printf Sim_Printf
+
+/* Code under test, built as is to reach the agility state */
+#include "app_zigbee_channel.c"
+#include "app_zigbee_agility.c"
+
+#undef printf
+
+/* Private defines -----------------------------------------------------------*/
+/* Simulated time in ps, the RTC tick is 16 / 32768 s */
+#define PS_PER_MS               1000000000ULL
+#define PS_PER_S                (1000ULL * PS_PER_MS)
+#define PS_PER_TICK             488281250ULL
+
+#define NEIGHBOR_NB             12U
+#define TX_PER_S                2U        /* Commands sent per second */
+#define FAIL_BACKGROUND         20U       /* Failures per 1000 without interference */
+#define ENERGY_BACKGROUND       40U
+#define ENERGY_WIFI             190U
+
+#define FORM_CHANNEL            15U
+#define MINUTE                  60U
+#define HOUR                    (60U * MINUTE)
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t ok;
+  uint32_t total;
+} Sim_Count_t;
+
+/* Private variables ---------------------------------------------------------*/
+App_Zb_Info_T               app_zb_info;
+
+static long                 failures;
+static uint32_t             sim_rng = 0x2545F491U;
+static uint32_t             sim_zb;
+
+/* Simulated clock, timer and sequencer */
+static uint64_t             sim_time;
+static HW_TS_pTimerCb_t     sim_timer_cb;
+static HW_TS_Mode_t         sim_timer_mode;
+static bool                 sim_timer_armed;
+static uint64_t             sim_timer_period;
+static uint64_t             sim_timer_expiry;
+static uint32_t             sim_samples;
+static void                 (*sim_task)(void);
+static bool                 sim_task_pending;
+static UTIL_SEQ_bm_t        sim_events;
+
+/* Simulated network */
+static uint8_t              sim_channel;
+static uint8_t              sim_update_id;
+static uint16_t             sim_tx_total;
+static struct ZbNwkNeighborT sim_neighbors[NEIGHBOR_NB];
+static uint16_t             sim_fail[WPAN_PAGE_CHANNELS_MAX];      /* Failures per 1000 */
+static uint8_t              sim_energy[WPAN_PAGE_CHANNELS_MAX];
+static uint32_t             sim_tx_per_s;
+static Sim_Count_t          sim_cmds;
+static uint32_t             sim_scans;
+static uint32_t             sim_changes;
+static uint64_t             sim_change_time;
+static uint32_t             sim_logs;
+
+/* Private functions ---------------------------------------------------------*/
+#define CHECK(cond, ...) \
+  do \
+  { \
+    if (!(cond)) \
+    { \
+      if (failures < 20) \
+      { \
+        fprintf(stderr, "  "); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+      } \
+      failures++; \
+    } \
+  } while (0)
+
+static uint32_t Sim_Random(void)
+{
+  sim_rng ^= sim_rng << 13;
+  sim_rng ^= sim_rng >> 17;
+  sim_rng ^= sim_rng << 5;
+  return sim_rng;
+}
+
+/* Simulated platform --------------------------------------------------------*/
+int Sim_Printf(const char *format, ...)
+{
+  if (strchr(format, '\n') != NULL)
+  {
+    sim_logs++;
+  }
+  return 0;
+}
+
+const char *DbgTraceGetFileName(const char *fullpath)
+{
+  const char *ret = strrchr(fullpath, '/');
+
+  return (ret != NULL) ? (ret + 1) : fullpath;
+}
+
+uint32_t HAL_GetTick(void)
+{
+  return (uint32_t)(sim_time / PS_PER_MS);
+}
+
+HW_TS_ReturnStatus_t HW_TS_Create(uint32_t TimerProcessID, uint8_t *pTimerId, HW_TS_Mode_t TimerMode, HW_TS_pTimerCb_t pTimerCallBack)
+{
+  (void)TimerProcessID;
+  *pTimerId      = 0U;
+  sim_timer_mode = TimerMode;
+  sim_timer_cb   = pTimerCallBack;
+  return hw_ts_Successful;
+}
+
+void HW_TS_Stop(uint8_t TimerID)
+{
+  (void)TimerID;
+  sim_timer_armed = false;
+}
+
+void HW_TS_Start(uint8_t TimerID, uint32_t timeout_ticks)
+{
+  (void)TimerID;
+  sim_timer_armed  = true;
+  sim_timer_period = (uint64_t)timeout_ticks * PS_PER_TICK;
+  sim_timer_expiry = sim_time + sim_timer_period;
+}
+
+void UTIL_SEQ_RegTask(UTIL_SEQ_bm_t TaskId_bm, uint32_t Flags, void (*Task)(void))
+{
+  (void)Flags;
+  CHECK(TaskId_bm == (1U << CFG_TASK_ZIGBEE_FREQ_AGILITY), "task 0x%X registered", (unsigned)TaskId_bm);
+  sim_task = Task;
+}
+
+void UTIL_SEQ_SetTask(UTIL_SEQ_bm_t TaskId_bm, uint32_t Task_Prio)
+{
+  (void)Task_Prio;
+  CHECK(TaskId_bm == (1U << CFG_TASK_ZIGBEE_FREQ_AGILITY), "task 0x%X set", (unsigned)TaskId_bm);
+  sim_task_pending = true;
+}
+
+void UTIL_SEQ_SetEvt(UTIL_SEQ_bm_t EvtId_bm)
+{
+  sim_events |= EvtId_bm;
+}
+
+/* The ED scan confirm is given before the wait */
+void UTIL_SEQ_WaitEvt(UTIL_SEQ_bm_t EvtId_bm)
+{
+  CHECK((sim_events & EvtId_bm) != 0U, "wait of event 0x%X never set", (unsigned)EvtId_bm);
+  sim_events &= ~EvtId_bm;
+}
+
+void logApplication(appliLogLevel_t aLogLevel, appliLogRegion_t aLogRegion, const char *aFormat, ...)
+{
+  (void)aLogLevel;
+  (void)aLogRegion;
+  (void)aFormat;
+}
+
+/* Zigbee stack --------------------------------------------------------------*/
+enum ZbStatusCodeT ZbNwkGet(struct ZigBeeT *zb, enum ZbNwkNibAttrIdT attrId, void *attrPtr, unsigned int attrSz)
+{
+  struct ZbChannelListT *list;
+
+  (void)zb;
+  switch (attrId)
+  {
+    case ZB_NWK_NIB_ID_TxTotal:
+      CHECK(attrSz == sizeof(uint16_t), "TxTotal read on %u bytes", attrSz);
+      memcpy(attrPtr, &sim_tx_total, sizeof(uint16_t));
+      return ZB_STATUS_SUCCESS;
+
+    case ZB_NWK_NIB_ID_UpdateId:
+      CHECK(attrSz == sizeof(uint8_t), "UpdateId read on %u bytes", attrSz);
+      memcpy(attrPtr, &sim_update_id, sizeof(uint8_t));
+      return ZB_STATUS_SUCCESS;
+
+    case ZB_NWK_NIB_ID_ActiveChannelList:
+      CHECK(attrSz == sizeof(struct ZbChannelListT), "ActiveChannelList read on %u bytes", attrSz);
+      list = attrPtr;
+      memset(list, 0, sizeof(*list));
+      list->count = 1U;
+      list->list[0].page = 0U;
+      list->list[0].channelMask = 1UL << sim_channel;
+      return ZB_STATUS_SUCCESS;
+
+    default:
+      CHECK(0, "NIB 0x%X read", (unsigned)attrId);
+      return ZB_NWK_STATUS_INVALID_PARAMETER;
+  }
+}
+
+enum ZbStatusCodeT ZbNwkGetIndex(struct ZigBeeT *zb, enum ZbNwkNibAttrIdT attrId, void *attrPtr, unsigned int attrSz,
+                                 unsigned int attrIndex)
+{
+  (void)zb;
+  CHECK(attrId == ZB_NWK_NIB_ID_NeighborTable, "NIB 0x%X read by index", (unsigned)attrId);
+  CHECK(attrSz == sizeof(struct ZbNwkNeighborT), "neighbor read on %u bytes", attrSz);
+  if (attrIndex >= NEIGHBOR_NB)
+  {
+    return ZB_NWK_STATUS_INVALID_INDEX;
+  }
+  memcpy(attrPtr, &sim_neighbors[attrIndex], sizeof(struct ZbNwkNeighborT));
+  return ZB_STATUS_SUCCESS;
+}
+
+enum ZbStatusCodeT ZbNlmeEdScanReq(struct ZigBeeT *zb, struct ZbNlmeEdScanReqT *req,
+                                   void (*callback)(struct ZbNlmeEdScanConfT *scanConf, void *arg), void *cbarg)
+{
+  struct ZbNlmeEdScanConfT conf;
+
+  (void)zb;
+  CHECK(req->channelMask == WPAN_CHANNELMASK_2400MHZ, "ED scan on 0x%08X", (unsigned)req->channelMask);
+  memset(&conf, 0, sizeof(conf));
+  memcpy(conf.energyDetectList, sim_energy, sizeof(conf.energyDetectList));
+  conf.status = ZB_STATUS_SUCCESS;
+  sim_scans++;
+  callback(&conf, cbarg);
+  return ZB_STATUS_SUCCESS;
+}
+
+enum ZbStatusCodeT ZbZdoNwkUpdateReq(struct ZigBeeT *zb, struct ZbZdoNwkUpdateReqT *req,
+                                     void (*callback)(struct ZbZdoNwkUpdateNotifyT *reqPtr, void *cb_arg), void *arg)
+{
+  struct ZbZdoNwkUpdateNotifyT notify;
+  uint8_t channel;
+
+  (void)zb;
+  CHECK(req->destAddr == ZB_NWK_ADDR_BCAST_RXON, "channel change sent to 0x%04X", req->destAddr);
+  CHECK(req->scanDuration == ZB_ZDP_NWK_UPDATE_CHANNEL_SWITCH, "channel change with scan duration %u", req->scanDuration);
+  CHECK(req->updateId == (uint8_t)(sim_update_id + 1U), "channel change with update id %u", req->updateId);
+  CHECK((req->channelMask != 0U) && ((req->channelMask & (req->channelMask - 1U)) == 0U)
+        && ((req->channelMask & WPAN_CHANNELMASK_2400MHZ) != 0U), "channel change to mask 0x%08X",
+        (unsigned)req->channelMask);
+
+  for (channel = 0U; (req->channelMask >> channel) > 1U; channel++)
+  {
+  }
+  sim_channel   = channel;
+  sim_update_id = req->updateId;
+  sim_changes++;
+  sim_change_time = sim_time;
+
+  memset(&notify, 0, sizeof(notify));
+  notify.status = ZB_STATUS_SUCCESS;
+  callback(&notify, arg);
+  return ZB_STATUS_SUCCESS;
+}
+
+/* Network simulation --------------------------------------------------------*/
+static void Sim_Network_Reset(void)
+{
+  uint32_t i;
+
+  sim_time         = 0U;
+  sim_timer_armed  = false;
+  sim_task_pending = false;
+  sim_events       = 0U;
+  sim_channel      = FORM_CHANNEL;
+  sim_update_id    = 0U;
+  sim_tx_total     = (uint16_t)Sim_Random();
+  sim_tx_per_s     = TX_PER_S;
+  sim_scans        = 0U;
+  sim_changes      = 0U;
+  memset(&sim_cmds, 0, sizeof(sim_cmds));
+  for (i = 0U; i < WPAN_PAGE_CHANNELS_MAX; i++)
+  {
+    sim_fail[i]   = FAIL_BACKGROUND;
+    sim_energy[i] = (uint8_t)(ENERGY_BACKGROUND + (Sim_Random() % 20U));
+  }
+  for (i = 0U; i < NEIGHBOR_NB; i++)
+  {
+    memset(&sim_neighbors[i], 0, sizeof(sim_neighbors[i]));
+    sim_neighbors[i].nwkAddr   = (uint16_t)(0x1000U + i);
+    sim_neighbors[i].txFailure = (uint8_t)Sim_Random();
+  }
+  /* A free entry in the middle of the table */
+  sim_neighbors[NEIGHBOR_NB / 2U].nwkAddr = ZB_NWK_ADDR_UNDEFINED;
+
+  App_Zigbee_Agility_Init();
+  CHECK((sim_timer_cb != NULL) && (sim_timer_mode == hw_ts_Repeated), "sampling timer not repeated");
+  App_Zigbee_Agility_Start();
+  CHECK(sim_timer_armed, "sampling timer not started");
+}
+
+/* Wi-Fi like interference on Width channels from First */
+static void Sim_Interference(uint8_t First, uint8_t Width, uint16_t Fail)
+{
+  uint32_t i;
+
+  for (i = First; (i < (uint32_t)(First + Width)) && (i < WPAN_PAGE_CHANNELS_MAX); i++)
+  {
+    sim_fail[i]   = Fail;
+    sim_energy[i] = (Fail > FAIL_BACKGROUND) ? ENERGY_WIFI : (uint8_t)(ENERGY_BACKGROUND + (Sim_Random() % 20U));
+  }
+}
+
+/* One command to a random neighbor, failed by the interference of the channel */
+static void Sim_Command(void)
+{
+  struct ZbNwkNeighborT *neighbor;
+
+  do
+  {
+    neighbor = &sim_neighbors[Sim_Random() % NEIGHBOR_NB];
+  } while (neighbor->nwkAddr == ZB_NWK_ADDR_UNDEFINED);
+
+  sim_tx_total++;
+  sim_cmds.total++;
+  if ((Sim_Random() % 1000U) < sim_fail[sim_channel])
+  {
+    neighbor->txFailure++;
+  }
+  else
+  {
+    sim_cmds.ok++;
+  }
+}
+
+/* Runs the network for Seconds, the sampling timer and the agility task on the way */
+static void Sim_Run(uint32_t Seconds)
+{
+  uint32_t s, i;
+
+  for (s = 0U; s < Seconds; s++)
+  {
+    for (i = 0U; i < sim_tx_per_s; i++)
+    {
+      Sim_Command();
+    }
+    sim_time += PS_PER_S;
+    while (sim_timer_armed && (sim_timer_expiry <= sim_time))
+    {
+      sim_timer_expiry += sim_timer_period;
+      sim_samples++;
+      sim_timer_cb();
+    }
+    if (sim_task_pending)
+    {
+      sim_task_pending = false;
+      sim_task();
+    }
+  }
+}
+
+/* Runs the network up to Number more samples of the link counters */
+static void Sim_Run_Samples(uint32_t Number)
+{
+  uint32_t end = sim_samples + Number;
+
+  while (sim_samples != end)
+  {
+    Sim_Run(1U);
+  }
+}
+
+static double Rate(const Sim_Count_t * pFrom, const Sim_Count_t * pTo)
+{
+  uint32_t total = pTo->total - pFrom->total;
+
+  return (total != 0U) ? ((100.0 * (pTo->ok - pFrom->ok)) / total) : 0.0;
+}
+
+/* Checks --------------------------------------------------------------------*/
+/* A clean network for a day, with neighbors aging out and counters wrapping */
+static void Check_Clean(void)
+{
+  const Agility_Stats_T *stats = App_Zigbee_Agility_Get_Stats();
+  uint32_t hour, i;
+
+  Sim_Network_Reset();
+  Sim_Run(24U * HOUR);
+  CHECK((stats->bad_nb == 0U) && (sim_scans == 0U) && (sim_changes == 0U),
+        "clean network: %u bad samples, %u scans, %u changes", (unsigned)stats->bad_nb, (unsigned)sim_scans,
+        (unsigned)sim_changes);
+  CHECK(stats->sample_nb >= ((24U * HOUR) / AGILITY_SAMPLE_PERIOD), "%u samples in a day", (unsigned)stats->sample_nb);
+
+  /* Every 10 minutes a neighbor ages out, or its counter is reset, then it comes back:
+   * the failures sum drops, as when an 8 bits counter wraps */
+  Sim_Network_Reset();
+  for (hour = 0U; hour < (24U * 6U); hour++)
+  {
+    Sim_Run(10U * MINUTE);
+    i = Sim_Random() % NEIGHBOR_NB;
+    if (i == (NEIGHBOR_NB / 2U))
+    {
+      continue;
+    }
+    if ((hour & 1U) != 0U)
+    {
+      sim_neighbors[i].nwkAddr = ZB_NWK_ADDR_UNDEFINED;
+      Sim_Run(3U * MINUTE);
+      sim_neighbors[i].nwkAddr = (uint16_t)(0x2000U + hour);
+    }
+    sim_neighbors[i].txFailure = 0U;
+  }
+  CHECK((stats->bad_nb == 0U) && (sim_scans == 0U) && (sim_changes == 0U),
+        "neighbors aging out: %u bad samples, %u scans, %u changes", (unsigned)stats->bad_nb, (unsigned)sim_scans,
+        (unsigned)sim_changes);
+  printf("  clean network, neighbors aging out every 10 min: %u samples, %u bad, %u scans, %u changes,"
+         " %.1f%% commands delivered\n", (unsigned)stats->sample_nb, (unsigned)stats->bad_nb, (unsigned)sim_scans,
+         (unsigned)sim_changes, Rate(&(Sim_Count_t){ 0U, 0U }, &sim_cmds));
+
+  /* Too few transmissions to conclude, even all failed */
+  Sim_Network_Reset();
+  sim_tx_per_s = 0U;
+  Sim_Interference(0U, WPAN_PAGE_CHANNELS_MAX, 1000U);
+  for (i = 0U; i < (4U * HOUR); i++)
+  {
+    if ((i % 6U) == 0U)
+    {
+      Sim_Command();
+    }
+    Sim_Run(1U);
+  }
+  CHECK((stats->bad_nb == 0U) && (sim_scans == 0U), "low traffic: %u bad samples, %u scans", (unsigned)stats->bad_nb,
+        (unsigned)sim_scans);
+}
+
+/* Interference on the channel of the network, command success before and after the change */
+static void Check_Interference(void)
+{
+  const Agility_Stats_T *stats = App_Zigbee_Agility_Get_Stats();
+  Sim_Count_t start, jam, change;
+  uint64_t jam_time;
+  uint8_t  left;
+
+  Sim_Network_Reset();
+  start = sim_cmds;
+  Sim_Run(HOUR);
+
+  /* Wi-Fi over channels 13 to 17, 40 % of the commands lost */
+  Sim_Interference(FORM_CHANNEL - 2U, 5U, 400U);
+  jam      = sim_cmds;
+  jam_time = sim_time;
+  while ((sim_changes == 0U) && (sim_time < (jam_time + (HOUR * PS_PER_S))))
+  {
+    Sim_Run(1U);
+  }
+  change = sim_cmds;
+  left   = stats->last_channel;
+  CHECK(sim_changes == 1U, "no channel change under interference");
+  CHECK((sim_channel < (FORM_CHANNEL - 2U)) || (sim_channel >= (FORM_CHANNEL + 3U)), "moved to jammed channel %u",
+        sim_channel);
+  CHECK(left == FORM_CHANNEL, "channel %u left instead of %u", left, FORM_CHANNEL);
+  CHECK((sim_change_time - jam_time) <= (((AGILITY_BAD_SAMPLE_NB + 1U) * sim_timer_period) + (2U * PS_PER_S)),
+        "change %u s after the interference", (unsigned)((sim_change_time - jam_time) / PS_PER_S));
+
+  Sim_Run(HOUR);
+  CHECK(sim_changes == 1U, "%u channel changes", (unsigned)sim_changes);
+  CHECK((stats->rate_before < 75U) && (stats->rate_after > 90U), "success %u%% before the change, %u%% after",
+        stats->rate_before, stats->rate_after);
+  CHECK(Rate(&change, &sim_cmds) > 95.0, "%.1f%% commands delivered after the change", Rate(&change, &sim_cmds));
+  printf("  interference at 60 min on channels 13-17: %.1f%% commands delivered before, %.1f%% under it,"
+         " %.1f%% in the hour after the move from %u to %u, %u s after the interference start"
+         " (samples: %u%% before, %u%% after)\n", Rate(&start, &jam), Rate(&jam, &change), Rate(&change, &sim_cmds),
+         left, sim_channel, (unsigned)((sim_change_time - jam_time) / PS_PER_S), stats->rate_before, stats->rate_after);
+}
+
+/* No channel quieter by the margin: scans, but the network stays */
+static void Check_Everywhere(void)
+{
+  const Agility_Stats_T *stats = App_Zigbee_Agility_Get_Stats();
+
+  Sim_Network_Reset();
+  Sim_Run(HOUR);
+  Sim_Interference(0U, WPAN_PAGE_CHANNELS_MAX, 400U);
+  Sim_Run(HOUR);
+  CHECK((sim_scans != 0U) && (sim_changes == 0U), "interference everywhere: %u scans, %u changes", (unsigned)sim_scans,
+        (unsigned)sim_changes);
+  CHECK(sim_scans <= ((HOUR / AGILITY_SAMPLE_PERIOD) / AGILITY_BAD_SAMPLE_NB), "%u scans in an hour",
+        (unsigned)sim_scans);
+  printf("  interference on every channel for an hour: %u scans, %u changes, %u bad samples\n", (unsigned)sim_scans,
+         (unsigned)sim_changes, (unsigned)stats->bad_nb);
+}
+
+/* Interference following the network: no new change before the hold-off */
+static void Check_Holdoff(void)
+{
+  const Agility_Stats_T *stats = App_Zigbee_Agility_Get_Stats();
+  uint64_t first;
+  uint8_t  channel;
+
+  Sim_Network_Reset();
+  Sim_Run(HOUR);
+  Sim_Interference(sim_channel, 1U, 400U);
+  while ((sim_changes == 0U) && (sim_time < (2U * HOUR * PS_PER_S)))
+  {
+    Sim_Run(1U);
+  }
+  CHECK(sim_changes == 1U, "no channel change");
+  first = sim_change_time;
+
+  for (channel = 0U; channel < WPAN_PAGE_CHANNELS_MAX; channel++)
+  {
+    if (((1UL << channel) & WPAN_CHANNELMASK_2400MHZ) == 0U)
+    {
+      continue;
+    }
+    Sim_Interference(channel, 1U, FAIL_BACKGROUND);
+  }
+  Sim_Interference(sim_channel, 1U, 400U);
+  Sim_Run(3U * HOUR);
+  CHECK(sim_changes == 2U, "%u changes with the interference following the network", (unsigned)sim_changes);
+  CHECK((sim_change_time - first) >= ((uint64_t)AGILITY_HOLDOFF * PS_PER_MS), "second change %u s after the first",
+        (unsigned)((sim_change_time - first) / PS_PER_S));
+  CHECK(stats->holdoff_nb != 0U, "no scan delayed by the hold-off");
+  printf("  interference following the network: second change %u s after the first, %u scans delayed\n",
+         (unsigned)((sim_change_time - first) / PS_PER_S), (unsigned)stats->holdoff_nb);
+}
+
+/* Intermittent interference: bad samples separated by good ones never move the
+ * network, separated by samples between the thresholds they do */
+static void Check_Intermittent(void)
+{
+  const Agility_Stats_T *stats = App_Zigbee_Agility_Get_Stats();
+  uint32_t i;
+
+  Sim_Network_Reset();
+  Sim_Run_Samples(60U);
+  for (i = 0U; i < 60U; i++)
+  {
+    Sim_Interference(sim_channel, 1U, ((i & 1U) != 0U) ? 400U : FAIL_BACKGROUND);
+    Sim_Run_Samples(1U);
+  }
+  CHECK((stats->bad_nb != 0U) && (sim_scans == 0U), "bad samples every other sample: %u bad, %u scans",
+        (unsigned)stats->bad_nb, (unsigned)sim_scans);
+
+  for (i = 0U; (i < 60U) && (sim_scans == 0U); i++)
+  {
+    Sim_Interference(sim_channel, 1U, ((i & 1U) != 0U) ? 400U : 170U);
+    Sim_Run_Samples(1U);
+  }
+  CHECK(sim_scans == 1U, "bad samples separated by samples above the low threshold: %u scans", (unsigned)sim_scans);
+  printf("  intermittent interference: no scan when the bad samples alternate with good ones,"
+         " scan after %u samples when they alternate with 17%% failures\n", (unsigned)i);
+}
+
+/* Decision on synthetic counters: wrap of the Tx counter, drop of the failures sum */
+static void Check_Counters(void)
+{
+  const Agility_Stats_T *stats = App_Zigbee_Agility_Get_Stats();
+
+  Sim_Network_Reset();
+  (void)App_Zigbee_Agility_Step(0xFFF0U, 300U, 0U);
+  CHECK(App_Zigbee_Agility_Step(0x0050U, 302U, 60000U) == AGILITY_ACTION_NONE, "Tx counter wrap");
+  CHECK(stats->success_rate == 98U, "success %u%% over the Tx counter wrap", stats->success_rate);
+
+  /* Two bad samples, a drop of the failures sum neither counts as bad nor clears them */
+  (void)App_Zigbee_Agility_Step(0x00B0U, 350U, 120000U);
+  (void)App_Zigbee_Agility_Step(0x0110U, 398U, 180000U);
+  CHECK(stats->bad_nb == 2U, "%u bad samples", (unsigned)stats->bad_nb);
+  CHECK(App_Zigbee_Agility_Step(0x0170U, 10U, 240000U) == AGILITY_ACTION_NONE, "failures sum drop");
+  CHECK((stats->success_rate == 50U) && (stats->bad_nb == 2U), "success %u%% on a failures sum drop, %u bad",
+        stats->success_rate, (unsigned)stats->bad_nb);
+  CHECK(App_Zigbee_Agility_Step(0x01D0U, 58U, 300000U) == AGILITY_ACTION_SCAN, "third bad sample after a drop");
+  CHECK((stats->success_rate == 50U) && (stats->bad_nb == 3U), "success %u%% from the new baseline, %u bad",
+        stats->success_rate, (unsigned)stats->bad_nb);
+}
+
+static void Usage(void)
+{
+  fprintf(stderr, "usage: agility_sim\n");
+  exit(2);
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char * argv[])
+{
+  if (argc > 1)
+  {
+    Usage();
+  }
+  (void)argv;
+
+  app_zb_info.zb          = (struct ZigBeeT *)&sim_zb;
+  app_zb_info.join_status = ZB_STATUS_SUCCESS;
+
+  Check_Counters();
+  Check_Clean();
+  Check_Interference();
+  Check_Everywhere();
+  Check_Holdoff();
+  Check_Intermittent();
+
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,371 @@
+/**
+  ******************************************************************************
+  * @file    channel_rank.c
+  * @author  Zigbee Application Team
+  * @brief   Energy scan and channel selection of the coordinator on simulated
+  *          per channel energy tables. The ranking of the unmodified
+  *          app_zigbee_channel.c is checked against a reference sort on
+  *          random tables and masks, with many ties, then the scan goes
+  *          through a simulated ED scan: Wi-Fi channels 1, 6 and 11, channels
+  *          left unscanned, a failed or refused scan.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2019-2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+/* The stub configuration comes first: the include guards it shares with the
+ * application headers keep them out */
+#include "app_conf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The logs of the application are counted, not printed */
+int Sim_Printf(const char *format, ...);
+#define printf Sim_Printf
+
+/* Code under test, built as is to reach the scan results */
+#include "app_zigbee_channel.c"
+
+#undef printf
+
+/* Private defines -----------------------------------------------------------*/
+#define RANDOM_DEFAULT          100000U
+
+#define ENERGY_BACKGROUND       40U
+#define ENERGY_WIFI             200U
+
+/* Private variables ---------------------------------------------------------*/
+App_Zb_Info_T               app_zb_info;
+
+static long                 failures;
+static uint32_t             sim_rng = 0x2545F491U;
+static uint32_t             sim_zb;
+
+/* Simulated ED scan */
+static uint8_t              sim_energy[WPAN_PAGE_CHANNELS_MAX];
+static uint32_t             sim_unscanned;
+static enum ZbStatusCodeT   sim_req_status;
+static enum ZbStatusCodeT   sim_conf_status;
+static uint32_t             sim_req_mask;
+static UTIL_SEQ_bm_t        sim_events;
+static uint32_t             sim_waits;
+static uint32_t             sim_logs;
+
+/* Private functions ---------------------------------------------------------*/
+#define CHECK(cond, ...) \
+  do \
+  { \
+    if (!(cond)) \
+    { \
+      if (failures < 20) \
+      { \
+        fprintf(stderr, "  "); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+      } \
+      failures++; \
+    } \
+  } while (0)
+
+static uint32_t Sim_Random(void)
+{
+  sim_rng ^= sim_rng << 13;
+  sim_rng ^= sim_rng >> 17;
+  sim_rng ^= sim_rng << 5;
+  return sim_rng;
+}
+
+/* Simulated platform --------------------------------------------------------*/
+int Sim_Printf(const char *format, ...)
+{
+  if (strchr(format, '\n') != NULL)
+  {
+    sim_logs++;
+  }
+  return 0;
+}
+
+const char *DbgTraceGetFileName(const char *fullpath)
+{
+  const char *ret = strrchr(fullpath, '/');
+
+  return (ret != NULL) ? (ret + 1) : fullpath;
+}
+
+uint32_t HAL_GetTick(void)
+{
+  return 0U;
+}
+
+void UTIL_SEQ_SetEvt(UTIL_SEQ_bm_t EvtId_bm)
+{
+  sim_events |= EvtId_bm;
+}
+
+/* The ED scan confirm is given before the wait */
+void UTIL_SEQ_WaitEvt(UTIL_SEQ_bm_t EvtId_bm)
+{
+  CHECK((sim_events & EvtId_bm) != 0U, "wait of event 0x%X never set", (unsigned)EvtId_bm);
+  sim_events &= ~EvtId_bm;
+  sim_waits++;
+}
+
+enum ZbStatusCodeT ZbNlmeEdScanReq(struct ZigBeeT *zb, struct ZbNlmeEdScanReqT *req,
+                                   void (*callback)(struct ZbNlmeEdScanConfT *scanConf, void *arg), void *cbarg)
+{
+  struct ZbNlmeEdScanConfT conf;
+
+  CHECK(zb == (struct ZigBeeT *)&sim_zb, "ED scan on another stack instance");
+  CHECK(req->scanDuration == CHANNEL_SCAN_DURATION, "ED scan duration %u", (unsigned)req->scanDuration);
+  sim_req_mask = req->channelMask;
+  if (sim_req_status != ZB_STATUS_SUCCESS)
+  {
+    return sim_req_status;
+  }
+
+  memset(&conf, 0, sizeof(conf));
+  memcpy(conf.energyDetectList, sim_energy, sizeof(conf.energyDetectList));
+  conf.unscannedChannels = sim_unscanned;
+  conf.status            = sim_conf_status;
+  callback(&conf, cbarg);
+  return ZB_STATUS_SUCCESS;
+}
+
+/* Reference ranking ---------------------------------------------------------*/
+static const uint8_t *ref_energy;
+
+/* Quietest first, then the HA channels, then the lowest channel number */
+static int Ref_Compare(const void *pA, const void *pB)
+{
+  uint8_t a = *(const uint8_t *)pA;
+  uint8_t b = *(const uint8_t *)pB;
+  int a_ha = ((ZB_CHANNELMASK_2400MHZ_HA >> a) & 1U) ? 0 : 1;
+  int b_ha = ((ZB_CHANNELMASK_2400MHZ_HA >> b) & 1U) ? 0 : 1;
+
+  if (ref_energy[a] != ref_energy[b])
+  {
+    return (int)ref_energy[a] - (int)ref_energy[b];
+  }
+  if (a_ha != b_ha)
+  {
+    return a_ha - b_ha;
+  }
+  return (int)a - (int)b;
+}
+
+static uint8_t Ref_Rank(const uint8_t *energy, uint32_t mask, uint8_t *rank)
+{
+  uint8_t order[WPAN_PAGE_CHANNELS_MAX];
+  uint8_t count = 0U;
+  uint8_t i;
+
+  memset(rank, 0, WPAN_PAGE_CHANNELS_MAX);
+  for (i = 0U; i < WPAN_PAGE_CHANNELS_MAX; i++)
+  {
+    if ((mask & (1UL << i)) != 0U)
+    {
+      order[count++] = i;
+    }
+  }
+  ref_energy = energy;
+  qsort(order, count, sizeof(order[0]), Ref_Compare);
+  for (i = 0U; i < count; i++)
+  {
+    rank[order[i]] = (uint8_t)(i + 1U);
+  }
+  return (count != 0U) ? order[0] : 0xffU;
+}
+
+/* Energy of the Zigbee channels under 20 MHz wide Wi-Fi channels */
+static void Wifi_Table(uint8_t *energy, const uint8_t *wifi, uint8_t count)
+{
+  uint8_t channel, i;
+  int32_t  zigbee_mhz, wifi_mhz;
+
+  for (channel = 0U; channel < WPAN_PAGE_CHANNELS_MAX; channel++)
+  {
+    energy[channel] = ENERGY_BACKGROUND;
+    zigbee_mhz = 2405 + (5 * ((int32_t)channel - 11));
+    for (i = 0U; i < count; i++)
+    {
+      wifi_mhz = 2412 + (5 * ((int32_t)wifi[i] - 1));
+      if ((zigbee_mhz > (wifi_mhz - 11)) && (zigbee_mhz < (wifi_mhz + 11)))
+      {
+        energy[channel] = ENERGY_WIFI;
+      }
+    }
+  }
+}
+
+/* Checks --------------------------------------------------------------------*/
+static void Check_Rank(const uint8_t *energy, uint32_t mask)
+{
+  uint8_t rank[WPAN_PAGE_CHANNELS_MAX];
+  uint8_t ref[WPAN_PAGE_CHANNELS_MAX];
+  uint8_t best, ref_best, i;
+
+  memset(rank, 0xA5, sizeof(rank));
+  best     = App_Zigbee_Channel_Rank(energy, mask, rank);
+  ref_best = Ref_Rank(energy, mask, ref);
+  CHECK(best == ref_best, "mask 0x%08X: quietest %u instead of %u", (unsigned)mask, best, ref_best);
+  for (i = 0U; i < WPAN_PAGE_CHANNELS_MAX; i++)
+  {
+    CHECK(rank[i] == ref[i], "mask 0x%08X: channel %u (energy %u) ranked %u instead of %u", (unsigned)mask, i,
+          energy[i], rank[i], ref[i]);
+  }
+}
+
+/* Random tables over a few energy levels to have ties, random masks */
+static void Check_Random(uint32_t Number)
+{
+  uint8_t  energy[WPAN_PAGE_CHANNELS_MAX];
+  uint32_t mask, n;
+  uint8_t  levels, i;
+
+  for (n = 0U; n < Number; n++)
+  {
+    levels = (uint8_t)(1U + (Sim_Random() % 8U));
+    for (i = 0U; i < WPAN_PAGE_CHANNELS_MAX; i++)
+    {
+      energy[i] = (uint8_t)((Sim_Random() % levels) * (256U / levels));
+    }
+    switch (n % 4U)
+    {
+      case 0:
+        mask = WPAN_CHANNELMASK_2400MHZ;
+        break;
+      case 1:
+        mask = Sim_Random() & WPAN_CHANNELMASK_2400MHZ;
+        break;
+      case 2:
+        mask = 1UL << (11U + (Sim_Random() % 16U));
+        break;
+      default:
+        mask = Sim_Random() & ((1UL << WPAN_PAGE_CHANNELS_MAX) - 1U);
+        break;
+    }
+    Check_Rank(energy, mask);
+  }
+
+  /* Empty mask, flat table */
+  memset(energy, ENERGY_BACKGROUND, sizeof(energy));
+  Check_Rank(energy, 0U);
+  Check_Rank(energy, WPAN_CHANNELMASK_2400MHZ);
+}
+
+/* Scans through the simulated ED scan */
+static void Check_Scan(void)
+{
+  static const uint8_t wifi_1_6_11[] = { 1U, 6U, 11U };
+  static const uint8_t wifi_1_6_13[] = { 1U, 6U, 13U };
+  const App_Zb_Channel_Info_T *info = App_Zigbee_Channel_Get_Info();
+  enum ZbStatusCodeT status;
+  uint8_t i;
+
+  CHECK(App_Zigbee_Channel_Select() == CHANNEL_DEFAULT, "channel %u before any scan", App_Zigbee_Channel_Select());
+
+  /* Wi-Fi 1, 6 and 11 leave 15, 20, 25 and 26 free: 15 is a HA channel and the lowest */
+  Wifi_Table(sim_energy, wifi_1_6_11, 3U);
+  sim_req_status  = ZB_STATUS_SUCCESS;
+  sim_conf_status = ZB_STATUS_SUCCESS;
+  sim_unscanned   = 0U;
+  status = App_Zigbee_Channel_Scan((struct ZigBeeT *)&sim_zb, CHANNEL_SCAN_MASK);
+  CHECK((status == ZB_STATUS_SUCCESS) && (sim_req_mask == CHANNEL_SCAN_MASK), "scan status 0x%02X, mask 0x%08X",
+        status, (unsigned)sim_req_mask);
+  CHECK(App_Zigbee_Channel_Select() == 15U, "Wi-Fi 1, 6, 11: channel %u", App_Zigbee_Channel_Select());
+  printf("  Wi-Fi 1, 6, 11:");
+  for (i = 11U; i <= 26U; i++)
+  {
+    printf(" %u:%u/%u", i, info->energy[i], info->rank[i]);
+  }
+  printf(" -> %u\n", App_Zigbee_Channel_Select());
+
+  /* Wi-Fi 13 covers 25 and 26 and a quieter 20 is chosen */
+  Wifi_Table(sim_energy, wifi_1_6_13, 3U);
+  sim_energy[20] = ENERGY_BACKGROUND - 10U;
+  (void)App_Zigbee_Channel_Scan((struct ZigBeeT *)&sim_zb, CHANNEL_SCAN_MASK);
+  CHECK(App_Zigbee_Channel_Select() == 20U, "Wi-Fi 1, 6, 13: channel %u", App_Zigbee_Channel_Select());
+
+  /* A quiet channel left unscanned is not selected */
+  sim_unscanned = 1UL << 20;
+  (void)App_Zigbee_Channel_Scan((struct ZigBeeT *)&sim_zb, CHANNEL_SCAN_MASK);
+  CHECK((App_Zigbee_Channel_Select() == 15U) && (info->rank[20] == 0U), "unscanned channel 20: channel %u, rank %u",
+        App_Zigbee_Channel_Select(), info->rank[20]);
+
+  /* Only a part of the band, all under Wi-Fi: the lowest channel */
+  sim_unscanned = 0U;
+  (void)App_Zigbee_Channel_Scan((struct ZigBeeT *)&sim_zb, ZB_CHANNELMASK_2400MHZ_HA & ~(1UL << 15) & ~(1UL << 20));
+  CHECK(App_Zigbee_Channel_Select() == 11U, "HA channels without 15 and 20: channel %u", App_Zigbee_Channel_Select());
+
+  /* A failed scan keeps the previous results */
+  sim_conf_status = ZB_NWK_STATUS_INVALID_REQUEST;
+  status = App_Zigbee_Channel_Scan((struct ZigBeeT *)&sim_zb, CHANNEL_SCAN_MASK);
+  CHECK((status == ZB_NWK_STATUS_INVALID_REQUEST) && (App_Zigbee_Channel_Select() == 11U),
+        "failed scan: status 0x%02X, channel %u", status, App_Zigbee_Channel_Select());
+
+  /* A refused scan does not wait */
+  sim_conf_status = ZB_STATUS_SUCCESS;
+  sim_req_status  = ZB_NWK_STATUS_INVALID_REQUEST;
+  sim_waits       = 0U;
+  status = App_Zigbee_Channel_Scan((struct ZigBeeT *)&sim_zb, CHANNEL_SCAN_MASK);
+  CHECK((status == ZB_NWK_STATUS_INVALID_REQUEST) && (sim_waits == 0U), "refused scan: status 0x%02X, %u waits",
+        status, (unsigned)sim_waits);
+
+  /* Nothing scanned: no valid result, back to the default channel */
+  sim_req_status = ZB_STATUS_SUCCESS;
+  sim_unscanned  = WPAN_CHANNELMASK_2400MHZ;
+  (void)App_Zigbee_Channel_Scan((struct ZigBeeT *)&sim_zb, CHANNEL_SCAN_MASK);
+  CHECK(App_Zigbee_Channel_Select() == CHANNEL_DEFAULT, "nothing scanned: channel %u", App_Zigbee_Channel_Select());
+
+  /* The menu display */
+  sim_unscanned = 0U;
+  (void)App_Zigbee_Channel_Scan((struct ZigBeeT *)&sim_zb, CHANNEL_SCAN_MASK);
+  sim_logs = 0U;
+  App_Zigbee_Channel_Scan_Disp();
+  CHECK(sim_logs == (3U + 16U + 1U), "%u display lines", (unsigned)sim_logs);
+}
+
+static void Usage(void)
+{
+  fprintf(stderr, "usage: channel_rank [-n random_tables]\n");
+  exit(2);
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char * argv[])
+{
+  uint32_t number = RANDOM_DEFAULT;
+  int i;
+
+  for (i = 1; i < argc; i++)
+  {
+    if ((strcmp(argv[i], "-n") == 0) && ((i + 1) < argc))
+    {
+      number = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+    else
+    {
+      Usage();
+    }
+  }
+
+  app_zb_info.zb = (struct ZigBeeT *)&sim_zb;
+
+  Check_Random(number);
+  Check_Scan();
+
+  printf("  %u random tables ranked as the reference sort\n", (unsigned)number);
+  printf("%s: %ld failures\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+}
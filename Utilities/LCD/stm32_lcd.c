@@ -33,6 +33,12 @@
          BSP_LCD_GetYSize
          BSP_LCD_SetActiveLayer
 
+   - On monochrome displays organized in pages of 8 vertical pixels, the board can
+     also register BSP_LCD_DrawGlyph. The characters are then transposed once in
+     columns, kept in a small cache, and written in one call per character
+     instead of one pixel at a time. The cache size is set by
+     UTIL_LCD_GLYPH_CACHE_NBR.
+
    - At application level, once the LCD is initialized, user should call UTIL_LCD_SetFuncDriver()
      API to link board LCD drivers to BASIC GUI LCD drivers.
      User can then call the BASIC GUI services:
@@ -69,6 +75,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm32_lcd.h"
+#include <string.h>
 #include "../Fonts/font24.c"
 #include "../Fonts/font20.c"
 #include "../Fonts/font16.c"
@@ -95,6 +102,13 @@
   #define UTIL_LCD_MAX_LAYERS_NBR    2U
 #endif
 
+#ifndef UTIL_LCD_GLYPH_CACHE_NBR
+  #define UTIL_LCD_GLYPH_CACHE_NBR   16U
+#endif
+
+/* Size of the biggest glyph in columns: Font24, 17 columns of 3 bytes */
+#define UTIL_LCD_GLYPH_MAX_SIZE      (17U * 3U)
+
 /** @defgroup UTIL_LCD_Private_Macros STM32 LCD Utility Private Macros
   * @{
   */
@@ -127,6 +141,13 @@ typedef struct
   uint32_t y3;
 }Triangle_Positions_t;
 
+typedef struct
+{
+  const sFONT *pFont;                            /* Font of the glyph, NULL if the entry is free */
+  uint8_t      Ascii;                            /* Character of the glyph */
+  uint8_t      Columns[UTIL_LCD_GLYPH_MAX_SIZE]; /* Glyph transposed in columns */
+}Glyph_Cache_t;
+
 /**
   * @}
   */
@@ -141,6 +162,11 @@ typedef struct
 static UTIL_LCD_Ctx_t DrawProp[UTIL_LCD_MAX_LAYERS_NBR];
 static LCD_UTILS_Drv_t FuncDriver;
 
+/**
+  * @brief  Transposed glyphs, direct mapped on the character code
+  */
+static Glyph_Cache_t GlyphCache[UTIL_LCD_GLYPH_CACHE_NBR];
+
 /**
   * @}
   */
@@ -149,6 +175,7 @@ static LCD_UTILS_Drv_t FuncDriver;
   * @{
   */
 static void DrawChar(uint32_t Xpos, uint32_t Ypos, const uint8_t *pData);
+static int32_t DrawGlyph(uint32_t Xpos, uint32_t Ypos, uint8_t Ascii, const uint8_t *pData);
 static void FillTriangle(Triangle_Positions_t *Positions, uint32_t Color);
 /**
   * @}
@@ -175,6 +202,7 @@ void UTIL_LCD_SetFuncDriver(const LCD_UTILS_Drv_t *pDrv)
   FuncDriver.GetYSize       = pDrv->GetYSize;
   FuncDriver.SetLayer       = pDrv->SetLayer;
   FuncDriver.GetFormat      = pDrv->GetFormat;
+  FuncDriver.DrawGlyph      = pDrv->DrawGlyph;
 
   DrawProp->LcdLayer = 0;
   DrawProp->LcdDevice = 0;
@@ -380,8 +408,14 @@ void UTIL_LCD_ClearStringLine(uint32_t Line)
   */
 void UTIL_LCD_DisplayChar(uint32_t Xpos, uint32_t Ypos, uint8_t Ascii)
 {
-  DrawChar(Xpos, Ypos, &DrawProp[DrawProp->LcdLayer].pFont->table[(Ascii-' ') *\
-  DrawProp[DrawProp->LcdLayer].pFont->Height * ((DrawProp[DrawProp->LcdLayer].pFont->Width + 7) / 8)]);
+  const uint8_t *pchar = &DrawProp[DrawProp->LcdLayer].pFont->table[(Ascii-' ') *\
+  DrawProp[DrawProp->LcdLayer].pFont->Height * ((DrawProp[DrawProp->LcdLayer].pFont->Width + 7) / 8)];
+
+  /* Fast path of the page organized displays, pixel by pixel otherwise */
+  if(DrawGlyph(Xpos, Ypos, Ascii, pchar) != 0)
+  {
+    DrawChar(Xpos, Ypos, pchar);
+  }
 }
 
 /**
@@ -1007,6 +1041,60 @@ static void DrawChar(uint32_t Xpos, uint32_t Ypos, const uint8_t *pData)
   }
 }
 
+/**
+  * @brief  Draws a character on LCD with the glyph function of the driver.
+  *         The glyph is transposed in columns of 8 vertical pixels per byte,
+  *         the bit 0 being the top pixel, and kept in the glyph cache.
+  * @param  Xpos  Start column address
+  * @param  Ypos  Line where to display the character shape
+  * @param  Ascii Character ascii code
+  * @param  pData Pointer to the character data
+  * @retval 0 if drawn, the character must be drawn by DrawChar() otherwise
+  */
+static int32_t DrawGlyph(uint32_t Xpos, uint32_t Ypos, uint8_t Ascii, const uint8_t *pData)
+{
+  const sFONT   *pfont = DrawProp[DrawProp->LcdLayer].pFont;
+  Glyph_Cache_t *pglyph;
+  uint32_t i, j;
+  uint32_t width, height, row_bytes, column_bytes;
+
+  if(FuncDriver.DrawGlyph == NULL)
+  {
+    return -1;
+  }
+
+  width        = pfont->Width;
+  height       = pfont->Height;
+  row_bytes    = (width + 7U) / 8U;
+  column_bytes = (height + 7U) / 8U;
+  if((width * column_bytes) > UTIL_LCD_GLYPH_MAX_SIZE)
+  {
+    return -1;
+  }
+
+  pglyph = &GlyphCache[Ascii % UTIL_LCD_GLYPH_CACHE_NBR];
+  if((pglyph->pFont != pfont) || (pglyph->Ascii != Ascii))
+  {
+    /* Transpose the rows of the font in columns */
+    memset(pglyph->Columns, 0, width * column_bytes);
+    for(i = 0; i < height; i++)
+    {
+      for(j = 0; j < width; j++)
+      {
+        if((pData[(i * row_bytes) + (j / 8U)] & (0x80U >> (j % 8U))) != 0U)
+        {
+          pglyph->Columns[(j * column_bytes) + (i / 8U)] |= (uint8_t)(1U << (i % 8U));
+        }
+      }
+    }
+    pglyph->pFont = pfont;
+    pglyph->Ascii = Ascii;
+  }
+
+  return FuncDriver.DrawGlyph(DrawProp->LcdDevice, Xpos, Ypos, pglyph->Columns, width, height,
+                              DrawProp[DrawProp->LcdLayer].TextColor, DrawProp[DrawProp->LcdLayer].BackColor);
+}
+
 /**
   * @brief  Fills a triangle (between 3 points).
   * @param  Positions  pointer to riangle coordinates
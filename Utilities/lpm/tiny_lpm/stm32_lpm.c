@@ -73,6 +73,96 @@
   #define UTIL_LPM_EXIT_CRITICAL_SECTION_ELP( )     UTIL_LPM_EXIT_CRITICAL_SECTION( )
 #endif
 
+/**
+ * @brief enable the residency and wakeup statistics of the low power modes
+ */
+#ifndef UTIL_LPM_STATS_ENABLE
+  #define UTIL_LPM_STATS_ENABLE   (0)
+#endif
+
+#if ( UTIL_LPM_STATS_ENABLE == 1 )
+/**
+ * @brief macro returning a free running 32 bits timestamp still counting in low power mode
+ *        (RTC, LPTIM), its unit is the unit of all the statistics
+ */
+#ifndef UTIL_LPM_GET_TIMESTAMP
+  #error "UTIL_LPM_GET_TIMESTAMP shall be defined when UTIL_LPM_STATS_ENABLE is set"
+#endif
+
+/**
+ * @brief macro returning the UTIL_LPM_WakeupSource_t that woke up the system
+ * @note  called in critical section when leaving the low power mode, the interrupt
+ *        of the wakeup source is still pending
+ */
+#ifndef UTIL_LPM_GET_WAKEUP_SOURCE
+  #define UTIL_LPM_GET_WAKEUP_SOURCE( )   UTIL_LPM_WAKEUP_UNKNOWN
+#endif
+
+#define UTIL_LPM_STATS_ENTER( )           uint32_t lpm_enter_time = UTIL_LPM_GET_TIMESTAMP( ); \
+                                          uint32_t lpm_wake_time = lpm_enter_time
+#define UTIL_LPM_STATS_EXIT( mode, bm )   do { lpm_wake_time = UTIL_LPM_GET_TIMESTAMP( );                      \
+                                               LPM_Account( ( mode ), ( bm ), lpm_enter_time, lpm_wake_time, \
+                                                            UTIL_LPM_GET_WAKEUP_SOURCE( ) ); } while( 0 )
+#define UTIL_LPM_STATS_STOP_EXIT( )       LPM_StopExitMeasure( UTIL_LPM_GET_TIMESTAMP( ) - lpm_wake_time )
+#else
+#define UTIL_LPM_STATS_ENTER( )
+#define UTIL_LPM_STATS_EXIT( mode, bm )
+#define UTIL_LPM_STATS_STOP_EXIT( )
+#endif
+
+/**
+ * @brief enable the selection of the sleep mode instead of the stop mode, and of the stop
+ *        mode instead of the off mode, when the next wakeup is closer than their break-even time
+ */
+#ifndef UTIL_LPM_PREDICT_ENABLE
+  #define UTIL_LPM_PREDICT_ENABLE   (0)
+#endif
+
+#if ( UTIL_LPM_PREDICT_ENABLE == 1 )
+#if ( UTIL_LPM_STATS_ENABLE != 1 )
+  #error "UTIL_LPM_PREDICT_ENABLE requires UTIL_LPM_STATS_ENABLE to measure the stop exit time"
+#endif
+
+/**
+ * @brief macro returning the time left before the next planned wakeup (timer server),
+ *        in the unit of UTIL_LPM_GET_TIMESTAMP
+ */
+#ifndef UTIL_LPM_GET_NEXT_WAKEUP
+  #error "UTIL_LPM_GET_NEXT_WAKEUP shall be defined when UTIL_LPM_PREDICT_ENABLE is set"
+#endif
+
+/**
+ * @brief shortest stop period worth its entry cost, in the unit of UTIL_LPM_GET_TIMESTAMP.
+ *        The measured stop exit time (clock restore) is added to get the break-even time
+ */
+#ifndef UTIL_LPM_STOP_BREAK_EVEN
+  #define UTIL_LPM_STOP_BREAK_EVEN  (2U)
+#endif
+
+/**
+ * @brief shortest off period worth its entry cost, on top of the stop one, in the unit of
+ *        UTIL_LPM_GET_TIMESTAMP. The exit of the off mode restarts the application, its time
+ *        is not measured
+ */
+#ifndef UTIL_LPM_OFF_BREAK_EVEN
+  #define UTIL_LPM_OFF_BREAK_EVEN   (64U)
+#endif
+
+#define UTIL_LPM_BREAK_EVEN( )          ( UTIL_LPM_STOP_BREAK_EVEN + ( LpmStats.StopExitAvg >> UTIL_LPM_AVG_SHIFT ) )
+#define UTIL_LPM_OFF_BREAK_EVEN_TIME( ) ( UTIL_LPM_BREAK_EVEN( ) + UTIL_LPM_OFF_BREAK_EVEN )
+#define UTIL_LPM_PREDICT_STATS( mode )  LPM_PredictAccount( ( mode ), lpm_next_wakeup, lpm_break_even )
+#else
+#define UTIL_LPM_GET_NEXT_WAKEUP( )     UTIL_LPM_NO_WAKEUP
+#define UTIL_LPM_BREAK_EVEN( )          ( 0U )
+#define UTIL_LPM_OFF_BREAK_EVEN_TIME( ) ( 0U )
+#define UTIL_LPM_PREDICT_STATS( mode )
+#endif
+
+/**
+ * @brief weight of the last measure in the average of the stop exit time ( 1 / 2^n )
+ */
+#define UTIL_LPM_AVG_WEIGHT   (3U)
+
 /**
  * @}
  */
@@ -89,6 +179,11 @@
  */
 #define UTIL_LPM_NO_BIT_SET   (0UL)
 
+/**
+ * @brief value used when no wakeup is planned
+ */
+#define UTIL_LPM_NO_WAKEUP    (0xFFFFFFFFUL)
+
 /**
  * @}
  */
@@ -108,11 +203,135 @@ static UTIL_LPM_bm_t StopModeDisable = UTIL_LPM_NO_BIT_SET;
  */
 static UTIL_LPM_bm_t OffModeDisable = UTIL_LPM_NO_BIT_SET;
 
+#if ( UTIL_LPM_STATS_ENABLE == 1 )
+/**
+ * @brief statistics of the low power modes
+ */
+static UTIL_LPM_Stats_t LpmStats;
+
+/**
+ * @brief timestamp of the last exit from low power mode (or of the reset of the statistics)
+ */
+static uint32_t LpmExitTime;
+#endif
+
 /**
  * @}
  */
 /* Global variables ----------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
+#if ( UTIL_LPM_STATS_ENABLE == 1 )
+static void LPM_Account( UTIL_LPM_Mode_t mode, UTIL_LPM_bm_t block_bm, uint32_t enter_time,
+                         uint32_t exit_time, UTIL_LPM_WakeupSource_t source );
+static void LPM_StopExitMeasure( uint32_t exit_time );
+#endif
+#if ( UTIL_LPM_PREDICT_ENABLE == 1 )
+static void LPM_PredictAccount( UTIL_LPM_Mode_t mode, uint32_t next_wakeup, uint32_t break_even );
+#endif
+
+/* Private functions ---------------------------------------------------------*/
+#if ( UTIL_LPM_STATS_ENABLE == 1 )
+/**
+ * @brief  Account a low power period
+ * @note   Only depends on its parameters and the statistics, called in critical section
+ * @param  mode: low power mode entered
+ * @param  block_bm: users that disallowed the deeper mode
+ * @param  enter_time: timestamp before entering the low power mode
+ * @param  exit_time: timestamp after the wakeup
+ * @param  source: source of the wakeup
+ */
+static void LPM_Account( UTIL_LPM_Mode_t mode, UTIL_LPM_bm_t block_bm, uint32_t enter_time,
+                         uint32_t exit_time, UTIL_LPM_WakeupSource_t source )
+{
+  uint32_t duration = exit_time - enter_time;
+  uint32_t *block_time = ( mode == UTIL_LPM_SLEEPMODE ) ? LpmStats.StopBlockTime : LpmStats.OffBlockTime;
+  uint32_t id;
+
+  LpmStats.RunTime += enter_time - LpmExitTime;
+  LpmExitTime = exit_time;
+
+  LpmStats.Residency[mode] += duration;
+  LpmStats.EntryNb[mode]++;
+
+  /* The users that kept the system out of the deeper mode are charged for the whole period */
+  if( mode != UTIL_LPM_OFFMODE )
+  {
+    for( id = 0; ( block_bm != UTIL_LPM_NO_BIT_SET ) && ( id < UTIL_LPM_ID_NB ); id++ )
+    {
+      if( ( block_bm & ( 1UL << id ) ) != 0U )
+      {
+        block_time[id] += duration;
+        block_bm &= ~( 1UL << id );
+      }
+    }
+  }
+
+  if( (uint32_t)source >= (uint32_t)UTIL_LPM_WAKEUP_NB )
+  {
+    source = UTIL_LPM_WAKEUP_UNKNOWN;
+  }
+  LpmStats.WakeupNb[source]++;
+}
+
+/**
+ * @brief  Update the average time to restore the system after a stop mode
+ * @param  exit_time: time spent in the exit function of the stop mode
+ */
+static void LPM_StopExitMeasure( uint32_t exit_time )
+{
+  uint32_t avg = LpmStats.StopExitAvg;
+  uint32_t sample = exit_time << UTIL_LPM_AVG_SHIFT;
+
+  /* Fixed point average, the first measure initializes it */
+  if( avg == 0U )
+  {
+    avg = sample;
+  }
+  else
+  {
+    avg = avg - ( avg >> UTIL_LPM_AVG_WEIGHT ) + ( sample >> UTIL_LPM_AVG_WEIGHT );
+  }
+  LpmStats.StopExitAvg = avg;
+}
+#endif
+
+#if ( UTIL_LPM_PREDICT_ENABLE == 1 )
+/**
+ * @brief  Account the decisions of the prediction
+ * @param  mode: low power mode selected
+ * @param  next_wakeup: time left before the next planned wakeup
+ * @param  break_even: break-even time of the stop mode
+ */
+static void LPM_PredictAccount( UTIL_LPM_Mode_t mode, uint32_t next_wakeup, uint32_t break_even )
+{
+  if( mode == UTIL_LPM_STOPMODE )
+  {
+    if( OffModeDisable == UTIL_LPM_NO_BIT_SET )
+    {
+      /* Off allowed but the next wakeup is too close */
+      LpmStats.PredictStopNb++;
+    }
+    return;
+  }
+
+  if( mode != UTIL_LPM_SLEEPMODE )
+  {
+    return;
+  }
+
+  if( StopModeDisable == UTIL_LPM_NO_BIT_SET )
+  {
+    /* Stop allowed but the next wakeup is too close */
+    LpmStats.PredictSleepNb++;
+  }
+  else if( next_wakeup >= break_even )
+  {
+    /* Stop would have been worth it, a user kept the system in sleep mode */
+    LpmStats.LongSleepNb++;
+  }
+}
+#endif
+
 /* Functions Definition ------------------------------------------------------*/
 
 /** @addtogroup TINY_LPM_Exported_function
@@ -123,6 +342,7 @@ void UTIL_LPM_Init( void )
   StopModeDisable = UTIL_LPM_NO_BIT_SET;
   OffModeDisable = UTIL_LPM_NO_BIT_SET;
   UTIL_LPM_INIT_CRITICAL_SECTION( );
+  UTIL_LPM_ResetStats( );
 }
 
 void UTIL_LPM_DeInit( void )
@@ -212,43 +432,111 @@ UTIL_LPM_Mode_t UTIL_LPM_GetMode( void )
   return mode_selected;
 }
 
+UTIL_LPM_Mode_t UTIL_LPM_SelectMode( UTIL_LPM_bm_t stop_bm, UTIL_LPM_bm_t off_bm,
+                                     uint32_t next_wakeup, uint32_t break_even,
+                                     uint32_t off_break_even )
+{
+  UTIL_LPM_Mode_t mode_selected;
+
+  if( ( stop_bm == UTIL_LPM_NO_BIT_SET ) && ( off_bm == UTIL_LPM_NO_BIT_SET ) &&
+      ( next_wakeup >= off_break_even ) )
+  {
+    mode_selected = UTIL_LPM_OFFMODE;
+  }
+  else if( ( stop_bm == UTIL_LPM_NO_BIT_SET ) && ( next_wakeup >= break_even ) )
+  {
+    /**
+     * At least one user disallows Off Mode or the next wakeup is too close for it
+     */
+    mode_selected = UTIL_LPM_STOPMODE;
+  }
+  else
+  {
+    /**
+     * At least one user disallows Stop Mode or the next wakeup is too close for it
+     */
+    mode_selected = UTIL_LPM_SLEEPMODE;
+  }
+
+  return mode_selected;
+}
+
 void UTIL_LPM_EnterLowPower( void )
 {
+  UTIL_LPM_Mode_t mode;
+  uint32_t lpm_next_wakeup;
+  uint32_t lpm_break_even;
+  uint32_t lpm_off_break_even;
+
   UTIL_LPM_ENTER_CRITICAL_SECTION_ELP( );
+  UTIL_LPM_STATS_ENTER( );
 
-  if( StopModeDisable != UTIL_LPM_NO_BIT_SET )
+  lpm_next_wakeup = UTIL_LPM_GET_NEXT_WAKEUP( );
+  lpm_break_even = UTIL_LPM_BREAK_EVEN( );
+  lpm_off_break_even = UTIL_LPM_OFF_BREAK_EVEN_TIME( );
+  mode = UTIL_LPM_SelectMode( StopModeDisable, OffModeDisable, lpm_next_wakeup, lpm_break_even,
+                              lpm_off_break_even );
+  UTIL_LPM_PREDICT_STATS( mode );
+
+  if( mode == UTIL_LPM_SLEEPMODE )
   {
     /**
-     * At least one user disallows Stop Mode
      * SLEEP mode is required
      */
       UTIL_PowerDriver.EnterSleepMode( );
+      UTIL_LPM_STATS_EXIT( UTIL_LPM_SLEEPMODE, StopModeDisable );
       UTIL_PowerDriver.ExitSleepMode( );
   }
+  else if( mode == UTIL_LPM_STOPMODE )
+  {
+    /**
+     * STOP mode is required
+     */
+      UTIL_PowerDriver.EnterStopMode( );
+      UTIL_LPM_STATS_EXIT( UTIL_LPM_STOPMODE, OffModeDisable );
+      UTIL_PowerDriver.ExitStopMode( );
+      UTIL_LPM_STATS_STOP_EXIT( );
+  }
   else
-  { 
-    if( OffModeDisable != UTIL_LPM_NO_BIT_SET )
-    {
-      /**
-       * At least one user disallows Off Mode
-       * STOP mode is required
-       */
-        UTIL_PowerDriver.EnterStopMode( );
-        UTIL_PowerDriver.ExitStopMode( );
-    }
-    else
-    {
-      /**
-       * OFF mode is required
-       */
-      UTIL_PowerDriver.EnterOffMode( );
-      UTIL_PowerDriver.ExitOffMode( );
-    }
+  {
+    /**
+     * OFF mode is required
+     */
+    UTIL_PowerDriver.EnterOffMode( );
+    UTIL_LPM_STATS_EXIT( UTIL_LPM_OFFMODE, UTIL_LPM_NO_BIT_SET );
+    UTIL_PowerDriver.ExitOffMode( );
   }
   
   UTIL_LPM_EXIT_CRITICAL_SECTION_ELP( );
 }
 
+void UTIL_LPM_GetStats( UTIL_LPM_Stats_t *stats )
+{
+#if ( UTIL_LPM_STATS_ENABLE == 1 )
+  UTIL_LPM_ENTER_CRITICAL_SECTION( );
+
+  *stats = LpmStats;
+  /* Add the ongoing run period */
+  stats->RunTime += UTIL_LPM_GET_TIMESTAMP( ) - LpmExitTime;
+
+  UTIL_LPM_EXIT_CRITICAL_SECTION( );
+#else
+  memset( stats, 0, sizeof( UTIL_LPM_Stats_t ) );
+#endif
+}
+
+void UTIL_LPM_ResetStats( void )
+{
+#if ( UTIL_LPM_STATS_ENABLE == 1 )
+  UTIL_LPM_ENTER_CRITICAL_SECTION( );
+
+  memset( &LpmStats, 0, sizeof( LpmStats ) );
+  LpmExitTime = UTIL_LPM_GET_TIMESTAMP( );
+
+  UTIL_LPM_EXIT_CRITICAL_SECTION( );
+#endif
+}
+
 /**
  * @}
  */
@@ -61,6 +61,68 @@ typedef enum
   UTIL_LPM_OFFMODE,
 } UTIL_LPM_Mode_t;
 
+/**
+ * @brief type definition to represent the source of a wakeup from low power mode
+ */
+typedef enum
+{
+  UTIL_LPM_WAKEUP_UNKNOWN,
+  UTIL_LPM_WAKEUP_IPCC,   /*!<message from the radio CPU     */
+  UTIL_LPM_WAKEUP_RTC,    /*!<RTC wakeup timer (timer server) */
+  UTIL_LPM_WAKEUP_EXTI,   /*!<external line (button)          */
+  UTIL_LPM_WAKEUP_UART,   /*!<UART reception                  */
+  UTIL_LPM_WAKEUP_NB,
+} UTIL_LPM_WakeupSource_t;
+
+/**
+ * @}
+ */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup TINY_LPM_Exported_constants TINY LPM exported constants
+  * @{
+  */
+
+/**
+ * @brief number of low power modes
+ */
+#define UTIL_LPM_MODE_NB      (3U)
+
+/**
+ * @brief number of users of the low power manager ( 1 bit per user )
+ */
+#define UTIL_LPM_ID_NB        (32U)
+
+/**
+ * @brief number of fractional bits of the average stop exit time
+ */
+#define UTIL_LPM_AVG_SHIFT    (4U)
+
+/**
+ * @}
+ */
+
+/** @defgroup TINY_LPM_Exported_struct TINY LPM exported struct
+  * @{
+  */
+
+/**
+ * @brief LPM statistics, all the times are in ticks of UTIL_LPM_GET_TIMESTAMP
+ */
+typedef struct
+{
+  uint32_t RunTime;                            /*!<time out of low power mode                         */
+  uint32_t Residency[UTIL_LPM_MODE_NB];        /*!<time spent in each low power mode                  */
+  uint32_t EntryNb[UTIL_LPM_MODE_NB];          /*!<number of entries in each low power mode           */
+  uint32_t StopBlockTime[UTIL_LPM_ID_NB];      /*!<time in sleep mode while the user disallowed stop  */
+  uint32_t OffBlockTime[UTIL_LPM_ID_NB];       /*!<time in stop mode while the user disallowed off    */
+  uint32_t WakeupNb[UTIL_LPM_WAKEUP_NB];       /*!<number of wakeups per source                       */
+  uint32_t PredictSleepNb;                     /*!<sleep instead of stop, next wakeup too close       */
+  uint32_t PredictStopNb;                      /*!<stop instead of off, next wakeup too close         */
+  uint32_t LongSleepNb;                        /*!<sleep forced by a user while stop was worth it     */
+  uint32_t StopExitAvg;                        /*!<average stop exit time, UTIL_LPM_AVG_SHIFT fixed point */
+} UTIL_LPM_Stats_t;
+
 /**
  * @}
  */
@@ -129,6 +191,23 @@ void UTIL_LPM_DeInit( void );
  */
 UTIL_LPM_Mode_t UTIL_LPM_GetMode( void );
 
+/**
+ * @brief  This API returns the mode to enter from the users requests and the next planned wakeup.
+ *         The off and stop modes are only selected when the next wakeup is at least at their
+ *         break-even time, otherwise their entry and exit cost more than the lighter mode:
+ *         off falls back to stop, then stop to sleep.
+ * @note   Only depends on its parameters, used by UTIL_LPM_EnterLowPower
+ * @param  stop_bm: users disallowing the Stop mode
+ * @param  off_bm: users disallowing the Off mode
+ * @param  next_wakeup: time left before the next planned wakeup
+ * @param  break_even: shortest stop period worth its cost, in the unit of next_wakeup
+ * @param  off_break_even: shortest off period worth its cost, in the unit of next_wakeup
+ * @retval the LPM mode based on @ref UTIL_LPM_Mode_t
+ */
+UTIL_LPM_Mode_t UTIL_LPM_SelectMode( UTIL_LPM_bm_t stop_bm, UTIL_LPM_bm_t off_bm,
+                                     uint32_t next_wakeup, uint32_t break_even,
+                                     uint32_t off_break_even );
+
 /**
  * @brief  This API notifies the low power manager if the specified user allows the Stop mode or not.
  *         The default mode selection for all users is Stop Mode enabled
@@ -151,6 +230,18 @@ void UTIL_LPM_SetOffMode( UTIL_LPM_bm_t lpm_id_bm, UTIL_LPM_State_t state );
  */
 void UTIL_LPM_EnterLowPower( void );
 
+/**
+ * @brief  This API returns the statistics of the low power modes since the init or the last reset
+ * @note   Only available when UTIL_LPM_STATS_ENABLE is set, filled with 0 otherwise
+ * @param  stats: filled with the statistics
+ */
+void UTIL_LPM_GetStats( UTIL_LPM_Stats_t *stats );
+
+/**
+ * @brief  This API resets the statistics of the low power modes
+ */
+void UTIL_LPM_ResetStats( void );
+
 /**
  *@}
  */
@@ -68,6 +68,20 @@ typedef struct
   #define UTIL_SEQ_EXIT_CRITICAL_SECTION_IDLE( )     UTIL_SEQ_EXIT_CRITICAL_SECTION( )
 #endif
 
+/**
+ * @brief macros called around the selection of the next task to be executed
+ * @note  UTIL_SEQ_DISPATCH_START is called once a pending task is found and
+ *        UTIL_SEQ_DISPATCH_END just before the task is called. They can be
+ *        redefined to measure the dispatch time of the sequencer
+ */
+#ifndef UTIL_SEQ_DISPATCH_START
+  #define UTIL_SEQ_DISPATCH_START( )
+#endif
+
+#ifndef UTIL_SEQ_DISPATCH_END
+  #define UTIL_SEQ_DISPATCH_END( )
+#endif
+
 /**
  * @brief define to represent no task running
  */
@@ -235,6 +249,8 @@ void UTIL_SEQ_Run( UTIL_SEQ_bm_t Mask_bm )
   local_evtwaited =  EvtWaited;
   while(((local_taskset & local_taskmask & SuperMask) != 0U) && ((local_evtset & local_evtwaited)==0U))
   {
+    UTIL_SEQ_DISPATCH_START( );
+
     counter = 0U;
     /*
      * When a flag is set, the associated bit is set in TaskPrio[counter].priority mask depending
@@ -286,6 +302,8 @@ void UTIL_SEQ_Run( UTIL_SEQ_bm_t Mask_bm )
     }
     UTIL_SEQ_EXIT_CRITICAL_SECTION( );
 
+    UTIL_SEQ_DISPATCH_END( );
+
     /* Execute the task */
     TaskCb[CurrentTaskIdx]( );
 